@@ -84,6 +84,8 @@ pub enum Command {
     /// A chip that sends advertisements at a set interval
     #[command(subcommand)]
     Beacon(Beacon),
+    /// Run commands from a file or stdin, one per line, over one connection
+    Batch(Batch),
 }
 
 impl Command {
@@ -215,6 +217,9 @@ impl Command {
                 },
                 Beacon::Remove(_) => Vec::new(),
             },
+            Command::Batch(_) => {
+                unimplemented!("get_request_bytes is not implemented for Batch Command.")
+            }
         }
     }
 
@@ -294,6 +299,16 @@ impl Command {
     }
 }
 
+#[derive(Debug, Args)]
+pub struct Batch {
+    /// File of commands, read from stdin if not given
+    pub file: Option<String>,
+    /// Apply every line, which must all be move or radio commands, as one
+    /// patch that either succeeds or changes nothing
+    #[arg(long)]
+    pub atomic: bool,
+}
+
 #[derive(Debug, Args)]
 pub struct Radio {
     /// Radio type
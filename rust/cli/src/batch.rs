@@ -0,0 +1,207 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Batch mode of the CLI.
+//!
+//! Runs many commands over one frontend client so a script pays for the
+//! connection once instead of once per netsim invocation.
+
+use crate::args::{self, Command};
+use crate::ffi::frontend_client_ffi::{FrontendClient, GrpcMethod};
+use clap::Parser;
+use log::error;
+use netsim_proto::frontend::{PatchDeviceRequest, PatchDevicesRequest};
+use protobuf::Message;
+use std::fs::File;
+use std::io::{self, BufRead, BufReader};
+
+/// One line of a batch, parsed like the arguments of netsim.
+#[derive(Debug, Parser)]
+#[command(no_binary_name = true)]
+struct BatchLine {
+    #[command(subcommand)]
+    command: Command,
+}
+
+/// Runs the commands of the batch file, or stdin, in order.
+pub fn run(
+    client: &cxx::UniquePtr<FrontendClient>,
+    cmd: &args::Batch,
+    verbose: bool,
+) -> Result<(), String> {
+    let reader: Box<dyn BufRead> = match &cmd.file {
+        Some(file) => Box::new(BufReader::new(
+            File::open(file).map_err(|err| format!("Failed to open batch file {file}: {err}"))?,
+        )),
+        None => Box::new(BufReader::new(io::stdin())),
+    };
+    if cmd.atomic {
+        run_atomic(client, reader, verbose)
+    } else {
+        run_each(client, reader, verbose)
+    }
+}
+
+// Sends each line as it is read, reports failed lines and keeps going.
+fn run_each(
+    client: &cxx::UniquePtr<FrontendClient>,
+    reader: Box<dyn BufRead>,
+    verbose: bool,
+) -> Result<(), String> {
+    let mut failed_lines = 0;
+    for (index, line) in reader.lines().enumerate() {
+        let line = line.map_err(|err| format!("Failed to read batch: {err}"))?;
+        let result = parse_line(&line).and_then(|command| match command {
+            Some(mut command) => {
+                let grpc_method = command.grpc_method();
+                crate::perform_command(&mut command, client, grpc_method, verbose)
+            }
+            None => Ok(()),
+        });
+        if let Err(err) = result {
+            error!("line {}: {err}", index + 1);
+            failed_lines += 1;
+        }
+    }
+    match failed_lines {
+        0 => Ok(()),
+        n => Err(format!("{n} batch line(s) failed.")),
+    }
+}
+
+// Sends every line as one PatchDevicesRequest. Nothing is sent unless the
+// whole batch parses.
+fn run_atomic(
+    client: &cxx::UniquePtr<FrontendClient>,
+    reader: Box<dyn BufRead>,
+    verbose: bool,
+) -> Result<(), String> {
+    let mut request = PatchDevicesRequest::new();
+    for (index, line) in reader.lines().enumerate() {
+        let line = line.map_err(|err| format!("Failed to read batch: {err}"))?;
+        let patch = parse_line(&line)
+            .and_then(|command| command.map(|command| patch_request(&command)).transpose())
+            .map_err(|err| format!("line {}: {err}", index + 1))?;
+        request.patches.extend(patch);
+    }
+    let bytes = request.write_to_bytes().map_err(|err| format!("{err}"))?;
+    let result = client.send_grpc(&GrpcMethod::PatchDevices, &bytes);
+    if !result.is_ok() {
+        return Err(format!("Grpc call error: {}", result.err()));
+    }
+    if verbose {
+        println!("Applied {} patch(es) atomically", request.patches.len());
+    }
+    Ok(())
+}
+
+// Returns the PatchDeviceRequest a move or radio command would send.
+fn patch_request(command: &Command) -> Result<PatchDeviceRequest, String> {
+    match command {
+        Command::Move(_) | Command::Radio(_) => {
+            PatchDeviceRequest::parse_from_bytes(&command.get_request_bytes())
+                .map_err(|err| format!("{err}"))
+        }
+        _ => Err(String::from("only move and radio commands can be applied atomically")),
+    }
+}
+
+// Parses a line into a command, or None for a blank or comment line.
+fn parse_line(line: &str) -> Result<Option<Command>, String> {
+    let words = split_line(line)?;
+    if words.is_empty() {
+        return Ok(None);
+    }
+    let command = BatchLine::try_parse_from(words).map_err(|err| err.to_string())?.command;
+    match command {
+        Command::Gui | Command::Artifact | Command::Batch(_) => {
+            Err(String::from("command is not supported in a batch"))
+        }
+        Command::Devices(ref cmd) if cmd.continuous => {
+            Err(String::from("continuous commands are not supported in a batch"))
+        }
+        Command::Capture(args::Capture::List(ref cmd)) if cmd.continuous => {
+            Err(String::from("continuous commands are not supported in a batch"))
+        }
+        command => Ok(Some(command)),
+    }
+}
+
+// Splits a line into words like a shell: whitespace separates words, single
+// or double quotes group them and a word starting with '#' starts a comment.
+fn split_line(line: &str) -> Result<Vec<String>, String> {
+    let mut words = Vec::new();
+    let mut word: Option<String> = None;
+    let mut quote: Option<char> = None;
+    for c in line.chars() {
+        match quote {
+            Some(q) if c == q => quote = None,
+            Some(_) => word.get_or_insert_with(String::new).push(c),
+            None => match c {
+                '#' if word.is_none() => break,
+                '\'' | '"' => {
+                    quote = Some(c);
+                    word.get_or_insert_with(String::new);
+                }
+                c if c.is_whitespace() => words.extend(word.take()),
+                c => word.get_or_insert_with(String::new).push(c),
+            },
+        }
+    }
+    if quote.is_some() {
+        return Err(String::from("unterminated quote"));
+    }
+    words.extend(word);
+    Ok(words)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_split_line() {
+        assert_eq!(split_line("move dev 1 2").unwrap(), vec!["move", "dev", "1", "2"]);
+        assert_eq!(
+            split_line("  radio ble down 'my device' # trailing").unwrap(),
+            vec!["radio", "ble", "down", "my device"]
+        );
+        assert_eq!(split_line(r#"move "a#b" 1 2"#).unwrap(), vec!["move", "a#b", "1", "2"]);
+        assert_eq!(split_line("move ''").unwrap(), vec!["move", ""]);
+        assert!(split_line("# only a comment").unwrap().is_empty());
+        assert!(split_line("").unwrap().is_empty());
+        assert!(split_line("move 'dev 1 2").is_err());
+    }
+
+    #[test]
+    fn test_parse_line() {
+        assert!(parse_line("   ").unwrap().is_none());
+        assert!(matches!(parse_line("move dev 1.0 2.0").unwrap(), Some(Command::Move(_))));
+        assert!(matches!(parse_line("radio ble up dev").unwrap(), Some(Command::Radio(_))));
+        assert!(matches!(parse_line("devices").unwrap(), Some(Command::Devices(_))));
+        assert!(parse_line("devices --continuous").is_err());
+        assert!(parse_line("gui").is_err());
+        assert!(parse_line("batch file").is_err());
+        assert!(parse_line("move dev").is_err());
+    }
+
+    #[test]
+    fn test_patch_request() {
+        let command = parse_line("move 'my device' 1.0 2.0 3.0").unwrap().unwrap();
+        let patch = patch_request(&command).unwrap();
+        assert_eq!(patch.device.name, "my device");
+        assert_eq!(patch.device.position.z, 3.0);
+        assert!(patch_request(&parse_line("reset").unwrap().unwrap()).is_err());
+    }
+}
@@ -45,6 +45,7 @@ pub mod frontend_client_ffi {
         ListCapture,
         PatchCapture,
         GetCapture,
+        PatchDevices,
     }
 
     extern "Rust" {
@@ -15,6 +15,7 @@
 //! Command Line Interface for Netsim
 
 mod args;
+mod batch;
 mod browser;
 mod display;
 mod ffi;
@@ -23,7 +24,7 @@ mod requests;
 mod response;
 
 use log::error;
-use netsim_common::util::os_utils::{get_instance, get_server_address};
+use netsim_common::util::os_utils::{get_frontend_server_address, get_instance};
 use netsim_proto::frontend::{DeleteChipRequest, ListDeviceResponse};
 use protobuf::Message;
 use std::env;
@@ -70,14 +71,14 @@ fn perform_streaming_request(
 /// helper function to send the Grpc request(s) and handle the response(s) per the given command
 fn perform_command(
     command: &mut args::Command,
-    client: cxx::UniquePtr<FrontendClient>,
+    client: &cxx::UniquePtr<FrontendClient>,
     grpc_method: GrpcMethod,
     verbose: bool,
 ) -> Result<(), String> {
     // Get command's gRPC request(s)
     let requests = match command {
         args::Command::Capture(args::Capture::Patch(_) | args::Capture::Get(_)) => {
-            command.get_requests(&client)
+            command.get_requests(client)
         }
         args::Command::Beacon(args::Beacon::Remove(_)) => {
             vec![args::Command::Devices(args::Devices { continuous: false }).get_request_bytes()]
@@ -90,14 +91,14 @@ fn perform_command(
         let result = match command {
             // Continuous option sends the gRPC call every second
             args::Command::Devices(ref cmd) if cmd.continuous => {
-                continuous_perform_command(command, &client, grpc_method, req, verbose)?
+                continuous_perform_command(command, client, grpc_method, req, verbose)?
             }
             args::Command::Capture(args::Capture::List(ref cmd)) if cmd.continuous => {
-                continuous_perform_command(command, &client, grpc_method, req, verbose)?
+                continuous_perform_command(command, client, grpc_method, req, verbose)?
             }
             // Get Capture use streaming gRPC reader request
             args::Command::Capture(args::Capture::Get(ref mut cmd)) => {
-                perform_streaming_request(&client, cmd, req, &cmd.filenames[i].to_owned())
+                perform_streaming_request(client, cmd, req, &cmd.filenames[i].to_owned())
             }
             args::Command::Beacon(args::Beacon::Remove(ref cmd)) => {
                 let devices = client.send_grpc(&GrpcMethod::ListDevice, req);
@@ -182,11 +183,10 @@ pub extern "C" fn rust_main() {
         browser::open(artifact_dir);
         return;
     }
-    let grpc_method = args.command.grpc_method();
     let server = match (args.vsock, args.port) {
         (Some(vsock), _) => format!("vsock:{vsock}"),
         (_, Some(port)) => format!("localhost:{port}"),
-        _ => get_server_address(get_instance(args.instance)).unwrap_or_default(),
+        _ => get_frontend_server_address(get_instance(args.instance)).unwrap_or_default(),
     };
     let_cxx_string!(server = server);
     let client = new_frontend_client(&server);
@@ -198,7 +198,14 @@ pub extern "C" fn rust_main() {
         }
         return;
     }
-    if let Err(e) = perform_command(&mut args.command, client, grpc_method, args.verbose) {
+    let result = match args.command {
+        args::Command::Batch(ref cmd) => batch::run(&client, cmd, args.verbose),
+        ref mut command => {
+            let grpc_method = command.grpc_method();
+            perform_command(command, &client, grpc_method, args.verbose)
+        }
+    };
+    if let Err(e) = result {
         error!("{e}");
     }
 }
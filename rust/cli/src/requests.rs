@@ -35,6 +35,9 @@ impl args::Command {
             Command::Artifact => {
                 panic!("No GrpcMethod for Artifact Command.");
             }
+            Command::Batch(_) => {
+                panic!("No GrpcMethod for Batch Command.");
+            }
             Command::Beacon(action) => match action {
                 Beacon::Create(_) => GrpcMethod::CreateDevice,
                 Beacon::Patch(_) => GrpcMethod::PatchDevice,
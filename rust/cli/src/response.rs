@@ -90,6 +90,9 @@ impl args::Command {
             Command::Artifact => {
                 unimplemented!("No Grpc Response for Artifact Command.");
             }
+            Command::Batch(_) => {
+                unimplemented!("No Grpc Response for Batch Command.");
+            }
             Command::Beacon(action) => match action {
                 Beacon::Create(kind) => match kind {
                     BeaconCreate::Ble(_) => {
@@ -73,11 +73,17 @@ impl IniFile {
     ///
     /// `Ok` if the write was successful, `Error` otherwise.
     pub fn write(&self) -> Result<(), Box<dyn Error>> {
-        let mut f = File::create(self.filepath.clone())?;
+        // Written aside and renamed over the file, so readers never see a
+        // partial or truncated file.
+        let mut temp_filepath = self.filepath.clone().into_os_string();
+        temp_filepath.push(".tmp");
+        let mut f = File::create(&temp_filepath)?;
         for (key, value) in &self.data {
             writeln!(&mut f, "{}={}", key, value)?;
         }
         f.flush()?;
+        drop(f);
+        std::fs::rename(&temp_filepath, &self.filepath)?;
         Ok(())
     }
 
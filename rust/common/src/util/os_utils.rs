@@ -107,6 +107,18 @@ pub fn get_server_address(instance_num: u16) -> Option<String> {
     })
 }
 
+/// Get the grpc server address of the netsim frontend service. It is the
+/// grpc server address unless netsimd runs a separate frontend server.
+pub fn get_frontend_server_address(instance_num: u16) -> Option<String> {
+    let mut ini_file = IniFile::new(get_netsim_ini_filepath(instance_num));
+    if ini_file.read().is_ok() {
+        if let Some(port) = ini_file.get("grpc.frontend_port") {
+            return Some(format!("localhost:{}", port));
+        }
+    }
+    get_server_address(instance_num)
+}
+
 const DEFAULT_INSTANCE: u16 = 1;
 
 /// Get the netsim instance number which is always > 0
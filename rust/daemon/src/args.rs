@@ -36,6 +36,10 @@ pub struct NetsimdArgs {
     #[arg(long, alias = "disable_address_reuse")]
     pub disable_address_reuse: bool,
 
+    /// Number of Bluetooth shards, each running its own rootcanal thread
+    #[arg(long, alias = "bluetooth_shards")]
+    pub bluetooth_shards: Option<u16>,
+
     /// Set custom hci port
     #[arg(long, alias = "hci_port")]
     pub hci_port: Option<u32>,
@@ -52,6 +56,11 @@ pub struct NetsimdArgs {
     #[arg(short, long)]
     pub logtostderr: bool,
 
+    /// Highest priority of the daemon C++ logs: 0 error, 1 warning, 2 info,
+    /// 3 debug
+    #[arg(long, alias = "log_level")]
+    pub log_level: Option<u8>,
+
     /// Enable development mode. This will include additional features
     #[arg(short, long)]
     pub dev: bool,
@@ -60,6 +69,16 @@ pub struct NetsimdArgs {
     #[arg(short, long)]
     pub vsock: Option<u16>,
 
+    /// Serve the PacketStreamer with the gRPC callback API instead of
+    /// one server thread per stream
+    #[arg(long, alias = "grpc_callback_api")]
+    pub grpc_callback_api: bool,
+
+    /// Restore chips from this simulation snapshot file at startup and save
+    /// their state to it at shutdown
+    #[arg(long)]
+    pub snapshot: Option<String>,
+
     // The name of a config file to load
     #[arg(long)]
     pub config: Option<String>,
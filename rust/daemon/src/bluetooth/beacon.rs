@@ -16,7 +16,7 @@ use super::advertise_data::{AdvertiseData, AdvertiseDataBuilder};
 use super::advertise_settings::{
     AdvertiseMode, AdvertiseSettings, AdvertiseSettingsBuilder, TxPowerLevel,
 };
-use super::chip::{rust_bluetooth_add, RustBluetoothChipCallbacks};
+use super::chip::{rust_bluetooth_add, ReceivedPacket, RustBluetoothChipCallbacks};
 use super::packets::link_layer::{
     Address, AddressType, LeLegacyAdvertisingPduBuilder, LeScanResponseBuilder, Packet, PacketType,
 };
@@ -39,7 +39,7 @@ use netsim_proto::model::chip_create::{
 use netsim_proto::model::{ChipCreate as ChipCreateProto, DeviceCreate as DeviceCreateProto};
 use protobuf::MessageField;
 use std::alloc::System;
-use std::sync::{Mutex, RwLock};
+use std::sync::{Arc, Mutex, RwLock, Weak};
 use std::time::{Duration, Instant};
 use std::{collections::HashMap, ptr::null};
 
@@ -52,6 +52,24 @@ lazy_static! {
     // Used to find beacon chip based on it's id from static methods.
     pub(crate) static ref BEACON_CHIPS: RwLock<HashMap<ChipIdentifier, Mutex<BeaconChip>>> =
         RwLock::new(HashMap::new());
+    // Advertising PDUs in use by at least one beacon.
+    static ref ADVERTISING_PDUS: Mutex<HashMap<Box<[u8]>, Weak<[u8]>>> =
+        Mutex::new(HashMap::new());
+}
+
+// Returns the shared copy of the PDU, creating it if no beacon uses it.
+fn intern_pdu(pdu: Vec<u8>) -> Arc<[u8]> {
+    let mut pdus = ADVERTISING_PDUS.lock().unwrap();
+    if let Some(shared) = pdus.get(pdu.as_slice()).and_then(Weak::upgrade) {
+        return shared;
+    }
+    // Drop the PDUs of patched or removed beacons before the map grows.
+    if pdus.len() == pdus.capacity() {
+        pdus.retain(|_, shared| shared.strong_count() > 0);
+    }
+    let shared: Arc<[u8]> = Arc::from(pdu.as_slice());
+    pdus.insert(pdu.into_boxed_slice(), Arc::downgrade(&shared));
+    shared
 }
 
 /// BeaconChip class.
@@ -64,6 +82,8 @@ pub struct BeaconChip {
     scan_response_data: AdvertiseData,
     advertise_last: Option<Instant>,
     advertise_start: Option<Instant>,
+    // Built on first use and dropped when the beacon is patched.
+    advertising_pdu: Option<Arc<[u8]>>,
 }
 
 impl BeaconChip {
@@ -85,6 +105,7 @@ impl BeaconChip {
                 .unwrap(),
             advertise_last: None,
             advertise_start: None,
+            advertising_pdu: None,
         })
     }
 
@@ -127,9 +148,31 @@ impl BeaconChip {
             scan_response_data,
             advertise_last: None,
             advertise_start: None,
+            advertising_pdu: None,
         })
     }
 
+    /// Returns the advertising PDU of the beacon. Beacons with identical
+    /// PDUs share one copy.
+    fn advertising_pdu(&mut self) -> Arc<[u8]> {
+        if let Some(pdu) = &self.advertising_pdu {
+            return pdu.clone();
+        }
+        let pdu = LeLegacyAdvertisingPduBuilder {
+            advertising_type: self.advertise_settings.get_packet_type(),
+            advertising_data: self.advertise_data.to_bytes(),
+            advertising_address_type: AddressType::Public,
+            target_address_type: AddressType::Public,
+            source_address: self.address,
+            destination_address: *EMPTY_ADDRESS,
+        }
+        .build()
+        .to_vec();
+        let pdu = intern_pdu(pdu);
+        self.advertising_pdu = Some(pdu.clone());
+        pdu
+    }
+
     pub fn send_link_layer_le_packet(&self, packet: &[u8], tx_power: i8) {
         let binding = BT_CHIPS.read().unwrap();
         if let Some(rust_bluetooth_chip) = binding.get(&self.chip_id) {
@@ -151,12 +194,14 @@ pub struct BeaconChipCallbacks {
 }
 
 impl RustBluetoothChipCallbacks for BeaconChipCallbacks {
-    fn tick(&mut self) {
+    // Runs at the advertising interval of the beacon. A beacon whose
+    // advertising timed out sleeps until it is patched.
+    fn tick(&mut self) -> Option<Duration> {
         let guard = BEACON_CHIPS.read().unwrap();
-        let mut beacon = guard.get(&self.chip_id);
+        let beacon = guard.get(&self.chip_id);
         if beacon.is_none() {
             error!("could not find bluetooth beacon with chip id {}", self.chip_id);
-            return;
+            return None;
         }
         let mut beacon = beacon.unwrap().lock().unwrap();
 
@@ -164,13 +209,15 @@ impl RustBluetoothChipCallbacks for BeaconChipCallbacks {
             (beacon.advertise_start, beacon.advertise_settings.timeout)
         {
             if start.elapsed() > timeout {
-                return;
+                return None;
             }
         }
 
+        let interval = beacon.advertise_settings.mode.interval;
         if let Some(last) = beacon.advertise_last {
-            if last.elapsed() <= beacon.advertise_settings.mode.interval {
-                return;
+            let elapsed = last.elapsed();
+            if elapsed < interval {
+                return Some(interval - elapsed);
             }
         } else {
             beacon.advertise_start = Some(Instant::now())
@@ -178,27 +225,29 @@ impl RustBluetoothChipCallbacks for BeaconChipCallbacks {
 
         beacon.advertise_last = Some(Instant::now());
 
-        let packet = LeLegacyAdvertisingPduBuilder {
-            advertising_type: beacon.advertise_settings.get_packet_type(),
-            advertising_data: beacon.advertise_data.to_bytes(),
-            advertising_address_type: AddressType::Public,
-            target_address_type: AddressType::Public,
-            source_address: beacon.address,
-            destination_address: *EMPTY_ADDRESS,
-        }
-        .build()
-        .to_vec();
-
+        let packet = beacon.advertising_pdu();
         beacon.send_link_layer_le_packet(&packet, beacon.advertise_settings.tx_power_level.dbm);
+        Some(interval)
     }
 
     fn receive_link_layer_packet(
         &mut self,
-        source_address: String,
-        destination_address: String,
+        source_address: [u8; 6],
+        destination_address: [u8; 6],
         packet_type: u8,
         packet: &[u8],
     ) {
+        self.receive_link_layer_packets(&[ReceivedPacket {
+            source_address,
+            destination_address,
+            packet_type,
+            packet,
+        }]);
+    }
+
+    // Beacons hear every advertisement of the scene: look the beacon up once
+    // per batch and only answer the scan requests addressed to it.
+    fn receive_link_layer_packets(&mut self, packets: &[ReceivedPacket]) {
         let guard = BEACON_CHIPS.read().unwrap();
         let beacon = guard.get(&self.chip_id);
         if beacon.is_none() {
@@ -206,21 +255,29 @@ impl RustBluetoothChipCallbacks for BeaconChipCallbacks {
             return;
         }
         let beacon = beacon.unwrap().lock().unwrap();
+        if !beacon.advertise_settings.scannable {
+            return;
+        }
 
-        if beacon.advertise_settings.scannable
-            && destination_address == addr_to_str(beacon.address)
-            && packet_type == u8::from(PacketType::LeScan)
-        {
-            let packet = LeScanResponseBuilder {
-                advertising_address_type: AddressType::Public,
-                source_address: beacon.address,
-                destination_address: beacon.address,
-                scan_response_data: beacon.scan_response_data.to_bytes(),
-            }
-            .build()
-            .to_vec();
+        let address = addr_to_bytes(beacon.address);
+        for packet in packets {
+            if packet.destination_address == address
+                && packet.packet_type == u8::from(PacketType::LeScan)
+            {
+                let packet = LeScanResponseBuilder {
+                    advertising_address_type: AddressType::Public,
+                    source_address: beacon.address,
+                    destination_address: beacon.address,
+                    scan_response_data: beacon.scan_response_data.to_bytes(),
+                }
+                .build()
+                .to_vec();
 
-            beacon.send_link_layer_le_packet(&packet, beacon.advertise_settings.tx_power_level.dbm);
+                beacon.send_link_layer_le_packet(
+                    &packet,
+                    beacon.advertise_settings.tx_power_level.dbm,
+                );
+            }
         }
     }
 }
@@ -255,6 +312,7 @@ pub fn ble_beacon_add(
         callbacks,
         String::from("beacon"),
         beacon_proto.address.clone(),
+        true,
     );
     let rust_chip = add_rust_device_result.rust_chip;
     let facade_id = add_rust_device_result.facade_id;
@@ -298,10 +356,7 @@ pub fn ble_beacon_patch(
     if patch.address != String::default() {
         beacon.address = str_to_addr(&patch.address)?;
         #[cfg(not(test))]
-        ffi_bluetooth::bluetooth_set_rust_device_address(
-            facade_id,
-            u64::from(beacon.address).to_le_bytes()[..6].try_into().unwrap(),
-        );
+        ffi_bluetooth::bluetooth_set_rust_device_address(facade_id, addr_to_bytes(beacon.address));
     }
 
     if let Some(patch_settings) = patch.settings.as_ref() {
@@ -344,6 +399,11 @@ pub fn ble_beacon_patch(
         beacon.advertise_data = builder.build()?;
     }
 
+    beacon.advertising_pdu = None;
+    // The interval or timeout may have changed.
+    #[cfg(not(test))]
+    ffi_bluetooth::bluetooth_wake_rust_device(facade_id);
+
     Ok(())
 }
 
@@ -373,6 +433,11 @@ fn addr_to_str(addr: Address) -> String {
         .rfold(format!("{:02x}", bytes[5]), |addr, byte| addr + &format!(":{:02x}", byte))
 }
 
+// Returns the address in the byte order of rootcanal.
+fn addr_to_bytes(addr: Address) -> [u8; 6] {
+    u64::from(addr).to_le_bytes()[..6].try_into().unwrap()
+}
+
 fn str_to_addr(addr: &str) -> Result<Address, String> {
     if addr == String::default() {
         Ok(*EMPTY_ADDRESS)
@@ -566,4 +631,19 @@ pub mod tests {
         let addr: u64 = 123;
         assert_eq!("00:00:00:00:00:7b", addr_to_str(addr.try_into().unwrap()))
     }
+
+    #[test]
+    fn test_intern_pdu_shares_identical_pdus() {
+        let first = intern_pdu(vec![1, 2, 3]);
+        let second = intern_pdu(vec![1, 2, 3]);
+        let other = intern_pdu(vec![4, 5, 6]);
+        assert!(Arc::ptr_eq(&first, &second));
+        assert!(!Arc::ptr_eq(&first, &other));
+    }
+
+    #[test]
+    fn test_addr_to_bytes_is_little_endian() {
+        let addr: u64 = 0xbe_ac_12_34_00_0f;
+        assert_eq!([0x0f, 0x00, 0x34, 0x12, 0xac, 0xbe], addr_to_bytes(addr.try_into().unwrap()))
+    }
 }
@@ -14,19 +14,71 @@
 
 use crate::ffi::ffi_bluetooth::RustBluetoothChip;
 use cxx::{let_cxx_string, UniquePtr};
+use std::time::Duration;
+
+/// A link layer packet received by a Rust chip, borrowed from the FFI.
+///
+/// Addresses are in rootcanal byte order, least significant byte first.
+#[derive(Debug, PartialEq)]
+pub struct ReceivedPacket<'a> {
+    pub source_address: [u8; 6],
+    pub destination_address: [u8; 6],
+    pub packet_type: u8,
+    pub packet: &'a [u8],
+}
 
 /// Rust bluetooth chip trait.
 pub trait RustBluetoothChipCallbacks {
-    fn tick(&mut self);
+    /// Called from a timer of the chip's shard. Returns the delay before the
+    /// next call, or None to wait until the chip is woken with
+    /// `bluetooth_wake_rust_device`.
+    fn tick(&mut self) -> Option<Duration>;
 
     // TODO: include the pdl library in Rust for reading the packet contents.
     fn receive_link_layer_packet(
         &mut self,
-        source_address: String,
-        destination_address: String,
+        source_address: [u8; 6],
+        destination_address: [u8; 6],
         packet_type: u8,
         packet: &[u8],
     );
+
+    /// Receives the packets collected since the previous tick, for chips
+    /// added with `batch_receive`. Called before `tick`.
+    fn receive_link_layer_packets(&mut self, packets: &[ReceivedPacket]) {
+        for packet in packets {
+            self.receive_link_layer_packet(
+                packet.source_address,
+                packet.destination_address,
+                packet.packet_type,
+                packet.packet,
+            );
+        }
+    }
+}
+
+/// Parses a batch of packets written by `RustDevice`. Each record is the
+/// source and destination addresses, the packet type, a 16 bit little
+/// endian size and the packet. A truncated record ends the batch.
+pub fn parse_received_packets(mut batch: &[u8]) -> impl Iterator<Item = ReceivedPacket<'_>> {
+    std::iter::from_fn(move || {
+        const HEADER_LEN: usize = 6 + 6 + 1 + 2;
+        if batch.len() < HEADER_LEN {
+            return None;
+        }
+        let size = u16::from_le_bytes([batch[13], batch[14]]) as usize;
+        if batch.len() < HEADER_LEN + size {
+            return None;
+        }
+        let packet = ReceivedPacket {
+            source_address: batch[0..6].try_into().unwrap(),
+            destination_address: batch[6..12].try_into().unwrap(),
+            packet_type: batch[12],
+            packet: &batch[HEADER_LEN..HEADER_LEN + size],
+        };
+        batch = &batch[HEADER_LEN + size..];
+        Some(packet)
+    })
 }
 
 /// AddRustDeviceResult for the returned object of AddRustDevice() in C++
@@ -43,11 +95,15 @@ pub fn create_add_rust_device_result(
 }
 
 /// Add a bluetooth chip by an object implements RustBluetoothChipCallbacks trait.
+///
+/// With `batch_receive` the received packets are delivered once per tick
+/// through `receive_link_layer_packets`.
 pub fn rust_bluetooth_add(
     device_id: u32,
     callbacks: Box<dyn RustBluetoothChipCallbacks>,
     string_type: String,
     address: String,
+    batch_receive: bool,
 ) -> Box<AddRustDeviceResult> {
     let_cxx_string!(cxx_string_type = string_type);
     let_cxx_string!(cxx_address = address);
@@ -56,5 +112,51 @@ pub fn rust_bluetooth_add(
         Box::new(callbacks),
         &cxx_string_type,
         &cxx_address,
+        batch_receive,
     )
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn record(source: u8, destination: u8, packet_type: u8, packet: &[u8]) -> Vec<u8> {
+        let mut record = vec![source; 6];
+        record.extend([destination; 6]);
+        record.push(packet_type);
+        record.extend((packet.len() as u16).to_le_bytes());
+        record.extend(packet);
+        record
+    }
+
+    #[test]
+    fn test_parse_received_packets() {
+        let mut batch = record(1, 2, 3, &[0xaa, 0xbb]);
+        batch.extend(record(4, 5, 6, &[]));
+        let packets: Vec<ReceivedPacket> = parse_received_packets(&batch).collect();
+        assert_eq!(
+            packets,
+            vec![
+                ReceivedPacket {
+                    source_address: [1; 6],
+                    destination_address: [2; 6],
+                    packet_type: 3,
+                    packet: &[0xaa, 0xbb],
+                },
+                ReceivedPacket {
+                    source_address: [4; 6],
+                    destination_address: [5; 6],
+                    packet_type: 6,
+                    packet: &[],
+                },
+            ]
+        );
+    }
+
+    #[test]
+    fn test_parse_truncated_received_packets() {
+        let mut batch = record(1, 2, 3, &[0xaa, 0xbb]);
+        batch.pop();
+        assert_eq!(parse_received_packets(&batch).count(), 0);
+    }
+}
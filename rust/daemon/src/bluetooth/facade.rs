@@ -13,23 +13,29 @@
 // limitations under the License.
 
 use crate::ffi::ffi_bluetooth;
+use crate::ffi::ffi_transport::PacketBuffer;
 use ::protobuf::MessageField;
 use cxx::let_cxx_string;
 use netsim_proto::config::Bluetooth as BluetoothConfig;
 use netsim_proto::configuration::Controller as RootcanalController;
 use netsim_proto::model::chip::Bluetooth;
+use netsim_proto::stats::{NetsimChipLatencyStats, NetsimStats};
 use protobuf::Message;
 
 pub fn handle_bluetooth_request(facade_id: u32, packet_type: u8, packet: &Vec<u8>) {
     ffi_bluetooth::handle_bt_request(facade_id, packet_type, packet);
 }
 
+pub fn handle_bluetooth_request_buffer(facade_id: u32, packet_type: u8, packet: &PacketBuffer) {
+    ffi_bluetooth::handle_bt_request_buffer(facade_id, packet_type, packet);
+}
+
 pub fn bluetooth_reset(facade_id: u32) {
     ffi_bluetooth::bluetooth_reset(facade_id);
 }
 
-pub fn bluetooth_remove(facade_id: u32) {
-    ffi_bluetooth::bluetooth_remove(facade_id);
+pub fn bluetooth_remove(facade_id: u32, keep_snapshot: bool) {
+    ffi_bluetooth::bluetooth_remove(facade_id, keep_snapshot);
 }
 
 pub fn bluetooth_patch(facade_id: u32, bluetooth: &Bluetooth) {
@@ -47,10 +53,12 @@ pub fn bluetooth_add(
     device_id: u32,
     address: &str,
     bt_properties: &MessageField<RootcanalController>,
+    snapshot_key: &str,
 ) -> u32 {
     let_cxx_string!(cxx_address = address);
+    let_cxx_string!(cxx_snapshot_key = snapshot_key);
     let proto_bytes = bt_properties.as_ref().unwrap_or_default().write_to_bytes().unwrap();
-    ffi_bluetooth::bluetooth_add(device_id, &cxx_address, &proto_bytes)
+    ffi_bluetooth::bluetooth_add(device_id, &cxx_address, &proto_bytes, &cxx_snapshot_key)
 }
 
 /// Starts the Bluetooth service.
@@ -58,12 +66,19 @@ pub fn bluetooth_start(
     config: &MessageField<BluetoothConfig>,
     instance_num: u16,
     disable_address_reuse: bool,
+    num_shards: u16,
 ) {
     let proto_bytes = config.as_ref().unwrap_or_default().write_to_bytes().unwrap();
-    ffi_bluetooth::bluetooth_start(&proto_bytes, instance_num, disable_address_reuse);
+    ffi_bluetooth::bluetooth_start(&proto_bytes, instance_num, disable_address_reuse, num_shards);
 }
 
 /// Stops the Bluetooth service.
 pub fn bluetooth_stop() {
     ffi_bluetooth::bluetooth_stop();
 }
+
+/// Returns the packet path latencies of the Bluetooth chips.
+pub fn bluetooth_latency_stats() -> Vec<NetsimChipLatencyStats> {
+    let stats_bytes = ffi_bluetooth::get_latency_stats();
+    NetsimStats::parse_from_bytes(&stats_bytes).map(|stats| stats.latency_stats).unwrap_or_default()
+}
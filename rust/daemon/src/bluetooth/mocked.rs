@@ -15,6 +15,7 @@
 use crate::bluetooth::{BeaconChip, BEACON_CHIPS};
 use crate::devices::chip::{ChipIdentifier, FacadeIdentifier};
 use crate::devices::device::{AddChipResult, DeviceIdentifier};
+use crate::ffi::ffi_transport::PacketBuffer;
 use ::protobuf::MessageField;
 use lazy_static::lazy_static;
 use log::info;
@@ -23,6 +24,7 @@ use netsim_proto::configuration::Controller as RootcanalController;
 use netsim_proto::model::chip::{BleBeacon, Bluetooth};
 use netsim_proto::model::chip_create::Chip as Builtin;
 use netsim_proto::model::{ChipCreate, DeviceCreate};
+use netsim_proto::stats::NetsimChipLatencyStats;
 use std::sync::Mutex;
 use std::sync::RwLock;
 use std::{collections::HashMap, ptr::null};
@@ -45,11 +47,15 @@ pub fn handle_bluetooth_request(facade_id: u32, packet_type: u8, packet: &Vec<u8
     info!("hci_reset({facade_id}, {packet_type}, {packet:?})");
 }
 
+pub fn handle_bluetooth_request_buffer(facade_id: u32, packet_type: u8, packet: &PacketBuffer) {
+    info!("hci_request_buffer({facade_id}, {packet_type})");
+}
+
 pub fn bluetooth_reset(facade_id: u32) {
     info!("hci_reset({facade_id})");
 }
 
-pub fn bluetooth_remove(facade_id: u32) {
+pub fn bluetooth_remove(facade_id: u32, _keep_snapshot: bool) {
     info!("hci_remove({facade_id})");
 }
 
@@ -67,6 +73,7 @@ pub fn bluetooth_add(
     device_id: u32,
     _address: &str,
     _bt_properties: &MessageField<RootcanalController>,
+    _snapshot_key: &str,
 ) -> u32 {
     info!("hci_add({device_id})");
     let mut resource = IDS.write().unwrap();
@@ -80,6 +87,7 @@ pub fn bluetooth_start(
     _config: &MessageField<BluetoothConfig>,
     _instance_num: u16,
     _disable_address_reuse: bool,
+    _num_shards: u16,
 ) {
     info!("bluetooth service started");
 }
@@ -89,6 +97,10 @@ pub fn bluetooth_stop() {
     info!("bluetooth service ended");
 }
 
+pub fn bluetooth_latency_stats() -> Vec<NetsimChipLatencyStats> {
+    Vec::new()
+}
+
 // Avoid crossing cxx boundary in tests
 pub fn ble_beacon_add(
     device_id: DeviceIdentifier,
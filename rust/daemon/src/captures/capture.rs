@@ -43,6 +43,15 @@ use crate::resource::clone_captures;
 use crate::devices::chip::ChipIdentifier;
 use crate::devices::chip::FacadeIdentifier;
 
+/// Returns the pcap link type of the packets of a chip kind.
+pub fn link_type(chip_kind: ChipKind) -> Result<LinkType> {
+    match chip_kind {
+        ChipKind::BLUETOOTH => Ok(LinkType::BluetoothHciH4WithPhdr),
+        ChipKind::WIFI => Ok(LinkType::Ieee802_11RadioTap),
+        _ => Err(Error::new(ErrorKind::Other, "Unsupported link type")),
+    }
+}
+
 /// Internal Capture struct
 pub struct CaptureInfo {
     facade_id: FacadeIdentifier,
@@ -118,12 +127,7 @@ impl CaptureInfo {
         std::fs::create_dir_all(&filename)?;
         filename.push(format!("{:?}-{:}-{:?}.pcap", self.id, self.device_name, self.chip_kind));
         let mut file = OpenOptions::new().write(true).truncate(true).create(true).open(filename)?;
-        let link_type = match self.chip_kind {
-            ChipKind::BLUETOOTH => LinkType::BluetoothHciH4WithPhdr,
-            ChipKind::WIFI => LinkType::Ieee802_11RadioTap,
-            _ => return Err(Error::new(ErrorKind::Other, "Unsupported link type")),
-        };
-        let size = write_pcap_header(link_type, &mut file)?;
+        let size = write_pcap_header(link_type(self.chip_kind)?, &mut file)?;
         let timestamp = SystemTime::now().duration_since(UNIX_EPOCH).expect("Time went backwards");
         self.size = size;
         self.records = 0;
@@ -151,7 +155,7 @@ impl CaptureInfo {
         (kind, facade_id)
     }
 
-    fn get_facade_key(&self) -> (ChipKind, FacadeIdentifier) {
+    pub fn get_facade_key(&self) -> (ChipKind, FacadeIdentifier) {
         CaptureInfo::new_facade_key(self.chip_kind, self.facade_id)
     }
 
@@ -0,0 +1,248 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Live capture tails for the TailCapture rpc.
+//!
+//! handle_packet publishes every packet to the tails of its chip. A tail
+//! keeps the pcap records of the packets matching its filter until the
+//! stream takes them, independent of the capture state of the chip.
+
+use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::{Arc, Condvar, Mutex, RwLock};
+use std::time::{Duration, SystemTime, UNIX_EPOCH};
+
+use lazy_static::lazy_static;
+use log::warn;
+use netsim_proto::common::ChipKind;
+use netsim_proto::frontend::CaptureFilter;
+use protobuf::Message;
+
+use crate::devices::chip::{ChipIdentifier, FacadeIdentifier};
+use crate::resource::clone_captures;
+
+use super::capture::link_type;
+use super::captures_handler::record_packet;
+use super::pcap_util::{append_record, write_pcap_header, PacketDirection};
+
+/// Packets are dropped while a tail has this many bytes that were not read.
+const MAX_PENDING_BYTES: usize = 4 * 1024 * 1024;
+
+struct Pending {
+    bytes: Vec<u8>,
+    dropped: u64,
+}
+
+struct Subscriber {
+    facade_key: (ChipKind, FacadeIdentifier),
+    filter: CaptureFilter,
+    pending: Mutex<Pending>,
+    ready: Condvar,
+}
+
+lazy_static! {
+    static ref SUBSCRIBERS: RwLock<Vec<Arc<Subscriber>>> = RwLock::new(Vec::new());
+}
+
+// Lets packets skip the lock while no capture is tailed.
+static SUBSCRIBER_COUNT: AtomicUsize = AtomicUsize::new(0);
+
+/// A tail of the capture of one chip. It is removed when dropped.
+pub struct CaptureTail {
+    subscriber: Option<Arc<Subscriber>>,
+}
+
+/// Starts to tail the capture of chip `id` with a serialized CaptureFilter.
+pub fn new_capture_tail_cxx(id: u32, filter: &[u8]) -> Box<CaptureTail> {
+    match new_subscriber(id, filter) {
+        Ok(subscriber) => {
+            let mut subscribers = SUBSCRIBERS.write().unwrap();
+            subscribers.push(subscriber.clone());
+            SUBSCRIBER_COUNT.store(subscribers.len(), Ordering::Release);
+            Box::new(CaptureTail { subscriber: Some(subscriber) })
+        }
+        Err(err) => {
+            warn!("TailCapture error: {err}");
+            Box::new(CaptureTail { subscriber: None })
+        }
+    }
+}
+
+fn new_subscriber(id: ChipIdentifier, filter: &[u8]) -> Result<Arc<Subscriber>, String> {
+    let filter = CaptureFilter::parse_from_bytes(filter).map_err(|err| err.to_string())?;
+    let capture = clone_captures()
+        .write()
+        .unwrap()
+        .get(id)
+        .cloned()
+        .ok_or(format!("No capture for chip {id}"))?;
+    let facade_key = capture.lock().unwrap().get_facade_key();
+    // The stream starts with the pcap header.
+    let mut bytes = Vec::new();
+    let link_type = link_type(facade_key.0).map_err(|err| err.to_string())?;
+    write_pcap_header(link_type, &mut bytes).map_err(|err| err.to_string())?;
+    Ok(Arc::new(Subscriber {
+        facade_key,
+        filter,
+        pending: Mutex::new(Pending { bytes, dropped: 0 }),
+        ready: Condvar::new(),
+    }))
+}
+
+impl CaptureTail {
+    pub fn is_error(&self) -> bool {
+        self.subscriber.is_none()
+    }
+
+    /// Returns the pcap records waiting for the tail. Waits up to
+    /// `timeout_ms` for records and returns an empty vector on timeout.
+    pub fn next(&self, timeout_ms: u32) -> Vec<u8> {
+        let subscriber = match &self.subscriber {
+            Some(subscriber) => subscriber,
+            None => return Vec::new(),
+        };
+        let pending = subscriber.pending.lock().unwrap();
+        let (mut pending, _) = subscriber
+            .ready
+            .wait_timeout_while(pending, Duration::from_millis(timeout_ms.into()), |pending| {
+                pending.bytes.is_empty()
+            })
+            .unwrap();
+        if pending.dropped != 0 {
+            warn!("TailCapture dropped {} packets of a slow reader", pending.dropped);
+            pending.dropped = 0;
+        }
+        std::mem::take(&mut pending.bytes)
+    }
+}
+
+impl Drop for CaptureTail {
+    fn drop(&mut self) {
+        if let Some(subscriber) = self.subscriber.take() {
+            let mut subscribers = SUBSCRIBERS.write().unwrap();
+            subscribers.retain(|other| !Arc::ptr_eq(other, &subscriber));
+            SUBSCRIBER_COUNT.store(subscribers.len(), Ordering::Release);
+        }
+    }
+}
+
+/// Returns true if the packet matches every field of the filter. The packet
+/// does not include the HCI packet type.
+fn matches(
+    filter: &CaptureFilter,
+    packet: &[u8],
+    packet_type: u32,
+    direction: PacketDirection,
+) -> bool {
+    if !filter.packet_types.is_empty() && !filter.packet_types.contains(&packet_type) {
+        return false;
+    }
+    if filter.host_to_controller || filter.controller_to_host {
+        let included = match direction {
+            PacketDirection::HostToController => filter.host_to_controller,
+            PacketDirection::ControllerToHost => filter.controller_to_host,
+        };
+        if !included {
+            return false;
+        }
+    }
+    filter.byte_matches.iter().all(|byte_match| {
+        let start = byte_match.offset as usize;
+        let bytes = match start
+            .checked_add(byte_match.value.len())
+            .and_then(|end| packet.get(start..end))
+        {
+            Some(bytes) => bytes,
+            None => return false,
+        };
+        if byte_match.mask.is_empty() {
+            bytes == byte_match.value.as_slice()
+        } else {
+            byte_match.mask.len() == byte_match.value.len()
+                && bytes
+                    .iter()
+                    .zip(&byte_match.value)
+                    .zip(&byte_match.mask)
+                    .all(|((byte, value), mask)| byte & mask == value & mask)
+        }
+    })
+}
+
+/// Appends the packet to the tails of the chip with a matching filter.
+pub fn publish(
+    chip_kind: ChipKind,
+    facade_id: FacadeIdentifier,
+    packet: &[u8],
+    packet_type: u32,
+    direction: PacketDirection,
+) {
+    if SUBSCRIBER_COUNT.load(Ordering::Acquire) == 0 {
+        return;
+    }
+    let subscribers = SUBSCRIBERS.read().unwrap();
+    for subscriber in subscribers.iter() {
+        if subscriber.facade_key != (chip_kind, facade_id)
+            || !matches(&subscriber.filter, packet, packet_type, direction)
+        {
+            continue;
+        }
+        let mut pending = subscriber.pending.lock().unwrap();
+        if pending.bytes.len() >= MAX_PENDING_BYTES {
+            pending.dropped += 1;
+            continue;
+        }
+        let timestamp = SystemTime::now().duration_since(UNIX_EPOCH).expect("Time went backwards");
+        let packet_buf = record_packet(chip_kind, packet, packet_type);
+        if let Err(err) = append_record(timestamp, &mut pending.bytes, direction, &packet_buf) {
+            warn!("{err:?}");
+            continue;
+        }
+        subscriber.ready.notify_one();
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use netsim_proto::frontend::ByteMatch;
+
+    fn byte_match(offset: u32, value: &[u8], mask: &[u8]) -> ByteMatch {
+        ByteMatch { offset, value: value.to_vec(), mask: mask.to_vec(), ..Default::default() }
+    }
+
+    #[test]
+    fn test_matches_packet_type_and_direction() {
+        let mut filter = CaptureFilter::new();
+        assert!(matches(&filter, &[1, 2], 2, PacketDirection::HostToController));
+
+        filter.packet_types = vec![2, 4];
+        filter.controller_to_host = true;
+        assert!(matches(&filter, &[1, 2], 4, PacketDirection::ControllerToHost));
+        assert!(!matches(&filter, &[1, 2], 1, PacketDirection::ControllerToHost));
+        assert!(!matches(&filter, &[1, 2], 2, PacketDirection::HostToController));
+    }
+
+    #[test]
+    fn test_matches_bytes() {
+        let mut filter = CaptureFilter::new();
+        filter.byte_matches.push(byte_match(1, &[0x40, 0x00], &[0xf0, 0x00]));
+        assert!(matches(&filter, &[0x00, 0x4f, 0x12], 2, PacketDirection::HostToController));
+        assert!(!matches(&filter, &[0x00, 0x3f, 0x12], 2, PacketDirection::HostToController));
+        // The packet is too short for the match.
+        assert!(!matches(&filter, &[0x00, 0x4f], 2, PacketDirection::HostToController));
+
+        filter.byte_matches.push(byte_match(0, &[0x07], &[]));
+        assert!(matches(&filter, &[0x07, 0x40, 0x12], 2, PacketDirection::HostToController));
+        assert!(!matches(&filter, &[0x08, 0x40, 0x12], 2, PacketDirection::HostToController));
+    }
+}
@@ -34,7 +34,7 @@ use netsim_proto::common::ChipKind;
 use netsim_proto::frontend::ListCaptureResponse;
 use protobuf_json_mapping::{print_to_string_with_options, PrintOptions};
 use std::fs::File;
-use std::io::{Read, Result};
+use std::io::{Read, Result, Seek, SeekFrom};
 use std::pin::Pin;
 use std::time::{SystemTime, UNIX_EPOCH};
 
@@ -46,10 +46,11 @@ use crate::resource::clone_captures;
 use crate::util::int_to_chip_kind;
 
 use super::capture::CaptureInfo;
+use super::capture_tail;
 use super::pcap_util::{append_record, PacketDirection};
 use super::PCAP_MIME_TYPE;
 
-const CHUNK_LEN: usize = 1024;
+const CHUNK_LEN: usize = 64 * 1024;
 const JSON_PRINT_OPTION: PrintOptions = PrintOptions {
     enum_values_int: false,
     proto_field_name: false,
@@ -70,49 +71,83 @@ fn get_file(id: ChipIdentifier, device_name: String, chip_kind: ChipKind) -> Res
 // GET /captures/id/{id} --> Get Capture information
 // GET /captures/contents/{id} --> Download Pcap file
 /// Performs GetCapture to download pcap file and write to writer.
-pub fn handle_capture_get(writer: ResponseWritable, id: ChipIdentifier) {
-    let captures_arc = clone_captures();
-    let mut captures = captures_arc.write().unwrap();
-    if let Some(capture) = captures.get(id).map(|arc_capture| arc_capture.lock().unwrap()) {
-        if capture.size == 0 {
-            writer.put_error(
-                404,
-                &format!(
-                    "Capture file not found for {:?}-{}-{:?}",
-                    id, capture.device_name, capture.chip_kind
-                ),
-            );
-        } else if let Ok(mut file) = get_file(id, capture.device_name.clone(), capture.chip_kind) {
-            let mut buffer = [0u8; CHUNK_LEN];
-            let time_display = TimeDisplay::new(capture.seconds, capture.nanos as u32);
-            let header_value = format!(
-                "attachment; filename=\"{:?}-{:}-{:?}-{}.pcap\"",
-                id,
+///
+/// The file is written from `offset` so that an interrupted download can be
+/// resumed. All chunks after the first one start at a multiple of CHUNK_LEN.
+pub fn handle_capture_get(writer: ResponseWritable, id: ChipIdentifier, offset: u64) {
+    // Copy the capture information and release the lock so that packets are
+    // still captured while the file is streamed.
+    let (size, device_name, chip_kind, time_display) = {
+        let captures_arc = clone_captures();
+        let mut captures = captures_arc.write().unwrap();
+        match captures.get(id).map(|arc_capture| arc_capture.lock().unwrap()) {
+            Some(capture) => (
+                capture.size,
                 capture.device_name.clone(),
                 capture.chip_kind,
-                time_display.utc_display()
-            );
-            writer.put_ok_with_length(
-                PCAP_MIME_TYPE,
-                capture.size,
-                vec![("Content-Disposition".to_string(), header_value)],
-            );
-            loop {
-                match file.read(&mut buffer) {
-                    Ok(0) => break,
-                    Ok(length) => writer.put_chunk(&buffer[..length]),
-                    Err(_) => {
-                        writer.put_error(404, "Error reading pcap file");
-                        break;
-                    }
-                }
+                TimeDisplay::new(capture.seconds, capture.nanos as u32),
+            ),
+            None => {
+                writer.put_error(404, "Cannot access Capture Resource");
+                return;
             }
-        } else {
+        }
+    };
+    if size == 0 {
+        writer.put_error(
+            404,
+            &format!("Capture file not found for {:?}-{}-{:?}", id, device_name, chip_kind),
+        );
+        return;
+    }
+    if offset > size as u64 {
+        writer.put_error(416, "Offset is past the end of the Capture file");
+        return;
+    }
+    let mut file = match get_file(id, device_name.clone(), chip_kind) {
+        Ok(file) => file,
+        Err(_) => {
             writer.put_error(404, "Cannot open Capture file");
+            return;
         }
-    } else {
-        writer.put_error(404, "Cannot access Capture Resource")
     };
+    if file.seek(SeekFrom::Start(offset)).is_err() {
+        writer.put_error(404, "Error reading pcap file");
+        return;
+    }
+    let header_value = format!(
+        "attachment; filename=\"{:?}-{:}-{:?}-{}.pcap\"",
+        id,
+        device_name,
+        chip_kind,
+        time_display.utc_display()
+    );
+    // The file may grow while it is streamed, only the bytes captured so far
+    // are written.
+    let mut remaining = size - offset as usize;
+    writer.put_ok_with_length(
+        PCAP_MIME_TYPE,
+        remaining,
+        vec![("Content-Disposition".to_string(), header_value)],
+    );
+    let mut buffer = vec![0u8; CHUNK_LEN];
+    let mut chunk_len = CHUNK_LEN - (offset as usize % CHUNK_LEN);
+    while remaining > 0 {
+        let len = chunk_len.min(remaining);
+        match file.read(&mut buffer[..len]) {
+            Ok(0) => break,
+            Ok(length) => {
+                writer.put_chunk(&buffer[..length]);
+                remaining -= length;
+                // Finish a short read before going back to aligned chunks.
+                chunk_len = if length < len { len - length } else { CHUNK_LEN };
+            }
+            Err(_) => {
+                writer.put_error(404, "Error reading pcap file");
+                break;
+            }
+        }
+    }
 }
 
 /// Performs ListCapture to get the list of CaptureInfos and write to writer.
@@ -162,7 +197,7 @@ pub fn handle_capture_patch(writer: ResponseWritable, id: ChipIdentifier, state:
 
 /// The Rust capture handler used directly by Http frontend or handle_capture_cxx for LIST, GET, and PATCH
 pub fn handle_capture(request: &Request<Vec<u8>>, param: &str, writer: ResponseWritable) {
-    if request.uri() == "/v1/captures" {
+    if request.uri().path() == "/v1/captures" {
         match request.method().as_str() {
             "GET" => {
                 handle_capture_list(writer);
@@ -179,7 +214,15 @@ pub fn handle_capture(request: &Request<Vec<u8>>, param: &str, writer: ResponseW
                         return;
                     }
                 };
-                handle_capture_get(writer, id);
+                // The offset query parameter resumes a download.
+                let offset = match offset_param(request.uri().query()) {
+                    Some(offset) => offset,
+                    None => {
+                        writer.put_error(404, "Incorrect offset for capture, should be u64.");
+                        return;
+                    }
+                };
+                handle_capture_get(writer, id, offset);
             }
             "PATCH" => {
                 let id = match param.parse::<u32>() {
@@ -202,6 +245,22 @@ pub fn handle_capture(request: &Request<Vec<u8>>, param: &str, writer: ResponseW
     }
 }
 
+/// Returns the value of the offset parameter of a query, 0 without one, or
+/// None if it is not a u64.
+fn offset_param(query: Option<&str>) -> Option<u64> {
+    let value = query
+        .unwrap_or_default()
+        .split('&')
+        .find_map(|param| param.strip_prefix("offset="))
+        .unwrap_or("0");
+    value.parse::<u64>().ok()
+}
+
+/// GetCapture handler cxx for grpc server to call
+pub fn handle_capture_get_cxx(responder: Pin<&mut CxxServerResponseWriter>, id: u32, offset: u64) {
+    handle_capture_get(&mut CxxServerResponseWriterWrapper { writer: responder }, id, offset);
+}
+
 /// Capture handler cxx for grpc server to call
 pub fn handle_capture_cxx(
     responder: Pin<&mut CxxServerResponseWriter>,
@@ -230,17 +289,32 @@ pub fn handle_capture_cxx(
     );
 }
 
+/// Returns the packet of a pcap record. Bluetooth packets start with the HCI
+/// packet type.
+pub fn record_packet(chip_kind: ChipKind, packet: &[u8], packet_type: u32) -> Vec<u8> {
+    if chip_kind == ChipKind::BLUETOOTH {
+        let mut packet_buf = Vec::with_capacity(packet.len() + 1);
+        packet_buf.push(packet_type as u8);
+        packet_buf.extend(packet);
+        packet_buf
+    } else {
+        packet.to_vec()
+    }
+}
+
 /// A common code for handle_request and handle_response methods.
 fn handle_packet(
     kind: u32,
     facade_id: u32,
-    packet: &Vec<u8>,
+    packet: &[u8],
     packet_type: u32,
     direction: PacketDirection,
 ) {
+    let chip_kind = int_to_chip_kind(kind);
+    capture_tail::publish(chip_kind, facade_id, packet, packet_type, direction);
     let captures_arc = clone_captures();
     let captures = captures_arc.write().unwrap();
-    let facade_key = CaptureInfo::new_facade_key(int_to_chip_kind(kind), facade_id);
+    let facade_key = CaptureInfo::new_facade_key(chip_kind, facade_id);
     if let Some(mut capture) = captures
         .facade_key_to_capture
         .get(&facade_key)
@@ -249,11 +323,7 @@ fn handle_packet(
         if let Some(ref mut file) = capture.file {
             let timestamp =
                 SystemTime::now().duration_since(UNIX_EPOCH).expect("Time went backwards");
-            let mut packet_buf = packet.clone();
-            if int_to_chip_kind(kind) == ChipKind::BLUETOOTH {
-                packet_buf = vec![packet_type as u8];
-                packet_buf.extend(packet);
-            };
+            let packet_buf = record_packet(chip_kind, packet, packet_type);
             match append_record(timestamp, file, direction, packet_buf.as_slice()) {
                 Ok(size) => {
                     capture.size += size;
@@ -268,12 +338,12 @@ fn handle_packet(
 }
 
 /// Method for dispatcher to invoke (Host to Controller Packet Flow)
-pub fn handle_packet_request(kind: u32, facade_id: u32, packet: &Vec<u8>, packet_type: u32) {
+pub fn handle_packet_request(kind: u32, facade_id: u32, packet: &[u8], packet_type: u32) {
     handle_packet(kind, facade_id, packet, packet_type, PacketDirection::HostToController)
 }
 
 /// Method for dispatcher to invoke (Controller to Host Packet Flow)
-pub fn handle_packet_response(kind: u32, facade_id: u32, packet: &Vec<u8>, packet_type: u32) {
+pub fn handle_packet_response(kind: u32, facade_id: u32, packet: &[u8], packet_type: u32) {
     handle_packet(kind, facade_id, packet, packet_type, PacketDirection::ControllerToHost)
 }
 
@@ -290,3 +360,17 @@ pub fn clear_pcap_files() -> bool {
     // Delete the directory.
     std::fs::remove_dir_all(&path).is_ok()
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_offset_param() {
+        assert_eq!(offset_param(None), Some(0));
+        assert_eq!(offset_param(Some("")), Some(0));
+        assert_eq!(offset_param(Some("offset=1024")), Some(1024));
+        assert_eq!(offset_param(Some("a=b&offset=7")), Some(7));
+        assert_eq!(offset_param(Some("offset=-1")), None);
+    }
+}
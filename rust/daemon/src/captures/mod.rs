@@ -15,6 +15,7 @@
 //! Capture Resource codebase
 
 pub mod capture;
+pub mod capture_tail;
 pub mod captures_handler;
 pub mod pcap_util;
 /// A mime type for pcap file in HTTP headers. [application/vnd.tcpdump.pcap]
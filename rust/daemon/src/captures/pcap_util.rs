@@ -31,6 +31,7 @@ macro_rules! be_vec {
     }
 
 /// The indication of packet direction for HCI packets.
+#[derive(Clone, Copy, Debug, PartialEq)]
 pub enum PacketDirection {
     /// Host To Controller as u32 value
     HostToController = 0,
@@ -19,6 +19,7 @@
 ///
 use crate::bluetooth as bluetooth_facade;
 use crate::devices::id_factory::IdFactory;
+use crate::uwb as uwb_facade;
 use crate::wifi as wifi_facade;
 use lazy_static::lazy_static;
 use log::info;
@@ -118,6 +119,12 @@ impl Chip {
                     stats.set_tx_count(wifi.tx_count);
                     stats.set_rx_count(wifi.rx_count);
                 }
+                ProtoChipKind::UWB => {
+                    stats.set_kind(netsim_radio_stats::Kind::UWB);
+                    let uwb = uwb_facade::uwb_get(facade_id);
+                    stats.set_tx_count(uwb.tx_count);
+                    stats.set_rx_count(uwb.rx_count);
+                }
                 _ => {
                     info!("Unhandled chip in get_stats {:?}", self.kind);
                 }
@@ -147,6 +154,9 @@ impl Chip {
             (Ok(ProtoChipKind::WIFI), Some(facade_id)) => {
                 chip.set_wifi(wifi_facade::wifi_get(facade_id));
             }
+            (Ok(ProtoChipKind::UWB), Some(facade_id)) => {
+                chip.set_uwb(uwb_facade::uwb_get(facade_id));
+            }
             (_, None) => {
                 return Err(format!(
                     "Facade Id hasn't been added yet to frontend resource for chip_id: {}",
@@ -184,6 +194,9 @@ impl Chip {
                 } else if self.kind == ProtoChipKind::WIFI && patch.has_wifi() {
                     wifi_facade::wifi_patch(facade_id, patch.wifi());
                     Ok(())
+                } else if self.kind == ProtoChipKind::UWB && patch.has_uwb() {
+                    uwb_facade::uwb_patch(facade_id, patch.uwb());
+                    Ok(())
                 } else {
                     Err(format!("Unknown chip kind or missing radio: {:?}", self.kind))
                 }
@@ -205,6 +218,10 @@ impl Chip {
                 wifi_facade::wifi_reset(facade_id);
                 Ok(())
             }
+            (ProtoChipKind::UWB, Some(facade_id)) => {
+                uwb_facade::uwb_reset(facade_id);
+                Ok(())
+            }
             (_, None) => Err(format!(
                 "Facade Id hasn't been added yet to frontend resource for chip_id: {}",
                 self.id
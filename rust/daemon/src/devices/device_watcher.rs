@@ -0,0 +1,237 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Computes the device changes streamed by the WatchDevices rpc.
+
+use super::devices_handler::get_devices_proto;
+use log::warn;
+use netsim_proto::frontend::WatchDevicesResponse;
+use netsim_proto::model::chip::Bluetooth as ProtoBluetooth;
+use netsim_proto::model::Chip as ProtoChip;
+use netsim_proto::model::Device as ProtoDevice;
+use protobuf::Message;
+use std::collections::BTreeMap;
+
+/// Remembers the devices sent to one watcher so that only the changes are
+/// sent next time.
+pub struct DeviceWatcher {
+    devices: Option<BTreeMap<u32, ProtoDevice>>,
+}
+
+pub fn new_device_watcher_cxx() -> Box<DeviceWatcher> {
+    Box::new(DeviceWatcher::new())
+}
+
+impl DeviceWatcher {
+    pub fn new() -> Self {
+        DeviceWatcher { devices: None }
+    }
+
+    /// Returns the changes from the devices of the previous call, or None
+    /// when nothing changed. The first call returns every device.
+    pub fn changes(&mut self, devices: Vec<ProtoDevice>) -> Option<WatchDevicesResponse> {
+        let devices: BTreeMap<u32, ProtoDevice> =
+            devices.into_iter().map(|device| (device.id, device)).collect();
+        let mut response = WatchDevicesResponse::new();
+        match &self.devices {
+            None => response.devices = devices.values().cloned().collect(),
+            Some(previous) => {
+                for (id, device) in &devices {
+                    match previous.get(id) {
+                        Some(old) => {
+                            if let Some(delta) =
+                                device_delta(old, device, &mut response.removed_chip_ids)
+                            {
+                                response.devices.push(delta);
+                            }
+                        }
+                        None => response.devices.push(device.clone()),
+                    }
+                }
+                response.removed_device_ids =
+                    previous.keys().filter(|id| !devices.contains_key(id)).cloned().collect();
+                if response.devices.is_empty() && response.removed_device_ids.is_empty() {
+                    return None;
+                }
+            }
+        }
+        self.devices = Some(devices);
+        Some(response)
+    }
+
+    /// Returns the serialized WatchDevicesResponse with the changes since
+    /// the previous poll, or an empty vector when nothing changed.
+    pub fn poll(&mut self) -> Vec<u8> {
+        let scene = match get_devices_proto() {
+            Ok(scene) => scene,
+            Err(err) => {
+                warn!("DeviceWatcher poll error: {err}");
+                return Vec::new();
+            }
+        };
+        match self.changes(scene.devices) {
+            Some(response) => response.write_to_bytes().unwrap_or_default(),
+            None => Vec::new(),
+        }
+    }
+}
+
+impl Default for DeviceWatcher {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+/// Returns a device with the id and the changed fields, or None when the
+/// device did not change.
+fn device_delta(
+    old: &ProtoDevice,
+    new: &ProtoDevice,
+    removed_chip_ids: &mut Vec<u32>,
+) -> Option<ProtoDevice> {
+    if old == new {
+        return None;
+    }
+    let mut delta = ProtoDevice::new();
+    delta.id = new.id;
+    if old.name != new.name {
+        delta.name = new.name.clone();
+    }
+    if old.visible != new.visible {
+        delta.visible = new.visible;
+    }
+    if old.position != new.position {
+        delta.position = new.position.clone();
+    }
+    if old.orientation != new.orientation {
+        delta.orientation = new.orientation.clone();
+    }
+    for chip in &new.chips {
+        match old.chips.iter().find(|old_chip| old_chip.id == chip.id) {
+            Some(old_chip) if old_chip == chip => {}
+            Some(old_chip) => delta.chips.push(chip_delta(old_chip, chip)),
+            None => delta.chips.push(chip.clone()),
+        }
+    }
+    removed_chip_ids.extend(
+        old.chips
+            .iter()
+            .filter(|old_chip| !new.chips.iter().any(|chip| chip.id == old_chip.id))
+            .map(|old_chip| old_chip.id),
+    );
+    Some(delta)
+}
+
+/// Bluetooth chips only carry the changed radios since the tx and rx counts
+/// change with every packet. Other chips are sent whole.
+fn chip_delta(old: &ProtoChip, new: &ProtoChip) -> ProtoChip {
+    if !old.has_bt() || !new.has_bt() || old.name != new.name {
+        return new.clone();
+    }
+    let (old_bt, new_bt) = (old.bt(), new.bt());
+    let mut bt = ProtoBluetooth::new();
+    if old_bt.low_energy != new_bt.low_energy {
+        bt.low_energy = new_bt.low_energy.clone();
+    }
+    if old_bt.classic != new_bt.classic {
+        bt.classic = new_bt.classic.clone();
+    }
+    if old_bt.address != new_bt.address {
+        bt.address = new_bt.address.clone();
+    }
+    if old_bt.bt_properties != new_bt.bt_properties {
+        bt.bt_properties = new_bt.bt_properties.clone();
+    }
+    let mut chip = ProtoChip::new();
+    chip.kind = new.kind;
+    chip.id = new.id;
+    if old.manufacturer != new.manufacturer {
+        chip.manufacturer = new.manufacturer.clone();
+    }
+    if old.product_name != new.product_name {
+        chip.product_name = new.product_name.clone();
+    }
+    chip.set_bt(bt);
+    chip
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use netsim_proto::common::ChipKind as ProtoChipKind;
+    use netsim_proto::model::chip::Radio as ProtoRadio;
+    use netsim_proto::model::Position as ProtoPosition;
+    use netsim_proto::model::State;
+    use protobuf::{EnumOrUnknown, MessageField};
+
+    fn test_device(id: u32, chip_id: u32) -> ProtoDevice {
+        let mut radio = ProtoRadio::new();
+        radio.state = State::ON.into();
+        let mut bt = ProtoBluetooth::new();
+        bt.low_energy = MessageField::some(radio.clone());
+        bt.classic = MessageField::some(radio);
+        let mut chip = ProtoChip::new();
+        chip.kind = EnumOrUnknown::new(ProtoChipKind::BLUETOOTH);
+        chip.id = chip_id;
+        chip.set_bt(bt);
+        let mut device = ProtoDevice::new();
+        device.id = id;
+        device.name = format!("device-{id}");
+        device.position = MessageField::some(ProtoPosition::new());
+        device.chips.push(chip);
+        device
+    }
+
+    #[test]
+    fn test_first_changes_is_snapshot() {
+        let mut watcher = DeviceWatcher::new();
+        let response = watcher.changes(vec![test_device(1, 10), test_device(2, 20)]).unwrap();
+        assert_eq!(response.devices, vec![test_device(1, 10), test_device(2, 20)]);
+        assert!(watcher.changes(vec![test_device(1, 10), test_device(2, 20)]).is_none());
+    }
+
+    #[test]
+    fn test_changes_only_has_changed_fields() {
+        let mut watcher = DeviceWatcher::new();
+        watcher.changes(vec![test_device(1, 10), test_device(2, 20)]);
+
+        let mut device = test_device(1, 10);
+        device.position.as_mut().unwrap().x = 1.0;
+        device.chips[0].mut_bt().low_energy.as_mut().unwrap().tx_count = 3;
+        let response = watcher.changes(vec![device, test_device(2, 20)]).unwrap();
+
+        assert_eq!(response.devices.len(), 1);
+        let delta = &response.devices[0];
+        assert_eq!(delta.id, 1);
+        assert!(delta.name.is_empty());
+        assert_eq!(delta.position.x, 1.0);
+        assert!(delta.orientation.is_none());
+        assert_eq!(delta.chips.len(), 1);
+        assert_eq!(delta.chips[0].id, 10);
+        assert_eq!(delta.chips[0].bt().low_energy.tx_count, 3);
+        assert!(delta.chips[0].bt().classic.is_none());
+    }
+
+    #[test]
+    fn test_changes_reports_removed() {
+        let mut watcher = DeviceWatcher::new();
+        let mut device = test_device(1, 10);
+        device.chips.push(test_device(1, 11).chips.remove(0));
+        watcher.changes(vec![device, test_device(2, 20)]);
+
+        let response = watcher.changes(vec![test_device(1, 10)]).unwrap();
+        assert_eq!(response.removed_device_ids, vec![2]);
+        assert_eq!(response.removed_chip_ids, vec![11]);
+    }
+}
@@ -24,6 +24,7 @@
 
 use super::chip::ChipIdentifier;
 use super::device::DeviceIdentifier;
+use super::facade_startup;
 use super::id_factory::IdFactory;
 use crate::bluetooth as bluetooth_facade;
 use crate::devices::device::AddChipResult;
@@ -33,10 +34,10 @@ use crate::events::Event;
 use crate::ffi::ffi_response_writable::CxxServerResponseWriter;
 use crate::ffi::CxxServerResponseWriterWrapper;
 use crate::http_server::server_response::ResponseWritable;
+use crate::uwb as uwb_facade;
 use crate::wifi as wifi_facade;
 use cxx::{CxxString, CxxVector};
 use http::Request;
-use http::Version;
 use lazy_static::lazy_static;
 use log::{info, warn};
 use netsim_proto::common::ChipKind as ProtoChipKind;
@@ -46,6 +47,7 @@ use netsim_proto::frontend::CreateDeviceResponse;
 use netsim_proto::frontend::DeleteChipRequest;
 use netsim_proto::frontend::ListDeviceResponse;
 use netsim_proto::frontend::PatchDeviceRequest;
+use netsim_proto::frontend::PatchDevicesRequest;
 use netsim_proto::model::chip_create::Chip as ProtoBuiltin;
 use netsim_proto::model::ChipCreate;
 use netsim_proto::model::Position as ProtoPosition;
@@ -58,7 +60,9 @@ use protobuf_json_mapping::print_to_string_with_options;
 use protobuf_json_mapping::PrintOptions;
 use std::collections::btree_map::Entry;
 use std::collections::BTreeMap;
+use std::collections::{HashMap, VecDeque};
 use std::pin::Pin;
+use std::sync::atomic::{AtomicU64, Ordering};
 use std::sync::mpsc::Receiver;
 use std::sync::Arc;
 use std::sync::RwLock;
@@ -80,6 +84,14 @@ lazy_static! {
     static ref DEVICES: Arc<RwLock<Devices>> = Arc::new(RwLock::new(Devices::new()));
 }
 
+// Incremented while holding the DEVICES write lock whenever device positions
+// change, so position caches know when to refresh.
+static POSITION_GENERATION: AtomicU64 = AtomicU64::new(0);
+
+// Removed devices remembered for get_position_changes_cxx. A cache that
+// falls further behind refreshes all of its positions.
+const MAX_REMOVED_POSITIONS: usize = 256;
+
 fn get_devices() -> Arc<RwLock<Devices>> {
     Arc::clone(&DEVICES)
 }
@@ -89,11 +101,41 @@ struct Devices {
     // BTreeMap allows ListDevice to output devices in order of identifiers.
     entries: BTreeMap<DeviceIdentifier, Device>,
     id_factory: IdFactory<DeviceIdentifier>,
+    // Generation of the last position change of each device.
+    position_generations: HashMap<DeviceIdentifier, u64>,
+    // Removed devices with the generation of their removal, oldest first.
+    removed_positions: VecDeque<(u64, DeviceIdentifier)>,
+    // Generation of the last removal dropped from removed_positions.
+    removed_floor: u64,
 }
 
 impl Devices {
     fn new() -> Self {
-        Devices { entries: BTreeMap::new(), id_factory: IdFactory::new(INITIAL_DEVICE_ID, 1) }
+        Devices {
+            entries: BTreeMap::new(),
+            id_factory: IdFactory::new(INITIAL_DEVICE_ID, 1),
+            position_generations: HashMap::new(),
+            removed_positions: VecDeque::new(),
+            removed_floor: 0,
+        }
+    }
+
+    // Records that the position of a device changed. Called with the
+    // DEVICES write lock held.
+    fn position_changed(&mut self, id: DeviceIdentifier) {
+        let generation = POSITION_GENERATION.fetch_add(1, Ordering::SeqCst) + 1;
+        self.position_generations.insert(id, generation);
+    }
+
+    fn position_removed(&mut self, id: DeviceIdentifier) {
+        let generation = POSITION_GENERATION.fetch_add(1, Ordering::SeqCst) + 1;
+        self.position_generations.remove(&id);
+        if self.removed_positions.len() == MAX_REMOVED_POSITIONS {
+            if let Some((dropped, _)) = self.removed_positions.pop_front() {
+                self.removed_floor = dropped;
+            }
+        }
+        self.removed_positions.push_back((generation, id));
     }
 }
 
@@ -102,6 +144,13 @@ fn notify_all() {
     // TODO
 }
 
+/// Names a chip in the snapshots of the facades. An emulator restored from
+/// a snapshot reconnects with the same device and chip names, so its new
+/// chip resumes the state of the old one.
+fn snapshot_key(device_name: &str, chip_kind: ProtoChipKind, chip_name: &str) -> String {
+    format!("{device_name}/{chip_kind:?}/{chip_name}")
+}
+
 /// Returns a Result<AddChipResult, String> after adding chip to resource.
 /// add_chip is called by the transport layer when a new chip is attached.
 ///
@@ -115,6 +164,9 @@ pub fn add_chip(
     chip_create_proto: &ChipCreate,
 ) -> Result<AddChipResult, String> {
     let chip_kind = chip_create_proto.kind.enum_value_or(ProtoChipKind::UNSPECIFIED);
+    // Chips that connect while netsimd starts wait for their facade, before
+    // the device is touched so a facade that failed leaves nothing behind.
+    facade_startup::wait_started(chip_kind)?;
     let result = {
         let devices_arc = get_devices();
         let mut devices = devices_arc.write().unwrap();
@@ -145,11 +197,13 @@ pub fn add_chip(
     match result {
         // id_tuple = (DeviceIdentifier, ChipIdentifier)
         Ok((device_id, chip_id)) => {
+            let snapshot_key = snapshot_key(device_name, chip_kind, &chip_create_proto.name);
             let facade_id = match chip_kind {
                 ProtoChipKind::BLUETOOTH => bluetooth_facade::bluetooth_add(
                     device_id,
                     &chip_create_proto.address,
                     &chip_create_proto.bt_properties,
+                    &snapshot_key,
                 ),
                 ProtoChipKind::BLUETOOTH_BEACON => bluetooth_facade::ble_beacon_add(
                     device_id,
@@ -157,7 +211,8 @@ pub fn add_chip(
                     chip_id,
                     chip_create_proto,
                 )?,
-                ProtoChipKind::WIFI => wifi_facade::wifi_add(device_id),
+                ProtoChipKind::WIFI => wifi_facade::wifi_add(device_id, &snapshot_key),
+                ProtoChipKind::UWB => uwb_facade::uwb_add(device_id),
                 _ => return Err(format!("Unknown chip kind: {:?}", chip_kind)),
             };
             // Add the facade_id into the resources
@@ -309,6 +364,7 @@ fn remove_device(
     let name = device.name.clone();
     let builtin = device.builtin;
     guard.entries.remove(&id).ok_or(format!("Error removing device with id {id}"))?;
+    guard.position_removed(id);
     // Publish DeviceRemoved Event
     events::publish(Event::DeviceRemoved { id, name, builtin });
     Ok(())
@@ -316,8 +372,19 @@ fn remove_device(
 
 /// Remove a chip from a device.
 ///
-/// Called when the packet transport for the chip shuts down.
+/// Called when the packet transport for the chip shuts down. The facade keeps
+/// the snapshot of the chip, so it resumes if its emulator reconnects.
 pub fn remove_chip(device_id: DeviceIdentifier, chip_id: ChipIdentifier) -> Result<(), String> {
+    remove_chip_with_snapshot(device_id, chip_id, true)
+}
+
+/// Remove a chip from a device, keeping its snapshot in the facade when
+/// keep_snapshot is set.
+fn remove_chip_with_snapshot(
+    device_id: DeviceIdentifier,
+    chip_id: ChipIdentifier,
+    keep_snapshot: bool,
+) -> Result<(), String> {
     let result = {
         let devices_arc = get_devices();
         let mut devices = devices_arc.write().unwrap();
@@ -348,10 +415,13 @@ pub fn remove_chip(device_id: DeviceIdentifier, chip_id: ChipIdentifier) -> Resu
             match facade_id_option {
                 Some(facade_id) => match chip_kind {
                     ProtoChipKind::BLUETOOTH => {
-                        bluetooth_facade::bluetooth_remove(facade_id);
+                        bluetooth_facade::bluetooth_remove(facade_id, keep_snapshot);
                     }
                     ProtoChipKind::WIFI => {
-                        wifi_facade::wifi_remove(facade_id);
+                        wifi_facade::wifi_remove(facade_id, keep_snapshot);
+                    }
+                    ProtoChipKind::UWB => {
+                        uwb_facade::uwb_remove(facade_id);
                     }
                     ProtoChipKind::BLUETOOTH_BEACON => {
                         bluetooth_facade::ble_beacon_remove(device_id, chip_id, facade_id)?;
@@ -386,7 +456,11 @@ pub fn delete_chip(delete_json: &str) -> Result<(), String> {
             delete_json
         ));
     };
+    delete_chip_proto(&request)
+}
 
+/// Delete the chip of a DeleteChipRequest.
+fn delete_chip_proto(request: &DeleteChipRequest) -> Result<(), String> {
     let device_id = {
         let devices_arc = get_devices();
         let devices = devices_arc.read().unwrap();
@@ -398,7 +472,8 @@ pub fn delete_chip(delete_json: &str) -> Result<(), String> {
             .ok_or(format!("failed to delete chip: could not find chip with id {}", request.id))?
     };
 
-    remove_chip(device_id, request.id)
+    // An explicit delete starts the next chip of the same name afresh.
+    remove_chip_with_snapshot(device_id, request.id, false)
 }
 
 /// A RemoveChip function for Rust Device API.
@@ -418,8 +493,14 @@ pub fn create_device(create_json: &str) -> Result<DeviceIdentifier, String> {
             create_json
         ));
     }
+    create_device_proto(&create_device_request)
+}
 
-    let new_device = create_device_request.device;
+/// Create a device from a CreateDeviceRequest.
+fn create_device_proto(
+    create_device_request: &CreateDeviceRequest,
+) -> Result<DeviceIdentifier, String> {
+    let new_device = &create_device_request.device;
     let devices_arc = get_devices();
     let mut devices = devices_arc.write().unwrap();
     // Check if specified device name is already mapped.
@@ -457,68 +538,93 @@ pub fn create_device(create_json: &str) -> Result<DeviceIdentifier, String> {
 fn patch_device(id_option: Option<DeviceIdentifier>, patch_json: &str) -> Result<(), String> {
     let mut patch_device_request = PatchDeviceRequest::new();
     if merge_from_str(&mut patch_device_request, patch_json).is_ok() {
-        let devices_arc = get_devices();
-        let mut devices = devices_arc.write().unwrap();
-        let proto_device = patch_device_request.device;
-        match id_option {
-            Some(id) => match devices.entries.get_mut(&id) {
-                Some(device) => {
-                    let result = device.patch(&proto_device);
-                    if result.is_ok() {
-                        // Publish Device Patched event
-                        events::publish(Event::DevicePatched { id, name: device.name.clone() });
-                    }
-                    result
-                }
-                None => Err(format!("No such device with id {id}")),
-            },
-            None => {
-                let mut multiple_matches = false;
-                let mut target: Option<&mut Device> = None;
-                for device in devices.entries.values_mut() {
-                    if device.name.contains(&proto_device.name) {
-                        if device.name == proto_device.name {
-                            let result = device.patch(&proto_device);
-                            if result.is_ok() {
-                                // Publish Device Patched event
-                                events::publish(Event::DevicePatched {
-                                    id: device.id,
-                                    name: device.name.clone(),
-                                });
-                            }
-                            return result;
-                        }
-                        multiple_matches = target.is_some();
-                        target = Some(device);
-                    }
-                }
-                if multiple_matches {
-                    return Err(format!(
-                        "Multiple ambiguous matches were found with substring {}",
-                        proto_device.name
-                    ));
-                }
-                match target {
-                    Some(device) => {
-                        let result = device.patch(&proto_device);
-                        if result.is_ok() {
-                            // Publish Device Patched event
-                            events::publish(Event::DevicePatched {
-                                id: device.id,
-                                name: device.name.clone(),
-                            });
-                        }
-                        result
-                    }
-                    None => Err(format!("No such device with name {}", proto_device.name)),
-                }
-            }
-        }
+        patch_device_proto(id_option, &patch_device_request)
     } else {
         Err(format!("Incorrect format of patch json {}", patch_json))
     }
 }
 
+// find the id of the device a patch applies to, by id or else by name: an
+// exact name match wins, otherwise the name must be a unique substring
+fn resolve_patch_target(
+    devices: &Devices,
+    id_option: Option<DeviceIdentifier>,
+    name: &str,
+) -> Result<DeviceIdentifier, String> {
+    if let Some(id) = id_option {
+        return match devices.entries.contains_key(&id) {
+            true => Ok(id),
+            false => Err(format!("No such device with id {id}")),
+        };
+    }
+    let mut multiple_matches = false;
+    let mut target: Option<DeviceIdentifier> = None;
+    for device in devices.entries.values() {
+        if device.name.contains(name) {
+            if device.name == name {
+                return Ok(device.id);
+            }
+            multiple_matches = target.is_some();
+            target = Some(device.id);
+        }
+    }
+    if multiple_matches {
+        return Err(format!("Multiple ambiguous matches were found with substring {}", name));
+    }
+    target.ok_or(format!("No such device with name {}", name))
+}
+
+// patch a device already resolved under the devices lock
+fn apply_patch(
+    devices: &mut Devices,
+    id: DeviceIdentifier,
+    patch_device_request: &PatchDeviceRequest,
+) -> Result<(), String> {
+    let device = devices.entries.get_mut(&id).ok_or(format!("No such device with id {id}"))?;
+    let result = device.patch(&patch_device_request.device);
+    if result.is_ok() {
+        // Publish Device Patched event
+        events::publish(Event::DevicePatched { id, name: device.name.clone() });
+    }
+    result
+}
+
+// lock the devices, find the id and call the patch function for a
+// PatchDeviceRequest
+fn patch_device_proto(
+    id_option: Option<DeviceIdentifier>,
+    patch_device_request: &PatchDeviceRequest,
+) -> Result<(), String> {
+    let devices_arc = get_devices();
+    let mut devices = devices_arc.write().unwrap();
+    let proto_device = &patch_device_request.device;
+    let id = resolve_patch_target(&devices, id_option, &proto_device.name)?;
+    if proto_device.position.is_some() {
+        devices.position_changed(id);
+    }
+    apply_patch(&mut devices, id, patch_device_request)
+}
+
+// lock the devices once for a batch of patches. Every device is resolved
+// before the first patch is applied, so an unknown or ambiguous device
+// rejects the whole batch without changing anything.
+fn patch_devices_proto(patch_devices_request: &PatchDevicesRequest) -> Result<(), String> {
+    let devices_arc = get_devices();
+    let mut devices = devices_arc.write().unwrap();
+    let ids = patch_devices_request
+        .patches
+        .iter()
+        .map(|patch| resolve_patch_target(&devices, None, &patch.device.name))
+        .collect::<Result<Vec<_>, _>>()?;
+    for (id, patch) in ids.into_iter().zip(patch_devices_request.patches.iter()) {
+        if patch.device.position.is_some() {
+            devices.position_changed(id);
+        }
+        apply_patch(&mut devices, id, patch)?;
+    }
+    Ok(())
+}
+
 fn distance(a: &ProtoPosition, b: &ProtoPosition) -> f32 {
     ((b.x - a.x).powf(2.0) + (b.y - a.y).powf(2.0) + (b.z - a.z).powf(2.0)).sqrt()
 }
@@ -540,6 +646,46 @@ fn get_distance(id: DeviceIdentifier, other_id: DeviceIdentifier) -> Result<f32,
     Ok(distance(&a, &b))
 }
 
+/// Returns the generation of device positions for the backend position cache.
+pub fn get_position_generation_cxx() -> u64 {
+    POSITION_GENERATION.load(Ordering::SeqCst)
+}
+
+/// Appends to `device_ids` the devices whose position changed or that were
+/// removed after `generation`, so position caches refresh only those.
+/// Returns false if the changes are no longer known, and then the caller
+/// refreshes every position.
+pub fn get_position_changes_cxx(generation: u64, device_ids: &mut Vec<u32>) -> bool {
+    let devices_arc = get_devices();
+    let devices = devices_arc.read().unwrap();
+    if generation < devices.removed_floor {
+        return false;
+    }
+    device_ids.extend(
+        devices.position_generations.iter().filter(|(_, g)| **g > generation).map(|(id, _)| *id),
+    );
+    device_ids.extend(
+        devices.removed_positions.iter().filter(|(g, _)| *g > generation).map(|(_, id)| *id),
+    );
+    true
+}
+
+/// Copies the x, y, z position of a device into `position`.
+/// Returns false if there is no such device.
+pub fn get_position_cxx(device_id: u32, position: &mut [f32]) -> bool {
+    let devices_arc = get_devices();
+    let devices = devices_arc.read().unwrap();
+    match devices.entries.get(&device_id) {
+        Some(device) if position.len() >= 3 => {
+            position[0] = device.position.x;
+            position[1] = device.position.y;
+            position[2] = device.position.z;
+            true
+        }
+        _ => false,
+    }
+}
+
 /// A GetDistance function for Rust Device API.
 /// The backend gRPC code will be invoking this method.
 pub fn get_distance_cxx(a: u32, b: u32) -> f32 {
@@ -552,7 +698,6 @@ pub fn get_distance_cxx(a: u32, b: u32) -> f32 {
     }
 }
 
-#[allow(dead_code)]
 pub fn get_devices_proto() -> Result<ProtoScene, String> {
     let mut scene = ProtoScene::new();
     // iterate over the devices and add each to the scene
@@ -567,6 +712,10 @@ pub fn get_devices_proto() -> Result<ProtoScene, String> {
 fn reset_all() -> Result<(), String> {
     let devices_arc = get_devices();
     let mut devices = devices_arc.write().unwrap();
+    let ids: Vec<DeviceIdentifier> = devices.entries.keys().copied().collect();
+    for id in ids {
+        devices.position_changed(id);
+    }
     for device in devices.entries.values_mut() {
         device.reset()?;
         // Publish Device Patched event
@@ -575,16 +724,19 @@ fn reset_all() -> Result<(), String> {
     Ok(())
 }
 
-fn handle_device_create(writer: ResponseWritable, create_json: &str) {
+/// Builds the CreateDeviceResponse of a created device.
+fn create_device_response(id: DeviceIdentifier) -> Result<CreateDeviceResponse, String> {
+    let devices_arc = get_devices();
+    let devices = devices_arc.read().unwrap();
+    let device_proto = devices.entries.get(&id).ok_or("failed to create device")?.get()?;
     let mut response = CreateDeviceResponse::new();
+    response.device = MessageField::some(device_proto);
+    Ok(response)
+}
 
-    let mut collate_results = || {
-        let id = create_device(create_json)?;
-
-        let devices_arc = get_devices();
-        let devices = devices_arc.read().unwrap();
-        let device_proto = devices.entries.get(&id).ok_or("failed to create device")?.get()?;
-        response.device = MessageField::some(device_proto);
+fn handle_device_create(writer: ResponseWritable, create_json: &str) {
+    let collate_results = || {
+        let response = create_device_response(create_device(create_json)?)?;
         print_to_string(&response).map_err(|_| String::from("failed to convert device to json"))
     };
 
@@ -609,8 +761,8 @@ fn handle_chip_delete(writer: ResponseWritable, delete_json: &str) {
     }
 }
 
-/// Performs ListDevices to get the list of Devices and write to writer.
-fn handle_device_list(writer: ResponseWritable) {
+/// Builds the ListDeviceResponse with all the devices.
+fn list_device_response() -> ListDeviceResponse {
     let devices_arc = get_devices();
     let devices = devices_arc.read().unwrap();
     // Instantiate ListDeviceResponse and add Devices
@@ -618,6 +770,12 @@ fn handle_device_list(writer: ResponseWritable) {
     for device in devices.entries.values() {
         response.devices.push(device.get().unwrap());
     }
+    response
+}
+
+/// Performs ListDevices to get the list of Devices and write to writer.
+fn handle_device_list(writer: ResponseWritable) {
+    let response = list_device_response();
 
     // Perform protobuf-json-mapping with the given protobuf
     if let Ok(json_response) = print_to_string_with_options(&response, &JSON_PRINT_OPTION) {
@@ -648,7 +806,7 @@ fn handle_device_subscribe(writer: ResponseWritable) {
     }
 }
 
-/// The Rust device handler used directly by Http frontend or handle_device_cxx for LIST, GET, and PATCH
+/// The Rust device handler used directly by Http frontend for LIST, GET, and PATCH
 pub fn handle_device(request: &Request<Vec<u8>>, param: &str, writer: ResponseWritable) {
     // Route handling
     if request.uri() == "/v1/devices" {
@@ -700,32 +858,55 @@ pub fn handle_device(request: &Request<Vec<u8>>, param: &str, writer: ResponseWr
     }
 }
 
-/// Device handler cxx for grpc server to call
-pub fn handle_device_cxx(
+/// Device handler cxx for the grpc server, with the request body and the
+/// response encoded as binary protobuf. JSON is only used by the HTTP server.
+pub fn handle_device_proto_cxx(
     responder: Pin<&mut CxxServerResponseWriter>,
     method: String,
     param: String,
-    body: String,
+    body: &[u8],
 ) {
-    let mut builder = Request::builder().method(method.as_str());
-    if param.is_empty() {
-        builder = builder.uri("/v1/devices");
-    } else {
-        builder = builder.uri(format!("/v1/devices/{}", param));
-    }
-    builder = builder.version(Version::HTTP_11);
-    let request = match builder.body(body.as_bytes().to_vec()) {
-        Ok(request) => request,
-        Err(err) => {
-            warn!("{err:?}");
-            return;
+    fn encode<M: Message>(message: &M) -> Result<Vec<u8>, String> {
+        message.write_to_bytes().map_err(|err| format!("failed to encode response: {err}"))
+    }
+    let writer: ResponseWritable = &mut CxxServerResponseWriterWrapper { writer: responder };
+    let result = match method.as_str() {
+        "GET" => encode(&list_device_response()),
+        "PUT" => reset_all().map(|()| Vec::new()),
+        "POST" => CreateDeviceRequest::parse_from_bytes(body)
+            .map_err(|err| format!("failed to create device: {err}"))
+            .and_then(|request| create_device_proto(&request))
+            .and_then(create_device_response)
+            .and_then(|response| encode(&response)),
+        "PATCH" => {
+            let id = match param.as_str() {
+                "" => Ok(None),
+                param => param
+                    .parse::<u32>()
+                    .map(Some)
+                    .map_err(|_| String::from("Incorrect Id type for devices, ID should be u32.")),
+            };
+            id.and_then(|id| {
+                PatchDeviceRequest::parse_from_bytes(body)
+                    .map_err(|err| format!("Incorrect format of patch request: {err}"))
+                    .and_then(|request| patch_device_proto(id, &request))
+            })
+            .map(|()| Vec::new())
         }
+        "PATCH_DEVICES" => PatchDevicesRequest::parse_from_bytes(body)
+            .map_err(|err| format!("Incorrect format of patch request: {err}"))
+            .and_then(|request| patch_devices_proto(&request))
+            .map(|()| Vec::new()),
+        "DELETE" => DeleteChipRequest::parse_from_bytes(body)
+            .map_err(|err| format!("failed to delete chip: {err}"))
+            .and_then(|request| delete_chip_proto(&request))
+            .map(|()| Vec::new()),
+        _ => Err(String::from("Not found.")),
     };
-    handle_device(
-        &request,
-        param.as_str(),
-        &mut CxxServerResponseWriterWrapper { writer: responder },
-    )
+    match result {
+        Ok(bytes) => writer.put_ok_with_vec("application/x-protobuf", bytes, vec![]),
+        Err(err) => writer.put_error(404, err.as_str()),
+    }
 }
 
 /// Get Facade ID from given chip_id
@@ -811,6 +992,7 @@ pub fn wait_devices(events_rx: Receiver<Event>) {
 #[cfg(test)]
 mod tests {
     use crate::events;
+    use http::Version;
     use netsim_common::util::netsim_logger::init_for_test;
     use netsim_proto::model::{
         Device as ProtoDevice, DeviceCreate as ProtoDeviceCreate, Orientation as ProtoOrientation,
@@ -959,6 +1141,18 @@ mod tests {
         );
     }
 
+    #[test]
+    fn test_snapshot_key() {
+        assert_eq!(
+            snapshot_key("emulator-5554", ProtoChipKind::BLUETOOTH, ""),
+            "emulator-5554/BLUETOOTH/"
+        );
+        assert_ne!(
+            snapshot_key("emulator-5554", ProtoChipKind::WIFI, "wifi"),
+            snapshot_key("emulator-5556", ProtoChipKind::WIFI, "wifi")
+        );
+    }
+
     #[test]
     fn test_get_or_create_device() {
         // Initializing Logger
@@ -1011,6 +1205,59 @@ mod tests {
         assert!(patch_device(None, patch_json.as_str()).is_ok());
     }
 
+    #[test]
+    fn test_get_position_cxx() {
+        // Initializing Logger
+        logger_setup();
+
+        let chip_params = test_chip_1_bt();
+        let chip_result = chip_params.add_chip().unwrap();
+        let generation = get_position_generation_cxx();
+        let mut patch_device_request = PatchDeviceRequest::new();
+        let mut proto_device = ProtoDevice::new();
+        proto_device.name = chip_params.device_name;
+        proto_device.position = Some(new_position(1.0, 2.0, 3.0)).into();
+        patch_device_request.device = Some(proto_device).into();
+        let patch_json = print_to_string(&patch_device_request).unwrap();
+        patch_device(Some(chip_result.device_id), patch_json.as_str()).unwrap();
+        assert!(get_position_generation_cxx() > generation);
+
+        let mut position = [0.0; 3];
+        assert!(get_position_cxx(chip_result.device_id, &mut position));
+        assert_eq!(position, [1.0, 2.0, 3.0]);
+        assert!(!get_position_cxx(0, &mut position));
+    }
+
+    #[test]
+    fn test_get_position_changes_cxx() {
+        // Initializing Logger
+        logger_setup();
+
+        let chip_params = test_chip_1_bt();
+        let chip_result = chip_params.add_chip().unwrap();
+        let generation = get_position_generation_cxx();
+        let mut patch_device_request = PatchDeviceRequest::new();
+        let mut proto_device = ProtoDevice::new();
+        proto_device.name = chip_params.device_name;
+        proto_device.position = Some(new_position(1.0, 2.0, 3.0)).into();
+        patch_device_request.device = Some(proto_device).into();
+        let patch_json = print_to_string(&patch_device_request).unwrap();
+        patch_device(Some(chip_result.device_id), patch_json.as_str()).unwrap();
+
+        let mut device_ids = Vec::new();
+        assert!(get_position_changes_cxx(generation, &mut device_ids));
+        assert!(device_ids.contains(&chip_result.device_id));
+
+        // Nothing new since the patch, and the removal of the device is a change
+        let moved = get_position_generation_cxx();
+        let mut device_ids = Vec::new();
+        assert!(get_position_changes_cxx(moved, &mut device_ids));
+        assert!(!device_ids.contains(&chip_result.device_id));
+        remove_chip(chip_result.device_id, chip_result.chip_id).unwrap();
+        assert!(get_position_changes_cxx(moved, &mut device_ids));
+        assert!(device_ids.contains(&chip_result.device_id));
+    }
+
     #[test]
     fn test_patch_error() {
         // Initializing Logger
@@ -1071,6 +1318,49 @@ mod tests {
         );
     }
 
+    #[test]
+    fn test_patch_devices() {
+        // Initializing Logger
+        logger_setup();
+
+        let bt_chip_params = test_chip_1_bt();
+        let bt_chip2_params = test_chip_2_bt();
+        let bt_chip_result = bt_chip_params.add_chip().unwrap();
+        let bt_chip2_result = bt_chip2_params.add_chip().unwrap();
+        let new_patch = |name: &str, position: ProtoPosition| {
+            let mut proto_device = ProtoDevice::new();
+            proto_device.name = name.to_string();
+            proto_device.position = Some(position).into();
+            let mut patch_device_request = PatchDeviceRequest::new();
+            patch_device_request.device = Some(proto_device).into();
+            patch_device_request
+        };
+        let position_of = |id: DeviceIdentifier| {
+            get_devices().read().unwrap().entries.get(&id).unwrap().position.clone()
+        };
+
+        // Both devices move under one lock
+        let mut request = PatchDevicesRequest::new();
+        request.patches.push(new_patch(&bt_chip_params.device_name, new_position(1.0, 2.0, 3.0)));
+        request.patches.push(new_patch(&bt_chip2_params.device_name, new_position(4.0, 5.0, 6.0)));
+        let generation = get_position_generation_cxx();
+        patch_devices_proto(&request).unwrap();
+        assert!(get_position_generation_cxx() > generation);
+        assert_eq!(position_of(bt_chip_result.device_id), new_position(1.0, 2.0, 3.0));
+        assert_eq!(position_of(bt_chip2_result.device_id), new_position(4.0, 5.0, 6.0));
+
+        // An unknown device rejects the batch and leaves both devices in place
+        let mut request = PatchDevicesRequest::new();
+        request.patches.push(new_patch(&bt_chip_params.device_name, new_position(7.0, 8.0, 9.0)));
+        request.patches.push(new_patch("wrong-name", new_position(7.0, 8.0, 9.0)));
+        assert_eq!(
+            patch_devices_proto(&request).unwrap_err(),
+            "No such device with name wrong-name"
+        );
+        assert_eq!(position_of(bt_chip_result.device_id), new_position(1.0, 2.0, 3.0));
+        assert_eq!(position_of(bt_chip2_result.device_id), new_position(4.0, 5.0, 6.0));
+    }
+
     #[test]
     fn test_adding_two_chips() {
         // Initializing Logger
@@ -0,0 +1,195 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+//! Radio facades started in the background.
+//!
+//! netsimd starts the Bluetooth and WiFi facades on their own threads and
+//! opens the gRPC server meanwhile, so clients connect without waiting for
+//! rootcanal, hostapd and slirp. A chip added while its facade is still
+//! starting waits for it in `wait_started`, and is refused if the start
+//! panicked.
+
+use lazy_static::lazy_static;
+use log::info;
+use netsim_proto::common::ChipKind;
+use std::sync::{Condvar, Mutex};
+use std::thread::JoinHandle;
+use std::time::Instant;
+
+/// A radio facade with a start function.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum Facade {
+    Bluetooth,
+    Wifi,
+}
+
+impl Facade {
+    /// Returns the facade of the chips of a kind, if it has to be started.
+    pub fn of(chip_kind: ChipKind) -> Option<Facade> {
+        match chip_kind {
+            ChipKind::BLUETOOTH | ChipKind::BLUETOOTH_BEACON => Some(Facade::Bluetooth),
+            ChipKind::WIFI => Some(Facade::Wifi),
+            _ => None,
+        }
+    }
+
+    fn index(self) -> usize {
+        self as usize
+    }
+}
+
+#[derive(Clone, Copy, Debug, Default, PartialEq, Eq)]
+enum State {
+    /// Started, or never started as in unit tests.
+    #[default]
+    Ready,
+    Starting,
+    /// The start function panicked.
+    Failed,
+}
+
+/// The states of the facades.
+#[derive(Default)]
+pub struct FacadeStartup {
+    states: Mutex<[State; 2]>,
+    started: Condvar,
+}
+
+impl FacadeStartup {
+    fn begin(&self, facade: Facade) {
+        self.states.lock().unwrap()[facade.index()] = State::Starting;
+    }
+
+    fn finish(&self, facade: Facade, state: State) {
+        self.states.lock().unwrap()[facade.index()] = state;
+        self.started.notify_all();
+    }
+
+    /// Blocks while the facade is starting. Returns an error if it failed.
+    pub fn wait(&self, facade: Facade) -> Result<(), String> {
+        let states = self.states.lock().unwrap();
+        let states = self
+            .started
+            .wait_while(states, |states| states[facade.index()] == State::Starting)
+            .unwrap();
+        match states[facade.index()] {
+            State::Failed => Err(format!("{facade:?} facade failed to start")),
+            _ => Ok(()),
+        }
+    }
+}
+
+/// Finishes a start when dropped, as failed if the start function
+/// panicked, so the chips waiting for the facade are released either way.
+struct FinishGuard {
+    startup: &'static FacadeStartup,
+    facade: Facade,
+}
+
+impl Drop for FinishGuard {
+    fn drop(&mut self) {
+        let state = if std::thread::panicking() { State::Failed } else { State::Ready };
+        self.startup.finish(self.facade, state);
+    }
+}
+
+lazy_static! {
+    static ref FACADE_STARTUP: FacadeStartup = FacadeStartup::default();
+}
+
+fn spawn_with(
+    startup: &'static FacadeStartup,
+    facade: Facade,
+    start: impl FnOnce() + Send + 'static,
+) -> JoinHandle<()> {
+    // Marked before the thread exists, so a chip added right after the spawn
+    // waits.
+    startup.begin(facade);
+    std::thread::Builder::new()
+        .name(format!("{facade:?}_start").to_lowercase())
+        .spawn(move || {
+            let _finish = FinishGuard { startup, facade };
+            let begin = Instant::now();
+            start();
+            info!("{facade:?} facade started in {:?}", begin.elapsed());
+        })
+        .expect("failed to spawn facade start thread")
+}
+
+/// Runs the start function of a facade on a new thread.
+pub fn spawn_start(facade: Facade, start: impl FnOnce() + Send + 'static) -> JoinHandle<()> {
+    spawn_with(&FACADE_STARTUP, facade, start)
+}
+
+/// Blocks until the facade of the chip kind has started. Returns an error
+/// if its start failed.
+pub fn wait_started(chip_kind: ChipKind) -> Result<(), String> {
+    match Facade::of(chip_kind) {
+        Some(facade) => FACADE_STARTUP.wait(facade),
+        None => Ok(()),
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use std::sync::mpsc::channel;
+    use std::time::Duration;
+
+    #[test]
+    fn test_wait_never_started() {
+        assert!(FacadeStartup::default().wait(Facade::Bluetooth).is_ok());
+        assert!(wait_started(ChipKind::UWB).is_ok());
+    }
+
+    #[test]
+    fn test_wait_blocks_until_started() {
+        lazy_static! {
+            static ref STARTUP: FacadeStartup = FacadeStartup::default();
+        }
+        let (release_tx, release_rx) = channel::<()>();
+        let handle = spawn_with(&STARTUP, Facade::Wifi, move || {
+            release_rx.recv().unwrap();
+        });
+        // The other facade is not held up.
+        assert!(STARTUP.wait(Facade::Bluetooth).is_ok());
+        let (done_tx, done_rx) = channel();
+        let waiter = std::thread::spawn(move || {
+            done_tx.send(STARTUP.wait(Facade::Wifi)).unwrap();
+        });
+        assert!(done_rx.recv_timeout(Duration::from_millis(50)).is_err());
+        release_tx.send(()).unwrap();
+        assert!(done_rx.recv_timeout(Duration::from_secs(5)).unwrap().is_ok());
+        handle.join().unwrap();
+        waiter.join().unwrap();
+    }
+
+    #[test]
+    fn test_wait_fails_when_start_panics() {
+        lazy_static! {
+            static ref STARTUP: FacadeStartup = FacadeStartup::default();
+        }
+        let handle = spawn_with(&STARTUP, Facade::Bluetooth, || panic!("no controller"));
+        assert!(handle.join().is_err());
+        assert!(STARTUP.wait(Facade::Bluetooth).is_err());
+        assert!(STARTUP.wait(Facade::Wifi).is_ok());
+    }
+
+    #[test]
+    fn test_facade_of_chip_kind() {
+        assert_eq!(Facade::of(ChipKind::BLUETOOTH_BEACON), Some(Facade::Bluetooth));
+        assert_eq!(Facade::of(ChipKind::WIFI), Some(Facade::Wifi));
+        assert_eq!(Facade::of(ChipKind::UWB), None);
+    }
+}
@@ -14,5 +14,7 @@
 
 pub mod chip;
 pub mod device;
+pub mod device_watcher;
 pub mod devices_handler;
+pub mod facade_startup;
 pub mod id_factory;
@@ -17,18 +17,24 @@
 use std::pin::Pin;
 
 use crate::bluetooth::chip::{
-    create_add_rust_device_result, AddRustDeviceResult, RustBluetoothChipCallbacks,
+    create_add_rust_device_result, parse_received_packets, AddRustDeviceResult, ReceivedPacket,
+    RustBluetoothChipCallbacks,
 };
 use crate::http_server::server_response::ServerResponseWritable;
 use crate::http_server::server_response::StrHeaders;
 use cxx::let_cxx_string;
 
-use crate::transport::dispatcher::{handle_request_cxx, handle_response};
+use crate::transport::dispatcher::{
+    handle_request_cxx, handle_response, handle_response_multicast,
+};
 use crate::transport::grpc::{register_grpc_transport, unregister_grpc_transport};
 
-use crate::captures::captures_handler::handle_capture_cxx;
+use crate::captures::capture_tail::{new_capture_tail_cxx, CaptureTail};
+use crate::captures::captures_handler::{handle_capture_cxx, handle_capture_get_cxx};
+use crate::devices::device_watcher::{new_device_watcher_cxx, DeviceWatcher};
 use crate::devices::devices_handler::{
-    add_chip_cxx, get_distance_cxx, handle_device_cxx, remove_chip_cxx, AddChipResultCxx,
+    add_chip_cxx, get_distance_cxx, get_position_changes_cxx, get_position_cxx,
+    get_position_generation_cxx, handle_device_proto_cxx, remove_chip_cxx, AddChipResultCxx,
 };
 use crate::ranging::*;
 use crate::version::*;
@@ -38,11 +44,14 @@ use crate::version::*;
 pub mod ffi_transport {
     extern "Rust" {
         #[cxx_name = HandleRequestCxx]
-        fn handle_request_cxx(kind: u32, facade_id: u32, packet: &CxxVector<u8>, packet_type: u8);
+        fn handle_request_cxx(kind: u32, facade_id: u32, packet: &PacketBuffer, packet_type: u8);
 
         #[cxx_name = HandleResponse]
         fn handle_response(kind: u32, facade_id: u32, packet: &CxxVector<u8>, packet_type: u8);
 
+        #[cxx_name = HandleResponseMulticast]
+        fn handle_response_multicast(kind: u32, facade_ids: &[u32], packet: &[u8], packet_type: u8);
+
         #[cxx_name = RegisterGrpcTransport]
         fn register_grpc_transport(kind: u32, facade_id: u32);
 
@@ -51,12 +60,21 @@ pub mod ffi_transport {
     }
 
     unsafe extern "C++" {
+        // Packet payload owned by C++ and passed by handle.
+        include!("util/packet_buffer.h");
+
+        #[namespace = "netsim::util"]
+        type PacketBuffer;
+        #[rust_name = as_slice]
+        #[namespace = "netsim::util"]
+        fn AsSlice(self: &PacketBuffer) -> &[u8];
+
         // Grpc server.
         include!("backend/backend_packet_hub.h");
 
         #[rust_name = handle_grpc_response]
         #[namespace = "netsim::backend"]
-        fn HandleResponseCxx(kind: u32, facade_id: u32, packet: &Vec<u8>, packet_type: u8);
+        fn HandleResponseCxx(kind: u32, facade_id: u32, packet: &[u8], packet_type: u8);
 
         include!("core/server.h");
 
@@ -70,12 +88,19 @@ pub mod ffi_transport {
         #[namespace = "netsim::server"]
         fn GetGrpcPort(self: &GrpcServer) -> u32;
 
+        #[rust_name = get_frontend_grpc_port]
+        #[namespace = "netsim::server"]
+        fn GetFrontendGrpcPort(self: &GrpcServer) -> u32;
+
         #[rust_name = run_grpc_server_cxx]
         #[namespace = "netsim::server"]
         pub fn RunGrpcServerCxx(
             netsim_grpc_port: u32,
             no_cli_ui: bool,
             vsock: u16,
+            callback_api: bool,
+            uds_path: &str,
+            options: &[u8],
         ) -> UniquePtr<GrpcServer>;
 
         // Grpc client.
@@ -116,20 +141,29 @@ pub mod ffi_bluetooth {
         #[namespace = "netsim::hci::facade"]
         type DynRustBluetoothChipCallbacks;
 
+        /// Returns the delay in milliseconds before the next tick, or
+        /// u64::MAX to wait for WakeRustDevice.
         #[cxx_name = Tick]
         #[namespace = "netsim::hci::facade"]
-        fn tick(dyn_callbacks: &mut DynRustBluetoothChipCallbacks);
+        fn tick(dyn_callbacks: &mut DynRustBluetoothChipCallbacks) -> u64;
 
         #[cxx_name = ReceiveLinkLayerPacket]
         #[namespace = "netsim::hci::facade"]
         fn receive_link_layer_packet(
             dyn_callbacks: &mut DynRustBluetoothChipCallbacks,
-            source_address: String,
-            destination_address: String,
+            source_address: [u8; 6],
+            destination_address: [u8; 6],
             packet_type: u8,
             packet: &[u8],
         );
 
+        #[cxx_name = ReceiveLinkLayerPackets]
+        #[namespace = "netsim::hci::facade"]
+        fn receive_link_layer_packets(
+            dyn_callbacks: &mut DynRustBluetoothChipCallbacks,
+            batch: &[u8],
+        );
+
         // Bluetooth facade.
         #[namespace = "netsim::hci::facade"]
         type AddRustDeviceResult;
@@ -150,6 +184,13 @@ pub mod ffi_bluetooth {
         #[namespace = "netsim::hci"]
         fn HandleBtRequestCxx(facade_id: u32, packet_type: u8, packet: &Vec<u8>);
 
+        #[namespace = "netsim::util"]
+        type PacketBuffer = crate::ffi::ffi_transport::PacketBuffer;
+
+        #[rust_name = handle_bt_request_buffer]
+        #[namespace = "netsim::hci"]
+        fn HandleBtRequestBufferCxx(facade_id: u32, packet_type: u8, packet: &PacketBuffer);
+
         // Rust Bluetooth device.
         include!("hci/rust_device.h");
 
@@ -175,11 +216,16 @@ pub mod ffi_bluetooth {
 
         #[rust_name = bluetooth_remove]
         #[namespace = "netsim::hci::facade"]
-        pub fn Remove(facade_id: u32);
+        pub fn Remove(facade_id: u32, keep_snapshot: bool);
 
         #[rust_name = bluetooth_add]
         #[namespace = "netsim::hci::facade"]
-        pub fn Add(_chip_id: u32, address: &CxxString, controller_proto_bytes: &[u8]) -> u32;
+        pub fn Add(
+            _chip_id: u32,
+            address: &CxxString,
+            controller_proto_bytes: &[u8],
+            snapshot_key: &CxxString,
+        ) -> u32;
 
         /*
         From https://cxx.rs/binding/box.html#restrictions,
@@ -199,6 +245,7 @@ pub mod ffi_bluetooth {
             callbacks: Box<DynRustBluetoothChipCallbacks>,
             string_type: &CxxString,
             address: &CxxString,
+            batch_receive: bool,
         ) -> Box<AddRustDeviceResult>;
 
         /// The provided address must be 6 bytes in length
@@ -206,17 +253,32 @@ pub mod ffi_bluetooth {
         #[namespace = "netsim::hci::facade"]
         pub fn SetRustDeviceAddress(facade_id: u32, address: [u8; 6]);
 
+        #[rust_name = bluetooth_wake_rust_device]
+        #[namespace = "netsim::hci::facade"]
+        pub fn WakeRustDevice(facade_id: u32);
+
         #[rust_name = bluetooth_remove_rust_device]
         #[namespace = "netsim::hci::facade"]
         pub fn RemoveRustDevice(facade_id: u32);
 
         #[rust_name = bluetooth_start]
         #[namespace = "netsim::hci::facade"]
-        pub fn Start(proto_bytes: &[u8], instance_num: u16, disable_address_reuse: bool);
+        pub fn Start(
+            proto_bytes: &[u8],
+            instance_num: u16,
+            disable_address_reuse: bool,
+            num_shards: u16,
+        );
 
         #[rust_name = bluetooth_stop]
         #[namespace = "netsim::hci::facade"]
         pub fn Stop();
+
+        include!("hci/packet_latency.h");
+
+        #[rust_name = get_latency_stats]
+        #[namespace = "netsim::hci"]
+        pub fn GetLatencyStatsCxx() -> Vec<u8>;
     }
 }
 
@@ -231,6 +293,13 @@ pub mod ffi_wifi {
         #[namespace = "netsim::wifi"]
         fn HandleWifiRequestCxx(facade_id: u32, packet: &Vec<u8>);
 
+        #[namespace = "netsim::util"]
+        type PacketBuffer = crate::ffi::ffi_transport::PacketBuffer;
+
+        #[rust_name = handle_wifi_request_buffer]
+        #[namespace = "netsim::wifi"]
+        fn HandleWifiRequestBufferCxx(facade_id: u32, packet: &PacketBuffer);
+
         include!("wifi/wifi_facade.h");
 
         #[rust_name = wifi_patch_cxx]
@@ -243,10 +312,10 @@ pub mod ffi_wifi {
         pub fn Reset(facade_id: u32);
 
         #[rust_name = wifi_remove]
-        pub fn Remove(facade_id: u32);
+        pub fn Remove(facade_id: u32, keep_snapshot: bool);
 
         #[rust_name = wifi_add]
-        pub fn Add(_chip_id: u32) -> u32;
+        pub fn Add(_chip_id: u32, snapshot_key: &CxxString) -> u32;
 
         #[rust_name = wifi_start]
         pub fn Start(proto_bytes: &[u8]);
@@ -257,6 +326,43 @@ pub mod ffi_wifi {
     }
 }
 
+#[cxx::bridge(namespace = "netsim::uwb::facade")]
+pub mod ffi_uwb {
+    #[allow(dead_code)]
+    unsafe extern "C++" {
+        // UWB facade.
+        include!("uwb/uwb_packet_hub.h");
+
+        #[rust_name = handle_uwb_request]
+        #[namespace = "netsim::uwb"]
+        fn HandleUwbRequestCxx(facade_id: u32, packet: &Vec<u8>);
+
+        #[namespace = "netsim::util"]
+        type PacketBuffer = crate::ffi::ffi_transport::PacketBuffer;
+
+        #[rust_name = handle_uwb_request_buffer]
+        #[namespace = "netsim::uwb"]
+        fn HandleUwbRequestBufferCxx(facade_id: u32, packet: &PacketBuffer);
+
+        include!("uwb/uwb_facade.h");
+
+        #[rust_name = uwb_patch_cxx]
+        pub fn PatchCxx(facade_id: u32, proto_bytes: &[u8]);
+
+        #[rust_name = uwb_get_cxx]
+        pub fn GetCxx(facade_id: u32) -> Vec<u8>;
+
+        #[rust_name = uwb_reset]
+        pub fn Reset(facade_id: u32);
+
+        #[rust_name = uwb_remove]
+        pub fn Remove(facade_id: u32);
+
+        #[rust_name = uwb_add]
+        pub fn Add(_chip_id: u32) -> u32;
+    }
+}
+
 #[allow(unsafe_op_in_unsafe_fn)]
 #[cxx::bridge(namespace = "netsim::device")]
 pub mod ffi_devices {
@@ -291,6 +397,22 @@ pub mod ffi_devices {
 
         #[cxx_name = GetDistanceCxx]
         fn get_distance_cxx(a: u32, b: u32) -> f32;
+
+        #[cxx_name = GetPositionGenerationCxx]
+        fn get_position_generation_cxx() -> u64;
+
+        #[cxx_name = GetPositionChangesCxx]
+        fn get_position_changes_cxx(generation: u64, device_ids: &mut Vec<u32>) -> bool;
+
+        #[cxx_name = GetPositionCxx]
+        fn get_position_cxx(device_id: u32, position: &mut [f32]) -> bool;
+
+        // Device changes for the WatchDevices stream
+        type DeviceWatcher;
+        #[cxx_name = NewDeviceWatcherCxx]
+        fn new_device_watcher_cxx() -> Box<DeviceWatcher>;
+        #[cxx_name = "Poll"]
+        fn poll(self: &mut DeviceWatcher) -> Vec<u8>;
     }
 }
 
@@ -308,13 +430,29 @@ pub mod ffi_response_writable {
             body: String,
         );
 
-        #[cxx_name = "HandleDeviceCxx"]
-        fn handle_device_cxx(
+        #[cxx_name = "HandleCaptureGetCxx"]
+        fn handle_capture_get_cxx(
+            responder: Pin<&mut CxxServerResponseWriter>,
+            id: u32,
+            offset: u64,
+        );
+
+        #[cxx_name = "HandleDeviceProtoCxx"]
+        fn handle_device_proto_cxx(
             responder: Pin<&mut CxxServerResponseWriter>,
             method: String,
             param: String,
-            body: String,
+            body: &[u8],
         );
+
+        // Live packets of a chip for the TailCapture stream
+        type CaptureTail;
+        #[cxx_name = "NewCaptureTailCxx"]
+        fn new_capture_tail_cxx(id: u32, filter: &[u8]) -> Box<CaptureTail>;
+        #[cxx_name = "IsError"]
+        fn is_error(self: &CaptureTail) -> bool;
+        #[cxx_name = "Next"]
+        fn next(self: &CaptureTail, timeout_ms: u32) -> Vec<u8>;
     }
     unsafe extern "C++" {
         /// A C++ class which can be used to respond to a request.
@@ -351,6 +489,11 @@ pub mod ffi_util {
 
         #[cxx_name = "GetVersion"]
         fn get_version() -> String;
+
+        // Buffers
+
+        #[cxx_name = "VecFromSlice"]
+        fn vec_from_slice(bytes: &[u8]) -> Vec<u8>;
     }
 
     #[allow(dead_code)]
@@ -363,6 +506,13 @@ pub mod ffi_util {
         #[namespace = "netsim::osutils"]
         pub fn RedirectStdStream(netsim_temp_dir: &CxxString);
 
+        // Logging.
+        include!("util/log.h");
+
+        #[rust_name = set_bts_log_priority]
+        #[namespace = "netsim"]
+        pub fn setBtsLogPriority(priority: i32);
+
         // Crash report.
         include!("util/crash_report.h");
 
@@ -370,6 +520,49 @@ pub mod ffi_util {
         #[namespace = "netsim"]
         pub fn SetUpCrashReport();
 
+        // Packet pool.
+        include!("util/packet_buffer.h");
+
+        #[rust_name = get_packet_pool_stats]
+        #[namespace = "netsim::util"]
+        pub fn GetPacketPoolStatsCxx(stats: &mut [u64]);
+
+        // Thread placement.
+        include!("util/thread_affinity.h");
+
+        #[rust_name = set_thread_class_cpus]
+        #[namespace = "netsim::util"]
+        pub fn SetThreadClassCpusCxx(thread_class: u32, cpus: &CxxString) -> bool;
+
+        // Trace points.
+        include!("core/tracing.h");
+
+        #[rust_name = get_trace_counters]
+        #[namespace = "netsim::tracing"]
+        pub fn GetTraceCountersCxx() -> Vec<u8>;
+
+        // Simulation snapshots.
+        include!("core/snapshot.h");
+
+        #[rust_name = save_snapshot]
+        #[namespace = "netsim::snapshot"]
+        pub fn SaveSnapshotCxx(path: &CxxString) -> bool;
+
+        #[rust_name = load_snapshot]
+        #[namespace = "netsim::snapshot"]
+        pub fn LoadSnapshotCxx(path: &CxxString) -> bool;
+
+        // Federation.
+        include!("core/federation.h");
+
+        #[rust_name = federation_start]
+        #[namespace = "netsim::federation"]
+        pub fn StartCxx(proto_bytes: &[u8]);
+
+        #[rust_name = federation_stop]
+        #[namespace = "netsim::federation"]
+        pub fn Stop();
+
         // Frontend client.
         include!("frontend/frontend_client_stub.h");
 
@@ -380,6 +573,12 @@ pub mod ffi_util {
     }
 }
 
+/// Copies bytes into a new Vec with a single allocation and copy. C++ can
+/// only grow a rust::Vec one element at a time.
+fn vec_from_slice(bytes: &[u8]) -> Vec<u8> {
+    bytes.to_vec()
+}
+
 // It's required so `RustBluetoothChip` can be sent between threads safely.
 // Ref: How to use opaque types in threads? https://github.com/dtolnay/cxx/issues/1175
 // SAFETY: Nothing in `RustBluetoothChip` depends on being run on a particular thread.
@@ -387,14 +586,18 @@ unsafe impl Send for ffi_bluetooth::RustBluetoothChip {}
 
 type DynRustBluetoothChipCallbacks = Box<dyn RustBluetoothChipCallbacks>;
 
-fn tick(dyn_callbacks: &mut DynRustBluetoothChipCallbacks) {
-    (**dyn_callbacks).tick();
+fn tick(dyn_callbacks: &mut DynRustBluetoothChipCallbacks) -> u64 {
+    // Round up so the chip is never ticked before it is due.
+    (**dyn_callbacks).tick().map_or(u64::MAX, |delay| {
+        let micros = delay.as_micros();
+        u64::try_from((micros + 999) / 1000).unwrap_or(u64::MAX - 1)
+    })
 }
 
 fn receive_link_layer_packet(
     dyn_callbacks: &mut DynRustBluetoothChipCallbacks,
-    source_address: String,
-    destination_address: String,
+    source_address: [u8; 6],
+    destination_address: [u8; 6],
     packet_type: u8,
     packet: &[u8],
 ) {
@@ -406,6 +609,11 @@ fn receive_link_layer_packet(
     );
 }
 
+fn receive_link_layer_packets(dyn_callbacks: &mut DynRustBluetoothChipCallbacks, batch: &[u8]) {
+    let packets: Vec<ReceivedPacket> = parse_received_packets(batch).collect();
+    (**dyn_callbacks).receive_link_layer_packets(&packets);
+}
+
 /// CxxServerResponseWriter is defined in server_response_writable.h
 /// Wrapper struct allows the impl to discover the respective C++ methods
 pub struct CxxServerResponseWriterWrapper<'a> {
@@ -430,8 +638,10 @@ impl ServerResponseWritable for CxxServerResponseWriterWrapper<'_> {
         self.writer.put_error(error_code.into(), &error_message);
     }
 
-    fn put_ok_with_vec(&mut self, _mime_type: &str, _body: Vec<u8>, _headers: StrHeaders) {
-        todo!()
+    fn put_ok_with_vec(&mut self, mime_type: &str, body: Vec<u8>, _headers: StrHeaders) {
+        let_cxx_string!(mime_type = mime_type);
+        let_cxx_string!(body = body);
+        self.writer.put_ok(&mime_type, &body);
     }
     fn put_ok_switch_protocol(&mut self, _connection: &str, _headers: StrHeaders) {
         todo!()
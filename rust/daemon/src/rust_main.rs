@@ -13,6 +13,7 @@
 // limitations under the License.
 
 use clap::Parser;
+use cxx::let_cxx_string;
 use log::warn;
 use log::{error, info};
 use netsim_common::system::netsimd_temp_dir;
@@ -23,6 +24,7 @@ use crate::bluetooth as bluetooth_facade;
 use crate::captures::capture::spawn_capture_event_subscriber;
 use crate::config_file;
 use crate::devices::devices_handler::wait_devices;
+use crate::devices::facade_startup::{spawn_start, wait_started, Facade};
 use crate::events;
 use crate::events::Event;
 use crate::session::Session;
@@ -35,10 +37,13 @@ use crate::ffi::ffi_util;
 use crate::service::{new_test_beacon, Service, ServiceParams};
 #[cfg(feature = "cuttlefish")]
 use netsim_common::util::os_utils::get_server_address;
-use netsim_proto::config::Config;
+use netsim_proto::common::ChipKind;
+use netsim_proto::config::{Config, ThreadOptions};
+use protobuf::Message;
 use std::env;
 use std::ffi::{c_char, c_int};
 use std::sync::mpsc::Receiver;
+use std::thread;
 
 /// Wireless network simulator for android (and other) emulated devices.
 ///
@@ -95,6 +100,9 @@ fn run_netsimd_with_args(args: NetsimdArgs) {
         cxx::let_cxx_string!(netsimd_temp_dir = netsim_common::system::netsimd_temp_dir_string());
         ffi_util::redirect_std_stream(&netsimd_temp_dir);
     }
+    if let Some(log_level) = args.log_level {
+        ffi_util::set_bts_log_priority(log_level.into());
+    }
 
     match args.connector_instance {
         #[cfg(feature = "cuttlefish")]
@@ -147,6 +155,18 @@ fn main_loop(events_rx: Receiver<Event>) {
     }
 }
 
+// Passes the CPU lists to C++ in the order of util::ThreadClass.
+fn set_thread_cpus(threads: &ThreadOptions) {
+    let classes =
+        [&threads.bluetooth_cpus, &threads.wifi_cpus, &threads.grpc_cpus, &threads.background_cpus];
+    for (thread_class, cpus) in classes.iter().enumerate() {
+        let_cxx_string!(cxx_cpus = cpus.as_str());
+        if !ffi_util::set_thread_class_cpus(thread_class as u32, &cxx_cpus) {
+            warn!("Ignoring malformed CPU list {cpus:?} of thread class {thread_class}");
+        }
+    }
+}
+
 fn run_netsimd_primary(args: NetsimdArgs) {
     info!("Netsim Version: {}", get_version());
 
@@ -179,6 +199,11 @@ fn run_netsimd_primary(args: NetsimdArgs) {
         }
     }
 
+    // Threads started from here on are placed on the CPUs of their class
+    if let Some(threads) = config.threads.as_ref() {
+        set_thread_cpus(threads);
+    }
+
     let service_params = ServiceParams::new(
         fd_startup_str,
         args.no_cli_ui,
@@ -188,6 +213,8 @@ fn run_netsimd_primary(args: NetsimdArgs) {
         instance_num,
         args.dev,
         args.vsock.unwrap_or_default(),
+        args.grpc_callback_api,
+        config.grpc_server.clone().unwrap_or_default(),
     );
 
     // SAFETY: The caller guaranteed that the file descriptors in `fd_startup_str` would remain
@@ -209,9 +236,47 @@ fn run_netsimd_primary(args: NetsimdArgs) {
     spawn_capture_event_subscriber(capture_events_rx);
     wait_devices(device_events_rx);
 
-    // Start radio facades
-    bluetooth_facade::bluetooth_start(&config.bluetooth, instance_num, args.disable_address_reuse);
-    wifi_facade::wifi_start(&config.wifi);
+    // Chips that reconnect resume the state saved by the previous run
+    if let Some(snapshot) = &args.snapshot {
+        let_cxx_string!(cxx_snapshot = snapshot);
+        if ffi_util::load_snapshot(&cxx_snapshot) {
+            info!("Loaded simulation snapshot {snapshot}");
+        }
+    }
+
+    // Link to the other nodes once the facades can take their traffic
+    let federation_start = config.federation.as_ref().map(|federation| {
+        let proto_bytes = federation.write_to_bytes().unwrap_or_default();
+        thread::spawn(move || {
+            if let Err(err) =
+                wait_started(ChipKind::BLUETOOTH).and_then(|_| wait_started(ChipKind::WIFI))
+            {
+                warn!("Federation not started: {err}");
+                return;
+            }
+            ffi_util::federation_start(&proto_bytes);
+        })
+    });
+
+    // Start radio facades in the background, chips added meanwhile wait
+    let bluetooth_config = config.bluetooth.clone();
+    let disable_address_reuse = args.disable_address_reuse;
+    let bluetooth_shards = args.bluetooth_shards.unwrap_or(1);
+    let facade_starts = [
+        spawn_start(Facade::Bluetooth, move || {
+            bluetooth_facade::bluetooth_start(
+                &bluetooth_config,
+                instance_num,
+                disable_address_reuse,
+                bluetooth_shards,
+            )
+        }),
+        spawn_start(Facade::Wifi, move || wifi_facade::wifi_start(&config.wifi)),
+    ];
+
+    // Run all netsimd services (grpc, socket, web), listening before the
+    // facades are up so clients stop backing off early
+    service.run();
 
     // Maybe create test beacons, default true for cuttlefish
     // TODO: remove default for cuttlefish by adding flag to tests
@@ -224,12 +289,28 @@ fn run_netsimd_primary(args: NetsimdArgs) {
         new_test_beacon(2, 1000);
     }
 
-    // Run all netsimd services (grpc, socket, web)
-    service.run();
-
     // Runs a synchronous main loop
     main_loop(main_events_rx);
 
+    for facade_start in facade_starts {
+        if facade_start.join().is_err() {
+            error!("A radio facade failed to start");
+        }
+    }
+    if let Some(federation_start) = federation_start {
+        if federation_start.join().is_ok() {
+            ffi_util::federation_stop();
+        }
+    }
+
+    // Save the chip state while the chips are still attached
+    if let Some(snapshot) = &args.snapshot {
+        let_cxx_string!(cxx_snapshot = snapshot);
+        if !ffi_util::save_snapshot(&cxx_snapshot) {
+            warn!("Failed to save simulation snapshot {snapshot}");
+        }
+    }
+
     // Gracefully shutdown netsimd services
     service.shut_down();
 
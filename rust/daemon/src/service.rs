@@ -23,6 +23,8 @@ use log::{error, info, warn};
 use netsim_common::util::ini_file::IniFile;
 use netsim_common::util::os_utils::get_netsim_ini_filepath;
 use netsim_common::util::zip_artifact::remove_zip_files;
+use netsim_proto::config::GrpcServerOptions;
+use protobuf::Message;
 use std::env;
 use std::time::Duration;
 
@@ -37,6 +39,8 @@ pub struct ServiceParams {
     instance_num: u16,
     dev: bool,
     vsock: u16,
+    grpc_callback_api: bool,
+    grpc_server_options: GrpcServerOptions,
 }
 
 impl ServiceParams {
@@ -50,6 +54,8 @@ impl ServiceParams {
         instance_num: u16,
         dev: bool,
         vsock: u16,
+        grpc_callback_api: bool,
+        grpc_server_options: GrpcServerOptions,
     ) -> Self {
         ServiceParams {
             fd_startup_str,
@@ -60,6 +66,8 @@ impl ServiceParams {
             instance_num,
             dev,
             vsock,
+            grpc_callback_api,
+            grpc_server_options,
         }
     }
 }
@@ -69,6 +77,8 @@ pub struct Service {
     service_params: ServiceParams,
     // grpc server
     grpc_server: UniquePtr<GrpcServer>,
+    // unix domain socket of the grpc server, empty if not used
+    grpc_uds_path: String,
 }
 
 impl Service {
@@ -77,7 +87,7 @@ impl Service {
     /// The file descriptors in `service_params.fd_startup_str` must be valid and open, and must
     /// remain so for as long as the `Service` exists.
     pub unsafe fn new(service_params: ServiceParams) -> Service {
-        Service { service_params, grpc_server: UniquePtr::null() }
+        Service { service_params, grpc_server: UniquePtr::null(), grpc_uds_path: String::new() }
     }
 
     /// Sets up the states for netsimd.
@@ -97,6 +107,23 @@ impl Service {
         set_dev(self.service_params.dev);
     }
 
+    /// Returns the path of the unix domain socket for the gRPC server, or an
+    /// empty string when unix domain sockets are not used.
+    fn grpc_uds_path(&self) -> String {
+        if cfg!(windows) {
+            return String::new();
+        }
+        let mut path = netsim_common::system::netsimd_temp_dir();
+        path.push(format!("netsim_grpc_{}.sock", self.service_params.instance_num));
+        let path = path.to_string_lossy().into_owned();
+        // The path of a sockaddr_un has at most 107 bytes.
+        if path.len() > 107 {
+            warn!("Not using a unix domain socket since the path is too long: {path}");
+            return String::new();
+        }
+        path
+    }
+
     /// Runs netsim gRPC server
     fn run_grpc_server(&self) -> Option<UniquePtr<GrpcServer>> {
         // Environment variable "NETSIM_GRPC_PORT" is set in google3 forge jobs.
@@ -107,6 +134,9 @@ impl Service {
             netsim_grpc_port,
             self.service_params.no_cli_ui,
             self.service_params.vsock,
+            self.service_params.grpc_callback_api,
+            &self.grpc_uds_path,
+            &self.service_params.grpc_server_options.write_to_bytes().unwrap_or_default(),
         );
         match grpc_server.is_null() {
             true => None,
@@ -126,13 +156,19 @@ impl Service {
     }
 
     /// Write ports to netsim.ini file
-    fn write_ports_to_ini(&self, grpc_port: u32, web_port: Option<u16>) {
+    fn write_ports_to_ini(&self, grpc_port: u32, frontend_grpc_port: u32, web_port: Option<u16>) {
         let filepath = get_netsim_ini_filepath(self.service_params.instance_num);
         let mut ini_file = IniFile::new(filepath);
         if let Some(num) = web_port {
             ini_file.insert("web.port", &num.to_string());
         }
         ini_file.insert("grpc.port", &grpc_port.to_string());
+        if frontend_grpc_port != 0 {
+            ini_file.insert("grpc.frontend_port", &frontend_grpc_port.to_string());
+        }
+        if !self.grpc_uds_path.is_empty() {
+            ini_file.insert("grpc.uds", &self.grpc_uds_path);
+        }
         if let Err(err) = ini_file.write() {
             error!("{err:?}");
         }
@@ -152,6 +188,7 @@ impl Service {
         }
 
         // Run netsim gRPC server
+        self.grpc_uds_path = self.grpc_uds_path();
         self.grpc_server = match self.run_grpc_server() {
             Some(server) => server,
             None => {
@@ -164,7 +201,11 @@ impl Service {
         let web_port = self.run_web_server();
 
         // Write the port numbers to ini file
-        self.write_ports_to_ini(self.grpc_server.get_grpc_port(), web_port);
+        self.write_ports_to_ini(
+            self.grpc_server.get_grpc_port(),
+            self.grpc_server.get_frontend_grpc_port(),
+            web_port,
+        );
 
         // Run the socket server.
         run_socket_transport(self.service_params.hci_port);
@@ -176,6 +217,9 @@ impl Service {
         if !self.grpc_server.is_null() {
             self.grpc_server.shut_down();
         }
+        if !self.grpc_uds_path.is_empty() {
+            let _ = std::fs::remove_file(&self.grpc_uds_path);
+        }
     }
 }
 
@@ -14,11 +14,12 @@
 
 //! A module to collect and write session stats
 
+use crate::bluetooth::bluetooth_latency_stats;
 use crate::events::Event;
 use anyhow::Context;
 use log::info;
 use netsim_common::system::netsimd_temp_dir;
-use netsim_proto::stats::NetsimStats;
+use netsim_proto::stats::{NetsimPacketPoolStats, NetsimStats, NetsimTraceCounter};
 use protobuf_json_mapping::print_to_string;
 use std::fs::File;
 use std::io::Write;
@@ -128,10 +129,51 @@ impl Session {
         info!("session stats to {}", filename.display());
         // session monitor thread is now shutdown...  write out the protobuf
         let mut file = File::create(filename)?;
-        let lock = self.info.read().expect("Could not acquire session lock");
+        let mut lock = self.info.write().expect("Could not acquire session lock");
+        // Empty unless latency stats are enabled in the Bluetooth config.
+        lock.stats_proto.latency_stats = bluetooth_latency_stats();
+        lock.stats_proto.packet_pool_stats = Some(packet_pool_stats()).into();
+        // Empty unless tracing was enabled through the frontend.
+        lock.stats_proto.trace_counters = trace_counters();
         let json = print_to_string(&lock.stats_proto)?;
         file.write(json.as_bytes()).context("Unable to write json session stats")?;
         file.flush()?;
         Ok(())
     }
 }
+
+// Packet pool counters of the C++ request path.
+#[cfg(not(test))]
+fn packet_pool_stats() -> NetsimPacketPoolStats {
+    let mut stats = [0u64; 5];
+    crate::ffi::ffi_util::get_packet_pool_stats(&mut stats);
+    let [acquired, reused, oversize, dropped, pooled] = stats;
+    NetsimPacketPoolStats {
+        acquired: Some(acquired),
+        reused: Some(reused),
+        oversize: Some(oversize),
+        dropped: Some(dropped),
+        pooled: Some(pooled),
+        ..Default::default()
+    }
+}
+
+#[cfg(test)]
+fn packet_pool_stats() -> NetsimPacketPoolStats {
+    NetsimPacketPoolStats::default()
+}
+
+// Totals of the C++ trace points.
+#[cfg(not(test))]
+fn trace_counters() -> Vec<NetsimTraceCounter> {
+    use protobuf::Message;
+    let stats_bytes = crate::ffi::ffi_util::get_trace_counters();
+    NetsimStats::parse_from_bytes(&stats_bytes)
+        .map(|stats| stats.trace_counters)
+        .unwrap_or_default()
+}
+
+#[cfg(test)]
+fn trace_counters() -> Vec<NetsimTraceCounter> {
+    Vec::new()
+}
@@ -21,10 +21,12 @@ use std::thread;
 
 use netsim_proto::common::ChipKind;
 
-use crate::bluetooth::handle_bluetooth_request;
+use crate::bluetooth::{handle_bluetooth_request, handle_bluetooth_request_buffer};
 use crate::captures::captures_handler as captures_handlers;
+use crate::ffi::ffi_transport::PacketBuffer;
 use crate::util::int_to_chip_kind;
-use crate::wifi::handle_wifi_request;
+use crate::uwb::{handle_uwb_request, handle_uwb_request_buffer};
+use crate::wifi::{handle_wifi_request, handle_wifi_request_buffer};
 
 /// The Dispatcher module routes packets from a chip controller instance to
 /// different transport managers. Currently transport managers include
@@ -36,14 +38,15 @@ use crate::wifi::handle_wifi_request;
 // When a connection arrives, the transport registers a responder
 // implementing Response trait for the packet stream.
 pub trait Response {
-    fn response(&mut self, packet: Vec<u8>, packet_type: u8);
+    fn response(&mut self, packet: &[u8], packet_type: u8);
 }
 
 // When a responder is registered a responder thread is created to
 // decouple the chip controller from the network. The thread reads
-// ResponsePacket from a queue and sends to responder.
+// ResponsePacket from a queue and sends to responder. The payload is shared
+// by the queues of all the receivers of a multicast response.
 struct ResponsePacket {
-    packet: Vec<u8>,
+    packet: Arc<[u8]>,
     packet_type: u8,
 }
 
@@ -77,7 +80,7 @@ pub fn register_transport(kind: u32, facade_id: u32, mut responder: Box<dyn Resp
         loop {
             match rx.recv() {
                 Ok(ResponsePacket { packet, packet_type }) => {
-                    responder.response(packet, packet_type);
+                    responder.response(&packet, packet_type);
                 }
                 Err(_) => {
                     info!("register_transport: finished thread chip_kind/facade_id: {key}");
@@ -100,13 +103,13 @@ pub fn unregister_transport(kind: u32, facade_id: u32) {
 // Queue the response packet to be handled by the responder thread.
 //
 pub fn handle_response(kind: u32, facade_id: u32, packet: &cxx::CxxVector<u8>, packet_type: u8) {
-    let packet_vec = packet.as_slice().to_vec();
-    captures_handlers::handle_packet_response(kind, facade_id, &packet_vec, packet_type.into());
+    let packet = packet.as_slice();
+    captures_handlers::handle_packet_response(kind, facade_id, packet, packet_type.into());
 
     let key = get_key(kind, facade_id);
     let mut binding = SENDERS.lock().unwrap();
     if let Some(responder) = binding.get(&key) {
-        if responder.send(ResponsePacket { packet: packet_vec, packet_type }).is_err() {
+        if responder.send(ResponsePacket { packet: Arc::from(packet), packet_type }).is_err() {
             warn!("handle_response: send failed for chip_kind/facade_id: {key}");
             binding.remove(&key);
         }
@@ -115,6 +118,28 @@ pub fn handle_response(kind: u32, facade_id: u32, packet: &cxx::CxxVector<u8>, p
     };
 }
 
+// Handle a response from a facade for several chips of one kind.
+//
+// The payload is copied once and shared by the responder queues, which are
+// all found under a single lock. Receivers that are gone are skipped.
+pub fn handle_response_multicast(kind: u32, facade_ids: &[u32], packet: &[u8], packet_type: u8) {
+    for &facade_id in facade_ids {
+        captures_handlers::handle_packet_response(kind, facade_id, packet, packet_type.into());
+    }
+
+    let packet: Arc<[u8]> = Arc::from(packet);
+    let mut binding = SENDERS.lock().unwrap();
+    for &facade_id in facade_ids {
+        let key = get_key(kind, facade_id);
+        if let Some(responder) = binding.get(&key) {
+            if responder.send(ResponsePacket { packet: packet.clone(), packet_type }).is_err() {
+                warn!("handle_response_multicast: send failed for chip_kind/facade_id: {key}");
+                binding.remove(&key);
+            }
+        }
+    }
+}
+
 /// Handle requests from transports.
 pub fn handle_request(kind: u32, facade_id: u32, packet: &Vec<u8>, packet_type: u8) {
     captures_handlers::handle_packet_request(kind, facade_id, packet, packet_type.into());
@@ -126,6 +151,9 @@ pub fn handle_request(kind: u32, facade_id: u32, packet: &Vec<u8>, packet_type:
         ChipKind::WIFI => {
             handle_wifi_request(facade_id, packet);
         }
+        ChipKind::UWB => {
+            handle_uwb_request(facade_id, packet);
+        }
         chip_kind => {
             warn!("Unable to handle request from chip_kind: {:?}", chip_kind);
         }
@@ -133,9 +161,31 @@ pub fn handle_request(kind: u32, facade_id: u32, packet: &Vec<u8>, packet_type:
 }
 
 /// Handle requests from transports in C++.
-pub fn handle_request_cxx(kind: u32, facade_id: u32, packet: &cxx::CxxVector<u8>, packet_type: u8) {
-    let packet_vec = packet.as_slice().to_vec();
-    handle_request(kind, facade_id, &packet_vec, packet_type);
+///
+/// The payload stays owned by the C++ PacketBuffer; captures borrow it and
+/// the facades share it, so the packet is not copied on this path.
+pub fn handle_request_cxx(kind: u32, facade_id: u32, packet: &PacketBuffer, packet_type: u8) {
+    captures_handlers::handle_packet_request(
+        kind,
+        facade_id,
+        packet.as_slice(),
+        packet_type.into(),
+    );
+
+    match int_to_chip_kind(kind) {
+        ChipKind::BLUETOOTH => {
+            handle_bluetooth_request_buffer(facade_id, packet_type, packet);
+        }
+        ChipKind::WIFI => {
+            handle_wifi_request_buffer(facade_id, packet);
+        }
+        ChipKind::UWB => {
+            handle_uwb_request_buffer(facade_id, packet);
+        }
+        chip_kind => {
+            warn!("Unable to handle request from chip_kind: {:?}", chip_kind);
+        }
+    }
 }
 
 #[cfg(test)]
@@ -151,7 +201,16 @@ mod tests {
 
     struct TestTransport {}
     impl Response for TestTransport {
-        fn response(&mut self, _packet: Vec<u8>, _packet_type: u8) {}
+        fn response(&mut self, _packet: &[u8], _packet_type: u8) {}
+    }
+
+    struct RecordingTransport {
+        packets: Sender<Vec<u8>>,
+    }
+    impl Response for RecordingTransport {
+        fn response(&mut self, packet: &[u8], _packet_type: u8) {
+            self.packets.send(packet.to_vec()).unwrap();
+        }
     }
 
     #[test]
@@ -167,6 +226,19 @@ mod tests {
         SENDERS.lock().unwrap().remove(&key);
     }
 
+    #[test]
+    fn test_handle_response_multicast() {
+        let (tx, rx) = channel();
+        register_transport(1, 10, Box::new(RecordingTransport { packets: tx.clone() }));
+        register_transport(1, 11, Box::new(RecordingTransport { packets: tx }));
+        // Facade 12 has no transport and is skipped.
+        handle_response_multicast(1, &[10, 11, 12], &[1, 2, 3], 0);
+        assert_eq!(rx.recv().unwrap(), vec![1, 2, 3]);
+        assert_eq!(rx.recv().unwrap(), vec![1, 2, 3]);
+        unregister_transport(1, 10);
+        unregister_transport(1, 11);
+    }
+
     #[test]
     fn test_unregister_transport() {
         register_transport(0, 1, Box::new(TestTransport {}));
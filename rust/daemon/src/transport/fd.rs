@@ -83,10 +83,10 @@ struct FdTransport {
 }
 
 impl Response for FdTransport {
-    fn response(&mut self, packet: Vec<u8>, packet_type: u8) {
+    fn response(&mut self, packet: &[u8], packet_type: u8) {
         let mut buffer = Vec::<u8>::with_capacity(packet.len() + 1);
         buffer.push(packet_type);
-        buffer.extend(packet);
+        buffer.extend_from_slice(packet);
         if let Err(e) = self.file.write_all(&buffer[..]) {
             error!("netsimd: error writing {}", e);
         }
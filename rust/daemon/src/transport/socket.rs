@@ -38,10 +38,10 @@ struct SocketTransport {
 }
 
 impl Response for SocketTransport {
-    fn response(&mut self, packet: Vec<u8>, packet_type: u8) {
-        let mut buffer = Vec::new();
+    fn response(&mut self, packet: &[u8], packet_type: u8) {
+        let mut buffer = Vec::with_capacity(packet.len() + 1);
         buffer.push(packet_type);
-        buffer.extend(packet);
+        buffer.extend_from_slice(packet);
         if let Err(e) = self.stream.write_all(&buffer[..]) {
             error!("error writing {}", e);
         };
@@ -20,9 +20,12 @@ use std::io::{Error, Read};
 /// Version 1.1
 ///
 /// 2.3.2 Format of Control Packets
+/// 2.3.3 Format of Data Packets
 
 const UCI_HEADER_SIZE: usize = 4;
 const UCI_PAYLOAD_LENGTH_FIELD: usize = 3;
+const UCI_MESSAGE_TYPE_SHIFT: u8 = 5;
+const UCI_MESSAGE_TYPE_DATA: u8 = 0;
 
 #[derive(Debug)]
 pub struct Packet {
@@ -38,8 +41,14 @@ pub fn read_uci_packet<R: Read>(reader: &mut R) -> Result<Packet, PacketError> {
     // Read the UCI header
     let mut buffer = vec![0; UCI_HEADER_SIZE];
     reader.read_exact(&mut buffer[0..]).map_err(PacketError::IoError)?;
-    // Extract the control packet payload length and read
-    let length = buffer[UCI_PAYLOAD_LENGTH_FIELD] as usize + UCI_HEADER_SIZE;
+    // Extract the payload length and read, data packets have a 16 bit
+    // little endian length in the last two octets of the header
+    let payload_length = if buffer[0] >> UCI_MESSAGE_TYPE_SHIFT == UCI_MESSAGE_TYPE_DATA {
+        u16::from_le_bytes([buffer[2], buffer[3]]) as usize
+    } else {
+        buffer[UCI_PAYLOAD_LENGTH_FIELD] as usize
+    };
+    let length = payload_length + UCI_HEADER_SIZE;
     buffer.resize(length, 0);
     reader.read_exact(&mut buffer[UCI_HEADER_SIZE..]).map_err(PacketError::IoError)?;
     Ok(Packet { payload: buffer })
@@ -75,10 +75,10 @@ struct WebSocketTransport {
 }
 
 impl Response for WebSocketTransport {
-    fn response(&mut self, packet: Vec<u8>, packet_type: u8) {
-        let mut buffer = Vec::new();
+    fn response(&mut self, packet: &[u8], packet_type: u8) {
+        let mut buffer = Vec::with_capacity(packet.len() + 1);
         buffer.push(packet_type);
-        buffer.extend(packet);
+        buffer.extend_from_slice(packet);
         if let Err(err) =
             self.websocket_writer.lock().unwrap().write_message(Message::Binary(buffer))
         {
@@ -12,40 +12,38 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#![allow(dead_code)]
+use crate::ffi::ffi_transport::PacketBuffer;
+use crate::ffi::ffi_uwb;
+use netsim_proto::model::chip::Radio;
+use protobuf::Message;
 
-use log::info;
-
-pub fn handle_uwb_request(_facade_id: u32, _packet: &[u8]) {
-    info!("handle_uwb_request");
+pub fn handle_uwb_request(facade_id: u32, packet: &Vec<u8>) {
+    ffi_uwb::handle_uwb_request(facade_id, packet);
 }
 
-pub fn uwb_reset(_facade_id: u32) {
-    info!("uwb_reset");
-}
-pub fn uwb_remove(_facade_id: u32) {
-    info!("uwb_remove");
+pub fn handle_uwb_request_buffer(facade_id: u32, packet: &PacketBuffer) {
+    ffi_uwb::handle_uwb_request_buffer(facade_id, packet);
 }
 
-pub fn uwb_patch(_facade_id: u32, _proto_bytes: &[u8]) {
-    info!("uwb_patch");
+pub fn uwb_reset(facade_id: u32) {
+    ffi_uwb::uwb_reset(facade_id);
 }
 
-pub fn uwb_get(_facade_id: u32) -> Vec<u8> {
-    info!("uwb_get");
-    Vec::<u8>::new()
+pub fn uwb_remove(facade_id: u32) {
+    ffi_uwb::uwb_remove(facade_id);
 }
 
-// Returns facade_id
-pub fn uwb_add(_chip_id: u32) -> u32 {
-    info!("uwb_get");
-    1
+pub fn uwb_patch(facade_id: u32, radio: &Radio) {
+    let radio_bytes = radio.write_to_bytes().unwrap();
+    ffi_uwb::uwb_patch_cxx(facade_id, &radio_bytes);
 }
 
-pub fn uwb_start() {
-    info!("uwb_start");
+pub fn uwb_get(facade_id: u32) -> Radio {
+    let radio_bytes = ffi_uwb::uwb_get_cxx(facade_id);
+    Radio::parse_from_bytes(&radio_bytes).unwrap()
 }
 
-pub fn uwb_stop() {
-    info!("uwb_stop");
+// Returns facade_id
+pub fn uwb_add(device_id: u32) -> u32 {
+    ffi_uwb::uwb_add(device_id)
 }
@@ -12,4 +12,17 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-pub mod facade;
+// [cfg(test)] gets compiled during local Rust unit tests
+// [cfg(not(test))] avoids getting compiled during local Rust unit tests
+
+#![allow(unused)]
+
+#[cfg(not(test))]
+mod facade;
+#[cfg(not(test))]
+pub(crate) use self::facade::*;
+
+#[cfg(test)]
+mod mocked;
+#[cfg(test)]
+pub(crate) use self::mocked::*;
@@ -12,8 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+use crate::ffi::ffi_transport::PacketBuffer;
 use crate::ffi::ffi_wifi;
 use ::protobuf::MessageField;
+use cxx::let_cxx_string;
 use netsim_proto::config::WiFi;
 use netsim_proto::model::chip::Radio;
 use protobuf::Message;
@@ -22,12 +24,16 @@ pub fn handle_wifi_request(facade_id: u32, packet: &Vec<u8>) {
     ffi_wifi::handle_wifi_request(facade_id, packet);
 }
 
+pub fn handle_wifi_request_buffer(facade_id: u32, packet: &PacketBuffer) {
+    ffi_wifi::handle_wifi_request_buffer(facade_id, packet);
+}
+
 pub fn wifi_reset(facade_id: u32) {
     ffi_wifi::wifi_reset(facade_id);
 }
 
-pub fn wifi_remove(facade_id: u32) {
-    ffi_wifi::wifi_remove(facade_id);
+pub fn wifi_remove(facade_id: u32, keep_snapshot: bool) {
+    ffi_wifi::wifi_remove(facade_id, keep_snapshot);
 }
 
 pub fn wifi_patch(facade_id: u32, radio: &Radio) {
@@ -41,8 +47,9 @@ pub fn wifi_get(facade_id: u32) -> Radio {
 }
 
 // Returns facade_id
-pub fn wifi_add(device_id: u32) -> u32 {
-    ffi_wifi::wifi_add(device_id)
+pub fn wifi_add(device_id: u32, snapshot_key: &str) -> u32 {
+    let_cxx_string!(cxx_snapshot_key = snapshot_key);
+    ffi_wifi::wifi_add(device_id, &cxx_snapshot_key)
 }
 
 /// Starts the WiFi service.
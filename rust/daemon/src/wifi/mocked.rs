@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+use crate::ffi::ffi_transport::PacketBuffer;
 use ::protobuf::MessageField;
 use lazy_static::lazy_static;
 use log::info;
@@ -37,11 +38,15 @@ pub fn handle_wifi_request(facade_id: u32, packet: &Vec<u8>) {
     info!("handle_wifi_request({facade_id}, {packet:?})");
 }
 
+pub fn handle_wifi_request_buffer(facade_id: u32, packet: &PacketBuffer) {
+    info!("handle_wifi_request_buffer({facade_id})");
+}
+
 pub fn wifi_reset(facade_id: u32) {
     info!("wifi_reset({facade_id})");
 }
 
-pub fn wifi_remove(facade_id: u32) {
+pub fn wifi_remove(facade_id: u32, _keep_snapshot: bool) {
     info!("wifi_remove({facade_id})");
 }
 
@@ -55,7 +60,7 @@ pub fn wifi_get(facade_id: u32) -> Radio {
 }
 
 // Returns facade_id
-pub fn wifi_add(device_id: u32) -> u32 {
+pub fn wifi_add(device_id: u32, _snapshot_key: &str) -> u32 {
     info!("wifi_add({device_id})");
     let mut resource = IDS.write().unwrap();
     let facade_id = resource.current_id;
@@ -583,6 +583,8 @@ pub struct WiFi {
     pub slirp_options: ::protobuf::MessageField<SlirpOptions>,
     // @@protoc_insertion_point(field:netsim.config.WiFi.hostapd_options)
     pub hostapd_options: ::protobuf::MessageField<HostapdOptions>,
+    // @@protoc_insertion_point(field:netsim.config.WiFi.slirp_poll_interval_ms)
+    pub slirp_poll_interval_ms: u32,
     // special fields
     // @@protoc_insertion_point(special_field:netsim.config.WiFi.special_fields)
     pub special_fields: ::protobuf::SpecialFields,
@@ -600,7 +602,7 @@ impl WiFi {
     }
 
     fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
-        let mut fields = ::std::vec::Vec::with_capacity(2);
+        let mut fields = ::std::vec::Vec::with_capacity(3);
         let mut oneofs = ::std::vec::Vec::with_capacity(0);
         fields.push(::protobuf::reflect::rt::v2::make_message_field_accessor::<_, SlirpOptions>(
             "slirp_options",
@@ -612,6 +614,11 @@ impl WiFi {
             |m: &WiFi| { &m.hostapd_options },
             |m: &mut WiFi| { &mut m.hostapd_options },
         ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "slirp_poll_interval_ms",
+            |m: &WiFi| { &m.slirp_poll_interval_ms },
+            |m: &mut WiFi| { &mut m.slirp_poll_interval_ms },
+        ));
         ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<WiFi>(
             "WiFi",
             fields,
@@ -636,6 +643,9 @@ impl ::protobuf::Message for WiFi {
                 18 => {
                     ::protobuf::rt::read_singular_message_into_field(is, &mut self.hostapd_options)?;
                 },
+                24 => {
+                    self.slirp_poll_interval_ms = is.read_uint32()?;
+                },
                 tag => {
                     ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
                 },
@@ -656,6 +666,9 @@ impl ::protobuf::Message for WiFi {
             let len = v.compute_size();
             my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
         }
+        if self.slirp_poll_interval_ms != 0 {
+            my_size += ::protobuf::rt::uint32_size(3, self.slirp_poll_interval_ms);
+        }
         my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
         self.special_fields.cached_size().set(my_size as u32);
         my_size
@@ -668,6 +681,9 @@ impl ::protobuf::Message for WiFi {
         if let Some(v) = self.hostapd_options.as_ref() {
             ::protobuf::rt::write_message_field_with_cached_size(2, v, os)?;
         }
+        if self.slirp_poll_interval_ms != 0 {
+            os.write_uint32(3, self.slirp_poll_interval_ms)?;
+        }
         os.write_unknown_fields(self.special_fields.unknown_fields())?;
         ::std::result::Result::Ok(())
     }
@@ -687,6 +703,7 @@ impl ::protobuf::Message for WiFi {
     fn clear(&mut self) {
         self.slirp_options.clear();
         self.hostapd_options.clear();
+        self.slirp_poll_interval_ms = 0;
         self.special_fields.clear();
     }
 
@@ -694,6 +711,7 @@ impl ::protobuf::Message for WiFi {
         static instance: WiFi = WiFi {
             slirp_options: ::protobuf::MessageField::none(),
             hostapd_options: ::protobuf::MessageField::none(),
+            slirp_poll_interval_ms: 0,
             special_fields: ::protobuf::SpecialFields::new(),
         };
         &instance
@@ -725,6 +743,10 @@ pub struct Bluetooth {
     pub properties: ::protobuf::MessageField<super::configuration::Controller>,
     // @@protoc_insertion_point(field:netsim.config.Bluetooth.address_reuse)
     pub address_reuse: ::std::option::Option<bool>,
+    // @@protoc_insertion_point(field:netsim.config.Bluetooth.radio_range)
+    pub radio_range: ::std::option::Option<f32>,
+    // @@protoc_insertion_point(field:netsim.config.Bluetooth.latency_stats)
+    pub latency_stats: ::std::option::Option<bool>,
     // special fields
     // @@protoc_insertion_point(special_field:netsim.config.Bluetooth.special_fields)
     pub special_fields: ::protobuf::SpecialFields,
@@ -742,7 +764,7 @@ impl Bluetooth {
     }
 
     fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
-        let mut fields = ::std::vec::Vec::with_capacity(2);
+        let mut fields = ::std::vec::Vec::with_capacity(4);
         let mut oneofs = ::std::vec::Vec::with_capacity(0);
         fields.push(::protobuf::reflect::rt::v2::make_message_field_accessor::<_, super::configuration::Controller>(
             "properties",
@@ -754,6 +776,16 @@ impl Bluetooth {
             |m: &Bluetooth| { &m.address_reuse },
             |m: &mut Bluetooth| { &mut m.address_reuse },
         ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "radio_range",
+            |m: &Bluetooth| { &m.radio_range },
+            |m: &mut Bluetooth| { &mut m.radio_range },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "latency_stats",
+            |m: &Bluetooth| { &m.latency_stats },
+            |m: &mut Bluetooth| { &mut m.latency_stats },
+        ));
         ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<Bluetooth>(
             "Bluetooth",
             fields,
@@ -778,6 +810,12 @@ impl ::protobuf::Message for Bluetooth {
                 16 => {
                     self.address_reuse = ::std::option::Option::Some(is.read_bool()?);
                 },
+                29 => {
+                    self.radio_range = ::std::option::Option::Some(is.read_float()?);
+                },
+                32 => {
+                    self.latency_stats = ::std::option::Option::Some(is.read_bool()?);
+                },
                 tag => {
                     ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
                 },
@@ -797,6 +835,12 @@ impl ::protobuf::Message for Bluetooth {
         if let Some(v) = self.address_reuse {
             my_size += 1 + 1;
         }
+        if let Some(v) = self.radio_range {
+            my_size += 1 + 4;
+        }
+        if let Some(v) = self.latency_stats {
+            my_size += 1 + 1;
+        }
         my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
         self.special_fields.cached_size().set(my_size as u32);
         my_size
@@ -809,6 +853,12 @@ impl ::protobuf::Message for Bluetooth {
         if let Some(v) = self.address_reuse {
             os.write_bool(2, v)?;
         }
+        if let Some(v) = self.radio_range {
+            os.write_float(3, v)?;
+        }
+        if let Some(v) = self.latency_stats {
+            os.write_bool(4, v)?;
+        }
         os.write_unknown_fields(self.special_fields.unknown_fields())?;
         ::std::result::Result::Ok(())
     }
@@ -828,6 +878,8 @@ impl ::protobuf::Message for Bluetooth {
     fn clear(&mut self) {
         self.properties.clear();
         self.address_reuse = ::std::option::Option::None;
+        self.radio_range = ::std::option::Option::None;
+        self.latency_stats = ::std::option::Option::None;
         self.special_fields.clear();
     }
 
@@ -835,6 +887,8 @@ impl ::protobuf::Message for Bluetooth {
         static instance: Bluetooth = Bluetooth {
             properties: ::protobuf::MessageField::none(),
             address_reuse: ::std::option::Option::None,
+            radio_range: ::std::option::Option::None,
+            latency_stats: ::std::option::Option::None,
             special_fields: ::protobuf::SpecialFields::new(),
         };
         &instance
@@ -858,6 +912,768 @@ impl ::protobuf::reflect::ProtobufValue for Bluetooth {
     type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
 }
 
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.config.GrpcServerOptions)
+pub struct GrpcServerOptions {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.min_pollers)
+    pub min_pollers: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.max_pollers)
+    pub max_pollers: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.num_completion_queues)
+    pub num_completion_queues: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.max_threads)
+    pub max_threads: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.max_memory_mb)
+    pub max_memory_mb: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.max_concurrent_streams)
+    pub max_concurrent_streams: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.stream_window_bytes)
+    pub stream_window_bytes: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.keepalive_time_ms)
+    pub keepalive_time_ms: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.keepalive_timeout_ms)
+    pub keepalive_timeout_ms: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.separate_frontend)
+    pub separate_frontend: bool,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.frontend_port)
+    pub frontend_port: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.frontend_max_threads)
+    pub frontend_max_threads: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.egress_queue_bytes)
+    pub egress_queue_bytes: u32,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.egress_data_policy)
+    pub egress_data_policy: ::protobuf::EnumOrUnknown<EgressDropPolicy>,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.egress_audio_policy)
+    pub egress_audio_policy: ::protobuf::EnumOrUnknown<EgressDropPolicy>,
+    // @@protoc_insertion_point(field:netsim.config.GrpcServerOptions.egress_stall_timeout_ms)
+    pub egress_stall_timeout_ms: u32,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.config.GrpcServerOptions.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a GrpcServerOptions {
+    fn default() -> &'a GrpcServerOptions {
+        <GrpcServerOptions as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl GrpcServerOptions {
+    pub fn new() -> GrpcServerOptions {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(16);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "min_pollers",
+            |m: &GrpcServerOptions| { &m.min_pollers },
+            |m: &mut GrpcServerOptions| { &mut m.min_pollers },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "max_pollers",
+            |m: &GrpcServerOptions| { &m.max_pollers },
+            |m: &mut GrpcServerOptions| { &mut m.max_pollers },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "num_completion_queues",
+            |m: &GrpcServerOptions| { &m.num_completion_queues },
+            |m: &mut GrpcServerOptions| { &mut m.num_completion_queues },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "max_threads",
+            |m: &GrpcServerOptions| { &m.max_threads },
+            |m: &mut GrpcServerOptions| { &mut m.max_threads },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "max_memory_mb",
+            |m: &GrpcServerOptions| { &m.max_memory_mb },
+            |m: &mut GrpcServerOptions| { &mut m.max_memory_mb },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "max_concurrent_streams",
+            |m: &GrpcServerOptions| { &m.max_concurrent_streams },
+            |m: &mut GrpcServerOptions| { &mut m.max_concurrent_streams },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "stream_window_bytes",
+            |m: &GrpcServerOptions| { &m.stream_window_bytes },
+            |m: &mut GrpcServerOptions| { &mut m.stream_window_bytes },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "keepalive_time_ms",
+            |m: &GrpcServerOptions| { &m.keepalive_time_ms },
+            |m: &mut GrpcServerOptions| { &mut m.keepalive_time_ms },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "keepalive_timeout_ms",
+            |m: &GrpcServerOptions| { &m.keepalive_timeout_ms },
+            |m: &mut GrpcServerOptions| { &mut m.keepalive_timeout_ms },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "separate_frontend",
+            |m: &GrpcServerOptions| { &m.separate_frontend },
+            |m: &mut GrpcServerOptions| { &mut m.separate_frontend },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "frontend_port",
+            |m: &GrpcServerOptions| { &m.frontend_port },
+            |m: &mut GrpcServerOptions| { &mut m.frontend_port },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "frontend_max_threads",
+            |m: &GrpcServerOptions| { &m.frontend_max_threads },
+            |m: &mut GrpcServerOptions| { &mut m.frontend_max_threads },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "egress_queue_bytes",
+            |m: &GrpcServerOptions| { &m.egress_queue_bytes },
+            |m: &mut GrpcServerOptions| { &mut m.egress_queue_bytes },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "egress_data_policy",
+            |m: &GrpcServerOptions| { &m.egress_data_policy },
+            |m: &mut GrpcServerOptions| { &mut m.egress_data_policy },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "egress_audio_policy",
+            |m: &GrpcServerOptions| { &m.egress_audio_policy },
+            |m: &mut GrpcServerOptions| { &mut m.egress_audio_policy },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "egress_stall_timeout_ms",
+            |m: &GrpcServerOptions| { &m.egress_stall_timeout_ms },
+            |m: &mut GrpcServerOptions| { &mut m.egress_stall_timeout_ms },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<GrpcServerOptions>(
+            "GrpcServerOptions",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for GrpcServerOptions {
+    const NAME: &'static str = "GrpcServerOptions";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.min_pollers = is.read_uint32()?;
+                },
+                16 => {
+                    self.max_pollers = is.read_uint32()?;
+                },
+                24 => {
+                    self.num_completion_queues = is.read_uint32()?;
+                },
+                32 => {
+                    self.max_threads = is.read_uint32()?;
+                },
+                40 => {
+                    self.max_memory_mb = is.read_uint32()?;
+                },
+                48 => {
+                    self.max_concurrent_streams = is.read_uint32()?;
+                },
+                56 => {
+                    self.stream_window_bytes = is.read_uint32()?;
+                },
+                64 => {
+                    self.keepalive_time_ms = is.read_uint32()?;
+                },
+                72 => {
+                    self.keepalive_timeout_ms = is.read_uint32()?;
+                },
+                80 => {
+                    self.separate_frontend = is.read_bool()?;
+                },
+                88 => {
+                    self.frontend_port = is.read_uint32()?;
+                },
+                96 => {
+                    self.frontend_max_threads = is.read_uint32()?;
+                },
+                104 => {
+                    self.egress_queue_bytes = is.read_uint32()?;
+                },
+                112 => {
+                    self.egress_data_policy = is.read_enum_or_unknown()?;
+                },
+                120 => {
+                    self.egress_audio_policy = is.read_enum_or_unknown()?;
+                },
+                128 => {
+                    self.egress_stall_timeout_ms = is.read_uint32()?;
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if self.min_pollers != 0 {
+            my_size += ::protobuf::rt::uint32_size(1, self.min_pollers);
+        }
+        if self.max_pollers != 0 {
+            my_size += ::protobuf::rt::uint32_size(2, self.max_pollers);
+        }
+        if self.num_completion_queues != 0 {
+            my_size += ::protobuf::rt::uint32_size(3, self.num_completion_queues);
+        }
+        if self.max_threads != 0 {
+            my_size += ::protobuf::rt::uint32_size(4, self.max_threads);
+        }
+        if self.max_memory_mb != 0 {
+            my_size += ::protobuf::rt::uint32_size(5, self.max_memory_mb);
+        }
+        if self.max_concurrent_streams != 0 {
+            my_size += ::protobuf::rt::uint32_size(6, self.max_concurrent_streams);
+        }
+        if self.stream_window_bytes != 0 {
+            my_size += ::protobuf::rt::uint32_size(7, self.stream_window_bytes);
+        }
+        if self.keepalive_time_ms != 0 {
+            my_size += ::protobuf::rt::uint32_size(8, self.keepalive_time_ms);
+        }
+        if self.keepalive_timeout_ms != 0 {
+            my_size += ::protobuf::rt::uint32_size(9, self.keepalive_timeout_ms);
+        }
+        if self.separate_frontend != false {
+            my_size += 1 + 1;
+        }
+        if self.frontend_port != 0 {
+            my_size += ::protobuf::rt::uint32_size(11, self.frontend_port);
+        }
+        if self.frontend_max_threads != 0 {
+            my_size += ::protobuf::rt::uint32_size(12, self.frontend_max_threads);
+        }
+        if self.egress_queue_bytes != 0 {
+            my_size += ::protobuf::rt::uint32_size(13, self.egress_queue_bytes);
+        }
+        if self.egress_data_policy != ::protobuf::EnumOrUnknown::new(EgressDropPolicy::EGRESS_DROP_DEFAULT) {
+            my_size += ::protobuf::rt::int32_size(14, self.egress_data_policy.value());
+        }
+        if self.egress_audio_policy != ::protobuf::EnumOrUnknown::new(EgressDropPolicy::EGRESS_DROP_DEFAULT) {
+            my_size += ::protobuf::rt::int32_size(15, self.egress_audio_policy.value());
+        }
+        if self.egress_stall_timeout_ms != 0 {
+            my_size += ::protobuf::rt::uint32_size(16, self.egress_stall_timeout_ms);
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if self.min_pollers != 0 {
+            os.write_uint32(1, self.min_pollers)?;
+        }
+        if self.max_pollers != 0 {
+            os.write_uint32(2, self.max_pollers)?;
+        }
+        if self.num_completion_queues != 0 {
+            os.write_uint32(3, self.num_completion_queues)?;
+        }
+        if self.max_threads != 0 {
+            os.write_uint32(4, self.max_threads)?;
+        }
+        if self.max_memory_mb != 0 {
+            os.write_uint32(5, self.max_memory_mb)?;
+        }
+        if self.max_concurrent_streams != 0 {
+            os.write_uint32(6, self.max_concurrent_streams)?;
+        }
+        if self.stream_window_bytes != 0 {
+            os.write_uint32(7, self.stream_window_bytes)?;
+        }
+        if self.keepalive_time_ms != 0 {
+            os.write_uint32(8, self.keepalive_time_ms)?;
+        }
+        if self.keepalive_timeout_ms != 0 {
+            os.write_uint32(9, self.keepalive_timeout_ms)?;
+        }
+        if self.separate_frontend != false {
+            os.write_bool(10, self.separate_frontend)?;
+        }
+        if self.frontend_port != 0 {
+            os.write_uint32(11, self.frontend_port)?;
+        }
+        if self.frontend_max_threads != 0 {
+            os.write_uint32(12, self.frontend_max_threads)?;
+        }
+        if self.egress_queue_bytes != 0 {
+            os.write_uint32(13, self.egress_queue_bytes)?;
+        }
+        if self.egress_data_policy != ::protobuf::EnumOrUnknown::new(EgressDropPolicy::EGRESS_DROP_DEFAULT) {
+            os.write_enum(14, ::protobuf::EnumOrUnknown::value(&self.egress_data_policy))?;
+        }
+        if self.egress_audio_policy != ::protobuf::EnumOrUnknown::new(EgressDropPolicy::EGRESS_DROP_DEFAULT) {
+            os.write_enum(15, ::protobuf::EnumOrUnknown::value(&self.egress_audio_policy))?;
+        }
+        if self.egress_stall_timeout_ms != 0 {
+            os.write_uint32(16, self.egress_stall_timeout_ms)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> GrpcServerOptions {
+        GrpcServerOptions::new()
+    }
+
+    fn clear(&mut self) {
+        self.min_pollers = 0;
+        self.max_pollers = 0;
+        self.num_completion_queues = 0;
+        self.max_threads = 0;
+        self.max_memory_mb = 0;
+        self.max_concurrent_streams = 0;
+        self.stream_window_bytes = 0;
+        self.keepalive_time_ms = 0;
+        self.keepalive_timeout_ms = 0;
+        self.separate_frontend = false;
+        self.frontend_port = 0;
+        self.frontend_max_threads = 0;
+        self.egress_queue_bytes = 0;
+        self.egress_data_policy = ::protobuf::EnumOrUnknown::new(EgressDropPolicy::EGRESS_DROP_DEFAULT);
+        self.egress_audio_policy = ::protobuf::EnumOrUnknown::new(EgressDropPolicy::EGRESS_DROP_DEFAULT);
+        self.egress_stall_timeout_ms = 0;
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static GrpcServerOptions {
+        static instance: GrpcServerOptions = GrpcServerOptions {
+            min_pollers: 0,
+            max_pollers: 0,
+            num_completion_queues: 0,
+            max_threads: 0,
+            max_memory_mb: 0,
+            max_concurrent_streams: 0,
+            stream_window_bytes: 0,
+            keepalive_time_ms: 0,
+            keepalive_timeout_ms: 0,
+            separate_frontend: false,
+            frontend_port: 0,
+            frontend_max_threads: 0,
+            egress_queue_bytes: 0,
+            egress_data_policy: ::protobuf::EnumOrUnknown::from_i32(0),
+            egress_audio_policy: ::protobuf::EnumOrUnknown::from_i32(0),
+            egress_stall_timeout_ms: 0,
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for GrpcServerOptions {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("GrpcServerOptions").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for GrpcServerOptions {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for GrpcServerOptions {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.config.Federation)
+pub struct Federation {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.config.Federation.node_id)
+    pub node_id: u32,
+    // @@protoc_insertion_point(field:netsim.config.Federation.peers)
+    pub peers: ::std::vec::Vec<::std::string::String>,
+    // @@protoc_insertion_point(field:netsim.config.Federation.wifi_node_id)
+    pub wifi_node_id: u32,
+    // @@protoc_insertion_point(field:netsim.config.Federation.flush_interval_us)
+    pub flush_interval_us: u32,
+    // @@protoc_insertion_point(field:netsim.config.Federation.max_batch_bytes)
+    pub max_batch_bytes: u32,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.config.Federation.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a Federation {
+    fn default() -> &'a Federation {
+        <Federation as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl Federation {
+    pub fn new() -> Federation {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(5);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "node_id",
+            |m: &Federation| { &m.node_id },
+            |m: &mut Federation| { &mut m.node_id },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "peers",
+            |m: &Federation| { &m.peers },
+            |m: &mut Federation| { &mut m.peers },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "wifi_node_id",
+            |m: &Federation| { &m.wifi_node_id },
+            |m: &mut Federation| { &mut m.wifi_node_id },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "flush_interval_us",
+            |m: &Federation| { &m.flush_interval_us },
+            |m: &mut Federation| { &mut m.flush_interval_us },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "max_batch_bytes",
+            |m: &Federation| { &m.max_batch_bytes },
+            |m: &mut Federation| { &mut m.max_batch_bytes },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<Federation>(
+            "Federation",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for Federation {
+    const NAME: &'static str = "Federation";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.node_id = is.read_uint32()?;
+                },
+                18 => {
+                    self.peers.push(is.read_string()?);
+                },
+                24 => {
+                    self.wifi_node_id = is.read_uint32()?;
+                },
+                32 => {
+                    self.flush_interval_us = is.read_uint32()?;
+                },
+                40 => {
+                    self.max_batch_bytes = is.read_uint32()?;
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if self.node_id != 0 {
+            my_size += ::protobuf::rt::uint32_size(1, self.node_id);
+        }
+        for value in &self.peers {
+            my_size += ::protobuf::rt::string_size(2, &value);
+        };
+        if self.wifi_node_id != 0 {
+            my_size += ::protobuf::rt::uint32_size(3, self.wifi_node_id);
+        }
+        if self.flush_interval_us != 0 {
+            my_size += ::protobuf::rt::uint32_size(4, self.flush_interval_us);
+        }
+        if self.max_batch_bytes != 0 {
+            my_size += ::protobuf::rt::uint32_size(5, self.max_batch_bytes);
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if self.node_id != 0 {
+            os.write_uint32(1, self.node_id)?;
+        }
+        for v in &self.peers {
+            os.write_string(2, &v)?;
+        };
+        if self.wifi_node_id != 0 {
+            os.write_uint32(3, self.wifi_node_id)?;
+        }
+        if self.flush_interval_us != 0 {
+            os.write_uint32(4, self.flush_interval_us)?;
+        }
+        if self.max_batch_bytes != 0 {
+            os.write_uint32(5, self.max_batch_bytes)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> Federation {
+        Federation::new()
+    }
+
+    fn clear(&mut self) {
+        self.node_id = 0;
+        self.peers.clear();
+        self.wifi_node_id = 0;
+        self.flush_interval_us = 0;
+        self.max_batch_bytes = 0;
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static Federation {
+        static instance: Federation = Federation {
+            node_id: 0,
+            peers: ::std::vec::Vec::new(),
+            wifi_node_id: 0,
+            flush_interval_us: 0,
+            max_batch_bytes: 0,
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for Federation {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("Federation").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for Federation {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for Federation {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.config.ThreadOptions)
+pub struct ThreadOptions {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.config.ThreadOptions.bluetooth_cpus)
+    pub bluetooth_cpus: ::std::string::String,
+    // @@protoc_insertion_point(field:netsim.config.ThreadOptions.wifi_cpus)
+    pub wifi_cpus: ::std::string::String,
+    // @@protoc_insertion_point(field:netsim.config.ThreadOptions.grpc_cpus)
+    pub grpc_cpus: ::std::string::String,
+    // @@protoc_insertion_point(field:netsim.config.ThreadOptions.background_cpus)
+    pub background_cpus: ::std::string::String,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.config.ThreadOptions.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a ThreadOptions {
+    fn default() -> &'a ThreadOptions {
+        <ThreadOptions as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl ThreadOptions {
+    pub fn new() -> ThreadOptions {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(4);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "bluetooth_cpus",
+            |m: &ThreadOptions| { &m.bluetooth_cpus },
+            |m: &mut ThreadOptions| { &mut m.bluetooth_cpus },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "wifi_cpus",
+            |m: &ThreadOptions| { &m.wifi_cpus },
+            |m: &mut ThreadOptions| { &mut m.wifi_cpus },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "grpc_cpus",
+            |m: &ThreadOptions| { &m.grpc_cpus },
+            |m: &mut ThreadOptions| { &mut m.grpc_cpus },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "background_cpus",
+            |m: &ThreadOptions| { &m.background_cpus },
+            |m: &mut ThreadOptions| { &mut m.background_cpus },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<ThreadOptions>(
+            "ThreadOptions",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for ThreadOptions {
+    const NAME: &'static str = "ThreadOptions";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                10 => {
+                    self.bluetooth_cpus = is.read_string()?;
+                },
+                18 => {
+                    self.wifi_cpus = is.read_string()?;
+                },
+                26 => {
+                    self.grpc_cpus = is.read_string()?;
+                },
+                34 => {
+                    self.background_cpus = is.read_string()?;
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if !self.bluetooth_cpus.is_empty() {
+            my_size += ::protobuf::rt::string_size(1, &self.bluetooth_cpus);
+        }
+        if !self.wifi_cpus.is_empty() {
+            my_size += ::protobuf::rt::string_size(2, &self.wifi_cpus);
+        }
+        if !self.grpc_cpus.is_empty() {
+            my_size += ::protobuf::rt::string_size(3, &self.grpc_cpus);
+        }
+        if !self.background_cpus.is_empty() {
+            my_size += ::protobuf::rt::string_size(4, &self.background_cpus);
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if !self.bluetooth_cpus.is_empty() {
+            os.write_string(1, &self.bluetooth_cpus)?;
+        }
+        if !self.wifi_cpus.is_empty() {
+            os.write_string(2, &self.wifi_cpus)?;
+        }
+        if !self.grpc_cpus.is_empty() {
+            os.write_string(3, &self.grpc_cpus)?;
+        }
+        if !self.background_cpus.is_empty() {
+            os.write_string(4, &self.background_cpus)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> ThreadOptions {
+        ThreadOptions::new()
+    }
+
+    fn clear(&mut self) {
+        self.bluetooth_cpus.clear();
+        self.wifi_cpus.clear();
+        self.grpc_cpus.clear();
+        self.background_cpus.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static ThreadOptions {
+        static instance: ThreadOptions = ThreadOptions {
+            bluetooth_cpus: ::std::string::String::new(),
+            wifi_cpus: ::std::string::String::new(),
+            grpc_cpus: ::std::string::String::new(),
+            background_cpus: ::std::string::String::new(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for ThreadOptions {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("ThreadOptions").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for ThreadOptions {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for ThreadOptions {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
 #[derive(PartialEq,Clone,Default,Debug)]
 // @@protoc_insertion_point(message:netsim.config.Config)
 pub struct Config {
@@ -866,6 +1682,12 @@ pub struct Config {
     pub bluetooth: ::protobuf::MessageField<Bluetooth>,
     // @@protoc_insertion_point(field:netsim.config.Config.wifi)
     pub wifi: ::protobuf::MessageField<WiFi>,
+    // @@protoc_insertion_point(field:netsim.config.Config.grpc_server)
+    pub grpc_server: ::protobuf::MessageField<GrpcServerOptions>,
+    // @@protoc_insertion_point(field:netsim.config.Config.federation)
+    pub federation: ::protobuf::MessageField<Federation>,
+    // @@protoc_insertion_point(field:netsim.config.Config.threads)
+    pub threads: ::protobuf::MessageField<ThreadOptions>,
     // special fields
     // @@protoc_insertion_point(special_field:netsim.config.Config.special_fields)
     pub special_fields: ::protobuf::SpecialFields,
@@ -883,7 +1705,7 @@ impl Config {
     }
 
     fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
-        let mut fields = ::std::vec::Vec::with_capacity(2);
+        let mut fields = ::std::vec::Vec::with_capacity(5);
         let mut oneofs = ::std::vec::Vec::with_capacity(0);
         fields.push(::protobuf::reflect::rt::v2::make_message_field_accessor::<_, Bluetooth>(
             "bluetooth",
@@ -895,6 +1717,21 @@ impl Config {
             |m: &Config| { &m.wifi },
             |m: &mut Config| { &mut m.wifi },
         ));
+        fields.push(::protobuf::reflect::rt::v2::make_message_field_accessor::<_, GrpcServerOptions>(
+            "grpc_server",
+            |m: &Config| { &m.grpc_server },
+            |m: &mut Config| { &mut m.grpc_server },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_message_field_accessor::<_, Federation>(
+            "federation",
+            |m: &Config| { &m.federation },
+            |m: &mut Config| { &mut m.federation },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_message_field_accessor::<_, ThreadOptions>(
+            "threads",
+            |m: &Config| { &m.threads },
+            |m: &mut Config| { &mut m.threads },
+        ));
         ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<Config>(
             "Config",
             fields,
@@ -919,6 +1756,15 @@ impl ::protobuf::Message for Config {
                 18 => {
                     ::protobuf::rt::read_singular_message_into_field(is, &mut self.wifi)?;
                 },
+                26 => {
+                    ::protobuf::rt::read_singular_message_into_field(is, &mut self.grpc_server)?;
+                },
+                34 => {
+                    ::protobuf::rt::read_singular_message_into_field(is, &mut self.federation)?;
+                },
+                42 => {
+                    ::protobuf::rt::read_singular_message_into_field(is, &mut self.threads)?;
+                },
                 tag => {
                     ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
                 },
@@ -939,6 +1785,18 @@ impl ::protobuf::Message for Config {
             let len = v.compute_size();
             my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
         }
+        if let Some(v) = self.grpc_server.as_ref() {
+            let len = v.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        }
+        if let Some(v) = self.federation.as_ref() {
+            let len = v.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        }
+        if let Some(v) = self.threads.as_ref() {
+            let len = v.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        }
         my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
         self.special_fields.cached_size().set(my_size as u32);
         my_size
@@ -951,6 +1809,15 @@ impl ::protobuf::Message for Config {
         if let Some(v) = self.wifi.as_ref() {
             ::protobuf::rt::write_message_field_with_cached_size(2, v, os)?;
         }
+        if let Some(v) = self.grpc_server.as_ref() {
+            ::protobuf::rt::write_message_field_with_cached_size(3, v, os)?;
+        }
+        if let Some(v) = self.federation.as_ref() {
+            ::protobuf::rt::write_message_field_with_cached_size(4, v, os)?;
+        }
+        if let Some(v) = self.threads.as_ref() {
+            ::protobuf::rt::write_message_field_with_cached_size(5, v, os)?;
+        }
         os.write_unknown_fields(self.special_fields.unknown_fields())?;
         ::std::result::Result::Ok(())
     }
@@ -970,6 +1837,9 @@ impl ::protobuf::Message for Config {
     fn clear(&mut self) {
         self.bluetooth.clear();
         self.wifi.clear();
+        self.grpc_server.clear();
+        self.federation.clear();
+        self.threads.clear();
         self.special_fields.clear();
     }
 
@@ -977,6 +1847,9 @@ impl ::protobuf::Message for Config {
         static instance: Config = Config {
             bluetooth: ::protobuf::MessageField::none(),
             wifi: ::protobuf::MessageField::none(),
+            grpc_server: ::protobuf::MessageField::none(),
+            federation: ::protobuf::MessageField::none(),
+            threads: ::protobuf::MessageField::none(),
             special_fields: ::protobuf::SpecialFields::new(),
         };
         &instance
@@ -1000,6 +1873,64 @@ impl ::protobuf::reflect::ProtobufValue for Config {
     type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
 }
 
+#[derive(Clone,Copy,PartialEq,Eq,Debug,Hash)]
+// @@protoc_insertion_point(enum:netsim.config.EgressDropPolicy)
+pub enum EgressDropPolicy {
+    // @@protoc_insertion_point(enum_value:netsim.config.EgressDropPolicy.EGRESS_DROP_DEFAULT)
+    EGRESS_DROP_DEFAULT = 0,
+    // @@protoc_insertion_point(enum_value:netsim.config.EgressDropPolicy.EGRESS_DROP_NEW)
+    EGRESS_DROP_NEW = 1,
+    // @@protoc_insertion_point(enum_value:netsim.config.EgressDropPolicy.EGRESS_DROP_OLDEST)
+    EGRESS_DROP_OLDEST = 2,
+}
+
+impl ::protobuf::Enum for EgressDropPolicy {
+    const NAME: &'static str = "EgressDropPolicy";
+
+    fn value(&self) -> i32 {
+        *self as i32
+    }
+
+    fn from_i32(value: i32) -> ::std::option::Option<EgressDropPolicy> {
+        match value {
+            0 => ::std::option::Option::Some(EgressDropPolicy::EGRESS_DROP_DEFAULT),
+            1 => ::std::option::Option::Some(EgressDropPolicy::EGRESS_DROP_NEW),
+            2 => ::std::option::Option::Some(EgressDropPolicy::EGRESS_DROP_OLDEST),
+            _ => ::std::option::Option::None
+        }
+    }
+
+    const VALUES: &'static [EgressDropPolicy] = &[
+        EgressDropPolicy::EGRESS_DROP_DEFAULT,
+        EgressDropPolicy::EGRESS_DROP_NEW,
+        EgressDropPolicy::EGRESS_DROP_OLDEST,
+    ];
+}
+
+impl ::protobuf::EnumFull for EgressDropPolicy {
+    fn enum_descriptor() -> ::protobuf::reflect::EnumDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::EnumDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().enum_by_package_relative_name("EgressDropPolicy").unwrap()).clone()
+    }
+
+    fn descriptor(&self) -> ::protobuf::reflect::EnumValueDescriptor {
+        let index = *self as usize;
+        Self::enum_descriptor().value_by_index(index)
+    }
+}
+
+impl ::std::default::Default for EgressDropPolicy {
+    fn default() -> Self {
+        EgressDropPolicy::EGRESS_DROP_DEFAULT
+    }
+}
+
+impl EgressDropPolicy {
+    fn generated_enum_descriptor_data() -> ::protobuf::reflect::GeneratedEnumDescriptorData {
+        ::protobuf::reflect::GeneratedEnumDescriptorData::new::<EgressDropPolicy>("EgressDropPolicy")
+    }
+}
+
 static file_descriptor_proto_data: &'static [u8] = b"\
     \n\x13netsim/config.proto\x12\rnetsim.config\x1a\x1drootcanal/configurat\
     ion.proto\"\xba\x03\n\x0cSlirpOptions\x12\x1a\n\x08disabled\x18\x01\x20\
@@ -1017,16 +1948,50 @@ static file_descriptor_proto_data: &'static [u8] = b"\
     \x20\x01(\tR\x04dns6B\x07\n\x05_ipv4B\x07\n\x05_ipv6\"j\n\x0eHostapdOpti\
     ons\x12\x1f\n\x08disabled\x18\x01\x20\x01(\x08H\0R\x08disabled\x88\x01\
     \x01\x12\x12\n\x04ssid\x18\x02\x20\x01(\tR\x04ssid\x12\x16\n\x06passwd\
-    \x18\x03\x20\x01(\tR\x06passwdB\x0b\n\t_disabled\"\x90\x01\n\x04WiFi\x12\
+    \x18\x03\x20\x01(\tR\x06passwdB\x0b\n\t_disabled\"\xc5\x01\n\x04WiFi\x12\
     @\n\rslirp_options\x18\x01\x20\x01(\x0b2\x1b.netsim.config.SlirpOptionsR\
     \x0cslirpOptions\x12F\n\x0fhostapd_options\x18\x02\x20\x01(\x0b2\x1d.net\
-    sim.config.HostapdOptionsR\x0ehostapdOptions\"\xa0\x01\n\tBluetooth\x12H\
-    \n\nproperties\x18\x01\x20\x01(\x0b2#.rootcanal.configuration.Controller\
-    H\0R\nproperties\x88\x01\x01\x12(\n\raddress_reuse\x18\x02\x20\x01(\x08H\
-    \x01R\x0caddressReuse\x88\x01\x01B\r\n\x0b_propertiesB\x10\n\x0e_address\
-    _reuse\"i\n\x06Config\x126\n\tbluetooth\x18\x01\x20\x01(\x0b2\x18.netsim\
-    .config.BluetoothR\tbluetooth\x12'\n\x04wifi\x18\x02\x20\x01(\x0b2\x13.n\
-    etsim.config.WiFiR\x04wifib\x06proto3\
+    sim.config.HostapdOptionsR\x0ehostapdOptions\x123\n\x16slirp_poll_interv\
+    al_ms\x18\x03\x20\x01(\rR\x13slirpPollIntervalMs\"\x92\x02\n\tBluetooth\
+    \x12H\n\nproperties\x18\x01\x20\x01(\x0b2#.rootcanal.configuration.Contr\
+    ollerH\0R\nproperties\x88\x01\x01\x12(\n\raddress_reuse\x18\x02\x20\x01(\
+    \x08H\x01R\x0caddressReuse\x88\x01\x01\x12$\n\x0bradio_range\x18\x03\x20\
+    \x01(\x02H\x02R\nradioRange\x88\x01\x01\x12(\n\rlatency_stats\x18\x04\
+    \x20\x01(\x08H\x03R\x0clatencyStats\x88\x01\x01B\r\n\x0b_propertiesB\x10\
+    \n\x0e_address_reuseB\x0e\n\x0c_radio_rangeB\x10\n\x0e_latency_stats\"\
+    \x9b\x06\n\x11GrpcServerOptions\x12\x1f\n\x0bmin_pollers\x18\x01\x20\x01\
+    (\rR\nminPollers\x12\x1f\n\x0bmax_pollers\x18\x02\x20\x01(\rR\nmaxPoller\
+    s\x122\n\x15num_completion_queues\x18\x03\x20\x01(\rR\x13numCompletionQu\
+    eues\x12\x1f\n\x0bmax_threads\x18\x04\x20\x01(\rR\nmaxThreads\x12\"\n\rm\
+    ax_memory_mb\x18\x05\x20\x01(\rR\x0bmaxMemoryMb\x124\n\x16max_concurrent\
+    _streams\x18\x06\x20\x01(\rR\x14maxConcurrentStreams\x12.\n\x13stream_wi\
+    ndow_bytes\x18\x07\x20\x01(\rR\x11streamWindowBytes\x12*\n\x11keepalive_\
+    time_ms\x18\x08\x20\x01(\rR\x0fkeepaliveTimeMs\x120\n\x14keepalive_timeo\
+    ut_ms\x18\t\x20\x01(\rR\x12keepaliveTimeoutMs\x12+\n\x11separate_fronten\
+    d\x18\n\x20\x01(\x08R\x10separateFrontend\x12#\n\rfrontend_port\x18\x0b\
+    \x20\x01(\rR\x0cfrontendPort\x120\n\x14frontend_max_threads\x18\x0c\x20\
+    \x01(\rR\x12frontendMaxThreads\x12,\n\x12egress_queue_bytes\x18\r\x20\
+    \x01(\rR\x10egressQueueBytes\x12M\n\x12egress_data_policy\x18\x0e\x20\
+    \x01(\x0e2\x1f.netsim.config.EgressDropPolicyR\x10egressDataPolicy\x12O\
+    \n\x13egress_audio_policy\x18\x0f\x20\x01(\x0e2\x1f.netsim.config.Egress\
+    DropPolicyR\x11egressAudioPolicy\x125\n\x17egress_stall_timeout_ms\x18\
+    \x10\x20\x01(\rR\x14egressStallTimeoutMs\"\xb1\x01\n\nFederation\x12\x17\
+    \n\x07node_id\x18\x01\x20\x01(\rR\x06nodeId\x12\x14\n\x05peers\x18\x02\
+    \x20\x03(\tR\x05peers\x12\x20\n\x0cwifi_node_id\x18\x03\x20\x01(\rR\nwif\
+    iNodeId\x12*\n\x11flush_interval_us\x18\x04\x20\x01(\rR\x0fflushInterval\
+    Us\x12&\n\x0fmax_batch_bytes\x18\x05\x20\x01(\rR\rmaxBatchBytes\"\x99\
+    \x01\n\rThreadOptions\x12%\n\x0ebluetooth_cpus\x18\x01\x20\x01(\tR\rblue\
+    toothCpus\x12\x1b\n\twifi_cpus\x18\x02\x20\x01(\tR\x08wifiCpus\x12\x1b\n\
+    \tgrpc_cpus\x18\x03\x20\x01(\tR\x08grpcCpus\x12'\n\x0fbackground_cpus\
+    \x18\x04\x20\x01(\tR\x0ebackgroundCpus\"\x9f\x02\n\x06Config\x126\n\tblu\
+    etooth\x18\x01\x20\x01(\x0b2\x18.netsim.config.BluetoothR\tbluetooth\x12\
+    '\n\x04wifi\x18\x02\x20\x01(\x0b2\x13.netsim.config.WiFiR\x04wifi\x12A\n\
+    \x0bgrpc_server\x18\x03\x20\x01(\x0b2\x20.netsim.config.GrpcServerOption\
+    sR\ngrpcServer\x129\n\nfederation\x18\x04\x20\x01(\x0b2\x19.netsim.confi\
+    g.FederationR\nfederation\x126\n\x07threads\x18\x05\x20\x01(\x0b2\x1c.ne\
+    tsim.config.ThreadOptionsR\x07threads*X\n\x10EgressDropPolicy\x12\x17\n\
+    \x13EGRESS_DROP_DEFAULT\x10\0\x12\x13\n\x0fEGRESS_DROP_NEW\x10\x01\x12\
+    \x16\n\x12EGRESS_DROP_OLDEST\x10\x02b\x06proto3\
 ";
 
 /// `FileDescriptorProto` object which was a source for this generated file
@@ -1045,13 +2010,17 @@ pub fn file_descriptor() -> &'static ::protobuf::reflect::FileDescriptor {
         let generated_file_descriptor = generated_file_descriptor_lazy.get(|| {
             let mut deps = ::std::vec::Vec::with_capacity(1);
             deps.push(super::configuration::file_descriptor().clone());
-            let mut messages = ::std::vec::Vec::with_capacity(5);
+            let mut messages = ::std::vec::Vec::with_capacity(8);
             messages.push(SlirpOptions::generated_message_descriptor_data());
             messages.push(HostapdOptions::generated_message_descriptor_data());
             messages.push(WiFi::generated_message_descriptor_data());
             messages.push(Bluetooth::generated_message_descriptor_data());
+            messages.push(GrpcServerOptions::generated_message_descriptor_data());
+            messages.push(Federation::generated_message_descriptor_data());
+            messages.push(ThreadOptions::generated_message_descriptor_data());
             messages.push(Config::generated_message_descriptor_data());
-            let mut enums = ::std::vec::Vec::with_capacity(0);
+            let mut enums = ::std::vec::Vec::with_capacity(1);
+            enums.push(EgressDropPolicy::generated_enum_descriptor_data());
             ::protobuf::reflect::GeneratedFileDescriptor::new_generated(
                 file_descriptor_proto(),
                 deps,
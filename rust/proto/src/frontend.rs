@@ -638,6 +638,129 @@ impl ::protobuf::reflect::ProtobufValue for PatchDeviceRequest {
     type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
 }
 
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.PatchDevicesRequest)
+pub struct PatchDevicesRequest {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.PatchDevicesRequest.patches)
+    pub patches: ::std::vec::Vec<PatchDeviceRequest>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.PatchDevicesRequest.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a PatchDevicesRequest {
+    fn default() -> &'a PatchDevicesRequest {
+        <PatchDevicesRequest as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl PatchDevicesRequest {
+    pub fn new() -> PatchDevicesRequest {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(1);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "patches",
+            |m: &PatchDevicesRequest| { &m.patches },
+            |m: &mut PatchDevicesRequest| { &mut m.patches },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<PatchDevicesRequest>(
+            "PatchDevicesRequest",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for PatchDevicesRequest {
+    const NAME: &'static str = "PatchDevicesRequest";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                10 => {
+                    self.patches.push(is.read_message()?);
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        for value in &self.patches {
+            let len = value.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        };
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        for v in &self.patches {
+            ::protobuf::rt::write_message_field_with_cached_size(1, v, os)?;
+        };
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> PatchDevicesRequest {
+        PatchDevicesRequest::new()
+    }
+
+    fn clear(&mut self) {
+        self.patches.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static PatchDevicesRequest {
+        static instance: PatchDevicesRequest = PatchDevicesRequest {
+            patches: ::std::vec::Vec::new(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for PatchDevicesRequest {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("PatchDevicesRequest").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for PatchDevicesRequest {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for PatchDevicesRequest {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
 #[derive(PartialEq,Clone,Default,Debug)]
 // @@protoc_insertion_point(message:netsim.frontend.ListDeviceResponse)
 pub struct ListDeviceResponse {
@@ -1156,6 +1279,8 @@ pub struct GetCaptureRequest {
     // message fields
     // @@protoc_insertion_point(field:netsim.frontend.GetCaptureRequest.id)
     pub id: u32,
+    // @@protoc_insertion_point(field:netsim.frontend.GetCaptureRequest.offset)
+    pub offset: u64,
     // special fields
     // @@protoc_insertion_point(special_field:netsim.frontend.GetCaptureRequest.special_fields)
     pub special_fields: ::protobuf::SpecialFields,
@@ -1173,13 +1298,18 @@ impl GetCaptureRequest {
     }
 
     fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
-        let mut fields = ::std::vec::Vec::with_capacity(1);
+        let mut fields = ::std::vec::Vec::with_capacity(2);
         let mut oneofs = ::std::vec::Vec::with_capacity(0);
         fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
             "id",
             |m: &GetCaptureRequest| { &m.id },
             |m: &mut GetCaptureRequest| { &mut m.id },
         ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "offset",
+            |m: &GetCaptureRequest| { &m.offset },
+            |m: &mut GetCaptureRequest| { &mut m.offset },
+        ));
         ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<GetCaptureRequest>(
             "GetCaptureRequest",
             fields,
@@ -1201,6 +1331,9 @@ impl ::protobuf::Message for GetCaptureRequest {
                 8 => {
                     self.id = is.read_uint32()?;
                 },
+                16 => {
+                    self.offset = is.read_uint64()?;
+                },
                 tag => {
                     ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
                 },
@@ -1216,6 +1349,9 @@ impl ::protobuf::Message for GetCaptureRequest {
         if self.id != 0 {
             my_size += ::protobuf::rt::uint32_size(1, self.id);
         }
+        if self.offset != 0 {
+            my_size += ::protobuf::rt::uint64_size(2, self.offset);
+        }
         my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
         self.special_fields.cached_size().set(my_size as u32);
         my_size
@@ -1225,6 +1361,9 @@ impl ::protobuf::Message for GetCaptureRequest {
         if self.id != 0 {
             os.write_uint32(1, self.id)?;
         }
+        if self.offset != 0 {
+            os.write_uint64(2, self.offset)?;
+        }
         os.write_unknown_fields(self.special_fields.unknown_fields())?;
         ::std::result::Result::Ok(())
     }
@@ -1243,12 +1382,14 @@ impl ::protobuf::Message for GetCaptureRequest {
 
     fn clear(&mut self) {
         self.id = 0;
+        self.offset = 0;
         self.special_fields.clear();
     }
 
     fn default_instance() -> &'static GetCaptureRequest {
         static instance: GetCaptureRequest = GetCaptureRequest {
             id: 0,
+            offset: 0,
             special_fields: ::protobuf::SpecialFields::new(),
         };
         &instance
@@ -1394,37 +1535,1731 @@ impl ::protobuf::reflect::ProtobufValue for GetCaptureResponse {
     type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
 }
 
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.WatchDevicesRequest)
+pub struct WatchDevicesRequest {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.WatchDevicesRequest.max_rate_hz)
+    pub max_rate_hz: u32,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.WatchDevicesRequest.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a WatchDevicesRequest {
+    fn default() -> &'a WatchDevicesRequest {
+        <WatchDevicesRequest as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl WatchDevicesRequest {
+    pub fn new() -> WatchDevicesRequest {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(1);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "max_rate_hz",
+            |m: &WatchDevicesRequest| { &m.max_rate_hz },
+            |m: &mut WatchDevicesRequest| { &mut m.max_rate_hz },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<WatchDevicesRequest>(
+            "WatchDevicesRequest",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for WatchDevicesRequest {
+    const NAME: &'static str = "WatchDevicesRequest";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.max_rate_hz = is.read_uint32()?;
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if self.max_rate_hz != 0 {
+            my_size += ::protobuf::rt::uint32_size(1, self.max_rate_hz);
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if self.max_rate_hz != 0 {
+            os.write_uint32(1, self.max_rate_hz)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> WatchDevicesRequest {
+        WatchDevicesRequest::new()
+    }
+
+    fn clear(&mut self) {
+        self.max_rate_hz = 0;
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static WatchDevicesRequest {
+        static instance: WatchDevicesRequest = WatchDevicesRequest {
+            max_rate_hz: 0,
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for WatchDevicesRequest {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("WatchDevicesRequest").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for WatchDevicesRequest {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for WatchDevicesRequest {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.WatchDevicesResponse)
+pub struct WatchDevicesResponse {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.WatchDevicesResponse.devices)
+    pub devices: ::std::vec::Vec<super::model::Device>,
+    // @@protoc_insertion_point(field:netsim.frontend.WatchDevicesResponse.removed_device_ids)
+    pub removed_device_ids: ::std::vec::Vec<u32>,
+    // @@protoc_insertion_point(field:netsim.frontend.WatchDevicesResponse.removed_chip_ids)
+    pub removed_chip_ids: ::std::vec::Vec<u32>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.WatchDevicesResponse.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a WatchDevicesResponse {
+    fn default() -> &'a WatchDevicesResponse {
+        <WatchDevicesResponse as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl WatchDevicesResponse {
+    pub fn new() -> WatchDevicesResponse {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(3);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "devices",
+            |m: &WatchDevicesResponse| { &m.devices },
+            |m: &mut WatchDevicesResponse| { &mut m.devices },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "removed_device_ids",
+            |m: &WatchDevicesResponse| { &m.removed_device_ids },
+            |m: &mut WatchDevicesResponse| { &mut m.removed_device_ids },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "removed_chip_ids",
+            |m: &WatchDevicesResponse| { &m.removed_chip_ids },
+            |m: &mut WatchDevicesResponse| { &mut m.removed_chip_ids },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<WatchDevicesResponse>(
+            "WatchDevicesResponse",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for WatchDevicesResponse {
+    const NAME: &'static str = "WatchDevicesResponse";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                10 => {
+                    self.devices.push(is.read_message()?);
+                },
+                18 => {
+                    is.read_repeated_packed_uint32_into(&mut self.removed_device_ids)?;
+                },
+                16 => {
+                    self.removed_device_ids.push(is.read_uint32()?);
+                },
+                26 => {
+                    is.read_repeated_packed_uint32_into(&mut self.removed_chip_ids)?;
+                },
+                24 => {
+                    self.removed_chip_ids.push(is.read_uint32()?);
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        for value in &self.devices {
+            let len = value.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        };
+        my_size += ::protobuf::rt::vec_packed_uint32_size(2, &self.removed_device_ids);
+        my_size += ::protobuf::rt::vec_packed_uint32_size(3, &self.removed_chip_ids);
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        for v in &self.devices {
+            ::protobuf::rt::write_message_field_with_cached_size(1, v, os)?;
+        };
+        os.write_repeated_packed_uint32(2, &self.removed_device_ids)?;
+        os.write_repeated_packed_uint32(3, &self.removed_chip_ids)?;
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> WatchDevicesResponse {
+        WatchDevicesResponse::new()
+    }
+
+    fn clear(&mut self) {
+        self.devices.clear();
+        self.removed_device_ids.clear();
+        self.removed_chip_ids.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static WatchDevicesResponse {
+        static instance: WatchDevicesResponse = WatchDevicesResponse {
+            devices: ::std::vec::Vec::new(),
+            removed_device_ids: ::std::vec::Vec::new(),
+            removed_chip_ids: ::std::vec::Vec::new(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for WatchDevicesResponse {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("WatchDevicesResponse").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for WatchDevicesResponse {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for WatchDevicesResponse {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.ByteMatch)
+pub struct ByteMatch {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.ByteMatch.offset)
+    pub offset: u32,
+    // @@protoc_insertion_point(field:netsim.frontend.ByteMatch.value)
+    pub value: ::std::vec::Vec<u8>,
+    // @@protoc_insertion_point(field:netsim.frontend.ByteMatch.mask)
+    pub mask: ::std::vec::Vec<u8>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.ByteMatch.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a ByteMatch {
+    fn default() -> &'a ByteMatch {
+        <ByteMatch as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl ByteMatch {
+    pub fn new() -> ByteMatch {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(3);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "offset",
+            |m: &ByteMatch| { &m.offset },
+            |m: &mut ByteMatch| { &mut m.offset },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "value",
+            |m: &ByteMatch| { &m.value },
+            |m: &mut ByteMatch| { &mut m.value },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "mask",
+            |m: &ByteMatch| { &m.mask },
+            |m: &mut ByteMatch| { &mut m.mask },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<ByteMatch>(
+            "ByteMatch",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for ByteMatch {
+    const NAME: &'static str = "ByteMatch";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.offset = is.read_uint32()?;
+                },
+                18 => {
+                    self.value = is.read_bytes()?;
+                },
+                26 => {
+                    self.mask = is.read_bytes()?;
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if self.offset != 0 {
+            my_size += ::protobuf::rt::uint32_size(1, self.offset);
+        }
+        if !self.value.is_empty() {
+            my_size += ::protobuf::rt::bytes_size(2, &self.value);
+        }
+        if !self.mask.is_empty() {
+            my_size += ::protobuf::rt::bytes_size(3, &self.mask);
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if self.offset != 0 {
+            os.write_uint32(1, self.offset)?;
+        }
+        if !self.value.is_empty() {
+            os.write_bytes(2, &self.value)?;
+        }
+        if !self.mask.is_empty() {
+            os.write_bytes(3, &self.mask)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> ByteMatch {
+        ByteMatch::new()
+    }
+
+    fn clear(&mut self) {
+        self.offset = 0;
+        self.value.clear();
+        self.mask.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static ByteMatch {
+        static instance: ByteMatch = ByteMatch {
+            offset: 0,
+            value: ::std::vec::Vec::new(),
+            mask: ::std::vec::Vec::new(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for ByteMatch {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("ByteMatch").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for ByteMatch {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for ByteMatch {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.CaptureFilter)
+pub struct CaptureFilter {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.CaptureFilter.packet_types)
+    pub packet_types: ::std::vec::Vec<u32>,
+    // @@protoc_insertion_point(field:netsim.frontend.CaptureFilter.host_to_controller)
+    pub host_to_controller: bool,
+    // @@protoc_insertion_point(field:netsim.frontend.CaptureFilter.controller_to_host)
+    pub controller_to_host: bool,
+    // @@protoc_insertion_point(field:netsim.frontend.CaptureFilter.byte_matches)
+    pub byte_matches: ::std::vec::Vec<ByteMatch>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.CaptureFilter.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a CaptureFilter {
+    fn default() -> &'a CaptureFilter {
+        <CaptureFilter as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl CaptureFilter {
+    pub fn new() -> CaptureFilter {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(4);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "packet_types",
+            |m: &CaptureFilter| { &m.packet_types },
+            |m: &mut CaptureFilter| { &mut m.packet_types },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "host_to_controller",
+            |m: &CaptureFilter| { &m.host_to_controller },
+            |m: &mut CaptureFilter| { &mut m.host_to_controller },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "controller_to_host",
+            |m: &CaptureFilter| { &m.controller_to_host },
+            |m: &mut CaptureFilter| { &mut m.controller_to_host },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "byte_matches",
+            |m: &CaptureFilter| { &m.byte_matches },
+            |m: &mut CaptureFilter| { &mut m.byte_matches },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<CaptureFilter>(
+            "CaptureFilter",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for CaptureFilter {
+    const NAME: &'static str = "CaptureFilter";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                10 => {
+                    is.read_repeated_packed_uint32_into(&mut self.packet_types)?;
+                },
+                8 => {
+                    self.packet_types.push(is.read_uint32()?);
+                },
+                16 => {
+                    self.host_to_controller = is.read_bool()?;
+                },
+                24 => {
+                    self.controller_to_host = is.read_bool()?;
+                },
+                34 => {
+                    self.byte_matches.push(is.read_message()?);
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        my_size += ::protobuf::rt::vec_packed_uint32_size(1, &self.packet_types);
+        if self.host_to_controller != false {
+            my_size += 1 + 1;
+        }
+        if self.controller_to_host != false {
+            my_size += 1 + 1;
+        }
+        for value in &self.byte_matches {
+            let len = value.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        };
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        os.write_repeated_packed_uint32(1, &self.packet_types)?;
+        if self.host_to_controller != false {
+            os.write_bool(2, self.host_to_controller)?;
+        }
+        if self.controller_to_host != false {
+            os.write_bool(3, self.controller_to_host)?;
+        }
+        for v in &self.byte_matches {
+            ::protobuf::rt::write_message_field_with_cached_size(4, v, os)?;
+        };
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> CaptureFilter {
+        CaptureFilter::new()
+    }
+
+    fn clear(&mut self) {
+        self.packet_types.clear();
+        self.host_to_controller = false;
+        self.controller_to_host = false;
+        self.byte_matches.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static CaptureFilter {
+        static instance: CaptureFilter = CaptureFilter {
+            packet_types: ::std::vec::Vec::new(),
+            host_to_controller: false,
+            controller_to_host: false,
+            byte_matches: ::std::vec::Vec::new(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for CaptureFilter {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("CaptureFilter").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for CaptureFilter {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for CaptureFilter {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.TailCaptureRequest)
+pub struct TailCaptureRequest {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.TailCaptureRequest.id)
+    pub id: u32,
+    // @@protoc_insertion_point(field:netsim.frontend.TailCaptureRequest.filter)
+    pub filter: ::protobuf::MessageField<CaptureFilter>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.TailCaptureRequest.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a TailCaptureRequest {
+    fn default() -> &'a TailCaptureRequest {
+        <TailCaptureRequest as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl TailCaptureRequest {
+    pub fn new() -> TailCaptureRequest {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(2);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "id",
+            |m: &TailCaptureRequest| { &m.id },
+            |m: &mut TailCaptureRequest| { &mut m.id },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_message_field_accessor::<_, CaptureFilter>(
+            "filter",
+            |m: &TailCaptureRequest| { &m.filter },
+            |m: &mut TailCaptureRequest| { &mut m.filter },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<TailCaptureRequest>(
+            "TailCaptureRequest",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for TailCaptureRequest {
+    const NAME: &'static str = "TailCaptureRequest";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.id = is.read_uint32()?;
+                },
+                18 => {
+                    ::protobuf::rt::read_singular_message_into_field(is, &mut self.filter)?;
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if self.id != 0 {
+            my_size += ::protobuf::rt::uint32_size(1, self.id);
+        }
+        if let Some(v) = self.filter.as_ref() {
+            let len = v.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if self.id != 0 {
+            os.write_uint32(1, self.id)?;
+        }
+        if let Some(v) = self.filter.as_ref() {
+            ::protobuf::rt::write_message_field_with_cached_size(2, v, os)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> TailCaptureRequest {
+        TailCaptureRequest::new()
+    }
+
+    fn clear(&mut self) {
+        self.id = 0;
+        self.filter.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static TailCaptureRequest {
+        static instance: TailCaptureRequest = TailCaptureRequest {
+            id: 0,
+            filter: ::protobuf::MessageField::none(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for TailCaptureRequest {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("TailCaptureRequest").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for TailCaptureRequest {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for TailCaptureRequest {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.GetLatencyStatsResponse)
+pub struct GetLatencyStatsResponse {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.GetLatencyStatsResponse.latency_stats)
+    pub latency_stats: ::std::vec::Vec<super::stats::NetsimChipLatencyStats>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.GetLatencyStatsResponse.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a GetLatencyStatsResponse {
+    fn default() -> &'a GetLatencyStatsResponse {
+        <GetLatencyStatsResponse as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl GetLatencyStatsResponse {
+    pub fn new() -> GetLatencyStatsResponse {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(1);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "latency_stats",
+            |m: &GetLatencyStatsResponse| { &m.latency_stats },
+            |m: &mut GetLatencyStatsResponse| { &mut m.latency_stats },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<GetLatencyStatsResponse>(
+            "GetLatencyStatsResponse",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for GetLatencyStatsResponse {
+    const NAME: &'static str = "GetLatencyStatsResponse";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                10 => {
+                    self.latency_stats.push(is.read_message()?);
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        for value in &self.latency_stats {
+            let len = value.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        };
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        for v in &self.latency_stats {
+            ::protobuf::rt::write_message_field_with_cached_size(1, v, os)?;
+        };
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> GetLatencyStatsResponse {
+        GetLatencyStatsResponse::new()
+    }
+
+    fn clear(&mut self) {
+        self.latency_stats.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static GetLatencyStatsResponse {
+        static instance: GetLatencyStatsResponse = GetLatencyStatsResponse {
+            latency_stats: ::std::vec::Vec::new(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for GetLatencyStatsResponse {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("GetLatencyStatsResponse").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for GetLatencyStatsResponse {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for GetLatencyStatsResponse {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.FlightRecord)
+pub struct FlightRecord {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.FlightRecord.timestamp_us)
+    pub timestamp_us: u64,
+    // @@protoc_insertion_point(field:netsim.frontend.FlightRecord.egress)
+    pub egress: bool,
+    // @@protoc_insertion_point(field:netsim.frontend.FlightRecord.packet_type)
+    pub packet_type: u32,
+    // @@protoc_insertion_point(field:netsim.frontend.FlightRecord.length)
+    pub length: u32,
+    // @@protoc_insertion_point(field:netsim.frontend.FlightRecord.packet)
+    pub packet: ::std::vec::Vec<u8>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.FlightRecord.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a FlightRecord {
+    fn default() -> &'a FlightRecord {
+        <FlightRecord as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl FlightRecord {
+    pub fn new() -> FlightRecord {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(5);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "timestamp_us",
+            |m: &FlightRecord| { &m.timestamp_us },
+            |m: &mut FlightRecord| { &mut m.timestamp_us },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "egress",
+            |m: &FlightRecord| { &m.egress },
+            |m: &mut FlightRecord| { &mut m.egress },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "packet_type",
+            |m: &FlightRecord| { &m.packet_type },
+            |m: &mut FlightRecord| { &mut m.packet_type },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "length",
+            |m: &FlightRecord| { &m.length },
+            |m: &mut FlightRecord| { &mut m.length },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "packet",
+            |m: &FlightRecord| { &m.packet },
+            |m: &mut FlightRecord| { &mut m.packet },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<FlightRecord>(
+            "FlightRecord",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for FlightRecord {
+    const NAME: &'static str = "FlightRecord";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.timestamp_us = is.read_uint64()?;
+                },
+                16 => {
+                    self.egress = is.read_bool()?;
+                },
+                24 => {
+                    self.packet_type = is.read_uint32()?;
+                },
+                32 => {
+                    self.length = is.read_uint32()?;
+                },
+                42 => {
+                    self.packet = is.read_bytes()?;
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if self.timestamp_us != 0 {
+            my_size += ::protobuf::rt::uint64_size(1, self.timestamp_us);
+        }
+        if self.egress != false {
+            my_size += 1 + 1;
+        }
+        if self.packet_type != 0 {
+            my_size += ::protobuf::rt::uint32_size(3, self.packet_type);
+        }
+        if self.length != 0 {
+            my_size += ::protobuf::rt::uint32_size(4, self.length);
+        }
+        if !self.packet.is_empty() {
+            my_size += ::protobuf::rt::bytes_size(5, &self.packet);
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if self.timestamp_us != 0 {
+            os.write_uint64(1, self.timestamp_us)?;
+        }
+        if self.egress != false {
+            os.write_bool(2, self.egress)?;
+        }
+        if self.packet_type != 0 {
+            os.write_uint32(3, self.packet_type)?;
+        }
+        if self.length != 0 {
+            os.write_uint32(4, self.length)?;
+        }
+        if !self.packet.is_empty() {
+            os.write_bytes(5, &self.packet)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> FlightRecord {
+        FlightRecord::new()
+    }
+
+    fn clear(&mut self) {
+        self.timestamp_us = 0;
+        self.egress = false;
+        self.packet_type = 0;
+        self.length = 0;
+        self.packet.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static FlightRecord {
+        static instance: FlightRecord = FlightRecord {
+            timestamp_us: 0,
+            egress: false,
+            packet_type: 0,
+            length: 0,
+            packet: ::std::vec::Vec::new(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for FlightRecord {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("FlightRecord").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for FlightRecord {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for FlightRecord {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.ChipFlightRecords)
+pub struct ChipFlightRecords {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.ChipFlightRecords.chip_kind)
+    pub chip_kind: ::protobuf::EnumOrUnknown<super::common::ChipKind>,
+    // @@protoc_insertion_point(field:netsim.frontend.ChipFlightRecords.facade_id)
+    pub facade_id: u32,
+    // @@protoc_insertion_point(field:netsim.frontend.ChipFlightRecords.records)
+    pub records: ::std::vec::Vec<FlightRecord>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.ChipFlightRecords.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a ChipFlightRecords {
+    fn default() -> &'a ChipFlightRecords {
+        <ChipFlightRecords as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl ChipFlightRecords {
+    pub fn new() -> ChipFlightRecords {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(3);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "chip_kind",
+            |m: &ChipFlightRecords| { &m.chip_kind },
+            |m: &mut ChipFlightRecords| { &mut m.chip_kind },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "facade_id",
+            |m: &ChipFlightRecords| { &m.facade_id },
+            |m: &mut ChipFlightRecords| { &mut m.facade_id },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "records",
+            |m: &ChipFlightRecords| { &m.records },
+            |m: &mut ChipFlightRecords| { &mut m.records },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<ChipFlightRecords>(
+            "ChipFlightRecords",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for ChipFlightRecords {
+    const NAME: &'static str = "ChipFlightRecords";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.chip_kind = is.read_enum_or_unknown()?;
+                },
+                16 => {
+                    self.facade_id = is.read_uint32()?;
+                },
+                26 => {
+                    self.records.push(is.read_message()?);
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if self.chip_kind != ::protobuf::EnumOrUnknown::new(super::common::ChipKind::UNSPECIFIED) {
+            my_size += ::protobuf::rt::int32_size(1, self.chip_kind.value());
+        }
+        if self.facade_id != 0 {
+            my_size += ::protobuf::rt::uint32_size(2, self.facade_id);
+        }
+        for value in &self.records {
+            let len = value.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        };
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if self.chip_kind != ::protobuf::EnumOrUnknown::new(super::common::ChipKind::UNSPECIFIED) {
+            os.write_enum(1, ::protobuf::EnumOrUnknown::value(&self.chip_kind))?;
+        }
+        if self.facade_id != 0 {
+            os.write_uint32(2, self.facade_id)?;
+        }
+        for v in &self.records {
+            ::protobuf::rt::write_message_field_with_cached_size(3, v, os)?;
+        };
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> ChipFlightRecords {
+        ChipFlightRecords::new()
+    }
+
+    fn clear(&mut self) {
+        self.chip_kind = ::protobuf::EnumOrUnknown::new(super::common::ChipKind::UNSPECIFIED);
+        self.facade_id = 0;
+        self.records.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static ChipFlightRecords {
+        static instance: ChipFlightRecords = ChipFlightRecords {
+            chip_kind: ::protobuf::EnumOrUnknown::from_i32(0),
+            facade_id: 0,
+            records: ::std::vec::Vec::new(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for ChipFlightRecords {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("ChipFlightRecords").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for ChipFlightRecords {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for ChipFlightRecords {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.GetFlightRecordsResponse)
+pub struct GetFlightRecordsResponse {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.GetFlightRecordsResponse.chips)
+    pub chips: ::std::vec::Vec<ChipFlightRecords>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.GetFlightRecordsResponse.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a GetFlightRecordsResponse {
+    fn default() -> &'a GetFlightRecordsResponse {
+        <GetFlightRecordsResponse as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl GetFlightRecordsResponse {
+    pub fn new() -> GetFlightRecordsResponse {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(1);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "chips",
+            |m: &GetFlightRecordsResponse| { &m.chips },
+            |m: &mut GetFlightRecordsResponse| { &mut m.chips },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<GetFlightRecordsResponse>(
+            "GetFlightRecordsResponse",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for GetFlightRecordsResponse {
+    const NAME: &'static str = "GetFlightRecordsResponse";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                10 => {
+                    self.chips.push(is.read_message()?);
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        for value in &self.chips {
+            let len = value.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        };
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        for v in &self.chips {
+            ::protobuf::rt::write_message_field_with_cached_size(1, v, os)?;
+        };
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> GetFlightRecordsResponse {
+        GetFlightRecordsResponse::new()
+    }
+
+    fn clear(&mut self) {
+        self.chips.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static GetFlightRecordsResponse {
+        static instance: GetFlightRecordsResponse = GetFlightRecordsResponse {
+            chips: ::std::vec::Vec::new(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for GetFlightRecordsResponse {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("GetFlightRecordsResponse").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for GetFlightRecordsResponse {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for GetFlightRecordsResponse {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.SetTracingRequest)
+pub struct SetTracingRequest {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.SetTracingRequest.enabled)
+    pub enabled: bool,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.SetTracingRequest.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a SetTracingRequest {
+    fn default() -> &'a SetTracingRequest {
+        <SetTracingRequest as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl SetTracingRequest {
+    pub fn new() -> SetTracingRequest {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(1);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "enabled",
+            |m: &SetTracingRequest| { &m.enabled },
+            |m: &mut SetTracingRequest| { &mut m.enabled },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<SetTracingRequest>(
+            "SetTracingRequest",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for SetTracingRequest {
+    const NAME: &'static str = "SetTracingRequest";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.enabled = is.read_bool()?;
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if self.enabled != false {
+            my_size += 1 + 1;
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if self.enabled != false {
+            os.write_bool(1, self.enabled)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> SetTracingRequest {
+        SetTracingRequest::new()
+    }
+
+    fn clear(&mut self) {
+        self.enabled = false;
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static SetTracingRequest {
+        static instance: SetTracingRequest = SetTracingRequest {
+            enabled: false,
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for SetTracingRequest {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("SetTracingRequest").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for SetTracingRequest {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for SetTracingRequest {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.frontend.GetTraceResponse)
+pub struct GetTraceResponse {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.frontend.GetTraceResponse.enabled)
+    pub enabled: bool,
+    // @@protoc_insertion_point(field:netsim.frontend.GetTraceResponse.trace_json)
+    pub trace_json: ::std::string::String,
+    // @@protoc_insertion_point(field:netsim.frontend.GetTraceResponse.dropped_events)
+    pub dropped_events: u64,
+    // @@protoc_insertion_point(field:netsim.frontend.GetTraceResponse.counters)
+    pub counters: ::std::vec::Vec<super::stats::NetsimTraceCounter>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.frontend.GetTraceResponse.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a GetTraceResponse {
+    fn default() -> &'a GetTraceResponse {
+        <GetTraceResponse as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl GetTraceResponse {
+    pub fn new() -> GetTraceResponse {
+        ::std::default::Default::default()
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(4);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "enabled",
+            |m: &GetTraceResponse| { &m.enabled },
+            |m: &mut GetTraceResponse| { &mut m.enabled },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "trace_json",
+            |m: &GetTraceResponse| { &m.trace_json },
+            |m: &mut GetTraceResponse| { &mut m.trace_json },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_simpler_field_accessor::<_, _>(
+            "dropped_events",
+            |m: &GetTraceResponse| { &m.dropped_events },
+            |m: &mut GetTraceResponse| { &mut m.dropped_events },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "counters",
+            |m: &GetTraceResponse| { &m.counters },
+            |m: &mut GetTraceResponse| { &mut m.counters },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<GetTraceResponse>(
+            "GetTraceResponse",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for GetTraceResponse {
+    const NAME: &'static str = "GetTraceResponse";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.enabled = is.read_bool()?;
+                },
+                18 => {
+                    self.trace_json = is.read_string()?;
+                },
+                24 => {
+                    self.dropped_events = is.read_uint64()?;
+                },
+                34 => {
+                    self.counters.push(is.read_message()?);
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if self.enabled != false {
+            my_size += 1 + 1;
+        }
+        if !self.trace_json.is_empty() {
+            my_size += ::protobuf::rt::string_size(2, &self.trace_json);
+        }
+        if self.dropped_events != 0 {
+            my_size += ::protobuf::rt::uint64_size(3, self.dropped_events);
+        }
+        for value in &self.counters {
+            let len = value.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        };
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if self.enabled != false {
+            os.write_bool(1, self.enabled)?;
+        }
+        if !self.trace_json.is_empty() {
+            os.write_string(2, &self.trace_json)?;
+        }
+        if self.dropped_events != 0 {
+            os.write_uint64(3, self.dropped_events)?;
+        }
+        for v in &self.counters {
+            ::protobuf::rt::write_message_field_with_cached_size(4, v, os)?;
+        };
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> GetTraceResponse {
+        GetTraceResponse::new()
+    }
+
+    fn clear(&mut self) {
+        self.enabled = false;
+        self.trace_json.clear();
+        self.dropped_events = 0;
+        self.counters.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static GetTraceResponse {
+        static instance: GetTraceResponse = GetTraceResponse {
+            enabled: false,
+            trace_json: ::std::string::String::new(),
+            dropped_events: 0,
+            counters: ::std::vec::Vec::new(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for GetTraceResponse {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("GetTraceResponse").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for GetTraceResponse {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for GetTraceResponse {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
 static file_descriptor_proto_data: &'static [u8] = b"\
     \n\x15netsim/frontend.proto\x12\x0fnetsim.frontend\x1a\x1bgoogle/protobu\
-    f/empty.proto\x1a\x12netsim/model.proto\"+\n\x0fVersionResponse\x12\x18\
-    \n\x07version\x18\x01\x20\x01(\tR\x07version\"I\n\x13CreateDeviceRequest\
-    \x122\n\x06device\x18\x01\x20\x01(\x0b2\x1a.netsim.model.DeviceCreateR\
-    \x06device\"D\n\x14CreateDeviceResponse\x12,\n\x06device\x18\x01\x20\x01\
-    (\x0b2\x14.netsim.model.DeviceR\x06device\"#\n\x11DeleteChipRequest\x12\
-    \x0e\n\x02id\x18\x02\x20\x01(\rR\x02id\"B\n\x12PatchDeviceRequest\x12,\n\
-    \x06device\x18\x02\x20\x01(\x0b2\x14.netsim.model.DeviceR\x06device\"D\n\
-    \x12ListDeviceResponse\x12.\n\x07devices\x18\x01\x20\x03(\x0b2\x14.netsi\
-    m.model.DeviceR\x07devices\"\xa9\x01\n\x13PatchCaptureRequest\x12\x0e\n\
-    \x02id\x18\x01\x20\x01(\rR\x02id\x12G\n\x05patch\x18\x02\x20\x01(\x0b21.\
-    netsim.frontend.PatchCaptureRequest.PatchCaptureR\x05patch\x1a9\n\x0cPat\
-    chCapture\x12)\n\x05state\x18\x01\x20\x01(\x0e2\x13.netsim.model.StateR\
-    \x05state\"H\n\x13ListCaptureResponse\x121\n\x08captures\x18\x01\x20\x03\
-    (\x0b2\x15.netsim.model.CaptureR\x08captures\"#\n\x11GetCaptureRequest\
-    \x12\x0e\n\x02id\x18\x01\x20\x01(\rR\x02id\";\n\x12GetCaptureResponse\
-    \x12%\n\x0ecapture_stream\x18\x01\x20\x01(\x0cR\rcaptureStream2\xc4\x05\
-    \n\x0fFrontendService\x12F\n\nGetVersion\x12\x16.google.protobuf.Empty\
-    \x1a\x20.netsim.frontend.VersionResponse\x12[\n\x0cCreateDevice\x12$.net\
-    sim.frontend.CreateDeviceRequest\x1a%.netsim.frontend.CreateDeviceRespon\
-    se\x12H\n\nDeleteChip\x12\".netsim.frontend.DeleteChipRequest\x1a\x16.go\
-    ogle.protobuf.Empty\x12J\n\x0bPatchDevice\x12#.netsim.frontend.PatchDevi\
-    ceRequest\x1a\x16.google.protobuf.Empty\x127\n\x05Reset\x12\x16.google.p\
-    rotobuf.Empty\x1a\x16.google.protobuf.Empty\x12I\n\nListDevice\x12\x16.g\
-    oogle.protobuf.Empty\x1a#.netsim.frontend.ListDeviceResponse\x12L\n\x0cP\
-    atchCapture\x12$.netsim.frontend.PatchCaptureRequest\x1a\x16.google.prot\
-    obuf.Empty\x12K\n\x0bListCapture\x12\x16.google.protobuf.Empty\x1a$.nets\
-    im.frontend.ListCaptureResponse\x12W\n\nGetCapture\x12\".netsim.frontend\
-    .GetCaptureRequest\x1a#.netsim.frontend.GetCaptureResponse0\x01b\x06prot\
-    o3\
+    f/empty.proto\x1a\x13netsim/common.proto\x1a\x12netsim/model.proto\x1a\
+    \x12netsim/stats.proto\"+\n\x0fVersionResponse\x12\x18\n\x07version\x18\
+    \x01\x20\x01(\tR\x07version\"I\n\x13CreateDeviceRequest\x122\n\x06device\
+    \x18\x01\x20\x01(\x0b2\x1a.netsim.model.DeviceCreateR\x06device\"D\n\x14\
+    CreateDeviceResponse\x12,\n\x06device\x18\x01\x20\x01(\x0b2\x14.netsim.m\
+    odel.DeviceR\x06device\"#\n\x11DeleteChipRequest\x12\x0e\n\x02id\x18\x02\
+    \x20\x01(\rR\x02id\"B\n\x12PatchDeviceRequest\x12,\n\x06device\x18\x02\
+    \x20\x01(\x0b2\x14.netsim.model.DeviceR\x06device\"T\n\x13PatchDevicesRe\
+    quest\x12=\n\x07patches\x18\x01\x20\x03(\x0b2#.netsim.frontend.PatchDevi\
+    ceRequestR\x07patches\"D\n\x12ListDeviceResponse\x12.\n\x07devices\x18\
+    \x01\x20\x03(\x0b2\x14.netsim.model.DeviceR\x07devices\"\xa9\x01\n\x13Pa\
+    tchCaptureRequest\x12\x0e\n\x02id\x18\x01\x20\x01(\rR\x02id\x12G\n\x05pa\
+    tch\x18\x02\x20\x01(\x0b21.netsim.frontend.PatchCaptureRequest.PatchCapt\
+    ureR\x05patch\x1a9\n\x0cPatchCapture\x12)\n\x05state\x18\x01\x20\x01(\
+    \x0e2\x13.netsim.model.StateR\x05state\"H\n\x13ListCaptureResponse\x121\
+    \n\x08captures\x18\x01\x20\x03(\x0b2\x15.netsim.model.CaptureR\x08captur\
+    es\";\n\x11GetCaptureRequest\x12\x0e\n\x02id\x18\x01\x20\x01(\rR\x02id\
+    \x12\x16\n\x06offset\x18\x02\x20\x01(\x04R\x06offset\";\n\x12GetCaptureR\
+    esponse\x12%\n\x0ecapture_stream\x18\x01\x20\x01(\x0cR\rcaptureStream\"5\
+    \n\x13WatchDevicesRequest\x12\x1e\n\x0bmax_rate_hz\x18\x01\x20\x01(\rR\t\
+    maxRateHz\"\x9e\x01\n\x14WatchDevicesResponse\x12.\n\x07devices\x18\x01\
+    \x20\x03(\x0b2\x14.netsim.model.DeviceR\x07devices\x12,\n\x12removed_dev\
+    ice_ids\x18\x02\x20\x03(\rR\x10removedDeviceIds\x12(\n\x10removed_chip_i\
+    ds\x18\x03\x20\x03(\rR\x0eremovedChipIds\"M\n\tByteMatch\x12\x16\n\x06of\
+    fset\x18\x01\x20\x01(\rR\x06offset\x12\x14\n\x05value\x18\x02\x20\x01(\
+    \x0cR\x05value\x12\x12\n\x04mask\x18\x03\x20\x01(\x0cR\x04mask\"\xcd\x01\
+    \n\rCaptureFilter\x12!\n\x0cpacket_types\x18\x01\x20\x03(\rR\x0bpacketTy\
+    pes\x12,\n\x12host_to_controller\x18\x02\x20\x01(\x08R\x10hostToControll\
+    er\x12,\n\x12controller_to_host\x18\x03\x20\x01(\x08R\x10controllerToHos\
+    t\x12=\n\x0cbyte_matches\x18\x04\x20\x03(\x0b2\x1a.netsim.frontend.ByteM\
+    atchR\x0bbyteMatches\"\\\n\x12TailCaptureRequest\x12\x0e\n\x02id\x18\x01\
+    \x20\x01(\rR\x02id\x126\n\x06filter\x18\x02\x20\x01(\x0b2\x1e.netsim.fro\
+    ntend.CaptureFilterR\x06filter\"d\n\x17GetLatencyStatsResponse\x12I\n\rl\
+    atency_stats\x18\x01\x20\x03(\x0b2$.netsim.stats.NetsimChipLatencyStatsR\
+    \x0clatencyStats\"\x9a\x01\n\x0cFlightRecord\x12!\n\x0ctimestamp_us\x18\
+    \x01\x20\x01(\x04R\x0btimestampUs\x12\x16\n\x06egress\x18\x02\x20\x01(\
+    \x08R\x06egress\x12\x1f\n\x0bpacket_type\x18\x03\x20\x01(\rR\npacketType\
+    \x12\x16\n\x06length\x18\x04\x20\x01(\rR\x06length\x12\x16\n\x06packet\
+    \x18\x05\x20\x01(\x0cR\x06packet\"\x9f\x01\n\x11ChipFlightRecords\x124\n\
+    \tchip_kind\x18\x01\x20\x01(\x0e2\x17.netsim.common.ChipKindR\x08chipKin\
+    d\x12\x1b\n\tfacade_id\x18\x02\x20\x01(\rR\x08facadeId\x127\n\x07records\
+    \x18\x03\x20\x03(\x0b2\x1d.netsim.frontend.FlightRecordR\x07records\"T\n\
+    \x18GetFlightRecordsResponse\x128\n\x05chips\x18\x01\x20\x03(\x0b2\".net\
+    sim.frontend.ChipFlightRecordsR\x05chips\"-\n\x11SetTracingRequest\x12\
+    \x18\n\x07enabled\x18\x01\x20\x01(\x08R\x07enabled\"\xb0\x01\n\x10GetTra\
+    ceResponse\x12\x18\n\x07enabled\x18\x01\x20\x01(\x08R\x07enabled\x12\x1d\
+    \n\ntrace_json\x18\x02\x20\x01(\tR\ttraceJson\x12%\n\x0edropped_events\
+    \x18\x03\x20\x01(\x04R\rdroppedEvents\x12<\n\x08counters\x18\x04\x20\x03\
+    (\x0b2\x20.netsim.stats.NetsimTraceCounterR\x08counters2\x89\n\n\x0fFron\
+    tendService\x12F\n\nGetVersion\x12\x16.google.protobuf.Empty\x1a\x20.net\
+    sim.frontend.VersionResponse\x12[\n\x0cCreateDevice\x12$.netsim.frontend\
+    .CreateDeviceRequest\x1a%.netsim.frontend.CreateDeviceResponse\x12H\n\nD\
+    eleteChip\x12\".netsim.frontend.DeleteChipRequest\x1a\x16.google.protobu\
+    f.Empty\x12J\n\x0bPatchDevice\x12#.netsim.frontend.PatchDeviceRequest\
+    \x1a\x16.google.protobuf.Empty\x12L\n\x0cPatchDevices\x12$.netsim.fronte\
+    nd.PatchDevicesRequest\x1a\x16.google.protobuf.Empty\x127\n\x05Reset\x12\
+    \x16.google.protobuf.Empty\x1a\x16.google.protobuf.Empty\x12I\n\nListDev\
+    ice\x12\x16.google.protobuf.Empty\x1a#.netsim.frontend.ListDeviceRespons\
+    e\x12L\n\x0cPatchCapture\x12$.netsim.frontend.PatchCaptureRequest\x1a\
+    \x16.google.protobuf.Empty\x12K\n\x0bListCapture\x12\x16.google.protobuf\
+    .Empty\x1a$.netsim.frontend.ListCaptureResponse\x12W\n\nGetCapture\x12\"\
+    .netsim.frontend.GetCaptureRequest\x1a#.netsim.frontend.GetCaptureRespon\
+    se0\x01\x12]\n\x0cWatchDevices\x12$.netsim.frontend.WatchDevicesRequest\
+    \x1a%.netsim.frontend.WatchDevicesResponse0\x01\x12Y\n\x0bTailCapture\
+    \x12#.netsim.frontend.TailCaptureRequest\x1a#.netsim.frontend.GetCapture\
+    Response0\x01\x12S\n\x0fGetLatencyStats\x12\x16.google.protobuf.Empty\
+    \x1a(.netsim.frontend.GetLatencyStatsResponse\x12U\n\x10GetFlightRecords\
+    \x12\x16.google.protobuf.Empty\x1a).netsim.frontend.GetFlightRecordsResp\
+    onse\x12H\n\nSetTracing\x12\".netsim.frontend.SetTracingRequest\x1a\x16.\
+    google.protobuf.Empty\x12E\n\x08GetTrace\x12\x16.google.protobuf.Empty\
+    \x1a!.netsim.frontend.GetTraceResponseb\x06proto3\
 ";
 
 /// `FileDescriptorProto` object which was a source for this generated file
@@ -1441,20 +3276,34 @@ pub fn file_descriptor() -> &'static ::protobuf::reflect::FileDescriptor {
     static file_descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::FileDescriptor> = ::protobuf::rt::Lazy::new();
     file_descriptor.get(|| {
         let generated_file_descriptor = generated_file_descriptor_lazy.get(|| {
-            let mut deps = ::std::vec::Vec::with_capacity(2);
+            let mut deps = ::std::vec::Vec::with_capacity(4);
             deps.push(::protobuf::well_known_types::empty::file_descriptor().clone());
+            deps.push(super::common::file_descriptor().clone());
             deps.push(super::model::file_descriptor().clone());
-            let mut messages = ::std::vec::Vec::with_capacity(11);
+            deps.push(super::stats::file_descriptor().clone());
+            let mut messages = ::std::vec::Vec::with_capacity(23);
             messages.push(VersionResponse::generated_message_descriptor_data());
             messages.push(CreateDeviceRequest::generated_message_descriptor_data());
             messages.push(CreateDeviceResponse::generated_message_descriptor_data());
             messages.push(DeleteChipRequest::generated_message_descriptor_data());
             messages.push(PatchDeviceRequest::generated_message_descriptor_data());
+            messages.push(PatchDevicesRequest::generated_message_descriptor_data());
             messages.push(ListDeviceResponse::generated_message_descriptor_data());
             messages.push(PatchCaptureRequest::generated_message_descriptor_data());
             messages.push(ListCaptureResponse::generated_message_descriptor_data());
             messages.push(GetCaptureRequest::generated_message_descriptor_data());
             messages.push(GetCaptureResponse::generated_message_descriptor_data());
+            messages.push(WatchDevicesRequest::generated_message_descriptor_data());
+            messages.push(WatchDevicesResponse::generated_message_descriptor_data());
+            messages.push(ByteMatch::generated_message_descriptor_data());
+            messages.push(CaptureFilter::generated_message_descriptor_data());
+            messages.push(TailCaptureRequest::generated_message_descriptor_data());
+            messages.push(GetLatencyStatsResponse::generated_message_descriptor_data());
+            messages.push(FlightRecord::generated_message_descriptor_data());
+            messages.push(ChipFlightRecords::generated_message_descriptor_data());
+            messages.push(GetFlightRecordsResponse::generated_message_descriptor_data());
+            messages.push(SetTracingRequest::generated_message_descriptor_data());
+            messages.push(GetTraceResponse::generated_message_descriptor_data());
             messages.push(patch_capture_request::PatchCapture::generated_message_descriptor_data());
             let mut enums = ::std::vec::Vec::with_capacity(0);
             ::protobuf::reflect::GeneratedFileDescriptor::new_generated(
@@ -468,6 +468,1051 @@ pub mod netsim_radio_stats {
     }
 }
 
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.stats.NetsimLatencyStats)
+pub struct NetsimLatencyStats {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.stats.NetsimLatencyStats.count)
+    pub count: ::std::option::Option<u64>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimLatencyStats.p50_us)
+    pub p50_us: ::std::option::Option<u64>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimLatencyStats.p99_us)
+    pub p99_us: ::std::option::Option<u64>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimLatencyStats.p999_us)
+    pub p999_us: ::std::option::Option<u64>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimLatencyStats.max_us)
+    pub max_us: ::std::option::Option<u64>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.stats.NetsimLatencyStats.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a NetsimLatencyStats {
+    fn default() -> &'a NetsimLatencyStats {
+        <NetsimLatencyStats as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl NetsimLatencyStats {
+    pub fn new() -> NetsimLatencyStats {
+        ::std::default::Default::default()
+    }
+
+    // optional uint64 count = 1;
+
+    pub fn count(&self) -> u64 {
+        self.count.unwrap_or(0)
+    }
+
+    pub fn clear_count(&mut self) {
+        self.count = ::std::option::Option::None;
+    }
+
+    pub fn has_count(&self) -> bool {
+        self.count.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_count(&mut self, v: u64) {
+        self.count = ::std::option::Option::Some(v);
+    }
+
+    // optional uint64 p50_us = 2;
+
+    pub fn p50_us(&self) -> u64 {
+        self.p50_us.unwrap_or(0)
+    }
+
+    pub fn clear_p50_us(&mut self) {
+        self.p50_us = ::std::option::Option::None;
+    }
+
+    pub fn has_p50_us(&self) -> bool {
+        self.p50_us.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_p50_us(&mut self, v: u64) {
+        self.p50_us = ::std::option::Option::Some(v);
+    }
+
+    // optional uint64 p99_us = 3;
+
+    pub fn p99_us(&self) -> u64 {
+        self.p99_us.unwrap_or(0)
+    }
+
+    pub fn clear_p99_us(&mut self) {
+        self.p99_us = ::std::option::Option::None;
+    }
+
+    pub fn has_p99_us(&self) -> bool {
+        self.p99_us.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_p99_us(&mut self, v: u64) {
+        self.p99_us = ::std::option::Option::Some(v);
+    }
+
+    // optional uint64 p999_us = 4;
+
+    pub fn p999_us(&self) -> u64 {
+        self.p999_us.unwrap_or(0)
+    }
+
+    pub fn clear_p999_us(&mut self) {
+        self.p999_us = ::std::option::Option::None;
+    }
+
+    pub fn has_p999_us(&self) -> bool {
+        self.p999_us.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_p999_us(&mut self, v: u64) {
+        self.p999_us = ::std::option::Option::Some(v);
+    }
+
+    // optional uint64 max_us = 5;
+
+    pub fn max_us(&self) -> u64 {
+        self.max_us.unwrap_or(0)
+    }
+
+    pub fn clear_max_us(&mut self) {
+        self.max_us = ::std::option::Option::None;
+    }
+
+    pub fn has_max_us(&self) -> bool {
+        self.max_us.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_max_us(&mut self, v: u64) {
+        self.max_us = ::std::option::Option::Some(v);
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(5);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "count",
+            |m: &NetsimLatencyStats| { &m.count },
+            |m: &mut NetsimLatencyStats| { &mut m.count },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "p50_us",
+            |m: &NetsimLatencyStats| { &m.p50_us },
+            |m: &mut NetsimLatencyStats| { &mut m.p50_us },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "p99_us",
+            |m: &NetsimLatencyStats| { &m.p99_us },
+            |m: &mut NetsimLatencyStats| { &mut m.p99_us },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "p999_us",
+            |m: &NetsimLatencyStats| { &m.p999_us },
+            |m: &mut NetsimLatencyStats| { &mut m.p999_us },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "max_us",
+            |m: &NetsimLatencyStats| { &m.max_us },
+            |m: &mut NetsimLatencyStats| { &mut m.max_us },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<NetsimLatencyStats>(
+            "NetsimLatencyStats",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for NetsimLatencyStats {
+    const NAME: &'static str = "NetsimLatencyStats";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.count = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                16 => {
+                    self.p50_us = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                24 => {
+                    self.p99_us = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                32 => {
+                    self.p999_us = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                40 => {
+                    self.max_us = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if let Some(v) = self.count {
+            my_size += ::protobuf::rt::uint64_size(1, v);
+        }
+        if let Some(v) = self.p50_us {
+            my_size += ::protobuf::rt::uint64_size(2, v);
+        }
+        if let Some(v) = self.p99_us {
+            my_size += ::protobuf::rt::uint64_size(3, v);
+        }
+        if let Some(v) = self.p999_us {
+            my_size += ::protobuf::rt::uint64_size(4, v);
+        }
+        if let Some(v) = self.max_us {
+            my_size += ::protobuf::rt::uint64_size(5, v);
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if let Some(v) = self.count {
+            os.write_uint64(1, v)?;
+        }
+        if let Some(v) = self.p50_us {
+            os.write_uint64(2, v)?;
+        }
+        if let Some(v) = self.p99_us {
+            os.write_uint64(3, v)?;
+        }
+        if let Some(v) = self.p999_us {
+            os.write_uint64(4, v)?;
+        }
+        if let Some(v) = self.max_us {
+            os.write_uint64(5, v)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> NetsimLatencyStats {
+        NetsimLatencyStats::new()
+    }
+
+    fn clear(&mut self) {
+        self.count = ::std::option::Option::None;
+        self.p50_us = ::std::option::Option::None;
+        self.p99_us = ::std::option::Option::None;
+        self.p999_us = ::std::option::Option::None;
+        self.max_us = ::std::option::Option::None;
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static NetsimLatencyStats {
+        static instance: NetsimLatencyStats = NetsimLatencyStats {
+            count: ::std::option::Option::None,
+            p50_us: ::std::option::Option::None,
+            p99_us: ::std::option::Option::None,
+            p999_us: ::std::option::Option::None,
+            max_us: ::std::option::Option::None,
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for NetsimLatencyStats {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("NetsimLatencyStats").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for NetsimLatencyStats {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for NetsimLatencyStats {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.stats.NetsimChipLatencyStats)
+pub struct NetsimChipLatencyStats {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.stats.NetsimChipLatencyStats.facade_id)
+    pub facade_id: ::std::option::Option<u32>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimChipLatencyStats.ingress_to_rootcanal)
+    pub ingress_to_rootcanal: ::protobuf::MessageField<NetsimLatencyStats>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimChipLatencyStats.queue_wait)
+    pub queue_wait: ::protobuf::MessageField<NetsimLatencyStats>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimChipLatencyStats.rootcanal_to_egress)
+    pub rootcanal_to_egress: ::protobuf::MessageField<NetsimLatencyStats>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.stats.NetsimChipLatencyStats.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a NetsimChipLatencyStats {
+    fn default() -> &'a NetsimChipLatencyStats {
+        <NetsimChipLatencyStats as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl NetsimChipLatencyStats {
+    pub fn new() -> NetsimChipLatencyStats {
+        ::std::default::Default::default()
+    }
+
+    // optional uint32 facade_id = 1;
+
+    pub fn facade_id(&self) -> u32 {
+        self.facade_id.unwrap_or(0)
+    }
+
+    pub fn clear_facade_id(&mut self) {
+        self.facade_id = ::std::option::Option::None;
+    }
+
+    pub fn has_facade_id(&self) -> bool {
+        self.facade_id.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_facade_id(&mut self, v: u32) {
+        self.facade_id = ::std::option::Option::Some(v);
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(4);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "facade_id",
+            |m: &NetsimChipLatencyStats| { &m.facade_id },
+            |m: &mut NetsimChipLatencyStats| { &mut m.facade_id },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_message_field_accessor::<_, NetsimLatencyStats>(
+            "ingress_to_rootcanal",
+            |m: &NetsimChipLatencyStats| { &m.ingress_to_rootcanal },
+            |m: &mut NetsimChipLatencyStats| { &mut m.ingress_to_rootcanal },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_message_field_accessor::<_, NetsimLatencyStats>(
+            "queue_wait",
+            |m: &NetsimChipLatencyStats| { &m.queue_wait },
+            |m: &mut NetsimChipLatencyStats| { &mut m.queue_wait },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_message_field_accessor::<_, NetsimLatencyStats>(
+            "rootcanal_to_egress",
+            |m: &NetsimChipLatencyStats| { &m.rootcanal_to_egress },
+            |m: &mut NetsimChipLatencyStats| { &mut m.rootcanal_to_egress },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<NetsimChipLatencyStats>(
+            "NetsimChipLatencyStats",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for NetsimChipLatencyStats {
+    const NAME: &'static str = "NetsimChipLatencyStats";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.facade_id = ::std::option::Option::Some(is.read_uint32()?);
+                },
+                18 => {
+                    ::protobuf::rt::read_singular_message_into_field(is, &mut self.ingress_to_rootcanal)?;
+                },
+                26 => {
+                    ::protobuf::rt::read_singular_message_into_field(is, &mut self.queue_wait)?;
+                },
+                34 => {
+                    ::protobuf::rt::read_singular_message_into_field(is, &mut self.rootcanal_to_egress)?;
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if let Some(v) = self.facade_id {
+            my_size += ::protobuf::rt::uint32_size(1, v);
+        }
+        if let Some(v) = self.ingress_to_rootcanal.as_ref() {
+            let len = v.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        }
+        if let Some(v) = self.queue_wait.as_ref() {
+            let len = v.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        }
+        if let Some(v) = self.rootcanal_to_egress.as_ref() {
+            let len = v.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if let Some(v) = self.facade_id {
+            os.write_uint32(1, v)?;
+        }
+        if let Some(v) = self.ingress_to_rootcanal.as_ref() {
+            ::protobuf::rt::write_message_field_with_cached_size(2, v, os)?;
+        }
+        if let Some(v) = self.queue_wait.as_ref() {
+            ::protobuf::rt::write_message_field_with_cached_size(3, v, os)?;
+        }
+        if let Some(v) = self.rootcanal_to_egress.as_ref() {
+            ::protobuf::rt::write_message_field_with_cached_size(4, v, os)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> NetsimChipLatencyStats {
+        NetsimChipLatencyStats::new()
+    }
+
+    fn clear(&mut self) {
+        self.facade_id = ::std::option::Option::None;
+        self.ingress_to_rootcanal.clear();
+        self.queue_wait.clear();
+        self.rootcanal_to_egress.clear();
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static NetsimChipLatencyStats {
+        static instance: NetsimChipLatencyStats = NetsimChipLatencyStats {
+            facade_id: ::std::option::Option::None,
+            ingress_to_rootcanal: ::protobuf::MessageField::none(),
+            queue_wait: ::protobuf::MessageField::none(),
+            rootcanal_to_egress: ::protobuf::MessageField::none(),
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for NetsimChipLatencyStats {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("NetsimChipLatencyStats").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for NetsimChipLatencyStats {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for NetsimChipLatencyStats {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.stats.NetsimPacketPoolStats)
+pub struct NetsimPacketPoolStats {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.stats.NetsimPacketPoolStats.acquired)
+    pub acquired: ::std::option::Option<u64>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimPacketPoolStats.reused)
+    pub reused: ::std::option::Option<u64>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimPacketPoolStats.oversize)
+    pub oversize: ::std::option::Option<u64>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimPacketPoolStats.dropped)
+    pub dropped: ::std::option::Option<u64>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimPacketPoolStats.pooled)
+    pub pooled: ::std::option::Option<u64>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.stats.NetsimPacketPoolStats.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a NetsimPacketPoolStats {
+    fn default() -> &'a NetsimPacketPoolStats {
+        <NetsimPacketPoolStats as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl NetsimPacketPoolStats {
+    pub fn new() -> NetsimPacketPoolStats {
+        ::std::default::Default::default()
+    }
+
+    // optional uint64 acquired = 1;
+
+    pub fn acquired(&self) -> u64 {
+        self.acquired.unwrap_or(0)
+    }
+
+    pub fn clear_acquired(&mut self) {
+        self.acquired = ::std::option::Option::None;
+    }
+
+    pub fn has_acquired(&self) -> bool {
+        self.acquired.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_acquired(&mut self, v: u64) {
+        self.acquired = ::std::option::Option::Some(v);
+    }
+
+    // optional uint64 reused = 2;
+
+    pub fn reused(&self) -> u64 {
+        self.reused.unwrap_or(0)
+    }
+
+    pub fn clear_reused(&mut self) {
+        self.reused = ::std::option::Option::None;
+    }
+
+    pub fn has_reused(&self) -> bool {
+        self.reused.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_reused(&mut self, v: u64) {
+        self.reused = ::std::option::Option::Some(v);
+    }
+
+    // optional uint64 oversize = 3;
+
+    pub fn oversize(&self) -> u64 {
+        self.oversize.unwrap_or(0)
+    }
+
+    pub fn clear_oversize(&mut self) {
+        self.oversize = ::std::option::Option::None;
+    }
+
+    pub fn has_oversize(&self) -> bool {
+        self.oversize.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_oversize(&mut self, v: u64) {
+        self.oversize = ::std::option::Option::Some(v);
+    }
+
+    // optional uint64 dropped = 4;
+
+    pub fn dropped(&self) -> u64 {
+        self.dropped.unwrap_or(0)
+    }
+
+    pub fn clear_dropped(&mut self) {
+        self.dropped = ::std::option::Option::None;
+    }
+
+    pub fn has_dropped(&self) -> bool {
+        self.dropped.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_dropped(&mut self, v: u64) {
+        self.dropped = ::std::option::Option::Some(v);
+    }
+
+    // optional uint64 pooled = 5;
+
+    pub fn pooled(&self) -> u64 {
+        self.pooled.unwrap_or(0)
+    }
+
+    pub fn clear_pooled(&mut self) {
+        self.pooled = ::std::option::Option::None;
+    }
+
+    pub fn has_pooled(&self) -> bool {
+        self.pooled.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_pooled(&mut self, v: u64) {
+        self.pooled = ::std::option::Option::Some(v);
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(5);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "acquired",
+            |m: &NetsimPacketPoolStats| { &m.acquired },
+            |m: &mut NetsimPacketPoolStats| { &mut m.acquired },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "reused",
+            |m: &NetsimPacketPoolStats| { &m.reused },
+            |m: &mut NetsimPacketPoolStats| { &mut m.reused },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "oversize",
+            |m: &NetsimPacketPoolStats| { &m.oversize },
+            |m: &mut NetsimPacketPoolStats| { &mut m.oversize },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "dropped",
+            |m: &NetsimPacketPoolStats| { &m.dropped },
+            |m: &mut NetsimPacketPoolStats| { &mut m.dropped },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "pooled",
+            |m: &NetsimPacketPoolStats| { &m.pooled },
+            |m: &mut NetsimPacketPoolStats| { &mut m.pooled },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<NetsimPacketPoolStats>(
+            "NetsimPacketPoolStats",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for NetsimPacketPoolStats {
+    const NAME: &'static str = "NetsimPacketPoolStats";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                8 => {
+                    self.acquired = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                16 => {
+                    self.reused = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                24 => {
+                    self.oversize = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                32 => {
+                    self.dropped = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                40 => {
+                    self.pooled = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if let Some(v) = self.acquired {
+            my_size += ::protobuf::rt::uint64_size(1, v);
+        }
+        if let Some(v) = self.reused {
+            my_size += ::protobuf::rt::uint64_size(2, v);
+        }
+        if let Some(v) = self.oversize {
+            my_size += ::protobuf::rt::uint64_size(3, v);
+        }
+        if let Some(v) = self.dropped {
+            my_size += ::protobuf::rt::uint64_size(4, v);
+        }
+        if let Some(v) = self.pooled {
+            my_size += ::protobuf::rt::uint64_size(5, v);
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if let Some(v) = self.acquired {
+            os.write_uint64(1, v)?;
+        }
+        if let Some(v) = self.reused {
+            os.write_uint64(2, v)?;
+        }
+        if let Some(v) = self.oversize {
+            os.write_uint64(3, v)?;
+        }
+        if let Some(v) = self.dropped {
+            os.write_uint64(4, v)?;
+        }
+        if let Some(v) = self.pooled {
+            os.write_uint64(5, v)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> NetsimPacketPoolStats {
+        NetsimPacketPoolStats::new()
+    }
+
+    fn clear(&mut self) {
+        self.acquired = ::std::option::Option::None;
+        self.reused = ::std::option::Option::None;
+        self.oversize = ::std::option::Option::None;
+        self.dropped = ::std::option::Option::None;
+        self.pooled = ::std::option::Option::None;
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static NetsimPacketPoolStats {
+        static instance: NetsimPacketPoolStats = NetsimPacketPoolStats {
+            acquired: ::std::option::Option::None,
+            reused: ::std::option::Option::None,
+            oversize: ::std::option::Option::None,
+            dropped: ::std::option::Option::None,
+            pooled: ::std::option::Option::None,
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for NetsimPacketPoolStats {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("NetsimPacketPoolStats").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for NetsimPacketPoolStats {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for NetsimPacketPoolStats {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
+#[derive(PartialEq,Clone,Default,Debug)]
+// @@protoc_insertion_point(message:netsim.stats.NetsimTraceCounter)
+pub struct NetsimTraceCounter {
+    // message fields
+    // @@protoc_insertion_point(field:netsim.stats.NetsimTraceCounter.name)
+    pub name: ::std::option::Option<::std::string::String>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimTraceCounter.count)
+    pub count: ::std::option::Option<u64>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimTraceCounter.total)
+    pub total: ::std::option::Option<u64>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimTraceCounter.max)
+    pub max: ::std::option::Option<u64>,
+    // special fields
+    // @@protoc_insertion_point(special_field:netsim.stats.NetsimTraceCounter.special_fields)
+    pub special_fields: ::protobuf::SpecialFields,
+}
+
+impl<'a> ::std::default::Default for &'a NetsimTraceCounter {
+    fn default() -> &'a NetsimTraceCounter {
+        <NetsimTraceCounter as ::protobuf::Message>::default_instance()
+    }
+}
+
+impl NetsimTraceCounter {
+    pub fn new() -> NetsimTraceCounter {
+        ::std::default::Default::default()
+    }
+
+    // optional string name = 1;
+
+    pub fn name(&self) -> &str {
+        match self.name.as_ref() {
+            Some(v) => v,
+            None => "",
+        }
+    }
+
+    pub fn clear_name(&mut self) {
+        self.name = ::std::option::Option::None;
+    }
+
+    pub fn has_name(&self) -> bool {
+        self.name.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_name(&mut self, v: ::std::string::String) {
+        self.name = ::std::option::Option::Some(v);
+    }
+
+    // Mutable pointer to the field.
+    // If field is not initialized, it is initialized with default value first.
+    pub fn mut_name(&mut self) -> &mut ::std::string::String {
+        if self.name.is_none() {
+            self.name = ::std::option::Option::Some(::std::string::String::new());
+        }
+        self.name.as_mut().unwrap()
+    }
+
+    // Take field
+    pub fn take_name(&mut self) -> ::std::string::String {
+        self.name.take().unwrap_or_else(|| ::std::string::String::new())
+    }
+
+    // optional uint64 count = 2;
+
+    pub fn count(&self) -> u64 {
+        self.count.unwrap_or(0)
+    }
+
+    pub fn clear_count(&mut self) {
+        self.count = ::std::option::Option::None;
+    }
+
+    pub fn has_count(&self) -> bool {
+        self.count.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_count(&mut self, v: u64) {
+        self.count = ::std::option::Option::Some(v);
+    }
+
+    // optional uint64 total = 3;
+
+    pub fn total(&self) -> u64 {
+        self.total.unwrap_or(0)
+    }
+
+    pub fn clear_total(&mut self) {
+        self.total = ::std::option::Option::None;
+    }
+
+    pub fn has_total(&self) -> bool {
+        self.total.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_total(&mut self, v: u64) {
+        self.total = ::std::option::Option::Some(v);
+    }
+
+    // optional uint64 max = 4;
+
+    pub fn max(&self) -> u64 {
+        self.max.unwrap_or(0)
+    }
+
+    pub fn clear_max(&mut self) {
+        self.max = ::std::option::Option::None;
+    }
+
+    pub fn has_max(&self) -> bool {
+        self.max.is_some()
+    }
+
+    // Param is passed by value, moved
+    pub fn set_max(&mut self, v: u64) {
+        self.max = ::std::option::Option::Some(v);
+    }
+
+    fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
+        let mut fields = ::std::vec::Vec::with_capacity(4);
+        let mut oneofs = ::std::vec::Vec::with_capacity(0);
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "name",
+            |m: &NetsimTraceCounter| { &m.name },
+            |m: &mut NetsimTraceCounter| { &mut m.name },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "count",
+            |m: &NetsimTraceCounter| { &m.count },
+            |m: &mut NetsimTraceCounter| { &mut m.count },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "total",
+            |m: &NetsimTraceCounter| { &m.total },
+            |m: &mut NetsimTraceCounter| { &mut m.total },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
+            "max",
+            |m: &NetsimTraceCounter| { &m.max },
+            |m: &mut NetsimTraceCounter| { &mut m.max },
+        ));
+        ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<NetsimTraceCounter>(
+            "NetsimTraceCounter",
+            fields,
+            oneofs,
+        )
+    }
+}
+
+impl ::protobuf::Message for NetsimTraceCounter {
+    const NAME: &'static str = "NetsimTraceCounter";
+
+    fn is_initialized(&self) -> bool {
+        true
+    }
+
+    fn merge_from(&mut self, is: &mut ::protobuf::CodedInputStream<'_>) -> ::protobuf::Result<()> {
+        while let Some(tag) = is.read_raw_tag_or_eof()? {
+            match tag {
+                10 => {
+                    self.name = ::std::option::Option::Some(is.read_string()?);
+                },
+                16 => {
+                    self.count = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                24 => {
+                    self.total = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                32 => {
+                    self.max = ::std::option::Option::Some(is.read_uint64()?);
+                },
+                tag => {
+                    ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
+                },
+            };
+        }
+        ::std::result::Result::Ok(())
+    }
+
+    // Compute sizes of nested messages
+    #[allow(unused_variables)]
+    fn compute_size(&self) -> u64 {
+        let mut my_size = 0;
+        if let Some(v) = self.name.as_ref() {
+            my_size += ::protobuf::rt::string_size(1, &v);
+        }
+        if let Some(v) = self.count {
+            my_size += ::protobuf::rt::uint64_size(2, v);
+        }
+        if let Some(v) = self.total {
+            my_size += ::protobuf::rt::uint64_size(3, v);
+        }
+        if let Some(v) = self.max {
+            my_size += ::protobuf::rt::uint64_size(4, v);
+        }
+        my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
+        self.special_fields.cached_size().set(my_size as u32);
+        my_size
+    }
+
+    fn write_to_with_cached_sizes(&self, os: &mut ::protobuf::CodedOutputStream<'_>) -> ::protobuf::Result<()> {
+        if let Some(v) = self.name.as_ref() {
+            os.write_string(1, v)?;
+        }
+        if let Some(v) = self.count {
+            os.write_uint64(2, v)?;
+        }
+        if let Some(v) = self.total {
+            os.write_uint64(3, v)?;
+        }
+        if let Some(v) = self.max {
+            os.write_uint64(4, v)?;
+        }
+        os.write_unknown_fields(self.special_fields.unknown_fields())?;
+        ::std::result::Result::Ok(())
+    }
+
+    fn special_fields(&self) -> &::protobuf::SpecialFields {
+        &self.special_fields
+    }
+
+    fn mut_special_fields(&mut self) -> &mut ::protobuf::SpecialFields {
+        &mut self.special_fields
+    }
+
+    fn new() -> NetsimTraceCounter {
+        NetsimTraceCounter::new()
+    }
+
+    fn clear(&mut self) {
+        self.name = ::std::option::Option::None;
+        self.count = ::std::option::Option::None;
+        self.total = ::std::option::Option::None;
+        self.max = ::std::option::Option::None;
+        self.special_fields.clear();
+    }
+
+    fn default_instance() -> &'static NetsimTraceCounter {
+        static instance: NetsimTraceCounter = NetsimTraceCounter {
+            name: ::std::option::Option::None,
+            count: ::std::option::Option::None,
+            total: ::std::option::Option::None,
+            max: ::std::option::Option::None,
+            special_fields: ::protobuf::SpecialFields::new(),
+        };
+        &instance
+    }
+}
+
+impl ::protobuf::MessageFull for NetsimTraceCounter {
+    fn descriptor() -> ::protobuf::reflect::MessageDescriptor {
+        static descriptor: ::protobuf::rt::Lazy<::protobuf::reflect::MessageDescriptor> = ::protobuf::rt::Lazy::new();
+        descriptor.get(|| file_descriptor().message_by_package_relative_name("NetsimTraceCounter").unwrap()).clone()
+    }
+}
+
+impl ::std::fmt::Display for NetsimTraceCounter {
+    fn fmt(&self, f: &mut ::std::fmt::Formatter<'_>) -> ::std::fmt::Result {
+        ::protobuf::text_format::fmt(self, f)
+    }
+}
+
+impl ::protobuf::reflect::ProtobufValue for NetsimTraceCounter {
+    type RuntimeType = ::protobuf::reflect::rt::RuntimeTypeMessage<Self>;
+}
+
 #[derive(PartialEq,Clone,Default,Debug)]
 // @@protoc_insertion_point(message:netsim.stats.NetsimStats)
 pub struct NetsimStats {
@@ -480,6 +1525,12 @@ pub struct NetsimStats {
     pub peak_concurrent_devices: ::std::option::Option<i32>,
     // @@protoc_insertion_point(field:netsim.stats.NetsimStats.radio_stats)
     pub radio_stats: ::std::vec::Vec<NetsimRadioStats>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimStats.latency_stats)
+    pub latency_stats: ::std::vec::Vec<NetsimChipLatencyStats>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimStats.packet_pool_stats)
+    pub packet_pool_stats: ::protobuf::MessageField<NetsimPacketPoolStats>,
+    // @@protoc_insertion_point(field:netsim.stats.NetsimStats.trace_counters)
+    pub trace_counters: ::std::vec::Vec<NetsimTraceCounter>,
     // special fields
     // @@protoc_insertion_point(special_field:netsim.stats.NetsimStats.special_fields)
     pub special_fields: ::protobuf::SpecialFields,
@@ -554,7 +1605,7 @@ impl NetsimStats {
     }
 
     fn generated_message_descriptor_data() -> ::protobuf::reflect::GeneratedMessageDescriptorData {
-        let mut fields = ::std::vec::Vec::with_capacity(4);
+        let mut fields = ::std::vec::Vec::with_capacity(7);
         let mut oneofs = ::std::vec::Vec::with_capacity(0);
         fields.push(::protobuf::reflect::rt::v2::make_option_accessor::<_, _>(
             "duration_secs",
@@ -576,6 +1627,21 @@ impl NetsimStats {
             |m: &NetsimStats| { &m.radio_stats },
             |m: &mut NetsimStats| { &mut m.radio_stats },
         ));
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "latency_stats",
+            |m: &NetsimStats| { &m.latency_stats },
+            |m: &mut NetsimStats| { &mut m.latency_stats },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_message_field_accessor::<_, NetsimPacketPoolStats>(
+            "packet_pool_stats",
+            |m: &NetsimStats| { &m.packet_pool_stats },
+            |m: &mut NetsimStats| { &mut m.packet_pool_stats },
+        ));
+        fields.push(::protobuf::reflect::rt::v2::make_vec_simpler_accessor::<_, _>(
+            "trace_counters",
+            |m: &NetsimStats| { &m.trace_counters },
+            |m: &mut NetsimStats| { &mut m.trace_counters },
+        ));
         ::protobuf::reflect::GeneratedMessageDescriptorData::new_2::<NetsimStats>(
             "NetsimStats",
             fields,
@@ -606,6 +1672,15 @@ impl ::protobuf::Message for NetsimStats {
                 34 => {
                     self.radio_stats.push(is.read_message()?);
                 },
+                42 => {
+                    self.latency_stats.push(is.read_message()?);
+                },
+                50 => {
+                    ::protobuf::rt::read_singular_message_into_field(is, &mut self.packet_pool_stats)?;
+                },
+                58 => {
+                    self.trace_counters.push(is.read_message()?);
+                },
                 tag => {
                     ::protobuf::rt::read_unknown_or_skip_group(tag, is, self.special_fields.mut_unknown_fields())?;
                 },
@@ -631,6 +1706,18 @@ impl ::protobuf::Message for NetsimStats {
             let len = value.compute_size();
             my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
         };
+        for value in &self.latency_stats {
+            let len = value.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        };
+        if let Some(v) = self.packet_pool_stats.as_ref() {
+            let len = v.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        }
+        for value in &self.trace_counters {
+            let len = value.compute_size();
+            my_size += 1 + ::protobuf::rt::compute_raw_varint64_size(len) + len;
+        };
         my_size += ::protobuf::rt::unknown_fields_size(self.special_fields.unknown_fields());
         self.special_fields.cached_size().set(my_size as u32);
         my_size
@@ -649,6 +1736,15 @@ impl ::protobuf::Message for NetsimStats {
         for v in &self.radio_stats {
             ::protobuf::rt::write_message_field_with_cached_size(4, v, os)?;
         };
+        for v in &self.latency_stats {
+            ::protobuf::rt::write_message_field_with_cached_size(5, v, os)?;
+        };
+        if let Some(v) = self.packet_pool_stats.as_ref() {
+            ::protobuf::rt::write_message_field_with_cached_size(6, v, os)?;
+        }
+        for v in &self.trace_counters {
+            ::protobuf::rt::write_message_field_with_cached_size(7, v, os)?;
+        };
         os.write_unknown_fields(self.special_fields.unknown_fields())?;
         ::std::result::Result::Ok(())
     }
@@ -670,6 +1766,9 @@ impl ::protobuf::Message for NetsimStats {
         self.device_count = ::std::option::Option::None;
         self.peak_concurrent_devices = ::std::option::Option::None;
         self.radio_stats.clear();
+        self.latency_stats.clear();
+        self.packet_pool_stats.clear();
+        self.trace_counters.clear();
         self.special_fields.clear();
     }
 
@@ -679,6 +1778,9 @@ impl ::protobuf::Message for NetsimStats {
             device_count: ::std::option::Option::None,
             peak_concurrent_devices: ::std::option::Option::None,
             radio_stats: ::std::vec::Vec::new(),
+            latency_stats: ::std::vec::Vec::new(),
+            packet_pool_stats: ::protobuf::MessageField::none(),
+            trace_counters: ::std::vec::Vec::new(),
             special_fields: ::protobuf::SpecialFields::new(),
         };
         &instance
@@ -712,12 +1814,33 @@ static file_descriptor_proto_data: &'static [u8] = b"\
     ytes\x12\x19\n\x08rx_bytes\x18\x07\x20\x01(\x05R\x07rxBytes\"`\n\x04Kind\
     \x12\x0f\n\x0bUNSPECIFIED\x10\0\x12\t\n\x05BT_LE\x10\x01\x12\x0e\n\nBT_C\
     LASSIC\x10\x02\x12\x10\n\x0cBT_LE_BEACON\x10\x03\x12\x08\n\x04WIFI\x10\
-    \x04\x12\x07\n\x03UWB\x10\x05\x12\x07\n\x03NFC\x10\x06\"\xce\x01\n\x0bNe\
-    tsimStats\x12#\n\rduration_secs\x18\x01\x20\x01(\x04R\x0cdurationSecs\
-    \x12!\n\x0cdevice_count\x18\x02\x20\x01(\x05R\x0bdeviceCount\x126\n\x17p\
-    eak_concurrent_devices\x18\x03\x20\x01(\x05R\x15peakConcurrentDevices\
-    \x12?\n\x0bradio_stats\x18\x04\x20\x03(\x0b2\x1e.netsim.stats.NetsimRadi\
-    oStatsR\nradioStats\
+    \x04\x12\x07\n\x03UWB\x10\x05\x12\x07\n\x03NFC\x10\x06\"\x88\x01\n\x12Ne\
+    tsimLatencyStats\x12\x14\n\x05count\x18\x01\x20\x01(\x04R\x05count\x12\
+    \x15\n\x06p50_us\x18\x02\x20\x01(\x04R\x05p50Us\x12\x15\n\x06p99_us\x18\
+    \x03\x20\x01(\x04R\x05p99Us\x12\x17\n\x07p999_us\x18\x04\x20\x01(\x04R\
+    \x06p999Us\x12\x15\n\x06max_us\x18\x05\x20\x01(\x04R\x05maxUs\"\x9c\x02\
+    \n\x16NetsimChipLatencyStats\x12\x1b\n\tfacade_id\x18\x01\x20\x01(\rR\
+    \x08facadeId\x12R\n\x14ingress_to_rootcanal\x18\x02\x20\x01(\x0b2\x20.ne\
+    tsim.stats.NetsimLatencyStatsR\x12ingressToRootcanal\x12?\n\nqueue_wait\
+    \x18\x03\x20\x01(\x0b2\x20.netsim.stats.NetsimLatencyStatsR\tqueueWait\
+    \x12P\n\x13rootcanal_to_egress\x18\x04\x20\x01(\x0b2\x20.netsim.stats.Ne\
+    tsimLatencyStatsR\x11rootcanalToEgress\"\x99\x01\n\x15NetsimPacketPoolSt\
+    ats\x12\x1a\n\x08acquired\x18\x01\x20\x01(\x04R\x08acquired\x12\x16\n\
+    \x06reused\x18\x02\x20\x01(\x04R\x06reused\x12\x1a\n\x08oversize\x18\x03\
+    \x20\x01(\x04R\x08oversize\x12\x18\n\x07dropped\x18\x04\x20\x01(\x04R\
+    \x07dropped\x12\x16\n\x06pooled\x18\x05\x20\x01(\x04R\x06pooled\"f\n\x12\
+    NetsimTraceCounter\x12\x12\n\x04name\x18\x01\x20\x01(\tR\x04name\x12\x14\
+    \n\x05count\x18\x02\x20\x01(\x04R\x05count\x12\x14\n\x05total\x18\x03\
+    \x20\x01(\x04R\x05total\x12\x10\n\x03max\x18\x04\x20\x01(\x04R\x03max\"\
+    \xb3\x03\n\x0bNetsimStats\x12#\n\rduration_secs\x18\x01\x20\x01(\x04R\
+    \x0cdurationSecs\x12!\n\x0cdevice_count\x18\x02\x20\x01(\x05R\x0bdeviceC\
+    ount\x126\n\x17peak_concurrent_devices\x18\x03\x20\x01(\x05R\x15peakConc\
+    urrentDevices\x12?\n\x0bradio_stats\x18\x04\x20\x03(\x0b2\x1e.netsim.sta\
+    ts.NetsimRadioStatsR\nradioStats\x12I\n\rlatency_stats\x18\x05\x20\x03(\
+    \x0b2$.netsim.stats.NetsimChipLatencyStatsR\x0clatencyStats\x12O\n\x11pa\
+    cket_pool_stats\x18\x06\x20\x01(\x0b2#.netsim.stats.NetsimPacketPoolStat\
+    sR\x0fpacketPoolStats\x12G\n\x0etrace_counters\x18\x07\x20\x03(\x0b2\x20\
+    .netsim.stats.NetsimTraceCounterR\rtraceCounters\
 ";
 
 /// `FileDescriptorProto` object which was a source for this generated file
@@ -735,8 +1858,12 @@ pub fn file_descriptor() -> &'static ::protobuf::reflect::FileDescriptor {
     file_descriptor.get(|| {
         let generated_file_descriptor = generated_file_descriptor_lazy.get(|| {
             let mut deps = ::std::vec::Vec::with_capacity(0);
-            let mut messages = ::std::vec::Vec::with_capacity(2);
+            let mut messages = ::std::vec::Vec::with_capacity(6);
             messages.push(NetsimRadioStats::generated_message_descriptor_data());
+            messages.push(NetsimLatencyStats::generated_message_descriptor_data());
+            messages.push(NetsimChipLatencyStats::generated_message_descriptor_data());
+            messages.push(NetsimPacketPoolStats::generated_message_descriptor_data());
+            messages.push(NetsimTraceCounter::generated_message_descriptor_data());
             messages.push(NetsimStats::generated_message_descriptor_data());
             let mut enums = ::std::vec::Vec::with_capacity(1);
             enums.push(netsim_radio_stats::Kind::generated_enum_descriptor_data());
@@ -19,6 +19,9 @@
 // Use gRPC HCI PacketType definitions so we don't expose Rootcanal's version
 // outside of the Bluetooth Facade.
 #include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "netsim/common.pb.h"
 #include "netsim/hci_packet.pb.h"
@@ -29,15 +32,27 @@ namespace backend {
 
 using netsim::common::ChipKind;
 
+class PacketResponseSink;
+
 /* Handle packet responses for the backend. */
 
+void HandleResponse(ChipKind kind, uint32_t facade_id, std::string packet,
+                    /* optional */ packet::HCIPacket_PacketType packet_type);
+
 void HandleResponse(ChipKind kind, uint32_t facade_id,
                     const std::vector<uint8_t> &packet,
                     /* optional */ packet::HCIPacket_PacketType packet_type);
 
 void HandleResponseCxx(uint32_t kind, uint32_t facade_id,
-                       const rust::Vec<rust::u8> &packet,
+                       rust::Slice<const rust::u8> packet,
                        /* optional */ uint8_t packet_type);
 
+// Attach a sink to the responses of a chip without a stream, for the
+// benchmarks. Returns false if kind is out of range.
+bool AddResponseSink(ChipKind kind, uint32_t facade_id,
+                     std::shared_ptr<PacketResponseSink> sink);
+
+void RemoveResponseSink(ChipKind kind, uint32_t facade_id);
+
 }  // namespace backend
 }  // namespace netsim
@@ -0,0 +1,207 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/egress_queue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "netsim/common.pb.h"
+#include "netsim/config.pb.h"
+#include "netsim/hci_packet.pb.h"
+
+namespace netsim {
+namespace backend {
+namespace {
+
+std::mutex egress_stats_mutex;
+std::map<std::pair<common::ChipKind, uint32_t>, std::shared_ptr<EgressStats>>
+    egress_stats;
+// Chips whose stream closed, oldest first.
+std::deque<std::pair<common::ChipKind, uint32_t>> retired_egress_stats;
+
+void ApplyPolicy(config::EgressDropPolicy policy,
+                 EgressOptions::DropPolicy *out) {
+  switch (policy) {
+    case config::EGRESS_DROP_NEW:
+      *out = EgressOptions::DropPolicy::kDropNew;
+      break;
+    case config::EGRESS_DROP_OLDEST:
+      *out = EgressOptions::DropPolicy::kDropOldest;
+      break;
+    default:
+      break;
+  }
+}
+
+}  // namespace
+
+EgressOptions EgressOptions::FromConfig(
+    const config::GrpcServerOptions &options) {
+  EgressOptions result;
+  if (options.egress_queue_bytes() != 0)
+    result.max_bytes = options.egress_queue_bytes();
+  ApplyPolicy(options.egress_data_policy(), &result.data_policy);
+  ApplyPolicy(options.egress_audio_policy(), &result.audio_policy);
+  if (options.egress_stall_timeout_ms() != 0)
+    result.stall_timeout =
+        std::chrono::milliseconds(options.egress_stall_timeout_ms());
+  return result;
+}
+
+std::shared_ptr<EgressStats> GetEgressStats(common::ChipKind chip_kind,
+                                            uint32_t facade_id) {
+  std::lock_guard<std::mutex> lock(egress_stats_mutex);
+  std::pair key{chip_kind, facade_id};
+  auto &retired = retired_egress_stats;
+  retired.erase(std::remove(retired.begin(), retired.end(), key),
+                retired.end());
+  auto &stats = egress_stats[key];
+  if (!stats) stats = std::make_shared<EgressStats>();
+  return stats;
+}
+
+std::shared_ptr<EgressStats> FindEgressStats(common::ChipKind chip_kind,
+                                             uint32_t facade_id) {
+  std::lock_guard<std::mutex> lock(egress_stats_mutex);
+  auto it = egress_stats.find({chip_kind, facade_id});
+  return it == egress_stats.end() ? nullptr : it->second;
+}
+
+void ReleaseEgressStats(common::ChipKind chip_kind, uint32_t facade_id) {
+  std::lock_guard<std::mutex> lock(egress_stats_mutex);
+  std::pair key{chip_kind, facade_id};
+  auto &retired = retired_egress_stats;
+  if (egress_stats.count(key) == 0 ||
+      std::find(retired.begin(), retired.end(), key) != retired.end())
+    return;
+  retired.push_back(key);
+  if (retired.size() > kRetiredEgressStats) {
+    egress_stats.erase(retired.front());
+    retired.pop_front();
+  }
+}
+
+std::vector<ChipEgressStats> GetAllEgressStats() {
+  std::lock_guard<std::mutex> lock(egress_stats_mutex);
+  std::vector<ChipEgressStats> result;
+  for (const auto &[key, stats] : egress_stats) {
+    ChipEgressStats chip{key.first, key.second, stats->dropped_packets,
+                         stats->dropped_bytes, stats->stalls};
+    if (chip.dropped_packets == 0 && chip.stalls == 0) continue;
+    result.push_back(chip);
+  }
+  return result;
+}
+
+EgressQueue::EgressQueue(const EgressOptions &options,
+                         common::ChipKind chip_kind,
+                         std::shared_ptr<EgressStats> stats)
+    : options_(options), chip_kind_(chip_kind), stats_(std::move(stats)) {}
+
+EgressQueue::Class EgressQueue::ClassOf(
+    packet::HCIPacket_PacketType packet_type) const {
+  if (chip_kind_ != common::ChipKind::BLUETOOTH) return Class::kData;
+  switch (packet_type) {
+    case packet::HCIPacket::SCO:
+    case packet::HCIPacket::ISO:
+      return Class::kAudio;
+    case packet::HCIPacket::ACL:
+      return Class::kData;
+    default:
+      return Class::kEvent;
+  }
+}
+
+void EgressQueue::CountDrop(size_t bytes) {
+  stats_->dropped_packets++;
+  stats_->dropped_bytes += bytes;
+}
+
+bool EgressQueue::MakeRoom(Class packet_class, size_t size) {
+  for (auto it = queue_.begin();
+       it != queue_.end() && bytes_ + size > options_.max_bytes;) {
+    if (ClassOf(it->packet_type) != packet_class) {
+      ++it;
+      continue;
+    }
+    CountDrop(it->packet.size());
+    bytes_ -= it->packet.size();
+    it = queue_.erase(it);
+  }
+  return bytes_ + size <= options_.max_bytes;
+}
+
+EgressQueue::PushResult EgressQueue::Push(
+    std::string packet, packet::HCIPacket_PacketType packet_type,
+    Clock::time_point now) {
+  if (stalled_) {
+    CountDrop(packet.size());
+    return PushResult::kDropped;
+  }
+  if (!in_flight_ && queue_.empty()) {
+    progress_ = now;
+  } else if (now - progress_ > options_.stall_timeout) {
+    stalled_ = true;
+    stats_->stalls++;
+    CountDrop(packet.size());
+    Clear();
+    return PushResult::kStalled;
+  }
+  auto packet_class = ClassOf(packet_type);
+  if (packet_class != Class::kEvent &&
+      bytes_ + packet.size() > options_.max_bytes) {
+    auto policy = packet_class == Class::kAudio ? options_.audio_policy
+                                                : options_.data_policy;
+    if (policy == EgressOptions::DropPolicy::kDropNew ||
+        !MakeRoom(packet_class, packet.size())) {
+      CountDrop(packet.size());
+      return PushResult::kDropped;
+    }
+  }
+  bytes_ += packet.size();
+  queue_.push_back({std::move(packet), packet_type});
+  return PushResult::kQueued;
+}
+
+bool EgressQueue::Pop(Packet &packet) {
+  if (queue_.empty()) return false;
+  packet = std::move(queue_.front());
+  queue_.pop_front();
+  bytes_ -= packet.packet.size();
+  in_flight_ = true;
+  return true;
+}
+
+void EgressQueue::WriteDone(Clock::time_point now) {
+  in_flight_ = false;
+  progress_ = now;
+}
+
+void EgressQueue::Clear() {
+  for (const auto &pending : queue_) CountDrop(pending.packet.size());
+  queue_.clear();
+  bytes_ = 0;
+}
+
+}  // namespace backend
+}  // namespace netsim
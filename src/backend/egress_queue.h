@@ -0,0 +1,155 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Bounded queue of the packets waiting to be written to one stream.
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "netsim/common.pb.h"
+#include "netsim/config.pb.h"
+#include "netsim/hci_packet.pb.h"
+
+namespace netsim {
+namespace backend {
+
+struct EgressOptions {
+  enum class DropPolicy { kDropNew, kDropOldest };
+
+  static constexpr size_t kDefaultMaxBytes = 1 << 20;
+  static constexpr std::chrono::milliseconds kDefaultStallTimeout{5000};
+
+  size_t max_bytes = kDefaultMaxBytes;
+  // ACL data and the frames of the other chip kinds.
+  DropPolicy data_policy = DropPolicy::kDropNew;
+  // SCO and ISO, where a late packet is worth less than the next one.
+  DropPolicy audio_policy = DropPolicy::kDropOldest;
+  std::chrono::milliseconds stall_timeout = kDefaultStallTimeout;
+
+  // Applies the options that are set, the others keep the defaults.
+  static EgressOptions FromConfig(const config::GrpcServerOptions &options);
+};
+
+// Packets dropped on the way to the stream of a chip. Kept for a while after
+// the stream closes so they cover the session of the chip.
+struct EgressStats {
+  std::atomic<uint64_t> dropped_packets{0};
+  std::atomic<uint64_t> dropped_bytes{0};
+  // Times the stream was disconnected for not reading.
+  std::atomic<uint64_t> stalls{0};
+};
+
+// Stats of removed chips kept for the session. Past this, those of the
+// oldest removed chip are dropped.
+constexpr size_t kRetiredEgressStats = 16;
+
+// Returns the stats of a chip, created on first use.
+std::shared_ptr<EgressStats> GetEgressStats(common::ChipKind chip_kind,
+                                            uint32_t facade_id);
+
+// Returns the stats of a chip, or nullptr if it has none.
+std::shared_ptr<EgressStats> FindEgressStats(common::ChipKind chip_kind,
+                                             uint32_t facade_id);
+
+// Called when the stream of a chip closes. Its stats stay listed until
+// kRetiredEgressStats other chips are released.
+void ReleaseEgressStats(common::ChipKind chip_kind, uint32_t facade_id);
+
+struct ChipEgressStats {
+  common::ChipKind chip_kind;
+  uint32_t facade_id;
+  uint64_t dropped_packets;
+  uint64_t dropped_bytes;
+  uint64_t stalls;
+};
+
+// Returns the chips that dropped packets or stalled.
+std::vector<ChipEgressStats> GetAllEgressStats();
+
+/**
+ * @class EgressQueue
+ *
+ * Packets queued for a stream, bounded in bytes. HCI events are always
+ * queued, since the host waits for the responses to its commands. When
+ * the queue is full, audio and data packets are dropped by their policy.
+ *
+ * The queue also detects a peer that stopped reading: once a write makes
+ * no progress for the stall timeout while packets wait, Push reports the
+ * stall once and drops every packet after it, so the owner can cancel the
+ * stream.
+ *
+ * Not thread safe, the owner of the stream guards it.
+ */
+class EgressQueue {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Packet {
+    std::string packet;
+    packet::HCIPacket_PacketType packet_type;
+  };
+
+  enum class PushResult { kQueued, kDropped, kStalled };
+
+  EgressQueue(const EgressOptions &options, common::ChipKind chip_kind,
+              std::shared_ptr<EgressStats> stats);
+
+  PushResult Push(std::string packet, packet::HCIPacket_PacketType packet_type,
+                  Clock::time_point now);
+
+  // Takes the next packet to write. The write is in flight until WriteDone.
+  bool Pop(Packet &packet);
+
+  void WriteDone(Clock::time_point now);
+
+  bool Empty() const { return queue_.empty(); }
+
+  // Bytes of the packets waiting, not counting the write in flight.
+  size_t Bytes() const { return bytes_; }
+
+  void Clear();
+
+ private:
+  enum class Class { kEvent, kAudio, kData };
+
+  Class ClassOf(packet::HCIPacket_PacketType packet_type) const;
+
+  void CountDrop(size_t bytes);
+
+  // Drops the oldest packets of a class until size bytes fit.
+  bool MakeRoom(Class packet_class, size_t size);
+
+  const EgressOptions options_;
+  const common::ChipKind chip_kind_;
+  std::shared_ptr<EgressStats> stats_;
+  std::deque<Packet> queue_;
+  size_t bytes_ = 0;
+  bool in_flight_ = false;
+  bool stalled_ = false;
+  // Last time the writer was idle or finished a write.
+  Clock::time_point progress_;
+};
+
+}  // namespace backend
+}  // namespace netsim
@@ -0,0 +1,193 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the EgressQueue class.
+#include "backend/egress_queue.h"
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "netsim/common.pb.h"
+#include "netsim/config.pb.h"
+#include "netsim/hci_packet.pb.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using backend::EgressOptions;
+using backend::EgressQueue;
+using backend::EgressStats;
+using common::ChipKind;
+using packet::HCIPacket;
+using PushResult = EgressQueue::PushResult;
+
+const auto kStart = EgressQueue::Clock::time_point();
+
+class EgressQueueTest : public ::testing::Test {
+ protected:
+  EgressQueueTest() {
+    options_.max_bytes = 10;
+    options_.stall_timeout = std::chrono::seconds(1);
+  }
+
+  EgressQueue MakeQueue(ChipKind chip_kind = ChipKind::BLUETOOTH) {
+    return EgressQueue(options_, chip_kind, stats_);
+  }
+
+  // Returns the first byte of every queued packet, in order.
+  static std::string Drain(EgressQueue &queue) {
+    std::string result;
+    EgressQueue::Packet packet;
+    while (queue.Pop(packet)) {
+      result += packet.packet[0];
+      queue.WriteDone(kStart);
+    }
+    return result;
+  }
+
+  EgressOptions options_;
+  std::shared_ptr<EgressStats> stats_ = std::make_shared<EgressStats>();
+};
+
+TEST_F(EgressQueueTest, DataDropsNewWhenFull) {
+  auto queue = MakeQueue();
+  EXPECT_EQ(queue.Push("aaaa", HCIPacket::ACL, kStart), PushResult::kQueued);
+  EXPECT_EQ(queue.Push("bbbb", HCIPacket::ACL, kStart), PushResult::kQueued);
+  EXPECT_EQ(queue.Push("cccc", HCIPacket::ACL, kStart), PushResult::kDropped);
+  EXPECT_EQ(queue.Bytes(), 8);
+  EXPECT_EQ(Drain(queue), "ab");
+  EXPECT_EQ(stats_->dropped_packets, 1);
+  EXPECT_EQ(stats_->dropped_bytes, 4);
+}
+
+TEST_F(EgressQueueTest, AudioDropsOldestOfItsClass) {
+  auto queue = MakeQueue();
+  queue.Push("aaaa", HCIPacket::ACL, kStart);
+  queue.Push("bbb", HCIPacket::SCO, kStart);
+  queue.Push("ccc", HCIPacket::ISO, kStart);
+  EXPECT_EQ(queue.Push("ddd", HCIPacket::SCO, kStart), PushResult::kQueued);
+  EXPECT_EQ(Drain(queue), "acd");
+  EXPECT_EQ(stats_->dropped_packets, 1);
+}
+
+TEST_F(EgressQueueTest, EventsAreNeverDropped) {
+  auto queue = MakeQueue();
+  queue.Push("aaaaaaaaaa", HCIPacket::ACL, kStart);
+  EXPECT_EQ(queue.Push("eeee", HCIPacket::EVENT, kStart), PushResult::kQueued);
+  EXPECT_EQ(queue.Push("ffff", HCIPacket::EVENT, kStart), PushResult::kQueued);
+  EXPECT_EQ(queue.Bytes(), 18);
+  EXPECT_EQ(stats_->dropped_packets, 0);
+}
+
+TEST_F(EgressQueueTest, OtherChipKindsUseDataPolicy) {
+  options_.data_policy = EgressOptions::DropPolicy::kDropOldest;
+  auto queue = MakeQueue(ChipKind::WIFI);
+  queue.Push("aaaaaa", HCIPacket::HCI_PACKET_UNSPECIFIED, kStart);
+  queue.Push("bbbbbb", HCIPacket::HCI_PACKET_UNSPECIFIED, kStart);
+  EXPECT_EQ(Drain(queue), "b");
+}
+
+TEST_F(EgressQueueTest, StallIsReportedOnce) {
+  auto queue = MakeQueue();
+  EgressQueue::Packet packet;
+  queue.Push("a", HCIPacket::EVENT, kStart);
+  ASSERT_TRUE(queue.Pop(packet));
+  // The write of a never completes.
+  auto later = kStart + std::chrono::milliseconds(500);
+  EXPECT_EQ(queue.Push("b", HCIPacket::EVENT, later), PushResult::kQueued);
+  auto stalled = kStart + std::chrono::seconds(2);
+  EXPECT_EQ(queue.Push("c", HCIPacket::EVENT, stalled), PushResult::kStalled);
+  EXPECT_EQ(queue.Push("d", HCIPacket::EVENT, stalled), PushResult::kDropped);
+  EXPECT_TRUE(queue.Empty());
+  EXPECT_EQ(stats_->stalls, 1);
+  EXPECT_EQ(stats_->dropped_packets, 3);
+}
+
+TEST_F(EgressQueueTest, IdleStreamIsNotStalled) {
+  auto queue = MakeQueue();
+  EgressQueue::Packet packet;
+  queue.Push("a", HCIPacket::EVENT, kStart);
+  ASSERT_TRUE(queue.Pop(packet));
+  queue.WriteDone(kStart);
+  // Nothing was written for a while because nothing was queued.
+  auto later = kStart + std::chrono::seconds(10);
+  EXPECT_EQ(queue.Push("b", HCIPacket::EVENT, later), PushResult::kQueued);
+  EXPECT_EQ(queue.Push("c", HCIPacket::EVENT, later), PushResult::kQueued);
+  EXPECT_EQ(stats_->stalls, 0);
+}
+
+TEST(EgressOptionsTest, FromConfig) {
+  config::GrpcServerOptions config;
+  auto defaults = EgressOptions::FromConfig(config);
+  EXPECT_EQ(defaults.max_bytes, EgressOptions::kDefaultMaxBytes);
+  EXPECT_EQ(defaults.data_policy, EgressOptions::DropPolicy::kDropNew);
+  EXPECT_EQ(defaults.audio_policy, EgressOptions::DropPolicy::kDropOldest);
+  EXPECT_EQ(defaults.stall_timeout, EgressOptions::kDefaultStallTimeout);
+
+  config.set_egress_queue_bytes(4096);
+  config.set_egress_data_policy(config::EGRESS_DROP_OLDEST);
+  config.set_egress_audio_policy(config::EGRESS_DROP_NEW);
+  config.set_egress_stall_timeout_ms(250);
+  auto options = EgressOptions::FromConfig(config);
+  EXPECT_EQ(options.max_bytes, 4096);
+  EXPECT_EQ(options.data_policy, EgressOptions::DropPolicy::kDropOldest);
+  EXPECT_EQ(options.audio_policy, EgressOptions::DropPolicy::kDropNew);
+  EXPECT_EQ(options.stall_timeout, std::chrono::milliseconds(250));
+}
+
+TEST(EgressStatsTest, ChipsWithDropsAreListed) {
+  auto stats = backend::GetEgressStats(ChipKind::UWB, 7);
+  EXPECT_EQ(stats, backend::GetEgressStats(ChipKind::UWB, 7));
+  stats->dropped_packets++;
+  bool found = false;
+  for (const auto &chip : backend::GetAllEgressStats()) {
+    if (chip.chip_kind == ChipKind::UWB && chip.facade_id == 7) {
+      found = true;
+      EXPECT_EQ(chip.dropped_packets, 1);
+    }
+  }
+  EXPECT_TRUE(found);
+}
+
+TEST(EgressStatsTest, ReleasedStatsAreBounded) {
+  const uint32_t first = 100;
+  const uint32_t last = first + backend::kRetiredEgressStats;
+  for (uint32_t id = first; id <= last; id++) {
+    backend::GetEgressStats(ChipKind::WIFI, id);
+    backend::ReleaseEgressStats(ChipKind::WIFI, id);
+  }
+  EXPECT_EQ(backend::FindEgressStats(ChipKind::WIFI, first), nullptr);
+  EXPECT_NE(backend::FindEgressStats(ChipKind::WIFI, first + 1), nullptr);
+  EXPECT_NE(backend::FindEgressStats(ChipKind::WIFI, last), nullptr);
+}
+
+TEST(EgressStatsTest, ReturningChipKeepsItsStats) {
+  auto stats = backend::GetEgressStats(ChipKind::WIFI, 200);
+  stats->stalls++;
+  backend::ReleaseEgressStats(ChipKind::WIFI, 200);
+  EXPECT_EQ(backend::GetEgressStats(ChipKind::WIFI, 200), stats);
+  for (uint32_t id = 201; id <= 201 + backend::kRetiredEgressStats; id++) {
+    backend::GetEgressStats(ChipKind::WIFI, id);
+    backend::ReleaseEgressStats(ChipKind::WIFI, id);
+  }
+  EXPECT_EQ(backend::FindEgressStats(ChipKind::WIFI, 200), stats);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
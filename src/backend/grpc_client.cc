@@ -16,19 +16,25 @@
 
 #include <google/protobuf/util/json_util.h>
 
+#include <condition_variable>
 #include <cstdint>
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "grpcpp/channel.h"
+#include "grpcpp/client_context.h"
 #include "grpcpp/create_channel.h"
+#include "grpcpp/generic/generic_stub.h"
 #include "grpcpp/security/credentials.h"
-#include "grpcpp/server_context.h"
-#include "netsim/packet_streamer.grpc.pb.h"
-#include "netsim/packet_streamer.pb.h"
+#include "grpcpp/support/byte_buffer.h"
+#include "grpcpp/support/client_callback.h"
+#include "grpcpp/support/status.h"
+#include "grpcpp/support/stub_options.h"
 #include "rust/cxx.h"
 #include "util/log.h"
 
@@ -40,20 +46,117 @@ namespace client {
 
 const std::chrono::duration kConnectionDeadline = std::chrono::seconds(5);
 
-using Stream = ::grpc::ClientReaderWriter<netsim::packet::PacketRequest,
-                                          netsim::packet::PacketResponse>;
+// The StreamPackets method of netsim.packet.PacketStreamer. Streams exchange
+// grpc::ByteBuffer so that the serialized protos are passed to and from Rust
+// without parsing and serializing them again.
+constexpr char kStreamPacketsMethod[] =
+    "/netsim.packet.PacketStreamer/StreamPackets";
 
-std::mutex mutex_;
+// A StreamPackets call on the callback API of the generic stub, with
+// blocking reads and writes for the Rust threads. gRPC allows one read and
+// one write in flight, the read loop is the only reader and writers are
+// serialized by write_mutex.
+//
+// A hold keeps the call from completing while writes may still start. The
+// read loop removes it, under write_mutex, once reading has stopped.
+class ClientStream
+    : public grpc::ClientBidiReactor<grpc::ByteBuffer, grpc::ByteBuffer> {
+ public:
+  void Start(grpc::GenericStub &stub) {
+    stub.PrepareBidiStreamingCall(&context_, kStreamPacketsMethod,
+                                  grpc::StubOptions(), this);
+    AddHold();
+    StartCall();
+  }
+
+  bool Read(grpc::ByteBuffer *buffer) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    read_done_ = false;
+    lock.unlock();
+    StartRead(buffer);
+    lock.lock();
+    cv_.wait(lock, [this] { return read_done_; });
+    return read_ok_;
+  }
+
+  // Called with write_mutex held.
+  bool Write(const grpc::ByteBuffer &buffer) {
+    if (closed_) return false;
+    std::unique_lock<std::mutex> lock(mutex_);
+    write_done_ = false;
+    lock.unlock();
+    StartWrite(&buffer);
+    lock.lock();
+    cv_.wait(lock, [this] { return write_done_; });
+    return write_ok_;
+  }
+
+  // Ends the writes and waits for the status of the call. Called once by
+  // the read loop, when reading has stopped.
+  grpc::Status Finish() {
+    {
+      std::lock_guard<std::mutex> lock(write_mutex);
+      closed_ = true;
+      RemoveHold();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return done_; });
+    return status_;
+  }
+
+  void OnReadDone(bool ok) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    read_done_ = true;
+    read_ok_ = ok;
+    cv_.notify_all();
+  }
+
+  void OnWriteDone(bool ok) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    write_done_ = true;
+    write_ok_ = ok;
+    cv_.notify_all();
+  }
+
+  void OnDone(const grpc::Status &status) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    done_ = true;
+    status_ = status;
+    cv_.notify_all();
+  }
+
+  std::mutex write_mutex;
+
+ private:
+  grpc::ClientContext context_;
+  // Guarded by write_mutex.
+  bool closed_ = false;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool read_done_ = false;
+  bool read_ok_ = false;
+  bool write_done_ = false;
+  bool write_ok_ = false;
+  bool done_ = false;
+  grpc::Status status_;
+};
+
+// Guards the maps, the streams themselves are used outside of the lock.
+std::shared_mutex mutex_;
 uint32_t stream_id_max_ = 0;
 
 // Active StreamPacket calls
-std::unordered_map<uint32_t, std::unique_ptr<Stream>> streams_;
+std::unordered_map<uint32_t, std::shared_ptr<ClientStream>> streams_;
 
-// Single connection to a server with multiple StreamPackets calls
-std::string server_;
-std::shared_ptr<grpc::Channel> channel_;
-grpc::ClientContext context_;
-std::unique_ptr<netsim::packet::PacketStreamer::Stub> stub_;
+// One connection per server shared by its StreamPackets calls
+std::unordered_map<std::string, std::shared_ptr<grpc::Channel>> channels_;
+
+std::shared_ptr<ClientStream> GetStream(uint32_t stream_id) {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  auto it = streams_.find(stream_id);
+  return it == streams_.end() ? nullptr : it->second;
+}
 
 // Call the StreamPackets RPC on server.
 //
@@ -62,69 +165,95 @@ std::unique_ptr<netsim::packet::PacketStreamer::Stub> stub_;
 // connection is created.
 
 uint32_t StreamPackets(const rust::String &server_rust) {
-  std::unique_lock<std::mutex> lock(mutex_);
   auto server = std::string(server_rust);
-  if (server_.empty()) {
-    server_ = server;
-    channel_ = grpc::CreateChannel(server, grpc::InsecureChannelCredentials());
+  std::shared_ptr<grpc::Channel> channel;
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (auto it = channels_.find(server); it != channels_.end()) {
+      channel = it->second;
+    }
+  }
+  if (channel == nullptr) {
+    // Connect without the lock, so the other streams are not stalled for up
+    // to kConnectionDeadline. If two calls race, the first channel stored is
+    // kept and shared.
+    channel = grpc::CreateChannel(server, grpc::InsecureChannelCredentials());
     auto deadline = std::chrono::system_clock::now() + kConnectionDeadline;
-    if (!channel_->WaitForConnected(deadline)) {
-      BtsLog("Failed to create packet streamer client to %s", server_.c_str());
+    if (!channel->WaitForConnected(deadline)) {
+      BtsLog("Failed to create packet streamer client to %s", server.c_str());
       return -1;
     }
-    stub_ = netsim::packet::PacketStreamer::NewStub(channel_);
-  } else if (server_ != server) {
-    BtsLog("grpc_client: multiple servers not supported");
-    return -1;
-  }
-  auto stream = stub_->StreamPackets(&context_);
-  streams_[++stream_id_max_] = std::move(stream);
-  BtsLog("Created packet streamer client to %s", server_.c_str());
-  return stream_id_max_;
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto &stored = channels_[server];
+    if (stored == nullptr) stored = channel;
+    channel = stored;
+  }
+  auto client_stream = std::make_shared<ClientStream>();
+  grpc::GenericStub stub(channel);
+  client_stream->Start(stub);
+  uint32_t stream_id;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    stream_id = ++stream_id_max_;
+    streams_[stream_id] = std::move(client_stream);
+  }
+  BtsLog("Created packet streamer client to %s", server.c_str());
+  return stream_id;
 }
 
 /// Loop reading packets on the stream identified by stream_id and call the
 //  ReadCallback function with the PacketResponse byte proto.
 
 bool ReadPacketResponseLoop(uint32_t stream_id, ReadCallback read_fn) {
-  netsim::packet::PacketResponse response;
-  while (true) {
-    {
-      std::unique_lock<std::mutex> lock(mutex_);
-      if (streams_.find(stream_id) == streams_.end()) {
-        BtsLogWarn("grpc_client: no stream for stream_id %d", stream_id);
-        return false;
-      }
+  auto client_stream = GetStream(stream_id);
+  if (client_stream == nullptr) {
+    BtsLogWarn("grpc_client: no stream for stream_id %d", stream_id);
+    return false;
+  }
+  grpc::ByteBuffer buffer;
+  std::vector<grpc::Slice> slices;
+  std::vector<uint8_t> proto_bytes;
+  while (client_stream->Read(&buffer)) {
+    slices.clear();
+    if (!buffer.Dump(&slices).ok()) continue;
+    // A response received in one slice is passed without a copy.
+    if (slices.size() == 1) {
+      (*read_fn)(stream_id, {slices[0].begin(), slices[0].size()});
+      continue;
     }
-    // TODO: fix locking here
-    if (!streams_[stream_id]->Read(&response)) {
-      BtsLogWarn("grpc_client: reading stopped stream_id %d", stream_id);
-      return false;
+    proto_bytes.clear();
+    for (const auto &slice : slices) {
+      proto_bytes.insert(proto_bytes.end(), slice.begin(), slice.end());
     }
-    std::vector<unsigned char> proto_bytes(response.ByteSizeLong());
-    response.SerializeToArray(proto_bytes.data(), proto_bytes.size());
-    rust::Slice<const uint8_t> slice{proto_bytes.data(), proto_bytes.size()};
-    (*read_fn)(stream_id, slice);
+    (*read_fn)(stream_id, {proto_bytes.data(), proto_bytes.size()});
+  }
+  BtsLogWarn("grpc_client: reading stopped stream_id %d", stream_id);
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    streams_.erase(stream_id);
   }
+  auto status = client_stream->Finish();
+  if (!status.ok()) {
+    BtsLogWarn("grpc_client: stream_id %d finished with %s", stream_id,
+               status.error_message().c_str());
+  }
+  return false;
 }
 
 // Write a packet to the stream identified by stream_id
 
 bool WritePacketRequest(uint32_t stream_id,
                         const rust::Slice<::std::uint8_t const> proto_bytes) {
-  netsim::packet::PacketRequest request;
-  if (!request.ParseFromArray(proto_bytes.data(), proto_bytes.size())) {
-    BtsLogWarn("grpc_client: write failed stream_id %d", stream_id);
-    return false;
-  };
-
-  std::unique_lock<std::mutex> lock(mutex_);
-  if (streams_.find(stream_id) == streams_.end()) {
-    BtsLogWarn("grpc_client: no stream for stream_id %d", stream_id);
+  auto client_stream = GetStream(stream_id);
+  if (client_stream == nullptr) {
+    BtsLogWarnRateLimited("grpc_client: no stream for stream_id %d", stream_id);
     return false;
   }
-  if (!streams_[stream_id]->Write(request)) {
-    BtsLogWarn("grpc_client: write failed stream_id %d", stream_id);
+  grpc::Slice slice(proto_bytes.data(), proto_bytes.size());
+  grpc::ByteBuffer buffer(&slice, 1);
+  std::lock_guard<std::mutex> lock(client_stream->write_mutex);
+  if (!client_stream->Write(buffer)) {
+    BtsLogWarnRateLimited("grpc_client: write failed stream_id %d", stream_id);
     return false;
   }
   return true;
@@ -19,21 +19,28 @@
 
 #include <cstdint>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
-#include <unordered_map>
+#include <utility>
 
+#include "backend/backend_packet_hub.h"
+#include "backend/egress_queue.h"
+#include "backend/packet_response_writer.h"
+#include "backend/request_executor.h"
+#include "backend/stream_table.h"
 #include "google/protobuf/empty.pb.h"
 #include "grpcpp/server_context.h"
+#include "grpcpp/support/server_callback.h"
 #include "grpcpp/support/status.h"
 #include "netsim-daemon/src/ffi.rs.h"
 #include "netsim/common.pb.h"
+#include "netsim/config.pb.h"
 #include "netsim/packet_streamer.grpc.pb.h"
 #include "netsim/packet_streamer.pb.h"
 #include "util/log.h"
-
-#ifdef NETSIM_ANDROID_EMULATOR
-#include "android-qemu2-glue/netsim/libslirp_driver.h"
-#endif
+#include "util/packet_buffer.h"
+#include "util/trace.h"
 
 namespace netsim {
 namespace backend {
@@ -46,17 +53,176 @@ using Stream =
 
 using netsim::startup::Chip;
 
-// Mapping from <chip kind, facade id> to streams.
-std::unordered_map<std::string, Stream *> facade_to_stream;
+// Mapping from <chip kind, facade id> to the sink of each stream.
+StreamTable facade_to_stream;
+
+// A chip attached to netsim through one StreamPackets call.
+struct ChipStream {
+  std::string device_name;
+  ChipKind chip_kind;
+  uint32_t device_id;
+  uint32_t chip_id;
+  uint32_t facade_id;
+};
+
+// Add the chip described by the initial_info of the first request.
+::grpc::Status AddChip(const std::string &peer,
+                       const packet::PacketRequest &request,
+                       ChipStream *chip_stream) {
+  if (!request.has_initial_info()) {
+    BtsLogError("ServiceImpl no initial information or stream closed");
+    return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                          "Missing initial_info in first packet.");
+  }
+
+  auto device_name = request.initial_info().name();
+  auto chip_kind = request.initial_info().chip().kind();
+  // multiple chips of the same chip_kind for a device have a name
+  auto chip_name = request.initial_info().chip().id();
+  auto manufacturer = request.initial_info().chip().manufacturer();
+  auto product_name = request.initial_info().chip().product_name();
+  auto chip_address = request.initial_info().chip().address();
+  auto bt_properties = request.initial_info().chip().bt_properties();
+  // Add a new chip to the device
+  std::string chip_kind_string;
+  switch (chip_kind) {
+    case common::ChipKind::BLUETOOTH:
+      chip_kind_string = "BLUETOOTH";
+      break;
+    case common::ChipKind::WIFI:
+      chip_kind_string = "WIFI";
+      break;
+    case common::ChipKind::UWB:
+      chip_kind_string = "UWB";
+      break;
+    default:
+      chip_kind_string = "UNSPECIFIED";
+      break;
+  }
+
+  std::vector<unsigned char> message_vec(bt_properties.ByteSizeLong());
+  if (!bt_properties.SerializeToArray(message_vec.data(), message_vec.size())) {
+    BtsLogError("Failed to serialize bt_properties to bytes");
+  }
+
+  auto result = netsim::device::AddChipCxx(
+      peer, device_name, chip_kind_string, chip_address, chip_name,
+      manufacturer, product_name, message_vec);
+  if (result->IsError()) {
+    return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                          "AddChipCxx failed to add chip into netsim");
+  }
+  chip_stream->device_name = device_name;
+  chip_stream->chip_kind = chip_kind;
+  chip_stream->device_id = result->GetDeviceId();
+  chip_stream->chip_id = result->GetChipId();
+  chip_stream->facade_id = result->GetFacadeId();
+
+  BtsLogInfo(
+      "grpc_server: adding chip - chip_id: %d, facade_id: %d, device_name: "
+      "%s",
+      chip_stream->chip_id, chip_stream->facade_id, device_name.c_str());
+  return ::grpc::Status::OK;
+}
+
+// Connect packet responses from the chip facade to the peer. Returns false
+// if the responses could not be connected.
+bool ConnectChip(const ChipStream &chip_stream,
+                 std::shared_ptr<PacketResponseSink> sink) {
+  if (!facade_to_stream.Add(chip_stream.chip_kind, chip_stream.facade_id,
+                            std::move(sink))) {
+    return false;
+  }
+  netsim::transport::RegisterGrpcTransport(chip_stream.chip_kind,
+                                           chip_stream.facade_id);
+  return true;
+}
+
+::grpc::Status ConnectChipFailed(const ChipStream &chip_stream) {
+  BtsLogError("grpc_server: failed to connect facade_id: %d",
+              chip_stream.facade_id);
+  return ::grpc::Status(::grpc::StatusCode::INTERNAL,
+                        "Failed to connect the chip responses.");
+}
 
-std::string ChipFacade(ChipKind chip_kind, uint32_t facade_id) {
-  return std::to_string(chip_kind) + "/" + std::to_string(facade_id);
+// No longer able to send responses to peer.
+void DisconnectChip(const ChipStream &chip_stream) {
+  netsim::transport::UnregisterGrpcTransport(chip_stream.chip_kind,
+                                             chip_stream.facade_id);
+  facade_to_stream.Remove(chip_stream.chip_kind, chip_stream.facade_id);
+  auto stats = FindEgressStats(chip_stream.chip_kind, chip_stream.facade_id);
+  if (stats && stats->dropped_packets != 0) {
+    BtsLogWarn("grpc_server: dropped %llu packets for facade_id: %d",
+               static_cast<unsigned long long>(stats->dropped_packets),
+               chip_stream.facade_id);
+  }
+  ReleaseEgressStats(chip_stream.chip_kind, chip_stream.facade_id);
+}
+
+// Remove the chip from the device.
+void RemoveChip(const ChipStream &chip_stream) {
+  netsim::device::RemoveChipCxx(chip_stream.device_id, chip_stream.chip_id);
+
+  BtsLogInfo(
+      "grpc_server: removing chip - chip_id: %d, facade_id: %d, device_name: "
+      "%s",
+      chip_stream.chip_id, chip_stream.facade_id,
+      chip_stream.device_name.c_str());
+}
+
+// Forward one request to the packet_hub.
+void ProcessRequest(const ChipStream &chip_stream,
+                    packet::PacketRequest *request) {
+  NETSIM_TRACE_SCOPE("StreamPackets");
+  auto chip_kind = chip_stream.chip_kind;
+  auto facade_id = chip_stream.facade_id;
+  // All kinds possible (bt, uwb, wifi), but each rpc only streames one.
+  if (chip_kind == common::ChipKind::BLUETOOTH) {
+    if (!request->has_hci_packet()) {
+      BtsLogWarnRateLimited(
+          "grpc_server: unknown packet type from facade_id: %d", facade_id);
+      return;
+    }
+    auto packet_type = request->hci_packet().packet_type();
+    // The payload is copied out of the request once, into the packet pool,
+    // and then passed by handle through the dispatcher down to rootcanal.
+    auto packet = util::PacketBuffer::FromBytes(
+        request->mutable_hci_packet()->mutable_packet());
+    transport::HandleRequestCxx(chip_kind, facade_id, packet, packet_type);
+  } else if (chip_kind == common::ChipKind::WIFI) {
+    if (!request->has_packet()) {
+      BtsLogWarnRateLimited(
+          "grpc_server: unknown packet type from facade_id: %d", facade_id);
+      return;
+    }
+    auto packet = util::PacketBuffer::FromBytes(request->mutable_packet());
+    // The WiFi facade batches the frame; slirp is serviced by its own thread.
+    transport::HandleRequestCxx(chip_kind, facade_id, packet,
+                                packet::HCIPacket::HCI_PACKET_UNSPECIFIED);
+  } else if (chip_kind == common::ChipKind::UWB) {
+    if (!request->has_packet()) {
+      BtsLogWarnRateLimited(
+          "grpc_server: unknown packet type from facade_id: %d", facade_id);
+      return;
+    }
+    auto packet = util::PacketBuffer::FromBytes(request->mutable_packet());
+    transport::HandleRequestCxx(chip_kind, facade_id, packet,
+                                packet::HCIPacket::HCI_PACKET_UNSPECIFIED);
+  } else {
+    BtsLogWarnRateLimited("grpc_server: unknown chip_kind from facade_id: %d",
+                          facade_id);
+  }
 }
 
 // Service handles the gRPC StreamPackets requests.
+//
+// Each stream holds a gRPC thread for the lifetime of the connection.
 
 class ServiceImpl final : public packet::PacketStreamer::Service {
  public:
+  explicit ServiceImpl(const EgressOptions &egress_options)
+      : egress_options_(egress_options) {}
+
   ::grpc::Status StreamPackets(::grpc::ServerContext *context,
                                Stream *stream) override {
     // Now connected to a peer issuing a bi-directional streaming grpc
@@ -66,175 +232,321 @@ class ServiceImpl final : public packet::PacketStreamer::Service {
     packet::PacketRequest request;
 
     // First packet must have initial_info describing the peer
-    bool success = stream->Read(&request);
-    if (!success || !request.has_initial_info()) {
+    if (!stream->Read(&request)) {
       BtsLogError("ServiceImpl no initial information or stream closed");
       return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
                             "Missing initial_info in first packet.");
     }
+    ChipStream chip_stream;
+    auto status = AddChip(peer, request, &chip_stream);
+    if (!status.ok()) return status;
 
-    auto device_name = request.initial_info().name();
-    auto chip_kind = request.initial_info().chip().kind();
-    // multiple chips of the same chip_kind for a device have a name
-    auto chip_name = request.initial_info().chip().id();
-    auto manufacturer = request.initial_info().chip().manufacturer();
-    auto product_name = request.initial_info().chip().product_name();
-    auto chip_address = request.initial_info().chip().address();
-    auto bt_properties = request.initial_info().chip().bt_properties();
-    // Add a new chip to the device
-    std::string chip_kind_string;
-    switch (chip_kind) {
-      case common::ChipKind::BLUETOOTH:
-        chip_kind_string = "BLUETOOTH";
-        break;
-      case common::ChipKind::WIFI:
-        chip_kind_string = "WIFI";
-        break;
-      case common::ChipKind::UWB:
-        chip_kind_string = "UWB";
-        break;
-      default:
-        chip_kind_string = "UNSPECIFIED";
-        break;
+    auto writer = std::make_shared<PacketResponseWriter>(
+        stream, context, chip_stream.chip_kind, chip_stream.facade_id,
+        egress_options_);
+    if (!ConnectChip(chip_stream, writer)) {
+      writer->Stop();
+      RemoveChip(chip_stream);
+      return ConnectChipFailed(chip_stream);
     }
 
-    std::vector<unsigned char> message_vec(bt_properties.ByteSizeLong());
-    if (!bt_properties.SerializeToArray(message_vec.data(),
-                                        message_vec.size())) {
-      BtsLogError("Failed to serialize bt_properties to bytes");
+    // Process requests in a loop forwarding packets to the packet_hub and
+    // returning when the channel is closed.
+    while (stream->Read(&request)) {
+      ProcessRequest(chip_stream, &request);
     }
+    BtsLogWarn("grpc_server: reading stopped - facade_id: %d",
+               chip_stream.facade_id);
 
-    auto result = netsim::device::AddChipCxx(
-        peer, device_name, chip_kind_string, chip_address, chip_name,
-        manufacturer, product_name, message_vec);
-    if (result->IsError()) {
-      return ::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
-                            "AddChipCxx failed to add chip into netsim");
-    }
-    uint32_t device_id = result->GetDeviceId();
-    uint32_t chip_id = result->GetChipId();
-    uint32_t facade_id = result->GetFacadeId();
-
-    BtsLogInfo(
-        "grpc_server: adding chip - chip_id: %d, facade_id: %d, device_name: "
-        "%s",
-        chip_id, facade_id, device_name.c_str());
-    // connect packet responses from chip facade to the peer
-    facade_to_stream[ChipFacade(chip_kind, facade_id)] = stream;
-    netsim::transport::RegisterGrpcTransport(chip_kind, facade_id);
-    this->ProcessRequests(stream, device_id, chip_kind, facade_id);
-
-    // no longer able to send responses to peer
-    netsim::transport::UnregisterGrpcTransport(chip_kind, facade_id);
-    facade_to_stream.erase(ChipFacade(chip_kind, facade_id));
-
-    // Remove the chip from the device
-    netsim::device::RemoveChipCxx(device_id, chip_id);
-
-    BtsLogInfo(
-        "grpc_server: removing chip - chip_id: %d, facade_id: %d, device_name: "
-        "%s",
-        chip_id, facade_id, device_name.c_str());
+    DisconnectChip(chip_stream);
+    // The stream is only valid during this call, flush and join the writer.
+    writer->Stop();
+    RemoveChip(chip_stream);
 
     return ::grpc::Status::OK;
   }
 
-  // Convert a protobuf bytes field into shared_ptr<<vec<uint8_t>>.
-  //
-  // Release ownership of the bytes field and convert it to a vector using move
-  // iterators. No copy when called with a mutable reference.
-  std::shared_ptr<std::vector<uint8_t>> ToSharedVec(std::string *bytes_field) {
-    return std::make_shared<std::vector<uint8_t>>(
-        std::make_move_iterator(bytes_field->begin()),
-        std::make_move_iterator(bytes_field->end()));
+ private:
+  const EgressOptions egress_options_;
+};
+
+class PacketStreamReactor;
+
+// Sink handed to the dispatcher for a reactor. It outlives the reactor and
+// drops packets once the reactor has detached.
+class ReactorSink : public PacketResponseSink {
+ public:
+  explicit ReactorSink(PacketStreamReactor *reactor) : reactor_(reactor) {}
+
+  void Enqueue(std::string packet,
+               packet::HCIPacket_PacketType packet_type) override;
+
+  void Detach() {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    reactor_ = nullptr;
   }
 
-  // Process requests in a loop forwarding packets to the packet_hub and
-  // returning when the channel is closed.
-  void ProcessRequests(Stream *stream, uint32_t device_id,
-                       common::ChipKind chip_kind, uint32_t facade_id) {
-    packet::PacketRequest request;
-    while (true) {
-      if (!stream->Read(&request)) {
-        BtsLogWarn("grpc_server: reading stopped - facade_id: %d", facade_id);
-        break;
+ private:
+  // Recursive because cancelling a stalled call from Enqueue may run the
+  // reactions of the reactor, and Detach, inline.
+  std::recursive_mutex mutex_;
+  PacketStreamReactor *reactor_;
+};
+
+// Reactor for one StreamPackets call on the callback service.
+//
+// Reads and writes are driven by gRPC completions, so an idle stream holds
+// no thread. What a read brings in may block, adding the chip or handing
+// the request to a facade, so it is done on the RequestExecutor, which
+// starts the next read when it is done. At most one write is in flight;
+// packets queued meanwhile are written back to back, all but the last with
+// the buffer hint. The queue is bounded by the EgressOptions and a stalled
+// peer has its call cancelled.
+class PacketStreamReactor
+    : public ::grpc::ServerBidiReactor<packet::PacketRequest,
+                                       packet::PacketResponse> {
+ public:
+  PacketStreamReactor(::grpc::CallbackServerContext *context,
+                      const EgressOptions &egress_options,
+                      RequestExecutor *executor)
+      : context_(context),
+        peer_(context->peer()),
+        egress_options_(egress_options),
+        executor_(executor) {
+    BtsLogInfo("grpc_server new packet_stream for peer %s", peer_.c_str());
+    StartRead(&request_);
+  }
+
+  void OnReadDone(bool ok) override {
+    executor_->Post([this, ok] { HandleRead(ok); });
+  }
+
+  void OnWriteDone(bool ok) override {
+    bool finish = false;
+    std::optional<::grpc::WriteOptions> write;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      writing_ = false;
+      queue_->WriteDone(EgressQueue::Clock::now());
+      if (!ok) {
+        BtsLogWarn("grpc_server: write failed for facade_id: %d",
+                   chip_stream_.facade_id);
+        // The stream is broken; drop the rest until the read side closes.
+        write_failed_ = true;
+        queue_->Clear();
+      }
+      if (finishing_) {
+        finish = TakeFinishLocked();
+      } else if (!queue_->Empty()) {
+        write = PrepareWriteLocked();
+      }
+    }
+    if (finish) Finish(::grpc::Status::OK);
+    if (write) StartWrite(&response_, *write);
+  }
+
+  void OnDone() override { delete this; }
+
+  void Enqueue(std::string packet, packet::HCIPacket_PacketType packet_type) {
+    std::optional<::grpc::WriteOptions> write;
+    bool cancel = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (finishing_ || write_failed_) return;
+      auto result = queue_->Push(std::move(packet), packet_type,
+                                 EgressQueue::Clock::now());
+      if (result == EgressQueue::PushResult::kStalled) {
+        BtsLogWarn("grpc_server: stream stalled, cancelling facade_id: %d",
+                   chip_stream_.facade_id);
+        write_failed_ = true;
+        cancel = true;
+      } else if (result == EgressQueue::PushResult::kQueued && !writing_) {
+        write = PrepareWriteLocked();
+      }
+    }
+    // Fails the write in flight and the read, which finishes the call.
+    if (cancel) context_->TryCancel();
+    if (write) StartWrite(&response_, *write);
+  }
+
+ private:
+  // Runs on the executor. Every path either starts the next read or
+  // finishes the call, and nothing of the reactor is touched after Finish.
+  void HandleRead(bool ok) {
+    if (!connected_) {
+      // First packet must have initial_info describing the peer
+      if (!ok) {
+        BtsLogError("ServiceImpl no initial information or stream closed");
+        Finish(::grpc::Status(::grpc::StatusCode::INVALID_ARGUMENT,
+                              "Missing initial_info in first packet."));
+        return;
+      }
+      auto status = AddChip(peer_, request_, &chip_stream_);
+      if (!status.ok()) {
+        Finish(status);
+        return;
       }
-      // All kinds possible (bt, uwb, wifi), but each rpc only streames one.
-      if (chip_kind == common::ChipKind::BLUETOOTH) {
-        if (!request.has_hci_packet()) {
-          BtsLogWarn("grpc_server: unknown packet type from facade_id: %d",
-                     facade_id);
-          continue;
-        }
-        auto packet_type = request.hci_packet().packet_type();
-        auto packet =
-            ToSharedVec(request.mutable_hci_packet()->mutable_packet());
-        transport::HandleRequestCxx(chip_kind, facade_id, *packet, packet_type);
-      } else if (chip_kind == common::ChipKind::WIFI) {
-        if (!request.has_packet()) {
-          BtsLogWarn("grpc_server: unknown packet type from facade_id: %d",
-                     facade_id);
-          continue;
-        }
-        auto packet = ToSharedVec(request.mutable_packet());
-        transport::HandleRequestCxx(chip_kind, facade_id, *packet,
-                                    packet::HCIPacket::HCI_PACKET_UNSPECIFIED);
-#ifdef NETSIM_ANDROID_EMULATOR
-        // main_loop_wait is a non-blocking call where fds maintained by the
-        // WiFi service (slirp) are polled and serviced for I/O. When any fd
-        // become ready for I/O, slirp_pollfds_poll() will be invoked to read
-        // from the open sockets therefore incoming packets are serviced.
-        android::qemu2::libslirp_main_loop_wait(true);
-#endif
-      } else {
-        // TODO: add UWB here
-        BtsLogWarn("grpc_server: unknown chip_kind");
+      queue_ = std::make_unique<EgressQueue>(
+          egress_options_, chip_stream_.chip_kind,
+          GetEgressStats(chip_stream_.chip_kind, chip_stream_.facade_id));
+      sink_ = std::make_shared<ReactorSink>(this);
+      if (!ConnectChip(chip_stream_, sink_)) {
+        sink_->Detach();
+        RemoveChip(chip_stream_);
+        Finish(ConnectChipFailed(chip_stream_));
+        return;
       }
+      connected_ = true;
+      StartRead(&request_);
+      return;
     }
+    if (!ok) {
+      BtsLogWarn("grpc_server: reading stopped - facade_id: %d",
+                 chip_stream_.facade_id);
+      DisconnectChip(chip_stream_);
+      sink_->Detach();
+      RemoveChip(chip_stream_);
+      bool finish;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finishing_ = true;
+        queue_->Clear();
+        finish = TakeFinishLocked();
+      }
+      if (finish) Finish(::grpc::Status::OK);
+      return;
+    }
+    ProcessRequest(chip_stream_, &request_);
+    StartRead(&request_);
+  }
+
+  // Move the next queued packet into response_ and mark a write in flight.
+  // The caller starts the write after releasing mutex_, because reactions
+  // may run inline.
+  ::grpc::WriteOptions PrepareWriteLocked() {
+    queue_->Pop(pending_);
+    if (chip_stream_.chip_kind == common::ChipKind::BLUETOOTH) {
+      auto hci_packet = response_.mutable_hci_packet();
+      hci_packet->set_packet_type(pending_.packet_type);
+      hci_packet->mutable_packet()->swap(pending_.packet);
+    } else {
+      response_.mutable_packet()->swap(pending_.packet);
+    }
+    writing_ = true;
+    return queue_->Empty() ? ::grpc::WriteOptions()
+                           : ::grpc::WriteOptions().set_buffer_hint();
   }
+
+  // Finish may only be called once and not while a write is in flight.
+  bool TakeFinishLocked() {
+    if (writing_ || finish_started_) return false;
+    finish_started_ = true;
+    return true;
+  }
+
+  ::grpc::CallbackServerContext *const context_;
+  const std::string peer_;
+  const EgressOptions egress_options_;
+  RequestExecutor *const executor_;
+  ChipStream chip_stream_;
+  bool connected_ = false;
+  std::shared_ptr<ReactorSink> sink_;
+  packet::PacketRequest request_;
+
+  // Write side, guarded by mutex_. response_ is owned by the write in
+  // flight while writing_ is set.
+  std::mutex mutex_;
+  packet::PacketResponse response_;
+  // Created with the chip, before the sink.
+  std::unique_ptr<EgressQueue> queue_;
+  EgressQueue::Packet pending_;
+  bool writing_ = false;
+  bool write_failed_ = false;
+  bool finishing_ = false;
+  bool finish_started_ = false;
+};
+
+void ReactorSink::Enqueue(std::string packet,
+                          packet::HCIPacket_PacketType packet_type) {
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  if (reactor_) reactor_->Enqueue(std::move(packet), packet_type);
+}
+
+// Callback service handles the gRPC StreamPackets requests with reactors
+// scheduled on gRPC's callback executor instead of one thread per stream.
+
+class CallbackServiceImpl final
+    : public packet::PacketStreamer::CallbackService {
+ public:
+  explicit CallbackServiceImpl(const EgressOptions &egress_options)
+      : egress_options_(egress_options), executor_(kRequestThreads) {}
+
+  ::grpc::ServerBidiReactor<packet::PacketRequest, packet::PacketResponse> *
+  StreamPackets(::grpc::CallbackServerContext *context) override {
+    return new PacketStreamReactor(context, egress_options_, &executor_);
+  }
+
+ private:
+  // Enough that a chip waiting for the facades to start does not hold up
+  // the requests of the other streams.
+  static constexpr int kRequestThreads = 4;
+
+  const EgressOptions egress_options_;
+  RequestExecutor executor_;
 };
 }  // namespace
 
 // handle_response is called by packet_hub to forward a response to the gRPC
 // stream associated with chip_kind and facade_id.
 //
-// When writing, the packet is copied because is borrowed from a shared_ptr and
-// grpc++ doesn't know about smart pointers.
+// The packet is queued on the stream's sink and written asynchronously, so
+// the caller never blocks inside gRPC.
+void HandleResponse(ChipKind kind, uint32_t facade_id, std::string packet,
+                    packet::HCIPacket_PacketType packet_type) {
+  NETSIM_TRACE_SCOPE("HandleResponse");
+  if (!facade_to_stream.Enqueue(kind, facade_id, std::move(packet),
+                               packet_type)) {
+    BtsLogWarnRateLimited("grpc_server: no stream for facade_id: %d",
+                          facade_id);
+  }
+}
+
 void HandleResponse(ChipKind kind, uint32_t facade_id,
                     const std::vector<uint8_t> &packet,
                     packet::HCIPacket_PacketType packet_type) {
-  auto stream = facade_to_stream[ChipFacade(kind, facade_id)];
-  if (stream) {
-    // TODO: lock or caller here because gRPC does not allow overlapping writes.
-    packet::PacketResponse response;
-    // Copies the borrowed packet for output
-    auto str_packet = std::string(packet.begin(), packet.end());
-    if (kind == ChipKind::BLUETOOTH) {
-      response.mutable_hci_packet()->set_packet_type(packet_type);
-      response.mutable_hci_packet()->set_packet(str_packet);
-    } else {
-      response.set_packet(str_packet);
-    }
-    if (!stream->Write(response)) {
-      BtsLogWarn("grpc_server: write failed for facade_id: %d", facade_id);
-    }
-  } else {
-    BtsLogWarn("grpc_server: no stream for facade_id: %d", facade_id);
-  }
+  HandleResponse(kind, facade_id, std::string(packet.begin(), packet.end()),
+                 packet_type);
 }
 
 // for cxx
 void HandleResponseCxx(uint32_t kind, uint32_t facade_id,
-                       const rust::Vec<rust::u8> &packet,
+                       rust::Slice<const rust::u8> packet,
                        /* optional */ uint8_t packet_type) {
-  std::vector<uint8_t> vec(packet.begin(), packet.end());
-  HandleResponse(ChipKind(kind), facade_id, vec,
+  HandleResponse(ChipKind(kind), facade_id,
+                 std::string(packet.begin(), packet.end()),
                  packet::HCIPacket_PacketType(packet_type));
 }
 
+bool AddResponseSink(ChipKind kind, uint32_t facade_id,
+                     std::shared_ptr<PacketResponseSink> sink) {
+  return facade_to_stream.Add(kind, facade_id, std::move(sink));
+}
+
+void RemoveResponseSink(ChipKind kind, uint32_t facade_id) {
+  facade_to_stream.Remove(kind, facade_id);
+}
+
 }  // namespace backend
 
-std::unique_ptr<packet::PacketStreamer::Service> GetBackendService() {
-  return std::make_unique<backend::ServiceImpl>();
+std::unique_ptr<packet::PacketStreamer::Service> GetBackendService(
+    const config::GrpcServerOptions &options) {
+  return std::make_unique<backend::ServiceImpl>(
+      backend::EgressOptions::FromConfig(options));
+}
+
+std::unique_ptr<packet::PacketStreamer::CallbackService>
+GetBackendCallbackService(const config::GrpcServerOptions &options) {
+  return std::make_unique<backend::CallbackServiceImpl>(
+      backend::EgressOptions::FromConfig(options));
 }
 }  // namespace netsim
@@ -23,9 +23,17 @@
 #include <memory>
 #include <utility>
 
+#include "netsim/config.pb.h"
 #include "netsim/packet_streamer.grpc.pb.h"
 
 namespace netsim {
-std::unique_ptr<packet::PacketStreamer::Service> GetBackendService();
+// The egress options bound the packets queued for each stream.
+std::unique_ptr<packet::PacketStreamer::Service> GetBackendService(
+    const config::GrpcServerOptions &options);
+
+// PacketStreamer on the gRPC callback API. Streams are served by reactors
+// instead of holding a server thread each.
+std::unique_ptr<packet::PacketStreamer::CallbackService>
+GetBackendCallbackService(const config::GrpcServerOptions &options);
 
 }  // namespace netsim
@@ -0,0 +1,111 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/packet_response_writer.h"
+
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "backend/egress_queue.h"
+#include "grpcpp/server_context.h"
+#include "util/log.h"
+
+namespace netsim {
+namespace backend {
+
+PacketResponseWriter::PacketResponseWriter(Stream *stream,
+                                           ::grpc::ServerContext *context,
+                                           common::ChipKind chip_kind,
+                                           uint32_t facade_id,
+                                           const EgressOptions &options)
+    : stream_(stream),
+      context_(context),
+      chip_kind_(chip_kind),
+      facade_id_(facade_id),
+      queue_(options, chip_kind, GetEgressStats(chip_kind, facade_id)),
+      thread_([this] { WriteLoop(); }) {}
+
+PacketResponseWriter::~PacketResponseWriter() { Stop(); }
+
+void PacketResponseWriter::Enqueue(std::string packet,
+                                   packet::HCIPacket_PacketType packet_type) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) return;
+    auto result = queue_.Push(std::move(packet), packet_type,
+                              EgressQueue::Clock::now());
+    if (result == EgressQueue::PushResult::kDropped) return;
+    if (result == EgressQueue::PushResult::kStalled) {
+      BtsLogWarn("grpc_server: stream stalled, cancelling facade_id: %d",
+                 facade_id_);
+      // Fails the blocked write and the read, ending StreamPackets. The
+      // context stays valid until Stop.
+      context_->TryCancel();
+      return;
+    }
+  }
+  cv_.notify_one();
+}
+
+void PacketResponseWriter::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  cv_.notify_one();
+  if (thread_.joinable()) thread_.join();
+}
+
+void PacketResponseWriter::WriteLoop() {
+  // Reused for every write to avoid re-allocating the message.
+  packet::PacketResponse response;
+  EgressQueue::Packet pending;
+  bool write_failed = false;
+
+  while (true) {
+    bool last;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cv_.wait(lock, [this] { return stopped_ || !queue_.Empty(); });
+      // Stopped and drained.
+      if (!queue_.Pop(pending)) return;
+      last = queue_.Empty();
+    }
+
+    // The stream is broken; drop the rest until the reader notices.
+    if (!write_failed) {
+      if (chip_kind_ == common::ChipKind::BLUETOOTH) {
+        auto hci_packet = response.mutable_hci_packet();
+        hci_packet->set_packet_type(pending.packet_type);
+        hci_packet->mutable_packet()->swap(pending.packet);
+      } else {
+        response.mutable_packet()->swap(pending.packet);
+      }
+      // Only the last write of what is queued flushes.
+      auto options = last ? ::grpc::WriteOptions()
+                          : ::grpc::WriteOptions().set_buffer_hint();
+      if (!stream_->Write(response, options)) {
+        BtsLogWarn("grpc_server: write failed for facade_id: %d", facade_id_);
+        write_failed = true;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.WriteDone(EgressQueue::Clock::now());
+  }
+}
+
+}  // namespace backend
+}  // namespace netsim
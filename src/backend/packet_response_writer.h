@@ -0,0 +1,98 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Serialized, batched egress for one PacketStreamer stream.
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "backend/egress_queue.h"
+#include "grpcpp/server_context.h"
+#include "netsim/common.pb.h"
+#include "netsim/hci_packet.pb.h"
+#include "netsim/packet_streamer.grpc.pb.h"
+#include "netsim/packet_streamer.pb.h"
+
+namespace netsim {
+namespace backend {
+
+// Destination for packets sent to a PacketStreamer peer.
+class PacketResponseSink {
+ public:
+  virtual ~PacketResponseSink() = default;
+
+  // Queue a packet for the peer. Ownership of the payload is taken.
+  virtual void Enqueue(std::string packet,
+                       packet::HCIPacket_PacketType packet_type) = 0;
+};
+
+/**
+ * @class PacketResponseWriter
+ *
+ * Owns the write side of a PacketStreamer stream.
+ *
+ * Producers enqueue packets from any thread and return immediately. A single
+ * writer thread drains the queue, so gRPC never sees overlapping writes.
+ * Packets are written back to back: every write but the last of the queue
+ * carries the buffer hint so gRPC can coalesce them into fewer transport
+ * writes.
+ *
+ * The queue is bounded by the EgressOptions. A peer that stops reading has
+ * its call cancelled after the stall timeout, which ends StreamPackets.
+ */
+class PacketResponseWriter : public PacketResponseSink {
+ public:
+  using Stream = ::grpc::ServerReaderWriter<packet::PacketResponse,
+                                            packet::PacketRequest>;
+
+  PacketResponseWriter(Stream *stream, ::grpc::ServerContext *context,
+                       common::ChipKind chip_kind, uint32_t facade_id,
+                       const EgressOptions &options);
+  ~PacketResponseWriter() override;
+
+  PacketResponseWriter(const PacketResponseWriter &) = delete;
+  PacketResponseWriter &operator=(const PacketResponseWriter &) = delete;
+
+  void Enqueue(std::string packet,
+               packet::HCIPacket_PacketType packet_type) override;
+
+  // Write out what is queued and join the writer thread. Must be called
+  // before the stream is destroyed.
+  void Stop();
+
+ private:
+  void WriteLoop();
+
+  Stream *stream_;
+  ::grpc::ServerContext *context_;
+  const common::ChipKind chip_kind_;
+  const uint32_t facade_id_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  EgressQueue queue_;
+  bool stopped_ = false;
+
+  std::thread thread_;
+};
+
+}  // namespace backend
+}  // namespace netsim
@@ -14,10 +14,11 @@
 
 #include "backend/packet_streamer_client.h"
 
+#include <algorithm>
 #include <chrono>
 #include <mutex>
 #include <optional>
-#include <thread>
+#include <vector>
 #ifdef _WIN32
 #include <Windows.h>
 #else
@@ -30,6 +31,8 @@
 #include "grpcpp/channel.h"
 #include "grpcpp/create_channel.h"
 #include "grpcpp/security/credentials.h"
+#include "util/file_watcher.h"
+#include "util/filesystem.h"
 #include "util/log.h"
 #include "util/os_utils.h"
 #include "util/string_utils.h"
@@ -40,12 +43,40 @@ namespace netsim::packet {
 namespace {
 
 const std::chrono::duration kConnectionDeadline = std::chrono::seconds(1);
+// How often to check whether netsimd is ready while it starts, when the
+// discovery directory can not be watched.
+const std::chrono::duration kReadyPollInterval = std::chrono::milliseconds(50);
+// Longest wait for a change of the discovery directory. Changes wake the
+// wait right away; this only bounds the netsimd relaunch checks.
+const std::chrono::duration kReadyWatchTimeout = std::chrono::seconds(1);
+// How long to wait for netsimd to start.
+const std::chrono::duration kStartupDeadline = std::chrono::seconds(15);
+constexpr int kMaxNetsimdLaunches = 4;
+
 std::string custom_packet_stream_endpoint = "";
-std::shared_ptr<grpc::Channel> packet_stream_channel;
+size_t packet_stream_pool_size = 1;
+// Streams are placed round-robin on the channels of the pool.
+std::vector<std::shared_ptr<grpc::Channel>> packet_stream_channels;
+size_t next_channel = 0;
 std::mutex channel_mutex;
 
-std::shared_ptr<grpc::Channel> CreateGrpcChannel() {
+// Returns true once netsimd has written its port to the ini file. Checked
+// without logging so it can be polled.
+bool ServerAddressReady() {
+  if (!custom_packet_stream_endpoint.empty()) return true;
+  return netsim::filesystem::exists(netsim::osutils::GetNetsimIniFilepath(0));
+}
+
+std::shared_ptr<grpc::Channel> CreateGrpcChannel(size_t index) {
   auto endpoint = custom_packet_stream_endpoint;
+#ifndef _WIN32
+  // Prefer the unix domain socket of a local netsimd to the TCP loopback.
+  if (endpoint.empty()) {
+    auto uds_path = netsim::osutils::GetServerUdsPath();
+    if (uds_path.has_value() && netsim::filesystem::exists(uds_path.value()))
+      endpoint = "unix:" + uds_path.value();
+  }
+#endif
   if (endpoint.empty()) {
     auto port = netsim::osutils::GetServerAddress();
     if (!port.has_value()) return nullptr;
@@ -60,11 +91,27 @@ std::shared_ptr<grpc::Channel> CreateGrpcChannel() {
       interceptors;
   interceptors.emplace_back(std::make_unique<MetricsInterceptorFactory>());
   grpc::ChannelArguments args;
+  if (packet_stream_pool_size > 1) {
+    // Channels with a local subchannel pool do not share their connection,
+    // each channel of the pool has its own HTTP/2 connection.
+    args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+    args.SetInt("netsim.channel_index", index);
+  }
   return grpc::experimental::CreateCustomChannelWithInterceptors(
       endpoint, grpc::InsecureChannelCredentials(), args,
       std::move(interceptors));
 }
 
+std::vector<std::shared_ptr<grpc::Channel>> CreateGrpcChannels() {
+  std::vector<std::shared_ptr<grpc::Channel>> channels;
+  for (size_t i = 0; i < packet_stream_pool_size; ++i) {
+    auto channel = CreateGrpcChannel(i);
+    if (!channel) return {};
+    channels.push_back(std::move(channel));
+  }
+  return channels;
+}
+
 bool GrpcChannelReady(const std::shared_ptr<grpc::Channel> &channel) {
   if (channel) {
     auto deadline = std::chrono::system_clock::now() + kConnectionDeadline;
@@ -100,25 +147,46 @@ void SetPacketStreamEndpoint(const std::string &endpoint) {
   if (endpoint != "default") custom_packet_stream_endpoint = endpoint;
 }
 
+void SetPacketStreamChannelPoolSize(size_t size) {
+  std::lock_guard<std::mutex> lock(channel_mutex);
+  packet_stream_pool_size = std::max<size_t>(size, 1);
+  packet_stream_channels.clear();
+}
+
 std::shared_ptr<grpc::Channel> GetChannel(NetsimdOptions options) {
   std::lock_guard<std::mutex> lock(channel_mutex);
 
-  // bool is_netsimd_started = false;
   std::unique_ptr<android::base::ObservableProcess> netsimProc;
-  for (int second : {1, 2, 4, 8}) {
-    if (!packet_stream_channel) packet_stream_channel = CreateGrpcChannel();
-    if (GrpcChannelReady(packet_stream_channel)) return packet_stream_channel;
-
-    packet_stream_channel.reset();
+  int launches = 0;
+  auto deadline = std::chrono::steady_clock::now() + kStartupDeadline;
+  // Notified when netsimd writes its discovery file.
+  util::DirectoryWatcher watcher(netsim::osutils::GetDiscoveryDirectory());
+  auto wait = watcher.IsWatching()
+                  ? std::chrono::milliseconds(kReadyWatchTimeout)
+                  : std::chrono::milliseconds(kReadyPollInterval);
+  while (true) {
+    if (packet_stream_channels.empty() && ServerAddressReady()) {
+      packet_stream_channels = CreateGrpcChannels();
+    }
+    if (!packet_stream_channels.empty()) {
+      auto index = next_channel++ % packet_stream_channels.size();
+      auto &channel = packet_stream_channels[index];
+      if (GrpcChannelReady(channel)) return channel;
+      packet_stream_channels.clear();
+    }
+    if (std::chrono::steady_clock::now() >= deadline) break;
 
     if ((!netsimProc || !netsimProc->isAlive()) &&
-        custom_packet_stream_endpoint.empty()) {
+        custom_packet_stream_endpoint.empty() &&
+        launches < kMaxNetsimdLaunches) {
       BtsLogInfo("Starting netsim since %s",
                  netsimProc ? "the process died" : "it is not yet launched");
       netsimProc = RunNetsimd(options);
+      ++launches;
     }
-    BtsLogInfo("Retry connecting to netsim in %d second.", second);
-    std::this_thread::sleep_for(std::chrono::seconds(second));
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    watcher.Wait(std::min(wait, remaining));
   }
 
   BtsLogError("Unable to get a packet stream channel.");
@@ -55,6 +55,11 @@ struct NetsimdOptions {
 // Configure the endpoint for a server other than the local netsimd server.
 void SetPacketStreamEndpoint(const std::string &endpoint);
 
+// Configure the number of connections to the server, 1 by default. Each
+// CreateChannel call returns the next channel of the pool so that streams,
+// e.g. of high bandwidth WiFi, do not share one HTTP/2 connection.
+void SetPacketStreamChannelPoolSize(size_t size);
+
 std::shared_ptr<grpc::Channel> CreateChannel(NetsimdOptions);
 
 // Deprecated.
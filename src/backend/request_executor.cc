@@ -0,0 +1,56 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/request_executor.h"
+
+#include <functional>
+#include <thread>
+#include <utility>
+
+#include "util/thread_affinity.h"
+
+namespace netsim {
+namespace backend {
+
+RequestExecutor::RequestExecutor(int num_threads) {
+  for (int i = 0; i < num_threads; i++) {
+    threads_.emplace_back([this] { RunLoop(); });
+  }
+}
+
+RequestExecutor::~RequestExecutor() { Stop(); }
+
+void RequestExecutor::Post(std::function<void()> task) {
+  tasks_.Push(std::move(task));
+}
+
+void RequestExecutor::Stop() {
+  tasks_.Stop();
+  for (auto &thread : threads_) {
+    if (thread.joinable()) thread.join();
+  }
+}
+
+void RequestExecutor::RunLoop() {
+  util::SetUpThread(util::ThreadClass::kGrpc, "grpc_requests");
+  std::function<void()> task;
+  while (tasks_.WaitAndPop(task)) {
+    task();
+    // Release what the task captured before waiting for the next one.
+    task = nullptr;
+  }
+}
+
+}  // namespace backend
+}  // namespace netsim
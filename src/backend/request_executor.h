@@ -0,0 +1,60 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// Threads for the work of the StreamPackets reactors that may block.
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "util/blocking_queue.h"
+
+namespace netsim {
+namespace backend {
+
+/**
+ * @class RequestExecutor
+ *
+ * Runs tasks on a fixed set of threads, in the order they are posted.
+ *
+ * gRPC callback reactions must not block, but adding a chip waits for the
+ * facades to start and a request may wait in a facade. The reactors post
+ * that work here, and start their next read when it is done, so the
+ * requests of one stream still run one at a time and in order.
+ */
+class RequestExecutor {
+ public:
+  explicit RequestExecutor(int num_threads);
+  ~RequestExecutor();
+
+  RequestExecutor(const RequestExecutor &) = delete;
+  RequestExecutor &operator=(const RequestExecutor &) = delete;
+
+  // Queue a task. Tasks posted after Stop are dropped.
+  void Post(std::function<void()> task);
+
+  // Drop the queued tasks and join the threads once their tasks are done.
+  void Stop();
+
+ private:
+  void RunLoop();
+
+  util::BlockingQueue<std::function<void()>> tasks_;
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace backend
+}  // namespace netsim
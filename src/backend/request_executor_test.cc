@@ -0,0 +1,85 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the RequestExecutor class.
+#include "backend/request_executor.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using backend::RequestExecutor;
+
+TEST(RequestExecutorTest, RunsTasksOffTheCallerInOrder) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::vector<int> order;
+  bool other_thread = true;
+  auto caller = std::this_thread::get_id();
+  RequestExecutor executor(1);
+  for (int i = 0; i < 3; i++) {
+    executor.Post([&, i] {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (std::this_thread::get_id() == caller) other_thread = false;
+      order.push_back(i);
+      cv.notify_one();
+    });
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&] { return order.size() == 3; });
+  EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+  EXPECT_TRUE(other_thread);
+}
+
+TEST(RequestExecutorTest, BlockedTaskDoesNotHoldTheOthers) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool release = false;
+  bool ran = false;
+  // Declared last, so the tasks finish before what they use is destroyed.
+  RequestExecutor executor(2);
+  executor.Post([&] {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&] { return release; });
+  });
+  executor.Post([&] {
+    std::lock_guard<std::mutex> lock(mutex);
+    ran = true;
+    cv.notify_all();
+  });
+  std::unique_lock<std::mutex> lock(mutex);
+  cv.wait(lock, [&] { return ran; });
+  release = true;
+  cv.notify_all();
+}
+
+TEST(RequestExecutorTest, DropsTasksPostedAfterStop) {
+  bool ran = false;
+  RequestExecutor executor(1);
+  executor.Stop();
+  executor.Post([&] { ran = true; });
+  executor.Stop();
+  EXPECT_FALSE(ran);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
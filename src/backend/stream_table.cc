@@ -0,0 +1,112 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "backend/stream_table.h"
+
+#include <thread>
+#include <utility>
+
+#include "util/log.h"
+
+namespace netsim {
+namespace backend {
+
+StreamTable::~StreamTable() {
+  // The current directory of a kind holds all of its chunks.
+  for (auto &directory : directories_) {
+    auto current = directory.load();
+    if (!current) continue;
+    for (size_t i = 0; i < current->size; i++) delete current->chunks[i];
+  }
+}
+
+StreamTable::Slot *StreamTable::FindSlot(common::ChipKind kind,
+                                         uint32_t facade_id) const {
+  if (kind < 0 || static_cast<size_t>(kind) >= kNumChipKinds) return nullptr;
+  auto directory = directories_[kind].load(std::memory_order_acquire);
+  size_t chunk_index = facade_id / kChunkSize;
+  if (!directory || chunk_index >= directory->size) return nullptr;
+  auto chunk = directory->chunks[chunk_index].load(std::memory_order_acquire);
+  return chunk ? &(*chunk)[facade_id % kChunkSize] : nullptr;
+}
+
+StreamTable::Directory &StreamTable::GrowLocked(common::ChipKind kind,
+                                                size_t chunk_index) {
+  auto current = directories_[kind].load(std::memory_order_relaxed);
+  if (current && chunk_index < current->size) return *current;
+  size_t size = current ? current->size : kInitialChunks;
+  while (size <= chunk_index) size *= 2;
+  auto grown = std::make_unique<Directory>(size);
+  if (current) {
+    for (size_t i = 0; i < current->size; i++) {
+      grown->chunks[i].store(current->chunks[i].load(std::memory_order_relaxed),
+                             std::memory_order_relaxed);
+    }
+  }
+  directories_[kind].store(grown.get(), std::memory_order_release);
+  all_directories_.push_back(std::move(grown));
+  return *all_directories_.back();
+}
+
+bool StreamTable::Add(common::ChipKind kind, uint32_t facade_id,
+                      std::shared_ptr<PacketResponseSink> sink) {
+  if (kind < 0 || static_cast<size_t>(kind) >= kNumChipKinds) {
+    BtsLogError("stream_table: chip_kind %d out of range for facade_id %d",
+                kind, facade_id);
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &chunk =
+      GrowLocked(kind, facade_id / kChunkSize).chunks[facade_id / kChunkSize];
+  if (chunk.load(std::memory_order_relaxed) == nullptr) {
+    chunk.store(new Chunk(), std::memory_order_release);
+  }
+  auto &slot = (*chunk.load(std::memory_order_relaxed))[facade_id % kChunkSize];
+  if (slot.owner) {
+    BtsLogWarn("stream_table: replacing stream for facade_id: %d", facade_id);
+  }
+  auto previous = std::move(slot.owner);
+  slot.owner = std::move(sink);
+  slot.sink.store(slot.owner.get());
+  // Wait for readers of the previous sink before releasing it.
+  while (previous && slot.readers.load() != 0) std::this_thread::yield();
+  return true;
+}
+
+void StreamTable::Remove(common::ChipKind kind, uint32_t facade_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto slot = FindSlot(kind, facade_id);
+  if (slot == nullptr) return;
+  slot->sink.store(nullptr);
+  while (slot->readers.load() != 0) std::this_thread::yield();
+  slot->owner.reset();
+}
+
+bool StreamTable::Enqueue(common::ChipKind kind, uint32_t facade_id,
+                          std::string packet,
+                          packet::HCIPacket_PacketType packet_type) {
+  auto slot = FindSlot(kind, facade_id);
+  if (slot == nullptr) return false;
+  // Both sides use sequentially consistent operations: the reader announces
+  // itself before loading the sink and Remove clears the sink before
+  // checking for readers, so one of them always sees the other.
+  slot->readers.fetch_add(1);
+  auto sink = slot->sink.load();
+  if (sink) sink->Enqueue(std::move(packet), packet_type);
+  slot->readers.fetch_sub(1);
+  return sink != nullptr;
+}
+
+}  // namespace backend
+}  // namespace netsim
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Dense table from <chip kind, facade id> to the sink of a PacketStreamer.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "backend/packet_response_writer.h"
+#include "netsim/common.pb.h"
+#include "netsim/hci_packet.pb.h"
+
+namespace netsim {
+namespace backend {
+
+/**
+ * @class StreamTable
+ *
+ * Slots are indexed directly by chip kind and facade id and allocated in
+ * fixed size chunks that are never moved or freed, so a lookup is two
+ * array indexings and no allocation. Facade ids only grow, so the directory
+ * of the chunks of a kind doubles when an id is past its end; the replaced
+ * directories are kept until the table is destroyed, as lock-free readers
+ * may still be using them.
+ *
+ * Enqueue is lock-free: a reader announces itself on the slot and loads the
+ * sink pointer. Remove clears the pointer and waits for the announced
+ * readers to leave before dropping its reference, so a sink is never
+ * destroyed while a reader is using it. Add and Remove are serialized with
+ * a mutex; they happen once per stream.
+ */
+class StreamTable {
+ public:
+  static constexpr size_t kNumChipKinds = common::ChipKind_ARRAYSIZE;
+  static constexpr size_t kChunkSize = 256;
+  // Chunks of the first directory of a kind.
+  static constexpr size_t kInitialChunks = 16;
+
+  StreamTable() = default;
+  ~StreamTable();
+
+  StreamTable(const StreamTable &) = delete;
+  StreamTable &operator=(const StreamTable &) = delete;
+
+  // Returns false if kind is out of range.
+  bool Add(common::ChipKind kind, uint32_t facade_id,
+           std::shared_ptr<PacketResponseSink> sink);
+
+  void Remove(common::ChipKind kind, uint32_t facade_id);
+
+  // Queue a packet on the sink. Returns false if there is no sink.
+  bool Enqueue(common::ChipKind kind, uint32_t facade_id, std::string packet,
+               packet::HCIPacket_PacketType packet_type);
+
+ private:
+  struct Slot {
+    std::atomic<PacketResponseSink *> sink{nullptr};
+    std::atomic<uint32_t> readers{0};
+    // Keeps sink alive, guarded by mutex_.
+    std::shared_ptr<PacketResponseSink> owner;
+  };
+
+  using Chunk = std::array<Slot, kChunkSize>;
+
+  struct Directory {
+    explicit Directory(size_t size)
+        : size(size), chunks(new std::atomic<Chunk *>[size]()) {}
+    const size_t size;
+    std::unique_ptr<std::atomic<Chunk *>[]> chunks;
+  };
+
+  Slot *FindSlot(common::ChipKind kind, uint32_t facade_id) const;
+  // Returns the directory of kind with room for chunk_index.
+  Directory &GrowLocked(common::ChipKind kind, size_t chunk_index);
+
+  std::mutex mutex_;
+  std::array<std::atomic<Directory *>, kNumChipKinds> directories_{};
+  // Every directory allocated, guarded by mutex_.
+  std::vector<std::unique_ptr<Directory>> all_directories_;
+};
+
+}  // namespace backend
+}  // namespace netsim
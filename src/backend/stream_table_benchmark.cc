@@ -0,0 +1,68 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of backend::HandleResponse through the stream table of the gRPC
+// server.
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "backend/backend_packet_hub.h"
+#include "backend/packet_response_writer.h"
+#include "benchmark/benchmark.h"
+#include "util/benchmark_counters.h"
+
+namespace netsim::backend {
+namespace {
+
+using common::ChipKind;
+
+class CountingSink : public PacketResponseSink {
+ public:
+  void Enqueue(std::string packet,
+               packet::HCIPacket_PacketType packet_type) override {
+    benchmark::DoNotOptimize(packet.data());
+    count++;
+  }
+  int64_t count = 0;
+};
+
+// HandleResponse copies the payload of rootcanal into a string and queues it
+// on the stream of the chip, here a sink that only counts. Arg: number of
+// streams, responses go to them in turn.
+void BM_HandleResponse(benchmark::State &state) {
+  const uint32_t streams = state.range(0);
+  auto sink = std::make_shared<CountingSink>();
+  for (uint32_t facade_id = 0; facade_id < streams; facade_id++) {
+    AddResponseSink(ChipKind::BLUETOOTH, facade_id, sink);
+  }
+  // HCI Command Complete event of a Reset.
+  const std::vector<uint8_t> event = {0x0e, 0x04, 0x01, 0x03, 0x0c, 0x00};
+  uint32_t facade_id = 0;
+  for (auto _ : state) {
+    HandleResponse(ChipKind::BLUETOOTH, facade_id, event,
+                   packet::HCIPacket::EVENT);
+    if (++facade_id == streams) facade_id = 0;
+  }
+  for (uint32_t id = 0; id < streams; id++) {
+    RemoveResponseSink(ChipKind::BLUETOOTH, id);
+  }
+  util::SetPacketCounters(state, sink->count);
+}
+
+BENCHMARK(BM_HandleResponse)->Arg(1)->Arg(64)->Arg(1024);
+
+}  // namespace
+}  // namespace netsim::backend
@@ -0,0 +1,120 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the StreamTable class.
+#include "backend/stream_table.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim::backend {
+namespace {
+
+using common::ChipKind;
+
+class CountingSink : public PacketResponseSink {
+ public:
+  void Enqueue(std::string packet,
+               packet::HCIPacket_PacketType packet_type) override {
+    count++;
+    last_packet = std::move(packet);
+  }
+  std::atomic<int> count{0};
+  std::string last_packet;
+};
+
+TEST(StreamTableTest, AddAndEnqueue) {
+  StreamTable table;
+  auto sink = std::make_shared<CountingSink>();
+  ASSERT_TRUE(table.Add(ChipKind::BLUETOOTH, 3, sink));
+
+  EXPECT_TRUE(table.Enqueue(ChipKind::BLUETOOTH, 3, "hci",
+                            packet::HCIPacket::EVENT));
+  EXPECT_EQ(sink->count, 1);
+  EXPECT_EQ(sink->last_packet, "hci");
+
+  // Same facade id of another kind is a different slot.
+  EXPECT_FALSE(table.Enqueue(ChipKind::WIFI, 3, "wifi",
+                             packet::HCIPacket::HCI_PACKET_UNSPECIFIED));
+  EXPECT_EQ(sink->count, 1);
+}
+
+TEST(StreamTableTest, RemoveDropsSink) {
+  StreamTable table;
+  auto sink = std::make_shared<CountingSink>();
+  ASSERT_TRUE(table.Add(ChipKind::WIFI, 2000, sink));
+  table.Remove(ChipKind::WIFI, 2000);
+
+  EXPECT_FALSE(table.Enqueue(ChipKind::WIFI, 2000, "wifi",
+                             packet::HCIPacket::HCI_PACKET_UNSPECIFIED));
+  EXPECT_EQ(sink->count, 0);
+  EXPECT_EQ(sink.use_count(), 1);
+}
+
+TEST(StreamTableTest, OutOfRange) {
+  StreamTable table;
+  auto sink = std::make_shared<CountingSink>();
+  auto bad_kind = static_cast<ChipKind>(StreamTable::kNumChipKinds);
+  EXPECT_FALSE(table.Add(bad_kind, 1, sink));
+  EXPECT_FALSE(table.Enqueue(bad_kind, 1, "hci", packet::HCIPacket::EVENT));
+  EXPECT_FALSE(table.Enqueue(ChipKind::BLUETOOTH, 1 << 30, "hci",
+                             packet::HCIPacket::EVENT));
+  // Removing an unknown slot is a no-op.
+  table.Remove(ChipKind::UWB, 42);
+  table.Remove(ChipKind::UWB, 1 << 30);
+}
+
+TEST(StreamTableTest, GrowsForLargeFacadeIds) {
+  StreamTable table;
+  auto early = std::make_shared<CountingSink>();
+  auto late = std::make_shared<CountingSink>();
+  ASSERT_TRUE(table.Add(ChipKind::BLUETOOTH, 7, early));
+  // Past the initial directory and the former fixed cap of 65536 ids.
+  ASSERT_TRUE(table.Add(ChipKind::BLUETOOTH, 100000, late));
+
+  EXPECT_TRUE(table.Enqueue(ChipKind::BLUETOOTH, 7, "hci",
+                            packet::HCIPacket::EVENT));
+  EXPECT_TRUE(table.Enqueue(ChipKind::BLUETOOTH, 100000, "hci",
+                            packet::HCIPacket::EVENT));
+  EXPECT_EQ(early->count, 1);
+  EXPECT_EQ(late->count, 1);
+}
+
+TEST(StreamTableTest, RemoveWhileEnqueueing) {
+  StreamTable table;
+  std::atomic<bool> done{false};
+  std::thread reader([&] {
+    while (!done) {
+      table.Enqueue(ChipKind::BLUETOOTH, 1, "hci", packet::HCIPacket::ACL);
+    }
+  });
+  for (int i = 0; i < 1000; i++) {
+    auto sink = std::make_shared<CountingSink>();
+    std::weak_ptr<CountingSink> weak = sink;
+    table.Add(ChipKind::BLUETOOTH, 1, std::move(sink));
+    table.Remove(ChipKind::BLUETOOTH, 1);
+    // Once removed no reader holds the sink.
+    EXPECT_TRUE(weak.expired());
+  }
+  done = true;
+  reader.join();
+}
+
+}  // namespace
+}  // namespace netsim::backend
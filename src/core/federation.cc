@@ -0,0 +1,387 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/federation.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/federation_batch.h"
+#include "grpcpp/client_context.h"
+#include "grpcpp/create_channel.h"
+#include "grpcpp/security/credentials.h"
+#include "grpcpp/server_context.h"
+#include "grpcpp/support/status.h"
+#include "grpcpp/support/sync_stream.h"
+#include "hci/bluetooth_facade.h"
+#include "netsim/config.pb.h"
+#include "netsim/federation.grpc.pb.h"
+#include "netsim/federation.pb.h"
+#include "util/log.h"
+#include "util/thread_affinity.h"
+#include "wifi/wifi_packet_hub.h"
+
+namespace netsim::federation {
+namespace {
+
+constexpr std::chrono::microseconds kDefaultFlushInterval(500);
+constexpr size_t kDefaultMaxBatchBytes = 64 << 10;
+// Traffic queued for a peer whose stream does not keep up is dropped past
+// this many batches.
+constexpr size_t kMaxQueuedBatches = 8;
+constexpr std::chrono::seconds kRedialInterval(1);
+constexpr uint32_t kUnknownNode = kAllNodes;
+
+// Set by Start before started_, read-only while started.
+std::atomic<bool> started_{false};
+uint32_t node_id_ = 0;
+uint32_t wifi_node_id_ = 0;
+std::chrono::microseconds flush_interval_ = kDefaultFlushInterval;
+size_t max_batch_bytes_ = kDefaultMaxBatchBytes;
+
+// One direction of the traffic with a peer node: the packets queued by the
+// facades are batched and written to the stream by the writer thread of the
+// link.
+class Link {
+ public:
+  explicit Link(std::function<void()> cancel)
+      : builder_(node_id_, max_batch_bytes_), cancel_(std::move(cancel)) {}
+
+  uint32_t NodeId() const {
+    return peer_node_id_.load(std::memory_order_acquire);
+  }
+
+  // Sets the node of the peer from its first batch. Returns false if the
+  // batch is not from that node.
+  bool SetNodeId(uint32_t node_id) {
+    auto expected = kUnknownNode;
+    return peer_node_id_.compare_exchange_strong(expected, node_id,
+                                                 std::memory_order_acq_rel) ||
+           expected == node_id;
+  }
+
+  void AddPhyPacket(uint32_t phy_type, uint32_t device_id,
+                    const std::optional<BatchBuilder::Position> &position,
+                    int8_t tx_power, const std::vector<uint8_t> &packet) {
+    Add([&] {
+      return builder_.AddPhyPacket(phy_type, device_id, position, tx_power,
+                                   packet.data(), packet.size());
+    });
+  }
+
+  void AddWifiFrame(const uint8_t *data, size_t size) {
+    Add([&] { return builder_.AddWifiFrame(data, size); });
+  }
+
+  // Writes a first batch naming this node, then the batches of the traffic
+  // until Close or a failed write.
+  void WriteLoop(const std::function<bool(const Batch &)> &write) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto hello = builder_.Take();
+    lock.unlock();
+    if (!write(hello)) return;
+    lock.lock();
+    while (true) {
+      cv_.wait(lock, [this] { return closed_ || !builder_.Empty(); });
+      if (closed_) return;
+      // Let the traffic of the next flush interval join the batch.
+      cv_.wait_for(lock, flush_interval_,
+                   [this] { return closed_ || full_; });
+      if (closed_) return;
+      auto batch = builder_.Take();
+      full_ = false;
+      lock.unlock();
+      if (!write(batch)) return;
+      lock.lock();
+    }
+  }
+
+  // Stops the writer and cancels the stream.
+  void Close() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_) return;
+      closed_ = true;
+    }
+    cv_.notify_all();
+    cancel_();
+  }
+
+ private:
+  // Runs add, which returns whether the batch is full, unless the writer is
+  // too far behind.
+  template <class F>
+  void Add(F &&add) {
+    bool notify;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (closed_) return;
+      if (builder_.Bytes() >= kMaxQueuedBatches * max_batch_bytes_) {
+        BtsLogWarnRateLimited("Dropping traffic to federation node %u",
+                              NodeId());
+        return;
+      }
+      notify = builder_.Empty();
+      full_ = add() || full_;
+      notify = notify || full_;
+    }
+    if (notify) cv_.notify_one();
+  }
+
+  std::atomic<uint32_t> peer_node_id_{kUnknownNode};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  BatchBuilder builder_;
+  bool full_ = false;
+  bool closed_ = false;
+  const std::function<void()> cancel_;
+};
+
+// The links, replaced whole under links_mutex_ and read with atomic_load so
+// the packet paths do not lock.
+std::mutex links_mutex_;
+std::shared_ptr<const std::vector<std::shared_ptr<Link>>> links_ =
+    std::make_shared<std::vector<std::shared_ptr<Link>>>();
+
+// Returns false if the peer is already linked, or federation is stopped.
+bool AddLink(const std::shared_ptr<Link> &link) {
+  std::lock_guard<std::mutex> lock(links_mutex_);
+  if (!started_.load(std::memory_order_acquire)) return false;
+  for (const auto &other : *links_) {
+    if (other->NodeId() == link->NodeId()) return false;
+  }
+  auto links = std::make_shared<std::vector<std::shared_ptr<Link>>>(*links_);
+  links->push_back(link);
+  std::atomic_store(&links_,
+                    std::shared_ptr<const std::vector<std::shared_ptr<Link>>>(
+                        std::move(links)));
+  return true;
+}
+
+void RemoveLink(const std::shared_ptr<Link> &link) {
+  std::lock_guard<std::mutex> lock(links_mutex_);
+  auto links = std::make_shared<std::vector<std::shared_ptr<Link>>>(*links_);
+  links->erase(std::remove(links->begin(), links->end(), link), links->end());
+  std::atomic_store(&links_,
+                    std::shared_ptr<const std::vector<std::shared_ptr<Link>>>(
+                        std::move(links)));
+}
+
+std::shared_ptr<const std::vector<std::shared_ptr<Link>>> Links() {
+  return std::atomic_load(&links_);
+}
+
+void HandleBatch(uint32_t node_id, const Batch &batch) {
+  if (batch.positions_size() != 0 || batch.phy_packets_size() != 0) {
+    hci::facade::HandleFederatedBatch(node_id, batch);
+  }
+  for (const auto &frame : batch.wifi_frames()) {
+    wifi::HandleFederatedWifiFrame(
+        node_id, reinterpret_cast<const uint8_t *>(frame.data()),
+        frame.size());
+  }
+}
+
+// Exchanges the traffic with a peer over a stream, ServerReaderWriter or
+// ClientReaderWriter, until either side closes it.
+template <class Stream, class Context>
+void RunLink(Stream &stream, Context &context, const std::string &peer) {
+  auto link = std::make_shared<Link>([&context] { context.TryCancel(); });
+  std::thread writer([&stream, link] {
+    util::SetUpThread(util::ThreadClass::kBackground, "fed_writer");
+    link->WriteLoop([&stream](const Batch &batch) {
+      return stream.Write(batch);
+    });
+  });
+  bool linked = false;
+  Batch batch;
+  while (stream.Read(&batch)) {
+    if (!linked) {
+      if (batch.node_id() == node_id_ || batch.node_id() > kMaxNodeId) {
+        BtsLogError("Federation peer %s has invalid node id %u", peer.c_str(),
+                    batch.node_id());
+        break;
+      }
+      link->SetNodeId(batch.node_id());
+      if (!AddLink(link)) {
+        BtsLogWarn("Federation node %u is already linked, closing %s",
+                   batch.node_id(), peer.c_str());
+        break;
+      }
+      linked = true;
+      BtsLogInfo("Federation linked to node %u at %s", batch.node_id(),
+                 peer.c_str());
+    } else if (!link->SetNodeId(batch.node_id())) {
+      BtsLogError("Federation peer %s changed its node id", peer.c_str());
+      break;
+    }
+    HandleBatch(batch.node_id(), batch);
+  }
+  if (linked) {
+    RemoveLink(link);
+    BtsLogInfo("Federation link to node %u closed", link->NodeId());
+  }
+  link->Close();
+  writer.join();
+}
+
+// Dials a peer, and dials it again after the link closes, until Stop.
+class Dialer {
+ public:
+  explicit Dialer(std::string address)
+      : address_(std::move(address)),
+        stub_(FederationService::NewStub(grpc::CreateChannel(
+            address_, grpc::InsecureChannelCredentials()))) {}
+
+  void Run() {
+    util::SetUpThread(util::ThreadClass::kBackground, "fed_dialer");
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopped_) {
+      grpc::ClientContext context;
+      context_ = &context;
+      lock.unlock();
+      auto stream = stub_->Link(&context);
+      RunLink(*stream, context, address_);
+      auto status = stream->Finish();
+      lock.lock();
+      context_ = nullptr;
+      if (stopped_) break;
+      BtsLogInfo("Federation peer %s: %s, dialing again", address_.c_str(),
+                 status.error_message().c_str());
+      cv_.wait_for(lock, kRedialInterval, [this] { return stopped_; });
+    }
+  }
+
+  void Stop() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+    if (context_) context_->TryCancel();
+    cv_.notify_all();
+  }
+
+ private:
+  const std::string address_;
+  const std::unique_ptr<FederationService::Stub> stub_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopped_ = false;
+  grpc::ClientContext *context_ = nullptr;
+};
+
+std::vector<std::unique_ptr<Dialer>> dialers_;
+std::vector<std::thread> dialer_threads_;
+
+class FederationServiceImpl final : public FederationService::Service {
+ public:
+  grpc::Status Link(grpc::ServerContext *context,
+                    grpc::ServerReaderWriter<Batch, Batch> *stream) override {
+    if (!Enabled()) {
+      return grpc::Status(grpc::StatusCode::FAILED_PRECONDITION,
+                          "netsimd is not federated");
+    }
+    RunLink(*stream, *context, context->peer());
+    return grpc::Status::OK;
+  }
+};
+
+}  // namespace
+
+bool Enabled() { return started_.load(std::memory_order_acquire); }
+
+bool IsWifiMedium() { return !Enabled() || node_id_ == wifi_node_id_; }
+
+void ForwardPhyPacket(uint32_t phy_type, uint32_t device_id,
+                      const std::optional<std::array<float, 3>> &position,
+                      int8_t tx_power, const std::vector<uint8_t> &packet) {
+  for (const auto &link : *Links()) {
+    link->AddPhyPacket(phy_type, device_id, position, tx_power, packet);
+  }
+}
+
+void ForwardWifiFrame(const uint8_t *data, size_t size) {
+  SendWifiFrame(wifi_node_id_, data, size);
+}
+
+void SendWifiFrame(uint32_t node_id, const uint8_t *data, size_t size) {
+  bool sent = false;
+  for (const auto &link : *Links()) {
+    if (node_id != kAllNodes && link->NodeId() != node_id) continue;
+    link->AddWifiFrame(data, size);
+    sent = true;
+  }
+  if (!sent && node_id != kAllNodes) {
+    BtsLogWarnRateLimited("Dropping WiFi frame to unlinked federation node %u",
+                          node_id);
+  }
+}
+
+std::unique_ptr<FederationService::Service> GetFederationService() {
+  return std::make_unique<FederationServiceImpl>();
+}
+
+void Start(const config::Federation &config) {
+  if (Enabled()) return;
+  if (config.node_id() > kMaxNodeId || config.wifi_node_id() > kMaxNodeId) {
+    BtsLogError("Federation node ids must be at most %u", kMaxNodeId);
+    return;
+  }
+  node_id_ = config.node_id();
+  wifi_node_id_ = config.wifi_node_id();
+  flush_interval_ = config.flush_interval_us() != 0
+                        ? std::chrono::microseconds(config.flush_interval_us())
+                        : kDefaultFlushInterval;
+  max_batch_bytes_ = config.max_batch_bytes() != 0 ? config.max_batch_bytes()
+                                                   : kDefaultMaxBatchBytes;
+  started_.store(true, std::memory_order_release);
+  BtsLogInfo("Federation node %u with %d peer(s), WiFi medium on node %u",
+             node_id_, config.peers_size(), wifi_node_id_);
+  for (const auto &peer : config.peers()) {
+    dialers_.push_back(std::make_unique<Dialer>(peer));
+    dialer_threads_.emplace_back(&Dialer::Run, dialers_.back().get());
+  }
+}
+
+void Stop() {
+  {
+    std::lock_guard<std::mutex> lock(links_mutex_);
+    if (!started_.exchange(false)) return;
+  }
+  for (auto &dialer : dialers_) dialer->Stop();
+  for (const auto &link : *Links()) link->Close();
+  for (auto &thread : dialer_threads_) thread.join();
+  dialer_threads_.clear();
+  dialers_.clear();
+}
+
+void StartCxx(rust::Slice<const uint8_t> proto_bytes) {
+  config::Federation config;
+  if (!config.ParseFromArray(proto_bytes.data(), proto_bytes.size())) {
+    BtsLogError("Failed to parse the federation config");
+    return;
+  }
+  Start(config);
+}
+
+}  // namespace netsim::federation
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+/** Federation of netsimd instances into one scene.
+ *
+ * Each node owns the devices connected to it and simulates their chips.
+ * The link layer packets sent by its Bluetooth chips, and the positions of
+ * the senders, are forwarded to every other node, which delivers them to its
+ * own chips in range as the packets of a remote device. Remote devices are
+ * known to the spatial index of a node by RemoteDeviceId.
+ *
+ * WiFi chips share the WiFi service of one node, the medium node: the other
+ * nodes forward the frames of their chips to it and deliver the frames it
+ * sends back.
+ *
+ * The nodes are linked pairwise by a FederationService stream in each
+ * direction of which the traffic is sent in batches, see BatchBuilder.
+ * Packets are not relayed, so every pair of nodes needs a link.
+ */
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "netsim/config.pb.h"
+#include "netsim/federation.grpc.pb.h"
+#include "rust/cxx.h"
+
+namespace netsim::federation {
+
+constexpr uint32_t kMaxNodeId = 2047;
+// Ids of simulation devices of this node stay below kRemoteDeviceBit.
+constexpr uint32_t kRemoteDeviceBit = 1u << 31;
+// With SendWifiFrame, sends to every linked node.
+constexpr uint32_t kAllNodes = std::numeric_limits<uint32_t>::max();
+
+// Id of a device of another node in the id space of the local simulation
+// devices.
+inline uint32_t RemoteDeviceId(uint32_t node_id, uint32_t device_id) {
+  return kRemoteDeviceBit | (node_id & kMaxNodeId) << 20 |
+         (device_id & 0xfffff);
+}
+
+inline bool IsRemoteDevice(uint32_t device_id) {
+  return (device_id & kRemoteDeviceBit) != 0;
+}
+
+// True between Start and Stop, when the facades forward their traffic.
+bool Enabled();
+
+// True when the frames of the local WiFi chips go to the local WiFi
+// service, that is unless federated with another medium node.
+bool IsWifiMedium();
+
+// Forwards a link layer packet sent by a chip of a local device to the
+// other nodes. position is the position of the device, if known.
+void ForwardPhyPacket(uint32_t phy_type, uint32_t device_id,
+                      const std::optional<std::array<float, 3>> &position,
+                      int8_t tx_power, const std::vector<uint8_t> &packet);
+
+// Forwards a frame of a local WiFi chip to the medium node.
+void ForwardWifiFrame(const uint8_t *data, size_t size);
+
+// Sends a frame of the WiFi medium to the chips of a node, or of every
+// linked node with kAllNodes.
+void SendWifiFrame(uint32_t node_id, const uint8_t *data, size_t size);
+
+// Accepts the links dialed by other nodes, registered with the grpc server
+// whether or not this node is federated.
+std::unique_ptr<FederationService::Service> GetFederationService();
+
+// Dials the peers of the config and accepts their links until Stop.
+void Start(const config::Federation &config);
+void Stop();
+
+// Cxx functions for rust ffi.
+void StartCxx(rust::Slice<const uint8_t> proto_bytes);
+
+}  // namespace netsim::federation
@@ -0,0 +1,75 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/federation_batch.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "netsim/federation.pb.h"
+
+namespace netsim::federation {
+
+BatchBuilder::BatchBuilder(uint32_t node_id, size_t max_bytes)
+    : node_id_(node_id), max_bytes_(max_bytes) {}
+
+bool BatchBuilder::AddPhyPacket(uint32_t phy_type, uint32_t device_id,
+                                const std::optional<Position> &position,
+                                int8_t tx_power, const uint8_t *data,
+                                size_t size) {
+  if (position) AddPosition(device_id, *position);
+  auto *packet = batch_.add_phy_packets();
+  packet->set_phy_type(phy_type);
+  packet->set_device_id(device_id);
+  packet->set_tx_power(tx_power);
+  packet->set_packet(data, size);
+  bytes_ += size + kEntryOverhead;
+  return bytes_ >= max_bytes_;
+}
+
+bool BatchBuilder::AddWifiFrame(const uint8_t *data, size_t size) {
+  batch_.add_wifi_frames(data, size);
+  bytes_ += size + kEntryOverhead;
+  return bytes_ >= max_bytes_;
+}
+
+void BatchBuilder::AddPosition(uint32_t device_id, const Position &position) {
+  auto [sent, inserted] = sent_positions_.emplace(device_id, position);
+  if (!inserted) {
+    if (sent->second == position) return;
+    sent->second = position;
+  }
+  auto [index, added] =
+      batch_positions_.emplace(device_id, batch_.positions_size());
+  auto *entry = added ? batch_.add_positions()
+                      : batch_.mutable_positions(index->second);
+  entry->set_device_id(device_id);
+  entry->mutable_position()->set_x(position[0]);
+  entry->mutable_position()->set_y(position[1]);
+  entry->mutable_position()->set_z(position[2]);
+  if (added) bytes_ += kEntryOverhead;
+}
+
+Batch BatchBuilder::Take() {
+  Batch batch = std::move(batch_);
+  batch_.Clear();
+  batch_positions_.clear();
+  bytes_ = 0;
+  batch.set_node_id(node_id_);
+  return batch;
+}
+
+}  // namespace netsim::federation
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Batches of the traffic sent to a federation peer.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <unordered_map>
+
+#include "netsim/federation.pb.h"
+
+namespace netsim::federation {
+
+/**
+ * @brief Collects the traffic for one peer until it is sent.
+ *
+ * The position of a device goes into the batch of its first packet after
+ * it moved: the builder remembers the positions the peer was sent, across
+ * batches, and a device that keeps its position costs no more than its
+ * packets. A device that moves again before the batch is sent has its
+ * position replaced, since the peer applies positions before packets.
+ *
+ * Not thread safe.
+ */
+class BatchBuilder {
+ public:
+  using Position = std::array<float, 3>;
+
+  // Rough wire size of the fields around each packet or frame.
+  static constexpr size_t kEntryOverhead = 16;
+
+  BatchBuilder(uint32_t node_id, size_t max_bytes);
+
+  // The Add functions return true once the batch holds max_bytes or more
+  // and should be sent without waiting.
+  bool AddPhyPacket(uint32_t phy_type, uint32_t device_id,
+                    const std::optional<Position> &position, int8_t tx_power,
+                    const uint8_t *data, size_t size);
+  bool AddWifiFrame(const uint8_t *data, size_t size);
+
+  bool Empty() const { return bytes_ == 0; }
+  // Estimated wire size of the batch.
+  size_t Bytes() const { return bytes_; }
+
+  // Returns the batch and starts the next one.
+  Batch Take();
+
+ private:
+  void AddPosition(uint32_t device_id, const Position &position);
+
+  const uint32_t node_id_;
+  const size_t max_bytes_;
+  Batch batch_;
+  size_t bytes_ = 0;
+  // Last position sent to the peer, by device.
+  std::unordered_map<uint32_t, Position> sent_positions_;
+  // Index in batch_.positions() of the devices positioned in this batch.
+  std::unordered_map<uint32_t, int> batch_positions_;
+};
+
+}  // namespace netsim::federation
@@ -0,0 +1,105 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/federation_batch.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using federation::BatchBuilder;
+
+const std::vector<uint8_t> kPacket = {0x01, 0x02, 0x03, 0x04};
+
+TEST(FederationBatchTest, TakeReturnsTheTraffic) {
+  BatchBuilder builder(3, 1024);
+  EXPECT_TRUE(builder.Empty());
+  builder.AddPhyPacket(1, 7, BatchBuilder::Position{1, 2, 3}, -10,
+                       kPacket.data(), kPacket.size());
+  builder.AddWifiFrame(kPacket.data(), 2);
+  EXPECT_FALSE(builder.Empty());
+
+  auto batch = builder.Take();
+  EXPECT_TRUE(builder.Empty());
+  EXPECT_EQ(batch.node_id(), 3);
+  ASSERT_EQ(batch.phy_packets_size(), 1);
+  EXPECT_EQ(batch.phy_packets(0).phy_type(), 1);
+  EXPECT_EQ(batch.phy_packets(0).device_id(), 7);
+  EXPECT_EQ(batch.phy_packets(0).tx_power(), -10);
+  EXPECT_EQ(batch.phy_packets(0).packet(), "\x01\x02\x03\x04");
+  ASSERT_EQ(batch.positions_size(), 1);
+  EXPECT_EQ(batch.positions(0).device_id(), 7);
+  EXPECT_FLOAT_EQ(batch.positions(0).position().z(), 3);
+  ASSERT_EQ(batch.wifi_frames_size(), 1);
+  EXPECT_EQ(batch.wifi_frames(0), "\x01\x02");
+
+  EXPECT_EQ(builder.Take().phy_packets_size(), 0);
+}
+
+TEST(FederationBatchTest, PositionIsSentOnceUntilItChanges) {
+  BatchBuilder builder(0, 1024);
+  BatchBuilder::Position position{1, 2, 3};
+  builder.AddPhyPacket(1, 7, position, 0, kPacket.data(), kPacket.size());
+  builder.AddPhyPacket(1, 7, position, 0, kPacket.data(), kPacket.size());
+  EXPECT_EQ(builder.Take().positions_size(), 1);
+
+  builder.AddPhyPacket(1, 7, position, 0, kPacket.data(), kPacket.size());
+  auto batch = builder.Take();
+  EXPECT_EQ(batch.phy_packets_size(), 1);
+  EXPECT_EQ(batch.positions_size(), 0);
+
+  builder.AddPhyPacket(1, 7, BatchBuilder::Position{4, 5, 6}, 0,
+                       kPacket.data(), kPacket.size());
+  batch = builder.Take();
+  ASSERT_EQ(batch.positions_size(), 1);
+  EXPECT_FLOAT_EQ(batch.positions(0).position().x(), 4);
+}
+
+TEST(FederationBatchTest, MoveWithinABatchReplacesThePosition) {
+  BatchBuilder builder(0, 1024);
+  builder.AddPhyPacket(1, 7, BatchBuilder::Position{1, 0, 0}, 0,
+                       kPacket.data(), kPacket.size());
+  builder.AddPhyPacket(1, 8, BatchBuilder::Position{2, 0, 0}, 0,
+                       kPacket.data(), kPacket.size());
+  builder.AddPhyPacket(1, 7, BatchBuilder::Position{3, 0, 0}, 0,
+                       kPacket.data(), kPacket.size());
+  builder.AddPhyPacket(1, 9, std::nullopt, 0, kPacket.data(), kPacket.size());
+
+  auto batch = builder.Take();
+  EXPECT_EQ(batch.phy_packets_size(), 4);
+  ASSERT_EQ(batch.positions_size(), 2);
+  EXPECT_EQ(batch.positions(0).device_id(), 7);
+  EXPECT_FLOAT_EQ(batch.positions(0).position().x(), 3);
+  EXPECT_EQ(batch.positions(1).device_id(), 8);
+}
+
+TEST(FederationBatchTest, FullAtMaxBytes) {
+  std::vector<uint8_t> frame(100);
+  BatchBuilder builder(0, 3 * (frame.size() + BatchBuilder::kEntryOverhead));
+  EXPECT_FALSE(builder.AddWifiFrame(frame.data(), frame.size()));
+  EXPECT_FALSE(builder.AddWifiFrame(frame.data(), frame.size()));
+  EXPECT_TRUE(builder.AddWifiFrame(frame.data(), frame.size()));
+  builder.Take();
+  EXPECT_EQ(builder.Bytes(), 0);
+  EXPECT_FALSE(builder.AddWifiFrame(frame.data(), frame.size()));
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
@@ -20,12 +20,16 @@
 #include <utility>
 
 #include "backend/grpc_server.h"
+#include "core/federation.h"
 #include "frontend/frontend_server.h"
+#include "grpcpp/resource_quota.h"
 #include "grpcpp/security/server_credentials.h"
 #include "grpcpp/server.h"
 #include "grpcpp/server_builder.h"
 #include "netsim-daemon/src/ffi.rs.h"
+#include "netsim/config.pb.h"
 #include "util/log.h"
+#include "util/thread_affinity.h"
 #ifdef _WIN32
 #include <Windows.h>
 #else
@@ -42,13 +46,60 @@ namespace netsim::server {
 namespace {
 constexpr std::chrono::seconds InactivityCheckInterval(5);
 
+// Applies the options that are set, the others keep the gRPC defaults.
+void ApplyServerOptions(const config::GrpcServerOptions &options,
+                        grpc::ServerBuilder &builder) {
+  using SyncServerOption = grpc::ServerBuilder::SyncServerOption;
+  if (options.min_pollers() != 0)
+    builder.SetSyncServerOption(SyncServerOption::MIN_POLLERS,
+                                options.min_pollers());
+  if (options.max_pollers() != 0)
+    builder.SetSyncServerOption(SyncServerOption::MAX_POLLERS,
+                                options.max_pollers());
+  if (options.num_completion_queues() != 0)
+    builder.SetSyncServerOption(SyncServerOption::NUM_CQS,
+                                options.num_completion_queues());
+  if (options.max_threads() != 0 || options.max_memory_mb() != 0) {
+    grpc::ResourceQuota quota("netsim");
+    if (options.max_threads() != 0) quota.SetMaxThreads(options.max_threads());
+    if (options.max_memory_mb() != 0)
+      quota.Resize(static_cast<size_t>(options.max_memory_mb()) << 20);
+    builder.SetResourceQuota(quota);
+  }
+  if (options.max_concurrent_streams() != 0)
+    builder.AddChannelArgument(GRPC_ARG_MAX_CONCURRENT_STREAMS,
+                               options.max_concurrent_streams());
+  if (options.stream_window_bytes() != 0)
+    builder.AddChannelArgument(GRPC_ARG_HTTP2_STREAM_LOOKAHEAD_BYTES,
+                               options.stream_window_bytes());
+  if (options.keepalive_time_ms() != 0)
+    builder.AddChannelArgument(GRPC_ARG_KEEPALIVE_TIME_MS,
+                               options.keepalive_time_ms());
+  if (options.keepalive_timeout_ms() != 0)
+    builder.AddChannelArgument(GRPC_ARG_KEEPALIVE_TIMEOUT_MS,
+                               options.keepalive_timeout_ms());
+}
+
 std::pair<std::unique_ptr<grpc::Server>, uint32_t> RunGrpcServer(
-    int netsim_grpc_port, bool no_cli_ui, int vsock) {
+    int netsim_grpc_port, bool no_cli_ui, int vsock, bool callback_api,
+    const std::string &uds_path, const config::GrpcServerOptions &options) {
   grpc::ServerBuilder builder;
+  ApplyServerOptions(options, builder);
   int selected_port;
   builder.AddListeningPort("0.0.0.0:" + std::to_string(netsim_grpc_port),
                            grpc::InsecureServerCredentials(), &selected_port);
-  if (!no_cli_ui) {
+#ifndef _WIN32
+  // Local clients connect through the unix domain socket and skip the TCP
+  // loopback.
+  if (!uds_path.empty()) {
+    // A socket left by a netsimd that did not shut down fails the bind.
+    unlink(uds_path.c_str());
+    BtsLogInfo("Grpc server listening on unix:%s", uds_path.c_str());
+    builder.AddListeningPort("unix:" + uds_path,
+                             grpc::InsecureServerCredentials());
+  }
+#endif
+  if (!no_cli_ui && !options.separate_frontend()) {
     static auto frontend_service = GetFrontendService();
     builder.RegisterService(frontend_service.release());
   }
@@ -62,10 +113,21 @@ std::pair<std::unique_ptr<grpc::Server>, uint32_t> RunGrpcServer(
   }
 #endif
 
-  static auto backend_service = GetBackendService();
-  builder.RegisterService(backend_service.release());
+  if (callback_api) {
+    static auto backend_service = GetBackendCallbackService(options);
+    builder.RegisterService(backend_service.release());
+  } else {
+    static auto backend_service = GetBackendService(options);
+    builder.RegisterService(backend_service.release());
+  }
+  // Other netsimd instances link to this one through the netsim port.
+  static auto federation_service = federation::GetFederationService();
+  builder.RegisterService(federation_service.release());
   builder.AddChannelArgument(GRPC_ARG_ALLOW_REUSEPORT, 0);
-  std::unique_ptr<grpc::Server> server(builder.BuildAndStart());
+  // The server threads inherit the CPUs of the thread that starts them.
+  std::unique_ptr<grpc::Server> server;
+  util::StartThreadsOf(util::ThreadClass::kGrpc,
+                       [&] { server = builder.BuildAndStart(); });
   if (server == nullptr) {
     return std::make_pair(nullptr, static_cast<uint32_t>(selected_port));
   }
@@ -76,13 +138,63 @@ std::pair<std::unique_ptr<grpc::Server>, uint32_t> RunGrpcServer(
   return std::make_pair(std::move(server),
                         static_cast<uint32_t>(selected_port));
 }
+
+// Runs the FrontendService on its own server. Its threads are separate from
+// the ones streaming packets.
+std::pair<std::unique_ptr<grpc::Server>, uint32_t> RunFrontendServer(
+    const config::GrpcServerOptions &options) {
+  grpc::ServerBuilder builder;
+  int selected_port;
+  builder.AddListeningPort(
+      "0.0.0.0:" + std::to_string(options.frontend_port()),
+      grpc::InsecureServerCredentials(), &selected_port);
+  if (options.frontend_max_threads() != 0) {
+    grpc::ResourceQuota quota("netsim-frontend");
+    quota.SetMaxThreads(options.frontend_max_threads());
+    builder.SetResourceQuota(quota);
+  }
+  static auto frontend_service = GetFrontendService();
+  builder.RegisterService(frontend_service.release());
+  builder.AddChannelArgument(GRPC_ARG_ALLOW_REUSEPORT, 0);
+  // The server threads inherit the CPUs of the thread that starts them.
+  std::unique_ptr<grpc::Server> server;
+  util::StartThreadsOf(util::ThreadClass::kGrpc,
+                       [&] { server = builder.BuildAndStart(); });
+  if (server == nullptr) {
+    return std::make_pair(nullptr, static_cast<uint32_t>(selected_port));
+  }
+
+  BtsLogInfo("Frontend grpc server listening on localhost: %s",
+             std::to_string(selected_port).c_str());
+
+  return std::make_pair(std::move(server),
+                        static_cast<uint32_t>(selected_port));
+}
 }  // namespace
 
-std::unique_ptr<GrpcServer> RunGrpcServerCxx(uint32_t netsim_grpc_port,
-                                             bool no_cli_ui, uint16_t vsock) {
-  auto [grpc_server, port] = RunGrpcServer(netsim_grpc_port, no_cli_ui, vsock);
+std::unique_ptr<GrpcServer> RunGrpcServerCxx(
+    uint32_t netsim_grpc_port, bool no_cli_ui, uint16_t vsock,
+    bool callback_api, rust::Str uds_path, rust::Slice<const uint8_t> options) {
+  config::GrpcServerOptions server_options;
+  if (!server_options.ParseFromArray(options.data(), options.size())) {
+    BtsLogWarn("Failed to parse the grpc server options");
+    server_options.Clear();
+  }
+  auto [grpc_server, port] =
+      RunGrpcServer(netsim_grpc_port, no_cli_ui, vsock, callback_api,
+                    std::string(uds_path), server_options);
   if (grpc_server == nullptr) return nullptr;
-  return std::make_unique<GrpcServer>(std::move(grpc_server), port);
+  if (no_cli_ui || !server_options.separate_frontend()) {
+    return std::make_unique<GrpcServer>(std::move(grpc_server), port);
+  }
+  auto [frontend_server, frontend_port] = RunFrontendServer(server_options);
+  if (frontend_server == nullptr) {
+    grpc_server->Shutdown();
+    return nullptr;
+  }
+  return std::make_unique<GrpcServer>(std::move(grpc_server), port,
+                                      std::move(frontend_server),
+                                      frontend_port);
 }
 
 }  // namespace netsim::server
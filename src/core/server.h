@@ -20,24 +20,41 @@
 #include <memory>
 
 #include "grpcpp/server.h"
+#include "rust/cxx.h"
 
 namespace netsim::server {
 
 class GrpcServer {
  public:
-  GrpcServer(std::unique_ptr<grpc::Server> server, std::uint32_t port)
-      : server(std::move(server)), port(port) {}
-
-  void Shutdown() const { server->Shutdown(); }
+  GrpcServer(std::unique_ptr<grpc::Server> server, std::uint32_t port,
+             std::unique_ptr<grpc::Server> frontend_server = nullptr,
+             std::uint32_t frontend_port = 0)
+      : server(std::move(server)),
+        port(port),
+        frontend_server(std::move(frontend_server)),
+        frontend_port(frontend_port) {}
+
+  void Shutdown() const {
+    if (frontend_server) frontend_server->Shutdown();
+    server->Shutdown();
+  }
   uint32_t GetGrpcPort() const { return port; };
+  // Returns 0 unless the frontend runs on its own server.
+  uint32_t GetFrontendGrpcPort() const { return frontend_port; };
 
  private:
   std::unique_ptr<grpc::Server> server;
   std::uint32_t port;
+  std::unique_ptr<grpc::Server> frontend_server;
+  std::uint32_t frontend_port;
 };
 
-// Run grpc server.
-std::unique_ptr<GrpcServer> RunGrpcServerCxx(uint32_t netsim_grpc_port,
-                                             bool no_cli_ui, uint16_t vsock);
+// Run grpc server. With callback_api the PacketStreamer is served by the
+// callback (reactor) API instead of the synchronous one. The server also
+// listens on the unix domain socket uds_path unless it is empty. options is
+// a serialized config::GrpcServerOptions.
+std::unique_ptr<GrpcServer> RunGrpcServerCxx(
+    uint32_t netsim_grpc_port, bool no_cli_ui, uint16_t vsock,
+    bool callback_api, rust::Str uds_path, rust::Slice<const uint8_t> options);
 
 }  // namespace netsim::server
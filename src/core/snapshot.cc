@@ -0,0 +1,52 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/snapshot.h"
+
+#include <string>
+#include <utility>
+
+#include "hci/bluetooth_facade.h"
+#include "util/chip_snapshot.h"
+#include "util/log.h"
+#include "wifi/wifi_facade.h"
+
+namespace netsim::snapshot {
+
+bool SaveSnapshotCxx(const std::string &path) {
+  // The removed chips and then the attached ones, which are newer.
+  auto snapshot = util::SnapshotStore::Copy();
+  hci::facade::SnapshotChips(snapshot);
+  wifi::facade::SnapshotChips(snapshot);
+  if (!util::WriteSnapshotFile(path, snapshot)) {
+    BtsLogWarn("Failed to write snapshot %s", path.c_str());
+    return false;
+  }
+  BtsLogInfo("Saved %zu chips to snapshot %s", snapshot.size(), path.c_str());
+  return true;
+}
+
+bool LoadSnapshotCxx(const std::string &path) {
+  auto snapshot = util::ReadSnapshotFile(path);
+  if (!snapshot) {
+    BtsLogWarn("Failed to read snapshot %s", path.c_str());
+    return false;
+  }
+  BtsLogInfo("Loaded %zu chips from snapshot %s", snapshot->size(),
+             path.c_str());
+  util::SnapshotStore::Merge(std::move(*snapshot));
+  return true;
+}
+
+}  // namespace netsim::snapshot
@@ -0,0 +1,32 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Simulation snapshot files, see util/chip_snapshot.h.
+
+#include <string>
+
+namespace netsim::snapshot {
+
+// Writes the snapshots of the attached and the removed chips to path.
+bool SaveSnapshotCxx(const std::string &path);
+
+// Adds the chip snapshots of the file at path to the snapshot store, for
+// the chips added afterwards. Returns false if it is missing or invalid.
+bool LoadSnapshotCxx(const std::string &path);
+
+}  // namespace netsim::snapshot
@@ -0,0 +1,51 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/tracing.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "netsim-daemon/src/ffi.rs.h"
+#include "netsim/stats.pb.h"
+#include "rust/cxx.h"
+#include "util/trace.h"
+
+namespace netsim::tracing {
+
+std::vector<stats::NetsimTraceCounter> GetTraceCounters() {
+  std::vector<stats::NetsimTraceCounter> result;
+  for (const auto &counter : util::GetTraceCounters()) {
+    auto &proto = result.emplace_back();
+    proto.set_name(counter.name);
+    proto.set_count(counter.count);
+    proto.set_total(counter.total);
+    proto.set_max(counter.max);
+  }
+  return result;
+}
+
+rust::Vec<uint8_t> GetTraceCountersCxx() {
+  stats::NetsimStats stats;
+  for (auto &counter : GetTraceCounters()) {
+    *stats.add_trace_counters() = std::move(counter);
+  }
+  std::string bytes = stats.SerializeAsString();
+  return VecFromSlice(
+      {reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size()});
+}
+
+}  // namespace netsim::tracing
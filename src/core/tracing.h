@@ -0,0 +1,34 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Trace point totals as stats protos, see util/trace.h.
+
+#include <cstdint>
+#include <vector>
+
+#include "netsim/stats.pb.h"
+#include "rust/cxx.h"
+
+namespace netsim::tracing {
+
+std::vector<stats::NetsimTraceCounter> GetTraceCounters();
+
+// Returns a serialized NetsimStats holding only trace_counters.
+rust::Vec<uint8_t> GetTraceCountersCxx();
+
+}  // namespace netsim::tracing
@@ -69,9 +69,9 @@ class FrontendClientImpl : public FrontendClient {
     message.SerializeToArray(message_vec.data(), message_vec.size());
     if (!status.ok()) {
       return std::make_unique<ClientResult>(false, status.error_message(),
-                                            message_vec);
+                                            std::move(message_vec));
     }
-    return std::make_unique<ClientResult>(true, "", message_vec);
+    return std::make_unique<ClientResult>(true, "", std::move(message_vec));
   }
 
   // Gets the version of the network simulator service.
@@ -134,6 +134,25 @@ class FrontendClientImpl : public FrontendClient {
     return make_result(status, response);
   }
 
+  // Patches several devices in one request, all of them or none
+  std::unique_ptr<ClientResult> PatchDevices(
+      rust::Vec<::rust::u8> const &request_byte_vec) const {
+    google::protobuf::Empty response;
+    grpc::ClientContext context_;
+    frontend::PatchDevicesRequest request;
+    if (!request.ParseFromArray(request_byte_vec.data(),
+                                request_byte_vec.size())) {
+      return make_result(
+          grpc::Status(
+              grpc::StatusCode::INVALID_ARGUMENT,
+              "Error parsing PatchDevices request protobuf. request size:" +
+                  std::to_string(request_byte_vec.size())),
+          response);
+    }
+    auto status = stub_->PatchDevices(&context_, request, &response);
+    return make_result(status, response);
+  }
+
   std::unique_ptr<ClientResult> DeleteChip(
       rust::Vec<::rust::u8> const &request_byte_vec) const {
     google::protobuf::Empty response;
@@ -233,6 +252,8 @@ class FrontendClientImpl : public FrontendClient {
         return ListCapture();
       case frontend::GrpcMethod::PatchCapture:
         return PatchCapture(request_byte_vec);
+      case frontend::GrpcMethod::PatchDevices:
+        return PatchDevices(request_byte_vec);
       default:
         return make_result(grpc::Status(grpc::StatusCode::INVALID_ARGUMENT,
                                         "Unknown GrpcMethod found."),
@@ -19,6 +19,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "rust/cxx.h"
@@ -32,8 +34,8 @@ struct ClientResponseReader;
 class ClientResult {
  public:
   ClientResult(bool is_ok, const std::string &err,
-               const std::vector<unsigned char> &byte_vec)
-      : is_ok_(is_ok), err_(err), byte_vec_(byte_vec){};
+               std::vector<unsigned char> byte_vec)
+      : is_ok_(is_ok), err_(err), byte_vec_(std::move(byte_vec)){};
 
   bool IsOk() const { return is_ok_; };
   rust::String Err() const { return err_; };
@@ -32,7 +32,7 @@ const std::chrono::duration kConnectionDeadline = std::chrono::seconds(1);
 
 std::unique_ptr<frontend::FrontendService::Stub> NewFrontendClient(
     uint16_t instance_num) {
-  auto port = netsim::osutils::GetServerAddress(instance_num);
+  auto port = netsim::osutils::GetFrontendServerAddress(instance_num);
   if (!port.has_value()) {
     return nullptr;
   }
@@ -16,17 +16,24 @@
 
 #include <google/protobuf/util/json_util.h>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <string>
+#include <thread>
 #include <utility>
 
 #include "google/protobuf/empty.pb.h"
 #include "grpcpp/server_context.h"
 #include "grpcpp/support/status.h"
+#include "core/tracing.h"
+#include "hci/packet_latency.h"
 #include "netsim-daemon/src/ffi.rs.h"
 #include "netsim/frontend.grpc.pb.h"
 #include "netsim/frontend.pb.h"
+#include "util/flight_recorder.h"
+#include "util/trace.h"
 
 namespace netsim {
 namespace {
@@ -54,10 +61,15 @@ class CxxServerResponseWritable : public frontend::CxxServerResponseWriter {
     is_ok = true;
   }
 
+  // Reuses one response message and lets gRPC coalesce the writes until the
+  // last chunk.
   void put_chunk(rust::Slice<const uint8_t> chunk) const override {
-    netsim::frontend::GetCaptureResponse response;
-    response.set_capture_stream(std::string(chunk.begin(), chunk.end()));
-    is_ok = grpc_writer_->Write(response);
+    response_.mutable_capture_stream()->assign(
+        reinterpret_cast<const char *>(chunk.data()), chunk.size());
+    written_ += chunk.size();
+    auto options = grpc::WriteOptions();
+    if (written_ < length) options.set_buffer_hint();
+    is_ok = grpc_writer_->Write(response_, options);
   }
 
   void put_ok(const std::string &mime_type,
@@ -72,8 +84,25 @@ class CxxServerResponseWritable : public frontend::CxxServerResponseWriter {
   mutable bool is_ok;
   mutable std::string body;
   mutable std::size_t length;
+
+ private:
+  mutable netsim::frontend::GetCaptureResponse response_;
+  mutable std::size_t written_ = 0;
 };
 
+// Calls the Rust device handler with the request encoded as binary
+// protobuf. On success the body of the writer holds the encoded response.
+void HandleDevice(CxxServerResponseWritable &writer, const std::string &method,
+                  const std::string &param,
+                  const google::protobuf::Message *request = nullptr) {
+  std::string request_bytes;
+  if (request != nullptr) request->SerializeToString(&request_bytes);
+  HandleDeviceProtoCxx(
+      writer, method, param,
+      {reinterpret_cast<const uint8_t *>(request_bytes.data()),
+       request_bytes.size()});
+}
+
 class FrontendServer final : public frontend::FrontendService::Service {
  public:
   grpc::Status GetVersion(grpc::ServerContext *context,
@@ -87,9 +116,9 @@ class FrontendServer final : public frontend::FrontendService::Service {
                           const google::protobuf::Empty *empty,
                           frontend::ListDeviceResponse *reply) {
     CxxServerResponseWritable writer;
-    HandleDeviceCxx(writer, "GET", "", "");
+    HandleDevice(writer, "GET", "");
     if (writer.is_ok) {
-      google::protobuf::util::JsonStringToMessage(writer.body, reply);
+      reply->ParseFromString(writer.body);
       return grpc::Status::OK;
     }
     return grpc::Status(grpc::StatusCode::UNKNOWN, writer.err);
@@ -99,11 +128,9 @@ class FrontendServer final : public frontend::FrontendService::Service {
                             const frontend::CreateDeviceRequest *request,
                             frontend::CreateDeviceResponse *response) {
     CxxServerResponseWritable writer;
-    std::string request_json;
-    google::protobuf::util::MessageToJsonString(*request, &request_json);
-    HandleDeviceCxx(writer, "POST", "", request_json);
+    HandleDevice(writer, "POST", "", request);
     if (writer.is_ok) {
-      google::protobuf::util::JsonStringToMessage(writer.body, response);
+      response->ParseFromString(writer.body);
       return grpc::Status::OK;
     }
     return grpc::Status(grpc::StatusCode::UNKNOWN, writer.err);
@@ -113,11 +140,8 @@ class FrontendServer final : public frontend::FrontendService::Service {
                           const frontend::DeleteChipRequest *request,
                           google::protobuf::Empty *response) {
     CxxServerResponseWritable writer;
-    std::string request_json;
-    google::protobuf::util::MessageToJsonString(*request, &request_json);
-    HandleDeviceCxx(writer, "DELETE", "", request_json);
+    HandleDevice(writer, "DELETE", "", request);
     if (writer.is_ok) {
-      google::protobuf::util::JsonStringToMessage(writer.body, response);
       return grpc::Status::OK;
     }
     return grpc::Status(grpc::StatusCode::UNKNOWN, writer.err);
@@ -127,16 +151,13 @@ class FrontendServer final : public frontend::FrontendService::Service {
                            const frontend::PatchDeviceRequest *request,
                            google::protobuf::Empty *response) {
     CxxServerResponseWritable writer;
-    std::string request_json;
-    google::protobuf::util::MessageToJsonString(*request, &request_json);
-    auto device = request->device();
+    const auto &device = request->device();
     // device.id() starts from 1.
     // If you don't populate the id, you must fill the name field.
     if (device.id() == 0) {
-      HandleDeviceCxx(writer, "PATCH", "", request_json);
+      HandleDevice(writer, "PATCH", "", request);
     } else {
-      HandleDeviceCxx(writer, "PATCH", std::to_string(device.id()),
-                      request_json);
+      HandleDevice(writer, "PATCH", std::to_string(device.id()), request);
     }
     if (writer.is_ok) {
       return grpc::Status::OK;
@@ -144,11 +165,22 @@ class FrontendServer final : public frontend::FrontendService::Service {
     return grpc::Status(grpc::StatusCode::UNKNOWN, writer.err);
   }
 
+  grpc::Status PatchDevices(grpc::ServerContext *context,
+                            const frontend::PatchDevicesRequest *request,
+                            google::protobuf::Empty *response) {
+    CxxServerResponseWritable writer;
+    HandleDevice(writer, "PATCH_DEVICES", "", request);
+    if (writer.is_ok) {
+      return grpc::Status::OK;
+    }
+    return grpc::Status(grpc::StatusCode::UNKNOWN, writer.err);
+  }
+
   grpc::Status Reset(grpc::ServerContext *context,
                      const google::protobuf::Empty *request,
                      google::protobuf::Empty *empty) {
     CxxServerResponseWritable writer;
-    HandleDeviceCxx(writer, "PUT", "", "");
+    HandleDevice(writer, "PUT", "");
     if (writer.is_ok) {
       return grpc::Status::OK;
     }
@@ -183,12 +215,122 @@ class FrontendServer final : public frontend::FrontendService::Service {
       const netsim::frontend::GetCaptureRequest *request,
       grpc::ServerWriter<netsim::frontend::GetCaptureResponse> *grpc_writer) {
     CxxServerResponseWritable writer(grpc_writer);
-    HandleCaptureCxx(writer, "GET", std::to_string(request->id()), "");
+    HandleCaptureGetCxx(writer, request->id(), request->offset());
     if (writer.is_ok) {
       return grpc::Status::OK;
     }
     return grpc::Status(grpc::StatusCode::UNKNOWN, writer.err);
   }
+
+  grpc::Status WatchDevices(
+      grpc::ServerContext *context,
+      const netsim::frontend::WatchDevicesRequest *request,
+      grpc::ServerWriter<netsim::frontend::WatchDevicesResponse>
+          *grpc_writer) {
+    auto max_rate_hz = request->max_rate_hz() == 0
+                           ? kDefaultWatchRateHz
+                           : std::min(request->max_rate_hz(), kMaxWatchRateHz);
+    auto interval = std::chrono::milliseconds(1000 / max_rate_hz);
+    auto watcher = netsim::device::NewDeviceWatcherCxx();
+    // The first response is the snapshot and is sent even without devices.
+    bool first = true;
+    while (!context->IsCancelled()) {
+      auto next = std::chrono::steady_clock::now() + interval;
+      auto changes = watcher->Poll();
+      if (first || !changes.empty()) {
+        netsim::frontend::WatchDevicesResponse response;
+        if (!response.ParseFromArray(changes.data(), changes.size())) {
+          return grpc::Status(grpc::StatusCode::INTERNAL,
+                              "Error parsing WatchDevicesResponse");
+        }
+        if (!grpc_writer->Write(response)) break;
+        first = false;
+      }
+      std::this_thread::sleep_until(next);
+    }
+    return grpc::Status::OK;
+  }
+
+  grpc::Status TailCapture(
+      grpc::ServerContext *context,
+      const netsim::frontend::TailCaptureRequest *request,
+      grpc::ServerWriter<netsim::frontend::GetCaptureResponse> *grpc_writer) {
+    std::string filter;
+    request->filter().SerializeToString(&filter);
+    auto tail = NewCaptureTailCxx(
+        request->id(), {reinterpret_cast<const uint8_t *>(filter.data()),
+                        filter.size()});
+    if (tail->IsError()) {
+      return grpc::Status(grpc::StatusCode::NOT_FOUND,
+                          "Cannot tail Capture " +
+                              std::to_string(request->id()));
+    }
+    netsim::frontend::GetCaptureResponse response;
+    while (!context->IsCancelled()) {
+      // Returns on timeout to notice a cancelled stream.
+      auto records = tail->Next(kTailTimeoutMs);
+      if (records.empty()) continue;
+      response.mutable_capture_stream()->assign(
+          reinterpret_cast<const char *>(records.data()), records.size());
+      if (!grpc_writer->Write(response)) break;
+    }
+    return grpc::Status::OK;
+  }
+
+  grpc::Status GetLatencyStats(grpc::ServerContext *context,
+                               const google::protobuf::Empty *empty,
+                               frontend::GetLatencyStatsResponse *reply) {
+    for (auto &stats : hci::GetLatencyStats()) {
+      *reply->add_latency_stats() = std::move(stats);
+    }
+    return grpc::Status::OK;
+  }
+
+  grpc::Status GetFlightRecords(grpc::ServerContext *context,
+                                const google::protobuf::Empty *empty,
+                                frontend::GetFlightRecordsResponse *reply) {
+    for (const auto &recorder : util::GetFlightRecorders()) {
+      auto records = recorder->Records();
+      if (records.empty()) continue;
+      auto *chip = reply->add_chips();
+      chip->set_chip_kind(
+          static_cast<common::ChipKind>(recorder->ChipKind()));
+      chip->set_facade_id(recorder->FacadeId());
+      for (auto &record : records) {
+        auto *proto = chip->add_records();
+        proto->set_timestamp_us(record.timestamp_us);
+        proto->set_egress(record.egress);
+        proto->set_packet_type(record.packet_type);
+        proto->set_length(record.length);
+        proto->set_packet(record.bytes.data(), record.bytes.size());
+      }
+    }
+    return grpc::Status::OK;
+  }
+
+  grpc::Status SetTracing(grpc::ServerContext *context,
+                          const frontend::SetTracingRequest *request,
+                          google::protobuf::Empty *empty) {
+    util::SetTracingEnabled(request->enabled());
+    return grpc::Status::OK;
+  }
+
+  grpc::Status GetTrace(grpc::ServerContext *context,
+                        const google::protobuf::Empty *empty,
+                        frontend::GetTraceResponse *reply) {
+    reply->set_enabled(util::TracingEnabled());
+    reply->set_trace_json(util::GetTraceJson());
+    reply->set_dropped_events(util::TraceDroppedEvents());
+    for (auto &counter : tracing::GetTraceCounters()) {
+      *reply->add_counters() = std::move(counter);
+    }
+    return grpc::Status::OK;
+  }
+
+ private:
+  static constexpr uint32_t kTailTimeoutMs = 100;
+  static constexpr uint32_t kDefaultWatchRateHz = 10;
+  static constexpr uint32_t kMaxWatchRateHz = 100;
 };
 }  // namespace
 
@@ -17,16 +17,28 @@
 
 #include <errno.h>  // for errno
 
+#if defined(__linux__)
+#include <sys/epoll.h>  // for epoll_create1, epoll_ctl, epoll_wait
+#include <unistd.h>     // for close
+#elif defined(__APPLE__)
+#include <sys/event.h>  // for kqueue, kevent
+#include <unistd.h>     // for close
+#endif
+
+#include <algorithm>           // for find, remove
+
 #include <atomic>              // for atomic_bool, atomic_e...
 #include <condition_variable>  // for condition_variable
 #include <cstring>             // for strerror
+#include <deque>               // for deque
 #include <limits>              // for numeric_limits
 #include <map>                 // for map<>::value_type, map
+#include <memory>              // for unique_ptr
 #include <mutex>               // for unique_lock, mutex
 #include <ratio>               // for ratio
-#include <set>                 // for set
 #include <thread>              // for thread
 #include <type_traits>         // for remove_extent_t
+#include <unordered_map>       // for unordered_map
 #include <utility>             // for pair, make_pair, oper...
 #include <vector>              // for vector
 
@@ -35,6 +47,8 @@
 #include "aemu/base/logging/CLog.h"
 #include "aemu/base/sockets/SocketUtils.h"   // for socketRecv, socketSet...
 #include "aemu/base/sockets/SocketWaiter.h"  // for SocketWaiter, SocketW...
+#include "util/thread_affinity.h"            // for SetUpThread
+#include "util/trace.h"                      // for NETSIM_TRACE_SCOPE
 
 namespace rootcanal {
 // Implementation of AsyncManager is divided between two classes, three if
@@ -47,10 +61,11 @@ namespace rootcanal {
 // After construction of this objects nothing happens beyond some very simple
 // member initialization. When the first FD is set up for watching the object
 // starts a new thread which watches the given (and later provided) FDs using
-// select() inside a loop. A special FD (a pipe) is also watched which is
-// used to notify the thread of internal changes on the object state (like
-// the addition of new FDs to watch on). Every access to internal state is
-// synchronized using a single internal mutex. The thread is only stopped on
+// epoll, kqueue or select() inside a loop. A special FD (a pipe) is also
+// watched which is used to notify the thread of internal changes on the
+// object state (like the addition of new FDs to watch on, which the select()
+// fallback needs). Every access to internal state is synchronized using a
+// single internal mutex. The thread is only stopped on
 // destruction of the object, by modifying a flag, which is the only member
 // variable accessed without acquiring the lock (because the notification to
 // the thread is done later by writing to a pipe which means the thread will
@@ -84,9 +99,6 @@ namespace rootcanal {
 // at a given time
 static const uint16_t kMaxTaskId =
     -1; /* 2^16 - 1, permisible ids are {1..2^16-1}*/
-static inline AsyncTaskId NextAsyncTaskId(const AsyncTaskId id) {
-  return (id == kMaxTaskId) ? 1 : id + 1;
-}
 // The buffer is only 10 bytes because the expected number of bytes
 // written on this socket is 1. It is possible that the thread is notified
 // more than once but highly unlikely, so a buffer of size 10 seems enough
@@ -101,6 +113,116 @@ static const int kNotificationBufferSize = 10;
 
 using android::base::SocketWaiter;
 
+// Readiness notification with persistent registrations, so a wakeup costs
+// time proportional to the number of ready descriptors instead of the number
+// of watched ones. Uses epoll on Linux and kqueue on macOS. Registrations are
+// level triggered because read callbacks are not required to drain their
+// descriptor. Other platforms fall back to a SocketWaiter rebuilt on each
+// wait.
+class FdPoller {
+ public:
+#if defined(__linux__) || defined(__APPLE__)
+  FdPoller() {
+#if defined(__linux__)
+    poll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+#else
+    poll_fd_ = kqueue();
+#endif
+    if (poll_fd_ < 0) {
+      derror("%s: Unable to create poller: %s", __func__, strerror(errno));
+    }
+  }
+
+  ~FdPoller() {
+    if (poll_fd_ >= 0) close(poll_fd_);
+  }
+
+  bool Add(int fd) {
+#if defined(__linux__)
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (epoll_ctl(poll_fd_, EPOLL_CTL_ADD, fd, &event) == 0) return true;
+    // A descriptor number can be reused before its registration is dropped.
+    return errno == EEXIST &&
+           epoll_ctl(poll_fd_, EPOLL_CTL_MOD, fd, &event) == 0;
+#else
+    struct kevent change;
+    EV_SET(&change, fd, EVFILT_READ, EV_ADD, 0, 0, nullptr);
+    return kevent(poll_fd_, &change, 1, nullptr, 0, nullptr) == 0;
+#endif
+  }
+
+  // The registration may already be gone if the descriptor was closed.
+  void Remove(int fd) {
+#if defined(__linux__)
+    epoll_ctl(poll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+#else
+    struct kevent change;
+    EV_SET(&change, fd, EVFILT_READ, EV_DELETE, 0, 0, nullptr);
+    kevent(poll_fd_, &change, 1, nullptr, 0, nullptr);
+#endif
+  }
+
+  // Blocks until at least one descriptor is readable and appends the ready
+  // descriptors to `ready_fds`. Returns the number of ready descriptors or -1.
+  int Wait(std::vector<int> &ready_fds) {
+#if defined(__linux__)
+    epoll_event events[kMaxEvents];
+    int count = HANDLE_EINTR(epoll_wait(poll_fd_, events, kMaxEvents, -1));
+    for (int i = 0; i < count; i++) ready_fds.push_back(events[i].data.fd);
+#else
+    struct kevent events[kMaxEvents];
+    int count = HANDLE_EINTR(
+        kevent(poll_fd_, nullptr, 0, events, kMaxEvents, nullptr));
+    for (int i = 0; i < count; i++) {
+      ready_fds.push_back(static_cast<int>(events[i].ident));
+    }
+#endif
+    return count;
+  }
+
+ private:
+  static constexpr int kMaxEvents = 64;
+  int poll_fd_ = -1;
+#else
+  bool Add(int fd) {
+    std::unique_lock<std::mutex> guard(mutex_);
+    fds_.push_back(fd);
+    return true;
+  }
+
+  void Remove(int fd) {
+    std::unique_lock<std::mutex> guard(mutex_);
+    fds_.erase(std::remove(fds_.begin(), fds_.end(), fd), fds_.end());
+  }
+
+  int Wait(std::vector<int> &ready_fds) {
+    {
+      std::unique_lock<std::mutex> guard(mutex_);
+      waited_fds_ = fds_;
+    }
+    waiter_->reset();
+    for (int fd : waited_fds_) waiter_->update(fd, SocketWaiter::kEventRead);
+    int retval = waiter_->wait(std::numeric_limits<int64_t>::max());
+    if (retval <= 0) return -1;
+    for (int fd : waited_fds_) {
+      if (waiter_->pendingEventsFor(fd) == SocketWaiter::kEventRead) {
+        ready_fds.push_back(fd);
+      }
+    }
+    return ready_fds.size();
+  }
+
+ private:
+  std::unique_ptr<SocketWaiter> waiter_{SocketWaiter::create()};
+  std::mutex mutex_;
+  std::vector<int> fds_;
+  // Only used by the waiting thread.
+  std::vector<int> waited_fds_;
+#endif
+};
+
 // Async File Descriptor Watcher Implementation:
 class AsyncManager::AsyncFdWatcher {
  public:
@@ -108,8 +230,16 @@ class AsyncManager::AsyncFdWatcher {
       int file_descriptor, const ReadCallback &on_read_fd_ready_callback) {
     // add file descriptor and callback
     {
-      std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
-      watched_shared_fds_[file_descriptor] = on_read_fd_ready_callback;
+      std::unique_lock<std::mutex> guard(internal_mutex_);
+      if (!poller_) poller_ = std::make_unique<FdPoller>();
+      watched_shared_fds_[file_descriptor] =
+          std::make_shared<ReadCallback>(on_read_fd_ready_callback);
+      if (!poller_->Add(file_descriptor)) {
+        derror("%s: Unable to watch fd %d: %s", __func__, file_descriptor,
+               strerror(errno));
+        watched_shared_fds_.erase(file_descriptor);
+        return -1;
+      }
     }
 
     // start the thread if not started yet
@@ -126,8 +256,10 @@ class AsyncManager::AsyncFdWatcher {
   }
 
   void StopWatchingFileDescriptor(int file_descriptor) {
-    std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
-    watched_shared_fds_.erase(file_descriptor);
+    std::unique_lock<std::mutex> guard(internal_mutex_);
+    if (watched_shared_fds_.erase(file_descriptor) != 0) {
+      poller_->Remove(file_descriptor);
+    }
   }
 
   AsyncFdWatcher() = default;
@@ -151,7 +283,8 @@ class AsyncManager::AsyncFdWatcher {
     }
 
     {
-      std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
+      std::unique_lock<std::mutex> guard(internal_mutex_);
+      for (auto &fdp : watched_shared_fds_) poller_->Remove(fdp.first);
       watched_shared_fds_.clear();
     }
 
@@ -176,6 +309,10 @@ class AsyncManager::AsyncFdWatcher {
     }
     android::base::socketSetNonBlocking(notification_listen_fd_);
     android::base::socketSetNonBlocking(notification_write_fd_);
+    {
+      std::unique_lock<std::mutex> guard(internal_mutex_);
+      poller_->Add(notification_listen_fd_);
+    }
 
     thread_ = std::thread([this]() { ThreadRoutine(); });
     if (!thread_.joinable()) {
@@ -194,59 +331,42 @@ class AsyncManager::AsyncFdWatcher {
     return 0;
   }
 
-  void setUpFileDescriptorSet(SocketWaiter *read_fds) {
-    // add comm channel to the set
-    read_fds->update(notification_listen_fd_, SocketWaiter::Event::kEventRead);
-
-    // add watched FDs to the set
-    {
-      std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
-      for (auto &fdp : watched_shared_fds_) {
-        read_fds->update(fdp.first, SocketWaiter::Event::kEventRead);
-      }
+  // read everything there is on the comm channel
+  void consumeThreadNotifications() {
+    char buffer[kNotificationBufferSize];
+    while (HANDLE_EINTR(android::base::socketRecv(
+               notification_listen_fd_, buffer, kNotificationBufferSize)) ==
+           kNotificationBufferSize) {
     }
   }
 
-  // check the comm channel and read everything there
-  bool consumeThreadNotifications(SocketWaiter *read_fds) {
-    if (read_fds->pendingEventsFor(notification_listen_fd_)) {
-      char buffer[kNotificationBufferSize];
-      while (HANDLE_EINTR(android::base::socketRecv(
-                 notification_listen_fd_, buffer, kNotificationBufferSize)) ==
-             kNotificationBufferSize) {
+  // call the callbacks of the ready file descriptors
+  void runAppropriateCallbacks(const std::vector<int> &ready_fds) {
+    // not a good idea to call a callback while holding the FD lock; the
+    // shared callback stays alive even if the fd stops being watched.
+    for (int fd : ready_fds) {
+      if (fd == notification_listen_fd_) continue;
+      std::shared_ptr<ReadCallback> callback;
+      {
+        std::unique_lock<std::mutex> guard(internal_mutex_);
+        auto it = watched_shared_fds_.find(fd);
+        if (it == watched_shared_fds_.end()) continue;
+        callback = it->second;
       }
-      return true;
-    }
-    return false;
-  }
-
-  // check all file descriptors and call callbacks if necesary
-  void runAppropriateCallbacks(SocketWaiter *read_fds) {
-    // not a good idea to call a callback while holding the FD lock,
-    // nor to release the lock while traversing the map
-    std::vector<decltype(watched_shared_fds_)::value_type> fds;
-    std::unique_lock<std::recursive_mutex> guard(internal_mutex_);
-    for (auto &fdc : watched_shared_fds_) {
-      auto pending = read_fds->pendingEventsFor(fdc.first);
-      if (pending == SocketWaiter::kEventRead) {
-        fds.push_back(fdc);
-      }
-    }
-
-    for (auto &p : fds) {
-      p.second(p.first);
+      (*callback)(fd);
     }
   }
 
   void ThreadRoutine() {
-    auto read_fds = std::unique_ptr<SocketWaiter>(SocketWaiter::create());
+    netsim::util::SetUpThread(netsim::util::ThreadClass::kBluetooth,
+                              "bt_fd_watcher");
+    std::vector<int> ready_fds;
     while (running_) {
-      read_fds->reset();
-      setUpFileDescriptorSet(read_fds.get());
+      ready_fds.clear();
 
       // wait until there is data available to read on some FD
-      int retval = read_fds->wait(std::numeric_limits<int64_t>::max());
-      if (retval <= 0) {  // there was some error or a timeout
+      int retval = poller_->Wait(ready_fds);
+      if (retval <= 0) {  // there was some error
         derror(
             "%s: There was an error while waiting for data on the file "
             "descriptors: %s",
@@ -254,23 +374,28 @@ class AsyncManager::AsyncFdWatcher {
         continue;
       }
 
-      consumeThreadNotifications(read_fds.get());
+      if (std::find(ready_fds.begin(), ready_fds.end(),
+                    notification_listen_fd_) != ready_fds.end()) {
+        consumeThreadNotifications();
+      }
 
       // Do not read if there was a call to stop running
       if (!running_) {
         break;
       }
 
-      runAppropriateCallbacks(read_fds.get());
+      runAppropriateCallbacks(ready_fds);
     }
   }
 
   std::atomic_bool running_{false};
   std::thread thread_;
-  std::recursive_mutex internal_mutex_;
+  std::mutex internal_mutex_;
 
-  // android::base::SocketWaiter socket_waiter_;
-  std::map<int, ReadCallback> watched_shared_fds_;
+  // Created with the first watched FD and kept until destruction, so the
+  // thread can use it without holding the lock.
+  std::unique_ptr<FdPoller> poller_;
+  std::unordered_map<int, std::shared_ptr<ReadCallback>> watched_shared_fds_;
 
   // A pair of FD to send information to the reading thread
   int notification_listen_fd_{};
@@ -278,22 +403,31 @@ class AsyncManager::AsyncFdWatcher {
 };
 
 // Async task manager implementation
+//
+// Tasks live in a pool and are never freed before the manager, so pointers
+// to them stay valid while a callback runs. Pending tasks are kept in an
+// intrusive binary min-heap ordered by (time, sequence number), where each
+// task stores its own heap position; scheduling and canceling are
+// O(log n) with no allocation once the pool is warm. Task ids index a flat
+// table instead of a map, and released ids are recycled in FIFO order so an
+// id is reused as late as possible. The tasks of each user are chained in an
+// intrusive list for CancelAsyncTasksFromUser.
 class AsyncManager::AsyncTaskManager {
  public:
   AsyncUserId GetNextUserId() { return lastUserId_++; }
 
   AsyncTaskId ExecAsync(AsyncUserId user_id, std::chrono::milliseconds delay,
                         const TaskCallback &callback) {
-    return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, callback, user_id));
+    return scheduleTask(std::chrono::steady_clock::now() + delay, false,
+                        std::chrono::milliseconds(0), callback, user_id);
   }
 
   AsyncTaskId ExecAsyncPeriodically(AsyncUserId user_id,
                                     std::chrono::milliseconds delay,
                                     std::chrono::milliseconds period,
                                     const TaskCallback &callback) {
-    return scheduleTask(std::make_shared<Task>(
-        std::chrono::steady_clock::now() + delay, period, callback, user_id));
+    return scheduleTask(std::chrono::steady_clock::now() + delay, true, period,
+                        callback, user_id);
   }
 
   bool CancelAsyncTask(AsyncTaskId async_task_id) {
@@ -305,18 +439,20 @@ class AsyncManager::AsyncTaskManager {
   bool CancelAsyncTasksFromUser(AsyncUserId user_id) {
     // remove task from queue (and task id association) while holding lock
     std::unique_lock<std::mutex> guard(internal_mutex_);
-    if (tasks_by_user_id_.count(user_id) == 0) {
+    auto it = tasks_by_user_id_.find(user_id);
+    if (it == tasks_by_user_id_.end()) {
       return false;
     }
-    for (auto task : tasks_by_user_id_[user_id]) {
-      cancel_task_with_lock_held(task);
+    while (auto task = it->second) {
+      cancel_task_with_lock_held(task->task_id);
     }
-    tasks_by_user_id_.erase(user_id);
+    tasks_by_user_id_.erase(it);
     return true;
   }
 
   void Synchronize(const CriticalCallback &critical) {
     std::unique_lock<std::mutex> guard(synchronization_mutex_);
+    NETSIM_TRACE_SCOPE("Synchronize");
     critical();
   }
 
@@ -329,8 +465,9 @@ class AsyncManager::AsyncTaskManager {
   int stopThread() {
     {
       std::unique_lock<std::mutex> guard(internal_mutex_);
-      tasks_by_id_.clear();
-      task_queue_.clear();
+      while (!task_queue_.empty()) {
+        releaseTask(task_queue_.front());
+      }
       if (!running_) {
         return 0;
       }
@@ -348,55 +485,139 @@ class AsyncManager::AsyncTaskManager {
   }
 
  private:
+  static constexpr size_t kNotQueued = std::numeric_limits<size_t>::max();
+
   // Holds the data for each task
-  class Task {
-   public:
-    Task(std::chrono::steady_clock::time_point time,
-         std::chrono::milliseconds period, const TaskCallback &callback,
-         AsyncUserId user)
-        : time(time),
-          periodic(true),
-          period(period),
-          callback(callback),
-          task_id(kInvalidTaskId),
-          user_id(user) {}
-    Task(std::chrono::steady_clock::time_point time,
-         const TaskCallback &callback, AsyncUserId user)
-        : time(time),
-          periodic(false),
-          callback(callback),
-          task_id(kInvalidTaskId),
-          user_id(user) {}
-
-    // Operators needed to be in a collection
-    bool operator<(const Task &another) const {
-      return std::make_pair(time, task_id) <
-             std::make_pair(another.time, another.task_id);
-    }
-
-    bool isPeriodic() const { return periodic; }
-
-    // These fields should no longer be public if the class ever becomes
-    // public or gets more complex
+  struct Task {
     std::chrono::steady_clock::time_point time;
-    bool periodic;
+    uint64_t sequence = 0;  // orders tasks due at the same time
+    bool periodic = false;
     std::chrono::milliseconds period{};
     std::mutex in_callback;  // Taken when the callback is active
     TaskCallback callback;
-    AsyncTaskId task_id;
-    AsyncUserId user_id;
+    AsyncTaskId task_id = kInvalidTaskId;
+    AsyncUserId user_id{};
+    size_t heap_index = kNotQueued;
+    // Intrusive list of the tasks of the same user.
+    Task *user_prev = nullptr;
+    Task *user_next = nullptr;
   };
 
-  // A comparator class to put shared pointers to tasks in an ordered set
-  struct task_p_comparator {
-    bool operator()(const std::shared_ptr<Task> &t1,
-                    const std::shared_ptr<Task> &t2) const {
-      return *t1 < *t2;
+  static bool earlier(const Task *t1, const Task *t2) {
+    return std::make_pair(t1->time, t1->sequence) <
+           std::make_pair(t2->time, t2->sequence);
+  }
+
+  // Binary heap maintenance, all with the lock held.
+  void heapSwap(size_t a, size_t b) {
+    std::swap(task_queue_[a], task_queue_[b]);
+    task_queue_[a]->heap_index = a;
+    task_queue_[b]->heap_index = b;
+  }
+
+  void heapSiftUp(size_t index) {
+    while (index > 0) {
+      size_t parent = (index - 1) / 2;
+      if (!earlier(task_queue_[index], task_queue_[parent])) break;
+      heapSwap(index, parent);
+      index = parent;
     }
-  };
+  }
+
+  void heapSiftDown(size_t index) {
+    while (true) {
+      size_t smallest = index;
+      for (size_t child = 2 * index + 1;
+           child <= 2 * index + 2 && child < task_queue_.size(); child++) {
+        if (earlier(task_queue_[child], task_queue_[smallest])) {
+          smallest = child;
+        }
+      }
+      if (smallest == index) break;
+      heapSwap(index, smallest);
+      index = smallest;
+    }
+  }
+
+  void heapPush(Task *task) {
+    task->heap_index = task_queue_.size();
+    task_queue_.push_back(task);
+    heapSiftUp(task->heap_index);
+  }
+
+  void heapErase(Task *task) {
+    size_t index = task->heap_index;
+    size_t last = task_queue_.size() - 1;
+    if (index != last) {
+      heapSwap(index, last);
+    }
+    task_queue_.pop_back();
+    task->heap_index = kNotQueued;
+    if (index < task_queue_.size()) {
+      heapSiftDown(index);
+      heapSiftUp(index);
+    }
+  }
+
+  // Takes a task object from the pool and assigns it a free id.
+  Task *allocateTask() {
+    AsyncTaskId task_id;
+    if (nextFreshTaskId_ <= kMaxTaskId) {
+      task_id = static_cast<AsyncTaskId>(nextFreshTaskId_++);
+    } else if (!free_task_ids_.empty()) {
+      task_id = free_task_ids_.front();
+      free_task_ids_.pop_front();
+    } else {
+      // no more room for new tasks, we need a larger type for IDs
+      return nullptr;
+    }
+    Task *task;
+    if (!free_tasks_.empty()) {
+      task = free_tasks_.back();
+      free_tasks_.pop_back();
+    } else {
+      task_pool_.push_back(std::make_unique<Task>());
+      task = task_pool_.back().get();
+    }
+    if (tasks_by_id_.empty()) {
+      tasks_by_id_.resize(static_cast<size_t>(kMaxTaskId) + 1, nullptr);
+    }
+    task->task_id = task_id;
+    tasks_by_id_[task_id] = task;
+    return task;
+  }
+
+  // Unlinks a task from every index and returns it to the pool.
+  void releaseTask(Task *task) {
+    if (task->heap_index != kNotQueued) {
+      heapErase(task);
+    }
+    if (task->user_prev) {
+      task->user_prev->user_next = task->user_next;
+    } else {
+      tasks_by_user_id_[task->user_id] = task->user_next;
+    }
+    if (task->user_next) {
+      task->user_next->user_prev = task->user_prev;
+    }
+    task->user_prev = task->user_next = nullptr;
+    tasks_by_id_[task->task_id] = nullptr;
+    free_task_ids_.push_back(task->task_id);
+    task->task_id = kInvalidTaskId;
+    task->callback = nullptr;
+    free_tasks_.push_back(task);
+  }
+
+  Task *findTask(AsyncTaskId async_task_id) const {
+    if (async_task_id == kInvalidTaskId || tasks_by_id_.empty()) {
+      return nullptr;
+    }
+    return tasks_by_id_[async_task_id];
+  }
 
   bool cancel_task_with_lock_held(AsyncTaskId async_task_id) {
-    if (tasks_by_id_.count(async_task_id) == 0) {
+    auto task = findTask(async_task_id);
+    if (task == nullptr) {
       return false;
     }
 
@@ -406,32 +627,36 @@ class AsyncManager::AsyncTaskManager {
     //   unregistering.
     // - Another thread is calling us, let's make sure the task is not active.
     if (thread_.get_id() != std::this_thread::get_id()) {
-      auto task = tasks_by_id_[async_task_id];
       const std::lock_guard<std::mutex> lock(task->in_callback);
-      task_queue_.erase(task);
-      tasks_by_id_.erase(async_task_id);
+      releaseTask(task);
     } else {
-      task_queue_.erase(tasks_by_id_[async_task_id]);
-      tasks_by_id_.erase(async_task_id);
+      releaseTask(task);
     }
 
     return true;
   }
 
-  AsyncTaskId scheduleTask(const std::shared_ptr<Task> &task) {
+  AsyncTaskId scheduleTask(std::chrono::steady_clock::time_point time,
+                           bool periodic, std::chrono::milliseconds period,
+                           const TaskCallback &callback, AsyncUserId user_id) {
+    AsyncTaskId task_id;
     {
       std::unique_lock<std::mutex> guard(internal_mutex_);
-      // no more room for new tasks, we need a larger type for IDs
-      if (tasks_by_id_.size() == kMaxTaskId)  // TODO potentially type unsafe
-        return kInvalidTaskId;
-      do {
-        lastTaskId_ = NextAsyncTaskId(lastTaskId_);
-      } while (isTaskIdInUse(lastTaskId_));
-      task->task_id = lastTaskId_;
-      // add task to the queue and map
-      tasks_by_id_[lastTaskId_] = task;
-      tasks_by_user_id_[task->user_id].insert(task->task_id);
-      task_queue_.insert(task);
+      auto task = allocateTask();
+      if (task == nullptr) return kInvalidTaskId;
+      task->time = time;
+      task->sequence = nextSequence_++;
+      task->periodic = periodic;
+      task->period = period;
+      task->callback = callback;
+      task->user_id = user_id;
+      // add task to the queue and the user's list
+      auto &user_head = tasks_by_user_id_[user_id];
+      task->user_next = user_head;
+      if (user_head) user_head->user_prev = task;
+      user_head = task;
+      heapPush(task);
+      task_id = task->task_id;
     }
     // start thread if necessary
     int started = tryStartThread();
@@ -442,11 +667,7 @@ class AsyncManager::AsyncTaskManager {
     // notify the thread so that it knows of the new task
     internal_cond_var_.notify_one();
     // return task id
-    return task->task_id;
-  }
-
-  bool isTaskIdInUse(const AsyncTaskId &task_id) const {
-    return tasks_by_id_.count(task_id) != 0;
+    return task_id;
   }
 
   int tryStartThread() {
@@ -467,32 +688,50 @@ class AsyncManager::AsyncTaskManager {
   }
 
   void ThreadRoutine() {
+    netsim::util::SetUpThread(netsim::util::ThreadClass::kBluetooth,
+                              "bt_async_task");
     while (running_) {
       TaskCallback callback;
-      std::shared_ptr<Task> task_p;
+      Task *task_p = nullptr;
       bool run_it = false;
       {
         std::unique_lock<std::mutex> guard(internal_mutex_);
         if (!task_queue_.empty()) {
-          task_p = *(task_queue_.begin());
-          if (task_p->time < std::chrono::steady_clock::now()) {
+          auto next = task_queue_.front();
+          auto now = std::chrono::steady_clock::now();
+          if (next->time < now) {
             run_it = true;
-            callback = task_p->callback;
-            task_queue_.erase(task_p);  // need to remove and add again if
-                                        // periodic to update order
-            if (task_p->isPeriodic()) {
-              task_p->time += task_p->period;
-              task_queue_.insert(task_p);
+            if (netsim::util::TracingEnabled()) {
+              netsim::util::TraceCounter("AsyncManager queue depth",
+                                         task_queue_.size());
+              netsim::util::TraceCounter(
+                  "AsyncManager lag us",
+                  std::chrono::duration_cast<std::chrono::microseconds>(
+                      now - next->time)
+                      .count());
+            }
+            if (next->periodic) {
+              // Re-queue right away to update order; the task stays
+              // registered and its in_callback lock guards the run.
+              callback = next->callback;
+              next->time += next->period;
+              next->sequence = nextSequence_++;
+              heapSiftDown(next->heap_index);
+              task_p = next;
             } else {
-              tasks_by_user_id_[task_p->user_id].erase(task_p->task_id);
-              tasks_by_id_.erase(task_p->task_id);
+              callback = std::move(next->callback);
+              releaseTask(next);
             }
           }
         }
       }
       if (run_it) {
-        const std::lock_guard<std::mutex> lock(task_p->in_callback);
-        Synchronize(callback);
+        if (task_p) {
+          const std::lock_guard<std::mutex> lock(task_p->in_callback);
+          Synchronize(callback);
+        } else {
+          Synchronize(callback);
+        }
       }
       {
         std::unique_lock<std::mutex> guard(internal_mutex_);
@@ -502,9 +741,9 @@ class AsyncManager::AsyncTaskManager {
         if (task_queue_.size() > 0) {
           // Make a copy of the time_point because wait_until takes a reference
           // to it and may read it after waiting, by which time the task may
-          // have been freed (e.g. via CancelAsyncTask).
+          // have been recycled (e.g. via CancelAsyncTask).
           std::chrono::steady_clock::time_point time =
-              (*task_queue_.begin())->time;
+              task_queue_.front()->time;
           internal_cond_var_.wait_until(guard, time);
         } else {
           internal_cond_var_.wait(guard);
@@ -519,11 +758,25 @@ class AsyncManager::AsyncTaskManager {
   std::mutex synchronization_mutex_;
   std::condition_variable internal_cond_var_;
 
-  AsyncTaskId lastTaskId_ = kInvalidTaskId;
   AsyncUserId lastUserId_{1};
-  std::map<AsyncTaskId, std::shared_ptr<Task>> tasks_by_id_;
-  std::map<AsyncUserId, std::set<AsyncTaskId>> tasks_by_user_id_;
-  std::set<std::shared_ptr<Task>, task_p_comparator> task_queue_;
+  uint64_t nextSequence_ = 0;
+
+  // Task storage. Objects are recycled through free_tasks_ and only
+  // destroyed with the manager.
+  std::vector<std::unique_ptr<Task>> task_pool_;
+  std::vector<Task *> free_tasks_;
+
+  // Ids never handed out yet start at nextFreshTaskId_; released ids are
+  // reused oldest first.
+  uint32_t nextFreshTaskId_ = 1;
+  std::deque<AsyncTaskId> free_task_ids_;
+
+  // Indexed by task id, allocated on first use.
+  std::vector<Task *> tasks_by_id_;
+  // Head of each user's task list.
+  std::unordered_map<AsyncUserId, Task *> tasks_by_user_id_;
+  // Min-heap of pending tasks.
+  std::vector<Task *> task_queue_;
 };
 
 // Async Manager Implementation:
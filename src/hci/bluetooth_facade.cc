@@ -16,27 +16,49 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <future>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "core/federation.h"
 #include "hci/address.h"
+#include "hci/chip_table.h"
+#include "hci/controller_state.h"
 #include "hci/hci_packet_transport.h"
+#include "hci/hci_scheduler.h"
+#include "hci/ranging.h"
+#include "hci/spatial_index.h"
 #include "model/setup/async_manager.h"
 #include "model/setup/test_command_handler.h"
 #include "model/setup/test_model.h"
 #include "netsim-daemon/src/ffi.rs.h"
 #include "netsim/config.pb.h"
+#include "netsim/federation.pb.h"
 #include "rust/cxx.h"
+#include "util/chip_snapshot.h"
 #include "util/filesystem.h"
+#include "util/intern_table.h"
+#include "util/latency_histogram.h"
+#include "util/serialized_cache.h"
 #include "util/log.h"
+#include "util/packet_pool.h"
+#include "util/trace.h"
 
 #ifndef NETSIM_ANDROID_EMULATOR
 #include "net/posix/posix_async_socket_server.h"
@@ -50,7 +72,6 @@ using netsim::model::State;
 
 namespace netsim::hci::facade {
 
-int8_t SimComputeRssi(int send_id, int recv_id, int8_t tx_power);
 void IncrTx(uint32_t send_id, rootcanal::Phy::Type phy_type);
 void IncrRx(uint32_t receive_id, rootcanal::Phy::Type phy_type);
 
@@ -60,9 +81,84 @@ using namespace rootcanal;
 using rootcanal::PhyDevice;
 using rootcanal::PhyLayer;
 
+class SimPhyLayer;
+class SimTestModel;
+
+// A chip waiting to be attached by the thread of its shard.
+struct PendingAttach {
+  std::shared_ptr<rootcanal::HciDevice> hci_device;
+  std::optional<Address> address;
+  std::promise<uint32_t> facade_id;
+};
+
+using RustDeviceMap =
+    std::map<PhyDevice::Identifier, std::shared_ptr<RustDevice>>;
+
+// A partition of the Bluetooth controllers. Each shard owns a TestModel
+// driven by its own AsyncManager thread, so controllers of different shards
+// never contend on the same lock.
+//
+// rootcanal device ids are local to a shard; the facade id seen by the rest of
+// netsim is `device_id * num_shards + shard index`, which is the rootcanal
+// device id itself when there is a single shard.
+struct Shard {
+  uint32_t index;
+  std::shared_ptr<rootcanal::AsyncManager> async_manager;
+  // Orders the requests of the transports of the shard.
+  std::shared_ptr<HciScheduler> hci_scheduler;
+  rootcanal::AsyncUserId user_id{};
+  std::shared_ptr<SimTestModel> test_model;
+  size_t phy_low_energy_index;
+  size_t phy_classic_index;
+  // Set up by Start and read-only afterwards.
+  std::map<rootcanal::Phy::Type, SimPhyLayer *> phy_layers;
+  // Used to generate addresses that are unique across shards.
+  uint16_t next_address = 0;
+  // Positions of the simulation devices seen by this shard, refreshed when
+  // the position generation of the device manager changes.
+  SpatialIndex spatial_index;
+  uint64_t position_generation = 0;
+  // Chips added concurrently are attached by a single task.
+  std::mutex attach_mutex;
+  std::vector<PendingAttach> pending_attaches;
+  // Rust devices by device id, which Deliver hands packets to directly.
+  // Replaced whole under rust_devices_mutex and read with atomic_load, so
+  // Deliver does not lock.
+  std::mutex rust_devices_mutex;
+  std::shared_ptr<const RustDeviceMap> rust_devices;
+};
+
+// RSSI reported through ComputeRssi for receivers out of radio range.
+constexpr int8_t kOutOfRangeRssi = -120;
+
+void SyncPositions(Shard &shard);
+std::optional<int8_t> SimComputeRssi(Shard &shard, uint32_t send_id,
+                                     uint32_t recv_id, int8_t tx_power);
+std::optional<int8_t> SimComputeDeviceRssi(Shard &shard, uint32_t send_device,
+                                           uint32_t recv_id, int8_t tx_power);
+void ForwardToFederation(Shard &shard, rootcanal::Phy::Type phy_type,
+                         uint32_t sender, int8_t tx_power,
+                         std::vector<uint8_t> const &packet);
+
+// Created by Start and never resized.
+std::vector<std::unique_ptr<Shard>> gShards;
+
+uint32_t ToFacadeId(const Shard &shard, PhyDevice::Identifier device_id) {
+  return static_cast<uint32_t>(device_id * gShards.size() + shard.index);
+}
+
+Shard &ShardOf(uint32_t facade_id) {
+  return *gShards[facade_id % gShards.size()];
+}
+
+PhyDevice::Identifier ToDeviceId(uint32_t facade_id) {
+  return facade_id / gShards.size();
+}
+
 class SimPhyLayer : public PhyLayer {
-  // for constructor inheritance
-  using PhyLayer::PhyLayer;
+ public:
+  SimPhyLayer(PhyLayer::Identifier id, rootcanal::Phy::Type type, Shard *shard)
+      : PhyLayer(id, type), shard_(shard) {}
 
   // Overrides ComputeRssi in PhyLayerFactory to provide
   // simulated RSSI information using actual spatial
@@ -70,41 +166,140 @@ class SimPhyLayer : public PhyLayer {
   int8_t ComputeRssi(PhyDevice::Identifier sender_id,
                      PhyDevice::Identifier receiver_id,
                      int8_t tx_power) override {
-    return SimComputeRssi(sender_id, receiver_id, tx_power);
+    return SimComputeRssi(*shard_, ToFacadeId(*shard_, sender_id),
+                          ToFacadeId(*shard_, receiver_id), tx_power)
+        .value_or(kOutOfRangeRssi);
   }
 
-  // Overrides Send in PhyLayerFactory to add Rx/Tx statistics.
+  // Overrides Send in PhyLayerFactory to add Rx/Tx statistics and deliver to
+  // the devices of the other shards and of the federation.
   void Send(std::vector<uint8_t> const &packet, int8_t tx_power,
             PhyDevice::Identifier sender_id) override {
-    IncrTx(sender_id, type);
+    NETSIM_TRACE_SCOPE("SimPhyLayer::Send");
+    auto sender = ToFacadeId(*shard_, sender_id);
+    IncrTx(sender, type);
+    Deliver(packet, tx_power, sender);
+    if (federation::Enabled()) {
+      ForwardToFederation(*shard_, type, sender, tx_power, packet);
+    }
+    if (gShards.size() == 1) return;
+
+    // Devices of another shard must only be touched from the thread of that
+    // shard: post one copy of the packet to each of them.
+    std::shared_ptr<const std::vector<uint8_t>> shared_packet =
+        util::PacketPool::Copy(packet.data(), packet.size());
+    for (const auto &shard : gShards) {
+      if (shard.get() == shard_) continue;
+      auto phy_layer = shard->phy_layers.find(type);
+      if (phy_layer == shard->phy_layers.end()) continue;
+      shard->async_manager->ExecAsync(
+          shard->user_id, std::chrono::milliseconds(0),
+          [phy = phy_layer->second, shared_packet, tx_power, sender]() {
+            phy->Deliver(*shared_packet, tx_power, sender);
+          });
+    }
+  }
+
+  // Delivers a packet from the sender facade id to the devices of this shard
+  // that are in radio range.
+  void Deliver(std::vector<uint8_t> const &packet, int8_t tx_power,
+               uint32_t sender) {
+    DeliverInRange(packet, [&](uint32_t receiver) -> std::optional<int8_t> {
+      if (sender == receiver) return std::nullopt;
+      return SimComputeRssi(*shard_, sender, receiver, tx_power);
+    });
+  }
+
+  // Delivers a packet sent by the device of another node of the federation,
+  // known to the spatial index as remote_device.
+  void DeliverRemote(std::vector<uint8_t> const &packet, int8_t tx_power,
+                     uint32_t remote_device) {
+    DeliverInRange(packet, [&](uint32_t receiver) {
+      return SimComputeDeviceRssi(*shard_, remote_device, receiver, tx_power);
+    });
+  }
+
+ private:
+  // Delivers to the devices for which rssi_of(facade id) has a value.
+  template <class RssiOf>
+  void DeliverInRange(std::vector<uint8_t> const &packet, RssiOf &&rssi_of) {
+    SyncPositions(*shard_);
+    auto rust_devices = std::atomic_load(&shard_->rust_devices);
     for (const auto &device : phy_devices_) {
-      if (sender_id != device->id) {
-        IncrRx(device->id, type);
-        device->Receive(packet, type,
-                        ComputeRssi(sender_id, device->id, tx_power));
+      auto receiver = ToFacadeId(*shard_, device->id);
+      auto rssi = rssi_of(receiver);
+      if (!rssi) continue;
+      IncrRx(receiver, type);
+      if (rust_devices) {
+        auto rust_device = rust_devices->find(device->id);
+        if (rust_device != rust_devices->end()) {
+          rust_device->second->ReceiveLinkLayerBytes(packet);
+          continue;
+        }
       }
+      device->Receive(packet, type, *rssi);
     }
   }
+
+  Shard *shard_;
 };
 
 class SimTestModel : public rootcanal::TestModel {
+ public:
   // for constructor inheritance
   using rootcanal::TestModel::TestModel;
 
+  void SetShard(Shard *shard) { shard_ = shard; }
+
+ private:
   std::unique_ptr<rootcanal::PhyLayer> CreatePhyLayer(
       PhyLayer::Identifier id, rootcanal::Phy::Type type) override {
-    return std::make_unique<SimPhyLayer>(id, type);
+    auto phy_layer = std::make_unique<SimPhyLayer>(id, type, shard_);
+    shard_->phy_layers[type] = phy_layer.get();
+    return phy_layer;
   }
-};
 
-size_t phy_low_energy_index_;
-size_t phy_classic_index_;
+  Shard *shard_ = nullptr;
+};
 
 bool gStarted = false;
-std::shared_ptr<rootcanal::AsyncManager> gAsyncManager;
-rootcanal::AsyncUserId gSocketUserId{};
-std::shared_ptr<SimTestModel> gTestModel;
-std::shared_ptr<rootcanal::configuration::Controller> controller_proto_;
+
+// Parsed controller configuration, shared by all the chips added with the
+// same configuration bytes. Immutable once built.
+class ControllerConfig {
+ public:
+  explicit ControllerConfig(rootcanal::configuration::Controller proto)
+      : proto_(std::move(proto)), properties_(proto_) {}
+
+  const rootcanal::configuration::Controller &Proto() const { return proto_; }
+
+  const rootcanal::ControllerProperties &Properties() const {
+    return properties_;
+  }
+
+  // Returns the bt_properties field of a model::Chip::Bluetooth serialized
+  // on its own, computed on first use. Appending it to a serialized model
+  // without bt_properties gives the serialization of the full model.
+  const std::string &SerializedField() const {
+    std::call_once(serialized_once_, [this] {
+      model::Chip::Bluetooth bluetooth;
+      *bluetooth.mutable_bt_properties() = proto_;
+      serialized_field_ = bluetooth.SerializeAsString();
+    });
+    return serialized_field_;
+  }
+
+ private:
+  const rootcanal::configuration::Controller proto_;
+  const rootcanal::ControllerProperties properties_;
+  mutable std::once_flag serialized_once_;
+  mutable std::string serialized_field_;
+};
+
+// Configuration used when a chip does not provide one, set by Start.
+std::shared_ptr<const ControllerConfig> default_controller_config_;
+// Configurations provided by the chips, interned by their bytes.
+util::InternTable<ControllerConfig> controller_configs_;
 
 #ifndef NETSIM_ANDROID_EMULATOR
 // test port
@@ -124,24 +319,28 @@ bool ChangedState(model::State a, model::State b) {
 
 using ::android::net::PosixAsyncSocketServer;
 
+// The test channel drives the first shard.
 void SetUpTestChannel(uint16_t instance_num) {
+  auto &shard = *gShards[0];
   gTestSocketServer = std::make_shared<PosixAsyncSocketServer>(
-      kDefaultTestPort + instance_num - 1, gAsyncManager.get());
+      kDefaultTestPort + instance_num - 1, shard.async_manager.get());
 
-  gTestChannel = std::make_unique<rootcanal::TestCommandHandler>(*gTestModel);
+  gTestChannel =
+      std::make_unique<rootcanal::TestCommandHandler>(*shard.test_model);
 
   gTestChannelTransport = std::make_unique<rootcanal::TestChannelTransport>();
   gTestChannelTransport->RegisterCommandHandler(
       [](const std::string &name, const std::vector<std::string> &args) {
-        gAsyncManager->ExecAsync(gSocketUserId, std::chrono::milliseconds(0),
-                                 [name, args]() {
-                                   std::string args_str = "";
-                                   for (auto arg : args) args_str += " " + arg;
-                                   if (name == "END_SIMULATION") {
-                                   } else {
-                                     gTestChannel->HandleCommand(name, args);
-                                   }
-                                 });
+        auto &shard = *gShards[0];
+        shard.async_manager->ExecAsync(
+            shard.user_id, std::chrono::milliseconds(0), [name, args]() {
+              std::string args_str = "";
+              for (auto arg : args) args_str += " " + arg;
+              if (name == "END_SIMULATION") {
+              } else {
+                gTestChannel->HandleCommand(name, args);
+              }
+            });
       });
 
   bool transport_configured = gTestChannelTransport->SetUp(
@@ -180,11 +379,66 @@ void SetUpTestChannel(uint16_t instance_num) {
 }
 #endif
 
+std::unique_ptr<Shard> CreateShard(uint32_t index, bool disable_address_reuse,
+                                   float radio_range) {
+  auto shard = std::make_unique<Shard>();
+  shard->index = index;
+  shard->spatial_index.SetRange(radio_range);
+  auto async_manager = std::make_shared<rootcanal::AsyncManager>();
+  shard->async_manager = async_manager;
+  shard->hci_scheduler = CreateScheduler(async_manager);
+  // Get a user ID for tasks scheduled within the test environment.
+  shard->user_id = async_manager->GetNextUserId();
+
+  shard->test_model = std::make_shared<SimTestModel>(
+      std::bind(&rootcanal::AsyncManager::GetNextUserId, async_manager),
+      std::bind(&rootcanal::AsyncManager::ExecAsync, async_manager,
+                std::placeholders::_1, std::placeholders::_2,
+                std::placeholders::_3),
+      std::bind(&rootcanal::AsyncManager::ExecAsyncPeriodically, async_manager,
+                std::placeholders::_1, std::placeholders::_2,
+                std::placeholders::_3, std::placeholders::_4),
+      std::bind(&rootcanal::AsyncManager::CancelAsyncTasksFromUser,
+                async_manager, std::placeholders::_1),
+      std::bind(&rootcanal::AsyncManager::CancelAsyncTask, async_manager,
+                std::placeholders::_1),
+      [](const std::string & /* server */, int /* port */,
+         rootcanal::Phy::Type /* phy_type */) { return nullptr; });
+  shard->test_model->SetShard(shard.get());
+
+  // Disable Address Reuse if '--disable_address_reuse' flag is true
+  // TODO: once config files are active, use the value from config proto
+  shard->test_model->SetReuseDeviceAddresses(!disable_address_reuse);
+
+  // NOTE: 0:BR_EDR, 1:LOW_ENERGY. The order is used by bluetooth CTS.
+  shard->phy_classic_index =
+      shard->test_model->AddPhy(rootcanal::Phy::Type::BR_EDR);
+  shard->phy_low_energy_index =
+      shard->test_model->AddPhy(rootcanal::Phy::Type::LOW_ENERGY);
+  return shard;
+}
+
+// Each TestModel generates addresses from its own device ids, which collide
+// between shards. Hand out addresses da:4c:10:<shard>:<sequence> instead.
+std::optional<Address> NextShardAddress(Shard &shard) {
+  if (gShards.size() == 1) return std::nullopt;
+  uint16_t sequence = shard.next_address++;
+  uint8_t addr[rootcanal::Address::kLength] = {
+      static_cast<uint8_t>(sequence & 0xff),
+      static_cast<uint8_t>(sequence >> 8),
+      static_cast<uint8_t>(shard.index),
+      0x10,
+      0x4c,
+      0xda};
+  return rootcanal::Address(addr);
+}
+
 }  // namespace
 
 // Initialize the rootcanal library.
 void Start(const rust::Slice<::std::uint8_t const> proto_bytes,
-           uint16_t instance_num, bool disable_address_reuse) {
+           uint16_t instance_num, bool disable_address_reuse,
+           uint16_t num_shards) {
   if (gStarted) return;
 
   // output is to a file, so no color wanted
@@ -192,8 +446,8 @@ void Start(const rust::Slice<::std::uint8_t const> proto_bytes,
 
   config::Bluetooth config;
   config.ParseFromArray(proto_bytes.data(), proto_bytes.size());
-  controller_proto_ = std::make_shared<rootcanal::configuration::Controller>(
-      config.properties());
+  rootcanal::configuration::Controller controller_proto = config.properties();
+  util::SetLatencyStatsEnabled(config.latency_stats());
 
   // When emulators restore from a snapshot the PacketStreamer connection to
   // netsim is recreated with a new (uninitialized) Rootcanal device. However
@@ -202,38 +456,21 @@ void Start(const rust::Slice<::std::uint8_t const> proto_bytes,
   // before a HCI Reset. The flag below causes a hardware error event that
   // triggers the Reset from the Bluetooth Stack.
 
-  controller_proto_->mutable_quirks()->set_hardware_error_before_reset(true);
-
-  gAsyncManager = std::make_shared<rootcanal::AsyncManager>();
-  // Get a user ID for tasks scheduled within the test environment.
-  gSocketUserId = gAsyncManager->GetNextUserId();
+  controller_proto.mutable_quirks()->set_hardware_error_before_reset(true);
+  default_controller_config_ =
+      std::make_shared<ControllerConfig>(std::move(controller_proto));
 
-  gTestModel = std::make_unique<SimTestModel>(
-      std::bind(&rootcanal::AsyncManager::GetNextUserId, gAsyncManager),
-      std::bind(&rootcanal::AsyncManager::ExecAsync, gAsyncManager,
-                std::placeholders::_1, std::placeholders::_2,
-                std::placeholders::_3),
-      std::bind(&rootcanal::AsyncManager::ExecAsyncPeriodically, gAsyncManager,
-                std::placeholders::_1, std::placeholders::_2,
-                std::placeholders::_3, std::placeholders::_4),
-      std::bind(&rootcanal::AsyncManager::CancelAsyncTasksFromUser,
-                gAsyncManager, std::placeholders::_1),
-      std::bind(&rootcanal::AsyncManager::CancelAsyncTask, gAsyncManager,
-                std::placeholders::_1),
-      [](const std::string & /* server */, int /* port */,
-         rootcanal::Phy::Type /* phy_type */) { return nullptr; });
-
-  // Disable Address Reuse if '--disable_address_reuse' flag is true
-  // TODO: once config files are active, use the value from config proto
-  gTestModel->SetReuseDeviceAddresses(!disable_address_reuse);
-
-  // NOTE: 0:BR_EDR, 1:LOW_ENERGY. The order is used by bluetooth CTS.
-  phy_classic_index_ = gTestModel->AddPhy(rootcanal::Phy::Type::BR_EDR);
-  phy_low_energy_index_ = gTestModel->AddPhy(rootcanal::Phy::Type::LOW_ENERGY);
+  if (num_shards == 0) num_shards = 1;
+  BtsLogInfo("Starting %d bluetooth shard(s)", num_shards);
+  gShards.clear();
+  for (uint32_t index = 0; index < num_shards; index++) {
+    gShards.push_back(
+        CreateShard(index, disable_address_reuse, config.radio_range()));
+  }
 
   // TODO: Remove test channel.
 #ifdef NETSIM_ANDROID_EMULATOR
-  auto testCommands = rootcanal::TestCommandHandler(*gTestModel);
+  auto testCommands = rootcanal::TestCommandHandler(*gShards[0]->test_model);
   testCommands.RegisterSendResponse([](const std::string &) {});
   testCommands.SetTimerPeriod({"5"});
   testCommands.StartTimer({});
@@ -250,12 +487,15 @@ void Stop() {
   gStarted = false;
 }
 
-void PatchPhy(int device_id, bool isAddToPhy, bool isLowEnergy) {
-  auto phy_index = (isLowEnergy) ? phy_low_energy_index_ : phy_classic_index_;
+void PatchPhy(uint32_t facade_id, bool isAddToPhy, bool isLowEnergy) {
+  auto &shard = ShardOf(facade_id);
+  auto device_id = ToDeviceId(facade_id);
+  auto phy_index =
+      (isLowEnergy) ? shard.phy_low_energy_index : shard.phy_classic_index;
   if (isAddToPhy) {
-    gTestModel->AddDeviceToPhy(device_id, phy_index);
+    shard.test_model->AddDeviceToPhy(device_id, phy_index);
   } else {
-    gTestModel->RemoveDeviceFromPhy(device_id, phy_index);
+    shard.test_model->RemoveDeviceFromPhy(device_id, phy_index);
   }
 }
 
@@ -263,52 +503,88 @@ class ChipInfo {
  public:
   uint32_t simulation_device;
   std::shared_ptr<model::Chip::Bluetooth> model;
-  int le_tx_count = 0;
-  int classic_tx_count = 0;
-  int le_rx_count = 0;
-  int classic_rx_count = 0;
-  std::shared_ptr<rootcanal::configuration::Controller> controller_proto;
-  std::unique_ptr<rootcanal::ControllerProperties> controller_properties;
+  std::shared_ptr<const ControllerConfig> controller_config;
+  // Bumped after every change of the model.
+  std::atomic<uint64_t> model_version{0};
+  // Serialized model for GetCxx, valid for a model version and counters.
+  util::SerializedCache<std::pair<uint64_t, ChipTable::Counters>> serialized;
+  // Set for HCI chips whose state is kept in util::SnapshotStore.
+  std::string snapshot_key;
+  std::vector<uint8_t> address;
+  std::shared_ptr<ControllerState> controller_state;
 
   ChipInfo(uint32_t simulation_device,
            std::shared_ptr<model::Chip::Bluetooth> model)
       : simulation_device(simulation_device), model(model) {}
-  ChipInfo(
-      uint32_t simulation_device, std::shared_ptr<model::Chip::Bluetooth> model,
-      std::shared_ptr<rootcanal::configuration::Controller> controller_proto,
-      std::unique_ptr<rootcanal::ControllerProperties> controller_properties)
+  ChipInfo(uint32_t simulation_device,
+           std::shared_ptr<model::Chip::Bluetooth> model,
+           std::shared_ptr<const ControllerConfig> controller_config)
       : simulation_device(simulation_device),
         model(model),
-        controller_proto(std::move(controller_proto)),
-        controller_properties(std::move(controller_properties)) {}
+        controller_config(std::move(controller_config)) {}
 };
 
+// Chip models, used by the frontend requests. Guarded by a shared mutex.
+std::shared_mutex id_to_chip_info_mutex_;
 std::unordered_map<uint32_t, std::shared_ptr<ChipInfo>> id_to_chip_info_;
 
+// Counters and simulation devices of the chips, used for every packet.
+ChipTable chip_table_;
+
+std::shared_ptr<ChipInfo> FindChipInfo(uint32_t id) {
+  std::shared_lock<std::shared_mutex> lock(id_to_chip_info_mutex_);
+  auto it = id_to_chip_info_.find(id);
+  return it == id_to_chip_info_.end() ? nullptr : it->second;
+}
+
+void AddChipInfo(uint32_t id, std::shared_ptr<ChipInfo> chip_info) {
+  auto simulation_device = chip_info->simulation_device;
+  {
+    std::unique_lock<std::shared_mutex> lock(id_to_chip_info_mutex_);
+    id_to_chip_info_.emplace(id, std::move(chip_info));
+  }
+  // Publish to the packet path once the chip info is complete.
+  if (!chip_table_.Publish(id, simulation_device)) {
+    BtsLogWarn("facade_id: %d out of range, radio counters disabled", id);
+  }
+}
+
+namespace {
+util::ChipSnapshot SnapshotOf(const ChipInfo &chip_info) {
+  util::ChipSnapshot snapshot;
+  snapshot.address = chip_info.address;
+  snapshot.model = chip_info.model->SerializeAsString();
+  snapshot.commands = chip_info.controller_state->Commands();
+  return snapshot;
+}
+
+// Returns the model of a chip without bt_properties.
+model::Chip::Bluetooth GetWithoutProperties(
+    const ChipInfo &chip_info, const ChipTable::Counters &counters) {
+  model::Chip::Bluetooth model;
+  model.CopyFrom(*chip_info.model.get());
+  model.mutable_classic()->set_tx_count(counters[ChipTable::kClassicTx]);
+  model.mutable_classic()->set_rx_count(counters[ChipTable::kClassicRx]);
+  model.mutable_low_energy()->set_tx_count(counters[ChipTable::kLowEnergyTx]);
+  model.mutable_low_energy()->set_rx_count(counters[ChipTable::kLowEnergyRx]);
+  return model;
+}
+}  // namespace
+
 model::Chip::Bluetooth Get(uint32_t id) {
   model::Chip::Bluetooth model;
-  if (id_to_chip_info_.find(id) != id_to_chip_info_.end()) {
-    model.CopyFrom(*id_to_chip_info_[id]->model.get());
-    auto chip_info = id_to_chip_info_[id];
-    model.mutable_classic()->set_tx_count(chip_info->classic_tx_count);
-    model.mutable_classic()->set_rx_count(chip_info->classic_rx_count);
-    model.mutable_low_energy()->set_tx_count(chip_info->le_tx_count);
-    model.mutable_low_energy()->set_rx_count(chip_info->le_rx_count);
-    if (chip_info->controller_proto) {
-      model.mutable_bt_properties()->CopyFrom(*chip_info->controller_proto);
+  if (auto chip_info = FindChipInfo(id)) {
+    model = GetWithoutProperties(*chip_info, chip_table_.Snapshot(id));
+    if (chip_info->controller_config) {
+      model.mutable_bt_properties()->CopyFrom(
+          chip_info->controller_config->Proto());
     }
   }
   return model;
 }
 
 void Reset(uint32_t id) {
-  if (id_to_chip_info_.find(id) != id_to_chip_info_.end()) {
-    auto chip_info = id_to_chip_info_[id];
-    chip_info->le_tx_count = 0;
-    chip_info->le_rx_count = 0;
-    chip_info->classic_tx_count = 0;
-    chip_info->classic_rx_count = 0;
-  }
+  chip_table_.ResetCounters(id);
   model::Chip::Bluetooth model;
   model.mutable_classic()->set_state(model::State::ON);
   model.mutable_low_energy()->set_state(model::State::ON);
@@ -316,49 +592,68 @@ void Reset(uint32_t id) {
 }
 
 void Patch(uint32_t id, const model::Chip::Bluetooth &request) {
-  if (id_to_chip_info_.find(id) == id_to_chip_info_.end()) {
+  auto chip_info = FindChipInfo(id);
+  if (!chip_info) {
     BtsLogWarn("Patch an unknown facade_id: %d", id);
     return;
   }
-  auto model = id_to_chip_info_[id]->model;
-  auto device_index = id_to_chip_info_[id]->simulation_device;
+  auto model = chip_info->model;
   // Low_energy radio state
   auto request_state = request.low_energy().state();
   auto *le = model->mutable_low_energy();
   if (ChangedState(le->state(), request_state)) {
     le->set_state(request_state);
-    PatchPhy(device_index, request_state == model::State::ON, true);
+    chip_info->model_version.fetch_add(1, std::memory_order_release);
+    PatchPhy(id, request_state == model::State::ON, true);
   }
   // Classic radio state
   request_state = request.classic().state();
   auto *classic = model->mutable_classic();
   if (ChangedState(classic->state(), request_state)) {
     classic->set_state(request_state);
-    PatchPhy(device_index, request_state == model::State::ON, false);
+    chip_info->model_version.fetch_add(1, std::memory_order_release);
+    PatchPhy(id, request_state == model::State::ON, false);
   }
 }
 
-void Remove(uint32_t id) {
+void Remove(uint32_t id, bool keep_snapshot) {
   BtsLogInfo("Removing HCI chip facade_id: %d.", id);
-  id_to_chip_info_.erase(id);
+  chip_table_.Retire(id);
+  std::shared_ptr<ChipInfo> chip_info;
+  {
+    std::unique_lock<std::shared_mutex> lock(id_to_chip_info_mutex_);
+    auto it = id_to_chip_info_.find(id);
+    if (it != id_to_chip_info_.end()) {
+      chip_info = std::move(it->second);
+      id_to_chip_info_.erase(it);
+    }
+  }
+  if (keep_snapshot && chip_info && !chip_info->snapshot_key.empty()) {
+    util::SnapshotStore::Put(chip_info->snapshot_key, SnapshotOf(*chip_info));
+  }
   // Call the transport close callback. This invokes HciDevice::Close and
   // TestModel close callback.
-  gAsyncManager->ExecAsync(gSocketUserId, std::chrono::milliseconds(0), [id]() {
-    // rootcanal will call HciPacketTransport::Close().
-    HciPacketTransport::Remove(id);
-  });
+  auto &shard = ShardOf(id);
+  shard.async_manager->ExecAsync(
+      shard.user_id, std::chrono::milliseconds(0), [id]() {
+        // rootcanal will call HciPacketTransport::Close().
+        HciPacketTransport::Remove(id);
+      });
 }
 
-// Rename AddChip(model::Chip, device, transport)
-
-uint32_t Add(uint32_t simulation_device, const std::string &address_string,
-             const rust::Slice<::std::uint8_t const> controller_proto_bytes) {
-  auto transport = std::make_shared<HciPacketTransport>(gAsyncManager);
+namespace {
 
-  std::shared_ptr<rootcanal::configuration::Controller> controller_proto =
-      controller_proto_;
-  // If the Bluetooth Controller protobuf is provided, we use the provided
-  if (controller_proto_bytes.size() != 0) {
+// Returns the parsed configuration for the controller configuration bytes,
+// parsing and validating them only the first time they are seen.
+std::shared_ptr<const ControllerConfig> GetControllerConfig(
+    uint32_t simulation_device,
+    const rust::Slice<::std::uint8_t const> controller_proto_bytes) {
+  if (controller_proto_bytes.size() == 0) return default_controller_config_;
+  std::string_view key(
+      reinterpret_cast<const char *>(controller_proto_bytes.data()),
+      controller_proto_bytes.size());
+  return controller_configs_.Intern(key, [&]() {
+    // If the Bluetooth Controller protobuf is provided, we use the provided
     rootcanal::configuration::Controller custom_proto;
     custom_proto.ParseFromArray(controller_proto_bytes.data(),
                                 controller_proto_bytes.size());
@@ -370,122 +665,384 @@ uint32_t Add(uint32_t simulation_device, const std::string &address_string,
     // the Android Bluetooth Stack does not re-initialize the controller. Our
     // solution is for Rootcanal to recognize that it is receiving HCI commands
     // before a HCI Reset. The flag below causes a hardware error event that
-    // triggers the Reset from the Bluetooth Stack.
+    // triggers the Reset from the Bluetooth Stack. Chips with a snapshot
+    // are reset and configured by Add instead, see ControllerState.
     custom_proto.mutable_quirks()->set_hardware_error_before_reset(true);
 
-    controller_proto =
-        std::make_shared<rootcanal::configuration::Controller>(custom_proto);
+    return std::make_shared<ControllerConfig>(std::move(custom_proto));
+  });
+}
+
+// Attaches the pending chips of a shard, on the thread of the shard.
+void AttachPending(Shard &shard) {
+  std::vector<PendingAttach> attaches;
+  {
+    std::lock_guard<std::mutex> lock(shard.attach_mutex);
+    attaches.swap(shard.pending_attaches);
+  }
+  for (auto &attach : attaches) {
+    auto address = attach.address ? attach.address : NextShardAddress(shard);
+    attach.facade_id.set_value(ToFacadeId(
+        shard, shard.test_model->AddHciConnection(attach.hci_device, address)));
   }
-  std::unique_ptr<rootcanal::ControllerProperties> controller_properties =
-      std::make_unique<rootcanal::ControllerProperties>(*controller_proto);
+}
 
-  auto hci_device =
-      std::make_shared<rootcanal::HciDevice>(transport, *controller_properties);
+}  // namespace
 
-  // Use the `AsyncManager` to ensure that the `AddHciConnection` method is
-  // invoked atomically, preventing data races.
-  std::promise<uint32_t> facade_id_promise;
-  auto facade_id_future = facade_id_promise.get_future();
+// Rename AddChip(model::Chip, device, transport)
+
+uint32_t Add(uint32_t simulation_device, const std::string &address_string,
+             const rust::Slice<::std::uint8_t const> controller_proto_bytes,
+             const std::string &snapshot_key) {
+  // Chips of the same device share a shard.
+  auto &shard = *gShards[simulation_device % gShards.size()];
+  auto transport = std::make_shared<HciPacketTransport>(shard.async_manager,
+                                                        shard.hci_scheduler);
+
+  auto config = GetControllerConfig(simulation_device, controller_proto_bytes);
+  auto hci_device =
+      std::make_shared<rootcanal::HciDevice>(transport, config->Properties());
 
-  std::optional<Address> address_option;
+  PendingAttach attach{hci_device, std::nullopt, {}};
+  auto snapshot = snapshot_key.empty()
+                      ? std::nullopt
+                      : util::SnapshotStore::Take(snapshot_key);
   if (address_string != "") {
-    address_option = rootcanal::Address::FromString(address_string);
+    attach.address = rootcanal::Address::FromString(address_string);
+  } else if (snapshot &&
+             snapshot->address.size() == rootcanal::Address::kLength) {
+    uint8_t addr[rootcanal::Address::kLength];
+    std::memcpy(addr, snapshot->address.data(), rootcanal::Address::kLength);
+    attach.address = rootcanal::Address(addr);
+  }
+  auto facade_id_future = attach.facade_id.get_future();
+
+  // Use the `AsyncManager` to ensure that the `AddHciConnection` method is
+  // invoked atomically, preventing data races. Only the first of the chips
+  // added at once schedules a task; it attaches all of them.
+  bool schedule;
+  {
+    std::lock_guard<std::mutex> lock(shard.attach_mutex);
+    schedule = shard.pending_attaches.empty();
+    shard.pending_attaches.push_back(std::move(attach));
+  }
+  if (schedule) {
+    shard.async_manager->ExecAsync(shard.user_id, std::chrono::milliseconds(0),
+                                   [&shard]() { AttachPending(shard); });
   }
-  gAsyncManager->ExecAsync(
-      gSocketUserId, std::chrono::milliseconds(0),
-      [hci_device, &facade_id_promise, address_option]() {
-        facade_id_promise.set_value(
-            gTestModel->AddHciConnection(hci_device, address_option));
-      });
   auto facade_id = facade_id_future.get();
 
+  auto controller_state = std::make_shared<ControllerState>();
+  transport->SetControllerState(controller_state);
   HciPacketTransport::Add(facade_id, transport);
   BtsLogInfo("Creating HCI facade_id: %d for device_id: %d", facade_id,
              simulation_device);
+  if (snapshot && !snapshot->commands.empty()) {
+    // Configure the controller before the first request of the host, which
+    // is queued behind the replay.
+    BtsLogInfo("Restoring %zu HCI commands for facade_id: %d",
+               snapshot->commands.size(), facade_id);
+    controller_state->Restore(snapshot->commands);
+    transport->Replay(std::move(snapshot->commands));
+  }
 
   auto model = std::make_shared<model::Chip::Bluetooth>();
   model->mutable_classic()->set_state(model::State::ON);
   model->mutable_low_energy()->set_state(model::State::ON);
 
-  id_to_chip_info_.emplace(
-      facade_id,
-      std::make_shared<ChipInfo>(simulation_device, model, controller_proto,
-                                 std::move(controller_properties)));
+  auto chip_info = std::make_shared<ChipInfo>(simulation_device, model,
+                                              std::move(config));
+  chip_info->snapshot_key = snapshot_key;
+  // Set by AddHciConnection on the shard thread, before the facade id.
+  auto address = hci_device->GetAddress();
+  chip_info->address.assign(address.data(),
+                            address.data() + rootcanal::Address::kLength);
+  chip_info->controller_state = std::move(controller_state);
+  AddChipInfo(facade_id, std::move(chip_info));
+
+  if (snapshot && !snapshot->model.empty()) {
+    model::Chip::Bluetooth restored;
+    if (restored.ParseFromString(snapshot->model)) Patch(facade_id, restored);
+  }
   return facade_id;
 }
 
-void RemoveRustDevice(uint32_t facade_id) {
-  gTestModel->RemoveDevice(facade_id);
+void SnapshotChips(util::SimulationSnapshot &snapshot) {
+  std::shared_lock<std::shared_mutex> lock(id_to_chip_info_mutex_);
+  for (const auto &[id, chip_info] : id_to_chip_info_) {
+    if (chip_info->snapshot_key.empty()) continue;
+    snapshot.insert_or_assign(chip_info->snapshot_key, SnapshotOf(*chip_info));
+  }
 }
 
-rust::Box<AddRustDeviceResult> AddRustDevice(
-    uint32_t simulation_device,
-    rust::Box<DynRustBluetoothChipCallbacks> callbacks, const std::string &type,
-    const std::string &address) {
-  auto rust_device =
-      std::make_shared<RustDevice>(std::move(callbacks), type, address);
-
+uint32_t AddLowEnergyDevice(uint32_t simulation_device,
+                            std::shared_ptr<rootcanal::Device> device) {
   // TODO: Use the `AsyncManager` to ensure that the `AddDevice` and
   // `AddDeviceToPhy` methods are invoked atomically, preventing data races.
   // For unknown reason, use `AsyncManager` hangs.
-  auto facade_id = gTestModel->AddDevice(rust_device);
-  gTestModel->AddDeviceToPhy(facade_id, phy_low_energy_index_);
+  // Rust devices live in the first shard.
+  auto &shard = *gShards[0];
+  auto device_id = shard.test_model->AddDevice(std::move(device));
+  shard.test_model->AddDeviceToPhy(device_id, shard.phy_low_energy_index);
+  auto facade_id = ToFacadeId(shard, device_id);
 
   auto model = std::make_shared<model::Chip::Bluetooth>();
   // Only enable ble for beacon.
   model->mutable_low_energy()->set_state(model::State::ON);
-  id_to_chip_info_.emplace(
-      facade_id, std::make_shared<ChipInfo>(simulation_device, model));
+  AddChipInfo(facade_id,
+              std::make_shared<ChipInfo>(simulation_device, model));
+  return facade_id;
+}
+
+namespace {
+
+// Copies the Rust devices of the shard, applies update and publishes the
+// copy to Deliver.
+template <class Update>
+void UpdateRustDevices(Shard &shard, Update update) {
+  std::lock_guard<std::mutex> lock(shard.rust_devices_mutex);
+  auto current = std::atomic_load(&shard.rust_devices);
+  auto rust_devices = current ? std::make_shared<RustDeviceMap>(*current)
+                              : std::make_shared<RustDeviceMap>();
+  update(*rust_devices);
+  std::atomic_store(
+      &shard.rust_devices,
+      std::shared_ptr<const RustDeviceMap>(std::move(rust_devices)));
+}
+
+// Runs the Rust Tick of a device and schedules the next one on the timer of
+// its shard, for as long as the device exists and no later wake happened.
+void RunRustTick(Shard &shard, const std::weak_ptr<RustDevice> &weak_device,
+                 uint64_t generation) {
+  auto rust_device = weak_device.lock();
+  if (!rust_device || rust_device->TickGeneration() != generation) return;
+  auto delay = rust_device->TickCallbacks();
+  if (!delay) return;
+  shard.async_manager->ExecAsync(
+      shard.user_id, *delay, [&shard, weak_device, generation]() {
+        RunRustTick(shard, weak_device, generation);
+      });
+}
+
+// Restarts the ticks of a device from its shard thread.
+void WakeRustTick(Shard &shard, std::weak_ptr<RustDevice> weak_device) {
+  shard.async_manager->ExecAsync(
+      shard.user_id, std::chrono::milliseconds(0),
+      [&shard, weak_device = std::move(weak_device)]() {
+        auto rust_device = weak_device.lock();
+        if (!rust_device) return;
+        RunRustTick(shard, weak_device, rust_device->NextTickGeneration());
+      });
+}
+
+}  // namespace
+
+void RemoveRustDevice(uint32_t facade_id) {
+  auto &shard = ShardOf(facade_id);
+  auto device_id = ToDeviceId(facade_id);
+  UpdateRustDevices(shard, [device_id](auto &rust_devices) {
+    rust_devices.erase(device_id);
+  });
+  shard.test_model->RemoveDevice(device_id);
+}
+
+rust::Box<AddRustDeviceResult> AddRustDevice(
+    uint32_t simulation_device,
+    rust::Box<DynRustBluetoothChipCallbacks> callbacks, const std::string &type,
+    const std::string &address, bool batch_receive) {
+  auto rust_device = std::make_shared<RustDevice>(std::move(callbacks), type,
+                                                  address, batch_receive);
+  auto facade_id = AddLowEnergyDevice(simulation_device, rust_device);
+  auto device_id = ToDeviceId(facade_id);
+  auto &shard = ShardOf(facade_id);
+  UpdateRustDevices(shard, [&](auto &rust_devices) {
+    rust_devices[device_id] = rust_device;
+  });
+  WakeRustTick(shard, rust_device);
   return CreateAddRustDeviceResult(
       facade_id, std::make_unique<RustBluetoothChip>(rust_device));
 }
 
+void WakeRustDevice(uint32_t facade_id) {
+  auto &shard = ShardOf(facade_id);
+  auto rust_devices = std::atomic_load(&shard.rust_devices);
+  if (!rust_devices) return;
+  auto rust_device = rust_devices->find(ToDeviceId(facade_id));
+  if (rust_device == rust_devices->end()) return;
+  WakeRustTick(shard, rust_device->second);
+}
+
 void SetRustDeviceAddress(
     uint32_t facade_id,
     std::array<uint8_t, rootcanal::Address::kLength> address) {
   uint8_t addr[rootcanal::Address::kLength];
   std::memcpy(addr, address.data(), rootcanal::Address::kLength);
-  gTestModel->SetDeviceAddress(facade_id, rootcanal::Address(addr));
+  ShardOf(facade_id).test_model->SetDeviceAddress(ToDeviceId(facade_id),
+                                                 rootcanal::Address(addr));
 }
 
 void IncrTx(uint32_t id, rootcanal::Phy::Type phy_type) {
-  if (id_to_chip_info_.find(id) != id_to_chip_info_.end()) {
-    auto chip_info = id_to_chip_info_[id];
-    if (phy_type == rootcanal::Phy::Type::LOW_ENERGY) {
-      chip_info->le_tx_count++;
-    } else {
-      chip_info->classic_tx_count++;
-    }
-  }
+  chip_table_.Increment(id, phy_type == rootcanal::Phy::Type::LOW_ENERGY
+                                ? ChipTable::kLowEnergyTx
+                                : ChipTable::kClassicTx);
 }
 
 void IncrRx(uint32_t id, rootcanal::Phy::Type phy_type) {
-  if (id_to_chip_info_.find(id) != id_to_chip_info_.end()) {
-    auto chip_info = id_to_chip_info_[id];
-    if (phy_type == rootcanal::Phy::Type::LOW_ENERGY) {
-      chip_info->le_rx_count++;
-    } else {
-      chip_info->classic_rx_count++;
+  chip_table_.Increment(id, phy_type == rootcanal::Phy::Type::LOW_ENERGY
+                                ? ChipTable::kLowEnergyRx
+                                : ChipTable::kClassicRx);
+}
+
+namespace {
+// Updates the position of a simulation device from the device manager. The
+// positions of remote devices come with their packets instead.
+void RefreshPosition(Shard &shard, uint32_t simulation_device) {
+  if (federation::IsRemoteDevice(simulation_device)) return;
+  std::array<float, 3> position;
+  if (netsim::device::GetPositionCxx(
+          simulation_device,
+          rust::Slice<float>(position.data(), position.size()))) {
+    shard.spatial_index.Update(simulation_device,
+                               {position[0], position[1], position[2]});
+  } else {
+    shard.spatial_index.Remove(simulation_device);
+  }
+}
+}  // namespace
+
+// Called from the thread of the shard before a burst of SimComputeRssi.
+// Only the devices that moved or are gone since the last sync are read,
+// unless the device manager no longer knows that far back.
+void SyncPositions(Shard &shard) {
+  auto generation = netsim::device::GetPositionGenerationCxx();
+  if (generation == shard.position_generation) return;
+  rust::Vec<uint32_t> changed;
+  bool incremental = netsim::device::GetPositionChangesCxx(
+      shard.position_generation, changed);
+  shard.position_generation = generation;
+  if (!incremental) {
+    for (auto simulation_device : shard.spatial_index.DeviceIds()) {
+      RefreshPosition(shard, simulation_device);
+    }
+    return;
+  }
+  for (auto simulation_device : changed) {
+    // Devices not seen yet are fetched on their first lookup.
+    if (shard.spatial_index.Contains(simulation_device)) {
+      RefreshPosition(shard, simulation_device);
     }
   }
 }
 
-// TODO: Make SimComputeRssi invoke netsim::device::GetDistanceRust with dev
-// flag
-int8_t SimComputeRssi(int send_id, int recv_id, int8_t tx_power) {
-  if (id_to_chip_info_.find(send_id) == id_to_chip_info_.end() ||
-      id_to_chip_info_.find(recv_id) == id_to_chip_info_.end()) {
+// Returns nullopt when the receiver is out of radio range of the sender.
+// Distances and RSSI come from the spatial index of the shard; devices are
+// fetched from the device manager the first time they are seen.
+std::optional<int8_t> SimComputeRssi(Shard &shard, uint32_t send_id,
+                                     uint32_t recv_id, int8_t tx_power) {
+  auto send_device = chip_table_.SimulationDevice(send_id);
+  if (!send_device) {
 #ifdef NETSIM_ANDROID_EMULATOR
     // NOTE: Ignore log messages in Cuttlefish for beacon devices created by
     // test channel.
-    BtsLogWarn("Missing chip_info");
+    BtsLogWarnRateLimited("Missing chip_info");
+#endif
+    return tx_power;
+  }
+  return SimComputeDeviceRssi(shard, *send_device, recv_id, tx_power);
+}
+
+// SimComputeRssi from the simulation device of the sender, which may be a
+// remote device.
+std::optional<int8_t> SimComputeDeviceRssi(Shard &shard, uint32_t send_device,
+                                           uint32_t recv_id, int8_t tx_power) {
+  auto recv_device = chip_table_.SimulationDevice(recv_id);
+  if (!recv_device) {
+#ifdef NETSIM_ANDROID_EMULATOR
+    BtsLogWarnRateLimited("Missing chip_info");
 #endif
     return tx_power;
   }
-  auto a = id_to_chip_info_[send_id]->simulation_device;
-  auto b = id_to_chip_info_[recv_id]->simulation_device;
-  auto distance = netsim::device::GetDistanceCxx(a, b);
-  return netsim::DistanceToRssi(tx_power, distance);
+  auto a = send_device;
+  auto b = *recv_device;
+  auto &index = shard.spatial_index;
+  if (!index.Contains(a)) RefreshPosition(shard, a);
+  if (!index.Contains(b)) RefreshPosition(shard, b);
+  // Chips of one device, or of a device that is gone, are at distance 0.
+  if (a == b || !index.Contains(a) || !index.Contains(b)) {
+    return ranging::DistanceToRssi(tx_power, 0);
+  }
+  // The first lookup for a sender computes the rssi of all its receivers in
+  // one batch; the rest of the fan-out are cache hits.
+  return index.Rssi(a, b, tx_power);
+}
+
+// Forwards a packet sent by a local chip to the other nodes, with the
+// position of its device.
+void ForwardToFederation(Shard &shard, rootcanal::Phy::Type phy_type,
+                         uint32_t sender, int8_t tx_power,
+                         std::vector<uint8_t> const &packet) {
+  auto device = chip_table_.SimulationDevice(sender);
+  if (!device) return;
+  auto &index = shard.spatial_index;
+  if (!index.Contains(*device)) RefreshPosition(shard, *device);
+  std::optional<std::array<float, 3>> position;
+  if (auto known = index.PositionOf(*device)) {
+    position = {known->x, known->y, known->z};
+  }
+  federation::ForwardPhyPacket(static_cast<uint32_t>(phy_type), *device,
+                               position, tx_power, packet);
+}
+
+namespace {
+// The traffic of a federation batch, converted once for all the shards.
+struct RemoteTraffic {
+  struct Packet {
+    rootcanal::Phy::Type phy_type;
+    uint32_t sender;
+    int8_t tx_power;
+    std::vector<uint8_t> bytes;
+  };
+  std::vector<std::pair<uint32_t, SpatialIndex::Position>> positions;
+  std::vector<Packet> packets;
+};
+}  // namespace
+
+void HandleFederatedBatch(uint32_t node_id, const federation::Batch &batch) {
+  auto traffic = std::make_shared<RemoteTraffic>();
+  traffic->positions.reserve(batch.positions_size());
+  for (const auto &entry : batch.positions()) {
+    const auto &position = entry.position();
+    traffic->positions.emplace_back(
+        federation::RemoteDeviceId(node_id, entry.device_id()),
+        SpatialIndex::Position{position.x(), position.y(), position.z()});
+  }
+  traffic->packets.reserve(batch.phy_packets_size());
+  for (const auto &packet : batch.phy_packets()) {
+    traffic->packets.push_back(
+        {static_cast<rootcanal::Phy::Type>(packet.phy_type()),
+         federation::RemoteDeviceId(node_id, packet.device_id()),
+         static_cast<int8_t>(std::clamp<int32_t>(packet.tx_power(), INT8_MIN,
+                                                 INT8_MAX)),
+         std::vector<uint8_t>(packet.packet().begin(),
+                              packet.packet().end())});
+  }
+  // Like the packets of another shard, on the thread of each shard and with
+  // the positions applied first.
+  for (const auto &shard : gShards) {
+    shard->async_manager->ExecAsync(
+        shard->user_id, std::chrono::milliseconds(0),
+        [shard = shard.get(), traffic]() {
+          for (const auto &[device, position] : traffic->positions) {
+            shard->spatial_index.Update(device, position);
+          }
+          for (const auto &packet : traffic->packets) {
+            auto phy_layer = shard->phy_layers.find(packet.phy_type);
+            if (phy_layer == shard->phy_layers.end()) continue;
+            phy_layer->second->DeliverRemote(packet.bytes, packet.tx_power,
+                                             packet.sender);
+          }
+        });
+  }
 }
 
 void PatchCxx(uint32_t id,
@@ -496,13 +1053,22 @@ void PatchCxx(uint32_t id,
 }
 
 rust::Vec<::std::uint8_t> GetCxx(uint32_t id) {
-  auto bluetooth = Get(id);
-  std::vector<uint8_t> proto_bytes(bluetooth.ByteSizeLong());
-  bluetooth.SerializeToArray(proto_bytes.data(), proto_bytes.size());
-  rust::Vec<uint8_t> proto_rust_bytes;
-  std::copy(proto_bytes.begin(), proto_bytes.end(),
-            std::back_inserter(proto_rust_bytes));
-  return proto_rust_bytes;
+  auto chip_info = FindChipInfo(id);
+  if (!chip_info) return {};
+  // Re-encode only when the model or the counters changed since the last
+  // poll. The controller configuration is the bulk of the model and is
+  // shared by many chips: append its cached serialization.
+  auto counters = chip_table_.Snapshot(id);
+  auto version = std::make_pair(
+      chip_info->model_version.load(std::memory_order_acquire), counters);
+  auto bytes = chip_info->serialized.Get(version, [&](std::string &bytes) {
+    GetWithoutProperties(*chip_info, counters).SerializeToString(&bytes);
+    if (chip_info->controller_config) {
+      bytes += chip_info->controller_config->SerializedField();
+    }
+  });
+  return VecFromSlice({reinterpret_cast<const uint8_t *>(bytes->data()),
+                       bytes->size()});
 }
 
 }  // namespace netsim::hci::facade
@@ -21,8 +21,10 @@
 
 #include "hci/address.h"
 #include "hci/rust_device.h"
+#include "netsim/federation.pb.h"
 #include "netsim/model.pb.h"
 #include "rust/cxx.h"
+#include "util/chip_snapshot.h"
 
 /** Manages the bluetooth chip emulation provided by the root canal library.
  *
@@ -36,25 +38,51 @@ struct DynRustBluetoothChipCallbacks;
 struct AddRustDeviceResult;
 
 void Reset(uint32_t);
-void Remove(uint32_t);
+// keep_snapshot is set when the chip leaves because its stream
+// disconnected, so a chip added again with its snapshot_key resumes. A chip
+// deleted on request drops its state.
+void Remove(uint32_t id, bool keep_snapshot);
 void Patch(uint32_t, const model::Chip::Bluetooth &);
 model::Chip::Bluetooth Get(uint32_t);
+// A chip added with the snapshot_key of a removed chip resumes its address,
+// radio states and controller configuration, see util::SnapshotStore.
 uint32_t Add(uint32_t simulation_device, const std::string &address_string,
-             const rust::Slice<::std::uint8_t const> controller_proto_bytes);
+             const rust::Slice<::std::uint8_t const> controller_proto_bytes,
+             const std::string &snapshot_key = "");
 
+// Adds a device that has no HCI transport, such as a beacon, to the low
+// energy phy and returns its facade id. Removed with RemoveRustDevice.
+uint32_t AddLowEnergyDevice(uint32_t simulation_device,
+                            std::shared_ptr<rootcanal::Device> device);
+
+// Adds a device implemented in Rust. With batch_receive its received packets
+// are delivered once per Tick, see RustDevice.
 rust::Box<AddRustDeviceResult> AddRustDevice(
     uint32_t simulation_device,
     rust::Box<DynRustBluetoothChipCallbacks> callbacks, const std::string &type,
-    const std::string &address);
+    const std::string &address, bool batch_receive);
+// Runs the Rust Tick of the device now, e.g. after its settings changed,
+// and restarts its timer from the delay it returns.
+void WakeRustDevice(uint32_t facade_id);
 void SetRustDeviceAddress(
     uint32_t facade_id,
     std::array<uint8_t, rootcanal::Address::kLength> address);
 void RemoveRustDevice(uint32_t facade_id);
 
+// Controllers are partitioned over num_shards independent TestModels, each
+// running on its own AsyncManager thread.
 void Start(const rust::Slice<::std::uint8_t const> proto_bytes,
-           uint16_t instance_num, bool disable_address_reuse);
+           uint16_t instance_num, bool disable_address_reuse,
+           uint16_t num_shards);
 void Stop();
 
+// Adds the snapshots of the attached chips to snapshot.
+void SnapshotChips(util::SimulationSnapshot &snapshot);
+
+// Delivers the link layer packets of the devices of another node of the
+// federation to the chips in range, see core/federation.h.
+void HandleFederatedBatch(uint32_t node_id, const federation::Batch &batch);
+
 // Cxx functions for rust ffi.
 void PatchCxx(uint32_t id, const rust::Slice<::std::uint8_t const> proto_bytes);
 rust::Vec<::std::uint8_t> GetCxx(uint32_t id);
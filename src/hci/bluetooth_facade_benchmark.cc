@@ -0,0 +1,111 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of the link layer fan-out of SimPhyLayer::Send.
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/bluetooth_facade.h"
+#include "model/devices/device.h"
+#include "netsim-daemon/src/ffi.rs.h"
+#include "packets/link_layer_packets.h"
+#include "phy.h"
+#include "rust/cxx.h"
+#include "util/benchmark_counters.h"
+
+namespace netsim::hci::facade {
+namespace {
+
+constexpr int kPacketsPerIteration = 1024;
+
+// Sends bursts of link layer packets from the thread of the shard, where
+// the test model ticks its devices, and reports how long they took.
+class BenchDevice : public rootcanal::Device {
+ public:
+  explicit BenchDevice(std::vector<uint8_t> packet)
+      : packet_(std::move(packet)) {}
+
+  std::string GetTypeString() const override { return "bench"; }
+
+  std::future<std::chrono::nanoseconds> Burst(int packets) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    burst_ = packets;
+    done_ = std::promise<std::chrono::nanoseconds>();
+    return done_.get_future();
+  }
+
+  void Tick() override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (burst_ == 0) return;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < burst_; i++) {
+      SendLinkLayerPacket(packet_, rootcanal::Phy::Type::LOW_ENERGY, 0);
+    }
+    done_.set_value(std::chrono::steady_clock::now() - start);
+    burst_ = 0;
+  }
+
+ private:
+  const std::vector<uint8_t> packet_;
+  std::mutex mutex_;
+  int burst_ = 0;
+  std::promise<std::chrono::nanoseconds> done_;
+};
+
+// A Disconnect to an address no controller has: every receiver computes
+// the rssi and parses the packet, then drops it. Arg: number of receiving
+// controllers, each on its own device.
+void BM_PhyFanOut(benchmark::State &state) {
+  // Start has no effect after the first call.
+  Start({}, 0, true, 1);
+  const int receivers = state.range(0);
+  const std::vector<uint8_t> no_properties;
+  std::vector<rust::Box<device::AddChipResultCxx>> chips;
+  for (int i = 0; i < receivers; i++) {
+    auto name = "bench-" + std::to_string(i);
+    chips.push_back(device::AddChipCxx(name, name, "BLUETOOTH", "", "", "", "",
+                                       no_properties));
+  }
+  auto source = rootcanal::Address::FromString("da:4c:00:00:00:01");
+  auto destination = rootcanal::Address::FromString("da:4c:00:00:00:02");
+  auto packet =
+      model::packets::DisconnectBuilder::Create(*source, *destination, 0x13)
+          ->SerializeToBytes();
+  auto sender = std::make_shared<BenchDevice>(std::move(packet));
+  // The sender shares the position of the first receiver.
+  auto sender_id = AddLowEnergyDevice(chips[0]->GetDeviceId(), sender);
+
+  for (auto _ : state) {
+    auto elapsed = sender->Burst(kPacketsPerIteration).get();
+    state.SetIterationTime(std::chrono::duration<double>(elapsed).count());
+  }
+  util::SetPacketCounters(state, state.iterations() * kPacketsPerIteration);
+  state.counters["receivers"] = receivers;
+
+  RemoveRustDevice(sender_id);
+  for (const auto &chip : chips) {
+    device::RemoveChipCxx(chip->GetDeviceId(), chip->GetChipId());
+  }
+}
+
+BENCHMARK(BM_PhyFanOut)->Arg(1)->Arg(8)->Arg(64)->UseManualTime();
+
+}  // namespace
+}  // namespace netsim::hci::facade
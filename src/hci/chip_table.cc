@@ -0,0 +1,100 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hci/chip_table.h"
+
+namespace netsim::hci {
+
+ChipTable::ChipTable()
+    : segments_(std::make_unique<std::atomic<Segment *>[]>(kMaxSegments)) {}
+
+ChipTable::~ChipTable() {
+  for (size_t i = 0; i < kMaxSegments; i++) {
+    delete segments_[i].load(std::memory_order_relaxed);
+  }
+}
+
+ChipTable::Slot *ChipTable::Find(uint32_t facade_id, bool create) const {
+  size_t index = facade_id / kSlotsPerSegment;
+  if (index >= kMaxSegments) return nullptr;
+  auto &entry = segments_[index];
+  auto *segment = entry.load(std::memory_order_acquire);
+  if (segment == nullptr && create) {
+    // Several chips may be added at once; the first allocation wins.
+    auto *allocated = new Segment();
+    if (entry.compare_exchange_strong(segment, allocated,
+                                      std::memory_order_acq_rel)) {
+      segment = allocated;
+    } else {
+      delete allocated;
+    }
+  }
+  return segment == nullptr ? nullptr
+                            : &(*segment)[facade_id % kSlotsPerSegment];
+}
+
+bool ChipTable::Publish(uint32_t facade_id, uint32_t simulation_device) {
+  auto *slot = Find(facade_id, true);
+  if (slot == nullptr) return false;
+  for (auto &counter : slot->counters) {
+    counter.store(0, std::memory_order_relaxed);
+  }
+  slot->simulation_device.store(simulation_device, std::memory_order_relaxed);
+  slot->published.store(true, std::memory_order_release);
+  return true;
+}
+
+void ChipTable::Retire(uint32_t facade_id) {
+  if (auto *slot = Find(facade_id)) {
+    slot->published.store(false, std::memory_order_release);
+  }
+}
+
+std::optional<uint32_t> ChipTable::SimulationDevice(uint32_t facade_id) const {
+  auto *slot = Find(facade_id);
+  if (slot == nullptr || !slot->published.load(std::memory_order_acquire)) {
+    return std::nullopt;
+  }
+  return slot->simulation_device.load(std::memory_order_relaxed);
+}
+
+void ChipTable::Increment(uint32_t facade_id, Counter counter) {
+  auto *slot = Find(facade_id);
+  if (slot == nullptr || !slot->published.load(std::memory_order_relaxed)) {
+    return;
+  }
+  slot->counters[counter].fetch_add(1, std::memory_order_relaxed);
+}
+
+ChipTable::Counters ChipTable::Snapshot(uint32_t facade_id) const {
+  Counters counters{};
+  auto *slot = Find(facade_id);
+  if (slot == nullptr || !slot->published.load(std::memory_order_acquire)) {
+    return counters;
+  }
+  for (size_t i = 0; i < kNumCounters; i++) {
+    counters[i] = slot->counters[i].load(std::memory_order_relaxed);
+  }
+  return counters;
+}
+
+void ChipTable::ResetCounters(uint32_t facade_id) {
+  if (auto *slot = Find(facade_id)) {
+    for (auto &counter : slot->counters) {
+      counter.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+}  // namespace netsim::hci
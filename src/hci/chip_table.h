@@ -0,0 +1,99 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Dense table of per-chip radio counters indexed by facade id.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace netsim::hci {
+
+/**
+ * @class ChipTable
+ *
+ * Holds the state read and written for every packet: the simulation device
+ * of a chip and its tx/rx counters. Slots are indexed by facade id, padded
+ * to a cache line, and allocated in fixed size segments that never move, so
+ * lookups are an index computation and a few relaxed atomic operations with
+ * no hashing, locking or reference counting.
+ *
+ * A chip is published with Publish after its counters are cleared, and
+ * readers only see it after the release store of the slot state. Retire
+ * hides it again; slots are never freed, so a reader racing with Retire
+ * touches valid memory and at worst counts one extra packet.
+ *
+ * Thread safe.
+ */
+class ChipTable {
+ public:
+  enum Counter : size_t {
+    kLowEnergyTx = 0,
+    kLowEnergyRx,
+    kClassicTx,
+    kClassicRx,
+    kNumCounters,
+  };
+
+  using Counters = std::array<int32_t, kNumCounters>;
+
+  // Largest supported facade id is kMaxSegments * kSlotsPerSegment - 1.
+  static constexpr size_t kSlotsPerSegment = 1024;
+  static constexpr size_t kMaxSegments = 4096;
+
+  ChipTable();
+  ~ChipTable();
+  ChipTable(const ChipTable &) = delete;
+  ChipTable &operator=(const ChipTable &) = delete;
+
+  // Clears the counters of a chip and makes it visible to readers. Returns
+  // false if the facade id is out of the supported range.
+  bool Publish(uint32_t facade_id, uint32_t simulation_device);
+
+  void Retire(uint32_t facade_id);
+
+  // Returns the simulation device of a published chip.
+  std::optional<uint32_t> SimulationDevice(uint32_t facade_id) const;
+
+  void Increment(uint32_t facade_id, Counter counter);
+
+  // Returns a snapshot of the counters of a chip, zeros if unknown.
+  Counters Snapshot(uint32_t facade_id) const;
+
+  void ResetCounters(uint32_t facade_id);
+
+ private:
+  struct alignas(64) Slot {
+    std::atomic<bool> published{false};
+    std::atomic<uint32_t> simulation_device{0};
+    std::array<std::atomic<int32_t>, kNumCounters> counters{};
+  };
+
+  using Segment = std::array<Slot, kSlotsPerSegment>;
+
+  // Returns the slot of a facade id; nullptr if its segment is not
+  // allocated yet, unless create is true.
+  Slot *Find(uint32_t facade_id, bool create = false) const;
+
+  std::unique_ptr<std::atomic<Segment *>[]> segments_;
+};
+
+}  // namespace netsim::hci
@@ -0,0 +1,89 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the ChipTable class.
+#include "hci/chip_table.h"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim::hci {
+namespace {
+
+TEST(ChipTableTest, PublishAndRetire) {
+  ChipTable table;
+  EXPECT_FALSE(table.SimulationDevice(3).has_value());
+  EXPECT_TRUE(table.Publish(3, 7));
+  EXPECT_EQ(table.SimulationDevice(3), 7u);
+  // Slots in another segment are allocated on demand.
+  EXPECT_TRUE(table.Publish(ChipTable::kSlotsPerSegment * 5 + 1, 8));
+  EXPECT_EQ(table.SimulationDevice(ChipTable::kSlotsPerSegment * 5 + 1), 8u);
+  EXPECT_FALSE(
+      table.SimulationDevice(ChipTable::kSlotsPerSegment * 6).has_value());
+  table.Retire(3);
+  EXPECT_FALSE(table.SimulationDevice(3).has_value());
+  EXPECT_FALSE(table.Publish(
+      ChipTable::kSlotsPerSegment * ChipTable::kMaxSegments, 1));
+}
+
+TEST(ChipTableTest, Counters) {
+  ChipTable table;
+  table.Increment(1, ChipTable::kLowEnergyTx);
+  EXPECT_EQ(table.Snapshot(1)[ChipTable::kLowEnergyTx], 0);
+
+  table.Publish(1, 1);
+  table.Increment(1, ChipTable::kLowEnergyTx);
+  table.Increment(1, ChipTable::kClassicRx);
+  table.Increment(1, ChipTable::kClassicRx);
+  auto counters = table.Snapshot(1);
+  EXPECT_EQ(counters[ChipTable::kLowEnergyTx], 1);
+  EXPECT_EQ(counters[ChipTable::kLowEnergyRx], 0);
+  EXPECT_EQ(counters[ChipTable::kClassicRx], 2);
+
+  table.ResetCounters(1);
+  EXPECT_EQ(table.Snapshot(1), ChipTable::Counters{});
+  // Publishing again starts from zero.
+  table.Increment(1, ChipTable::kClassicTx);
+  table.Publish(1, 1);
+  EXPECT_EQ(table.Snapshot(1), ChipTable::Counters{});
+}
+
+TEST(ChipTableTest, ConcurrentIncrementsAndPublish) {
+  constexpr int kThreads = 4;
+  constexpr int kIncrements = 10000;
+  ChipTable table;
+  table.Publish(0, 0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&table, t] {
+      // Publishing other chips concurrently allocates segments.
+      table.Publish(ChipTable::kSlotsPerSegment * (t + 1), t);
+      for (int i = 0; i < kIncrements; i++) {
+        table.Increment(0, ChipTable::kLowEnergyRx);
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  EXPECT_EQ(table.Snapshot(0)[ChipTable::kLowEnergyRx], kThreads * kIncrements);
+  for (int t = 0; t < kThreads; t++) {
+    EXPECT_EQ(table.SimulationDevice(ChipTable::kSlotsPerSegment * (t + 1)),
+              static_cast<uint32_t>(t));
+  }
+}
+
+}  // namespace
+}  // namespace netsim::hci
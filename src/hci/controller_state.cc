@@ -0,0 +1,271 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hci/controller_state.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "util/log.h"
+
+namespace netsim::hci {
+namespace {
+
+constexpr uint16_t kReset = 0x0c03;
+
+// How a recorded command relates to the earlier ones.
+enum class Kind {
+  // Not part of the configuration.
+  kIgnored,
+  // Replaces the earlier command with the same opcode.
+  kSetting,
+  // Replaces the earlier command with the same opcode and first parameter,
+  // an advertising set handle or a feature bit.
+  kSetSetting,
+  // LE Set Extended Advertising Enable: kept per advertising set.
+  kSetEnable,
+  // Drops the recorded settings of an advertising set, or of all sets.
+  kSetRemove,
+  // Edits a list, kept in order after the last clear of the list.
+  kListEdit,
+  // Clears a list: drops the recorded edits of the list.
+  kListClear,
+};
+
+struct CommandInfo {
+  Kind kind;
+  // For list edits and clears, the clear command of the list.
+  uint16_t list = 0;
+};
+
+constexpr uint16_t kLeClearFilterAcceptList = 0x2010;
+constexpr uint16_t kLeClearResolvingList = 0x2029;
+constexpr uint16_t kLeSetExtendedAdvertisingEnable = 0x2039;
+constexpr uint16_t kLeClearAdvertisingSets = 0x203d;
+
+// Parameters of one set in LE Set Extended Advertising Enable: handle,
+// duration (2) and max extended advertising events.
+constexpr size_t kEnableSetSize = 4;
+// Offset of the first set, after the enable and number of sets fields.
+constexpr size_t kEnableSetsOffset = 5;
+
+CommandInfo Classify(uint16_t opcode) {
+  switch (opcode) {
+    case 0x080f:  // Write Default Link Policy Settings
+    case 0x0c01:  // Set Event Mask
+    case 0x0c13:  // Write Local Name
+    case 0x0c18:  // Write Page Timeout
+    case 0x0c1a:  // Write Scan Enable
+    case 0x0c1c:  // Write Page Scan Activity
+    case 0x0c1e:  // Write Inquiry Scan Activity
+    case 0x0c24:  // Write Class Of Device
+    case 0x0c43:  // Write Inquiry Scan Type
+    case 0x0c45:  // Write Inquiry Mode
+    case 0x0c47:  // Write Page Scan Type
+    case 0x0c52:  // Write Extended Inquiry Response
+    case 0x0c56:  // Write Simple Pairing Mode
+    case 0x0c63:  // Set Event Mask Page 2
+    case 0x0c6d:  // Write LE Host Support
+    case 0x0c7a:  // Write Secure Connections Host Support
+    case 0x2001:  // LE Set Event Mask
+    case 0x2005:  // LE Set Random Address
+    case 0x2006:  // LE Set Advertising Parameters
+    case 0x2008:  // LE Set Advertising Data
+    case 0x2009:  // LE Set Scan Response Data
+    case 0x200a:  // LE Set Advertising Enable
+    case 0x200b:  // LE Set Scan Parameters
+    case 0x200c:  // LE Set Scan Enable
+    case 0x2024:  // LE Write Suggested Default Data Length
+    case 0x202d:  // LE Set Address Resolution Enable
+    case 0x202e:  // LE Set Resolvable Private Address Timeout
+    case 0x2031:  // LE Set Default PHY
+    case 0x2041:  // LE Set Extended Scan Parameters
+    case 0x2042:  // LE Set Extended Scan Enable
+      return {Kind::kSetting};
+    case 0x2035:  // LE Set Advertising Set Random Address
+    case 0x2036:  // LE Set Extended Advertising Parameters
+    case 0x2037:  // LE Set Extended Advertising Data
+    case 0x2038:  // LE Set Extended Scan Response Data
+    case 0x2074:  // LE Set Host Feature
+      return {Kind::kSetSetting};
+    case kLeSetExtendedAdvertisingEnable:
+      return {Kind::kSetEnable};
+    case 0x203c:  // LE Remove Advertising Set
+    case kLeClearAdvertisingSets:
+      return {Kind::kSetRemove};
+    case 0x2011:  // LE Add Device To Filter Accept List
+    case 0x2012:  // LE Remove Device From Filter Accept List
+      return {Kind::kListEdit, kLeClearFilterAcceptList};
+    case kLeClearFilterAcceptList:
+      return {Kind::kListClear, kLeClearFilterAcceptList};
+    case 0x2027:  // LE Add Device To Resolving List
+    case 0x2028:  // LE Remove Device From Resolving List
+    case 0x204e:  // LE Set Privacy Mode
+      return {Kind::kListEdit, kLeClearResolvingList};
+    case kLeClearResolvingList:
+      return {Kind::kListClear, kLeClearResolvingList};
+    default:
+      return {Kind::kIgnored};
+  }
+}
+
+uint16_t Opcode(const std::vector<uint8_t> &command) {
+  return command[0] | (command[1] << 8);
+}
+
+bool IsSetCommand(const std::vector<uint8_t> &command) {
+  auto kind = Classify(Opcode(command)).kind;
+  return kind == Kind::kSetSetting || kind == Kind::kSetEnable;
+}
+
+// Advertising set handle of a recorded per-set command. Enables are
+// recorded with a single set.
+uint8_t SetHandle(const std::vector<uint8_t> &command) {
+  if (Opcode(command) == kLeSetExtendedAdvertisingEnable) {
+    return command.size() > kEnableSetsOffset ? command[kEnableSetsOffset]
+                                              : 0;
+  }
+  return command.size() > 3 ? command[3] : 0;
+}
+
+// Drops the commands in superseded and appends command, if any. Nothing is
+// changed if the result would hold more than kMaxCommands.
+template <class F>
+void Replace(std::vector<std::vector<uint8_t>> &commands, F superseded,
+             std::vector<uint8_t> command) {
+  if (!command.empty()) {
+    auto dropped = std::count_if(commands.begin(), commands.end(), superseded);
+    if (commands.size() - dropped >= ControllerState::kMaxCommands) {
+      BtsLogWarnRateLimited(
+          "controller_state: dropped command 0x%04x, %d commands recorded",
+          Opcode(command), static_cast<int>(commands.size()));
+      return;
+    }
+  }
+  commands.erase(std::remove_if(commands.begin(), commands.end(), superseded),
+                 commands.end());
+  if (!command.empty()) commands.push_back(std::move(command));
+}
+
+}  // namespace
+
+void ControllerState::Record(const uint8_t *command, size_t size) {
+  // Opcode and parameter length.
+  if (size < 3) return;
+  uint16_t opcode = command[0] | (command[1] << 8);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (opcode == kReset) {
+    commands_.clear();
+    return;
+  }
+  auto info = Classify(opcode);
+  std::vector<uint8_t> recorded(command, command + size);
+  switch (info.kind) {
+    case Kind::kIgnored:
+      return;
+    case Kind::kSetting:
+      Replace(
+          commands_,
+          [opcode](const auto &other) { return Opcode(other) == opcode; },
+          std::move(recorded));
+      return;
+    case Kind::kSetSetting:
+      if (size < 4) return;
+      Replace(
+          commands_,
+          [opcode, handle = command[3]](const auto &other) {
+            return Opcode(other) == opcode && SetHandle(other) == handle;
+          },
+          std::move(recorded));
+      return;
+    case Kind::kSetEnable:
+      RecordEnableLocked(command, size);
+      return;
+    case Kind::kSetRemove:
+      if (opcode == kLeClearAdvertisingSets) {
+        Replace(commands_, IsSetCommand, {});
+      } else if (size >= 4) {
+        Replace(
+            commands_,
+            [handle = command[3]](const auto &other) {
+              return IsSetCommand(other) && SetHandle(other) == handle;
+            },
+            {});
+      }
+      return;
+    case Kind::kListEdit:
+      Replace(
+          commands_, [](const auto &) { return false; }, std::move(recorded));
+      return;
+    case Kind::kListClear:
+      Replace(
+          commands_,
+          [list = info.list](const auto &other) {
+            return Classify(Opcode(other)).list == list;
+          },
+          std::move(recorded));
+      return;
+  }
+}
+
+// Splits the command into one enable per set, so that toggling a set only
+// replaces its own earlier enable. Disabling with no sets disables all.
+void ControllerState::RecordEnableLocked(const uint8_t *command,
+                                         size_t size) {
+  if (size < kEnableSetsOffset) return;
+  uint8_t enable = command[3];
+  size_t num_sets = command[4];
+  auto is_enable = [](const auto &other) {
+    return Opcode(other) == kLeSetExtendedAdvertisingEnable;
+  };
+  if (num_sets == 0) {
+    if (!enable) Replace(commands_, is_enable, {});
+    return;
+  }
+  if (size < kEnableSetsOffset + num_sets * kEnableSetSize) return;
+  for (size_t i = 0; i < num_sets; i++) {
+    const uint8_t *set = command + kEnableSetsOffset + i * kEnableSetSize;
+    std::vector<uint8_t> single = {command[0], command[1],
+                                   2 + kEnableSetSize, enable, 1};
+    single.insert(single.end(), set, set + kEnableSetSize);
+    Replace(
+        commands_,
+        [is_enable, handle = set[0]](const auto &other) {
+          return is_enable(other) && SetHandle(other) == handle;
+        },
+        std::move(single));
+  }
+}
+
+std::vector<std::vector<uint8_t>> ControllerState::Commands() const {
+  std::vector<std::vector<uint8_t>> commands;
+  commands.push_back({kReset & 0xff, kReset >> 8, 0x00});
+  std::lock_guard<std::mutex> lock(mutex_);
+  commands.insert(commands.end(), commands_.begin(), commands_.end());
+  return commands;
+}
+
+void ControllerState::Restore(std::vector<std::vector<uint8_t>> commands) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  commands_.clear();
+  for (auto &command : commands) {
+    if (command.size() < 3 || Opcode(command) == kReset) continue;
+    commands_.push_back(std::move(command));
+  }
+}
+
+}  // namespace netsim::hci
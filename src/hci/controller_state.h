@@ -0,0 +1,59 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace netsim::hci {
+
+/**
+ * @class ControllerState
+ *
+ * Records the HCI commands with which the host configured its controller
+ * since the last HCI Reset: event masks, scan and advertising settings,
+ * filter accept and resolving lists and the like.
+ *
+ * Replaying Commands() into a new controller brings it to the same
+ * configuration, so a host restored from a snapshot can keep using it
+ * without the hardware error and re-initialization of a reset. Connections
+ * are not recorded: they belong to rootcanal and do not survive a restore.
+ */
+class ControllerState {
+ public:
+  // Most commands a chip's configuration holds. Commands that would grow it
+  // further are dropped, and logged.
+  static constexpr size_t kMaxCommands = 256;
+
+  void Record(const uint8_t *command, size_t size);
+
+  // The commands to replay, starting with an HCI Reset.
+  std::vector<std::vector<uint8_t>> Commands() const;
+
+  // Restores recorded commands, such as those of a snapshot.
+  void Restore(std::vector<std::vector<uint8_t>> commands);
+
+ private:
+  void RecordEnableLocked(const uint8_t *command, size_t size);
+
+  mutable std::mutex mutex_;
+  std::vector<std::vector<uint8_t>> commands_;
+};
+
+}  // namespace netsim::hci
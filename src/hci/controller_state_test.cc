@@ -0,0 +1,150 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for ControllerState class.
+#include "hci/controller_state.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using hci::ControllerState;
+using Command = std::vector<uint8_t>;
+
+const Command kReset = {0x03, 0x0c, 0x00};
+
+void Record(ControllerState &state, const Command &command) {
+  state.Record(command.data(), command.size());
+}
+
+TEST(ControllerStateTest, StartsWithReset) {
+  ControllerState state;
+  EXPECT_EQ(state.Commands(), std::vector<Command>{kReset});
+}
+
+TEST(ControllerStateTest, SettingsReplaceEarlierValues) {
+  ControllerState state;
+  // LE Set Scan Enable, enabled then disabled.
+  Record(state, {0x0c, 0x20, 0x02, 0x01, 0x00});
+  Record(state, {0x0c, 0x20, 0x02, 0x00, 0x00});
+  // LE Read Buffer Size is not configuration.
+  Record(state, {0x02, 0x20, 0x00});
+  EXPECT_EQ(state.Commands(),
+            (std::vector<Command>{kReset, {0x0c, 0x20, 0x02, 0x00, 0x00}}));
+}
+
+TEST(ControllerStateTest, AdvertisingSetsAreKeptApart) {
+  ControllerState state;
+  // LE Set Extended Advertising Data for sets 0, 1 and then 0 again.
+  Record(state, {0x37, 0x20, 0x02, 0x00, 0xaa});
+  Record(state, {0x37, 0x20, 0x02, 0x01, 0xbb});
+  Record(state, {0x37, 0x20, 0x02, 0x00, 0xcc});
+  EXPECT_EQ(state.Commands(),
+            (std::vector<Command>{kReset,
+                                  {0x37, 0x20, 0x02, 0x01, 0xbb},
+                                  {0x37, 0x20, 0x02, 0x00, 0xcc}}));
+}
+
+TEST(ControllerStateTest, ListClearDropsEdits) {
+  ControllerState state;
+  // Add to filter accept list, add to resolving list, clear filter list.
+  Record(state, {0x11, 0x20, 0x01, 0x01});
+  Record(state, {0x27, 0x20, 0x01, 0x02});
+  Record(state, {0x10, 0x20, 0x00});
+  Record(state, {0x11, 0x20, 0x01, 0x03});
+  EXPECT_EQ(state.Commands(), (std::vector<Command>{kReset,
+                                                    {0x27, 0x20, 0x01, 0x02},
+                                                    {0x10, 0x20, 0x00},
+                                                    {0x11, 0x20, 0x01, 0x03}}));
+}
+
+TEST(ControllerStateTest, ExtendedAdvertisingEnableIsPerSet) {
+  ControllerState state;
+  // Enable sets 0 and 1, then toggle set 0 off and on many times.
+  Record(state, {0x39, 0x20, 0x0a, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x01,
+                 0x00, 0x00, 0x00});
+  for (size_t i = 0; i < 2 * ControllerState::kMaxCommands; i++) {
+    Record(state, {0x39, 0x20, 0x06, static_cast<uint8_t>(i % 2), 0x01, 0x00,
+                   0x00, 0x00, 0x00});
+  }
+  EXPECT_EQ(state.Commands(),
+            (std::vector<Command>{
+                kReset,
+                {0x39, 0x20, 0x06, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00},
+                {0x39, 0x20, 0x06, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00}}));
+
+  // Disabling with no sets disables all of them.
+  Record(state, {0x39, 0x20, 0x02, 0x00, 0x00});
+  EXPECT_EQ(state.Commands(), std::vector<Command>{kReset});
+}
+
+TEST(ControllerStateTest, RemoveAdvertisingSetDropsItsSettings) {
+  ControllerState state;
+  // Data for sets 0 and 1, set 1 enabled, then set 1 removed.
+  Record(state, {0x37, 0x20, 0x02, 0x00, 0xaa});
+  Record(state, {0x37, 0x20, 0x02, 0x01, 0xbb});
+  Record(state, {0x39, 0x20, 0x06, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00});
+  Record(state, {0x3c, 0x20, 0x01, 0x01});
+  EXPECT_EQ(state.Commands(),
+            (std::vector<Command>{kReset, {0x37, 0x20, 0x02, 0x00, 0xaa}}));
+
+  // LE Clear Advertising Sets.
+  Record(state, {0x3d, 0x20, 0x00});
+  EXPECT_EQ(state.Commands(), std::vector<Command>{kReset});
+}
+
+TEST(ControllerStateTest, FullStateStillUpdatesSettings) {
+  ControllerState state;
+  // Set Event Mask, then filter accept list additions up to the cap.
+  Record(state, {0x01, 0x0c, 0x01, 0x01});
+  for (size_t i = 1; i < ControllerState::kMaxCommands; i++) {
+    Record(state, {0x11, 0x20, 0x01, static_cast<uint8_t>(i)});
+  }
+  ASSERT_EQ(state.Commands().size(), ControllerState::kMaxCommands + 1);
+
+  // An update of a recorded setting replaces it.
+  Record(state, {0x01, 0x0c, 0x01, 0x02});
+  auto commands = state.Commands();
+  ASSERT_EQ(commands.size(), ControllerState::kMaxCommands + 1);
+  EXPECT_EQ(commands.back(), (Command{0x01, 0x0c, 0x01, 0x02}));
+
+  // A command that would grow the state is dropped, the rest is kept.
+  Record(state, {0x0c, 0x20, 0x02, 0x01, 0x00});
+  Record(state, {0x11, 0x20, 0x01, 0xff});
+  EXPECT_EQ(state.Commands(), commands);
+}
+
+TEST(ControllerStateTest, ResetClearsCommands) {
+  ControllerState state;
+  Record(state, {0x01, 0x0c, 0x01, 0xff});
+  Record(state, kReset);
+  EXPECT_EQ(state.Commands(), std::vector<Command>{kReset});
+}
+
+TEST(ControllerStateTest, RestoreSkipsReset) {
+  ControllerState state;
+  state.Restore({kReset, {0x01, 0x0c, 0x01, 0xff}});
+  EXPECT_EQ(state.Commands(),
+            (std::vector<Command>{kReset, {0x01, 0x0c, 0x01, 0xff}}));
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
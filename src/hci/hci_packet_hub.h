@@ -18,25 +18,35 @@
 
 // Use gRPC HCI PacketType definitions so we don't expose Rootcanal's version
 // outside of the Bluetooth Facade.
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "netsim/hci_packet.pb.h"
 #include "rust/cxx.h"
+#include "util/packet_buffer.h"
 
 namespace netsim {
 namespace hci {
 
 /* Handle packet requests for the Bluetooth Facade which may come over
-   different transports including gRPC. */
+   different transports including gRPC. ingress_time is when the packet was
+   read from its transport, used by the latency stats. */
 
 void handle_bt_request(uint32_t facade_id,
                        packet::HCIPacket_PacketType packet_type,
-                       const std::shared_ptr<std::vector<uint8_t>> &packet);
+                       const std::shared_ptr<std::vector<uint8_t>> &packet,
+                       std::chrono::steady_clock::time_point ingress_time = {});
 
 void HandleBtRequestCxx(uint32_t facade_id, uint8_t packet_type,
                         const rust::Vec<uint8_t> &packet);
 
+/* Zero-copy variant used by the gRPC transport: the payload owned by the
+   PacketBuffer is shared with rootcanal instead of copied. */
+
+void HandleBtRequestBufferCxx(uint32_t facade_id, uint8_t packet_type,
+                              const util::PacketBuffer &packet);
+
 }  // namespace hci
 }  // namespace netsim
@@ -14,24 +14,61 @@
 
 #include "hci/hci_packet_transport.h"
 
+#include <chrono>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <utility>
+#include <vector>
 
+#include "hci/controller_state.h"
+#include "hci/hci_scheduler.h"
+#include "hci/packet_latency.h"
 #include "model/hci/hci_transport.h"
 #include "netsim-daemon/src/ffi.rs.h"
 #include "netsim/hci_packet.pb.h"
 #include "rust/cxx.h"
+#include "util/flight_recorder.h"
+#include "util/latency_histogram.h"
 #include "util/log.h"
+#include "util/packet_pool.h"
 
 using netsim::packet::HCIPacket;
 
 namespace netsim {
 namespace hci {
 
+// Transports of all bluetooth shards; closed from the shard threads.
+std::mutex device_to_transport_mutex_;
 std::unordered_map<uint32_t, std::shared_ptr<HciPacketTransport>>
     device_to_transport_;
 
+namespace {
+constexpr uint8_t kCommandCompleteEvent = 0x0e;
+constexpr uint8_t kCommandStatusEvent = 0x0f;
+
+std::shared_ptr<HciPacketTransport> FindTransport(uint32_t device_id) {
+  std::lock_guard<std::mutex> lock(device_to_transport_mutex_);
+  auto it = device_to_transport_.find(device_id);
+  return it == device_to_transport_.end() ? nullptr : it->second;
+}
+}  // namespace
+
+std::shared_ptr<HciScheduler> CreateScheduler(
+    std::shared_ptr<rootcanal::AsyncManager> async_manager) {
+  auto user_id = async_manager->GetNextUserId();
+  return std::make_shared<HciScheduler>(
+      [async_manager](const std::function<void()> &critical) {
+        async_manager->Synchronize(critical);
+      },
+      [async_manager, user_id](std::function<void()> task) {
+        async_manager->ExecAsync(user_id, std::chrono::milliseconds(0),
+                                 std::move(task));
+      });
+}
+
 /**
  * @class HciPacketTransport
  *
@@ -39,8 +76,13 @@ std::unordered_map<uint32_t, std::shared_ptr<HciPacketTransport>>
  *
  */
 HciPacketTransport::HciPacketTransport(
-    std::shared_ptr<rootcanal::AsyncManager> async_manager)
-    : mDeviceId(std::nullopt), mAsyncManager(std::move(async_manager)) {}
+    std::shared_ptr<rootcanal::AsyncManager> async_manager,
+    std::shared_ptr<HciScheduler> scheduler)
+    : mDeviceId(std::nullopt),
+      mAsyncManager(std::move(async_manager)),
+      mScheduler(std::move(scheduler)) {
+  if (!mScheduler) mScheduler = CreateScheduler(mAsyncManager);
+}
 
 /**
  * @brief Connect the phy device to the transport
@@ -50,6 +92,8 @@ HciPacketTransport::HciPacketTransport(
 void HciPacketTransport::Connect(rootcanal::PhyDevice::Identifier device_id) {
   assert(!mDeviceId.has_value());
   mDeviceId.emplace(device_id);
+  mLatency = GetChipLatency(device_id);
+  mRecorder = util::GetFlightRecorder(common::ChipKind::BLUETOOTH, device_id);
 }
 
 // Called by HCITransport (rootcanal)
@@ -60,12 +104,26 @@ void HciPacketTransport::Send(rootcanal::PacketType packet_type,
   packet::HCIPacket_PacketType hci_packet_type =
       static_cast<packet::HCIPacket_PacketType>(packet_type);
   if (!mDeviceId.has_value()) {
-    BtsLogWarn("hci_packet_transport: response with no device.");
+    BtsLogWarnRateLimited("hci_packet_transport: response with no device.");
     return;
   }
+  // The host did not send the replayed commands.
+  if (mReplaying && packet_type == rootcanal::PacketType::EVENT &&
+      !data.empty() &&
+      (data[0] == kCommandCompleteEvent || data[0] == kCommandStatusEvent)) {
+    return;
+  }
+  mRecorder->Record(true, hci_packet_type, data.data(), data.size());
+  bool measure = util::LatencyStatsEnabled();
+  auto start = measure ? std::chrono::steady_clock::now()
+                       : std::chrono::steady_clock::time_point();
   // Send response to transport dispatcher.
   netsim::transport::HandleResponse(common::ChipKind::BLUETOOTH,
                                     mDeviceId.value(), data, hci_packet_type);
+  if (measure) {
+    mLatency->rootcanal_to_egress.Record(std::chrono::steady_clock::now() -
+                                         start);
+  }
 }
 
 // Called by HCITransport (rootcanal)
@@ -82,14 +140,54 @@ void HciPacketTransport::Tick() {}
 
 void HciPacketTransport::Request(
     packet::HCIPacket_PacketType packet_type,
-    const std::shared_ptr<std::vector<uint8_t>> &packet) {
+    const std::shared_ptr<std::vector<uint8_t>> &packet,
+    std::chrono::steady_clock::time_point ingress_time) {
   assert(mPacketCallback);
+  if (mRecorder) {
+    mRecorder->Record(false, packet_type, packet->data(), packet->size());
+  }
+  if (mControllerState && packet_type == packet::HCIPacket::COMMAND) {
+    mControllerState->Record(packet->data(), packet->size());
+  }
+  HciScheduler::Packet scheduled{packet_type, packet};
+  if (util::LatencyStatsEnabled() && mLatency) {
+    scheduled.queued = std::chrono::steady_clock::now();
+    scheduled.ingress = ingress_time;
+  }
+  mScheduler->Schedule(shared_from_this(), std::move(scheduled));
+}
+
+void HciPacketTransport::Deliver(HciScheduler::Packet &packet) {
+  // Closed while the packet was queued.
+  if (!mDeviceId.has_value()) return;
+  if (packet.queued != std::chrono::steady_clock::time_point()) {
+    auto start = std::chrono::steady_clock::now();
+    mLatency->queue_wait.Record(start - packet.queued);
+    if (packet.ingress != std::chrono::steady_clock::time_point())
+      mLatency->ingress_to_rootcanal.Record(start - packet.ingress);
+  }
   // The packet types have standard values, converting from
   // HCIPacket_PacketType to rootcanal::PacketType is safe.
-  rootcanal::PacketType rootcanal_packet_type =
-      static_cast<rootcanal::PacketType>(packet_type);
-  mAsyncManager->Synchronize([this, rootcanal_packet_type, packet]() {
-    mPacketCallback(rootcanal_packet_type, packet);
+  mPacketCallback(static_cast<rootcanal::PacketType>(packet.type),
+                  packet.bytes);
+}
+
+void HciPacketTransport::SetControllerState(
+    std::shared_ptr<ControllerState> state) {
+  mControllerState = std::move(state);
+}
+
+void HciPacketTransport::Replay(std::vector<std::vector<uint8_t>> commands) {
+  assert(mPacketCallback);
+  mAsyncManager->Synchronize([this, commands = std::move(commands)]() {
+    // rootcanal answers commands while handling them, so every event of the
+    // replay is sent before mReplaying is cleared.
+    mReplaying = true;
+    for (const auto &command : commands) {
+      mPacketCallback(rootcanal::PacketType::COMMAND,
+                      util::PacketPool::Copy(command.data(), command.size()));
+    }
+    mReplaying = false;
   });
 }
 
@@ -97,23 +195,30 @@ void HciPacketTransport::Add(
     rootcanal::PhyDevice::Identifier device_id,
     const std::shared_ptr<HciPacketTransport> &transport) {
   transport->Connect(device_id);
+  std::lock_guard<std::mutex> lock(device_to_transport_mutex_);
   device_to_transport_[device_id] = transport;
 }
 
 void HciPacketTransport::Remove(rootcanal::PhyDevice::Identifier device_id) {
   BtsLogInfo("hci_packet_transport remove from netsim");
-  if (device_to_transport_.find(device_id) != device_to_transport_.end() &&
-      device_to_transport_[device_id]) {
+  // Not called under the lock: closing erases the transport from the map.
+  if (auto transport = FindTransport(device_id)) {
     // Calls HciDevice::Close, will disconnect AclHandles with
     // CONNECTION_TIMEOUT, and call TestModel::CloseCallback.
-    device_to_transport_[device_id]->mCloseCallback();
+    transport->mCloseCallback();
   }
 }
 
 // Called by HciDevice::Close
 void HciPacketTransport::Close() {
   if (mDeviceId.has_value()) {
-    device_to_transport_.erase(mDeviceId.value());
+    {
+      std::lock_guard<std::mutex> lock(device_to_transport_mutex_);
+      device_to_transport_.erase(mDeviceId.value());
+    }
+    util::ReleaseFlightRecorder(common::ChipKind::BLUETOOTH,
+                                mDeviceId.value());
+    ReleaseChipLatency(mDeviceId.value());
   }
   BtsLogInfo("hci_packet_transport close from rootcanal");
   mDeviceId = std::nullopt;
@@ -126,16 +231,12 @@ void HciPacketTransport::Close() {
 // acl/sco/iso/command callback methods under synchronization.
 void handle_bt_request(uint32_t facade_id,
                        packet::HCIPacket_PacketType packet_type,
-                       const std::shared_ptr<std::vector<uint8_t>> &packet) {
-  if (device_to_transport_.find(facade_id) != device_to_transport_.end() &&
-      device_to_transport_[facade_id]) {
-    auto transport = device_to_transport_[facade_id];
-    transport->Request(packet_type, packet);
+                       const std::shared_ptr<std::vector<uint8_t>> &packet,
+                       std::chrono::steady_clock::time_point ingress_time) {
+  if (auto transport = FindTransport(facade_id)) {
+    transport->Request(packet_type, packet, ingress_time);
   } else {
-    std::cout << "device_to_transport_ ids ";
-    for (auto [k, _] : device_to_transport_) std::cout << k << " ";
-    std::cout << std::endl;
-    BtsLogWarn(
+    BtsLogWarnRateLimited(
         "hci_packet_transport: handle_request with no transport for device "
         "with facade_id: %d",
         facade_id);
@@ -144,12 +245,18 @@ void handle_bt_request(uint32_t facade_id,
 
 void HandleBtRequestCxx(uint32_t facade_id, uint8_t packet_type,
                         const rust::Vec<uint8_t> &packet) {
-  std::vector<uint8_t> buffer(packet.begin(), packet.end());
-  auto packet_ptr = std::make_shared<std::vector<uint8_t>>(buffer);
+  auto packet_ptr = util::PacketPool::Copy(packet.data(), packet.size());
   handle_bt_request(facade_id,
                     static_cast<packet::HCIPacket_PacketType>(packet_type),
                     packet_ptr);
 }
 
+void HandleBtRequestBufferCxx(uint32_t facade_id, uint8_t packet_type,
+                              const util::PacketBuffer &packet) {
+  handle_bt_request(facade_id,
+                    static_cast<packet::HCIPacket_PacketType>(packet_type),
+                    packet.Share(), packet.IngressTime());
+}
+
 }  // namespace hci
 }  // namespace netsim
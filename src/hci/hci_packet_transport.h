@@ -16,27 +16,45 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
+#include "hci/controller_state.h"
+#include "hci/hci_scheduler.h"
+#include "hci/packet_latency.h"
 #include "model/hci/hci_transport.h"    // for HciTransport
 #include "model/setup/async_manager.h"  // for AsyncManager
 #include "model/setup/phy_device.h"     // for Identifier
 #include "netsim/hci_packet.pb.h"
+#include "util/flight_recorder.h"
 
 namespace netsim {
 namespace hci {
 using rootcanal::CloseCallback;
 using rootcanal::PacketCallback;
 
+// Returns a scheduler delivering under the Synchronize of async_manager.
+std::shared_ptr<HciScheduler> CreateScheduler(
+    std::shared_ptr<rootcanal::AsyncManager> async_manager);
+
 /**
  * @class HciPacketTransport
  *
  * Connects Rootcanal's HciTransport to the packet_hub.
  *
+ * Requests go through the HciScheduler of the AsyncManager, shared by the
+ * transports of a shard, so audio and commands are not held up behind ACL
+ * data. Without a scheduler the transport creates its own.
  */
-class HciPacketTransport : public rootcanal::HciTransport {
+class HciPacketTransport
+    : public rootcanal::HciTransport,
+      public HciScheduler::Client,
+      public std::enable_shared_from_this<HciPacketTransport> {
  public:
-  HciPacketTransport(std::shared_ptr<rootcanal::AsyncManager>);
+  HciPacketTransport(std::shared_ptr<rootcanal::AsyncManager>,
+                     std::shared_ptr<HciScheduler> scheduler = nullptr);
   ~HciPacketTransport() = default;
 
   static void Add(rootcanal::PhyDevice::Identifier id,
@@ -61,8 +79,21 @@ class HciPacketTransport : public rootcanal::HciTransport {
 
   void Close() override;
 
+  // ingress_time is when the packet was read from its stream, it is only
+  // set when latency stats are enabled.
   void Request(packet::HCIPacket_PacketType packet_type,
-               const std::shared_ptr<std::vector<uint8_t>> &packet);
+               const std::shared_ptr<std::vector<uint8_t>> &packet,
+               std::chrono::steady_clock::time_point ingress_time = {});
+
+  // Records the configuration commands of the host into state.
+  void SetControllerState(std::shared_ptr<ControllerState> state);
+
+  // Runs commands on the controller as if the host had sent them, without
+  // sending their Command Complete and Command Status events to the host.
+  void Replay(std::vector<std::vector<uint8_t>> commands);
+
+  // Called by the scheduler under Synchronize.
+  void Deliver(HciScheduler::Packet &packet) override;
 
  private:
   rootcanal::PacketCallback mPacketCallback;
@@ -70,6 +101,12 @@ class HciPacketTransport : public rootcanal::HciTransport {
   // Device ID is the same as Chip Id externally.
   std::optional<rootcanal::PhyDevice::Identifier> mDeviceId;
   std::shared_ptr<rootcanal::AsyncManager> mAsyncManager;
+  std::shared_ptr<HciScheduler> mScheduler;
+  std::shared_ptr<ChipLatency> mLatency;
+  std::shared_ptr<util::FlightRecorder> mRecorder;
+  std::shared_ptr<ControllerState> mControllerState;
+  // Set on the AsyncManager thread while replayed commands run.
+  bool mReplaying = false;
 };
 
 }  // namespace hci
@@ -0,0 +1,104 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of the HCI request path and of the AsyncManager scheduling it
+// relies on.
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "hci/bluetooth_facade.h"
+#include "hci/hci_packet_hub.h"
+#include "model/setup/async_manager.h"
+#include "netsim/hci_packet.pb.h"
+#include "util/benchmark_counters.h"
+#include "util/latency_histogram.h"
+
+namespace netsim::hci {
+namespace {
+
+constexpr uint32_t kSimulationDevice = 123;
+constexpr int kTasksPerIteration = 1024;
+
+// HCI commands, without the packet type indicator.
+const std::vector<uint8_t> kReset = {0x03, 0x0c, 0x00};
+const std::vector<uint8_t> kReadBdAddr = {0x09, 0x10, 0x00};
+
+// A request is delivered to the controller on the calling thread and its
+// Command Complete event goes back through transport::HandleResponse, so an
+// iteration covers ingress to egress of one command. Arg: 1 to enable the
+// latency stats.
+void BM_HandleBtRequest(benchmark::State &state,
+                        const std::vector<uint8_t> &command) {
+  // Start has no effect after the first call.
+  facade::Start({}, 0, true, 1);
+  util::SetLatencyStatsEnabled(state.range(0) != 0);
+  auto facade_id = facade::Add(kSimulationDevice, "", {});
+  auto packet = std::make_shared<std::vector<uint8_t>>(command);
+  for (auto _ : state) {
+    handle_bt_request(facade_id, packet::HCIPacket::COMMAND, packet);
+  }
+  util::SetPacketCounters(state, state.iterations());
+  facade::Remove(facade_id, false);
+  util::SetLatencyStatsEnabled(false);
+}
+
+BENCHMARK_CAPTURE(BM_HandleBtRequest, reset, kReset)->Arg(0)->Arg(1);
+BENCHMARK_CAPTURE(BM_HandleBtRequest, read_bd_addr, kReadBdAddr)
+    ->Arg(0)
+    ->Arg(1);
+
+// Tasks posted with no delay, as the shards do for attaches, removals and
+// packets delivered to another shard.
+void BM_AsyncManagerExecAsync(benchmark::State &state) {
+  rootcanal::AsyncManager async_manager;
+  auto user_id = async_manager.GetNextUserId();
+  std::atomic<int> executed{0};
+  for (auto _ : state) {
+    std::promise<void> done;
+    executed = 0;
+    for (int i = 0; i < kTasksPerIteration; i++) {
+      async_manager.ExecAsync(user_id, std::chrono::milliseconds(0),
+                              [&executed, &done]() {
+                                if (++executed == kTasksPerIteration)
+                                  done.set_value();
+                              });
+    }
+    done.get_future().wait();
+  }
+  async_manager.CancelAsyncTasksFromUser(user_id);
+  util::SetPacketCounters(state, state.iterations() * kTasksPerIteration);
+}
+
+BENCHMARK(BM_AsyncManagerExecAsync)->UseRealTime();
+
+// The critical section every HCI request goes through.
+void BM_AsyncManagerSynchronize(benchmark::State &state) {
+  rootcanal::AsyncManager async_manager;
+  int64_t count = 0;
+  for (auto _ : state) {
+    async_manager.Synchronize([&count]() { count++; });
+  }
+  benchmark::DoNotOptimize(count);
+  util::SetPacketCounters(state, state.iterations());
+}
+
+BENCHMARK(BM_AsyncManagerSynchronize);
+
+}  // namespace
+}  // namespace netsim::hci
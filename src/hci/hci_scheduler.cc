@@ -0,0 +1,88 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hci/hci_scheduler.h"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "netsim/hci_packet.pb.h"
+
+namespace netsim::hci {
+
+HciScheduler::Lane HciScheduler::LaneOf(packet::HCIPacket_PacketType type) {
+  switch (type) {
+    case packet::HCIPacket::SCO:
+    case packet::HCIPacket::ISO:
+      return kAudio;
+    case packet::HCIPacket::ACL:
+      return kData;
+    default:
+      return kControl;
+  }
+}
+
+void HciScheduler::Schedule(const std::shared_ptr<Client> &client,
+                            Packet packet) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto lane = LaneOf(packet.type);
+    auto &queue = client->lanes_[lane];
+    if (queue.empty()) ready_[lane].push_back(client);
+    queue.push_back(std::move(packet));
+    // The running drain delivers it.
+    if (draining_) return;
+    draining_ = true;
+  }
+  synchronize_([this]() { DeliverBatch(); });
+}
+
+bool HciScheduler::PopLocked(std::shared_ptr<Client> &client,
+                             Packet &packet) {
+  for (auto &ready : ready_) {
+    if (ready.empty()) continue;
+    auto lane = static_cast<Lane>(&ready - ready_.data());
+    client = std::move(ready.front());
+    ready.pop_front();
+    auto &queue = client->lanes_[lane];
+    packet = std::move(queue.front());
+    queue.pop_front();
+    // Back of the line for its next packet of the lane.
+    if (!queue.empty()) ready.push_back(client);
+    return true;
+  }
+  draining_ = false;
+  return false;
+}
+
+void HciScheduler::DeliverBatch() {
+  std::shared_ptr<Client> client;
+  Packet packet;
+  for (size_t i = 0; i < kMaxBatch; i++) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!PopLocked(client, packet)) return;
+    }
+    client->Deliver(packet);
+  }
+  // Still draining: the next batch is a task of its own, which ends the
+  // drain if nothing is left by then.
+  post_([weak = weak_from_this()]() {
+    if (auto scheduler = weak.lock()) scheduler->DeliverBatch();
+  });
+}
+
+}  // namespace netsim::hci
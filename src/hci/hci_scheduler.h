@@ -0,0 +1,112 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "netsim/hci_packet.pb.h"
+
+namespace netsim::hci {
+
+/**
+ * @class HciScheduler
+ *
+ * Orders the HCI requests of the controllers sharing an AsyncManager.
+ *
+ * Each client, an HciPacketTransport, queues its packets in one lane per
+ * priority: SCO and ISO audio first, then commands, then ACL data. The
+ * requests are delivered one at a time from the highest non-empty lane,
+ * round robin over the clients with packets in that lane, so a bulk ACL
+ * transfer of one device does not delay the audio or the commands of the
+ * others. Packets of the same client and lane keep their order.
+ *
+ * The thread that queues a packet while no delivery is running delivers
+ * one batch itself under the synchronize callback, so an uncontended
+ * request is still delivered on its own thread. Packets left after the
+ * batch are delivered by posted tasks, a batch each, so the caller returns
+ * and the timers of the AsyncManager run in between. Other threads only
+ * queue.
+ */
+class HciScheduler : public std::enable_shared_from_this<HciScheduler> {
+ public:
+  enum Lane : size_t { kAudio, kControl, kData, kNumLanes };
+
+  // Requests in a batch, bounding the time the synchronize callback is held
+  // and the time a scheduling thread spends delivering.
+  static constexpr size_t kMaxBatch = 32;
+
+  struct Packet {
+    packet::HCIPacket_PacketType type;
+    std::shared_ptr<std::vector<uint8_t>> bytes;
+    // Set when latency stats are enabled.
+    std::chrono::steady_clock::time_point queued;
+    std::chrono::steady_clock::time_point ingress;
+  };
+
+  class Client {
+   public:
+    virtual ~Client() = default;
+
+    // Called within the synchronize callback.
+    virtual void Deliver(Packet &packet) = 0;
+
+   private:
+    friend class HciScheduler;
+    // Guarded by the mutex of the scheduler.
+    std::array<std::deque<Packet>, kNumLanes> lanes_;
+  };
+
+  // Runs a callback within the critical section of the controllers, e.g.
+  // AsyncManager::Synchronize.
+  using Synchronize = std::function<void(const std::function<void()> &)>;
+  // Runs a task later within the same critical section, e.g.
+  // AsyncManager::ExecAsync, whose tasks run under Synchronize.
+  using Post = std::function<void(std::function<void()>)>;
+
+  HciScheduler(Synchronize synchronize, Post post)
+      : synchronize_(std::move(synchronize)), post_(std::move(post)) {}
+
+  static Lane LaneOf(packet::HCIPacket_PacketType type);
+
+  void Schedule(const std::shared_ptr<Client> &client, Packet packet);
+
+ private:
+  // Delivers a batch, and posts the next one while packets are left.
+  // Called within the synchronize callback.
+  void DeliverBatch();
+
+  // Returns false and ends the drain when no packet is queued.
+  bool PopLocked(std::shared_ptr<Client> &client, Packet &packet);
+
+  Synchronize synchronize_;
+  Post post_;
+  std::mutex mutex_;
+  // Clients with packets, in delivery order, per lane.
+  std::array<std::deque<std::shared_ptr<Client>>, kNumLanes> ready_;
+  bool draining_ = false;
+};
+
+}  // namespace netsim::hci
@@ -0,0 +1,244 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for HciScheduler class.
+#include "hci/hci_scheduler.h"
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "netsim/hci_packet.pb.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using hci::HciScheduler;
+using packet::HCIPacket;
+
+// Deliveries of every client, in order, as "<client>:<type>:<byte>".
+class Log {
+ public:
+  void Add(std::string entry) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back(std::move(entry));
+  }
+  std::vector<std::string> Entries() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::vector<std::string> entries_;
+};
+
+class TestClient : public HciScheduler::Client {
+ public:
+  TestClient(std::string name, Log &log) : name_(std::move(name)), log_(log) {}
+
+  void Deliver(HciScheduler::Packet &packet) override {
+    if (on_deliver) on_deliver(packet);
+    log_.Add(name_ + ":" + HCIPacket::PacketType_Name(packet.type) + ":" +
+             std::to_string(packet.bytes->at(0)));
+  }
+
+  std::function<void(HciScheduler::Packet &)> on_deliver;
+
+ private:
+  std::string name_;
+  Log &log_;
+};
+
+HciScheduler::Packet MakePacket(HCIPacket::PacketType type, uint8_t byte) {
+  return {type, std::make_shared<std::vector<uint8_t>>(1, byte), {}, {}};
+}
+
+class HciSchedulerTest : public ::testing::Test {
+ protected:
+  HciSchedulerTest()
+      : scheduler_(std::make_shared<HciScheduler>(
+            [this](const std::function<void()> &critical) {
+              std::lock_guard<std::mutex> lock(sync_mutex_);
+              critical();
+            },
+            [this](std::function<void()> task) {
+              std::lock_guard<std::mutex> lock(posted_mutex_);
+              posted_.push_back(std::move(task));
+            })) {}
+
+  // Runs the posted tasks, and those they post, under the synchronize
+  // lock like the AsyncManager. Returns how many ran.
+  int RunPosted() {
+    int ran = 0;
+    while (true) {
+      std::function<void()> task;
+      {
+        std::lock_guard<std::mutex> lock(posted_mutex_);
+        if (posted_.empty()) return ran;
+        task = std::move(posted_.front());
+        posted_.pop_front();
+      }
+      std::lock_guard<std::mutex> lock(sync_mutex_);
+      task();
+      ran++;
+    }
+  }
+
+  // Delivers a packet of gate on another thread and blocks the delivery
+  // until Release, so the packets scheduled meanwhile are queued.
+  void Hold(const std::shared_ptr<TestClient> &gate) {
+    auto released = release_.get_future().share();
+    gate->on_deliver = [this, released](HciScheduler::Packet &) {
+      entered_.set_value();
+      released.wait();
+    };
+    drainer_ = std::thread([this, gate]() {
+      scheduler_->Schedule(gate, MakePacket(HCIPacket::COMMAND, 0));
+    });
+    entered_.get_future().wait();
+  }
+
+  void Release() {
+    release_.set_value();
+    drainer_.join();
+  }
+
+  std::mutex sync_mutex_;
+  std::mutex posted_mutex_;
+  std::deque<std::function<void()>> posted_;
+  std::shared_ptr<HciScheduler> scheduler_;
+  Log log_;
+  std::promise<void> entered_;
+  std::promise<void> release_;
+  std::thread drainer_;
+};
+
+TEST_F(HciSchedulerTest, DeliversOnCallingThreadWhenIdle) {
+  auto client = std::make_shared<TestClient>("a", log_);
+  auto caller = std::this_thread::get_id();
+  std::thread::id delivered;
+  client->on_deliver = [&delivered](HciScheduler::Packet &) {
+    delivered = std::this_thread::get_id();
+  };
+  scheduler_->Schedule(client, MakePacket(HCIPacket::ACL, 1));
+  EXPECT_EQ(delivered, caller);
+  EXPECT_EQ(log_.Entries(), std::vector<std::string>{"a:ACL:1"});
+}
+
+TEST_F(HciSchedulerTest, AudioAndCommandsOvertakeData) {
+  auto gate = std::make_shared<TestClient>("gate", log_);
+  auto a = std::make_shared<TestClient>("a", log_);
+  auto b = std::make_shared<TestClient>("b", log_);
+  Hold(gate);
+  scheduler_->Schedule(a, MakePacket(HCIPacket::ACL, 1));
+  scheduler_->Schedule(b, MakePacket(HCIPacket::ACL, 2));
+  scheduler_->Schedule(b, MakePacket(HCIPacket::COMMAND, 3));
+  scheduler_->Schedule(a, MakePacket(HCIPacket::ISO, 4));
+  scheduler_->Schedule(b, MakePacket(HCIPacket::SCO, 5));
+  Release();
+  EXPECT_EQ(log_.Entries(),
+            (std::vector<std::string>{"gate:COMMAND:0", "a:ISO:4", "b:SCO:5",
+                                      "b:COMMAND:3", "a:ACL:1", "b:ACL:2"}));
+}
+
+TEST_F(HciSchedulerTest, LaneIsRoundRobinAcrossClients) {
+  auto gate = std::make_shared<TestClient>("gate", log_);
+  auto a = std::make_shared<TestClient>("a", log_);
+  auto b = std::make_shared<TestClient>("b", log_);
+  Hold(gate);
+  for (uint8_t i = 1; i <= 3; i++) {
+    scheduler_->Schedule(a, MakePacket(HCIPacket::ACL, i));
+  }
+  scheduler_->Schedule(b, MakePacket(HCIPacket::ACL, 4));
+  scheduler_->Schedule(b, MakePacket(HCIPacket::ACL, 5));
+  Release();
+  EXPECT_EQ(log_.Entries(),
+            (std::vector<std::string>{"gate:COMMAND:0", "a:ACL:1", "b:ACL:4",
+                                      "a:ACL:2", "b:ACL:5", "a:ACL:3"}));
+}
+
+TEST_F(HciSchedulerTest, CallerDeliversOneBatchAndPostsTheRest) {
+  auto gate = std::make_shared<TestClient>("gate", log_);
+  auto a = std::make_shared<TestClient>("a", log_);
+  Hold(gate);
+  constexpr size_t kQueued = 2 * HciScheduler::kMaxBatch;
+  for (size_t i = 0; i < kQueued; i++) {
+    scheduler_->Schedule(a, MakePacket(HCIPacket::ACL, i));
+  }
+  Release();
+  EXPECT_EQ(log_.Entries().size(), HciScheduler::kMaxBatch);
+  // One task per batch left, the gate having taken a slot of the first.
+  EXPECT_EQ(RunPosted(), 2);
+  EXPECT_EQ(log_.Entries().size(), kQueued + 1);
+
+  scheduler_->Schedule(a, MakePacket(HCIPacket::ACL, 0));
+  EXPECT_EQ(log_.Entries().size(), kQueued + 2);
+  EXPECT_EQ(RunPosted(), 0);
+}
+
+TEST_F(HciSchedulerTest, ManyThreadsDeliverEveryPacketOnceInOrder) {
+  constexpr int kThreads = 4;
+  constexpr int kPackets = 2000;
+  const HCIPacket::PacketType kTypes[] = {HCIPacket::ACL, HCIPacket::COMMAND,
+                                          HCIPacket::SCO, HCIPacket::ACL};
+  std::vector<std::shared_ptr<TestClient>> clients;
+  // Next expected byte per client and lane, only touched by Deliver.
+  std::vector<std::array<int, HciScheduler::kNumLanes>> next(kThreads);
+  bool in_order = true;
+  int delivered = 0;
+  for (int t = 0; t < kThreads; t++) {
+    clients.push_back(std::make_shared<TestClient>(std::to_string(t), log_));
+    next[t].fill(0);
+    clients[t]->on_deliver = [&, t](HciScheduler::Packet &packet) {
+      auto &expected = next[t][HciScheduler::LaneOf(packet.type)];
+      if (packet.bytes->at(0) != static_cast<uint8_t>(expected)) {
+        in_order = false;
+      }
+      expected++;
+      delivered++;
+    };
+  }
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&, t]() {
+      std::array<int, HciScheduler::kNumLanes> sent{};
+      for (int i = 0; i < kPackets; i++) {
+        auto type = kTypes[(i + t) % 4];
+        auto &count = sent[HciScheduler::LaneOf(type)];
+        scheduler_->Schedule(clients[t],
+                            MakePacket(type, static_cast<uint8_t>(count++)));
+      }
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  RunPosted();
+  std::lock_guard<std::mutex> lock(sync_mutex_);
+  EXPECT_EQ(delivered, kThreads * kPackets);
+  EXPECT_TRUE(in_order);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
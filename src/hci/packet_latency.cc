@@ -0,0 +1,100 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hci/packet_latency.h"
+
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "netsim-daemon/src/ffi.rs.h"
+#include "netsim/stats.pb.h"
+#include "rust/cxx.h"
+#include "util/latency_histogram.h"
+
+namespace netsim::hci {
+namespace {
+
+std::mutex chip_latencies_mutex;
+std::map<uint32_t, std::shared_ptr<ChipLatency>> chip_latencies;
+// Removed chips, oldest first.
+std::deque<uint32_t> retired_chip_latencies;
+
+void SetLatencyStats(const util::LatencyHistogram &histogram,
+                     stats::NetsimLatencyStats *stats) {
+  stats->set_count(histogram.Count());
+  stats->set_p50_us(histogram.PercentileMicros(0.5));
+  stats->set_p99_us(histogram.PercentileMicros(0.99));
+  stats->set_p999_us(histogram.PercentileMicros(0.999));
+  stats->set_max_us(histogram.MaxMicros());
+}
+
+}  // namespace
+
+std::shared_ptr<ChipLatency> GetChipLatency(uint32_t facade_id) {
+  std::lock_guard<std::mutex> lock(chip_latencies_mutex);
+  auto &retired = retired_chip_latencies;
+  retired.erase(std::remove(retired.begin(), retired.end(), facade_id),
+                retired.end());
+  auto &latency = chip_latencies[facade_id];
+  if (!latency) latency = std::make_shared<ChipLatency>();
+  return latency;
+}
+
+void ReleaseChipLatency(uint32_t facade_id) {
+  std::lock_guard<std::mutex> lock(chip_latencies_mutex);
+  auto &retired = retired_chip_latencies;
+  if (chip_latencies.count(facade_id) == 0 ||
+      std::find(retired.begin(), retired.end(), facade_id) != retired.end())
+    return;
+  retired.push_back(facade_id);
+  if (retired.size() > kRetiredChipLatencies) {
+    chip_latencies.erase(retired.front());
+    retired.pop_front();
+  }
+}
+
+std::vector<stats::NetsimChipLatencyStats> GetLatencyStats() {
+  std::lock_guard<std::mutex> lock(chip_latencies_mutex);
+  std::vector<stats::NetsimChipLatencyStats> result;
+  for (const auto &[facade_id, latency] : chip_latencies) {
+    if (latency->ingress_to_rootcanal.Count() == 0 &&
+        latency->rootcanal_to_egress.Count() == 0)
+      continue;
+    auto &stats = result.emplace_back();
+    stats.set_facade_id(facade_id);
+    SetLatencyStats(latency->ingress_to_rootcanal,
+                    stats.mutable_ingress_to_rootcanal());
+    SetLatencyStats(latency->queue_wait, stats.mutable_queue_wait());
+    SetLatencyStats(latency->rootcanal_to_egress,
+                    stats.mutable_rootcanal_to_egress());
+  }
+  return result;
+}
+
+rust::Vec<uint8_t> GetLatencyStatsCxx() {
+  stats::NetsimStats stats;
+  for (auto &chip_stats : GetLatencyStats()) {
+    *stats.add_latency_stats() = std::move(chip_stats);
+  }
+  std::string bytes = stats.SerializeAsString();
+  return VecFromSlice(
+      {reinterpret_cast<const uint8_t *>(bytes.data()), bytes.size()});
+}
+
+}  // namespace netsim::hci
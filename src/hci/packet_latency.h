@@ -0,0 +1,64 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Latencies of the Bluetooth packet path of every chip.
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "netsim/stats.pb.h"
+#include "rust/cxx.h"
+#include "util/latency_histogram.h"
+
+namespace netsim::hci {
+
+/**
+ * @brief Latency histograms of one chip.
+ *
+ * ingress_to_rootcanal: from reading the packet off the gRPC stream to the
+ *   Synchronize callback delivering it to rootcanal.
+ * queue_wait: from HciPacketTransport::Request to its delivery by the
+ *   HciScheduler, through the lanes of higher priority packets.
+ * rootcanal_to_egress: from HciPacketTransport::Send to the response being
+ *   queued on the gRPC stream, through the dispatcher and captures.
+ */
+struct ChipLatency {
+  util::LatencyHistogram ingress_to_rootcanal;
+  util::LatencyHistogram queue_wait;
+  util::LatencyHistogram rootcanal_to_egress;
+};
+
+// Histograms of removed chips kept for the session stats. Past this, those
+// of the oldest removed chip are dropped.
+constexpr size_t kRetiredChipLatencies = 16;
+
+// Returns the histograms of a chip, created on first use.
+std::shared_ptr<ChipLatency> GetChipLatency(uint32_t facade_id);
+
+// Called when a chip is removed. Its histograms stay in the stats until
+// kRetiredChipLatencies other chips are removed.
+void ReleaseChipLatency(uint32_t facade_id);
+
+std::vector<stats::NetsimChipLatencyStats> GetLatencyStats();
+
+// Returns a serialized NetsimStats holding only latency_stats.
+rust::Vec<uint8_t> GetLatencyStatsCxx();
+
+}  // namespace netsim::hci
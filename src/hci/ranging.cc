@@ -0,0 +1,311 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hci/ranging.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "netsim-daemon/src/ffi.rs.h"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define NETSIM_RANGING_AVX2
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define NETSIM_RANGING_NEON
+#include <arm_neon.h>
+#endif
+
+namespace netsim::hci::ranging {
+namespace {
+
+// Constants of distance_to_rssi in ranging.rs, for the vector paths.
+constexpr float kPathLossAt1m = 40.20f;
+constexpr float kMinRssi = -120.0f;
+constexpr float kMaxRssi = 20.0f;
+// 20 * log10(d) == kLnToDb * ln(d).
+constexpr float kLnToDb = 8.685889638f;
+
+// Some bluetooth devices report a tx_power of 0 or 1 (unset). Only the
+// vector paths need it, the Rust model handles it itself.
+[[maybe_unused]] float EffectiveTxPower(int8_t tx_power) {
+  return (tx_power == 0 || tx_power == 1) ? -49.0f : tx_power;
+}
+
+// Handles the elements after the last full vector with the Rust model.
+void ScalarTail(int8_t tx_power, const float *distances, size_t begin,
+                size_t count, int8_t *rssi) {
+  for (size_t i = begin; i < count; i++) {
+    rssi[i] = ::netsim::DistanceToRssi(tx_power, distances[i]);
+  }
+}
+
+void ScalarPositions(float sx, float sy, float sz, int8_t tx_power,
+                     const float *x, const float *y, const float *z,
+                     size_t begin, size_t count, float *distances,
+                     int8_t *rssi) {
+  for (size_t i = begin; i < count; i++) {
+    float dx = x[i] - sx, dy = y[i] - sy, dz = z[i] - sz;
+    distances[i] = std::sqrt(dx * dx + dy * dy + dz * dz);
+  }
+  ScalarTail(tx_power, distances, begin, count, rssi);
+}
+
+// The vector paths compute ln(x) with the cephes single precision
+// polynomial: x = m * 2^e with m in [sqrt(1/2), sqrt(2)), then
+// ln(x) = e * ln(2) + ln(m). Relative error is below 1e-7 for normal x,
+// which is far below the 1 dBm resolution of the result.
+constexpr float kSqrtHalf = 0.707106781186547524f;
+constexpr float kLogP0 = 7.0376836292E-2f;
+constexpr float kLogP1 = -1.1514610310E-1f;
+constexpr float kLogP2 = 1.1676998740E-1f;
+constexpr float kLogP3 = -1.2420140846E-1f;
+constexpr float kLogP4 = 1.4249322787E-1f;
+constexpr float kLogP5 = -1.6668057665E-1f;
+constexpr float kLogP6 = 2.0000714765E-1f;
+constexpr float kLogP7 = -2.4999993993E-1f;
+constexpr float kLogP8 = 3.3333331174E-1f;
+constexpr float kLogQ1 = -2.12194440e-4f;
+constexpr float kLogQ2 = 0.693359375f;
+
+#if defined(NETSIM_RANGING_AVX2)
+
+constexpr size_t kLanes = 8;
+
+__attribute__((target("avx2,fma"))) __m256 LogAvx2(__m256 x) {
+  const __m256 one = _mm256_set1_ps(1.0f);
+  // Distances are finite and positive here; zero is handled by the caller.
+  x = _mm256_max_ps(x, _mm256_set1_ps(std::numeric_limits<float>::min()));
+  __m256i bits = _mm256_castps_si256(x);
+  __m256i exponent = _mm256_sub_epi32(_mm256_srli_epi32(bits, 23),
+                                      _mm256_set1_epi32(0x7e));
+  // Mantissa in [0.5, 1).
+  x = _mm256_castsi256_ps(
+      _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                      _mm256_set1_epi32(0x3f000000)));
+  __m256 e = _mm256_cvtepi32_ps(exponent);
+  __m256 small = _mm256_cmp_ps(x, _mm256_set1_ps(kSqrtHalf), _CMP_LT_OQ);
+  e = _mm256_sub_ps(e, _mm256_and_ps(one, small));
+  x = _mm256_add_ps(_mm256_sub_ps(x, one), _mm256_and_ps(x, small));
+
+  __m256 z = _mm256_mul_ps(x, x);
+  __m256 y = _mm256_set1_ps(kLogP0);
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kLogP1));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kLogP2));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kLogP3));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kLogP4));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kLogP5));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kLogP6));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kLogP7));
+  y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(kLogP8));
+  y = _mm256_mul_ps(_mm256_mul_ps(y, x), z);
+  y = _mm256_fmadd_ps(e, _mm256_set1_ps(kLogQ1), y);
+  y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+  x = _mm256_add_ps(x, y);
+  return _mm256_fmadd_ps(e, _mm256_set1_ps(kLogQ2), x);
+}
+
+// Computes 8 RSSI values from 8 distances.
+__attribute__((target("avx2,fma"))) void RssiAvx2(__m256 tx_power,
+                                                   __m256 distance,
+                                                   int8_t *rssi) {
+  __m256 loss = _mm256_mul_ps(LogAvx2(distance), _mm256_set1_ps(kLnToDb));
+  __m256 value = _mm256_sub_ps(tx_power, loss);
+  __m256 zero = _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_EQ_OQ);
+  value = _mm256_blendv_ps(
+      value, _mm256_add_ps(tx_power, _mm256_set1_ps(kPathLossAt1m)), zero);
+  value = _mm256_min_ps(_mm256_max_ps(value, _mm256_set1_ps(kMinRssi)),
+                        _mm256_set1_ps(kMaxRssi));
+  // Truncate toward zero like the scalar cast, then narrow to int8.
+  __m256i ints = _mm256_cvttps_epi32(value);
+  __m128i lo = _mm256_castsi256_si128(ints);
+  __m128i hi = _mm256_extracti128_si256(ints, 1);
+  __m128i packed =
+      _mm_packs_epi16(_mm_packs_epi32(lo, hi), _mm_setzero_si128());
+  _mm_storel_epi64(reinterpret_cast<__m128i *>(rssi), packed);
+}
+
+__attribute__((target("avx2,fma"))) void DistancesAvx2(int8_t tx_power,
+                                                        const float *distances,
+                                                        size_t count,
+                                                        int8_t *rssi) {
+  __m256 tx = _mm256_set1_ps(EffectiveTxPower(tx_power));
+  size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    RssiAvx2(tx, _mm256_loadu_ps(distances + i), rssi + i);
+  }
+  ScalarTail(tx_power, distances, i, count, rssi);
+}
+
+__attribute__((target("avx2,fma"))) void PositionsAvx2(
+    float sx, float sy, float sz, int8_t tx_power, const float *x,
+    const float *y, const float *z, size_t count, float *distances,
+    int8_t *rssi) {
+  __m256 tx = _mm256_set1_ps(EffectiveTxPower(tx_power));
+  __m256 vsx = _mm256_set1_ps(sx);
+  __m256 vsy = _mm256_set1_ps(sy);
+  __m256 vsz = _mm256_set1_ps(sz);
+  size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), vsx);
+    __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), vsy);
+    __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(z + i), vsz);
+    __m256 squared = _mm256_mul_ps(dx, dx);
+    squared = _mm256_fmadd_ps(dy, dy, squared);
+    squared = _mm256_fmadd_ps(dz, dz, squared);
+    __m256 distance = _mm256_sqrt_ps(squared);
+    _mm256_storeu_ps(distances + i, distance);
+    RssiAvx2(tx, distance, rssi + i);
+  }
+  ScalarPositions(sx, sy, sz, tx_power, x, y, z, i, count, distances, rssi);
+}
+
+bool HasAvx2() {
+  static const bool has_avx2 =
+      __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+  return has_avx2;
+}
+
+#elif defined(NETSIM_RANGING_NEON)
+
+constexpr size_t kLanes = 4;
+
+float32x4_t LogNeon(float32x4_t x) {
+  const float32x4_t one = vdupq_n_f32(1.0f);
+  x = vmaxq_f32(x, vdupq_n_f32(std::numeric_limits<float>::min()));
+  uint32x4_t bits = vreinterpretq_u32_f32(x);
+  int32x4_t exponent = vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)),
+                                 vdupq_n_s32(0x7e));
+  x = vreinterpretq_f32_u32(vorrq_u32(vandq_u32(bits, vdupq_n_u32(0x007fffff)),
+                                      vdupq_n_u32(0x3f000000)));
+  float32x4_t e = vcvtq_f32_s32(exponent);
+  uint32x4_t small = vcltq_f32(x, vdupq_n_f32(kSqrtHalf));
+  e = vsubq_f32(e, vreinterpretq_f32_u32(
+                       vandq_u32(vreinterpretq_u32_f32(one), small)));
+  x = vaddq_f32(vsubq_f32(x, one),
+                vreinterpretq_f32_u32(
+                    vandq_u32(vreinterpretq_u32_f32(x), small)));
+
+  float32x4_t z = vmulq_f32(x, x);
+  float32x4_t y = vdupq_n_f32(kLogP0);
+  y = vfmaq_f32(vdupq_n_f32(kLogP1), y, x);
+  y = vfmaq_f32(vdupq_n_f32(kLogP2), y, x);
+  y = vfmaq_f32(vdupq_n_f32(kLogP3), y, x);
+  y = vfmaq_f32(vdupq_n_f32(kLogP4), y, x);
+  y = vfmaq_f32(vdupq_n_f32(kLogP5), y, x);
+  y = vfmaq_f32(vdupq_n_f32(kLogP6), y, x);
+  y = vfmaq_f32(vdupq_n_f32(kLogP7), y, x);
+  y = vfmaq_f32(vdupq_n_f32(kLogP8), y, x);
+  y = vmulq_f32(vmulq_f32(y, x), z);
+  y = vfmaq_f32(y, e, vdupq_n_f32(kLogQ1));
+  y = vfmsq_f32(y, z, vdupq_n_f32(0.5f));
+  x = vaddq_f32(x, y);
+  return vfmaq_f32(x, e, vdupq_n_f32(kLogQ2));
+}
+
+// Computes 4 RSSI values from 4 distances.
+void RssiNeon(float32x4_t tx_power, float32x4_t distance, int8_t *rssi) {
+  float32x4_t loss = vmulq_f32(LogNeon(distance), vdupq_n_f32(kLnToDb));
+  float32x4_t value = vsubq_f32(tx_power, loss);
+  uint32x4_t zero = vceqq_f32(distance, vdupq_n_f32(0.0f));
+  value = vbslq_f32(zero, vaddq_f32(tx_power, vdupq_n_f32(kPathLossAt1m)),
+                    value);
+  value = vminq_f32(vmaxq_f32(value, vdupq_n_f32(kMinRssi)),
+                    vdupq_n_f32(kMaxRssi));
+  // Truncate toward zero like the scalar cast.
+  int32x4_t ints = vcvtq_s32_f32(value);
+  int32_t lanes[kLanes];
+  vst1q_s32(lanes, ints);
+  for (size_t i = 0; i < kLanes; i++) rssi[i] = static_cast<int8_t>(lanes[i]);
+}
+
+void DistancesNeon(int8_t tx_power, const float *distances, size_t count,
+                   int8_t *rssi) {
+  float32x4_t tx = vdupq_n_f32(EffectiveTxPower(tx_power));
+  size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    RssiNeon(tx, vld1q_f32(distances + i), rssi + i);
+  }
+  ScalarTail(tx_power, distances, i, count, rssi);
+}
+
+void PositionsNeon(float sx, float sy, float sz, int8_t tx_power,
+                   const float *x, const float *y, const float *z,
+                   size_t count, float *distances, int8_t *rssi) {
+  float32x4_t tx = vdupq_n_f32(EffectiveTxPower(tx_power));
+  float32x4_t vsx = vdupq_n_f32(sx);
+  float32x4_t vsy = vdupq_n_f32(sy);
+  float32x4_t vsz = vdupq_n_f32(sz);
+  size_t i = 0;
+  for (; i + kLanes <= count; i += kLanes) {
+    float32x4_t dx = vsubq_f32(vld1q_f32(x + i), vsx);
+    float32x4_t dy = vsubq_f32(vld1q_f32(y + i), vsy);
+    float32x4_t dz = vsubq_f32(vld1q_f32(z + i), vsz);
+    float32x4_t squared = vmulq_f32(dx, dx);
+    squared = vfmaq_f32(squared, dy, dy);
+    squared = vfmaq_f32(squared, dz, dz);
+    float32x4_t distance = vsqrtq_f32(squared);
+    vst1q_f32(distances + i, distance);
+    RssiNeon(tx, distance, rssi + i);
+  }
+  ScalarPositions(sx, sy, sz, tx_power, x, y, z, i, count, distances, rssi);
+}
+
+#endif
+
+}  // namespace
+
+int8_t DistanceToRssi(int8_t tx_power, float distance) {
+  return ::netsim::DistanceToRssi(tx_power, distance);
+}
+
+void BatchDistanceToRssi(int8_t tx_power, const float *distances, size_t count,
+                         int8_t *rssi) {
+#if defined(NETSIM_RANGING_AVX2)
+  if (HasAvx2()) return DistancesAvx2(tx_power, distances, count, rssi);
+#elif defined(NETSIM_RANGING_NEON)
+  return DistancesNeon(tx_power, distances, count, rssi);
+#endif
+  ScalarTail(tx_power, distances, 0, count, rssi);
+}
+
+void BatchPositionsToRssi(float sender_x, float sender_y, float sender_z,
+                          int8_t tx_power, const float *x, const float *y,
+                          const float *z, size_t count, float *distances,
+                          int8_t *rssi) {
+#if defined(NETSIM_RANGING_AVX2)
+  if (HasAvx2()) {
+    return PositionsAvx2(sender_x, sender_y, sender_z, tx_power, x, y, z,
+                         count, distances, rssi);
+  }
+#elif defined(NETSIM_RANGING_NEON)
+  return PositionsNeon(sender_x, sender_y, sender_z, tx_power, x, y, z, count,
+                       distances, rssi);
+#endif
+  ScalarPositions(sender_x, sender_y, sender_z, tx_power, x, y, z, 0, count,
+                  distances, rssi);
+}
+
+const char *BatchImplementation() {
+#if defined(NETSIM_RANGING_AVX2)
+  if (HasAvx2()) return "avx2";
+#elif defined(NETSIM_RANGING_NEON)
+  return "neon";
+#endif
+  return "scalar";
+}
+
+}  // namespace netsim::hci::ranging
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Batch RSSI computation for the Bluetooth PHY fan-out.
+//
+// The free space path loss model is distance_to_rssi in
+// rust/daemon/src/ranging.rs, which the scalar paths call. The batch
+// functions use AVX2 or NEON when available, whose results agree with it up
+// to float rounding, and the Rust model otherwise.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace netsim::hci::ranging {
+
+// Convert distance in meters to the RSSI measured at that distance, in the
+// range -120..20 dBm. Calls distance_to_rssi of the Rust daemon.
+int8_t DistanceToRssi(int8_t tx_power, float distance);
+
+// DistanceToRssi of each of count distances.
+void BatchDistanceToRssi(int8_t tx_power, const float *distances, size_t count,
+                         int8_t *rssi);
+
+// Computes the distance from the sender to count receivers, whose positions
+// are given as separate x, y and z arrays, and the RSSI at each receiver.
+void BatchPositionsToRssi(float sender_x, float sender_y, float sender_z,
+                          int8_t tx_power, const float *x, const float *y,
+                          const float *z, size_t count, float *distances,
+                          int8_t *rssi);
+
+// Returns the name of the batch implementation in use: "avx2", "neon" or
+// "scalar".
+const char *BatchImplementation();
+
+}  // namespace netsim::hci::ranging
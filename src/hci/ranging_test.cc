@@ -0,0 +1,78 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the batch RSSI functions.
+#include "hci/ranging.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "netsim-daemon/src/ffi.rs.h"
+
+namespace netsim::hci::ranging {
+namespace {
+
+// Same cases as the tests of rust/daemon/src/ranging.rs.
+TEST(RangingTest, DistanceToRssi) {
+  EXPECT_EQ(DistanceToRssi(-120, 0), -79);
+  EXPECT_EQ(DistanceToRssi(-120, 1000), -120);
+  EXPECT_EQ(DistanceToRssi(20, 0), 20);
+  auto rssi = DistanceToRssi(0, 1);
+  EXPECT_GT(rssi, -55);
+  EXPECT_LT(rssi, -35);
+}
+
+// The vector paths reimplement distance_to_rssi of ranging.rs, pin them to
+// the Rust model itself.
+TEST(RangingTest, BatchMatchesRustModel) {
+  // Odd count to exercise the scalar tail after the vector loop.
+  constexpr size_t kCount = 1003;
+  std::vector<float> distances(kCount);
+  for (size_t i = 0; i < kCount; i++) distances[i] = i * 0.37f;
+  for (int8_t tx_power : {-120, -49, 0, 1, 4, 20}) {
+    std::vector<int8_t> rssi(kCount);
+    BatchDistanceToRssi(tx_power, distances.data(), kCount, rssi.data());
+    for (size_t i = 0; i < kCount; i++) {
+      // The vector log may round differently right at an integer boundary.
+      EXPECT_LE(std::abs(rssi[i] -
+                         ::netsim::DistanceToRssi(tx_power, distances[i])),
+                1)
+          << BatchImplementation() << " distance " << distances[i];
+    }
+  }
+}
+
+TEST(RangingTest, BatchPositions) {
+  std::vector<float> x = {0, 3, 0, 0, 10, -7, 1, 2, 100};
+  std::vector<float> y = {0, 4, 6, 0, 0, 0, 1, 2, 0};
+  std::vector<float> z = {0, 0, 8, 1, 0, 24, 1, 2, 0};
+  auto count = x.size();
+  std::vector<float> distances(count);
+  std::vector<int8_t> rssi(count);
+  BatchPositionsToRssi(0, 0, 0, -10, x.data(), y.data(), z.data(), count,
+                       distances.data(), rssi.data());
+  std::vector<float> expected = {0, 5, 10, 1, 10, 25, std::sqrt(3.0f),
+                                 std::sqrt(12.0f), 100};
+  for (size_t i = 0; i < count; i++) {
+    EXPECT_NEAR(distances[i], expected[i], 1e-5);
+    EXPECT_LE(std::abs(rssi[i] - DistanceToRssi(-10, expected[i])), 1);
+  }
+  EXPECT_EQ(rssi[0], DistanceToRssi(-10, 0));
+}
+
+}  // namespace
+}  // namespace netsim::hci::ranging
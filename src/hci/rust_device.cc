@@ -14,32 +14,83 @@
 
 #include "hci/rust_device.h"
 
+#include <chrono>
 #include <cstdint>
+#include <memory>
+#include <optional>
+#include <vector>
 
 #include "netsim-daemon/src/ffi.rs.h"
 #include "packets/link_layer_packets.h"
 #include "phy.h"
 #include "rust/cxx.h"
+#include "util/packet_pool.h"
 
 namespace netsim::hci::facade {
-void RustDevice::Tick() { ::netsim::hci::facade::Tick(*callbacks_); }
+void RustDevice::Tick() {
+  if (!batch_.empty()) {
+    // Packets sent by the callbacks may be delivered while they run, so
+    // they go to a fresh batch.
+    batch_.swap(delivered_batch_);
+    ::netsim::hci::facade::ReceiveLinkLayerPackets(
+        *callbacks_, rust::Slice<const uint8_t>(delivered_batch_.data(),
+                                                delivered_batch_.size()));
+    delivered_batch_.clear();
+  }
+}
+
+std::optional<std::chrono::milliseconds> RustDevice::TickCallbacks() {
+  auto next_tick_ms = ::netsim::hci::facade::Tick(*callbacks_);
+  if (next_tick_ms == UINT64_MAX) return std::nullopt;
+  return std::chrono::milliseconds(next_tick_ms);
+}
 
 void RustDevice::ReceiveLinkLayerPacket(
     ::model::packets::LinkLayerPacketView packet, rootcanal::Phy::Type type,
     int8_t rssi) {
-  auto packet_vec = packet.bytes().bytes();
-  auto slice = rust::Slice<const uint8_t>(packet_vec.data(), packet_vec.size());
+  auto bytes = packet.bytes().bytes();
+  Receive(packet.GetSourceAddress(), packet.GetDestinationAddress(),
+          static_cast<uint8_t>(packet.GetType()), bytes.data(), bytes.size());
+}
+
+void RustDevice::ReceiveLinkLayerBytes(const std::vector<uint8_t> &packet) {
+  // The view does not outlive the call, so it borrows the packet through a
+  // shared pointer that owns nothing.
+  auto view = ::model::packets::LinkLayerPacketView::Create(pdl::packet::slice(
+      std::shared_ptr<const std::vector<uint8_t>>(std::shared_ptr<void>(),
+                                                  &packet)));
+  if (!view.IsValid()) return;
+  Receive(view.GetSourceAddress(), view.GetDestinationAddress(),
+          static_cast<uint8_t>(view.GetType()), packet.data(), packet.size());
+}
 
-  ::netsim::hci::facade::ReceiveLinkLayerPacket(
-      *callbacks_, packet.GetSourceAddress().ToString(),
-      packet.GetDestinationAddress().ToString(),
-      static_cast<int8_t>(packet.GetType()), slice);
+void RustDevice::Receive(const rootcanal::Address &source_address,
+                         const rootcanal::Address &destination_address,
+                         uint8_t packet_type, const uint8_t *packet,
+                         size_t size) {
+  if (!batch_receive_) {
+    ::netsim::hci::facade::ReceiveLinkLayerPacket(
+        *callbacks_, source_address.address, destination_address.address,
+        packet_type, rust::Slice<const uint8_t>(packet, size));
+    return;
+  }
+  // Record: source and destination address, packet type, 16 bit little
+  // endian size, then the packet.
+  if (size > UINT16_MAX) return;
+  batch_.insert(batch_.end(), source_address.address.begin(),
+                source_address.address.end());
+  batch_.insert(batch_.end(), destination_address.address.begin(),
+                destination_address.address.end());
+  batch_.push_back(packet_type);
+  batch_.push_back(static_cast<uint8_t>(size));
+  batch_.push_back(static_cast<uint8_t>(size >> 8));
+  batch_.insert(batch_.end(), packet, packet + size);
 }
 
 void RustBluetoothChip::SendLinkLayerLePacket(
     const rust::Slice<const uint8_t> packet, int8_t tx_power) const {
-  std::vector<uint8_t> buffer(packet.begin(), packet.end());
-  rust_device->SendLinkLayerPacket(buffer, rootcanal::Phy::Type::LOW_ENERGY,
+  auto buffer = util::PacketPool::Copy(packet.data(), packet.size());
+  rust_device->SendLinkLayerPacket(*buffer, rootcanal::Phy::Type::LOW_ENERGY,
                                    tx_power);
 }
 }  // namespace netsim::hci::facade
@@ -13,9 +13,12 @@
 // limitations under the License.
 #pragma once
 
+#include <chrono>
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 #include "model/devices/device.h"
 #include "packets/link_layer_packets.h"
@@ -27,26 +30,64 @@ namespace netsim::hci::facade {
 struct DynRustBluetoothChipCallbacks;
 class RustBluetoothChip;
 
+/**
+ * @class RustDevice
+ *
+ * A rootcanal device implemented in Rust, such as a beacon.
+ *
+ * Received packets cross into Rust as borrowed slices, with the addresses as
+ * 6 byte arrays in rootcanal byte order. With batch_receive they are instead
+ * collected and delivered in a single call at the next Tick, so a chip in a
+ * crowded scene does not cross the FFI once per advertisement.
+ *
+ * The Rust Tick is not called from the rootcanal tick. The device is driven
+ * by a timer of its AsyncManager (see TickCallbacks), so an idle beacon
+ * costs nothing between advertisements.
+ */
 class RustDevice : public rootcanal::Device {
  public:
   RustDevice(rust::Box<DynRustBluetoothChipCallbacks> callbacks,
-             const std::string &type, const std::string &address)
-      : callbacks_(std::move(callbacks)), TYPE(type) {
+             const std::string &type, const std::string &address,
+             bool batch_receive)
+      : callbacks_(std::move(callbacks)),
+        TYPE(type),
+        batch_receive_(batch_receive) {
     rootcanal::Address::FromString(address, address_);
     this->SetAddress(address_);
   }
 
+  // Delivers the batch of received packets. The Rust Tick runs on its timer.
   void Tick() override;
+  // Runs the Rust Tick and returns the delay before it wants the next one,
+  // or nullopt when it waits to be woken.
+  std::optional<std::chrono::milliseconds> TickCallbacks();
+  // Starts a new timer generation: timers of earlier generations stop.
+  // Only called on the thread of the AsyncManager, like TickCallbacks.
+  uint64_t NextTickGeneration() { return ++tick_generation_; }
+  uint64_t TickGeneration() const { return tick_generation_; }
   std::string GetTypeString() const override { return TYPE; }
   std::string ToString() const override { return TYPE; }
   void Close() override {}
   void ReceiveLinkLayerPacket(::model::packets::LinkLayerPacketView packet,
                               rootcanal::Phy::Type type, int8_t rssi) override;
+  // Receives a link layer packet straight from the netsim phy, without the
+  // copy and parse of PhyDevice::Receive.
+  void ReceiveLinkLayerBytes(const std::vector<uint8_t> &packet);
   void SetRustBluetoothChip(std::unique_ptr<RustBluetoothChip>);
 
  private:
+  void Receive(const rootcanal::Address &source_address,
+               const rootcanal::Address &destination_address,
+               uint8_t packet_type, const uint8_t *packet, size_t size);
+
   rust::Box<DynRustBluetoothChipCallbacks> callbacks_;
   const std::string TYPE;
+  const bool batch_receive_;
+  // Packets received since the last Tick when batch_receive_ is set, in the
+  // record format of ReceiveLinkLayerPackets.
+  std::vector<uint8_t> batch_;
+  std::vector<uint8_t> delivered_batch_;
+  uint64_t tick_generation_ = 0;
 };
 
 /// Delegation class for RustDevice to be used in Rust.
@@ -0,0 +1,234 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "hci/spatial_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+#include "hci/ranging.h"
+
+namespace netsim::hci {
+namespace {
+
+float EuclideanDistance(const SpatialIndex::Position &a,
+                        const SpatialIndex::Position &b) {
+  return std::sqrt(std::pow(b.x - a.x, 2.0f) + std::pow(b.y - a.y, 2.0f) +
+                   std::pow(b.z - a.z, 2.0f));
+}
+
+}  // namespace
+
+size_t SpatialIndex::CellHash::operator()(const Cell &cell) const {
+  auto [x, y, z] = cell;
+  return std::hash<int64_t>()((static_cast<int64_t>(x) * 73856093) ^
+                              (static_cast<int64_t>(y) * 19349663) ^
+                              (static_cast<int64_t>(z) * 83492791));
+}
+
+SpatialIndex::SpatialIndex(float range) : range_(range) {}
+
+void SpatialIndex::SetRange(float range) {
+  range_ = range;
+  Rebuild();
+}
+
+SpatialIndex::Cell SpatialIndex::CellOf(const Position &position) const {
+  // Without a cutoff every device shares one cell.
+  if (range_ <= 0) return {0, 0, 0};
+  return {static_cast<int32_t>(std::floor(position.x / range_)),
+          static_cast<int32_t>(std::floor(position.y / range_)),
+          static_cast<int32_t>(std::floor(position.z / range_))};
+}
+
+bool SpatialIndex::Contains(uint32_t device_id) const {
+  return positions_.find(device_id) != positions_.end();
+}
+
+std::optional<SpatialIndex::Position> SpatialIndex::PositionOf(
+    uint32_t device_id) const {
+  auto it = positions_.find(device_id);
+  if (it == positions_.end()) return std::nullopt;
+  return it->second;
+}
+
+std::vector<uint32_t> SpatialIndex::DeviceIds() const {
+  std::vector<uint32_t> device_ids;
+  device_ids.reserve(positions_.size());
+  for (const auto &[device_id, _] : positions_) device_ids.push_back(device_id);
+  return device_ids;
+}
+
+template <class F>
+void SpatialIndex::ForEachNear(const Cell &center, F &&f) const {
+  // Devices in range are at most one cell away.
+  int reach = range_ <= 0 ? 0 : 1;
+  auto [cx, cy, cz] = center;
+  for (int dx = -reach; dx <= reach; dx++) {
+    for (int dy = -reach; dy <= reach; dy++) {
+      for (int dz = -reach; dz <= reach; dz++) {
+        auto cell = cells_.find({cx + dx, cy + dy, cz + dz});
+        if (cell == cells_.end()) continue;
+        for (auto device_id : cell->second) f(device_id);
+      }
+    }
+  }
+}
+
+bool SpatialIndex::Update(uint32_t device_id, const Position &position) {
+  auto old = positions_.find(device_id);
+  if (old != positions_.end() && old->second.x == position.x &&
+      old->second.y == position.y && old->second.z == position.z) {
+    return false;
+  }
+  Remove(device_id);
+  auto cell = CellOf(position);
+  positions_[device_id] = position;
+  cells_[cell].push_back(device_id);
+  // Add the device to the cached links of the senders now in range.
+  ForEachNear(cell, [&](uint32_t other_id) {
+    if (other_id == device_id) return;
+    auto row = rows_.find(other_id);
+    if (row == rows_.end()) return;
+    auto distance = EuclideanDistance(positions_.at(other_id), position);
+    if (range_ <= 0 || distance <= range_) {
+      AddLink(row->second, device_id, distance);
+    }
+  });
+  return true;
+}
+
+void SpatialIndex::Remove(uint32_t device_id) {
+  auto position = positions_.find(device_id);
+  if (position == positions_.end()) return;
+  auto cell = CellOf(position->second);
+  // Only senders around the old position can link to the device.
+  ForEachNear(cell, [&](uint32_t other_id) {
+    auto row = rows_.find(other_id);
+    if (row != rows_.end()) RemoveLink(row->second, device_id);
+  });
+  rows_.erase(device_id);
+  auto &devices = cells_[cell];
+  devices.erase(std::remove(devices.begin(), devices.end(), device_id),
+                devices.end());
+  if (devices.empty()) cells_.erase(cell);
+  positions_.erase(position);
+}
+
+void SpatialIndex::Rebuild() {
+  rows_.clear();
+  cells_.clear();
+  for (const auto &[device_id, position] : positions_) {
+    cells_[CellOf(position)].push_back(device_id);
+  }
+}
+
+void SpatialIndex::AddLink(Row &row, uint32_t receiver_id, float distance) {
+  auto rssi = ranging::DistanceToRssi(row.tx_power, distance);
+  auto [slot, inserted] =
+      row.slots.try_emplace(receiver_id, row.receiver_ids.size());
+  if (inserted) {
+    row.receiver_ids.push_back(receiver_id);
+    row.distances.push_back(distance);
+    row.rssi.push_back(rssi);
+  } else {
+    row.distances[slot->second] = distance;
+    row.rssi[slot->second] = rssi;
+  }
+}
+
+void SpatialIndex::RemoveLink(Row &row, uint32_t receiver_id) {
+  auto slot = row.slots.find(receiver_id);
+  if (slot == row.slots.end()) return;
+  // Move the last link into the freed slot.
+  auto index = slot->second;
+  row.slots.erase(slot);
+  auto last = row.receiver_ids.size() - 1;
+  if (index != last) {
+    row.receiver_ids[index] = row.receiver_ids[last];
+    row.distances[index] = row.distances[last];
+    row.rssi[index] = row.rssi[last];
+    row.slots[row.receiver_ids[index]] = index;
+  }
+  row.receiver_ids.pop_back();
+  row.distances.pop_back();
+  row.rssi.pop_back();
+}
+
+SpatialIndex::Row &SpatialIndex::RowOf(uint32_t sender_id, int8_t tx_power) {
+  auto [row, inserted] = rows_.try_emplace(sender_id);
+  auto &links = row->second;
+  if (inserted) {
+    // Gather the candidates and compute all distances and rssi in one batch,
+    // then keep the links in range.
+    const auto &position = positions_.at(sender_id);
+    scratch_ids_.clear();
+    scratch_x_.clear();
+    scratch_y_.clear();
+    scratch_z_.clear();
+    ForEachNear(CellOf(position), [&](uint32_t other_id) {
+      if (other_id == sender_id) return;
+      const auto &other = positions_.at(other_id);
+      scratch_ids_.push_back(other_id);
+      scratch_x_.push_back(other.x);
+      scratch_y_.push_back(other.y);
+      scratch_z_.push_back(other.z);
+    });
+    auto count = scratch_ids_.size();
+    scratch_distances_.resize(count);
+    scratch_rssi_.resize(count);
+    ranging::BatchPositionsToRssi(
+        position.x, position.y, position.z, tx_power, scratch_x_.data(),
+        scratch_y_.data(), scratch_z_.data(), count, scratch_distances_.data(),
+        scratch_rssi_.data());
+    links.tx_power = tx_power;
+    for (size_t i = 0; i < count; i++) {
+      if (range_ > 0 && scratch_distances_[i] > range_) continue;
+      links.slots[scratch_ids_[i]] = links.receiver_ids.size();
+      links.receiver_ids.push_back(scratch_ids_[i]);
+      links.distances.push_back(scratch_distances_[i]);
+      links.rssi.push_back(scratch_rssi_[i]);
+    }
+  } else if (links.tx_power != tx_power) {
+    links.tx_power = tx_power;
+    ranging::BatchDistanceToRssi(tx_power, links.distances.data(),
+                                 links.distances.size(), links.rssi.data());
+  }
+  return links;
+}
+
+std::optional<float> SpatialIndex::Distance(uint32_t sender_id,
+                                            uint32_t receiver_id) {
+  if (!Contains(sender_id) || !Contains(receiver_id)) return std::nullopt;
+  // Keep the rssi already cached for the sender.
+  auto cached = rows_.find(sender_id);
+  auto &row =
+      RowOf(sender_id, cached == rows_.end() ? 0 : cached->second.tx_power);
+  auto slot = row.slots.find(receiver_id);
+  if (slot == row.slots.end()) return std::nullopt;
+  return row.distances[slot->second];
+}
+
+std::optional<int8_t> SpatialIndex::Rssi(uint32_t sender_id,
+                                         uint32_t receiver_id,
+                                         int8_t tx_power) {
+  if (!Contains(sender_id) || !Contains(receiver_id)) return std::nullopt;
+  auto &row = RowOf(sender_id, tx_power);
+  auto slot = row.slots.find(receiver_id);
+  if (slot == row.slots.end()) return std::nullopt;
+  return row.rssi[slot->second];
+}
+
+}  // namespace netsim::hci
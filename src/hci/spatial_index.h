@@ -0,0 +1,126 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Spatial index of simulated device positions.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace netsim::hci {
+
+/**
+ * @class SpatialIndex
+ *
+ * Keeps device positions in a uniform grid whose cells are as large as the
+ * radio range, so the devices in range of a sender are found by visiting
+ * the 27 cells around it. The in range links of a sender are computed on
+ * first use and cached; moving a device only updates the links of the
+ * senders around its old and new positions.
+ *
+ * The links of a sender are kept in structure of arrays layout, so the
+ * distances and RSSI values of a whole row are computed by one batch call
+ * of the ranging kernel.
+ *
+ * A range of zero or less disables the cutoff: every pair of known devices
+ * is linked.
+ *
+ * Not thread safe.
+ */
+class SpatialIndex {
+ public:
+  struct Position {
+    float x;
+    float y;
+    float z;
+  };
+
+  explicit SpatialIndex(float range = 0);
+
+  float Range() const { return range_; }
+  void SetRange(float range);
+
+  bool Contains(uint32_t device_id) const;
+
+  std::optional<Position> PositionOf(uint32_t device_id) const;
+
+  std::vector<uint32_t> DeviceIds() const;
+
+  // Adds or moves a device. Returns false, keeping the cached links, if the
+  // device is already at position.
+  bool Update(uint32_t device_id, const Position &position);
+
+  void Remove(uint32_t device_id);
+
+  // Returns the distance from a sender to a receiver, or nullopt if either
+  // device is unknown or the receiver is out of range.
+  std::optional<float> Distance(uint32_t sender_id, uint32_t receiver_id);
+
+  // Returns the rssi at a receiver of a packet sent with tx_power, or nullopt
+  // if either device is unknown or the receiver is out of range.
+  std::optional<int8_t> Rssi(uint32_t sender_id, uint32_t receiver_id,
+                             int8_t tx_power);
+
+ private:
+  using Cell = std::tuple<int32_t, int32_t, int32_t>;
+
+  struct CellHash {
+    size_t operator()(const Cell &cell) const;
+  };
+
+  Cell CellOf(const Position &position) const;
+  // Calls f(device_id) for every device in the cells around center.
+  template <class F>
+  void ForEachNear(const Cell &center, F &&f) const;
+  void Rebuild();
+
+  // The in range links of one sender.
+  struct Row {
+    std::vector<uint32_t> receiver_ids;
+    std::vector<float> distances;
+    std::vector<int8_t> rssi;
+    // Index of each receiver in the arrays above.
+    std::unordered_map<uint32_t, uint32_t> slots;
+    // The tx_power rssi was computed for.
+    int8_t tx_power = 0;
+  };
+
+  // Returns the links of a sender with rssi computed for tx_power.
+  Row &RowOf(uint32_t sender_id, int8_t tx_power);
+  static void AddLink(Row &row, uint32_t receiver_id, float distance);
+  static void RemoveLink(Row &row, uint32_t receiver_id);
+
+  float range_;
+  std::unordered_map<uint32_t, Position> positions_;
+  std::unordered_map<Cell, std::vector<uint32_t>, CellHash> cells_;
+  // Links by sender, computed on first use and kept up to date as devices
+  // move.
+  std::unordered_map<uint32_t, Row> rows_;
+  // Receiver positions gathered for a batch call.
+  std::vector<uint32_t> scratch_ids_;
+  std::vector<float> scratch_x_;
+  std::vector<float> scratch_y_;
+  std::vector<float> scratch_z_;
+  std::vector<float> scratch_distances_;
+  std::vector<int8_t> scratch_rssi_;
+};
+
+}  // namespace netsim::hci
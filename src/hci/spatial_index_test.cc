@@ -0,0 +1,127 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the SpatialIndex class.
+#include "hci/spatial_index.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "hci/ranging.h"
+
+namespace netsim::hci {
+namespace {
+
+TEST(SpatialIndexTest, NoCutoffLinksAllDevices) {
+  SpatialIndex index;
+  index.Update(1, {0, 0, 0});
+  index.Update(2, {1000, 0, 0});
+  auto distance = index.Distance(1, 2);
+  ASSERT_TRUE(distance.has_value());
+  EXPECT_FLOAT_EQ(*distance, 1000);
+  EXPECT_FALSE(index.Distance(1, 1).has_value());
+  EXPECT_FALSE(index.Distance(1, 3).has_value());
+}
+
+TEST(SpatialIndexTest, PositionOf) {
+  SpatialIndex index(10);
+  EXPECT_FALSE(index.PositionOf(1).has_value());
+  index.Update(1, {1, 2, 3});
+  index.Update(1, {4, 5, 6});
+  auto position = index.PositionOf(1);
+  ASSERT_TRUE(position.has_value());
+  EXPECT_FLOAT_EQ(position->x, 4);
+  EXPECT_FLOAT_EQ(position->y, 5);
+  EXPECT_FLOAT_EQ(position->z, 6);
+  index.Remove(1);
+  EXPECT_FALSE(index.PositionOf(1).has_value());
+}
+
+TEST(SpatialIndexTest, RangeCutoff) {
+  SpatialIndex index(10);
+  index.Update(1, {0, 0, 0});
+  index.Update(2, {3, 4, 0});
+  index.Update(3, {-9, 0, 0});
+  index.Update(4, {11, 0, 0});
+  ASSERT_TRUE(index.Distance(1, 2).has_value());
+  EXPECT_FLOAT_EQ(*index.Distance(1, 2), 5);
+  EXPECT_TRUE(index.Distance(1, 3).has_value());
+  EXPECT_FALSE(index.Distance(1, 4).has_value());
+  EXPECT_FALSE(index.Distance(3, 4).has_value());
+}
+
+TEST(SpatialIndexTest, MoveUpdatesCachedLinks) {
+  SpatialIndex index(10);
+  index.Update(1, {0, 0, 0});
+  index.Update(2, {50, 0, 0});
+  EXPECT_FALSE(index.Distance(1, 2).has_value());
+
+  // The links of 1 are cached now; moving 2 into range updates them.
+  index.Update(2, {0, 6, 8});
+  ASSERT_TRUE(index.Distance(1, 2).has_value());
+  EXPECT_FLOAT_EQ(*index.Distance(1, 2), 10);
+  EXPECT_TRUE(index.Distance(2, 1).has_value());
+
+  index.Update(2, {0, 0, 20});
+  EXPECT_FALSE(index.Distance(1, 2).has_value());
+
+  index.Remove(1);
+  EXPECT_FALSE(index.Contains(1));
+  EXPECT_EQ(index.DeviceIds(), std::vector<uint32_t>{2});
+  EXPECT_FALSE(index.Distance(2, 1).has_value());
+}
+
+TEST(SpatialIndexTest, UpdateInPlaceIsANoOp) {
+  SpatialIndex index;
+  EXPECT_TRUE(index.Update(1, {0, 0, 0}));
+  EXPECT_TRUE(index.Update(2, {3, 4, 0}));
+  ASSERT_TRUE(index.Distance(1, 2).has_value());
+  EXPECT_FALSE(index.Update(2, {3, 4, 0}));
+  EXPECT_FLOAT_EQ(*index.Distance(1, 2), 5);
+  EXPECT_TRUE(index.Update(2, {6, 8, 0}));
+  EXPECT_FLOAT_EQ(*index.Distance(1, 2), 10);
+}
+
+TEST(SpatialIndexTest, SetRange) {
+  SpatialIndex index(1);
+  index.Update(1, {0, 0, 0});
+  index.Update(2, {5, 0, 0});
+  EXPECT_FALSE(index.Distance(1, 2).has_value());
+  index.SetRange(0);
+  EXPECT_TRUE(index.Distance(1, 2).has_value());
+}
+
+TEST(SpatialIndexTest, RssiFollowsTxPowerAndMoves) {
+  SpatialIndex index(100);
+  index.Update(1, {0, 0, 0});
+  for (uint32_t id = 2; id < 40; id++) {
+    index.Update(id, {static_cast<float>(id), 0, 0});
+  }
+  EXPECT_EQ(index.Rssi(1, 9, -20), ranging::DistanceToRssi(-20, 9));
+  // A new tx_power recomputes the cached row.
+  EXPECT_EQ(index.Rssi(1, 9, 10), ranging::DistanceToRssi(10, 9));
+  EXPECT_EQ(index.Rssi(1, 39, 10), ranging::DistanceToRssi(10, 39));
+  // Moves and removals keep the row consistent.
+  index.Update(10, {0, 50, 0});
+  EXPECT_EQ(index.Rssi(1, 10, 10), ranging::DistanceToRssi(10, 50));
+  index.Remove(2);
+  EXPECT_FALSE(index.Rssi(1, 2, 10).has_value());
+  EXPECT_EQ(index.Rssi(1, 39, 10), ranging::DistanceToRssi(10, 39));
+  index.Update(10, {0, 500, 0});
+  EXPECT_FALSE(index.Rssi(1, 10, 10).has_value());
+}
+
+}  // namespace
+}  // namespace netsim::hci
@@ -12,34 +12,462 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+// Load generator for netsimd.
+//
+// Opens PacketStreamer streams as a fleet of emulators would and replays
+// packets on them, then reports the throughput and the round trip latency
+// of the HCI commands of every stream, e.g.
+//
+//   netsim-packet-streamer-client --streams=1000 --kind=mixed --rate=50
+//       --duration=60 --report=streams.csv
+//
+// Without --duration the streams run until Enter is pressed.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "backend/packet_streamer_client.h"
+#include "grpcpp/support/client_callback.h"
+#include "netsim/hci_packet.pb.h"
 #include "netsim/packet_streamer.grpc.pb.h"
+#include "util/latency_histogram.h"
+#include "util/packet_script.h"
 
 using netsim::common::ChipKind;
+using netsim::packet::HCIPacket;
+using netsim::packet::PacketRequest;
+using netsim::packet::PacketResponse;
+using netsim::util::LatencyHistogram;
+using netsim::util::ScriptPacket;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+constexpr uint8_t kHciEventCommandComplete = 0x0e;
+constexpr uint8_t kHciEventCommandStatus = 0x0f;
+
+const char kUsage[] =
+    "Usage: netsim-packet-streamer-client [options]\n"
+    "  --streams=N      number of concurrent streams (1)\n"
+    "  --kind=KIND      bt, wifi or mixed, alternating the kinds (bt)\n"
+    "  --rate=R         packets per second per stream, 0 to send as fast as\n"
+    "                   the command window allows (0)\n"
+    "  --window=N       HCI commands sent before their completion (1)\n"
+    "  --duration=S     seconds to run, 0 to run until Enter is pressed (0)\n"
+    "  --script=FILE    packet script to replay, see util/packet_script.h\n"
+    "  --pcap=FILE      host to controller packets of a netsim capture to\n"
+    "                   replay\n"
+    "  --server=ADDR    endpoint of netsimd, the local one by default\n"
+    "  --channels=N     connections to the server shared by the streams (1)\n"
+    "  --name=NAME      prefix of the device names (loadgen)\n"
+    "  --report=FILE    write the stats of every stream as CSV\n";
+
+struct Options {
+  int streams = 1;
+  std::string kind = "bt";
+  double rate = 0;
+  int window = 1;
+  int duration = 0;
+  std::string script;
+  std::string pcap;
+  std::string server;
+  int channels = 1;
+  std::string name = "loadgen";
+  std::string report;
+};
+
+bool ParseOptions(int argc, char *argv[], Options &options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    auto equal = arg.find('=');
+    if (arg.rfind("--", 0) != 0 || equal == std::string::npos) return false;
+    auto key = arg.substr(2, equal - 2);
+    auto value = arg.substr(equal + 1);
+    try {
+      if (key == "streams") {
+        options.streams = std::stoi(value);
+      } else if (key == "kind") {
+        options.kind = value;
+      } else if (key == "rate") {
+        options.rate = std::stod(value);
+      } else if (key == "window") {
+        options.window = std::stoi(value);
+      } else if (key == "duration") {
+        options.duration = std::stoi(value);
+      } else if (key == "script") {
+        options.script = value;
+      } else if (key == "pcap") {
+        options.pcap = value;
+      } else if (key == "server") {
+        options.server = value;
+      } else if (key == "channels") {
+        options.channels = std::stoi(value);
+      } else if (key == "name") {
+        options.name = value;
+      } else if (key == "report") {
+        options.report = value;
+      } else {
+        return false;
+      }
+    } catch (const std::exception &) {
+      return false;
+    }
+  }
+  return options.streams > 0 && options.window > 0 && options.rate >= 0 &&
+         options.duration >= 0 && options.channels > 0 &&
+         (options.script.empty() || options.pcap.empty()) &&
+         (options.kind == "bt" || options.kind == "wifi" ||
+          options.kind == "mixed");
+}
+
+std::optional<std::string> ReadFile(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) return std::nullopt;
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return buffer.str();
+}
+
+// HCI Reset, as the Bluetooth stack sends first, then commands answered by
+// any controller.
+std::vector<ScriptPacket> DefaultBluetoothPackets() {
+  return {{HCIPacket::COMMAND, {0x03, 0x0c, 0x00}},
+          {HCIPacket::COMMAND, {0x09, 0x10, 0x00}},
+          {HCIPacket::COMMAND, {0x01, 0x10, 0x00}}};
+}
+
+// A QoS data frame from a station address unique to the stream.
+std::vector<ScriptPacket> DefaultWifiPackets(uint32_t index) {
+  std::vector<uint8_t> frame = {
+      0x88, 0x02, 0x2c, 0x00, 0x02, 0x15, 0xb2, 0x00, 0x00, 0x02,
+      0x02, 0x15, 0xb2, 0x00, 0x00, 0x01, 0x02, 0x15, 0xb2, 0x00,
+      0x00, 0x03, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+  frame[13] = index >> 16;
+  frame[14] = index >> 8;
+  frame[15] = index;
+  return {{0, std::move(frame)}};
+}
+
+/**
+ * @class StreamLoad
+ *
+ * Replays packets in a loop on one stream with the gRPC callback API, so
+ * thousands of streams do not need threads of their own. One write is in
+ * flight at a time; the next one starts when the write is done, when a
+ * command completes or when the pacer ticks.
+ */
+class StreamLoad
+    : public grpc::ClientBidiReactor<PacketRequest, PacketResponse> {
+ public:
+  StreamLoad(std::string name, ChipKind kind,
+             std::vector<ScriptPacket> packets, const Options &options,
+             LatencyHistogram &total_latency)
+      : name_(std::move(name)),
+        kind_(kind),
+        packets_(std::move(packets)),
+        window_(options.window),
+        interval_(options.rate > 0
+                      ? std::chrono::duration_cast<Clock::duration>(
+                            std::chrono::duration<double>(1 / options.rate))
+                      : Clock::duration::zero()),
+        total_latency_(total_latency) {}
+
+  void Start(netsim::packet::PacketStreamer::Stub &stub) {
+    stub.async()->StreamPackets(&context_, this);
+    request_.mutable_initial_info()->set_name(name_);
+    request_.mutable_initial_info()->mutable_chip()->set_kind(kind_);
+    writing_ = true;
+    StartWrite(&request_);
+    StartRead(&response_);
+    StartCall();
+  }
+
+  // Cancels the stream and waits for gRPC to be done with it.
+  void Stop() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    context_.TryCancel();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return done_; });
+  }
+
+  // Sends the next packet if the rate allows it.
+  void Tick(Clock::time_point now) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (PrepareWriteLocked(now)) {
+      lock.unlock();
+      StartWrite(&request_);
+    }
+  }
+
+  void OnWriteDone(bool ok) override {
+    std::unique_lock<std::mutex> lock(mutex_);
+    writing_ = false;
+    if (!ok) return;  // The stream is broken, OnDone follows.
+    connected_ = true;
+    if (PrepareWriteLocked(Clock::now())) {
+      lock.unlock();
+      StartWrite(&request_);
+    }
+  }
+
+  void OnReadDone(bool ok) override {
+    if (!ok) return;  // The stream is finished, OnDone follows.
+    auto now = Clock::now();
+    std::unique_lock<std::mutex> lock(mutex_);
+    received_++;
+    if (response_.has_hci_packet()) {
+      const auto &packet = response_.hci_packet().packet();
+      received_bytes_ += packet.size();
+      if (response_.hci_packet().packet_type() == HCIPacket::EVENT &&
+          !packet.empty() && !outstanding_.empty() &&
+          (packet[0] == kHciEventCommandComplete ||
+           packet[0] == kHciEventCommandStatus)) {
+        latency_.Record(now - outstanding_.front());
+        total_latency_.Record(now - outstanding_.front());
+        outstanding_.pop_front();
+      }
+    } else {
+      received_bytes_ += response_.packet().size();
+    }
+    bool write = PrepareWriteLocked(now);
+    lock.unlock();
+    if (write) StartWrite(&request_);
+    StartRead(&response_);
+  }
+
+  void OnDone(const grpc::Status &status) override {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!stopping_) error_ = status.ok() ? "closed" : status.error_message();
+    done_ = true;
+    done_cv_.notify_all();
+  }
+
+  // One line of the CSV report.
+  std::string Report(double seconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::ostringstream line;
+    line << name_ << "," << (kind_ == ChipKind::WIFI ? "wifi" : "bt") << ","
+         << sent_ << "," << received_ << "," << sent_bytes_ << ","
+         << received_bytes_ << "," << sent_ / seconds << ","
+         << received_ / seconds << "," << latency_.Count() << ","
+         << latency_.PercentileMicros(0.5) << ","
+         << latency_.PercentileMicros(0.99) << "," << latency_.MaxMicros()
+         << "," << (error_.empty() ? "ok" : error_);
+    return line.str();
+  }
+
+  struct Totals {
+    int connected = 0;
+    int failed = 0;
+    uint64_t sent = 0;
+    uint64_t received = 0;
+    uint64_t sent_bytes = 0;
+    uint64_t received_bytes = 0;
+  };
+
+  void AddTo(Totals &totals) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (connected_) totals.connected++;
+    if (!error_.empty()) totals.failed++;
+    totals.sent += sent_;
+    totals.received += received_;
+    totals.sent_bytes += sent_bytes_;
+    totals.received_bytes += received_bytes_;
+  }
+
+ private:
+  // Fills request_ with the next packet and returns true if it has to be
+  // written.
+  bool PrepareWriteLocked(Clock::time_point now) {
+    if (writing_ || stopping_ || !connected_ || packets_.empty()) return false;
+    if (interval_ != Clock::duration::zero() && now < next_send_) return false;
+    const auto &packet = packets_[next_packet_];
+    bool command = packet.hci_type == HCIPacket::COMMAND;
+    if (command && outstanding_.size() >= static_cast<size_t>(window_)) {
+      return false;
+    }
+    std::string payload(packet.payload.begin(), packet.payload.end());
+    if (packet.hci_type != 0) {
+      auto hci_packet = request_.mutable_hci_packet();
+      hci_packet->set_packet_type(
+          static_cast<HCIPacket::PacketType>(packet.hci_type));
+      hci_packet->set_packet(std::move(payload));
+    } else {
+      request_.set_packet(std::move(payload));
+    }
+    if (command) outstanding_.push_back(now);
+    sent_++;
+    sent_bytes_ += packet.payload.size();
+    next_packet_ = (next_packet_ + 1) % packets_.size();
+    if (interval_ != Clock::duration::zero()) {
+      // Catch up after short stalls but not after long ones.
+      next_send_ = std::max(next_send_ + interval_, now - interval_);
+    }
+    writing_ = true;
+    return true;
+  }
+
+  const std::string name_;
+  const ChipKind kind_;
+  const std::vector<ScriptPacket> packets_;
+  const int window_;
+  const Clock::duration interval_;
+  LatencyHistogram &total_latency_;
+  grpc::ClientContext context_;
+  // Only touched by the write in flight.
+  PacketRequest request_;
+  PacketResponse response_;
+
+  std::mutex mutex_;
+  std::condition_variable done_cv_;
+  bool writing_ = false;
+  bool connected_ = false;
+  bool stopping_ = false;
+  bool done_ = false;
+  std::string error_;
+  size_t next_packet_ = 0;
+  Clock::time_point next_send_;
+  // Send times of the commands waiting for their completion.
+  std::deque<Clock::time_point> outstanding_;
+  uint64_t sent_ = 0;
+  uint64_t received_ = 0;
+  uint64_t sent_bytes_ = 0;
+  uint64_t received_bytes_ = 0;
+  LatencyHistogram latency_;
+};
+
+}  // namespace
 
 int main(int argc, char *argv[]) {
   // Finding the netsimd binary requires this env variable when run
   // interactively export ANDROID_EMULATOR_LAUNCHER_DIR=./objs
 
-  auto channel = netsim::packet::CreateChannel("");
+  Options options;
+  if (!ParseOptions(argc, argv, options)) {
+    std::cerr << kUsage;
+    return 1;
+  }
+
+  // Packets of a script or capture go to the streams of their radio.
+  std::optional<std::vector<ScriptPacket>> replay;
+  if (!options.script.empty() || !options.pcap.empty()) {
+    auto path = options.script.empty() ? options.pcap : options.script;
+    auto contents = ReadFile(path);
+    if (!contents) {
+      std::cerr << "Failed to read " << path << "\n";
+      return 1;
+    }
+    replay = options.script.empty()
+                 ? netsim::util::ParsePcap(*contents)
+                 : netsim::util::ParsePacketScript(*contents);
+    if (!replay) return 1;
+  }
+  std::vector<ScriptPacket> bt_packets;
+  std::vector<ScriptPacket> wifi_packets;
+  if (replay) {
+    for (auto &packet : *replay) {
+      (packet.hci_type != 0 ? bt_packets : wifi_packets).push_back(packet);
+    }
+  } else {
+    bt_packets = DefaultBluetoothPackets();
+  }
+
+  if (!options.server.empty()) {
+    netsim::packet::SetPacketStreamEndpoint(options.server);
+  }
+  netsim::packet::SetPacketStreamChannelPoolSize(options.channels);
 
-  std::unique_ptr<netsim::packet::PacketStreamer::Stub> stub =
-      netsim::packet::PacketStreamer::NewStub(channel);
+  LatencyHistogram total_latency;
+  std::vector<std::unique_ptr<netsim::packet::PacketStreamer::Stub>> stubs;
+  std::vector<std::unique_ptr<StreamLoad>> streams;
+  for (int i = 0; i < options.streams; i++) {
+    bool wifi = options.kind == "wifi" || (options.kind == "mixed" && i % 2);
+    auto packets = !wifi    ? bt_packets
+                   : replay ? wifi_packets
+                            : DefaultWifiPackets(i);
+    streams.push_back(std::make_unique<StreamLoad>(
+        options.name + "-" + std::to_string(i),
+        wifi ? ChipKind::WIFI : ChipKind::BLUETOOTH, std::move(packets),
+        options, total_latency));
+    // Channels are handed out from the pool in turn.
+    stubs.push_back(netsim::packet::PacketStreamer::NewStub(
+        netsim::packet::CreateChannel("")));
+  }
+  auto start = Clock::now();
+  for (size_t i = 0; i < streams.size(); i++) streams[i]->Start(*stubs[i]);
 
-  grpc::ClientContext context;
+  std::atomic<bool> running{true};
+  std::thread pacer;
+  if (options.rate > 0) {
+    pacer = std::thread([&streams, &running] {
+      while (running) {
+        auto now = Clock::now();
+        for (auto &stream : streams) stream->Tick(now);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+  }
 
-  netsim::packet::PacketRequest initial_request;
-  netsim::packet::Stream bt_stream = stub->StreamPackets(&context);
-  initial_request.mutable_initial_info()->set_name("emulator-5554");
-  initial_request.mutable_initial_info()->mutable_chip()->set_kind(
-      ChipKind::BLUETOOTH);
-  bt_stream->Write(initial_request);
+  if (options.duration > 0) {
+    std::this_thread::sleep_for(std::chrono::seconds(options.duration));
+  } else {
+    std::cout << "Press enter to close the connections...";
+    std::string s;
+    getline(std::cin, s);
+  }
+  running = false;
+  if (pacer.joinable()) pacer.join();
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  for (auto &stream : streams) stream->Stop();
 
-  std::cout << "Press enter to close the connection...";
-  std::string s;
-  getline(std::cin, s);
+  StreamLoad::Totals totals;
+  for (auto &stream : streams) stream->AddTo(totals);
+  std::printf("streams:  %d, %d connected, %d failed\n", options.streams,
+              totals.connected, totals.failed);
+  std::printf("duration: %.1f s\n", seconds);
+  std::printf("sent:     %llu packets, %.0f packets/s, %.3f MB/s\n",
+              static_cast<unsigned long long>(totals.sent),
+              totals.sent / seconds, totals.sent_bytes / seconds / 1e6);
+  std::printf("received: %llu packets, %.0f packets/s, %.3f MB/s\n",
+              static_cast<unsigned long long>(totals.received),
+              totals.received / seconds,
+              totals.received_bytes / seconds / 1e6);
+  std::printf(
+      "command round trip: %llu, p50 %llu us, p99 %llu us, p99.9 %llu us, "
+      "max %llu us\n",
+      static_cast<unsigned long long>(total_latency.Count()),
+      static_cast<unsigned long long>(total_latency.PercentileMicros(0.5)),
+      static_cast<unsigned long long>(total_latency.PercentileMicros(0.99)),
+      static_cast<unsigned long long>(total_latency.PercentileMicros(0.999)),
+      static_cast<unsigned long long>(total_latency.MaxMicros()));
 
+  if (!options.report.empty()) {
+    std::ofstream report(options.report);
+    report << "stream,kind,sent,received,sent_bytes,received_bytes,"
+              "sent_per_sec,received_per_sec,rtt_count,rtt_p50_us,"
+              "rtt_p99_us,rtt_max_us,status\n";
+    for (auto &stream : streams) report << stream->Report(seconds) << "\n";
+    if (!report) {
+      std::cerr << "Failed to write " << options.report << "\n";
+      return 1;
+    }
+  }
   return (0);
 }
@@ -0,0 +1,26 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Microbenchmarks of the netsimd packet path.
+//
+// The benchmarks run in-process on synthetic HCI and 802.11 traffic and
+// report packets/sec (items_per_second) and time_per_packet, e.g.
+//
+//   netsimd-bench --benchmark_filter=HandleBtRequest
+//
+// They live next to the code they measure as *_benchmark.cc.
+
+#include "benchmark/benchmark.h"
+
+BENCHMARK_MAIN();
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Counters shared by the netsimd-bench benchmarks.
+
+#include <cstdint>
+
+#include "benchmark/benchmark.h"
+
+namespace netsim {
+namespace util {
+
+/**
+ * @brief Reports packets/sec as items_per_second and the time per packet as
+ * time_per_packet, printed with a time unit such as "97ns".
+ *
+ * @param packets - number of packets handled by all the iterations
+ */
+inline void SetPacketCounters(benchmark::State &state, int64_t packets) {
+  state.SetItemsProcessed(packets);
+  state.counters["time_per_packet"] = benchmark::Counter(
+      static_cast<double>(packets),
+      benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+}
+
+}  // namespace util
+}  // namespace netsim
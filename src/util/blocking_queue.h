@@ -18,6 +18,7 @@
 #include <condition_variable>
 #include <deque>
 #include <mutex>
+#include <queue>
 
 namespace netsim {
 namespace util {
@@ -32,6 +33,8 @@ namespace util {
  *
  * Avoid copying by using a smart pointer for T.
  *
+ * See `MpscRingQueue` for a bounded lock-free variant with a single reader.
+ *
  */
 
 template <class T>
@@ -56,7 +59,7 @@ class BlockingQueue {
       std::unique_lock<std::mutex> lock(this->mutex);
       this->stopped = true;
     }
-    this->condition.notify_one();
+    this->condition.notify_all();
   }
 
   /**
@@ -97,7 +100,7 @@ class BlockingQueue {
     this->condition.wait(lock,
                          [=] { return this->stopped || !this->queue.empty(); });
     if (stopped) return false;
-    value = this->queue.front();
+    value = std::move(this->queue.front());
     this->queue.pop();
     return true;
   }
@@ -0,0 +1,80 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of the packet hand-off queues.
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "util/benchmark_counters.h"
+#include "util/blocking_queue.h"
+#include "util/mpsc_ring_queue.h"
+
+namespace netsim {
+namespace util {
+namespace {
+
+using Packet = std::shared_ptr<std::vector<uint8_t>>;
+
+constexpr int kPacketsPerIteration = 16384;
+
+void PushPacket(BlockingQueue<Packet> &queue, const Packet &packet) {
+  queue.Push(packet);
+}
+
+void PushPacket(MpscRingQueue<Packet> &queue, const Packet &packet) {
+  while (!queue.Push(packet)) std::this_thread::yield();
+}
+
+// Producers hand kPacketsPerIteration packets to the benchmark thread, as
+// the gRPC readers do to a chip writer. Arg: number of producer threads.
+template <class Queue>
+void BM_QueueHandOff(benchmark::State &state) {
+  const int producers = state.range(0);
+  // An HCI ACL packet, shared as on the packet path.
+  auto packet = std::make_shared<std::vector<uint8_t>>(64, 0x02);
+  Queue queue;
+  for (auto _ : state) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producers; i++) {
+      threads.emplace_back([&queue, &packet, producers] {
+        for (int n = 0; n < kPacketsPerIteration / producers; n++) {
+          PushPacket(queue, packet);
+        }
+      });
+    }
+    Packet received;
+    for (int n = 0; n < kPacketsPerIteration / producers * producers; n++) {
+      queue.WaitAndPop(received);
+    }
+    for (auto &thread : threads) thread.join();
+  }
+  SetPacketCounters(state, state.iterations() *
+                               (kPacketsPerIteration / producers * producers));
+}
+
+BENCHMARK_TEMPLATE(BM_QueueHandOff, BlockingQueue<Packet>)
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_QueueHandOff, MpscRingQueue<Packet>)
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace util
+}  // namespace netsim
@@ -0,0 +1,210 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/chip_snapshot.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "util/log.h"
+#include "util/mapped_file.h"
+
+namespace netsim {
+namespace util {
+namespace {
+
+// Layout: magic, version, chip count, then for each chip its key, address,
+// model and commands. Strings and byte arrays are prefixed with their size.
+constexpr std::string_view kMagic = "NSSN";
+constexpr uint32_t kVersion = 1;
+
+void PutUint(std::string &out, uint64_t value, int bytes) {
+  for (int i = 0; i < bytes; i++) {
+    out.push_back(static_cast<char>(value >> (8 * i)));
+  }
+}
+
+void PutBytes(std::string &out, const void *data, size_t size, int size_bytes) {
+  PutUint(out, size, size_bytes);
+  out.append(static_cast<const char *>(data), size);
+}
+
+class Reader {
+ public:
+  explicit Reader(std::string_view bytes) : bytes_(bytes) {}
+
+  std::optional<uint64_t> Uint(int bytes) {
+    if (bytes_.size() < static_cast<size_t>(bytes)) return std::nullopt;
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++)
+      value |= uint64_t{static_cast<uint8_t>(bytes_[i])} << (8 * i);
+    bytes_.remove_prefix(bytes);
+    return value;
+  }
+
+  std::optional<std::string_view> Bytes(int size_bytes) {
+    auto size = Uint(size_bytes);
+    if (!size || bytes_.size() < *size) return std::nullopt;
+    auto bytes = bytes_.substr(0, *size);
+    bytes_.remove_prefix(*size);
+    return bytes;
+  }
+
+  bool Done() const { return bytes_.empty(); }
+
+ private:
+  std::string_view bytes_;
+};
+
+std::vector<uint8_t> ToVector(std::string_view bytes) {
+  return {bytes.begin(), bytes.end()};
+}
+
+std::mutex store_mutex;
+SimulationSnapshot store;
+// Keys of the snapshots put by removed chips, oldest first.
+std::deque<std::string> retired_keys;
+
+void ForgetRetiredLocked(const std::string &key) {
+  retired_keys.erase(
+      std::remove(retired_keys.begin(), retired_keys.end(), key),
+      retired_keys.end());
+}
+
+}  // namespace
+
+std::string SerializeSnapshot(const SimulationSnapshot &snapshot) {
+  std::string out(kMagic);
+  PutUint(out, kVersion, 4);
+  PutUint(out, snapshot.size(), 4);
+  for (const auto &[key, chip] : snapshot) {
+    PutBytes(out, key.data(), key.size(), 2);
+    PutBytes(out, chip.address.data(), chip.address.size(), 1);
+    PutBytes(out, chip.model.data(), chip.model.size(), 4);
+    PutUint(out, chip.commands.size(), 2);
+    for (const auto &command : chip.commands) {
+      PutBytes(out, command.data(), command.size(), 2);
+    }
+  }
+  return out;
+}
+
+std::optional<SimulationSnapshot> ParseSnapshot(std::string_view bytes) {
+  if (bytes.substr(0, kMagic.size()) != kMagic) return std::nullopt;
+  Reader reader(bytes.substr(kMagic.size()));
+  auto version = reader.Uint(4);
+  if (version != kVersion) return std::nullopt;
+  auto count = reader.Uint(4);
+  if (!count) return std::nullopt;
+  SimulationSnapshot snapshot;
+  for (uint64_t i = 0; i < *count; i++) {
+    auto key = reader.Bytes(2);
+    auto address = reader.Bytes(1);
+    auto model = reader.Bytes(4);
+    auto command_count = reader.Uint(2);
+    if (!key || !address || !model || !command_count) return std::nullopt;
+    ChipSnapshot chip{ToVector(*address), std::string(*model), {}};
+    chip.commands.reserve(*command_count);
+    for (uint64_t c = 0; c < *command_count; c++) {
+      auto command = reader.Bytes(2);
+      if (!command) return std::nullopt;
+      chip.commands.push_back(ToVector(*command));
+    }
+    snapshot.insert_or_assign(std::string(*key), std::move(chip));
+  }
+  if (!reader.Done()) return std::nullopt;
+  return snapshot;
+}
+
+bool WriteSnapshotFile(const std::string &path,
+                       const SimulationSnapshot &snapshot) {
+  auto bytes = SerializeSnapshot(snapshot);
+  auto temporary = path + ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), bytes.size());
+    if (!out) {
+      BtsLogError("Failed to write snapshot %s", temporary.c_str());
+      return false;
+    }
+  }
+  // Replace the old snapshot in one step, so a reader sees either the old
+  // snapshot or the new one, and a crash never leaves neither.
+#if defined(_WIN32)
+  if (!MoveFileExA(temporary.c_str(), path.c_str(),
+                   MOVEFILE_REPLACE_EXISTING)) {
+#else
+  if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+#endif
+    BtsLogError("Failed to rename snapshot to %s", path.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::optional<SimulationSnapshot> ReadSnapshotFile(const std::string &path) {
+  auto file = MappedFile::Open(path);
+  if (!file) return std::nullopt;
+  auto snapshot = ParseSnapshot(file->Contents());
+  if (!snapshot) BtsLogError("Invalid snapshot %s", path.c_str());
+  return snapshot;
+}
+
+void SnapshotStore::Put(const std::string &key, ChipSnapshot snapshot) {
+  std::lock_guard<std::mutex> lock(store_mutex);
+  store.insert_or_assign(key, std::move(snapshot));
+  ForgetRetiredLocked(key);
+  retired_keys.push_back(key);
+  if (retired_keys.size() > kRetiredChipSnapshots) {
+    store.erase(retired_keys.front());
+    retired_keys.pop_front();
+  }
+}
+
+std::optional<ChipSnapshot> SnapshotStore::Take(const std::string &key) {
+  std::lock_guard<std::mutex> lock(store_mutex);
+  auto node = store.extract(key);
+  if (node.empty()) return std::nullopt;
+  ForgetRetiredLocked(key);
+  return std::move(node.mapped());
+}
+
+SimulationSnapshot SnapshotStore::Copy() {
+  std::lock_guard<std::mutex> lock(store_mutex);
+  return store;
+}
+
+void SnapshotStore::Merge(SimulationSnapshot snapshot) {
+  std::lock_guard<std::mutex> lock(store_mutex);
+  for (auto &[key, chip] : snapshot) {
+    store.insert_or_assign(key, std::move(chip));
+    ForgetRetiredLocked(key);
+  }
+}
+
+}  // namespace util
+}  // namespace netsim
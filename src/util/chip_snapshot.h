@@ -0,0 +1,87 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Simulation state of chips kept across their streams and netsimd runs.
+//
+// An emulator restored from a snapshot reconnects with a new stream and so
+// a new chip. The state the guest already configured, such as the address
+// and the controller configuration, is looked up by a key naming the chip
+// in its device, so the new chip can resume instead of being reset.
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace netsim {
+namespace util {
+
+struct ChipSnapshot {
+  // Bluetooth address in rootcanal byte order, empty when not known.
+  std::vector<uint8_t> address;
+  // Serialized model of the chip, e.g. a model::Chip::Bluetooth.
+  std::string model;
+  // HCI commands that restore the controller configuration.
+  std::vector<std::vector<uint8_t>> commands;
+};
+
+// Chip snapshots by chip key.
+using SimulationSnapshot = std::map<std::string, ChipSnapshot>;
+
+// Compact binary encoding of a simulation snapshot, little endian.
+std::string SerializeSnapshot(const SimulationSnapshot &snapshot);
+
+// Returns nullopt when the bytes are not a valid snapshot.
+std::optional<SimulationSnapshot> ParseSnapshot(std::string_view bytes);
+
+// Writes the snapshot to a temporary file renamed over path.
+bool WriteSnapshotFile(const std::string &path,
+                       const SimulationSnapshot &snapshot);
+
+// Parses the snapshot file in place from a read-only mapping.
+std::optional<SimulationSnapshot> ReadSnapshotFile(const std::string &path);
+
+// Snapshots of removed chips kept in the store. Past this, the snapshot of
+// the oldest removed chip is dropped.
+constexpr size_t kRetiredChipSnapshots = 16;
+
+/**
+ * @brief Snapshots of the chips that are not attached.
+ *
+ * A facade puts the snapshot of a chip when its stream disconnects and takes
+ * it back when a chip with the same key is added. The snapshots loaded from
+ * a file are kept until taken; the ones put are capped at
+ * kRetiredChipSnapshots.
+ */
+class SnapshotStore {
+ public:
+  static void Put(const std::string &key, ChipSnapshot snapshot);
+
+  static std::optional<ChipSnapshot> Take(const std::string &key);
+
+  static SimulationSnapshot Copy();
+
+  // Adds the chips of snapshot, replacing those with the same keys.
+  static void Merge(SimulationSnapshot snapshot);
+};
+
+}  // namespace util
+}  // namespace netsim
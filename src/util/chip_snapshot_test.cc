@@ -0,0 +1,109 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the chip snapshot encoding and store.
+#include "util/chip_snapshot.h"
+
+#include <cstdio>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using util::ChipSnapshot;
+using util::SimulationSnapshot;
+using util::SnapshotStore;
+
+SimulationSnapshot TestSnapshot() {
+  SimulationSnapshot snapshot;
+  snapshot["emulator-5554/BLUETOOTH/"] = ChipSnapshot{
+      {0x01, 0x02, 0x03, 0x04, 0x05, 0x06},
+      "model",
+      {{0x03, 0x0c, 0x00}, {0x01, 0x20, 0x08, 1, 2, 3, 4, 5, 6, 7, 8}}};
+  snapshot["emulator-5556/WIFI/"] = ChipSnapshot{{}, "wifi", {}};
+  return snapshot;
+}
+
+void ExpectEqual(const SimulationSnapshot &a, const SimulationSnapshot &b) {
+  ASSERT_EQ(a.size(), b.size());
+  for (const auto &[key, chip] : a) {
+    auto it = b.find(key);
+    ASSERT_NE(it, b.end()) << key;
+    EXPECT_EQ(chip.address, it->second.address);
+    EXPECT_EQ(chip.model, it->second.model);
+    EXPECT_EQ(chip.commands, it->second.commands);
+  }
+}
+
+TEST(ChipSnapshotTest, SerializeRoundTrip) {
+  auto snapshot = TestSnapshot();
+  auto parsed = util::ParseSnapshot(util::SerializeSnapshot(snapshot));
+  ASSERT_TRUE(parsed.has_value());
+  ExpectEqual(snapshot, *parsed);
+}
+
+TEST(ChipSnapshotTest, RejectsTruncatedSnapshot) {
+  auto bytes = util::SerializeSnapshot(TestSnapshot());
+  for (size_t size = 0; size < bytes.size(); size++) {
+    EXPECT_FALSE(util::ParseSnapshot(bytes.substr(0, size)).has_value())
+        << size;
+  }
+  EXPECT_FALSE(util::ParseSnapshot(bytes + "x").has_value());
+}
+
+TEST(ChipSnapshotTest, FileRoundTrip) {
+  std::string path = ::testing::TempDir() + "chip_snapshot_test.bin";
+  auto snapshot = TestSnapshot();
+  ASSERT_TRUE(util::WriteSnapshotFile(path, snapshot));
+  auto read = util::ReadSnapshotFile(path);
+  ASSERT_TRUE(read.has_value());
+  ExpectEqual(snapshot, *read);
+  std::remove(path.c_str());
+  EXPECT_FALSE(util::ReadSnapshotFile(path).has_value());
+}
+
+TEST(ChipSnapshotTest, StoreTakesSnapshotOnce) {
+  SnapshotStore::Merge(TestSnapshot());
+  auto chip = SnapshotStore::Take("emulator-5554/BLUETOOTH/");
+  ASSERT_TRUE(chip.has_value());
+  EXPECT_EQ(chip->model, "model");
+  EXPECT_FALSE(SnapshotStore::Take("emulator-5554/BLUETOOTH/").has_value());
+  SnapshotStore::Put("emulator-5554/BLUETOOTH/", *chip);
+  EXPECT_EQ(SnapshotStore::Copy().size(), 2);
+}
+
+TEST(ChipSnapshotTest, StoreDropsOldestRemovedChips) {
+  SnapshotStore::Merge(TestSnapshot());
+  for (size_t i = 0; i <= util::kRetiredChipSnapshots; i++) {
+    SnapshotStore::Put("removed-" + std::to_string(i), ChipSnapshot{});
+  }
+  auto last = "removed-" + std::to_string(util::kRetiredChipSnapshots);
+  auto store = SnapshotStore::Copy();
+  EXPECT_EQ(store.count("removed-0"), 0);
+  EXPECT_EQ(store.count("removed-1"), 1);
+  EXPECT_EQ(store.count(last), 1);
+  // Loaded snapshots are kept until taken.
+  EXPECT_EQ(store.count("emulator-5556/WIFI/"), 1);
+  EXPECT_TRUE(SnapshotStore::Take("emulator-5556/WIFI/").has_value());
+  for (size_t i = 1; i <= util::kRetiredChipSnapshots; i++) {
+    SnapshotStore::Take("removed-" + std::to_string(i));
+  }
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
@@ -41,6 +41,7 @@
 #endif
 
 #include "util/filesystem.h"
+#include "util/flight_recorder.h"
 #include "util/ini_file.h"
 #include "util/log.h"
 
@@ -66,6 +67,8 @@ bool crash_callback(const void *crash_context, size_t crash_context_size,
   } else {
     std::cerr << "Process crashed, signal: unknown, tid: unknown\n";
   }
+  // Dumps the recent packets of the chips before unwinding, which may fail.
+  util::DumpFlightRecorders(STDERR_FILENO);
   unwindstack::AndroidLocalUnwinder unwinder;
   unwindstack::AndroidUnwinderData data;
   if (!unwinder.Unwind(tid, data)) {
@@ -89,6 +92,7 @@ void SignalHandler(int sig) {
           "netsim error: interrupt by signal %d. Obtained %d stack frames:\n",
           sig, size);
   backtrace_symbols_fd(buffer, size, STDERR_FILENO);
+  util::DumpFlightRecorders(STDERR_FILENO);
   exit(sig);
 }
 #endif
@@ -100,9 +104,10 @@ void SetUpCrashReport() {
 #if defined(__linux__)
 #ifndef NETSIM_ANDROID_EMULATOR
   google_breakpad::MinidumpDescriptor descriptor("/tmp");
-  google_breakpad::ExceptionHandler eh(descriptor, nullptr, nullptr, nullptr,
-                                       true, -1);
-  eh.set_crash_handler(crash_callback);
+  // Lives until exit: the handler is uninstalled when it is destroyed.
+  static auto *eh = new google_breakpad::ExceptionHandler(
+      descriptor, nullptr, nullptr, nullptr, true, -1);
+  eh->set_crash_handler(crash_callback);
 #else
   signal(SIGSEGV, SignalHandler);
 #endif
@@ -0,0 +1,136 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/file_watcher.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/event.h>
+#include <unistd.h>
+#else
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#include <chrono>
+#include <string>
+#include <thread>
+
+namespace netsim {
+namespace util {
+
+#if defined(_WIN32)
+
+DirectoryWatcher::DirectoryWatcher(const std::string &directory) {
+  handle_ = FindFirstChangeNotificationA(
+      directory.c_str(), FALSE,
+      FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE);
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+  if (IsWatching()) FindCloseChangeNotification(handle_);
+}
+
+bool DirectoryWatcher::IsWatching() const {
+  return handle_ != INVALID_HANDLE_VALUE;
+}
+
+bool DirectoryWatcher::Wait(std::chrono::milliseconds timeout) {
+  if (!IsWatching()) {
+    std::this_thread::sleep_for(timeout);
+    return false;
+  }
+  if (WaitForSingleObject(handle_, static_cast<DWORD>(timeout.count())) !=
+      WAIT_OBJECT_0)
+    return false;
+  FindNextChangeNotification(handle_);
+  return true;
+}
+
+#elif defined(__APPLE__)
+
+DirectoryWatcher::DirectoryWatcher(const std::string &directory) {
+  directory_fd_ = open(directory.c_str(), O_EVTONLY);
+  if (directory_fd_ < 0) return;
+  fd_ = kqueue();
+  if (fd_ < 0) return;
+  // Entries of a directory are created and renamed by writing it.
+  struct kevent change;
+  EV_SET(&change, directory_fd_, EVFILT_VNODE, EV_ADD | EV_CLEAR,
+         NOTE_WRITE | NOTE_EXTEND, 0, nullptr);
+  if (kevent(fd_, &change, 1, nullptr, 0, nullptr) < 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+  if (fd_ >= 0) close(fd_);
+  if (directory_fd_ >= 0) close(directory_fd_);
+}
+
+bool DirectoryWatcher::IsWatching() const { return fd_ >= 0; }
+
+bool DirectoryWatcher::Wait(std::chrono::milliseconds timeout) {
+  if (!IsWatching()) {
+    std::this_thread::sleep_for(timeout);
+    return false;
+  }
+  auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+  struct timespec spec;
+  spec.tv_sec = seconds.count();
+  spec.tv_nsec = std::chrono::nanoseconds(timeout - seconds).count();
+  struct kevent event;
+  return kevent(fd_, nullptr, 0, &event, 1, &spec) > 0;
+}
+
+#else
+
+DirectoryWatcher::DirectoryWatcher(const std::string &directory) {
+  fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (fd_ < 0) return;
+  if (inotify_add_watch(fd_, directory.c_str(),
+                        IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+    close(fd_);
+    fd_ = -1;
+  }
+}
+
+DirectoryWatcher::~DirectoryWatcher() {
+  if (fd_ >= 0) close(fd_);
+}
+
+bool DirectoryWatcher::IsWatching() const { return fd_ >= 0; }
+
+bool DirectoryWatcher::Wait(std::chrono::milliseconds timeout) {
+  if (!IsWatching()) {
+    std::this_thread::sleep_for(timeout);
+    return false;
+  }
+  struct pollfd pfd = {fd_, POLLIN, 0};
+  if (poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) return false;
+  // Drop the queued events, a change of any file wakes the waiter.
+  alignas(struct inotify_event) char events[4096];
+  while (read(fd_, events, sizeof(events)) > 0) {
+  }
+  return true;
+}
+
+#endif
+
+}  // namespace util
+}  // namespace netsim
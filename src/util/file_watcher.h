@@ -0,0 +1,58 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <string>
+
+namespace netsim {
+namespace util {
+
+/**
+ * @class DirectoryWatcher
+ *
+ * Waits for files of a directory to be created, written or renamed, with
+ * inotify on Linux, kqueue on macOS and change notifications on Windows.
+ * When the directory can not be watched, for example because it does not
+ * exist yet, Wait sleeps for its timeout instead.
+ */
+class DirectoryWatcher {
+ public:
+  explicit DirectoryWatcher(const std::string &directory);
+  ~DirectoryWatcher();
+  DirectoryWatcher(const DirectoryWatcher &) = delete;
+  DirectoryWatcher &operator=(const DirectoryWatcher &) = delete;
+
+  bool IsWatching() const;
+
+  // Returns true when the directory changed within timeout, or since the
+  // previous Wait.
+  bool Wait(std::chrono::milliseconds timeout);
+
+ private:
+#if defined(_WIN32)
+  void *handle_;
+#else
+  int fd_ = -1;
+#if defined(__APPLE__)
+  int directory_fd_ = -1;
+#endif
+#endif
+};
+
+}  // namespace util
+}  // namespace netsim
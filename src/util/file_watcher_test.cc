@@ -0,0 +1,66 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for DirectoryWatcher class.
+#include "util/file_watcher.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "util/filesystem.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using namespace std::chrono_literals;
+using util::DirectoryWatcher;
+
+// The directory of a temporary file name, which exists.
+std::string TempDirectory() {
+  std::string name = std::tmpnam(nullptr);
+  return name.substr(0, name.rfind(netsim::filesystem::slash.back()));
+}
+
+TEST(DirectoryWatcherTest, WakesOnNewFile) {
+  auto directory = TempDirectory();
+  DirectoryWatcher watcher(directory);
+  ASSERT_TRUE(watcher.IsWatching());
+
+  std::string filename = std::tmpnam(nullptr);
+  std::thread writer([&filename]() {
+    std::this_thread::sleep_for(20ms);
+    std::ofstream(filename) << "grpc.port=123\n";
+  });
+  auto start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(watcher.Wait(10s));
+  EXPECT_LT(std::chrono::steady_clock::now() - start, 5s);
+  writer.join();
+  std::remove(filename.c_str());
+}
+
+TEST(DirectoryWatcherTest, SleepsWhenDirectoryIsMissing) {
+  DirectoryWatcher watcher(TempDirectory() + netsim::filesystem::slash +
+                           "netsim-no-such-directory");
+  EXPECT_FALSE(watcher.IsWatching());
+  EXPECT_FALSE(watcher.Wait(1ms));
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
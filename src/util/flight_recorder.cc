@@ -0,0 +1,270 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/flight_recorder.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace netsim {
+namespace util {
+namespace {
+
+std::mutex recorders_mutex;
+std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<FlightRecorder>>
+    recorders;
+// Recorders of removed chips, oldest first.
+std::deque<std::shared_ptr<FlightRecorder>> retired_recorders;
+// Head of the list of recorders linked by next_recorder_, only pushed.
+std::atomic<FlightRecorder *> first_recorder{nullptr};
+
+uint64_t MakeHeader(bool egress, uint8_t packet_type, size_t size) {
+  auto length = std::min<size_t>(size, UINT32_MAX);
+  return uint64_t{length} << 16 | uint64_t{egress} << 8 | packet_type;
+}
+
+uint32_t HeaderLength(uint64_t header) { return header >> 16; }
+bool HeaderEgress(uint64_t header) { return (header >> 8) & 1; }
+uint8_t HeaderPacketType(uint64_t header) { return header & 0xff; }
+
+// Formats a line of a dump without allocating.
+class DumpLine {
+ public:
+  DumpLine &Append(const char *text) {
+    while (*text && size_ < sizeof(buffer_)) buffer_[size_++] = *text++;
+    return *this;
+  }
+
+  DumpLine &AppendDecimal(uint64_t value) {
+    char digits[20];
+    size_t count = 0;
+    do {
+      digits[count++] = '0' + value % 10;
+      value /= 10;
+    } while (value != 0);
+    while (count > 0 && size_ < sizeof(buffer_)) {
+      buffer_[size_++] = digits[--count];
+    }
+    return *this;
+  }
+
+  DumpLine &AppendHex(const uint8_t *data, size_t size) {
+    static constexpr char kHex[] = "0123456789abcdef";
+    for (size_t i = 0; i < size && size_ + 2 <= sizeof(buffer_); i++) {
+      buffer_[size_++] = kHex[data[i] >> 4];
+      buffer_[size_++] = kHex[data[i] & 0xf];
+    }
+    return *this;
+  }
+
+  void WriteTo(int fd) {
+    Append("\n");
+    size_t written = 0;
+    while (written < size_) {
+#if defined(_WIN32)
+      auto result = _write(fd, buffer_ + written,
+                           static_cast<unsigned int>(size_ - written));
+#else
+      auto result = write(fd, buffer_ + written, size_ - written);
+#endif
+      if (result <= 0) return;
+      written += result;
+    }
+  }
+
+ private:
+  // Fits the longest record line, with the packet as hex.
+  char buffer_[80 + 2 * FlightRecorder::kSnapLength];
+  size_t size_ = 0;
+};
+
+}  // namespace
+
+FlightRecorder::FlightRecorder(uint32_t chip_kind, uint32_t facade_id)
+    : chip_kind_(chip_kind), facade_id_(facade_id) {}
+
+void FlightRecorder::Reset(uint32_t chip_kind, uint32_t facade_id) {
+  next_ticket_.store(0, std::memory_order_relaxed);
+  for (auto &slot : slots_) slot.sequence.store(0, std::memory_order_relaxed);
+  chip_kind_.store(chip_kind, std::memory_order_relaxed);
+  facade_id_.store(facade_id, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+}
+
+void FlightRecorder::Record(bool egress, uint8_t packet_type,
+                            const uint8_t *data, size_t size) {
+  auto ticket = next_ticket_.fetch_add(1, std::memory_order_relaxed);
+  auto &slot = slots_[ticket % kSlots];
+  auto writing = 2 * ticket + 1;
+  auto sequence = slot.sequence.load(std::memory_order_relaxed);
+  // The slot is being written by a writer a ring behind, or a newer
+  // packet is already in it.
+  if ((sequence & 1) != 0 || sequence > writing ||
+      !slot.sequence.compare_exchange_strong(sequence, writing,
+                                             std::memory_order_relaxed)) {
+    return;
+  }
+  std::atomic_thread_fence(std::memory_order_release);
+  auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch());
+  slot.timestamp_us.store(now.count(), std::memory_order_relaxed);
+  slot.header.store(MakeHeader(egress, packet_type, size),
+                    std::memory_order_relaxed);
+  std::array<uint64_t, kWords> words{};
+  auto snap = std::min(size, kSnapLength);
+  std::memcpy(words.data(), data, snap);
+  for (size_t i = 0; i < (snap + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+       i++) {
+    slot.words[i].store(words[i], std::memory_order_relaxed);
+  }
+  slot.sequence.store(writing + 1, std::memory_order_release);
+}
+
+bool FlightRecorder::Read(uint64_t ticket, RawRecord &record) const {
+  const auto &slot = slots_[ticket % kSlots];
+  auto written = 2 * ticket + 2;
+  if (slot.sequence.load(std::memory_order_acquire) != written) return false;
+  record.timestamp_us = slot.timestamp_us.load(std::memory_order_relaxed);
+  record.header = slot.header.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < kWords; i++) {
+    record.words[i] = slot.words[i].load(std::memory_order_relaxed);
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot.sequence.load(std::memory_order_relaxed) == written;
+}
+
+std::pair<uint64_t, uint64_t> FlightRecorder::Tickets() const {
+  auto end = next_ticket_.load(std::memory_order_acquire);
+  return {end > kSlots ? end - kSlots : 0, end};
+}
+
+std::vector<FlightRecord> FlightRecorder::Records() const {
+  std::vector<FlightRecord> records;
+  auto [first, end] = Tickets();
+  records.reserve(end - first);
+  RawRecord raw;
+  for (auto ticket = first; ticket < end; ticket++) {
+    if (!Read(ticket, raw)) continue;
+    auto length = HeaderLength(raw.header);
+    auto bytes = reinterpret_cast<const uint8_t *>(raw.words.data());
+    records.push_back(
+        {raw.timestamp_us, HeaderEgress(raw.header),
+         HeaderPacketType(raw.header), length,
+         std::vector<uint8_t>(
+             bytes, bytes + std::min<size_t>(length, kSnapLength))});
+  }
+  return records;
+}
+
+void FlightRecorder::Dump(int fd) const {
+  DumpLine()
+      .Append("flight recorder chip_kind=")
+      .AppendDecimal(ChipKind())
+      .Append(" facade_id=")
+      .AppendDecimal(FacadeId())
+      .WriteTo(fd);
+  auto [first, end] = Tickets();
+  RawRecord raw;
+  for (auto ticket = first; ticket < end; ticket++) {
+    if (!Read(ticket, raw)) continue;
+    auto length = HeaderLength(raw.header);
+    DumpLine()
+        .Append("  ")
+        .AppendDecimal(raw.timestamp_us)
+        .Append(HeaderEgress(raw.header) ? " egress" : " ingress")
+        .Append(" type=")
+        .AppendDecimal(HeaderPacketType(raw.header))
+        .Append(" length=")
+        .AppendDecimal(length)
+        .Append(" ")
+        .AppendHex(reinterpret_cast<const uint8_t *>(raw.words.data()),
+                   std::min<size_t>(length, kSnapLength))
+        .WriteTo(fd);
+  }
+}
+
+std::shared_ptr<FlightRecorder> GetFlightRecorder(uint32_t chip_kind,
+                                                  uint32_t facade_id) {
+  std::lock_guard<std::mutex> lock(recorders_mutex);
+  auto &recorder = recorders[{chip_kind, facade_id}];
+  if (recorder) return recorder;
+  auto &retired = retired_recorders;
+  // A chip that comes back keeps its records.
+  auto same = std::find_if(retired.begin(), retired.end(), [&](auto &old) {
+    return old->ChipKind() == chip_kind && old->FacadeId() == facade_id;
+  });
+  if (same != retired.end()) {
+    recorder = std::move(*same);
+    retired.erase(same);
+    return recorder;
+  }
+  // Recorders are never freed, the crash handler walks them without a
+  // lock, so one that nothing writes to anymore is reused in place.
+  if (retired.size() >= kRetiredFlightRecorders) {
+    auto unused = std::find_if(retired.begin(), retired.end(),
+                               [](auto &old) { return old.use_count() == 1; });
+    if (unused != retired.end()) {
+      recorder = std::move(*unused);
+      retired.erase(unused);
+      recorder->Reset(chip_kind, facade_id);
+      return recorder;
+    }
+  }
+  recorder = std::make_shared<FlightRecorder>(chip_kind, facade_id);
+  recorder->next_recorder_ = first_recorder.load(std::memory_order_relaxed);
+  first_recorder.store(recorder.get(), std::memory_order_release);
+  return recorder;
+}
+
+void ReleaseFlightRecorder(uint32_t chip_kind, uint32_t facade_id) {
+  std::lock_guard<std::mutex> lock(recorders_mutex);
+  auto it = recorders.find({chip_kind, facade_id});
+  if (it == recorders.end()) return;
+  retired_recorders.push_back(std::move(it->second));
+  recorders.erase(it);
+}
+
+std::vector<std::shared_ptr<FlightRecorder>> GetFlightRecorders() {
+  std::lock_guard<std::mutex> lock(recorders_mutex);
+  std::vector<std::shared_ptr<FlightRecorder>> result;
+  result.reserve(recorders.size() + retired_recorders.size());
+  for (const auto &[key, recorder] : recorders) result.push_back(recorder);
+  for (const auto &recorder : retired_recorders) result.push_back(recorder);
+  return result;
+}
+
+void DumpFlightRecorders(int fd) {
+  for (auto recorder = first_recorder.load(std::memory_order_acquire);
+       recorder != nullptr; recorder = recorder->next_recorder_) {
+    recorder->Dump(fd);
+  }
+}
+
+}  // namespace util
+}  // namespace netsim
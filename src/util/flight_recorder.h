@@ -0,0 +1,143 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Always-on record of the last packets of every chip.
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace netsim {
+namespace util {
+
+struct FlightRecord {
+  // Microseconds since the epoch.
+  uint64_t timestamp_us;
+  // Sent to the chip rather than received from it.
+  bool egress;
+  // HCI packet type, 0 for WiFi frames.
+  uint8_t packet_type;
+  // Length of the packet, of which bytes holds at most kSnapLength.
+  uint32_t length;
+  std::vector<uint8_t> bytes;
+};
+
+/**
+ * @brief Ring of the last kSlots packets of a chip.
+ *
+ * Only the first kSnapLength bytes of a packet are kept, enough for the
+ * HCI and 802.11 headers, so recording is cheap enough to leave on for
+ * every chip.
+ *
+ * Record is lock free and may be called from several threads. A writer
+ * claims a slot with a ticket and publishes it with a sequence number;
+ * readers skip a slot that is being written instead of waiting for it, and
+ * a writer drops its packet if the slot is still being written by a writer
+ * a whole ring behind.
+ */
+class FlightRecorder {
+ public:
+  static constexpr size_t kSlots = 256;
+  static constexpr size_t kSnapLength = 64;
+
+  // chip_kind is a common::ChipKind.
+  FlightRecorder(uint32_t chip_kind, uint32_t facade_id);
+
+  void Record(bool egress, uint8_t packet_type, const uint8_t *data,
+              size_t size);
+
+  // Returns the recorded packets, oldest first.
+  std::vector<FlightRecord> Records() const;
+
+  // Writes the recorded packets as text to fd. Async signal safe, for the
+  // crash handler: it neither allocates nor locks.
+  void Dump(int fd) const;
+
+  uint32_t ChipKind() const {
+    return chip_kind_.load(std::memory_order_relaxed);
+  }
+  uint32_t FacadeId() const {
+    return facade_id_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static constexpr size_t kWords = kSnapLength / sizeof(uint64_t);
+
+  // The fields are atomics so that readers racing a writer are well
+  // defined; the sequence tells them whether what they read is whole.
+  struct Slot {
+    // 2 * ticket + 1 while written, then 2 * ticket + 2.
+    std::atomic<uint64_t> sequence{0};
+    std::atomic<uint64_t> timestamp_us{0};
+    // length << 16 | egress << 8 | packet_type
+    std::atomic<uint64_t> header{0};
+    std::array<std::atomic<uint64_t>, kWords> words{};
+  };
+
+  struct RawRecord {
+    uint64_t timestamp_us;
+    uint64_t header;
+    std::array<uint64_t, kWords> words;
+  };
+
+  // Copies the packet of a ticket, returns false if its slot was
+  // overwritten or is being written.
+  bool Read(uint64_t ticket, RawRecord &record) const;
+  // Returns the first and past the last tickets still in the ring.
+  std::pair<uint64_t, uint64_t> Tickets() const;
+  // Empties the recorder for another chip. Only called when nothing else
+  // holds it; the crash handler may still read it, and skips the slots
+  // whose sequence changes under it.
+  void Reset(uint32_t chip_kind, uint32_t facade_id);
+
+  // Atomic because a recorder is reused in place for another chip.
+  std::atomic<uint32_t> chip_kind_;
+  std::atomic<uint32_t> facade_id_;
+  std::atomic<uint64_t> next_ticket_{0};
+  std::array<Slot, kSlots> slots_;
+
+  // Links every recorder for the crash handler, which cannot take the
+  // lock of the registry.
+  FlightRecorder *next_recorder_ = nullptr;
+  friend std::shared_ptr<FlightRecorder> GetFlightRecorder(uint32_t, uint32_t);
+  friend void DumpFlightRecorders(int);
+};
+
+// Recorders of removed chips kept for the dumps. Past this, the recorder of
+// the oldest removed chip is reused for the next new chip.
+constexpr size_t kRetiredFlightRecorders = 16;
+
+// Returns the recorder of a chip, created on first use.
+std::shared_ptr<FlightRecorder> GetFlightRecorder(uint32_t chip_kind,
+                                                  uint32_t facade_id);
+
+// Called when a chip is removed. Its recorder stays in the dumps until it
+// is reused.
+void ReleaseFlightRecorder(uint32_t chip_kind, uint32_t facade_id);
+
+std::vector<std::shared_ptr<FlightRecorder>> GetFlightRecorders();
+
+// Writes every recorder to fd. Async signal safe.
+void DumpFlightRecorders(int fd);
+
+}  // namespace util
+}  // namespace netsim
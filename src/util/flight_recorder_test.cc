@@ -0,0 +1,168 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/flight_recorder.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using util::FlightRecorder;
+
+TEST(FlightRecorderTest, RecordsOldestFirst) {
+  FlightRecorder recorder(1, 7);
+  const uint8_t command[] = {0x03, 0x0c, 0x00};
+  const uint8_t event[] = {0x0e, 0x04, 0x01, 0x03, 0x0c, 0x00};
+  recorder.Record(false, 1, command, sizeof(command));
+  recorder.Record(true, 4, event, sizeof(event));
+
+  auto records = recorder.Records();
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_FALSE(records[0].egress);
+  EXPECT_EQ(records[0].packet_type, 1);
+  EXPECT_EQ(records[0].length, sizeof(command));
+  EXPECT_EQ(records[0].bytes, std::vector<uint8_t>({0x03, 0x0c, 0x00}));
+  EXPECT_TRUE(records[1].egress);
+  EXPECT_EQ(records[1].packet_type, 4);
+  EXPECT_EQ(records[1].bytes.size(), sizeof(event));
+  EXPECT_LE(records[0].timestamp_us, records[1].timestamp_us);
+}
+
+TEST(FlightRecorderTest, TruncatesLongPackets) {
+  FlightRecorder recorder(2, 2000);
+  std::vector<uint8_t> frame(1500);
+  for (size_t i = 0; i < frame.size(); i++) frame[i] = i;
+  recorder.Record(true, 0, frame.data(), frame.size());
+
+  auto records = recorder.Records();
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].length, 1500);
+  EXPECT_EQ(records[0].bytes,
+            std::vector<uint8_t>(frame.begin(),
+                                 frame.begin() + FlightRecorder::kSnapLength));
+}
+
+TEST(FlightRecorderTest, KeepsTheLastPackets) {
+  FlightRecorder recorder(1, 8);
+  for (uint32_t i = 0; i < FlightRecorder::kSlots + 10; i++) {
+    uint8_t byte = i;
+    recorder.Record(false, 2, &byte, 1);
+  }
+  auto records = recorder.Records();
+  ASSERT_EQ(records.size(), FlightRecorder::kSlots);
+  EXPECT_EQ(records.front().bytes[0], 10);
+  EXPECT_EQ(records.back().bytes[0],
+            static_cast<uint8_t>(FlightRecorder::kSlots + 9));
+}
+
+TEST(FlightRecorderTest, RecordFromManyThreads) {
+  FlightRecorder recorder(1, 9);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&recorder, t] {
+      std::vector<uint8_t> packet(FlightRecorder::kSnapLength, t);
+      for (int i = 0; i < 10000; i++) {
+        recorder.Record(t % 2, t, packet.data(), packet.size());
+      }
+    });
+  }
+  // Reading while the writers run only returns whole packets.
+  for (int i = 0; i < 100; i++) {
+    for (const auto &record : recorder.Records()) {
+      ASSERT_EQ(record.bytes,
+                std::vector<uint8_t>(record.bytes.size(), record.packet_type));
+    }
+  }
+  for (auto &thread : threads) thread.join();
+  EXPECT_LE(recorder.Records().size(), FlightRecorder::kSlots);
+}
+
+TEST(FlightRecorderTest, GetFlightRecorderIsPerChip) {
+  auto recorder = util::GetFlightRecorder(1, 100);
+  EXPECT_EQ(recorder, util::GetFlightRecorder(1, 100));
+  EXPECT_NE(recorder, util::GetFlightRecorder(2, 100));
+  EXPECT_EQ(recorder->ChipKind(), 1);
+  EXPECT_EQ(recorder->FacadeId(), 100);
+}
+
+TEST(FlightRecorderTest, ReturningChipKeepsItsRecords) {
+  const uint8_t command[] = {0x03, 0x0c, 0x00};
+  auto recorder = util::GetFlightRecorder(1, 102);
+  recorder->Record(false, 1, command, sizeof(command));
+  auto *raw = recorder.get();
+  recorder.reset();
+  util::ReleaseFlightRecorder(1, 102);
+
+  recorder = util::GetFlightRecorder(1, 102);
+  EXPECT_EQ(recorder.get(), raw);
+  EXPECT_EQ(recorder->Records().size(), 1);
+  util::ReleaseFlightRecorder(1, 102);
+}
+
+TEST(FlightRecorderTest, ReusesTheOldestRemovedRecorder) {
+  const uint8_t command[] = {0x03, 0x0c, 0x00};
+  std::vector<FlightRecorder *> removed;
+  for (uint32_t id = 200; id < 200 + util::kRetiredFlightRecorders; id++) {
+    auto recorder = util::GetFlightRecorder(2, id);
+    recorder->Record(false, 0, command, sizeof(command));
+    removed.push_back(recorder.get());
+    recorder.reset();
+    util::ReleaseFlightRecorder(2, id);
+  }
+
+  // The pool is full, the next chip reuses a recorder nothing holds.
+  auto recorder = util::GetFlightRecorder(2, 300);
+  EXPECT_NE(std::find(removed.begin(), removed.end(), recorder.get()),
+            removed.end());
+  EXPECT_EQ(recorder->ChipKind(), 2);
+  EXPECT_EQ(recorder->FacadeId(), 300);
+  EXPECT_TRUE(recorder->Records().empty());
+
+  // A recorder still held is not reused.
+  util::ReleaseFlightRecorder(2, 300);
+  auto next = util::GetFlightRecorder(2, 301);
+  EXPECT_NE(next, recorder);
+}
+
+TEST(FlightRecorderTest, DumpWritesEveryRecorder) {
+  const uint8_t command[] = {0x03, 0x0c, 0x00};
+  util::GetFlightRecorder(1, 101)->Record(false, 1, command, sizeof(command));
+
+  FILE *file = std::tmpfile();
+  ASSERT_NE(file, nullptr);
+  util::DumpFlightRecorders(fileno(file));
+  std::rewind(file);
+  std::string dump;
+  char buffer[256];
+  while (auto size = std::fread(buffer, 1, sizeof(buffer), file)) {
+    dump.append(buffer, size);
+  }
+  std::fclose(file);
+  EXPECT_NE(dump.find("flight recorder chip_kind=1 facade_id=101\n"),
+            std::string::npos);
+  EXPECT_NE(dump.find(" ingress type=1 length=3 030c00\n"), std::string::npos);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
@@ -14,15 +14,104 @@
 
 #include "util/ini_file.h"
 
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <string>
 #include <string_view>
 
 #include "util/log.h"
+#include "util/mapped_file.h"
 #include "util/string_utils.h"
 
 namespace netsim {
+namespace {
+
+// Calls on_entry(key, value) for every `key=value` line of contents, with
+// the views trimmed and pointing into contents. Lines without exactly one
+// '=' are skipped.
+template <class OnEntry>
+void ForEachEntry(std::string_view contents, OnEntry on_entry) {
+  while (!contents.empty()) {
+    auto end = contents.find('\n');
+    auto line = contents.substr(0, end);
+    contents.remove_prefix(end == std::string_view::npos ? contents.size()
+                                                         : end + 1);
+    auto equals = line.find('=');
+    if (equals == std::string_view::npos ||
+        line.find('=', equals + 1) != std::string_view::npos)
+      continue;
+    if (!on_entry(stringutils::Trim(line.substr(0, equals)),
+                  stringutils::Trim(line.substr(equals + 1))))
+      return;
+  }
+}
+
+// Only compared for equality. On Windows `inode` is the file index and
+// `mtime` counts 100 ns ticks; elsewhere `mtime` is in nanoseconds.
+struct FileVersion {
+  uint64_t inode;
+  uint64_t size;
+  int64_t mtime;
+  bool operator==(const FileVersion &other) const {
+    return inode == other.inode && size == other.size &&
+           mtime == other.mtime;
+  }
+};
+
+std::optional<FileVersion> StatFile(const std::string &filepath) {
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(
+      filepath.c_str(), FILE_READ_ATTRIBUTES,
+      FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+      OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file == INVALID_HANDLE_VALUE) return std::nullopt;
+  BY_HANDLE_FILE_INFORMATION info;
+  bool ok = GetFileInformationByHandle(file, &info);
+  CloseHandle(file);
+  if (!ok) return std::nullopt;
+  auto high_low = [](DWORD high, DWORD low) {
+    return (static_cast<uint64_t>(high) << 32) | low;
+  };
+  return FileVersion{
+      high_low(info.nFileIndexHigh, info.nFileIndexLow),
+      high_low(info.nFileSizeHigh, info.nFileSizeLow),
+      static_cast<int64_t>(high_low(info.ftLastWriteTime.dwHighDateTime,
+                                    info.ftLastWriteTime.dwLowDateTime))};
+#else
+  struct stat stat_buffer;
+  if (stat(filepath.c_str(), &stat_buffer) != 0) return std::nullopt;
+#if defined(__APPLE__)
+  auto mtime = stat_buffer.st_mtimespec;
+#else
+  auto mtime = stat_buffer.st_mtim;
+#endif
+  return FileVersion{static_cast<uint64_t>(stat_buffer.st_ino),
+                     static_cast<uint64_t>(stat_buffer.st_size),
+                     static_cast<int64_t>(mtime.tv_sec) * 1000000000 +
+                         mtime.tv_nsec};
+#endif
+}
+
+struct CachedFile {
+  FileVersion version;
+  std::string contents;
+};
+
+std::mutex cached_files_mutex;
+std::map<std::string, CachedFile> cached_files;
+
+}  // namespace
 
 bool IniFile::Read() {
   data.clear();
@@ -32,21 +121,15 @@ bool IniFile::Read() {
     return false;
   }
 
-  std::ifstream inFile(filepath);
-
-  if (!inFile) {
+  auto file = util::MappedFile::Open(filepath);
+  if (!file) {
     BtsLogWarn("Failed to process .ini file %s for reading.", filepath.c_str());
     return false;
   }
-  std::string line;
-  while (std::getline(inFile, line)) {
-    auto argv = stringutils::Split(line, "=");
-
-    if (argv.size() != 2) continue;
-    auto key = stringutils::Trim(argv[0]);
-    auto val = stringutils::Trim(argv[1]);
-    data.emplace(key, val);
-  }
+  ForEachEntry(file->Contents(), [this](auto key, auto value) {
+    data.emplace(key, value);
+    return true;
+  });
   return true;
 }
 
@@ -83,4 +166,40 @@ void IniFile::Set(const std::string &key, std::string_view value) {
   data[key] = std::string(value);
 }
 
+std::optional<std::string_view> IniFile::Find(std::string_view contents,
+                                              std::string_view key) {
+  std::optional<std::string_view> result;
+  ForEachEntry(contents, [&](auto entry_key, auto value) {
+    if (entry_key != key) return true;
+    result = value;
+    return false;
+  });
+  return result;
+}
+
+std::optional<std::string> IniFileCache::Get(const std::string &filepath,
+                                             std::string_view key) {
+  auto version = StatFile(filepath);
+  std::lock_guard<std::mutex> lock(cached_files_mutex);
+  if (!version) {
+    cached_files.erase(filepath);
+    return std::nullopt;
+  }
+  auto it = cached_files.find(filepath);
+  if (it == cached_files.end() || !(it->second.version == *version)) {
+    auto file = util::MappedFile::Open(filepath);
+    if (!file) return std::nullopt;
+    // Copied out of the mapping so a later rewrite of the file can not
+    // change it under the cache.
+    it = cached_files
+             .insert_or_assign(filepath,
+                               CachedFile{*version,
+                                          std::string(file->Contents())})
+             .first;
+  }
+  auto value = IniFile::Find(it->second.contents, key);
+  if (!value) return std::nullopt;
+  return std::string(*value);
+}
+
 }  // namespace netsim
@@ -47,9 +47,28 @@ class IniFile {
   // Sets value.
   void Set(const std::string &key, std::string_view value);
 
+  // Returns the value of key in the ini contents without copying them; the
+  // view points into contents.
+  static std::optional<std::string_view> Find(std::string_view contents,
+                                              std::string_view key);
+
  private:
   std::unordered_map<std::string, std::string> data;
   std::string filepath;
 };
 
+/**
+ * @class IniFileCache
+ *
+ * Looks up keys of ini files that are read many times but rarely change,
+ * like the discovery file of netsimd. A file is only read again when its
+ * inode, size or modification time changed since the last lookup.
+ */
+class IniFileCache {
+ public:
+  // Returns nullopt when the file or the key does not exist.
+  static std::optional<std::string> Get(const std::string &filepath,
+                                        std::string_view key);
+};
+
 }  // namespace netsim
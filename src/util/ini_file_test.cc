@@ -18,6 +18,7 @@
 #include <cstdio>
 #include <fstream>
 #include <string>
+#include <string_view>
 
 #include "gtest/gtest.h"
 
@@ -108,6 +109,33 @@ TEST(IniFileTest, WriteTest) {
   ASSERT_EQ(std::remove(tempFileName), 0);
 }
 
+TEST(IniFileTest, FindTest) {
+  std::string_view contents = "grpc.port = 123\nbad=line=\n\nweb.port=456";
+  EXPECT_EQ(IniFile::Find(contents, "grpc.port"), "123");
+  EXPECT_EQ(IniFile::Find(contents, "web.port"), "456");
+  EXPECT_FALSE(IniFile::Find(contents, "bad").has_value());
+  EXPECT_FALSE(IniFile::Find(contents, "port").has_value());
+  EXPECT_FALSE(IniFile::Find("", "port").has_value());
+}
+
+TEST(IniFileCacheTest, ReloadsChangedFile) {
+  std::string tempFileName = tmpnam(NULL);
+  EXPECT_FALSE(IniFileCache::Get(tempFileName, "port").has_value());
+
+  std::ofstream(tempFileName) << "port=123\n";
+  EXPECT_EQ(IniFileCache::Get(tempFileName, "port"), "123");
+  EXPECT_EQ(IniFileCache::Get(tempFileName, "port"), "123");
+
+  // Replaced the way netsimd writes it, with the same size.
+  std::string replacement = tempFileName + ".tmp";
+  std::ofstream(replacement) << "port=234\n";
+  ASSERT_EQ(std::rename(replacement.c_str(), tempFileName.c_str()), 0);
+  EXPECT_EQ(IniFileCache::Get(tempFileName, "port"), "234");
+
+  ASSERT_EQ(std::remove(tempFileName.c_str()), 0);
+  EXPECT_FALSE(IniFileCache::Get(tempFileName, "port").has_value());
+}
+
 }  // namespace
 }  // namespace testing
 }  // namespace netsim
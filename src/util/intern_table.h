@@ -0,0 +1,114 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+namespace netsim {
+namespace util {
+
+/**
+ * @brief A store of immutable values interned by the bytes they are built
+ * from.
+ *
+ * @tparam V Type of the value
+ *
+ * `Intern` returns the value already stored for the same key bytes, and
+ * otherwise builds it once with the given function. Entries are found by
+ * the hash of the key and compared byte for byte. The table only holds weak
+ * references, so a value is released with its last user and its entry is
+ * swept on a later insertion.
+ *
+ * Thread safe. The build function runs without the table lock held.
+ */
+template <class V>
+class InternTable {
+ public:
+  InternTable() = default;
+  InternTable(const InternTable &) = delete;
+  InternTable &operator=(const InternTable &) = delete;
+
+  /**
+   * @brief Returns the value interned for key, calling make() to build a
+   * std::shared_ptr<V> if there is none.
+   */
+  template <class F>
+  std::shared_ptr<const V> Intern(std::string_view key, F &&make) {
+    auto hash = std::hash<std::string_view>()(key);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (auto value = FindLocked(hash, key)) return value;
+    }
+    std::shared_ptr<const V> value = make();
+    std::lock_guard<std::mutex> lock(mutex_);
+    // Another thread may have built the same value meanwhile; keep the first.
+    if (auto existing = FindLocked(hash, key)) return existing;
+    if (entries_.size() >= sweep_threshold_) SweepLocked();
+    entries_.emplace(hash, Entry{std::string(key), value});
+    return value;
+  }
+
+  /**
+   * @brief Returns the number of values still in use.
+   */
+  size_t Size() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SweepLocked();
+    return entries_.size();
+  }
+
+ private:
+  struct Entry {
+    std::string key;
+    std::weak_ptr<const V> value;
+  };
+
+  std::shared_ptr<const V> FindLocked(size_t hash, std::string_view key) {
+    auto [begin, end] = entries_.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+      if (it->second.key != key) continue;
+      if (auto value = it->second.value.lock()) return value;
+    }
+    return nullptr;
+  }
+
+  // Drops released values; the next sweep happens when the table doubles.
+  void SweepLocked() {
+    for (auto it = entries_.begin(); it != entries_.end();) {
+      it = it->second.value.expired() ? entries_.erase(it) : std::next(it);
+    }
+    sweep_threshold_ =
+        std::max<size_t>(kMinSweepThreshold, 2 * entries_.size());
+  }
+
+  static constexpr size_t kMinSweepThreshold = 16;
+
+  std::mutex mutex_;
+  std::unordered_multimap<size_t, Entry> entries_;
+  size_t sweep_threshold_ = kMinSweepThreshold;
+};
+
+}  // namespace util
+}  // namespace netsim
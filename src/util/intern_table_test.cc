@@ -0,0 +1,77 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for InternTable class.
+#include "util/intern_table.h"
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using util::InternTable;
+
+TEST(InternTableTest, SameKeySharesValue) {
+  InternTable<std::string> table;
+  int built = 0;
+  auto make = [&built] {
+    built++;
+    return std::make_shared<std::string>("value");
+  };
+  auto a = table.Intern("key", make);
+  auto b = table.Intern(std::string("key"), make);
+  auto c = table.Intern("other", make);
+  EXPECT_EQ(a.get(), b.get());
+  EXPECT_NE(a.get(), c.get());
+  EXPECT_EQ(built, 2);
+  EXPECT_EQ(table.Size(), 2u);
+}
+
+TEST(InternTableTest, ReleasedValuesAreRebuilt) {
+  InternTable<int> table;
+  auto value = table.Intern("key", [] { return std::make_shared<int>(1); });
+  value.reset();
+  EXPECT_EQ(table.Size(), 0u);
+  value = table.Intern("key", [] { return std::make_shared<int>(2); });
+  EXPECT_EQ(*value, 2);
+  // Keys with embedded zero bytes are compared in full.
+  auto zero = table.Intern(std::string("key\0a", 5),
+                           [] { return std::make_shared<int>(3); });
+  EXPECT_EQ(*zero, 3);
+}
+
+TEST(InternTableTest, ConcurrentIntern) {
+  constexpr int kThreads = 8;
+  InternTable<int> table;
+  std::vector<std::shared_ptr<const int>> values(kThreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; t++) {
+    threads.emplace_back([&table, &values, t] {
+      values[t] = table.Intern("key", [t] { return std::make_shared<int>(t); });
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  for (const auto &value : values) EXPECT_EQ(value.get(), values[0].get());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
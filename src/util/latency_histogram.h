@@ -0,0 +1,128 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace netsim {
+namespace util {
+
+// Packet latencies are only measured after latency stats are enabled.
+inline std::atomic<bool> latency_stats_enabled{false};
+
+inline void SetLatencyStatsEnabled(bool enabled) {
+  latency_stats_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+inline bool LatencyStatsEnabled() {
+  return latency_stats_enabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief A lock-free histogram of latencies in microseconds.
+ *
+ * Buckets are log-linear as in HDR histograms: every power of two is split
+ * in kSubBuckets linear buckets, so a percentile is within 1/kSubBuckets of
+ * the recorded value from 1 us up to about 71 minutes. Longer latencies are
+ * counted in the last bucket.
+ *
+ * Record may be called from any thread; readers see a consistent count per
+ * bucket but not an atomic snapshot of the whole histogram.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr int kSubBucketBits = 4;
+  static constexpr uint64_t kSubBuckets = 1 << kSubBucketBits;
+  static constexpr int kMaxValueBits = 32;
+  static constexpr size_t kBucketCount =
+      (kMaxValueBits - kSubBucketBits + 1) * kSubBuckets;
+
+  LatencyHistogram() = default;
+  LatencyHistogram(const LatencyHistogram &) = delete;
+  LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+  void Record(std::chrono::nanoseconds latency) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(latency)
+                      .count();
+    uint64_t value = micros > 0 ? static_cast<uint64_t>(micros) : 0;
+    buckets_[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    uint64_t max = max_.load(std::memory_order_relaxed);
+    while (value > max &&
+           !max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+  }
+
+  uint64_t Count() const { return count_.load(std::memory_order_relaxed); }
+
+  uint64_t MaxMicros() const { return max_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Returns the highest value of the bucket holding the quantile.
+   *
+   * @param quantile - between 0 and 1, e.g. 0.99 for p99
+   */
+  uint64_t PercentileMicros(double quantile) const {
+    uint64_t count = Count();
+    if (count == 0) return 0;
+    auto rank = static_cast<uint64_t>(
+        std::ceil(std::clamp(quantile, 0.0, 1.0) * count));
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kBucketCount; i++) {
+      seen += buckets_[i].load(std::memory_order_relaxed);
+      if (seen >= rank) return std::min(BucketMaxValue(i), MaxMicros());
+    }
+    return MaxMicros();
+  }
+
+  void Reset() {
+    for (auto &bucket : buckets_) bucket.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+  }
+
+  static size_t BucketIndex(uint64_t value) {
+    value = std::min<uint64_t>(value, (uint64_t{1} << kMaxValueBits) - 1);
+    if (value < kSubBuckets) return value;
+    int shift = 0;
+    while ((value >> shift) >= 2 * kSubBuckets) shift++;
+    // The sub-bucket drops the leading one bit.
+    uint64_t sub_bucket = (value >> shift) - kSubBuckets;
+    return (shift + 1) * kSubBuckets + sub_bucket;
+  }
+
+  static uint64_t BucketMaxValue(size_t index) {
+    if (index < kSubBuckets) return index;
+    int shift = index / kSubBuckets - 1;
+    uint64_t sub_bucket = index % kSubBuckets;
+    return ((kSubBuckets + sub_bucket + 1) << shift) - 1;
+  }
+
+ private:
+  std::array<std::atomic<uint64_t>, kBucketCount> buckets_{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> max_{0};
+};
+
+}  // namespace util
+}  // namespace netsim
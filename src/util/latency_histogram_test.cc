@@ -0,0 +1,89 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for LatencyHistogram class.
+#include "util/latency_histogram.h"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using std::chrono::microseconds;
+using util::LatencyHistogram;
+
+TEST(LatencyHistogramTest, EmptyHistogram) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.Count(), 0);
+  EXPECT_EQ(histogram.PercentileMicros(0.5), 0);
+  EXPECT_EQ(histogram.MaxMicros(), 0);
+}
+
+TEST(LatencyHistogramTest, BucketsCoverEveryValue) {
+  for (uint64_t value = 0; value < 1 << 20; value++) {
+    auto index = LatencyHistogram::BucketIndex(value);
+    ASSERT_LT(index, LatencyHistogram::kBucketCount);
+    ASSERT_LE(value, LatencyHistogram::BucketMaxValue(index));
+    if (index > 0) {
+      ASSERT_GT(value, LatencyHistogram::BucketMaxValue(index - 1));
+    }
+  }
+  EXPECT_EQ(LatencyHistogram::BucketIndex(UINT64_MAX),
+            LatencyHistogram::kBucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, PercentilesAreWithinPrecision) {
+  LatencyHistogram histogram;
+  for (int i = 1; i <= 1000; i++) histogram.Record(microseconds(i));
+  EXPECT_EQ(histogram.Count(), 1000);
+  EXPECT_EQ(histogram.MaxMicros(), 1000);
+  auto p50 = histogram.PercentileMicros(0.5);
+  EXPECT_GE(p50, 500);
+  EXPECT_LE(p50, 500 + 500 / LatencyHistogram::kSubBuckets);
+  auto p99 = histogram.PercentileMicros(0.99);
+  EXPECT_GE(p99, 990);
+  EXPECT_LE(p99, 1000);
+  EXPECT_EQ(histogram.PercentileMicros(1.0), 1000);
+}
+
+TEST(LatencyHistogramTest, ResetClearsCounts) {
+  LatencyHistogram histogram;
+  histogram.Record(microseconds(42));
+  histogram.Reset();
+  EXPECT_EQ(histogram.Count(), 0);
+  EXPECT_EQ(histogram.MaxMicros(), 0);
+}
+
+TEST(LatencyHistogramTest, RecordFromManyThreads) {
+  LatencyHistogram histogram;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&histogram, t] {
+      for (int i = 0; i < 1000; i++) histogram.Record(microseconds(t * 10));
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  EXPECT_EQ(histogram.Count(), 4000);
+  EXPECT_EQ(histogram.MaxMicros(), 30);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
@@ -13,70 +13,190 @@
 // limitations under the License.
 #include "log.h"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdarg>
+#include <cstdint>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
-#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include "util/mpsc_ring_queue.h"
 
 namespace netsim {
+namespace {
+
+// A log line as handed from the logging threads to the writer thread. Fixed
+// size, so that logging does not allocate.
+struct LogRecord {
+  int priority;
+  const char *file;
+  int line;
+  std::chrono::system_clock::time_point time;
+  char message[255];
+};
 
-void BtsLogDefault(int priority, const char *file, int lineNumber,
-                   const char *buffer) {
-  auto now = std::chrono::system_clock::now();
-  auto now_ms = std::chrono::time_point_cast<std::chrono::milliseconds>(now);
-  auto now_t = std::chrono::system_clock::to_time_t(now);
+// Records waiting for the writer thread. When it is full, new records are
+// dropped and counted instead of blocking the caller.
+constexpr size_t kLogQueueSize = 1024;
+// How long FlushBtsLog waits for the writer thread.
+constexpr std::chrono::seconds kFlushTimeout{1};
+
+void WriteDefault(const LogRecord &record) {
+  auto now_ms =
+      std::chrono::time_point_cast<std::chrono::milliseconds>(record.time);
+  auto now_t = std::chrono::system_clock::to_time_t(record.time);
+  std::tm tm;
+#ifdef _WIN32
+  gmtime_s(&tm, &now_t);
+#else
+  gmtime_r(&now_t, &tm);
+#endif
   //"mm-dd_HH:MM:SS.sss\0" is 19 byte long
   char prefix[19];
-  auto l = std::strftime(prefix, sizeof(prefix), "%m-%d %H:%M:%S",
-                         std::gmtime(&now_t));
+  auto l = std::strftime(prefix, sizeof(prefix), "%m-%d %H:%M:%S", &tm);
   snprintf(prefix + l, sizeof(prefix) - l, ".%03u",
            static_cast<unsigned int>(now_ms.time_since_epoch().count() % 1000));
 
   // Obtain the file name from given filepath
-  std::string file_path(file);
-  const char *separators = "/";
 #ifdef _WIN32
-  separators = "\\";
+  const char *last_separator = strrchr(record.file, '\\');
+#else
+  const char *last_separator = strrchr(record.file, '/');
 #endif
-  size_t last_slash_pos = file_path.find_last_of(separators);
-  if (last_slash_pos != std::string::npos) {
-    file_path = file_path.substr(last_slash_pos + 1);
-  }
+  const char *file_name = last_separator ? last_separator + 1 : record.file;
 
   // Obtain the log level based on given priority
-  std::string level;
-  switch (priority) {
+  char level;
+  switch (record.priority) {
     case 0:
-      level = "E";
+      level = 'E';
       break;
     case 1:
-      level = "W";
+      level = 'W';
       break;
     case 2:
-      level = "I";
+      level = 'I';
       break;
     default:
-      level = "D";
+      level = 'D';
+  }
+
+  fprintf(stderr, "netsimd %c %s %s:%d - %s\n", level, prefix, file_name,
+          record.line, record.message);
+}
+
+// Moves log records from the calling threads to a writer thread, which
+// does the formatting and the I/O.
+class AsyncLogger {
+ public:
+  AsyncLogger() : queue_(kLogQueueSize) {
+    std::thread(&AsyncLogger::Run, this).detach();
+    std::atexit([] { FlushBtsLog(); });
+  }
+
+  void Push(const LogRecord &record) {
+    if (queue_.Push(record)) {
+      pushed_.fetch_add(1, std::memory_order_release);
+    } else {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void SetSink(BtsLogFn sink) {
+    std::lock_guard<std::mutex> lock(sink_mutex_);
+    sink_ = std::move(sink);
   }
 
-  fprintf(stderr, "netsimd %s %s %s:%d - %s\n", level.c_str(), prefix,
-          file_path.c_str(), lineNumber, buffer);
-  fflush(stderr);
+  void Flush() {
+    auto target = pushed_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(flush_mutex_);
+    flushed_.wait_for(lock, kFlushTimeout, [this, target] {
+      return written_.load(std::memory_order_acquire) >= target;
+    });
+  }
+
+ private:
+  void Run() {
+    LogRecord record;
+    while (queue_.WaitAndPop(record)) {
+      // Write everything that is queued, then flush stderr once.
+      uint64_t count = 0;
+      do {
+        Write(record);
+        count++;
+      } while (queue_.TryPop(record));
+      if (auto dropped = dropped_.exchange(0, std::memory_order_relaxed)) {
+        LogRecord summary{1, __FILE__, __LINE__, record.time, {}};
+        snprintf(summary.message, sizeof(summary.message),
+                 "Dropped %llu log messages",
+                 static_cast<unsigned long long>(dropped));
+        Write(summary);
+      }
+      fflush(stderr);
+      {
+        std::lock_guard<std::mutex> lock(flush_mutex_);
+        written_.fetch_add(count, std::memory_order_release);
+      }
+      flushed_.notify_all();
+    }
+  }
+
+  void Write(const LogRecord &record) {
+    std::lock_guard<std::mutex> lock(sink_mutex_);
+    if (sink_) {
+      sink_(record.priority, record.file, record.line, record.message);
+    } else {
+      WriteDefault(record);
+    }
+  }
+
+  util::MpscRingQueue<LogRecord> queue_;
+  std::atomic<uint64_t> pushed_{0};
+  std::atomic<uint64_t> written_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::mutex sink_mutex_;
+  BtsLogFn sink_;
+  std::mutex flush_mutex_;
+  std::condition_variable flushed_;
+};
+
+// Never destroyed: the writer thread and the exit handler may still use it
+// while static objects are torn down.
+AsyncLogger &Logger() {
+  static AsyncLogger *logger = new AsyncLogger();
+  return *logger;
 }
 
-static BtsLogFn logFunction = BtsLogDefault;
+}  // namespace
+
+std::atomic<int> bts_log_priority{3};
+
+void setBtsLogPriority(int priority) {
+  bts_log_priority.store(priority, std::memory_order_relaxed);
+}
 
 void __BtsLog(int priority, const char *file, int line, const char *fmt, ...) {
-  char buffer[255];
-  va_list arglist;
+  LogRecord record;
+  record.priority = priority;
+  record.file = file;
+  record.line = line;
+  record.time = std::chrono::system_clock::now();
 
+  va_list arglist;
   va_start(arglist, fmt);
-  vsnprintf(buffer, sizeof(buffer), fmt, arglist);
+  vsnprintf(record.message, sizeof(record.message), fmt, arglist);
   va_end(arglist);
 
-  logFunction(priority, file, line, buffer);
+  Logger().Push(record);
 }
 
-void setBtsLogSink(BtsLogFn logFn) { logFunction = logFn; }
+void setBtsLogSink(BtsLogFn logFn) { Logger().SetSink(std::move(logFn)); }
+
+void FlushBtsLog() { Logger().Flush(); }
+
 }  // namespace netsim
@@ -15,21 +15,109 @@
  */
 
 #pragma once
+#include <atomic>
+#include <chrono>
 #include <cstdarg>
+#include <cstdint>
 #include <functional>
 #include <string>
 namespace netsim {
 
-#define BtsLog(fmt, ...) __BtsLog(3, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define BtsLogInfo(fmt, ...) __BtsLog(2, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define BtsLogWarn(fmt, ...) __BtsLog(1, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
-#define BtsLogError(fmt, ...) \
-  __BtsLog(0, __FILE__, __LINE__, fmt, ##__VA_ARGS__)
+// Priorities above this value are compiled out. 0 error, 1 warning, 2 info,
+// 3 debug.
+#ifndef NETSIM_MAX_LOG_PRIORITY
+#define NETSIM_MAX_LOG_PRIORITY 3
+#endif
+
+// The arguments are only evaluated and formatted when the priority is
+// enabled at compile time and at run time.
+#define NETSIM_LOG(priority, fmt, ...)                             \
+  do {                                                             \
+    if ((priority) <= NETSIM_MAX_LOG_PRIORITY &&                   \
+        ::netsim::BtsLogEnabled(priority)) {                       \
+      __BtsLog(priority, __FILE__, __LINE__, fmt, ##__VA_ARGS__);  \
+    }                                                              \
+  } while (0)
+
+// Logs at most kBtsLogRateLimit messages per second from the call site and
+// then reports how many were suppressed. For logs on packet paths.
+#define NETSIM_LOG_RATE_LIMITED(priority, fmt, ...)                       \
+  do {                                                                    \
+    if ((priority) <= NETSIM_MAX_LOG_PRIORITY &&                          \
+        ::netsim::BtsLogEnabled(priority)) {                              \
+      static ::netsim::BtsLogRateLimiter netsim_log_limiter;              \
+      uint32_t netsim_log_suppressed = 0;                                 \
+      if (netsim_log_limiter.Allow(netsim_log_suppressed)) {              \
+        if (netsim_log_suppressed != 0) {                                 \
+          __BtsLog(priority, __FILE__, __LINE__,                          \
+                   "Suppressed %u messages", netsim_log_suppressed);      \
+        }                                                                 \
+        __BtsLog(priority, __FILE__, __LINE__, fmt, ##__VA_ARGS__);       \
+      }                                                                   \
+    }                                                                     \
+  } while (0)
+
+#define BtsLog(fmt, ...) NETSIM_LOG(3, fmt, ##__VA_ARGS__)
+#define BtsLogInfo(fmt, ...) NETSIM_LOG(2, fmt, ##__VA_ARGS__)
+#define BtsLogWarn(fmt, ...) NETSIM_LOG(1, fmt, ##__VA_ARGS__)
+#define BtsLogError(fmt, ...) NETSIM_LOG(0, fmt, ##__VA_ARGS__)
+#define BtsLogWarnRateLimited(fmt, ...) \
+  NETSIM_LOG_RATE_LIMITED(1, fmt, ##__VA_ARGS__)
 
 void __BtsLog(int priority, const char *file, int line, const char *fmt, ...);
 
-using BtsLogFn = std::function<void(int, const char *, int, const char *)>;
+// Highest priority logged at run time, 3 (debug) by default.
+extern std::atomic<int> bts_log_priority;
+
+inline bool BtsLogEnabled(int priority) {
+  return priority <= bts_log_priority.load(std::memory_order_relaxed);
+}
+
+void setBtsLogPriority(int priority);
 
+constexpr uint32_t kBtsLogRateLimit = 10;
+
+// Counts the messages of a call site per one second window.
+class BtsLogRateLimiter {
+ public:
+  // Returns true if the message may be logged, and the number of messages
+  // suppressed since the last one that was logged.
+  bool Allow(uint32_t &suppressed) {
+    return Allow(suppressed,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(
+                     std::chrono::steady_clock::now().time_since_epoch())
+                     .count());
+  }
+
+  // Allow at now, a steady clock time in milliseconds.
+  bool Allow(uint32_t &suppressed, int64_t now) {
+    int64_t start = window_start_.load(std::memory_order_relaxed);
+    if (now - start >= 1000 &&
+        window_start_.compare_exchange_strong(start, now,
+                                              std::memory_order_relaxed)) {
+      count_.store(0, std::memory_order_relaxed);
+    }
+    if (count_.fetch_add(1, std::memory_order_relaxed) >= kBtsLogRateLimit) {
+      suppressed_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+    return true;
+  }
+
+ private:
+  std::atomic<int64_t> window_start_{INT64_MIN / 2};
+  std::atomic<uint32_t> count_{0};
+  std::atomic<uint32_t> suppressed_{0};
+};
+
+using BtsLogFn = std::function<void(int, const char *, int, const char *)>;
+// Log records are written by a background thread. The sink is called on
+// that thread. Records logged while the queue is full are dropped and
+// counted in a warning.
 void setBtsLogSink(BtsLogFn logFn);
 
+// Waits until the records logged so far have been written.
+void FlushBtsLog();
+
 }  // namespace netsim
@@ -0,0 +1,114 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the asynchronous log sink.
+#include "util/log.h"
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+TEST(LogTest, SinkReceivesRecordsInOrder) {
+  std::mutex mutex;
+  std::vector<std::string> messages;
+  std::thread::id sink_thread;
+  setBtsLogSink([&](int priority, const char *, int, const char *message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    sink_thread = std::this_thread::get_id();
+    messages.push_back(std::to_string(priority) + ":" + message);
+  });
+  BtsLogInfo("first %d", 1);
+  BtsLogWarn("second %s", "two");
+  FlushBtsLog();
+  setBtsLogSink(nullptr);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(messages.size(), 2u);
+  EXPECT_EQ(messages[0], "2:first 1");
+  EXPECT_EQ(messages[1], "1:second two");
+  // Formatting and I/O happen off the calling thread.
+  EXPECT_NE(sink_thread, std::this_thread::get_id());
+}
+
+TEST(LogTest, LongMessagesAreTruncated) {
+  std::mutex mutex;
+  std::string received;
+  setBtsLogSink([&](int, const char *, int, const char *message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    received = message;
+  });
+  BtsLogError("%s", std::string(1000, 'x').c_str());
+  FlushBtsLog();
+  setBtsLogSink(nullptr);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  EXPECT_EQ(received, std::string(254, 'x'));
+}
+
+TEST(LogTest, DisabledPriorityIsNotFormatted) {
+  int evaluated = 0;
+  auto argument = [&evaluated] { return ++evaluated; };
+  setBtsLogPriority(1);
+  BtsLogInfo("%d", argument());
+  BtsLog("%d", argument());
+  EXPECT_EQ(evaluated, 0);
+  BtsLogWarn("%d", argument());
+  EXPECT_EQ(evaluated, 1);
+  setBtsLogPriority(3);
+  FlushBtsLog();
+}
+
+TEST(LogTest, RateLimiterSuppressesAndReports) {
+  BtsLogRateLimiter limiter;
+  uint32_t suppressed = 0;
+  const int64_t now = 5000;
+  for (uint32_t i = 0; i < kBtsLogRateLimit; i++) {
+    EXPECT_TRUE(limiter.Allow(suppressed, now));
+    EXPECT_EQ(suppressed, 0u);
+  }
+  EXPECT_FALSE(limiter.Allow(suppressed, now));
+  EXPECT_FALSE(limiter.Allow(suppressed, now + 999));
+  // The first message of the next window reports the suppressed ones.
+  EXPECT_TRUE(limiter.Allow(suppressed, now + 1000));
+  EXPECT_EQ(suppressed, 2u);
+  EXPECT_TRUE(limiter.Allow(suppressed, now + 1000));
+  EXPECT_EQ(suppressed, 0u);
+}
+
+TEST(LogTest, RateLimitedCallSite) {
+  std::mutex mutex;
+  std::vector<std::string> messages;
+  setBtsLogSink([&](int, const char *, int, const char *message) {
+    std::lock_guard<std::mutex> lock(mutex);
+    messages.push_back(message);
+  });
+  for (int i = 0; i < 100; i++) BtsLogWarnRateLimited("flood %d", i);
+  FlushBtsLog();
+  setBtsLogSink(nullptr);
+
+  std::lock_guard<std::mutex> lock(mutex);
+  ASSERT_EQ(messages.size(), kBtsLogRateLimit);
+  EXPECT_EQ(messages.back(), "flood 9");
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace netsim {
+namespace util {
+
+/**
+ * @class MappedFile
+ *
+ * A file mapped read-only into memory, so it can be parsed in place without
+ * reading it into a buffer first. The contents stay valid until the
+ * MappedFile is destroyed.
+ */
+class MappedFile {
+ public:
+  // Returns nullptr when the file can not be opened or mapped.
+  static std::unique_ptr<MappedFile> Open(const std::string &path);
+
+  ~MappedFile();
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  std::string_view Contents() const {
+    return {static_cast<const char *>(data_), size_};
+  }
+
+ private:
+  MappedFile(const void *data, size_t size) : data_(data), size_(size) {}
+
+  const void *data_;
+  size_t size_;
+};
+
+}  // namespace util
+}  // namespace netsim
@@ -0,0 +1,213 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace netsim {
+namespace util {
+
+/**
+ * @brief A bounded lock-free multi-producer single-consumer queue.
+ *
+ * @tparam T Type of the element
+ *
+ * Drop-in alternative to `BlockingQueue` for hot hand-off paths. Producers
+ * claim a slot with one compare-and-swap and never take a lock unless the
+ * consumer is parked. The consumer spins briefly before parking on a
+ * condition variable, so a busy queue is drained without syscalls.
+ *
+ * The capacity is rounded up to a power of two. `Push` fails instead of
+ * blocking when the queue is full.
+ *
+ * Only one thread may call `WaitAndPop`, `TryPop` and `PopAll`.
+ */
+template <class T>
+class MpscRingQueue {
+ public:
+  explicit MpscRingQueue(size_t capacity = 1024)
+      : capacity_(RoundUpPowerOfTwo(capacity)),
+        mask_(capacity_ - 1),
+        cells_(new Cell[capacity_]) {
+    for (size_t i = 0; i < capacity_; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ~MpscRingQueue() {
+    for (; !Empty(); dequeue_pos_++) {
+      cells_[dequeue_pos_ & mask_].element()->~T();
+    }
+  }
+
+  MpscRingQueue(const MpscRingQueue &) = delete;
+  MpscRingQueue &operator=(const MpscRingQueue &) = delete;
+
+  /**
+   * @brief Returns true if the queue is active.
+   */
+  bool Active() const { return !stopped_.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Stops the queue and unblocks the reader.
+   */
+  void Stop() {
+    stopped_.store(true);
+    std::lock_guard<std::mutex> lock(mutex_);
+    condition_.notify_all();
+  }
+
+  /**
+   * @brief Add data to the end of the queue.
+   *
+   * Returns false if the queue is stopped or full.
+   */
+  bool Push(const T &value) { return Emplace(value); }
+
+  /**
+   * @brief Add data to the end of the queue.
+   *
+   * Returns false if the queue is stopped or full.
+   */
+  bool Push(T &&value) { return Emplace(std::move(value)); }
+
+  /**
+   * @brief Moves the front element out without blocking.
+   *
+   * Returns false if the queue is empty.
+   */
+  bool TryPop(T &value) {
+    Cell &cell = cells_[dequeue_pos_ & mask_];
+    if (cell.sequence.load() != dequeue_pos_ + 1) return false;
+    T *element = cell.element();
+    value = std::move(*element);
+    element->~T();
+    cell.sequence.store(dequeue_pos_ + capacity_, std::memory_order_release);
+    dequeue_pos_++;
+    return true;
+  }
+
+  /**
+   * @brief Moves all available elements to the end of `values` without
+   * blocking.
+   *
+   * Returns the number of elements moved.
+   */
+  size_t PopAll(std::vector<T> &values) {
+    size_t count = 0;
+    T value;
+    while (TryPop(value)) {
+      values.push_back(std::move(value));
+      count++;
+    }
+    return count;
+  }
+
+  /**
+   * @brief Retrieves the front element, waiting for one if needed.
+   *
+   * Returns false if stopped, true otherwise
+   */
+  bool WaitAndPop(T &value) {
+    for (int spin = 0; spin < kSpinCount; spin++) {
+      if (!Active()) return false;
+      if (TryPop(value)) return true;
+      if (spin >= kSpinCount / 2) std::this_thread::yield();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Producers check `parked_` after publishing and the predicate checks
+    // the queue after `parked_` is set, so a wake-up cannot be lost.
+    parked_.store(true);
+    condition_.wait(lock, [this] { return !Active() || !Empty(); });
+    parked_.store(false, std::memory_order_relaxed);
+    if (!Active()) return false;
+    return TryPop(value);
+  }
+
+ private:
+  static constexpr int kSpinCount = 128;
+
+  struct Cell {
+    std::atomic<size_t> sequence;
+    alignas(T) unsigned char storage[sizeof(T)];
+
+    T *element() { return std::launder(reinterpret_cast<T *>(storage)); }
+  };
+
+  static size_t RoundUpPowerOfTwo(size_t value) {
+    size_t result = 2;
+    while (result < value) result <<= 1;
+    return result;
+  }
+
+  bool Empty() const {
+    return cells_[dequeue_pos_ & mask_].sequence.load() != dequeue_pos_ + 1;
+  }
+
+  template <class U>
+  bool Emplace(U &&value) {
+    if (!Active()) return false;
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell *cell;
+    while (true) {
+      cell = &cells_[pos & mask_];
+      size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;  // full
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    new (cell->storage) T(std::forward<U>(value));
+    cell->sequence.store(pos + 1);
+    if (parked_.load()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      condition_.notify_one();
+    }
+    return true;
+  }
+
+  const size_t capacity_;
+  const size_t mask_;
+  std::unique_ptr<Cell[]> cells_;
+
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  // Only touched by the consumer.
+  alignas(64) size_t dequeue_pos_{0};
+
+  std::atomic<bool> stopped_{false};
+  std::atomic<bool> parked_{false};
+  std::mutex mutex_;
+  std::condition_variable condition_;
+};
+
+}  // namespace util
+}  // namespace netsim
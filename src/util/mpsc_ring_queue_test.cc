@@ -0,0 +1,104 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for MpscRingQueue class.
+#include "util/mpsc_ring_queue.h"
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using util::MpscRingQueue;
+
+TEST(MpscRingQueueTest, PushAndPopInOrder) {
+  MpscRingQueue<int> queue(4);
+  EXPECT_TRUE(queue.Push(1));
+  EXPECT_TRUE(queue.Push(2));
+  int value = 0;
+  EXPECT_TRUE(queue.WaitAndPop(value));
+  EXPECT_EQ(value, 1);
+  EXPECT_TRUE(queue.TryPop(value));
+  EXPECT_EQ(value, 2);
+  EXPECT_FALSE(queue.TryPop(value));
+}
+
+TEST(MpscRingQueueTest, PushFailsWhenFull) {
+  MpscRingQueue<int> queue(2);
+  EXPECT_TRUE(queue.Push(1));
+  EXPECT_TRUE(queue.Push(2));
+  EXPECT_FALSE(queue.Push(3));
+  int value = 0;
+  EXPECT_TRUE(queue.TryPop(value));
+  EXPECT_TRUE(queue.Push(3));
+}
+
+TEST(MpscRingQueueTest, MoveOnlyElements) {
+  MpscRingQueue<std::unique_ptr<int>> queue(8);
+  EXPECT_TRUE(queue.Push(std::make_unique<int>(7)));
+  EXPECT_TRUE(queue.Push(std::make_unique<int>(8)));
+  EXPECT_TRUE(queue.Push(std::make_unique<int>(9)));
+  std::vector<std::unique_ptr<int>> values;
+  EXPECT_EQ(queue.PopAll(values), 3u);
+  ASSERT_EQ(values.size(), 3u);
+  EXPECT_EQ(*values[0], 7);
+  EXPECT_EQ(*values[2], 9);
+  // Elements left in the queue are released by the destructor.
+  EXPECT_TRUE(queue.Push(std::make_unique<int>(10)));
+}
+
+TEST(MpscRingQueueTest, StopUnblocksReader) {
+  MpscRingQueue<int> queue(4);
+  std::thread reader([&queue] {
+    int value;
+    EXPECT_FALSE(queue.WaitAndPop(value));
+  });
+  queue.Stop();
+  reader.join();
+  EXPECT_FALSE(queue.Active());
+  EXPECT_FALSE(queue.Push(1));
+}
+
+TEST(MpscRingQueueTest, MultipleProducers) {
+  constexpr int kProducers = 4;
+  constexpr int kPerProducer = 10000;
+  MpscRingQueue<int> queue(64);
+  std::vector<std::thread> producers;
+  for (int p = 0; p < kProducers; p++) {
+    producers.emplace_back([&queue, p] {
+      for (int i = 0; i < kPerProducer; i++) {
+        while (!queue.Push(p * kPerProducer + i)) std::this_thread::yield();
+      }
+    });
+  }
+  // Every producer's values arrive in the order they were pushed.
+  std::vector<int> next(kProducers, 0);
+  for (int received = 0; received < kProducers * kPerProducer; received++) {
+    int value;
+    ASSERT_TRUE(queue.WaitAndPop(value));
+    int p = value / kPerProducer;
+    EXPECT_EQ(value % kPerProducer, next[p]);
+    next[p]++;
+  }
+  for (auto &producer : producers) producer.join();
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
@@ -98,9 +98,22 @@ std::optional<std::string> GetServerAddress(uint16_t instance_num) {
     BtsLogError("Not a regular file: %s", filepath.c_str());
     return std::nullopt;
   }
-  IniFile iniFile(filepath);
-  iniFile.Read();
-  return iniFile.Get("grpc.port");
+  return IniFileCache::Get(filepath, "grpc.port");
+}
+
+std::optional<std::string> GetFrontendServerAddress(uint16_t instance_num) {
+  auto filepath = GetNetsimIniFilepath(instance_num);
+  if (netsim::filesystem::is_regular_file(filepath)) {
+    auto port = IniFileCache::Get(filepath, "grpc.frontend_port");
+    if (port.has_value()) return port;
+  }
+  return GetServerAddress(instance_num);
+}
+
+std::optional<std::string> GetServerUdsPath(uint16_t instance_num) {
+  auto filepath = GetNetsimIniFilepath(instance_num);
+  if (!netsim::filesystem::is_regular_file(filepath)) return std::nullopt;
+  return IniFileCache::Get(filepath, "grpc.uds");
 }
 
 bool is_stderr_open() {
@@ -45,6 +45,17 @@ std::string GetNetsimIniFilepath(uint16_t instance_num);
  */
 std::optional<std::string> GetServerAddress(uint16_t instance_num = 0);
 
+/**
+ * Return the grpc port of the frontend service, which is the frontend grpc
+ * port if netsimd runs a separate frontend server.
+ */
+std::optional<std::string> GetFrontendServerAddress(uint16_t instance_num = 0);
+
+/**
+ * Return the path of the grpc unix domain socket if the server has one.
+ */
+std::optional<std::string> GetServerUdsPath(uint16_t instance_num = 0);
+
 /**
  * Redirect stdout and stderr to file.
  */
@@ -0,0 +1,97 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rust/cxx.h"
+#include "util/latency_histogram.h"
+#include "util/packet_pool.h"
+
+namespace netsim::util {
+
+/**
+ * @class PacketBuffer
+ *
+ * Owned packet payload passed by handle between the gRPC transport, the
+ * Rust dispatcher and the chip facades.
+ *
+ * The payload is copied once into a pooled vector (see PacketPool) when the
+ * packet enters netsimd. Every later layer either borrows it as a slice
+ * (captures, Rust) or shares ownership of the underlying vector (rootcanal,
+ * WiFi service), so no further copies are made on the request path.
+ */
+class PacketBuffer {
+ public:
+  PacketBuffer() : data_(std::make_shared<std::vector<uint8_t>>()) {}
+
+  explicit PacketBuffer(std::shared_ptr<std::vector<uint8_t>> data)
+      : data_(std::move(data)) {}
+
+  // Makes the one pooled copy of a protobuf bytes field, and clears the
+  // field. The payload is not moved: rootcanal and the WiFi service share a
+  // std::vector, which cannot adopt the storage of a std::string. The
+  // packet is stamped with its ingress time when latency stats are on.
+  static PacketBuffer FromBytes(std::string *bytes_field) {
+    auto data = PacketPool::Copy(
+        reinterpret_cast<const uint8_t *>(bytes_field->data()),
+        bytes_field->size());
+    bytes_field->clear();
+    PacketBuffer buffer(std::move(data));
+    if (LatencyStatsEnabled())
+      buffer.ingress_time_ = std::chrono::steady_clock::now();
+    return buffer;
+  }
+
+  // Shared ownership of the payload, for consumers that outlive the call.
+  const std::shared_ptr<std::vector<uint8_t>> &Share() const { return data_; }
+
+  // Borrowed view of the payload, used by the Rust dispatcher.
+  rust::Slice<const uint8_t> AsSlice() const {
+    return rust::Slice<const uint8_t>(data_->data(), data_->size());
+  }
+
+  const uint8_t *Data() const { return data_->data(); }
+  size_t Size() const { return data_->size(); }
+
+  // Time the packet was read from its stream, or the epoch if the packet
+  // was not stamped.
+  std::chrono::steady_clock::time_point IngressTime() const {
+    return ingress_time_;
+  }
+
+ private:
+  std::shared_ptr<std::vector<uint8_t>> data_;
+  std::chrono::steady_clock::time_point ingress_time_;
+};
+
+// Copies the packet pool stats into stats, in PacketPoolStats field order.
+inline void GetPacketPoolStatsCxx(rust::Slice<uint64_t> stats) {
+  auto pool_stats = PacketPool::Stats();
+  const uint64_t values[] = {pool_stats.acquired, pool_stats.reused,
+                             pool_stats.oversize, pool_stats.dropped,
+                             pool_stats.pooled};
+  for (size_t i = 0; i < stats.size() && i < std::size(values); i++)
+    stats[i] = values[i];
+}
+
+}  // namespace netsim::util
@@ -0,0 +1,376 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/packet_pool.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include "util/thread_affinity.h"
+
+namespace netsim {
+namespace util {
+namespace {
+
+using Packet = std::vector<uint8_t>;
+
+constexpr size_t kNumClasses = PacketPool::kSizeClasses.size();
+// Packets are pooled apart per NUMA node, with larger nodes folded onto
+// these.
+constexpr size_t kMaxNumaNodes = 4;
+// Items kept per free list by each thread and, at most, by the shared pool.
+constexpr size_t kThreadCacheSize = 64;
+constexpr size_t kSharedPoolSize = 4096;
+// Bytes of packets kept by the shared pool of a size class on a node, so the
+// large classes keep few packets after a burst.
+constexpr size_t kSharedPoolBytes = 1 << 20;
+// Items moved at once between a thread cache and the shared pool.
+constexpr size_t kBatchSize = kThreadCacheSize / 2;
+// Free lists of packets, plus a few for the control block slots.
+constexpr size_t kMaxFreeLists = kMaxNumaNodes * kNumClasses + 4;
+
+std::atomic<uint64_t> oversize{0};
+std::atomic<uint64_t> dropped{0};
+std::atomic<uint64_t> pooled{0};
+
+/**
+ * @brief Counters bumped on every packet, kept per thread.
+ *
+ * Only the owning thread writes them, so a plain load and store is enough
+ * and the hot path has no atomic read-modify-write. Stats() sums the live
+ * threads and the counts of the threads that exited.
+ */
+struct PacketCounters {
+  std::atomic<uint64_t> acquired{0};
+  std::atomic<uint64_t> reused{0};
+};
+
+std::mutex counters_mutex;
+auto *live_counters = new std::vector<PacketCounters *>();
+PacketCounters exited_counters;
+
+void Add(std::atomic<uint64_t> &counter, uint64_t n) {
+  counter.store(counter.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+}
+
+struct ThreadCounters {
+  PacketCounters counters;
+  ThreadCounters() {
+    std::lock_guard<std::mutex> lock(counters_mutex);
+    live_counters->push_back(&counters);
+  }
+  ~ThreadCounters() {
+    std::lock_guard<std::mutex> lock(counters_mutex);
+    live_counters->erase(
+        std::find(live_counters->begin(), live_counters->end(), &counters));
+    Add(exited_counters.acquired, counters.acquired.load());
+    Add(exited_counters.reused, counters.reused.load());
+    exited = true;
+  }
+  // Trivially destructible, so it can be read after the destructor ran.
+  static thread_local bool exited;
+};
+
+thread_local bool ThreadCounters::exited = false;
+
+// Counts one packet, and whether it reused a pooled vector.
+void CountPacket(bool was_reused) {
+  PacketCounters *counters = &exited_counters;
+  std::unique_lock<std::mutex> lock;
+  if (ThreadCounters::exited) {
+    lock = std::unique_lock<std::mutex>(counters_mutex);
+  } else {
+    static thread_local ThreadCounters thread_counters;
+    counters = &thread_counters.counters;
+  }
+  Add(counters->acquired, 1);
+  if (was_reused) Add(counters->reused, 1);
+}
+
+/**
+ * @brief A free list with a cache per thread in front of a shared pool.
+ *
+ * The shared pool is never destroyed, so items released while threads or
+ * the process exit still have a home. Items that do not fit are destroyed.
+ */
+class FreeList {
+ public:
+  using Destroy = void (*)(void *);
+
+  FreeList(Destroy destroy, bool count, size_t capacity)
+      : destroy_(destroy),
+        count_(count),
+        capacity_(capacity),
+        index_(next_index++) {
+    assert(index_ < kMaxFreeLists);
+  }
+
+  void *Pop() {
+    Cache *cache = LocalCache();
+    if (!cache) return PopShared();
+    if (cache->items.empty()) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      size_t n = std::min(kBatchSize, items_.size());
+      cache->items.insert(cache->items.end(), items_.end() - n, items_.end());
+      items_.resize(items_.size() - n);
+      if (count_) pooled.fetch_sub(n, std::memory_order_relaxed);
+    }
+    if (cache->items.empty()) return nullptr;
+    void *item = cache->items.back();
+    cache->items.pop_back();
+    return item;
+  }
+
+  void Push(void *item) {
+    Cache *cache = LocalCache();
+    if (!cache) {
+      PushShared(&item, 1);
+      return;
+    }
+    if (cache->items.size() >= kThreadCacheSize) {
+      PushShared(cache->items.data() + kThreadCacheSize - kBatchSize,
+                 kBatchSize);
+      cache->items.resize(kThreadCacheSize - kBatchSize);
+    }
+    cache->items.push_back(item);
+  }
+
+ private:
+  struct Cache {
+    std::vector<void *> items;
+  };
+
+  // Flushes the caches of a thread to their shared pools when it exits.
+  struct ThreadCaches {
+    std::array<std::pair<FreeList *, Cache *>, kMaxFreeLists> caches{};
+    ~ThreadCaches() {
+      for (auto &[free_list, cache] : caches) {
+        if (!cache) continue;
+        free_list->PushShared(cache->items.data(), cache->items.size());
+        delete cache;
+      }
+      exited = true;
+    }
+    // Trivially destructible, so it can be read after the destructor ran.
+    static thread_local bool exited;
+  };
+
+  // Returns nullptr once the caches of the thread are gone.
+  Cache *LocalCache() {
+    if (ThreadCaches::exited) return nullptr;
+    static thread_local ThreadCaches thread_caches;
+    auto &[free_list, cache] = thread_caches.caches[index_];
+    if (!cache) {
+      free_list = this;
+      cache = new Cache();
+      cache->items.reserve(kThreadCacheSize);
+    }
+    return cache;
+  }
+
+  void *PopShared() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (items_.empty()) return nullptr;
+    void *item = items_.back();
+    items_.pop_back();
+    if (count_) pooled.fetch_sub(1, std::memory_order_relaxed);
+    return item;
+  }
+
+  void PushShared(void *const *items, size_t n) {
+    size_t kept;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      kept = std::min(n, capacity_ - std::min(capacity_, items_.size()));
+      items_.insert(items_.end(), items, items + kept);
+    }
+    for (size_t i = kept; i < n; i++) destroy_(items[i]);
+    if (count_) {
+      pooled.fetch_add(kept, std::memory_order_relaxed);
+      dropped.fetch_add(n - kept, std::memory_order_relaxed);
+    }
+  }
+
+  const Destroy destroy_;
+  // Whether the items are packets counted in the stats.
+  const bool count_;
+  // Items kept by the shared pool.
+  const size_t capacity_;
+  // Index of the cache of this free list in ThreadCaches.
+  const size_t index_;
+  std::mutex mutex_;
+  std::vector<void *> items_;
+
+  static inline std::atomic<size_t> next_index{0};
+};
+
+thread_local bool FreeList::ThreadCaches::exited = false;
+
+void DestroyPacket(void *packet) { delete static_cast<Packet *>(packet); }
+
+void DestroySlot(void *slot) { ::operator delete(slot); }
+
+// Pages are placed on the node of the thread that first writes them, which
+// is the thread that takes a new packet. Keeping the packets of each node
+// in their own free lists keeps them there when they are reused.
+FreeList &PacketFreeList(size_t node, size_t size_class) {
+  static auto *free_lists = [] {
+    auto lists = new std::vector<std::unique_ptr<FreeList>>();
+    for (size_t i = 0; i < kMaxNumaNodes * kNumClasses; i++) {
+      size_t size = PacketPool::kSizeClasses[i % kNumClasses];
+      size_t capacity = std::min(kSharedPoolBytes / size, kSharedPoolSize);
+      lists->push_back(
+          std::make_unique<FreeList>(DestroyPacket, true, capacity));
+    }
+    return lists;
+  }();
+  return *(*free_lists)[node * kNumClasses + size_class];
+}
+
+size_t LocalNode() { return CurrentNumaNode() % kMaxNumaNodes; }
+
+// Slots of one size, for the control blocks of the shared pointers.
+template <size_t kSize>
+FreeList &SlotFreeList() {
+  static auto *free_list = new FreeList(DestroySlot, false, kSharedPoolSize);
+  return *free_list;
+}
+
+template <class T>
+struct SlotAllocator {
+  using value_type = T;
+
+  SlotAllocator() = default;
+  template <class U>
+  SlotAllocator(const SlotAllocator<U> &) {}
+
+  T *allocate(size_t n) {
+    static_assert(alignof(T) <= alignof(std::max_align_t));
+    if (n != 1) return std::allocator<T>().allocate(n);
+    void *slot = SlotFreeList<sizeof(T)>().Pop();
+    return static_cast<T *>(slot ? slot : ::operator new(sizeof(T)));
+  }
+
+  void deallocate(T *p, size_t n) {
+    if (n != 1) return std::allocator<T>().deallocate(p, n);
+    SlotFreeList<sizeof(T)>().Push(p);
+  }
+
+  template <class U>
+  bool operator==(const SlotAllocator<U> &) const {
+    return true;
+  }
+  template <class U>
+  bool operator!=(const SlotAllocator<U> &) const {
+    return false;
+  }
+};
+
+// Returns the smallest size class holding size bytes, or kNumClasses.
+size_t SizeClass(size_t size) {
+  for (size_t i = 0; i < kNumClasses; i++) {
+    if (size <= PacketPool::kSizeClasses[i]) return i;
+  }
+  return kNumClasses;
+}
+
+// Returns the packet to the largest size class its capacity holds, in the
+// free lists of the node it was allocated on.
+void Recycle(size_t node, Packet *packet) {
+  size_t capacity = packet->capacity();
+  if (capacity < PacketPool::kSizeClasses.front() ||
+      capacity > 2 * PacketPool::kSizeClasses.back()) {
+    delete packet;
+    return;
+  }
+  size_t size_class = kNumClasses - 1;
+  while (capacity < PacketPool::kSizeClasses[size_class]) size_class--;
+  packet->clear();
+  PacketFreeList(node, size_class).Push(packet);
+}
+
+// Returns an empty packet with the capacity of a size class.
+Packet *Take(size_t node, size_t size_class) {
+  if (auto packet =
+          static_cast<Packet *>(PacketFreeList(node, size_class).Pop())) {
+    CountPacket(true);
+    return packet;
+  }
+  CountPacket(false);
+  auto packet = new Packet();
+  packet->reserve(PacketPool::kSizeClasses[size_class]);
+  return packet;
+}
+
+struct Recycler {
+  size_t node;
+  void operator()(Packet *packet) const { Recycle(node, packet); }
+};
+
+std::shared_ptr<Packet> Wrap(size_t node, Packet *packet) {
+  return std::shared_ptr<Packet>(packet, Recycler{node},
+                                 SlotAllocator<Packet>());
+}
+
+}  // namespace
+
+std::shared_ptr<std::vector<uint8_t>> PacketPool::Acquire(size_t size) {
+  auto size_class = SizeClass(size);
+  if (size_class == kNumClasses) {
+    oversize.fetch_add(1, std::memory_order_relaxed);
+    return std::make_shared<Packet>(size);
+  }
+  auto node = LocalNode();
+  auto packet = Take(node, size_class);
+  packet->resize(size);
+  return Wrap(node, packet);
+}
+
+std::shared_ptr<std::vector<uint8_t>> PacketPool::Copy(const uint8_t *data,
+                                                       size_t size) {
+  auto size_class = SizeClass(size);
+  if (size_class == kNumClasses) {
+    oversize.fetch_add(1, std::memory_order_relaxed);
+    return std::make_shared<Packet>(data, data + size);
+  }
+  auto node = LocalNode();
+  auto packet = Take(node, size_class);
+  packet->assign(data, data + size);
+  return Wrap(node, packet);
+}
+
+PacketPoolStats PacketPool::Stats() {
+  std::lock_guard<std::mutex> lock(counters_mutex);
+  uint64_t acquired = exited_counters.acquired.load();
+  uint64_t reused = exited_counters.reused.load();
+  for (auto *counters : *live_counters) {
+    acquired += counters->acquired.load(std::memory_order_relaxed);
+    reused += counters->reused.load(std::memory_order_relaxed);
+  }
+  return {acquired, reused, oversize.load(std::memory_order_relaxed),
+          dropped.load(std::memory_order_relaxed),
+          pooled.load(std::memory_order_relaxed)};
+}
+
+}  // namespace util
+}  // namespace netsim
@@ -0,0 +1,72 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Recycled storage for the packets of the request and phy paths.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace netsim {
+namespace util {
+
+struct PacketPoolStats {
+  // Packets handed out, and how many of them reused a pooled vector.
+  uint64_t acquired;
+  uint64_t reused;
+  // Packets too large for the size classes, never pooled.
+  uint64_t oversize;
+  // Vectors freed because the pool of their size class was full.
+  uint64_t dropped;
+  // Vectors waiting in the shared pool, not counting the thread caches.
+  uint64_t pooled;
+};
+
+/**
+ * @brief Hands out packets as shared vectors whose storage is recycled.
+ *
+ * rootcanal and the WiFi service take packets as
+ * std::shared_ptr<std::vector<uint8_t>>, so that is the handle. When the
+ * last reference is dropped the vector keeps its capacity and goes back to
+ * the pool of its size class, and the control block goes back to a slot
+ * pool, so a steady packet flow does not allocate.
+ *
+ * Each thread keeps a small cache per size class and only takes the pool
+ * mutex to exchange batches with the shared pool. Packets may be released
+ * on another thread than the one that acquired them. Packets are pooled
+ * per NUMA node of the thread that allocated them, see CurrentNumaNode.
+ */
+class PacketPool {
+ public:
+  static constexpr std::array<size_t, 6> kSizeClasses = {
+      64, 256, 1024, 4096, 16384, 65536};
+
+  // Returns a packet of size zeroed bytes.
+  static std::shared_ptr<std::vector<uint8_t>> Acquire(size_t size);
+
+  // Returns a packet holding a copy of the bytes.
+  static std::shared_ptr<std::vector<uint8_t>> Copy(const uint8_t *data,
+                                                    size_t size);
+
+  static PacketPoolStats Stats();
+};
+
+}  // namespace util
+}  // namespace netsim
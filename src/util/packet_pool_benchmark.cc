@@ -0,0 +1,55 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of packet allocation on the request path.
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "util/benchmark_counters.h"
+#include "util/packet_pool.h"
+
+namespace netsim {
+namespace util {
+namespace {
+
+// Copies a packet of Arg bytes into a new shared vector, as the request path
+// did before the pool.
+void BM_MakeSharedCopy(benchmark::State &state) {
+  std::vector<uint8_t> bytes(state.range(0), 0x02);
+  for (auto _ : state) {
+    auto packet =
+        std::make_shared<std::vector<uint8_t>>(bytes.begin(), bytes.end());
+    benchmark::DoNotOptimize(packet->data());
+  }
+  SetPacketCounters(state, state.iterations());
+}
+
+// Copies a packet of Arg bytes into a pooled vector.
+void BM_PacketPoolCopy(benchmark::State &state) {
+  std::vector<uint8_t> bytes(state.range(0), 0x02);
+  for (auto _ : state) {
+    auto packet = PacketPool::Copy(bytes.data(), bytes.size());
+    benchmark::DoNotOptimize(packet->data());
+  }
+  SetPacketCounters(state, state.iterations());
+}
+
+BENCHMARK(BM_MakeSharedCopy)->Arg(64)->Arg(1024)->Arg(16384);
+BENCHMARK(BM_PacketPoolCopy)->Arg(64)->Arg(1024)->Arg(16384);
+
+}  // namespace
+}  // namespace util
+}  // namespace netsim
@@ -0,0 +1,98 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for PacketPool class.
+#include "util/packet_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using util::PacketPool;
+
+TEST(PacketPoolTest, AcquireReturnsZeroedPacket) {
+  auto packet = PacketPool::Acquire(10);
+  EXPECT_EQ(*packet, std::vector<uint8_t>(10, 0));
+  EXPECT_GE(packet->capacity(), 64);
+}
+
+TEST(PacketPoolTest, CopyHoldsBytes) {
+  const uint8_t bytes[] = {0x03, 0x0c, 0x00};
+  auto packet = PacketPool::Copy(bytes, sizeof(bytes));
+  EXPECT_EQ(*packet, std::vector<uint8_t>({0x03, 0x0c, 0x00}));
+}
+
+TEST(PacketPoolTest, ReleasedPacketIsReused) {
+  auto packet = PacketPool::Acquire(300);
+  auto storage = packet->data();
+  packet->assign(300, 0xff);
+  packet.reset();
+
+  auto before = PacketPool::Stats();
+  packet = PacketPool::Acquire(500);
+  auto after = PacketPool::Stats();
+  EXPECT_EQ(packet->data(), storage);
+  EXPECT_EQ(*packet, std::vector<uint8_t>(500, 0));
+  EXPECT_EQ(after.acquired - before.acquired, 1);
+  EXPECT_EQ(after.reused - before.reused, 1);
+}
+
+TEST(PacketPoolTest, OversizePacketsAreNotPooled) {
+  auto before = PacketPool::Stats();
+  auto packet = PacketPool::Acquire(PacketPool::kSizeClasses.back() + 1);
+  EXPECT_EQ(packet->size(), PacketPool::kSizeClasses.back() + 1);
+  EXPECT_EQ(PacketPool::Stats().oversize - before.oversize, 1);
+}
+
+TEST(PacketPoolTest, ReleaseOnOtherThreads) {
+  std::vector<std::shared_ptr<std::vector<uint8_t>>> packets;
+  for (int i = 0; i < 1000; i++) packets.push_back(PacketPool::Acquire(100));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&packets, t] {
+      for (size_t i = t; i < packets.size(); i += 4) packets[i].reset();
+    });
+  }
+  for (auto &thread : threads) thread.join();
+  // The caches of the exited threads went back to the shared pool.
+  auto before = PacketPool::Stats();
+  EXPECT_GT(before.pooled, 0);
+  for (int i = 0; i < 100; i++) packets[i] = PacketPool::Acquire(100);
+  EXPECT_EQ(PacketPool::Stats().reused - before.reused, 100);
+}
+
+TEST(PacketPoolTest, SharedPoolOfLargePacketsIsBoundedByBytes) {
+  auto before = PacketPool::Stats();
+  std::thread([] {
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> packets;
+    for (int i = 0; i < 200; i++) {
+      packets.push_back(PacketPool::Acquire(PacketPool::kSizeClasses.back()));
+    }
+  }).join();
+  auto after = PacketPool::Stats();
+  // 1 MiB of 64 KiB packets.
+  EXPECT_LE(after.pooled - before.pooled, 16);
+  EXPECT_GE(after.dropped - before.dropped, 200 - 16);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
@@ -0,0 +1,165 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/packet_script.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/log.h"
+#include "util/string_utils.h"
+
+namespace netsim {
+namespace util {
+namespace {
+
+// https://www.tcpdump.org/linktypes.html
+constexpr uint32_t kLinkTypeIeee80211RadioTap = 127;
+constexpr uint32_t kLinkTypeBluetoothHciH4WithPhdr = 201;
+
+constexpr size_t kPcapHeaderSize = 24;
+constexpr size_t kRecordHeaderSize = 16;
+constexpr size_t kDirectionSize = 4;
+constexpr uint32_t kHostToController = 0;
+
+std::optional<uint8_t> ParseType(std::string_view type) {
+  if (type == "command") return 1;
+  if (type == "acl") return 2;
+  if (type == "sco") return 3;
+  if (type == "iso") return 5;
+  if (type == "packet") return 0;
+  return std::nullopt;
+}
+
+int HexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Appends the bytes of a hex word; an odd number of digits is an error.
+bool AppendHex(std::string_view word, std::vector<uint8_t> &bytes) {
+  if (word.size() % 2 != 0) return false;
+  for (size_t i = 0; i < word.size(); i += 2) {
+    int high = HexValue(word[i]);
+    int low = HexValue(word[i + 1]);
+    if (high < 0 || low < 0) return false;
+    bytes.push_back(high << 4 | low);
+  }
+  return true;
+}
+
+uint32_t ReadU32(const uint8_t *data, bool big_endian) {
+  if (big_endian) {
+    return uint32_t{data[0]} << 24 | uint32_t{data[1]} << 16 |
+           uint32_t{data[2]} << 8 | data[3];
+  }
+  return uint32_t{data[3]} << 24 | uint32_t{data[2]} << 16 |
+         uint32_t{data[1]} << 8 | data[0];
+}
+
+}  // namespace
+
+std::optional<std::vector<ScriptPacket>> ParsePacketScript(
+    std::string_view script) {
+  std::vector<ScriptPacket> packets;
+  int line_number = 0;
+  for (auto line : stringutils::Split(script, "\n")) {
+    line_number++;
+    line = stringutils::Trim(line);
+    if (line.empty() || line[0] == '#') continue;
+    auto words = stringutils::Split(line, " ");
+    auto type = ParseType(words[0]);
+    if (!type) {
+      BtsLogError("packet script line %d: unknown packet type", line_number);
+      return std::nullopt;
+    }
+    ScriptPacket packet{*type, {}};
+    for (size_t i = 1; i < words.size(); i++) {
+      if (!AppendHex(stringutils::Trim(words[i]), packet.payload)) {
+        BtsLogError("packet script line %d: invalid hex bytes", line_number);
+        return std::nullopt;
+      }
+    }
+    if (packet.payload.empty()) {
+      BtsLogError("packet script line %d: empty packet", line_number);
+      return std::nullopt;
+    }
+    packets.push_back(std::move(packet));
+  }
+  return packets;
+}
+
+std::optional<std::vector<ScriptPacket>> ParsePcap(std::string_view bytes) {
+  auto data = reinterpret_cast<const uint8_t *>(bytes.data());
+  if (bytes.size() < kPcapHeaderSize) {
+    BtsLogError("pcap: missing file header");
+    return std::nullopt;
+  }
+  // The magic number of pcap files with micro or nanosecond timestamps
+  // gives the byte order of the headers.
+  bool big_endian;
+  auto magic = ReadU32(data, true);
+  if (magic == 0xa1b2c3d4 || magic == 0xa1b23c4d) {
+    big_endian = true;
+  } else if (magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1) {
+    big_endian = false;
+  } else {
+    BtsLogError("pcap: unknown magic number 0x%08x", magic);
+    return std::nullopt;
+  }
+  auto link_type = ReadU32(data + 20, big_endian);
+  if (link_type != kLinkTypeBluetoothHciH4WithPhdr &&
+      link_type != kLinkTypeIeee80211RadioTap) {
+    BtsLogError("pcap: unsupported link type %u", link_type);
+    return std::nullopt;
+  }
+
+  std::vector<ScriptPacket> packets;
+  size_t offset = kPcapHeaderSize;
+  while (offset < bytes.size()) {
+    if (bytes.size() - offset < kRecordHeaderSize) {
+      BtsLogError("pcap: truncated record header");
+      return std::nullopt;
+    }
+    auto length = ReadU32(data + offset + 8, big_endian);
+    offset += kRecordHeaderSize;
+    if (bytes.size() - offset < length || length < kDirectionSize) {
+      BtsLogError("pcap: truncated record");
+      return std::nullopt;
+    }
+    const uint8_t *record = data + offset;
+    offset += length;
+    // The direction is in network byte order.
+    if (ReadU32(record, true) != kHostToController) continue;
+    record += kDirectionSize;
+    length -= kDirectionSize;
+    if (link_type == kLinkTypeBluetoothHciH4WithPhdr) {
+      // H4 packet type indicator followed by the packet.
+      if (length < 2) continue;
+      packets.push_back({record[0], {record + 1, record + length}});
+    } else {
+      if (length == 0) continue;
+      packets.push_back({0, {record, record + length}});
+    }
+  }
+  return packets;
+}
+
+}  // namespace util
+}  // namespace netsim
@@ -0,0 +1,66 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Packets replayed on PacketStreamer streams by load generators.
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace netsim {
+namespace util {
+
+/**
+ * @brief A packet sent by a chip to netsim.
+ *
+ * hci_type is the HCIPacket::PacketType of a Bluetooth packet, e.g. 1 for a
+ * command, and 0 for the packets of the other radios.
+ */
+struct ScriptPacket {
+  uint8_t hci_type;
+  std::vector<uint8_t> payload;
+};
+
+/**
+ * @brief Parses a packet script.
+ *
+ * Each line holds one packet: its type, one of command, acl, sco, iso or
+ * packet for the other radios, followed by its bytes in hex, e.g.
+ *
+ *   # HCI Reset
+ *   command 03 0c 00
+ *
+ * Empty lines and lines starting with '#' are skipped. Returns nullopt if a
+ * line is malformed.
+ */
+std::optional<std::vector<ScriptPacket>> ParsePacketScript(
+    std::string_view script);
+
+/**
+ * @brief Returns the host to controller packets of a pcap file.
+ *
+ * Supports the files written by netsim captures: Bluetooth HCI H4 with
+ * phdr (link type 201) and WiFi (link type 127) records, both prefixed
+ * with a direction. Returns nullopt if the file is malformed or has
+ * another link type.
+ */
+std::optional<std::vector<ScriptPacket>> ParsePcap(std::string_view bytes);
+
+}  // namespace util
+}  // namespace netsim
@@ -0,0 +1,93 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the packet script and pcap parsers.
+#include "util/packet_script.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using util::ParsePacketScript;
+using util::ParsePcap;
+
+TEST(PacketScriptTest, ParsesPacketsAndSkipsComments) {
+  auto packets = ParsePacketScript(
+      "# HCI Reset\n"
+      "command 03 0c 00\n"
+      "\n"
+      "acl 0100 0400 01020304\r\n"
+      "packet 88 02\n");
+  ASSERT_TRUE(packets.has_value());
+  ASSERT_EQ(packets->size(), 3);
+  EXPECT_EQ((*packets)[0].hci_type, 1);
+  EXPECT_EQ((*packets)[0].payload, std::vector<uint8_t>({0x03, 0x0c, 0x00}));
+  EXPECT_EQ((*packets)[1].hci_type, 2);
+  EXPECT_EQ((*packets)[1].payload,
+            std::vector<uint8_t>({0x01, 0x00, 0x04, 0x00, 1, 2, 3, 4}));
+  EXPECT_EQ((*packets)[2].hci_type, 0);
+  EXPECT_EQ((*packets)[2].payload, std::vector<uint8_t>({0x88, 0x02}));
+}
+
+TEST(PacketScriptTest, RejectsMalformedLines) {
+  EXPECT_FALSE(ParsePacketScript("event 0e 00\n").has_value());
+  EXPECT_FALSE(ParsePacketScript("command 0\n").has_value());
+  EXPECT_FALSE(ParsePacketScript("command zz\n").has_value());
+  EXPECT_FALSE(ParsePacketScript("command\n").has_value());
+}
+
+// The records of sample.pcap of the netsim captures.
+TEST(PacketScriptTest, ParsesHostToControllerRecords) {
+  const std::vector<uint8_t> pcap = {
+      // File header, big endian, link type 201.
+      0xa1, 0xb2, 0xc3, 0xd4, 0x00, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0xc9,
+      // Host to controller: Command Complete event.
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0b,
+      0x00, 0x00, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x04, 0x0e, 0x04, 0x01,
+      0x0a, 0x20, 0x00,
+      // Controller to host: LE Set Advertise Enable command.
+      0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0xd0, 0x90, 0x00, 0x00, 0x00, 0x09,
+      0x00, 0x00, 0x00, 0x09, 0x00, 0x00, 0x00, 0x01, 0x01, 0x0a, 0x20, 0x01,
+      0x00};
+  auto packets = ParsePcap(
+      {reinterpret_cast<const char *>(pcap.data()), pcap.size()});
+  ASSERT_TRUE(packets.has_value());
+  ASSERT_EQ(packets->size(), 1);
+  EXPECT_EQ((*packets)[0].hci_type, 4);
+  EXPECT_EQ((*packets)[0].payload,
+            std::vector<uint8_t>({0x0e, 0x04, 0x01, 0x0a, 0x20, 0x00}));
+}
+
+TEST(PacketScriptTest, RejectsMalformedPcap) {
+  EXPECT_FALSE(ParsePcap("").has_value());
+  std::string header(24, '\0');
+  EXPECT_FALSE(ParsePcap(header).has_value());
+  // Valid header with link type 1 (Ethernet).
+  header = std::string("\xa1\xb2\xc3\xd4", 4) + std::string(19, '\0') + "\x01";
+  EXPECT_FALSE(ParsePcap(header).has_value());
+  // Truncated record.
+  header[23] = '\xc9';
+  EXPECT_FALSE(ParsePcap(header + std::string(8, '\0')).has_value());
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
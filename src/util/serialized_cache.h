@@ -0,0 +1,72 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace netsim {
+namespace util {
+
+/**
+ * @brief Caches the serialized form of an object until its version changes.
+ *
+ * @tparam Version Equality comparable description of the object state, for
+ * example a counter bumped on every change or a tuple of counters
+ *
+ * `Get` returns the cached bytes when the version matches the one they were
+ * encoded for and re-encodes them otherwise, so repeated reads of an object
+ * that did not change cost one comparison.
+ *
+ * Thread safe.
+ */
+template <class Version>
+class SerializedCache {
+ public:
+  /**
+   * @brief Returns the bytes for version, calling encode(std::string &) to
+   * rebuild them if the object changed since the last call.
+   */
+  template <class F>
+  std::shared_ptr<const std::string> Get(const Version &version, F &&encode) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (bytes_ == nullptr || !(version_ == version)) {
+      auto bytes = std::make_shared<std::string>();
+      encode(*bytes);
+      bytes_ = std::move(bytes);
+      version_ = version;
+    }
+    return bytes_;
+  }
+
+  /**
+   * @brief Drops the cached bytes.
+   */
+  void Invalidate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bytes_.reset();
+  }
+
+ private:
+  std::mutex mutex_;
+  Version version_{};
+  std::shared_ptr<const std::string> bytes_;
+};
+
+}  // namespace util
+}  // namespace netsim
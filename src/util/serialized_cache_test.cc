@@ -0,0 +1,59 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for SerializedCache class.
+#include "util/serialized_cache.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using util::SerializedCache;
+
+TEST(SerializedCacheTest, EncodesOncePerVersion) {
+  SerializedCache<uint64_t> cache;
+  int encoded = 0;
+  auto encode = [&encoded](std::string &bytes) {
+    encoded++;
+    bytes = "v" + std::to_string(encoded);
+  };
+  EXPECT_EQ(*cache.Get(0, encode), "v1");
+  EXPECT_EQ(*cache.Get(0, encode), "v1");
+  EXPECT_EQ(*cache.Get(1, encode), "v2");
+  EXPECT_EQ(encoded, 2);
+  cache.Invalidate();
+  EXPECT_EQ(*cache.Get(1, encode), "v3");
+}
+
+TEST(SerializedCacheTest, CompositeVersion) {
+  SerializedCache<std::array<int32_t, 2>> cache;
+  int encoded = 0;
+  auto encode = [&encoded](std::string &) { encoded++; };
+  auto bytes = cache.Get({1, 2}, encode);
+  cache.Get({1, 2}, encode);
+  cache.Get({1, 3}, encode);
+  EXPECT_EQ(encoded, 2);
+  // Earlier results stay valid after the cache is refreshed.
+  EXPECT_NE(bytes, nullptr);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
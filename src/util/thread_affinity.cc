@@ -0,0 +1,218 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread_affinity.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+#if defined(__linux__)
+#include <dirent.h>
+#include <sched.h>
+#endif
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "util/log.h"
+
+namespace netsim {
+namespace util {
+namespace {
+
+// Larger ids are rejected as typos rather than silently ignored.
+constexpr int kMaxCpu = 4095;
+
+std::mutex class_cpus_mutex;
+std::array<std::vector<int>, kNumThreadClasses> class_cpus;
+
+// Node of the calling thread, worked out on first use when the thread was
+// not set up, e.g. one that inherited its CPUs through StartThreadsOf.
+constexpr int kUnknownNumaNode = -1;
+thread_local int numa_node = kUnknownNumaNode;
+
+std::optional<int> ParseCpu(std::string_view text) {
+  if (text.empty() || text.size() > 4) return std::nullopt;
+  int cpu = 0;
+  for (char c : text) {
+    if (c < '0' || c > '9') return std::nullopt;
+    cpu = cpu * 10 + (c - '0');
+  }
+  if (cpu > kMaxCpu) return std::nullopt;
+  return cpu;
+}
+
+std::string_view Trim(std::string_view text) {
+  while (!text.empty() && text.front() == ' ') text.remove_prefix(1);
+  while (!text.empty() && text.back() == ' ') text.remove_suffix(1);
+  return text;
+}
+
+int NumaNodeOfCpu(int cpu) {
+#if defined(__linux__)
+  // The directory of a CPU links the node it belongs to as "node<N>".
+  auto path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+  DIR *dir = opendir(path.c_str());
+  if (!dir) return kDefaultNumaNode;
+  int node = kDefaultNumaNode;
+  while (auto entry = readdir(dir)) {
+    if (std::strncmp(entry->d_name, "node", 4) != 0) continue;
+    if (auto parsed = ParseCpu(entry->d_name + 4)) {
+      node = *parsed;
+      break;
+    }
+  }
+  closedir(dir);
+  return node;
+#else
+  return kDefaultNumaNode;
+#endif
+}
+
+// NUMA node of the first CPU the calling thread may run on.
+int NumaNodeOfThread() {
+#if defined(__linux__)
+  cpu_set_t set;
+  if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &set)) return NumaNodeOfCpu(cpu);
+    }
+  }
+#endif
+  return kDefaultNumaNode;
+}
+
+// Places the calling thread on cpus, returns false if it failed.
+bool PlaceThread(const std::vector<int> &cpus) {
+#if defined(__linux__)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+  DWORD_PTR mask = 0;
+  for (int cpu : cpus) {
+    if (static_cast<size_t>(cpu) < 8 * sizeof(mask)) {
+      mask |= DWORD_PTR{1} << cpu;
+    }
+  }
+  return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#else
+  // macOS has affinity tags, not CPU sets, so threads stay unplaced.
+  return false;
+#endif
+}
+
+void SetThreadName(const char *name) {
+  char short_name[16];
+  std::strncpy(short_name, name, sizeof(short_name) - 1);
+  short_name[sizeof(short_name) - 1] = '\0';
+#if defined(__linux__)
+  pthread_setname_np(pthread_self(), short_name);
+#elif defined(__APPLE__)
+  pthread_setname_np(short_name);
+#endif
+}
+
+}  // namespace
+
+std::optional<std::vector<int>> ParseCpuList(std::string_view cpu_list) {
+  std::vector<int> cpus;
+  cpu_list = Trim(cpu_list);
+  while (!cpu_list.empty()) {
+    auto comma = cpu_list.find(',');
+    auto item = Trim(cpu_list.substr(0, comma));
+    cpu_list = comma == std::string_view::npos ? std::string_view()
+                                               : cpu_list.substr(comma + 1);
+    auto dash = item.find('-');
+    auto first = ParseCpu(Trim(item.substr(0, dash)));
+    auto last = dash == std::string_view::npos
+                    ? first
+                    : ParseCpu(Trim(item.substr(dash + 1)));
+    if (!first || !last || *first > *last) return std::nullopt;
+    for (int cpu = *first; cpu <= *last; cpu++) cpus.push_back(cpu);
+  }
+  return cpus;
+}
+
+void SetThreadClassCpus(ThreadClass thread_class, std::vector<int> cpus) {
+  std::lock_guard<std::mutex> lock(class_cpus_mutex);
+  class_cpus[static_cast<uint32_t>(thread_class)] = std::move(cpus);
+}
+
+std::vector<int> GetThreadClassCpus(ThreadClass thread_class) {
+  std::lock_guard<std::mutex> lock(class_cpus_mutex);
+  return class_cpus[static_cast<uint32_t>(thread_class)];
+}
+
+void SetUpThread(ThreadClass thread_class, const char *name) {
+  SetThreadName(name);
+  auto cpus = GetThreadClassCpus(thread_class);
+  if (cpus.empty()) return;
+  if (!PlaceThread(cpus)) {
+    BtsLogWarn("Failed to place thread %s on its CPUs", name);
+    return;
+  }
+  numa_node = NumaNodeOfCpu(cpus.front());
+}
+
+void StartThreadsOf(ThreadClass thread_class,
+                    const std::function<void()> &start) {
+#if defined(__linux__)
+  auto cpus = GetThreadClassCpus(thread_class);
+  cpu_set_t placement;
+  bool placed =
+      !cpus.empty() &&
+      pthread_getaffinity_np(pthread_self(), sizeof(placement), &placement) ==
+          0 &&
+      PlaceThread(cpus);
+  start();
+  if (placed) {
+    pthread_setaffinity_np(pthread_self(), sizeof(placement), &placement);
+  }
+#else
+  // Only Linux threads inherit the CPUs of the thread that creates them.
+  start();
+#endif
+}
+
+int CurrentNumaNode() {
+  if (numa_node == kUnknownNumaNode) numa_node = NumaNodeOfThread();
+  return numa_node;
+}
+
+bool SetThreadClassCpusCxx(uint32_t thread_class, const std::string &cpus) {
+  if (thread_class >= kNumThreadClasses) return false;
+  auto cpu_list = ParseCpuList(cpus);
+  if (!cpu_list) return false;
+  SetThreadClassCpus(static_cast<ThreadClass>(thread_class),
+                     std::move(*cpu_list));
+  return true;
+}
+
+}  // namespace util
+}  // namespace netsim
@@ -0,0 +1,76 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Names and CPU placement of the netsimd threads.
+
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace netsim {
+namespace util {
+
+// Classes of threads that are placed on the same CPUs. The values are the
+// thread_class of SetThreadClassCpusCxx.
+enum class ThreadClass : uint32_t {
+  // Bluetooth controllers: the AsyncManager task and fd watcher threads
+  kBluetooth = 0,
+  // WiFi service and slirp poll threads
+  kWifi = 1,
+  // gRPC server threads
+  kGrpc = 2,
+  // Federation links
+  kBackground = 3,
+};
+constexpr uint32_t kNumThreadClasses = 4;
+
+// NUMA node of the threads that are not placed on CPUs.
+constexpr int kDefaultNumaNode = 0;
+
+// Parses a CPU list in the format of /sys/devices/system/cpu/online, like
+// "0-3,8". Returns nullopt if it is malformed; an empty list is empty.
+std::optional<std::vector<int>> ParseCpuList(std::string_view cpu_list);
+
+// Sets the CPUs of the threads of a class that are set up from now on. An
+// empty list leaves them to the OS scheduler.
+void SetThreadClassCpus(ThreadClass thread_class, std::vector<int> cpus);
+std::vector<int> GetThreadClassCpus(ThreadClass thread_class);
+
+// Names the calling thread for profilers and debuggers, and places it on
+// the CPUs of its class. Names are cut to 15 characters.
+void SetUpThread(ThreadClass thread_class, const char *name);
+
+// Runs start with the calling thread placed on the CPUs of the class, for
+// the threads created by libraries, which inherit the placement of the
+// thread that creates them. The placement of the caller is restored after.
+void StartThreadsOf(ThreadClass thread_class,
+                    const std::function<void()> &start);
+
+// NUMA node of the first CPU the calling thread is placed on, or
+// kDefaultNumaNode. Threads placed by inheritance are looked up on their
+// first call. PacketPool keeps the storage of each node apart.
+int CurrentNumaNode();
+
+// Cxx functions for rust ffi. Returns false if cpus is malformed.
+bool SetThreadClassCpusCxx(uint32_t thread_class, const std::string &cpus);
+
+}  // namespace util
+}  // namespace netsim
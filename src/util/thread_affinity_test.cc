@@ -0,0 +1,93 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/thread_affinity.h"
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+using util::ParseCpuList;
+using util::ThreadClass;
+
+TEST(ThreadAffinityTest, ParseCpuList) {
+  EXPECT_EQ(ParseCpuList(""), std::vector<int>());
+  EXPECT_EQ(ParseCpuList("3"), std::vector<int>({3}));
+  EXPECT_EQ(ParseCpuList("0-3,8"), std::vector<int>({0, 1, 2, 3, 8}));
+  EXPECT_EQ(ParseCpuList(" 4 - 5 , 7 "), std::vector<int>({4, 5, 7}));
+}
+
+TEST(ThreadAffinityTest, ParseCpuListRejectsMalformed) {
+  EXPECT_FALSE(ParseCpuList("a"));
+  EXPECT_FALSE(ParseCpuList("3-1"));
+  EXPECT_FALSE(ParseCpuList("1,,2"));
+  EXPECT_FALSE(ParseCpuList("-2"));
+  EXPECT_FALSE(ParseCpuList("99999"));
+}
+
+TEST(ThreadAffinityTest, SetThreadClassCpusCxx) {
+  EXPECT_TRUE(util::SetThreadClassCpusCxx(
+      static_cast<uint32_t>(ThreadClass::kBackground), "0"));
+  EXPECT_EQ(util::GetThreadClassCpus(ThreadClass::kBackground),
+            std::vector<int>({0}));
+  EXPECT_FALSE(util::SetThreadClassCpusCxx(
+      static_cast<uint32_t>(ThreadClass::kBackground), "x"));
+  EXPECT_FALSE(util::SetThreadClassCpusCxx(util::kNumThreadClasses, "0"));
+  util::SetThreadClassCpus(ThreadClass::kBackground, {});
+}
+
+TEST(ThreadAffinityTest, UnplacedThreadsUseTheDefaultNode) {
+  std::thread([] {
+    util::SetUpThread(ThreadClass::kWifi, "netsim_test_thread");
+    EXPECT_EQ(util::CurrentNumaNode(), util::kDefaultNumaNode);
+  }).join();
+}
+
+TEST(ThreadAffinityTest, InheritedPlacementSetsTheNode) {
+  int last_cpu = std::max(1u, std::thread::hardware_concurrency()) - 1;
+  util::SetThreadClassCpus(ThreadClass::kGrpc, {last_cpu});
+  int set_up_node = -1;
+  std::thread([&set_up_node] {
+    util::SetUpThread(ThreadClass::kGrpc, "netsim_test_thread");
+    set_up_node = util::CurrentNumaNode();
+  }).join();
+  int inherited_node = -1;
+  std::thread inherited;
+  util::StartThreadsOf(ThreadClass::kGrpc, [&] {
+    inherited = std::thread(
+        [&inherited_node] { inherited_node = util::CurrentNumaNode(); });
+  });
+  inherited.join();
+  EXPECT_GE(set_up_node, 0);
+  EXPECT_EQ(inherited_node, set_up_node);
+  util::SetThreadClassCpus(ThreadClass::kGrpc, {});
+}
+
+TEST(ThreadAffinityTest, StartThreadsOfRunsStart) {
+  util::SetThreadClassCpus(ThreadClass::kGrpc, {0});
+  bool started = false;
+  util::StartThreadsOf(ThreadClass::kGrpc, [&started] { started = true; });
+  EXPECT_TRUE(started);
+  util::SetThreadClassCpus(ThreadClass::kGrpc, {});
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
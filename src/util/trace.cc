@@ -0,0 +1,252 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/trace.h"
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace netsim {
+namespace util {
+namespace {
+
+// Events kept per thread, the older ones are overwritten.
+constexpr size_t kEventsPerThread = 16384;
+
+struct TraceEvent {
+  const char *name;
+  uint64_t start_us;
+  // Duration of a scope, or the sample of a counter.
+  uint64_t value;
+  bool counter;
+};
+
+struct Totals {
+  const char *name;
+  uint64_t count;
+  uint64_t total;
+  uint64_t max;
+};
+
+/**
+ * @brief Events of a thread.
+ *
+ * Only its own thread records into it, so the mutex is uncontended except
+ * while a trace is read or cleared.
+ */
+struct ThreadTrace {
+  std::mutex mutex;
+  uint32_t tid;
+  std::string thread_name;
+  // Ring of kEventsPerThread events once full.
+  std::vector<TraceEvent> events;
+  uint64_t recorded = 0;
+  // Few names per thread, so a linear search is fastest.
+  std::vector<Totals> totals;
+
+  void Clear() {
+    events.clear();
+    recorded = 0;
+    totals.clear();
+  }
+};
+
+std::atomic<uint64_t> dropped_events{0};
+std::mutex threads_mutex;
+// Shared with the threads, a trace whose thread exited is only referenced
+// here and is kept until tracing is enabled again.
+auto *threads = new std::vector<std::shared_ptr<ThreadTrace>>();
+uint32_t next_tid = 1;
+
+std::string CurrentThreadName(uint32_t tid) {
+#if defined(__linux__) || defined(__APPLE__)
+  char name[16];
+  if (pthread_getname_np(pthread_self(), name, sizeof(name)) == 0 &&
+      name[0] != '\0') {
+    return name;
+  }
+#endif
+  return "thread " + std::to_string(tid);
+}
+
+struct ThreadTraceHolder {
+  std::shared_ptr<ThreadTrace> trace = std::make_shared<ThreadTrace>();
+  ThreadTraceHolder() {
+    std::lock_guard<std::mutex> lock(threads_mutex);
+    trace->tid = next_tid++;
+    trace->thread_name = CurrentThreadName(trace->tid);
+    threads->push_back(trace);
+  }
+  ~ThreadTraceHolder() { exited = true; }
+  // Trivially destructible, so it can be read after the destructor ran.
+  static thread_local bool exited;
+};
+
+thread_local bool ThreadTraceHolder::exited = false;
+
+// Returns nullptr once the thread is exiting.
+ThreadTrace *LocalTrace() {
+  if (ThreadTraceHolder::exited) return nullptr;
+  static thread_local ThreadTraceHolder holder;
+  return holder.trace.get();
+}
+
+void Record(const TraceEvent &event) {
+  auto *trace = LocalTrace();
+  if (!trace) return;
+  std::lock_guard<std::mutex> lock(trace->mutex);
+  if (trace->events.size() < kEventsPerThread) {
+    trace->events.push_back(event);
+  } else {
+    trace->events[trace->recorded % kEventsPerThread] = event;
+    dropped_events.fetch_add(1, std::memory_order_relaxed);
+  }
+  trace->recorded++;
+  auto totals = std::find_if(
+      trace->totals.begin(), trace->totals.end(),
+      [&event](const Totals &totals) { return totals.name == event.name; });
+  if (totals == trace->totals.end()) {
+    trace->totals.push_back({event.name, 0, 0, 0});
+    totals = trace->totals.end() - 1;
+  }
+  totals->count++;
+  totals->total += event.value;
+  totals->max = std::max(totals->max, event.value);
+}
+
+// Appends text as the contents of a JSON string.
+void AppendEscaped(std::string &json, const std::string &text) {
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      json += '\\';
+      json += c;
+    } else if (static_cast<unsigned char>(c) >= 0x20) {
+      json += c;
+    }
+  }
+}
+
+void AppendEvent(std::string &json, uint32_t tid, const TraceEvent &event) {
+  json += ",\n{\"name\":\"";
+  AppendEscaped(json, event.name);
+  json += event.counter ? "\",\"ph\":\"C\"" : "\",\"ph\":\"X\"";
+  json += ",\"ts\":" + std::to_string(event.start_us);
+  json += ",\"pid\":1,\"tid\":" + std::to_string(tid);
+  if (event.counter) {
+    json += ",\"args\":{\"value\":" + std::to_string(event.value) + "}}";
+  } else {
+    json += ",\"dur\":" + std::to_string(event.value) + "}";
+  }
+}
+
+std::vector<std::shared_ptr<ThreadTrace>> Threads() {
+  std::lock_guard<std::mutex> lock(threads_mutex);
+  return *threads;
+}
+
+}  // namespace
+
+void SetTracingEnabled(bool enabled) {
+  if (enabled && !TracingEnabled()) {
+    std::lock_guard<std::mutex> lock(threads_mutex);
+    threads->erase(std::remove_if(threads->begin(), threads->end(),
+                                  [](const auto &trace) {
+                                    return trace.use_count() == 1;
+                                  }),
+                   threads->end());
+    for (auto &trace : *threads) {
+      std::lock_guard<std::mutex> trace_lock(trace->mutex);
+      trace->Clear();
+    }
+    dropped_events.store(0, std::memory_order_relaxed);
+  }
+  tracing_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t TraceNowUs() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void TraceComplete(const char *name, uint64_t start_us, uint64_t duration_us) {
+  Record({name, start_us, duration_us, false});
+}
+
+void TraceCounter(const char *name, uint64_t value) {
+  if (!TracingEnabled()) return;
+  Record({name, TraceNowUs(), value, true});
+}
+
+std::vector<TraceCounterStats> GetTraceCounters() {
+  std::map<std::string, TraceCounterStats> by_name;
+  for (const auto &trace : Threads()) {
+    std::lock_guard<std::mutex> lock(trace->mutex);
+    for (const auto &totals : trace->totals) {
+      auto [it, inserted] = by_name.try_emplace(
+          totals.name, TraceCounterStats{totals.name, 0, 0, 0});
+      auto &stats = it->second;
+      stats.count += totals.count;
+      stats.total += totals.total;
+      stats.max = std::max(stats.max, totals.max);
+    }
+  }
+  std::vector<TraceCounterStats> result;
+  result.reserve(by_name.size());
+  for (auto &[name, stats] : by_name) result.push_back(std::move(stats));
+  return result;
+}
+
+std::string GetTraceJson() {
+  std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+  json += "\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,";
+  json += "\"args\":{\"name\":\"netsimd\"}}";
+  for (const auto &trace : Threads()) {
+    std::lock_guard<std::mutex> lock(trace->mutex);
+    if (trace->events.empty()) continue;
+    json += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+    json += std::to_string(trace->tid) + ",\"args\":{\"name\":\"";
+    AppendEscaped(json, trace->thread_name);
+    json += "\"}}";
+    // Oldest first, from the slot the next event overwrites.
+    auto first = trace->events.size() < kEventsPerThread
+                     ? 0
+                     : trace->recorded % kEventsPerThread;
+    for (size_t i = 0; i < trace->events.size(); i++) {
+      AppendEvent(json, trace->tid,
+                  trace->events[(first + i) % trace->events.size()]);
+    }
+  }
+  json += "\n]}\n";
+  return json;
+}
+
+uint64_t TraceDroppedEvents() {
+  return dropped_events.load(std::memory_order_relaxed);
+}
+
+}  // namespace util
+}  // namespace netsim
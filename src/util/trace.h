@@ -0,0 +1,97 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Trace events of the packet paths, recorded while tracing is enabled.
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace netsim {
+namespace util {
+
+// Read with a relaxed load by every trace point, so a trace point costs a
+// predicted branch while tracing is disabled.
+inline std::atomic<bool> tracing_enabled{false};
+
+inline bool TracingEnabled() {
+  return tracing_enabled.load(std::memory_order_relaxed);
+}
+
+// Enabling tracing drops the events and counters recorded before.
+void SetTracingEnabled(bool enabled);
+
+// Microseconds of the clock of the trace events.
+uint64_t TraceNowUs();
+
+// Records that the calling thread spent duration_us in name from start_us.
+// name must be a string literal, or otherwise live forever.
+void TraceComplete(const char *name, uint64_t start_us, uint64_t duration_us);
+
+// Records a sample of a counter, like a queue depth.
+void TraceCounter(const char *name, uint64_t value);
+
+/**
+ * @brief Records the lifetime of the scope as a trace event.
+ *
+ * The clock is only read if tracing is enabled when the scope starts.
+ */
+class ScopedTrace {
+ public:
+  explicit ScopedTrace(const char *name)
+      : name_(name), start_us_(TracingEnabled() ? TraceNowUs() : 0) {}
+  ~ScopedTrace() {
+    if (start_us_ != 0) {
+      TraceComplete(name_, start_us_, TraceNowUs() - start_us_);
+    }
+  }
+  ScopedTrace(const ScopedTrace &) = delete;
+  ScopedTrace &operator=(const ScopedTrace &) = delete;
+
+ private:
+  const char *const name_;
+  const uint64_t start_us_;
+};
+
+#define NETSIM_TRACE_CONCAT_(a, b) a##b
+#define NETSIM_TRACE_CONCAT(a, b) NETSIM_TRACE_CONCAT_(a, b)
+#define NETSIM_TRACE_SCOPE(name)                                 \
+  ::netsim::util::ScopedTrace NETSIM_TRACE_CONCAT(netsim_trace_, \
+                                                  __LINE__)(name)
+
+// Totals of the events of a name since tracing was enabled. For scopes the
+// values are durations in microseconds, for counters the samples.
+struct TraceCounterStats {
+  std::string name;
+  uint64_t count = 0;
+  uint64_t total = 0;
+  uint64_t max = 0;
+};
+
+std::vector<TraceCounterStats> GetTraceCounters();
+
+// Returns the recorded events in the Chrome trace event format, which
+// Perfetto and chrome://tracing open.
+std::string GetTraceJson();
+
+// Events overwritten because a thread recorded more than it keeps.
+uint64_t TraceDroppedEvents();
+
+}  // namespace util
+}  // namespace netsim
@@ -0,0 +1,105 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "util/trace.h"
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim {
+namespace testing {
+namespace {
+
+class TraceTest : public ::testing::Test {
+ protected:
+  void SetUp() override { util::SetTracingEnabled(true); }
+  void TearDown() override { util::SetTracingEnabled(false); }
+};
+
+const util::TraceCounterStats *FindCounter(
+    const std::vector<util::TraceCounterStats> &counters,
+    const std::string &name) {
+  for (const auto &counter : counters) {
+    if (counter.name == name) return &counter;
+  }
+  return nullptr;
+}
+
+TEST_F(TraceTest, DisabledTracingRecordsNothing) {
+  util::SetTracingEnabled(false);
+  { NETSIM_TRACE_SCOPE("test_disabled"); }
+  util::TraceCounter("test_disabled_counter", 3);
+  auto counters = util::GetTraceCounters();
+  EXPECT_EQ(FindCounter(counters, "test_disabled"), nullptr);
+  EXPECT_EQ(FindCounter(counters, "test_disabled_counter"), nullptr);
+}
+
+TEST_F(TraceTest, ScopesAndCountersAreTotaled) {
+  for (int i = 0; i < 3; i++) {
+    NETSIM_TRACE_SCOPE("test_scope");
+  }
+  util::TraceCounter("test_depth", 4);
+  util::TraceCounter("test_depth", 10);
+
+  auto counters = util::GetTraceCounters();
+  auto scope = FindCounter(counters, "test_scope");
+  ASSERT_NE(scope, nullptr);
+  EXPECT_EQ(scope->count, 3);
+  auto depth = FindCounter(counters, "test_depth");
+  ASSERT_NE(depth, nullptr);
+  EXPECT_EQ(depth->count, 2);
+  EXPECT_EQ(depth->total, 14);
+  EXPECT_EQ(depth->max, 10);
+}
+
+TEST_F(TraceTest, EnablingClearsTheTrace) {
+  { NETSIM_TRACE_SCOPE("test_cleared"); }
+  util::SetTracingEnabled(false);
+  util::SetTracingEnabled(true);
+  EXPECT_EQ(FindCounter(util::GetTraceCounters(), "test_cleared"), nullptr);
+}
+
+TEST_F(TraceTest, TraceJsonHasTheEventsOfEveryThread) {
+  util::TraceComplete("test_main", 100, 5);
+  std::thread([] {
+    util::TraceCounter("test_other", 7);
+  }).join();
+
+  auto json = util::GetTraceJson();
+  EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0);
+  EXPECT_NE(json.find("{\"name\":\"test_main\",\"ph\":\"X\",\"ts\":100,"),
+            std::string::npos);
+  EXPECT_NE(json.find("\"dur\":5}"), std::string::npos);
+  EXPECT_NE(json.find("{\"name\":\"test_other\",\"ph\":\"C\""),
+            std::string::npos);
+  EXPECT_NE(json.find("\"args\":{\"value\":7}}"), std::string::npos);
+  EXPECT_NE(json.find("\"thread_name\""), std::string::npos);
+}
+
+TEST_F(TraceTest, KeepsTheLastEventsOfAThread) {
+  std::thread([] {
+    for (int i = 0; i < 20000; i++) util::TraceCounter("test_ring", i);
+  }).join();
+  EXPECT_EQ(util::TraceDroppedEvents(), 20000 - 16384);
+  auto json = util::GetTraceJson();
+  EXPECT_EQ(json.find("\"args\":{\"value\":0}}"), std::string::npos);
+  EXPECT_NE(json.find("\"args\":{\"value\":19999}}"), std::string::npos);
+}
+
+}  // namespace
+}  // namespace testing
+}  // namespace netsim
@@ -0,0 +1,41 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "uwb/uci.h"
+
+namespace netsim::uwb::uci {
+
+std::optional<Header> ParseHeader(const uint8_t *packet, size_t size) {
+  if (size < kHeaderSize) return std::nullopt;
+  uint8_t message_type = packet[0] >> 5;
+  if (message_type > static_cast<uint8_t>(MessageType::kNotification)) {
+    return std::nullopt;
+  }
+  Header header;
+  header.message_type = static_cast<MessageType>(message_type);
+  header.segmented = (packet[0] & 0x10) != 0;
+  header.group_id = packet[0] & 0x0f;
+  if (header.message_type == MessageType::kData) {
+    // Data packets have a 16 bit little endian payload length.
+    header.opcode_id = 0;
+    header.payload_length = packet[2] | (packet[3] << 8);
+  } else {
+    header.opcode_id = packet[1] & 0x3f;
+    header.payload_length = packet[3];
+  }
+  if (size < kHeaderSize + header.payload_length) return std::nullopt;
+  return header;
+}
+
+}  // namespace netsim::uwb::uci
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Header of UCI packets, the packets exchanged between a UWB host and its
+// controller, see the UCI Generic Specification 2.3 "Packet Format".
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace netsim::uwb::uci {
+
+enum class MessageType : uint8_t {
+  kData = 0,
+  kCommand = 1,
+  kResponse = 2,
+  kNotification = 3,
+};
+
+constexpr size_t kHeaderSize = 4;
+
+struct Header {
+  MessageType message_type;
+  // Set on the segments of a message but the last (PBF).
+  bool segmented;
+  // The group (GID) of control packets, the format (DPF) of data packets.
+  uint8_t group_id;
+  // Opcode (OID) of control packets, 0 for data packets.
+  uint8_t opcode_id;
+  size_t payload_length;
+};
+
+// Returns the header of a packet, or nullopt if the packet is shorter than
+// its header says or its message type is reserved.
+std::optional<Header> ParseHeader(const uint8_t *packet, size_t size);
+
+}  // namespace netsim::uwb::uci
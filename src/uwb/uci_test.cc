@@ -0,0 +1,67 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the UCI header accessors.
+#include "uwb/uci.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim::uwb::uci {
+namespace {
+
+TEST(UciTest, CommandHeader) {
+  // CORE_GET_DEVICE_INFO_CMD.
+  std::vector<uint8_t> command = {0x20, 0x02, 0x00, 0x00};
+  auto header = ParseHeader(command.data(), command.size());
+  ASSERT_TRUE(header.has_value());
+  EXPECT_EQ(header->message_type, MessageType::kCommand);
+  EXPECT_FALSE(header->segmented);
+  EXPECT_EQ(header->group_id, 0);
+  EXPECT_EQ(header->opcode_id, 2);
+  EXPECT_EQ(header->payload_length, 0u);
+}
+
+TEST(UciTest, DataHeaderHasLongLength) {
+  std::vector<uint8_t> data = {0x01, 0x00, 0x04, 0x01};
+  data.resize(kHeaderSize + 0x104);
+  auto header = ParseHeader(data.data(), data.size());
+  ASSERT_TRUE(header.has_value());
+  EXPECT_EQ(header->message_type, MessageType::kData);
+  // DATA_MESSAGE_SND.
+  EXPECT_EQ(header->group_id, 1);
+  EXPECT_EQ(header->payload_length, 0x104u);
+}
+
+TEST(UciTest, SegmentedNotification) {
+  std::vector<uint8_t> notification = {0x72, 0x00, 0x00, 0x01, 0xaa};
+  auto header = ParseHeader(notification.data(), notification.size());
+  ASSERT_TRUE(header.has_value());
+  EXPECT_EQ(header->message_type, MessageType::kNotification);
+  EXPECT_TRUE(header->segmented);
+  EXPECT_EQ(header->group_id, 2);
+}
+
+TEST(UciTest, RejectsTruncatedAndReserved) {
+  std::vector<uint8_t> truncated = {0x20, 0x02, 0x00, 0x02, 0x00};
+  EXPECT_FALSE(ParseHeader(truncated.data(), truncated.size()).has_value());
+  EXPECT_FALSE(ParseHeader(truncated.data(), 3).has_value());
+  std::vector<uint8_t> reserved = {0xe0, 0x00, 0x00, 0x00};
+  EXPECT_FALSE(ParseHeader(reserved.data(), reserved.size()).has_value());
+}
+
+}  // namespace
+}  // namespace netsim::uwb::uci
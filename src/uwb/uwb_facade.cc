@@ -0,0 +1,217 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "uwb/uwb_facade.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "netsim-daemon/src/ffi.rs.h"
+#include "rust/cxx.h"
+#include "util/flight_recorder.h"
+#include "util/log.h"
+#include "util/packet_pool.h"
+#include "util/serialized_cache.h"
+#include "util/trace.h"
+#include "uwb/uci.h"
+#include "uwb/uwb_packet_hub.h"
+
+namespace netsim::uwb {
+namespace {
+// To detect bugs of misuse of chip_id more efficiently.
+const int kGlobalChipStartIndex = 3000;
+
+class ChipInfo {
+ public:
+  uint32_t simulation_device;
+  // Radio state, guarded by mutex_. The counters are kept out of the model
+  // so the packet paths can update them without the lock.
+  std::shared_ptr<model::Chip::Radio> model;
+  std::atomic<int32_t> tx_count{0};
+  std::atomic<int32_t> rx_count{0};
+  // Bumped after every change of the model state.
+  std::atomic<uint64_t> version{0};
+  // Serialized model for GetCxx, valid for a version and counters.
+  util::SerializedCache<std::tuple<uint64_t, int32_t, int32_t>> serialized;
+  // Packets sent and received by the chip.
+  std::shared_ptr<util::FlightRecorder> recorder;
+
+  ChipInfo(uint32_t simulation_device,
+           std::shared_ptr<model::Chip::Radio> model)
+      : simulation_device(simulation_device), model(std::move(model)) {}
+};
+
+// Guards the chips and their models.
+std::mutex mutex_;
+std::unordered_map<uint32_t, std::shared_ptr<ChipInfo>> id_to_chip_info_;
+
+bool ChangedState(model::State a, model::State b) {
+  return (b != model::State::UNKNOWN && a != b);
+}
+
+// Returns the chip if it is known and its radio is not OFF.
+std::shared_ptr<ChipInfo> FindEnabledChip(uint32_t id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = id_to_chip_info_.find(id);
+  if (it == id_to_chip_info_.end()) {
+    BtsLogWarnRateLimited("Failed to get UWB state with unknown facade %d",
+                          id);
+    return nullptr;
+  }
+  if (it->second->model->state() == model::State::OFF) return nullptr;
+  return it->second;
+}
+
+}  // namespace
+
+namespace facade {
+
+void Reset(uint32_t id) {
+  BtsLog("uwb::facade::Reset(%d)", id);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = id_to_chip_info_.find(id); it != id_to_chip_info_.end()) {
+    auto chip_info = it->second;
+    chip_info->model->set_state(model::State::ON);
+    chip_info->tx_count.store(0, std::memory_order_relaxed);
+    chip_info->rx_count.store(0, std::memory_order_relaxed);
+    chip_info->version.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void Remove(uint32_t id) {
+  BtsLog("uwb::facade::Remove(%d)", id);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    id_to_chip_info_.erase(id);
+  }
+  util::ReleaseFlightRecorder(common::ChipKind::UWB, id);
+}
+
+void Patch(uint32_t id, const model::Chip::Radio &request) {
+  BtsLog("uwb::facade::Patch(%d)", id);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = id_to_chip_info_.find(id);
+  if (it == id_to_chip_info_.end()) {
+    BtsLogWarn("Patch an unknown facade_id: %d", id);
+    return;
+  }
+  auto &model = it->second->model;
+  if (ChangedState(model->state(), request.state())) {
+    model->set_state(request.state());
+    it->second->version.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+model::Chip::Radio Get(uint32_t id) {
+  BtsLog("uwb::facade::Get(%d)", id);
+  model::Chip::Radio radio;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (auto it = id_to_chip_info_.find(id); it != id_to_chip_info_.end()) {
+    radio.CopyFrom(*it->second->model);
+    radio.set_tx_count(it->second->tx_count.load(std::memory_order_relaxed));
+    radio.set_rx_count(it->second->rx_count.load(std::memory_order_relaxed));
+  }
+  return radio;
+}
+
+void PatchCxx(uint32_t id,
+              const rust::Slice<::std::uint8_t const> proto_bytes) {
+  model::Chip::Radio radio;
+  radio.ParseFromArray(proto_bytes.data(), proto_bytes.size());
+  Patch(id, radio);
+}
+
+rust::Vec<uint8_t> GetCxx(uint32_t id) {
+  std::shared_ptr<ChipInfo> chip_info;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = id_to_chip_info_.find(id);
+    if (it == id_to_chip_info_.end()) return {};
+    chip_info = it->second;
+  }
+  // Re-encode only when the model or the counters changed since the last
+  // poll.
+  auto version =
+      std::make_tuple(chip_info->version.load(std::memory_order_relaxed),
+                      chip_info->tx_count.load(std::memory_order_relaxed),
+                      chip_info->rx_count.load(std::memory_order_relaxed));
+  auto bytes = chip_info->serialized.Get(version, [&](std::string &bytes) {
+    model::Chip::Radio radio;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      radio.CopyFrom(*chip_info->model);
+    }
+    radio.set_tx_count(std::get<1>(version));
+    radio.set_rx_count(std::get<2>(version));
+    radio.SerializeToString(&bytes);
+  });
+  return VecFromSlice({reinterpret_cast<const uint8_t *>(bytes->data()),
+                       bytes->size()});
+}
+
+uint32_t Add(uint32_t simulation_device) {
+  BtsLog("uwb::facade::Add(%d)", simulation_device);
+  static uint32_t global_chip_id = kGlobalChipStartIndex;
+
+  auto model = std::make_shared<model::Chip::Radio>();
+  model->set_state(model::State::ON);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto chip_info = std::make_shared<ChipInfo>(simulation_device, model);
+  chip_info->recorder =
+      util::GetFlightRecorder(common::ChipKind::UWB, global_chip_id);
+  id_to_chip_info_.emplace(global_chip_id, std::move(chip_info));
+
+  return global_chip_id++;
+}
+
+}  // namespace facade
+
+void HandleUwbRequest(uint32_t facade_id,
+                      const std::shared_ptr<std::vector<uint8_t>> &packet) {
+  NETSIM_TRACE_SCOPE("uwb::HandleUwbRequest");
+  auto chip_info = FindEnabledChip(facade_id);
+  if (!chip_info) return;
+  chip_info->tx_count.fetch_add(1, std::memory_order_relaxed);
+  chip_info->recorder->Record(false, 0, packet->data(), packet->size());
+  auto header = uci::ParseHeader(packet->data(), packet->size());
+  if (!header.has_value()) {
+    BtsLogWarnRateLimited("Malformed UCI packet from facade_id: %d",
+                          facade_id);
+    return;
+  }
+  // Packets of a host are for its controller, and the other hosts expect
+  // controller packets, such as DATA_MESSAGE_RCV with the source address
+  // and session of the receiver. Until there is a UCI controller model to
+  // answer and convert them, they are counted and dropped.
+  BtsLogWarnRateLimited(
+      "No UCI controller model for the packets of facade_id: %d", facade_id);
+}
+
+void HandleUwbRequestCxx(uint32_t facade_id,
+                         const rust::Vec<uint8_t> &packet) {
+  auto packet_ptr = util::PacketPool::Copy(packet.data(), packet.size());
+  HandleUwbRequest(facade_id, packet_ptr);
+}
+
+void HandleUwbRequestBufferCxx(uint32_t facade_id,
+                               const util::PacketBuffer &packet) {
+  HandleUwbRequest(facade_id, packet.Share());
+}
+
+}  // namespace netsim::uwb
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+#include <cstdint>
+
+#include "netsim/model.pb.h"
+#include "rust/cxx.h"
+
+/** Manages the UWB chips and their UCI packets.
+ *
+ * The packets of the chips are counted and recorded, but not answered or
+ * forwarded: there is no UCI controller model yet.
+ */
+
+namespace netsim::uwb::facade {
+
+void Reset(uint32_t);
+void Remove(uint32_t);
+void Patch(uint32_t, const model::Chip::Radio &);
+model::Chip::Radio Get(uint32_t);
+uint32_t Add(uint32_t simulation_device);
+
+// Cxx functions for rust ffi.
+void PatchCxx(uint32_t, const rust::Slice<::std::uint8_t const> _proto_bytes);
+rust::Vec<uint8_t> GetCxx(uint32_t);
+
+}  // namespace netsim::uwb::facade
@@ -0,0 +1,123 @@
+// Copyright 2022 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the UWB facade.
+
+#include "uwb/uwb_facade.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "uwb/uwb_packet_hub.h"
+
+namespace netsim::uwb::facade {
+namespace {
+
+// DATA_MESSAGE_SND with a 2 octet payload.
+std::shared_ptr<std::vector<uint8_t>> DataPacket() {
+  return std::make_shared<std::vector<uint8_t>>(
+      std::vector<uint8_t>{0x01, 0x00, 0x02, 0x00, 0xaa, 0xbb});
+}
+
+// CORE_GET_DEVICE_INFO_CMD.
+std::shared_ptr<std::vector<uint8_t>> CommandPacket() {
+  return std::make_shared<std::vector<uint8_t>>(
+      std::vector<uint8_t>{0x20, 0x02, 0x00, 0x00});
+}
+
+}  // namespace
+
+class UwbFacadeTest : public ::testing::Test {
+ protected:
+  void TearDown() {
+    for (auto facade_id : facade_ids_) Remove(facade_id);
+  }
+
+  uint32_t AddChip() {
+    auto facade_id = Add(SIMULATION_DEVICE + facade_ids_.size());
+    facade_ids_.push_back(facade_id);
+    return facade_id;
+  }
+
+  const int SIMULATION_DEVICE = 123;
+  std::vector<uint32_t> facade_ids_;
+};
+
+TEST_F(UwbFacadeTest, AddAndGetTest) {
+  auto facade_id = AddChip();
+
+  auto radio = Get(facade_id);
+  EXPECT_EQ(model::State::ON, radio.state());
+  EXPECT_EQ(0, radio.tx_count());
+  EXPECT_EQ(0, radio.rx_count());
+}
+
+TEST_F(UwbFacadeTest, RemoveTest) {
+  auto facade_id = AddChip();
+
+  Remove(facade_id);
+
+  auto radio = Get(facade_id);
+  EXPECT_EQ(model::State::UNKNOWN, radio.state());
+}
+
+TEST_F(UwbFacadeTest, PatchTest) {
+  auto facade_id = AddChip();
+
+  model::Chip::Radio request;
+  request.set_state(model::State::OFF);
+  Patch(facade_id, request);
+
+  auto radio = Get(facade_id);
+  EXPECT_EQ(model::State::OFF, radio.state());
+}
+
+TEST_F(UwbFacadeTest, ResetTest) {
+  auto facade_id = AddChip();
+  HandleUwbRequest(facade_id, DataPacket());
+
+  Reset(facade_id);
+
+  auto radio = Get(facade_id);
+  EXPECT_EQ(model::State::ON, radio.state());
+  EXPECT_EQ(0, radio.tx_count());
+  EXPECT_EQ(0, radio.rx_count());
+}
+
+TEST_F(UwbFacadeTest, HostPacketsAreNotForwarded) {
+  auto sender = AddChip();
+  auto receiver = AddChip();
+
+  HandleUwbRequest(sender, DataPacket());
+  HandleUwbRequest(sender, CommandPacket());
+
+  EXPECT_EQ(2, Get(sender).tx_count());
+  EXPECT_EQ(0, Get(sender).rx_count());
+  EXPECT_EQ(0, Get(receiver).rx_count());
+}
+
+TEST_F(UwbFacadeTest, OffChipsDoNotSend) {
+  auto chip = AddChip();
+  model::Chip::Radio off;
+  off.set_state(model::State::OFF);
+  Patch(chip, off);
+
+  HandleUwbRequest(chip, DataPacket());
+
+  EXPECT_EQ(0, Get(chip).tx_count());
+}
+
+}  // namespace netsim::uwb::facade
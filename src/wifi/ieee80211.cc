@@ -0,0 +1,58 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "wifi/ieee80211.h"
+
+namespace netsim::wifi::ieee80211 {
+namespace {
+
+// Frame control (2), duration (2), then the addresses.
+constexpr size_t kAddress1Offset = 4;
+constexpr size_t kAddress2Offset = 10;
+constexpr size_t kAddressLength = 6;
+
+// Frame type, bits 2-3 of the first frame control octet.
+constexpr uint8_t kTypeControl = 1;
+constexpr uint8_t kTypeExtension = 3;
+
+MacAddress ReadAddress(const uint8_t *bytes) {
+  MacAddress address = 0;
+  for (size_t i = 0; i < kAddressLength; i++) {
+    address = (address << 8) | bytes[i];
+  }
+  return address;
+}
+
+}  // namespace
+
+bool IsGroupAddress(MacAddress address) {
+  // Individual/group bit of the first octet.
+  return (address >> 40) & 0x01;
+}
+
+std::optional<MacAddress> GetReceiverAddress(const uint8_t *frame,
+                                             size_t size) {
+  if (size < kAddress1Offset + kAddressLength) return std::nullopt;
+  return ReadAddress(frame + kAddress1Offset);
+}
+
+std::optional<MacAddress> GetTransmitterAddress(const uint8_t *frame,
+                                                size_t size) {
+  if (size < kAddress2Offset + kAddressLength) return std::nullopt;
+  uint8_t type = (frame[0] >> 2) & 0x03;
+  if (type == kTypeControl || type == kTypeExtension) return std::nullopt;
+  return ReadAddress(frame + kAddress2Offset);
+}
+
+}  // namespace netsim::wifi::ieee80211
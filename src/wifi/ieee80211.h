@@ -0,0 +1,43 @@
+/*
+ * Copyright 2023 The Android Open Source Project
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Accessors for the addresses of IEEE 802.11 MAC frames, used to route
+// frames between the WiFi chips and the WiFi service.
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace netsim::wifi::ieee80211 {
+
+// A 48 bit MAC address in the low bytes, first octet most significant.
+using MacAddress = uint64_t;
+
+// Returns true for broadcast and multicast addresses.
+bool IsGroupAddress(MacAddress address);
+
+// Returns the receiver address (Address 1) of a frame.
+std::optional<MacAddress> GetReceiverAddress(const uint8_t *frame,
+                                             size_t size);
+
+// Returns the transmitter address (Address 2) of a management or data
+// frame. Control frames are skipped: most of them carry no transmitter.
+std::optional<MacAddress> GetTransmitterAddress(const uint8_t *frame,
+                                                size_t size);
+
+}  // namespace netsim::wifi::ieee80211
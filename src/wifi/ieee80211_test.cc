@@ -0,0 +1,63 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Unit tests for the IEEE 802.11 frame accessors.
+#include "wifi/ieee80211.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace netsim::wifi::ieee80211 {
+namespace {
+
+// QoS data frame from 02:15:b2:00:00:01 to 02:15:b2:00:00:02.
+const std::vector<uint8_t> kDataFrame = {
+    0x88, 0x02, 0x2c, 0x00, 0x02, 0x15, 0xb2, 0x00, 0x00, 0x02, 0x02, 0x15,
+    0xb2, 0x00, 0x00, 0x01, 0x02, 0x15, 0xb2, 0x00, 0x00, 0x03, 0x10, 0x00};
+
+TEST(Ieee80211Test, DataFrameAddresses) {
+  EXPECT_EQ(GetReceiverAddress(kDataFrame.data(), kDataFrame.size()),
+            0x0215b2000002u);
+  EXPECT_EQ(GetTransmitterAddress(kDataFrame.data(), kDataFrame.size()),
+            0x0215b2000001u);
+  EXPECT_FALSE(IsGroupAddress(0x0215b2000002u));
+}
+
+TEST(Ieee80211Test, BeaconIsBroadcast) {
+  std::vector<uint8_t> beacon = {0x80, 0x00, 0x00, 0x00, 0xff, 0xff,
+                                 0xff, 0xff, 0xff, 0xff, 0x02, 0x15,
+                                 0xb2, 0x00, 0x00, 0x00};
+  auto receiver = GetReceiverAddress(beacon.data(), beacon.size());
+  ASSERT_TRUE(receiver.has_value());
+  EXPECT_TRUE(IsGroupAddress(*receiver));
+  EXPECT_EQ(GetTransmitterAddress(beacon.data(), beacon.size()),
+            0x0215b2000000u);
+  // IPv6 multicast.
+  EXPECT_TRUE(IsGroupAddress(0x333300000001u));
+}
+
+TEST(Ieee80211Test, ControlAndShortFrames) {
+  // ACK frames only carry a receiver address.
+  std::vector<uint8_t> ack = {0xd4, 0x00, 0x00, 0x00, 0x02,
+                              0x15, 0xb2, 0x00, 0x00, 0x01};
+  EXPECT_EQ(GetReceiverAddress(ack.data(), ack.size()), 0x0215b2000001u);
+  EXPECT_FALSE(GetTransmitterAddress(ack.data(), ack.size()).has_value());
+  EXPECT_FALSE(GetReceiverAddress(ack.data(), 9).has_value());
+  EXPECT_FALSE(GetTransmitterAddress(kDataFrame.data(), 15).has_value());
+}
+
+}  // namespace
+}  // namespace netsim::wifi::ieee80211
@@ -14,36 +14,108 @@
 
 #include "wifi/wifi_facade.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
 
+#include "core/federation.h"
 #include "netsim-daemon/src/ffi.rs.h"
 #include "netsim/config.pb.h"
 #include "netsim/hci_packet.pb.h"
 #include "rust/cxx.h"
+#include "util/chip_snapshot.h"
+#include "util/flight_recorder.h"
 #include "util/log.h"
+#include "util/packet_pool.h"
+#include "util/serialized_cache.h"
+#include "util/thread_affinity.h"
+#include "wifi/ieee80211.h"
 #ifdef NETSIM_ANDROID_EMULATOR
 #include "android-qemu2-glue/emulation/WifiService.h"
+#include "android-qemu2-glue/netsim/libslirp_driver.h"
 #endif
 
 namespace netsim::wifi {
 namespace {
 // To detect bugs of misuse of chip_id more efficiently.
 const int kGlobalChipStartIndex = 2000;
+// Marks a station address seen from more than one chip, for example
+// emulators started with the same MAC, so its frames are broadcast.
+const uint32_t kSharedStation = 0;
+// Cadence of the slirp poll thread while frames flow. Each poll without
+// traffic doubles the wait, up to kMaxSlirpPollIntervalMs.
+const uint32_t kDefaultSlirpPollIntervalMs = 1;
+const uint32_t kMaxSlirpPollIntervalMs = 50;
 
 class ChipInfo {
  public:
   uint32_t simulation_device;
+  // Radio state, guarded by mutex_. The counters are kept out of the model
+  // so the packet paths can update them without the lock.
   std::shared_ptr<model::Chip::Radio> model;
+  std::atomic<int32_t> tx_count{0};
+  std::atomic<int32_t> rx_count{0};
+  // Bumped after every change of the model state.
+  std::atomic<uint64_t> version{0};
+  // Serialized model for GetCxx, valid for a version and counters.
+  util::SerializedCache<std::tuple<uint64_t, int32_t, int32_t>> serialized;
+  // Key of the chip in util::SnapshotStore, empty when not kept.
+  std::string snapshot_key;
+  // Frames sent and received by the chip.
+  std::shared_ptr<util::FlightRecorder> recorder;
 
   ChipInfo(uint32_t simulation_device,
-           std::shared_ptr<model::Chip::Radio> model)
-      : simulation_device(simulation_device), model(std::move(model)) {}
+           std::shared_ptr<model::Chip::Radio> model, std::string snapshot_key)
+      : simulation_device(simulation_device),
+        model(std::move(model)),
+        snapshot_key(std::move(snapshot_key)) {}
 };
 
+// The chips that receive the frames of the WiFi service. Rebuilt when a
+// chip is added, removed or changes state, so that delivering a frame does
+// no lookups.
+struct Receivers {
+  std::vector<uint32_t> facade_ids;
+  std::vector<std::shared_ptr<ChipInfo>> chip_infos;
+};
+
+// Guards the chips and their models.
+std::mutex mutex_;
 std::unordered_map<uint32_t, std::shared_ptr<ChipInfo>> id_to_chip_info_;
+std::shared_ptr<const Receivers> receivers_ = std::make_shared<Receivers>();
+// Frames waiting to be sent to the WiFi service, guarded by tx_mutex_.
+std::mutex tx_mutex_;
+std::vector<std::shared_ptr<std::vector<uint8_t>>> tx_queue_;
+bool tx_flushing_ = false;
+// Station addresses learned from the frames sent by the chips, used to
+// deliver unicast frames of the WiFi service to a single chip.
+std::unordered_map<ieee80211::MacAddress, uint32_t> station_to_facade_id_;
+// Station addresses of the chips of other nodes by node id, learned on the
+// WiFi medium node from the frames the nodes forward.
+std::unordered_map<ieee80211::MacAddress, uint32_t> station_to_node_id_;
 #ifdef NETSIM_ANDROID_EMULATOR
 std::shared_ptr<android::qemu2::WifiService> wifi_service;
+// Serializes the calls into the WiFi service and slirp, which are not
+// thread safe, between the TX flush and the slirp poll thread.
+std::mutex service_mutex_;
+// Slirp poll thread, stopped by setting slirp_stop_ under slirp_mutex_.
+std::mutex slirp_mutex_;
+std::condition_variable slirp_cv_;
+bool slirp_stop_ = false;
+// Set by the TX and RX paths, cleared by the poll thread, which polls at
+// its base interval again after traffic.
+std::atomic<bool> slirp_active_{false};
+std::thread slirp_thread_;
 #endif
 ;
 
@@ -51,49 +123,249 @@ bool ChangedState(model::State a, model::State b) {
   return (b != model::State::UNKNOWN && a != b);
 }
 
-std::optional<model::State> GetState(uint32_t id) {
-  if (auto it = id_to_chip_info_.find(id); it != id_to_chip_info_.end()) {
-    auto &model = it->second->model;
-    return model->state();
+void UpdateReceiversLocked() {
+  auto receivers = std::make_shared<Receivers>();
+  for (const auto &[facade_id, chip_info] : id_to_chip_info_) {
+    if (chip_info->model->state() == model::State::OFF) continue;
+    receivers->facade_ids.push_back(facade_id);
+    receivers->chip_infos.push_back(chip_info);
   }
-  BtsLogWarn("Failed to get WiFi state with unknown facade %d", id);
-  return std::nullopt;
+  receivers_ = std::move(receivers);
 }
 
-void IncrTx(uint32_t id) {
-  if (auto it = id_to_chip_info_.find(id); it != id_to_chip_info_.end()) {
-    auto &model = it->second->model;
-    model->set_tx_count(model->tx_count() + 1);
+util::ChipSnapshot SnapshotOfLocked(const ChipInfo &chip_info) {
+  util::ChipSnapshot snapshot;
+  snapshot.model = chip_info.model->SerializeAsString();
+  return snapshot;
+}
+
+void LearnStationLocked(ieee80211::MacAddress station, uint32_t id) {
+  auto [it, inserted] = station_to_facade_id_.emplace(station, id);
+  if (!inserted && it->second != id && it->second != kSharedStation) {
+    BtsLogWarn("WiFi station %012llx is used by facades %d and %d",
+               static_cast<unsigned long long>(station), it->second, id);
+    it->second = kSharedStation;
   }
 }
 
-void IncrRx(uint32_t id) {
-  if (auto it = id_to_chip_info_.find(id); it != id_to_chip_info_.end()) {
-    auto &model = it->second->model;
-    model->set_rx_count(model->rx_count() + 1);
+// Returns the chip if it is known and its radio is not OFF, and records
+// station as one of its addresses.
+std::shared_ptr<ChipInfo> FindEnabledChip(
+    uint32_t id, std::optional<ieee80211::MacAddress> station) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = id_to_chip_info_.find(id);
+  if (it == id_to_chip_info_.end()) {
+    BtsLogWarnRateLimited("Failed to get WiFi state with unknown facade %d",
+                          id);
+    return nullptr;
+  }
+  if (it->second->model->state() == model::State::OFF) return nullptr;
+  if (station.has_value() && !ieee80211::IsGroupAddress(*station)) {
+    LearnStationLocked(*station, id);
+  }
+  return it->second;
+}
+
+// Returns the enabled chip owning the receiver address of a unicast frame,
+// or nullptr if the frame has to be broadcast.
+std::shared_ptr<ChipInfo> FindUnicastReceiverLocked(
+    std::optional<ieee80211::MacAddress> receiver, uint32_t &facade_id) {
+  if (!receiver.has_value() || ieee80211::IsGroupAddress(*receiver)) {
+    return nullptr;
+  }
+  auto station = station_to_facade_id_.find(*receiver);
+  if (station == station_to_facade_id_.end() ||
+      station->second == kSharedStation) {
+    return nullptr;
+  }
+  auto it = id_to_chip_info_.find(station->second);
+  if (it == id_to_chip_info_.end()) return nullptr;
+  facade_id = it->first;
+  return it->second;
+}
+
+// Sends a batch of frames to the WiFi service. The frames are shared with
+// the transports, not copied.
+void SendBatch(
+    const std::vector<std::shared_ptr<std::vector<uint8_t>>> &frames) {
+#ifdef NETSIM_ANDROID_EMULATOR
+  std::vector<struct iovec> iov(frames.size());
+  for (size_t i = 0; i < frames.size(); i++) {
+    iov[i].iov_base = frames[i]->data();
+    iov[i].iov_len = frames[i]->size();
+  }
+  // An IOVector describes a single frame, so each frame is submitted with
+  // its own element of the batch.
+  {
+    std::lock_guard<std::mutex> lock(service_mutex_);
+    for (auto &frame : iov) {
+      wifi_service->send(android::base::IOVector(&frame, &frame + 1));
+    }
+  }
+  // Replies to the frames come through the slirp fds, so an idle poll
+  // thread is woken to service them at its base interval.
+  if (!slirp_active_.exchange(true, std::memory_order_relaxed)) {
+    // Taking the mutex orders the wake with the wait of the poll thread.
+    { std::lock_guard<std::mutex> slirp_lock(slirp_mutex_); }
+    slirp_cv_.notify_one();
+  }
+#endif
+}
+
+#ifdef NETSIM_ANDROID_EMULATOR
+// Services the slirp fds independently of the TX traffic, so that host
+// network data reaches idle chips without waiting for frames from other
+// chips. The thread polls every base interval while frames flow and backs
+// off to kMaxSlirpPollIntervalMs while the network is idle, rather than
+// waking a thousand times a second for nothing.
+void SlirpPollLoop(std::chrono::milliseconds base_interval) {
+  util::SetUpThread(util::ThreadClass::kWifi, "wifi_slirp");
+  const auto max_interval = std::max(
+      base_interval, std::chrono::milliseconds(kMaxSlirpPollIntervalMs));
+  auto interval = base_interval;
+  std::unique_lock<std::mutex> lock(slirp_mutex_);
+  while (!slirp_stop_) {
+    lock.unlock();
+    {
+      // main_loop_wait is a non-blocking call where fds maintained by the
+      // WiFi service (slirp) are polled and serviced for I/O. When any fd
+      // become ready for I/O, slirp_pollfds_poll() will be invoked to read
+      // from the open sockets therefore incoming packets are serviced.
+      std::lock_guard<std::mutex> service_lock(service_mutex_);
+      android::qemu2::libslirp_main_loop_wait(true);
+    }
+    if (slirp_active_.exchange(false, std::memory_order_relaxed)) {
+      interval = base_interval;
+    } else {
+      interval = std::min(interval * 2, max_interval);
+    }
+    lock.lock();
+    slirp_cv_.wait_for(lock, interval, [] {
+      return slirp_stop_ || slirp_active_.load(std::memory_order_relaxed);
+    });
+  }
+}
+#endif
+
+// Queues a frame for the WiFi service. The caller that finds no flush in
+// progress drains the queue, so frames sent by other chips meanwhile are
+// submitted in the same batch and the service is never entered
+// concurrently.
+void EnqueueFrame(std::shared_ptr<std::vector<uint8_t>> frame) {
+  std::vector<std::shared_ptr<std::vector<uint8_t>>> batch;
+  {
+    std::lock_guard<std::mutex> lock(tx_mutex_);
+    tx_queue_.push_back(std::move(frame));
+    if (tx_flushing_) return;
+    tx_flushing_ = true;
+  }
+  while (true) {
+    {
+      std::lock_guard<std::mutex> lock(tx_mutex_);
+      if (tx_queue_.empty()) {
+        tx_flushing_ = false;
+        return;
+      }
+      batch.swap(tx_queue_);
+    }
+    SendBatch(batch);
+    batch.clear();
   }
 }
 
+// Unicast frames go to the chip that sent from the receiver address.
+// Other frames are broadcast to all WiFi chips that are not OFF, with the
+// payload passed once and shared by the streams of all the receivers.
+void DeliverToChips(const uint8_t *buf, size_t size) {
+  auto receiver = ieee80211::GetReceiverAddress(buf, size);
+  std::shared_ptr<const Receivers> receivers;
+  std::shared_ptr<ChipInfo> unicast;
+  uint32_t unicast_id = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    unicast = FindUnicastReceiverLocked(receiver, unicast_id);
+    if (unicast && unicast->model->state() == model::State::OFF) return;
+    if (!unicast) receivers = receivers_;
+  }
+  if (unicast) {
+    unicast->rx_count.fetch_add(1, std::memory_order_relaxed);
+    unicast->recorder->Record(true, 0, buf, size);
+    transport::HandleResponseMulticast(
+        common::ChipKind::WIFI, {&unicast_id, 1}, {buf, size},
+        packet::HCIPacket::HCI_PACKET_UNSPECIFIED);
+    return;
+  }
+  if (receivers->facade_ids.empty()) return;
+  for (const auto &chip_info : receivers->chip_infos) {
+    chip_info->rx_count.fetch_add(1, std::memory_order_relaxed);
+    chip_info->recorder->Record(true, 0, buf, size);
+  }
+  transport::HandleResponseMulticast(
+      common::ChipKind::WIFI,
+      {receivers->facade_ids.data(), receivers->facade_ids.size()},
+      {buf, size}, packet::HCIPacket::HCI_PACKET_UNSPECIFIED);
+}
+
+// Returns the federation node a frame of the medium is for: the node of a
+// remote station, kAllNodes for group frames and unknown stations, or
+// nullopt for the stations of the local chips.
+std::optional<uint32_t> FederatedReceiverNode(const uint8_t *buf,
+                                              size_t size) {
+  auto receiver = ieee80211::GetReceiverAddress(buf, size);
+  if (!receiver.has_value() || ieee80211::IsGroupAddress(*receiver)) {
+    return federation::kAllNodes;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (station_to_facade_id_.count(*receiver) != 0) return std::nullopt;
+  auto node = station_to_node_id_.find(*receiver);
+  if (node == station_to_node_id_.end()) return federation::kAllNodes;
+  return node->second;
+}
+
 }  // namespace
 
 namespace facade {
 
 void Reset(uint32_t id) {
   BtsLog("wifi::facade::Reset(%d)", id);
+  std::lock_guard<std::mutex> lock(mutex_);
   if (auto it = id_to_chip_info_.find(id); it != id_to_chip_info_.end()) {
     auto chip_info = it->second;
     chip_info->model->set_state(model::State::ON);
-    chip_info->model->set_tx_count(0);
-    chip_info->model->set_rx_count(0);
+    chip_info->tx_count.store(0, std::memory_order_relaxed);
+    chip_info->rx_count.store(0, std::memory_order_relaxed);
+    chip_info->version.fetch_add(1, std::memory_order_relaxed);
+    UpdateReceiversLocked();
   }
 }
-void Remove(uint32_t id) {
+void Remove(uint32_t id, bool keep_snapshot) {
   BtsLog("wifi::facade::Remove(%d)", id);
-  id_to_chip_info_.erase(id);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (auto it = id_to_chip_info_.find(id); it != id_to_chip_info_.end()) {
+      const auto &chip_info = *it->second;
+      if (keep_snapshot && !chip_info.snapshot_key.empty()) {
+        util::SnapshotStore::Put(chip_info.snapshot_key,
+                                 SnapshotOfLocked(chip_info));
+      }
+      id_to_chip_info_.erase(it);
+    }
+    for (auto it = station_to_facade_id_.begin();
+         it != station_to_facade_id_.end();) {
+      if (it->second == id) {
+        it = station_to_facade_id_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    UpdateReceiversLocked();
+  }
+  util::ReleaseFlightRecorder(common::ChipKind::WIFI, id);
 }
 
 void Patch(uint32_t id, const model::Chip::Radio &request) {
   BtsLog("wifi::facade::Patch(%d)", id);
+  std::lock_guard<std::mutex> lock(mutex_);
   auto it = id_to_chip_info_.find(id);
   if (it == id_to_chip_info_.end()) {
     BtsLogWarn("Patch an unknown facade_id: %d", id);
@@ -102,14 +374,19 @@ void Patch(uint32_t id, const model::Chip::Radio &request) {
   auto &model = it->second->model;
   if (ChangedState(model->state(), request.state())) {
     model->set_state(request.state());
+    it->second->version.fetch_add(1, std::memory_order_relaxed);
+    UpdateReceiversLocked();
   }
 }
 
 model::Chip::Radio Get(uint32_t id) {
   BtsLog("wifi::facade::Get(%d)", id);
   model::Chip::Radio radio;
+  std::lock_guard<std::mutex> lock(mutex_);
   if (auto it = id_to_chip_info_.find(id); it != id_to_chip_info_.end()) {
     radio.CopyFrom(*it->second->model);
+    radio.set_tx_count(it->second->tx_count.load(std::memory_order_relaxed));
+    radio.set_rx_count(it->second->rx_count.load(std::memory_order_relaxed));
   }
   return radio;
 }
@@ -122,39 +399,81 @@ void PatchCxx(uint32_t id,
 }
 
 rust::Vec<uint8_t> GetCxx(uint32_t id) {
-  auto radio = Get(id);
-  std::vector<uint8_t> proto_bytes(radio.ByteSizeLong());
-  radio.SerializeToArray(proto_bytes.data(), proto_bytes.size());
-  rust::Vec<uint8_t> proto_rust_bytes;
-  std::copy(proto_bytes.begin(), proto_bytes.end(),
-            std::back_inserter(proto_rust_bytes));
-  return proto_rust_bytes;
+  std::shared_ptr<ChipInfo> chip_info;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = id_to_chip_info_.find(id);
+    if (it == id_to_chip_info_.end()) return {};
+    chip_info = it->second;
+  }
+  // Re-encode only when the model or the counters changed since the last
+  // poll.
+  auto version =
+      std::make_tuple(chip_info->version.load(std::memory_order_relaxed),
+                      chip_info->tx_count.load(std::memory_order_relaxed),
+                      chip_info->rx_count.load(std::memory_order_relaxed));
+  auto bytes = chip_info->serialized.Get(version, [&](std::string &bytes) {
+    model::Chip::Radio radio;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      radio.CopyFrom(*chip_info->model);
+    }
+    radio.set_tx_count(std::get<1>(version));
+    radio.set_rx_count(std::get<2>(version));
+    radio.SerializeToString(&bytes);
+  });
+  return VecFromSlice({reinterpret_cast<const uint8_t *>(bytes->data()),
+                       bytes->size()});
 }
 
-uint32_t Add(uint32_t simulation_device) {
+uint32_t Add(uint32_t simulation_device, const std::string &snapshot_key) {
   BtsLog("wifi::facade::Add(%d)", simulation_device);
   static uint32_t global_chip_id = kGlobalChipStartIndex;
 
   auto model = std::make_shared<model::Chip::Radio>();
   model->set_state(model::State::ON);
-  id_to_chip_info_.emplace(
-      global_chip_id, std::make_shared<ChipInfo>(simulation_device, model));
+  if (!snapshot_key.empty()) {
+    model::Chip::Radio restored;
+    auto snapshot = util::SnapshotStore::Take(snapshot_key);
+    if (snapshot && restored.ParseFromString(snapshot->model) &&
+        restored.state() != model::State::UNKNOWN) {
+      model->set_state(restored.state());
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto chip_info =
+      std::make_shared<ChipInfo>(simulation_device, model, snapshot_key);
+  chip_info->recorder =
+      util::GetFlightRecorder(common::ChipKind::WIFI, global_chip_id);
+  id_to_chip_info_.emplace(global_chip_id, std::move(chip_info));
+  UpdateReceiversLocked();
 
   return global_chip_id++;
 }
 
+void SnapshotChips(util::SimulationSnapshot &snapshot) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto &[id, chip_info] : id_to_chip_info_) {
+    if (chip_info->snapshot_key.empty()) continue;
+    snapshot.insert_or_assign(chip_info->snapshot_key,
+                              SnapshotOfLocked(*chip_info));
+  }
+}
+
 size_t HandleWifiCallback(const uint8_t *buf, size_t size) {
-  //  Broadcast the response to all WiFi chips.
-  std::vector<uint8_t> packet(buf, buf + size);
-  for (auto [facade_id, _] : id_to_chip_info_) {
-    if (auto state = GetState(facade_id);
-        !state || state == model::State::OFF) {
-      continue;
+#ifdef NETSIM_ANDROID_EMULATOR
+  slirp_active_.store(true, std::memory_order_relaxed);
+#endif
+  // In a federation the frames for the stations of other nodes go to their
+  // node only, group frames to every node and to the local chips.
+  if (federation::Enabled()) {
+    auto node_id = FederatedReceiverNode(buf, size);
+    if (node_id.has_value()) {
+      federation::SendWifiFrame(*node_id, buf, size);
+      if (*node_id != federation::kAllNodes) return size;
     }
-    netsim::wifi::IncrRx(facade_id);
-    transport::HandleResponse(common::ChipKind::WIFI, facade_id, packet,
-                              packet::HCIPacket::HCI_PACKET_UNSPECIFIED);
   }
+  DeliverToChips(buf, size);
   return size;
 }
 
@@ -196,13 +515,33 @@ void Start(const rust::Slice<::std::uint8_t const> proto_bytes) {
                      .withOnReceiveCallback(HandleWifiCallback)
                      .withVerboseLogging(true);
   wifi_service = builder.build();
-  if (!wifi_service->init()) {
-    BtsLogWarn("Failed to initialize wifi service");
+  // The hostapd and slirp threads of the service inherit the WiFi CPUs.
+  util::StartThreadsOf(util::ThreadClass::kWifi, [] {
+    if (!wifi_service->init()) {
+      BtsLogWarn("Failed to initialize wifi service");
+    }
+  });
+
+  auto interval = config.slirp_poll_interval_ms() != 0
+                      ? config.slirp_poll_interval_ms()
+                      : kDefaultSlirpPollIntervalMs;
+  {
+    std::lock_guard<std::mutex> lock(slirp_mutex_);
+    slirp_stop_ = false;
   }
+  slirp_thread_ =
+      std::thread(SlirpPollLoop, std::chrono::milliseconds(interval));
 #endif
 }
 void Stop() {
 #ifdef NETSIM_ANDROID_EMULATOR
+  {
+    std::lock_guard<std::mutex> lock(slirp_mutex_);
+    slirp_stop_ = true;
+  }
+  slirp_cv_.notify_all();
+  if (slirp_thread_.joinable()) slirp_thread_.join();
+  std::lock_guard<std::mutex> lock(service_mutex_);
   wifi_service->stop();
 #endif
 }
@@ -211,24 +550,42 @@ void Stop() {
 
 void HandleWifiRequest(uint32_t facade_id,
                        const std::shared_ptr<std::vector<uint8_t>> &packet) {
-#ifdef NETSIM_ANDROID_EMULATOR
-  if (auto state = GetState(facade_id); !state || state == model::State::OFF) {
+  auto chip_info = FindEnabledChip(
+      facade_id,
+      ieee80211::GetTransmitterAddress(packet->data(), packet->size()));
+  if (!chip_info) return;
+  chip_info->tx_count.fetch_add(1, std::memory_order_relaxed);
+  chip_info->recorder->Record(false, 0, packet->data(), packet->size());
+  if (!federation::IsWifiMedium()) {
+    federation::ForwardWifiFrame(packet->data(), packet->size());
     return;
   }
-  netsim::wifi::IncrTx(facade_id);
-  // Send the packet to the WiFi service.
-  struct iovec iov[1];
-  iov[0].iov_base = packet->data();
-  iov[0].iov_len = packet->size();
-  wifi_service->send(android::base::IOVector(iov, iov + 1));
-#endif
+  EnqueueFrame(packet);
 }
 
 void HandleWifiRequestCxx(uint32_t facade_id,
                           const rust::Vec<uint8_t> &packet) {
-  std::vector<uint8_t> buffer(packet.begin(), packet.end());
-  auto packet_ptr = std::make_shared<std::vector<uint8_t>>(buffer);
+  auto packet_ptr = util::PacketPool::Copy(packet.data(), packet.size());
   HandleWifiRequest(facade_id, packet_ptr);
 }
 
+void HandleWifiRequestBufferCxx(uint32_t facade_id,
+                                const util::PacketBuffer &packet) {
+  HandleWifiRequest(facade_id, packet.Share());
+}
+
+void HandleFederatedWifiFrame(uint32_t node_id, const uint8_t *data,
+                              size_t size) {
+  if (!federation::IsWifiMedium()) {
+    DeliverToChips(data, size);
+    return;
+  }
+  auto station = ieee80211::GetTransmitterAddress(data, size);
+  if (station.has_value() && !ieee80211::IsGroupAddress(*station)) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    station_to_node_id_[*station] = node_id;
+  }
+  EnqueueFrame(util::PacketPool::Copy(data, size));
+}
+
 }  // namespace netsim::wifi
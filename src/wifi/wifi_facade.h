@@ -20,6 +20,7 @@
 
 #include "netsim/model.pb.h"
 #include "rust/cxx.h"
+#include "util/chip_snapshot.h"
 
 /** Manages the WiFi chip emulation provided by the WiFi service library.
  *
@@ -30,14 +31,22 @@
 namespace netsim::wifi::facade {
 
 void Reset(uint32_t);
-void Remove(uint32_t);
+// keep_snapshot is set when the chip leaves because its stream
+// disconnected, so a chip added again with its snapshot_key resumes. A chip
+// deleted on request drops its state.
+void Remove(uint32_t id, bool keep_snapshot);
 void Patch(uint32_t, const model::Chip::Radio &);
 model::Chip::Radio Get(uint32_t);
-uint32_t Add(uint32_t simulation_device);
+// A chip added with the snapshot_key of a removed chip resumes its radio
+// state, see util::SnapshotStore.
+uint32_t Add(uint32_t simulation_device, const std::string &snapshot_key = "");
 
 void Start(const rust::Slice<::std::uint8_t const> proto_bytes);
 void Stop();
 
+// Adds the snapshots of the attached chips to snapshot.
+void SnapshotChips(util::SimulationSnapshot &snapshot);
+
 // Cxx functions for rust ffi.
 void PatchCxx(uint32_t, const rust::Slice<::std::uint8_t const> _proto_bytes);
 rust::Vec<uint8_t> GetCxx(uint32_t);
@@ -0,0 +1,69 @@
+// Copyright 2023 The Android Open Source Project
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Benchmarks of the WiFi request path.
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "netsim/config.pb.h"
+#include "rust/cxx.h"
+#include "util/benchmark_counters.h"
+#include "wifi/wifi_facade.h"
+#include "wifi/wifi_packet_hub.h"
+
+namespace netsim::wifi {
+namespace {
+
+constexpr uint32_t kSimulationDevice = 123;
+
+// QoS data frame from 02:15:b2:00:00:01 to 02:15:b2:00:00:02.
+const std::vector<uint8_t> kDataFrame = {
+    0x88, 0x02, 0x2c, 0x00, 0x02, 0x15, 0xb2, 0x00, 0x00, 0x02, 0x02, 0x15,
+    0xb2, 0x00, 0x00, 0x01, 0x02, 0x15, 0xb2, 0x00, 0x00, 0x03, 0x10, 0x00};
+
+// The WiFi service runs without hostapd and slirp, so the frames stop at
+// the service and only the netsim side of the path is measured. It is
+// started once and left running until the process exits.
+void StartWifi() {
+  static bool started = false;
+  if (started) return;
+  started = true;
+  config::WiFi config;
+  config.mutable_hostapd_options()->set_disabled(true);
+  config.mutable_slirp_options()->set_disabled(true);
+  std::string bytes = config.SerializeAsString();
+  facade::Start({reinterpret_cast<const uint8_t *>(bytes.data()),
+                 bytes.size()});
+}
+
+// Arg: payload bytes appended to the frame header.
+void BM_HandleWifiRequest(benchmark::State &state) {
+  StartWifi();
+  auto facade_id = facade::Add(kSimulationDevice);
+  auto frame = std::make_shared<std::vector<uint8_t>>(kDataFrame);
+  frame->resize(kDataFrame.size() + state.range(0));
+  for (auto _ : state) {
+    HandleWifiRequest(facade_id, frame);
+  }
+  util::SetPacketCounters(state, state.iterations());
+  facade::Remove(facade_id, false);
+}
+
+BENCHMARK(BM_HandleWifiRequest)->Arg(64)->Arg(1500);
+
+}  // namespace
+}  // namespace netsim::wifi
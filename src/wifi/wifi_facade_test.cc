@@ -21,7 +21,9 @@
 namespace netsim::wifi::facade {
 
 class WiFiFacadeTest : public ::testing::Test {
-  void TearDown() { netsim::wifi::facade::Remove(SIMULATION_DEVICE); }
+  void TearDown() {
+    netsim::wifi::facade::Remove(SIMULATION_DEVICE, false);
+  }
 
  protected:
   const int SIMULATION_DEVICE = 123;
@@ -39,7 +41,7 @@ TEST_F(WiFiFacadeTest, AddAndGetTest) {
 TEST_F(WiFiFacadeTest, RemoveTest) {
   auto facade_id = Add(SIMULATION_DEVICE);
 
-  Remove(facade_id);
+  Remove(facade_id, false);
 
   auto radio = Get(facade_id);
   EXPECT_EQ(model::State::UNKNOWN, radio.state());
@@ -67,4 +69,32 @@ TEST_F(WiFiFacadeTest, ResetTest) {
   EXPECT_EQ(0, radio.rx_count());
 }
 
+TEST_F(WiFiFacadeTest, SnapshotRestoresState) {
+  auto facade_id = Add(SIMULATION_DEVICE, "device/WIFI/wifi");
+  model::Chip::Radio request;
+  request.set_state(model::State::OFF);
+  Patch(facade_id, request);
+  Remove(facade_id, true);
+
+  auto restored_id = Add(SIMULATION_DEVICE, "device/WIFI/wifi");
+  EXPECT_EQ(model::State::OFF, Get(restored_id).state());
+  Remove(restored_id, false);
+
+  // Chips with another key start from the default state.
+  auto other_id = Add(SIMULATION_DEVICE, "device/WIFI/other");
+  EXPECT_EQ(model::State::ON, Get(other_id).state());
+}
+
+TEST_F(WiFiFacadeTest, DeletedChipDoesNotResume) {
+  auto facade_id = Add(SIMULATION_DEVICE, "device/WIFI/deleted");
+  model::Chip::Radio request;
+  request.set_state(model::State::OFF);
+  Patch(facade_id, request);
+  Remove(facade_id, false);
+
+  auto added_id = Add(SIMULATION_DEVICE, "device/WIFI/deleted");
+  EXPECT_EQ(model::State::ON, Get(added_id).state());
+  Remove(added_id, false);
+}
+
 }  // namespace netsim::wifi::facade
\ No newline at end of file
@@ -16,11 +16,13 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
 #include "rust/cxx.h"
+#include "util/packet_buffer.h"
 
 namespace netsim::wifi {
 
@@ -32,4 +34,15 @@ void HandleWifiRequest(uint32_t facade_id,
 
 void HandleWifiRequestCxx(uint32_t facade_id, const rust::Vec<uint8_t> &packet);
 
+/* Zero-copy variant used by the gRPC transport. */
+
+void HandleWifiRequestBufferCxx(uint32_t facade_id,
+                                const util::PacketBuffer &packet);
+
+/* Frames exchanged with another node of a federation: the frames of its
+   chips on the medium node, the frames of the medium on the others. */
+
+void HandleFederatedWifiFrame(uint32_t node_id, const uint8_t *data,
+                              size_t size);
+
 }  // namespace netsim::wifi